@@ -11,6 +11,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
  */
 #include <fstream>
+#include <nlohmann/json.hpp>
 
 #include "CypherQueryExecutor.h"
 #include "antlr4-runtime.h"
@@ -27,6 +28,99 @@ limitations under the License.
 
 Logger cypher_logger;
 
+using json = nlohmann::json;
+
+// Storage metrics JSON of every distinct worker of a query, keyed by host:port
+static std::map<std::string, std::string> collectStorageMetrics(
+    const std::vector<JasmineGraphServer::worker> &workers, const std::string &masterIP) {
+    std::map<std::string, std::string> metrics;
+    for (const auto &worker : workers) {
+        std::string workerName = worker.hostname + ":" + std::to_string(worker.port);
+        if (metrics.find(workerName) == metrics.end()) {
+            metrics[workerName] = Utils::getStorageMetrics(worker.hostname, worker.port, masterIP);
+        }
+    }
+    return metrics;
+}
+
+// Upper bound of the bucket of the read latency histogram holding the given percentile of the reads
+static std::string latencyPercentile(const std::vector<unsigned long> &histogram, unsigned long reads,
+                                     double percentile) {
+    unsigned long rank = (unsigned long)std::ceil(reads * percentile);
+    unsigned long seen = 0;
+    for (size_t bucket = 0; bucket < histogram.size(); bucket++) {
+        seen += histogram[bucket];
+        if (seen >= rank) {
+            if (bucket == histogram.size() - 1) {
+                return ">=" + std::to_string(1UL << bucket) + "ns";
+            }
+            return "<" + std::to_string(1UL << (bucket + 1)) + "ns";
+        }
+    }
+    return "-";
+}
+
+/**
+ * Log the storage I/O each worker did for the partitions of the graph between two metric collections: the counters
+ * of every block file that was touched and the read latency percentiles
+ * */
+static void logStorageMetrics(const std::string &graphId, long msDuration,
+                              const std::map<std::string, std::string> &before,
+                              const std::map<std::string, std::string> &after) {
+    const std::string graphPrefix = "g" + graphId + "_";
+    for (const auto &worker : after) {
+        auto previous = before.find(worker.first);
+        if (worker.second.empty() || previous == before.end() || previous->second.empty()) {
+            cypher_logger.warn("Storage metrics of worker " + worker.first + " are not available");
+            continue;
+        }
+        json start = json::parse(previous->second, nullptr, false);
+        json end = json::parse(worker.second, nullptr, false);
+        if (start.is_discarded() || end.is_discarded()) {
+            cypher_logger.warn("Invalid storage metrics from worker " + worker.first);
+            continue;
+        }
+        for (auto partition = end.begin(); partition != end.end(); ++partition) {
+            if (partition.key().rfind(graphPrefix, 0) != 0) {
+                continue;
+            }
+            // Partitions first used by this query have no counters in the first collection
+            json startFiles = start.value(partition.key(), json::object()).value("files", json::object());
+            std::vector<unsigned long> startLatency =
+                start.value(partition.key(), json::object()).value("readLatency", std::vector<unsigned long>());
+            std::string files;
+            for (auto file = (*partition)["files"].begin(); file != (*partition)["files"].end(); ++file) {
+                std::string counters;
+                bool used = false;
+                for (auto counter = file->begin(); counter != file->end(); ++counter) {
+                    unsigned long delta = counter->get<unsigned long>() -
+                                          startFiles.value(file.key(), json::object()).value(counter.key(), 0UL);
+                    used |= delta > 0;
+                    counters += " " + counter.key() + "=" + std::to_string(delta);
+                }
+                if (used) {
+                    files += " [" + file.key() + counters + "]";
+                }
+            }
+            if (files.empty()) {
+                continue;
+            }
+            std::vector<unsigned long> latency = (*partition)["readLatency"].get<std::vector<unsigned long>>();
+            unsigned long reads = 0;
+            for (size_t bucket = 0; bucket < latency.size(); bucket++) {
+                if (bucket < startLatency.size()) {
+                    latency[bucket] -= startLatency[bucket];
+                }
+                reads += latency[bucket];
+            }
+            cypher_logger.info("Storage I/O of " + partition.key() + " on worker " + worker.first + " in query of " +
+                               std::to_string(msDuration) + " ms:" + files + " read latency p50 " +
+                               latencyPercentile(latency, reads, 0.5) + " p99 " +
+                               latencyPercentile(latency, reads, 0.99));
+        }
+    }
+}
+
 CypherQueryExecutor::CypherQueryExecutor() {}
 
 CypherQueryExecutor::CypherQueryExecutor(SQLiteDBInterface *db, PerformanceSQLiteDBInterface *perfDb,
@@ -56,39 +150,55 @@ void CypherQueryExecutor::execute() {
     bool canCalibrate = Utils::parseBoolean(canCalibrateString);
     bool autoCalibrate = Utils::parseBoolean(autoCalibrateString);
 
-    antlr4::ANTLRInputStream input(queryString);
-    // Create a lexer from the input
-    CypherLexer lexer(&input);
-    cypher_logger.info("Created lexer from input");
-
-    // Create a token stream from the lexer
-    antlr4::CommonTokenStream tokens(&lexer);
-    cypher_logger.info("Created tokens from lexer");
-
-    // Create a parser from the token stream
-    CypherParser parser(&tokens);
-    cypher_logger.info("Created parser from tokens");
-
-    ASTBuilder astBuilder;
-    auto* ast = any_cast<ASTNode*>(astBuilder.visitOC_Cypher(parser.oC_Cypher()));
-
-    SemanticAnalyzer semanticAnalyzer;
+    // Options such as CYPHER parallelism=4 are taken off the query before it is parsed
+    std::map<std::string, std::string> queryOptions = QueryPlanner::extractQueryOptions(queryString);
     string queryPlan;
-    if (semanticAnalyzer.analyze(ast)) {
-        cypher_logger.info("AST is successfully analyzed");
-        QueryPlanner queryPlanner;
-        Operator *executionPlan = queryPlanner.createExecutionPlan(ast);
-        queryPlan = executionPlan->execute();
+    Operator *indexPlan = QueryPlanner::createIndexPlan(queryString);
+    if (indexPlan) {
+        cypher_logger.info("Query is recognized as CREATE INDEX");
+        queryPlan = indexPlan->execute();
+        delete indexPlan;
     } else {
-        cypher_logger.error("Query isn't semantically correct: " + queryString);
+        antlr4::ANTLRInputStream input(queryString);
+        // Create a lexer from the input
+        CypherLexer lexer(&input);
+        cypher_logger.info("Created lexer from input");
+
+        // Create a token stream from the lexer
+        antlr4::CommonTokenStream tokens(&lexer);
+        cypher_logger.info("Created tokens from lexer");
+
+        // Create a parser from the token stream
+        CypherParser parser(&tokens);
+        cypher_logger.info("Created parser from tokens");
+
+        ASTBuilder astBuilder;
+        auto* ast = any_cast<ASTNode*>(astBuilder.visitOC_Cypher(parser.oC_Cypher()));
+
+        SemanticAnalyzer semanticAnalyzer;
+        if (semanticAnalyzer.analyze(ast)) {
+            cypher_logger.info("AST is successfully analyzed");
+            QueryPlanner queryPlanner;
+            Operator *executionPlan = queryPlanner.createExecutionPlan(ast);
+            queryPlan = executionPlan->execute();
+        } else {
+            cypher_logger.error("Query isn't semantically correct: " + queryString);
+        }
     }
+    queryPlan = QueryPlanner::applyQueryOptions(queryPlan, queryOptions);
 
     std::vector<std::future<void>> intermRes;
     std::vector<std::future<int>> statResponse;
 
-    auto begin = chrono::high_resolution_clock::now();
-
     const auto &workerList = JasmineGraphServer::getWorkers(numberOfPartitions);
+    bool storageMetrics =
+        Utils::parseBoolean(Utils::getJasmineGraphProperty("org.jasminegraph.nativestore.query.io.metrics"));
+    std::map<std::string, std::string> storageMetricsBefore;
+    if (storageMetrics) {  // Collected before the query is timed
+        storageMetricsBefore = collectStorageMetrics(workerList, masterIP);
+    }
+
+    auto begin = chrono::high_resolution_clock::now();
 
     std::vector<std::unique_ptr<SharedBuffer>> bufferPool;
     bufferPool.reserve(numberOfPartitions);  // Pre-allocate space for pointers
@@ -140,20 +250,27 @@ void CypherQueryExecutor::execute() {
         auto startTime = std::chrono::high_resolution_clock::now();
         if (Operator::aggregateType == AggregationFactory::AVERAGE) {
             Aggregation* aggregation = AggregationFactory::getAggregationMethod(AggregationFactory::AVERAGE);
-            while (true) {
-                if (closeFlag == numberOfPartitions) {
-                    break;
-                }
+            std::vector<std::string> rows;
+            unsigned int idle = 0;
+            while (closeFlag < numberOfPartitions) {
+                closeFlag = 0;
+                bool received = false;
                 for (size_t i = 0; i < bufferPool.size(); ++i) {
-                    std::string data;
-                    if (bufferPool[i]->tryGet(data)) {
-                        if (data == "-1") {
-                            closeFlag++;
-                        } else {
+                    if (bufferPool[i]->tryGetBatch(rows, MASTER_BUFFER_SIZE) > 0) {
+                        received = true;
+                        for (auto &data : rows) {
                             aggregation->insert(data);
                         }
+                        rows.clear();
+                    } else if (bufferPool[i]->finished()) {
+                        closeFlag++;
                     }
                 }
+                if (received) {
+                    idle = 0;
+                } else {
+                    SpscRing<std::string>::backoff(idle);
+                }
             }
             aggregation->getResult(connFd);
         } else if (Operator::aggregateType == AggregationFactory::ASC ||
@@ -182,8 +299,8 @@ void CypherQueryExecutor::execute() {
             bool isAsc = (Operator::aggregateType == AggregationFactory::ASC);
             std::priority_queue<BufferEntry> mergeQueue;  // Min-heap
             for (size_t i = 0; i < numberOfPartitions; ++i) {
-                std::string value = bufferPool[i]->get();
-                if (value != "-1") {
+                std::string value;
+                if (bufferPool[i]->get(value)) {
                     try {
                         json parsed = json::parse(value);
                         if (!parsed.contains(Operator::aggregateKey)) {
@@ -222,8 +339,8 @@ void CypherQueryExecutor::execute() {
                     return;
                 }
                 if (closeFlag < numberOfPartitions) {
-                    std::string nextValue = bufferPool[smallest.bufferIndex]->get();
-                    if (nextValue == "-1") {
+                    std::string nextValue;
+                    if (!bufferPool[smallest.bufferIndex]->get(nextValue)) {
                         closeFlag++;
                         cypher_logger.info("closeflag" + std::to_string(closeFlag));
                     } else {
@@ -260,27 +377,36 @@ void CypherQueryExecutor::execute() {
         Operator::isAggregate = false;
     } else {
         int count = 0;
-        while (true) {
-            if (closeFlag == numberOfPartitions) {
-                break;
-            }
+        std::vector<std::string> rows;
+        unsigned int idle = 0;
+        while (closeFlag < numberOfPartitions) {
+            closeFlag = 0;
+            bool received = false;
             for (size_t i = 0; i < bufferPool.size(); ++i) {
-                std::string data;
-                if (bufferPool[i]->tryGet(data)) {
-                    if (data == "-1") {
+                if (bufferPool[i]->tryGetBatch(rows, MASTER_BUFFER_SIZE) == 0) {
+                    if (bufferPool[i]->finished()) {
                         closeFlag++;
-                    } else {
-                        count++;
-                        result_wr = write(connFd, data.c_str(), data.length());
-                        result_wr = write(connFd, Conts::CARRIAGE_RETURN_NEW_LINE.c_str(),
-                                          Conts::CARRIAGE_RETURN_NEW_LINE.size());
-                        if (result_wr < 0) {
-                            cypher_logger.error("Error writing to socket");
-                            *loop_exit = true;
-                            return;
-                        }
+                    }
+                    continue;
+                }
+                received = true;
+                for (auto &data : rows) {
+                    count++;
+                    result_wr = write(connFd, data.c_str(), data.length());
+                    result_wr = write(connFd, Conts::CARRIAGE_RETURN_NEW_LINE.c_str(),
+                                      Conts::CARRIAGE_RETURN_NEW_LINE.size());
+                    if (result_wr < 0) {
+                        cypher_logger.error("Error writing to socket");
+                        *loop_exit = true;
+                        return;
                     }
                 }
+                rows.clear();
+            }
+            if (received) {
+                idle = 0;
+            } else {
+                SpscRing<std::string>::backoff(idle);
             }
         }
         cypher_logger.info("Total records returned: " + std::to_string(count));
@@ -307,6 +433,9 @@ void CypherQueryExecutor::execute() {
     auto msDuration = std::chrono::duration_cast<std::chrono::milliseconds>(dur).count();
 
     std::string durationString = std::to_string(msDuration);
+    if (storageMetrics) {
+        logStorageMetrics(graphId, msDuration, storageMetricsBefore, collectStorageMetrics(workerList, masterIP));
+    }
 
     if (canCalibrate || autoCalibrate) {
         Utils::updateSLAInformation(perfDB, graphId, numberOfPartitions, msDuration, CYPHER,
@@ -798,6 +798,7 @@ static void cypher_ast_command(int connFd, vector<DataPublisher *> &workerClient
 
     string user_res_1(graph_id);
     string user_res_s(query);
+    std::map<std::string, std::string> queryOptions = QueryPlanner::extractQueryOptions(user_res_s);
 
     antlr4::ANTLRInputStream input(user_res_s);
     // Create a lexer from the input
@@ -822,6 +823,7 @@ static void cypher_ast_command(int connFd, vector<DataPublisher *> &workerClient
     } else {
         ui_frontend_logger.error("query isn't semantically correct: " + user_res_s);
     }
+    obj = QueryPlanner::applyQueryOptions(obj, queryOptions);
 
     int bufferSize = 5;
     // Create buffer pool
@@ -839,22 +841,29 @@ static void cypher_ast_command(int connFd, vector<DataPublisher *> &workerClient
     if (Operator::isAggregate) {
         if (Operator::aggregateType == AggregationFactory::AVERAGE) {
             Aggregation* aggregation = AggregationFactory::getAggregationMethod(AggregationFactory::AVERAGE);
-            while (true) {
-                if (closeFlag == numberOfPartitions) {
-                    write(connFd, "-1", 2);
-                    break;
-                }
+            std::vector<std::string> rows;
+            unsigned int idle = 0;
+            while (closeFlag < numberOfPartitions) {
+                closeFlag = 0;
+                bool received = false;
                 for (size_t i = 0; i < bufferPool.size(); ++i) {
-                    std::string data;
-                    if (bufferPool[i]->tryGet(data)) {
-                        if (data == "-1") {
-                            closeFlag++;
-                        } else {
+                    if (bufferPool[i]->tryGetBatch(rows, bufferSize) > 0) {
+                        received = true;
+                        for (auto &data : rows) {
                             aggregation->insert(data);
                         }
+                        rows.clear();
+                    } else if (bufferPool[i]->finished()) {
+                        closeFlag++;
                     }
                 }
+                if (received) {
+                    idle = 0;
+                } else {
+                    SpscRing<std::string>::backoff(idle);
+                }
             }
+            write(connFd, "-1", 2);
             aggregation->getResult(connFd);
         } else if (Operator::aggregateType == AggregationFactory::ASC ||
             Operator::aggregateType == AggregationFactory::DESC) {
@@ -884,8 +893,8 @@ static void cypher_ast_command(int connFd, vector<DataPublisher *> &workerClient
             bool isAsc = (Operator::aggregateType == AggregationFactory::ASC);
             std::priority_queue<BufferEntry> mergeQueue;  // Min-heap
             for (size_t i = 0; i < numberOfPartitions; ++i) {
-                std::string value = bufferPool[i]->get();
-                if (value != "-1") {
+                std::string value;
+                if (bufferPool[i]->get(value)) {
                     try {
                         json parsed = json::parse(value);
                         if (!parsed.contains(Operator::aggregateKey)) {
@@ -923,8 +932,8 @@ static void cypher_ast_command(int connFd, vector<DataPublisher *> &workerClient
 
                 // Only fetch next value if the buffer isn't exhausted
                 if (closeFlag < numberOfPartitions) {
-                    std::string nextValue = bufferPool[smallest.bufferIndex]->get();
-                    if (nextValue == "-1") {
+                    std::string nextValue;
+                    if (!bufferPool[smallest.bufferIndex]->get(nextValue)) {
                         closeFlag++;
                         ui_frontend_logger.info("Value of closeflag : " + std::to_string(closeFlag));
                     } else {
@@ -951,25 +960,33 @@ static void cypher_ast_command(int connFd, vector<DataPublisher *> &workerClient
                     Conts::CARRIAGE_RETURN_NEW_LINE.size());
         }
     } else {
-        while (true) {
-            if (closeFlag == numberOfPartitions) {
-                write(connFd, "-1", 2);
-                break;
-            }
-
+        std::vector<std::string> rows;
+        unsigned int idle = 0;
+        while (closeFlag < numberOfPartitions) {
+            closeFlag = 0;
+            bool received = false;
             for (size_t i = 0; i < bufferPool.size(); ++i) {
-                std::string data;
-                if (bufferPool[i]->tryGet(data)) {
-                    if (data == "-1") {
+                if (bufferPool[i]->tryGetBatch(rows, bufferSize) == 0) {
+                    if (bufferPool[i]->finished()) {
                         closeFlag++;
-                    } else {
-                        int result_wr = write(connFd, data.c_str(), data.length());
-                        result_wr = write(connFd, Conts::CARRIAGE_RETURN_NEW_LINE.c_str(),
-                            Conts::CARRIAGE_RETURN_NEW_LINE.size());
                     }
+                    continue;
                 }
+                received = true;
+                for (auto &data : rows) {
+                    int result_wr = write(connFd, data.c_str(), data.length());
+                    result_wr = write(connFd, Conts::CARRIAGE_RETURN_NEW_LINE.c_str(),
+                        Conts::CARRIAGE_RETURN_NEW_LINE.size());
+                }
+                rows.clear();
+            }
+            if (received) {
+                idle = 0;
+            } else {
+                SpscRing<std::string>::backoff(idle);
             }
         }
+        write(connFd, "-1", 2);
     }
 }
 
@@ -23,6 +23,25 @@ limitations under the License.
 
 Logger incremental_localstore_logger;
 
+/**
+ * Typed value of a JSON property, values other than numbers and booleans are stored as text
+ * */
+static PropertyValue toPropertyValue(const json& value) {
+    if (value.is_number_integer()) {
+        return PropertyValue::ofInt(value.get<long long>());
+    }
+    if (value.is_number_float()) {
+        return PropertyValue::ofDouble(value.get<double>());
+    }
+    if (value.is_boolean()) {
+        return PropertyValue::ofBool(value.get<bool>());
+    }
+    if (value.is_string()) {
+        return PropertyValue::ofString(value.get<std::string>());
+    }
+    return PropertyValue::ofString(value.dump());
+}
+
 JasmineGraphIncrementalLocalStore::JasmineGraphIncrementalLocalStore(unsigned int graphID, unsigned int partitionID,
                                                                      std::string openMode) {
     gc.graphID = graphID;
@@ -30,8 +49,51 @@ JasmineGraphIncrementalLocalStore::JasmineGraphIncrementalLocalStore(unsigned in
     gc.maxLabelSize = std::stoi(Utils::getJasmineGraphProperty("org.jasminegraph.nativestore.max.label.size"));
     gc.openMode = openMode;
     this->nm = new NodeManager(gc);
+    this->nm->ownWriteAheadLog();
+    this->replayLog();
 };
 
+/**
+ * Apply the operations of the write-ahead log that were not covered by a checkpoint when the partition was last
+ * closed, then checkpoint them. Operations that already reached the block files are found again, edges by the edge
+ * index and nodes by the node index, so replaying them adds nothing new.
+ * */
+void JasmineGraphIncrementalLocalStore::replayLog() {
+    if (!this->nm->wal || this->nm->wal->size() == 0) {
+        return;
+    }
+    unsigned long replayed = this->nm->wal->replay([this](WalRecordType type, const std::string& message) {
+        try {
+            if (type == WalRecordType::LOCAL_EDGE) {
+                applyLocalEdge(message);
+            } else if (type == WalRecordType::CENTRAL_EDGE) {
+                applyCentralEdge(message);
+            } else {
+                applyMessage(message);
+            }
+        } catch (const std::exception& e) {
+            incremental_localstore_logger.error("Error while replaying " + message + ": " + std::string(e.what()));
+        }
+    });
+    this->nm->checkpoint();
+    incremental_localstore_logger.info("Replayed " + std::to_string(replayed) + " logged operations of graph " +
+                                       std::to_string(gc.graphID) + " partition " + std::to_string(gc.partitionID));
+}
+
+/**
+ * Log a stream message before it is applied. The block files are synced and the log truncated once enough operations
+ * are logged, see org.jasminegraph.nativestore.wal.checkpoint.records.
+ * */
+void JasmineGraphIncrementalLocalStore::logOperations(WalRecordType type, const std::vector<std::string>& messages) {
+    if (!this->nm->wal) {
+        return;
+    }
+    if (this->nm->wal->needsCheckpoint()) {
+        this->nm->checkpoint();
+    }
+    this->nm->wal->append(type, messages);
+}
+
 std::pair<std::string, unsigned int> JasmineGraphIncrementalLocalStore::getIDs(std::string edgeString) {
     try {
         auto edgeJson = json::parse(edgeString);
@@ -51,6 +113,11 @@ std::pair<std::string, unsigned int> JasmineGraphIncrementalLocalStore::getIDs(s
 
 
 void JasmineGraphIncrementalLocalStore::addEdgeFromString(std::string edgeString) {
+    logOperations(WalRecordType::MESSAGE, {edgeString});
+    applyMessage(edgeString);
+}
+
+void JasmineGraphIncrementalLocalStore::applyMessage(const std::string& edgeString) {
     try {
         auto edgeJson = json::parse(edgeString);
         incremental_localstore_logger.info(edgeString);
@@ -58,14 +125,12 @@ void JasmineGraphIncrementalLocalStore::addEdgeFromString(std::string edgeString
             std::string nodeId = edgeJson["id"];
             NodeBlock* newNode = this->nm->addNode(nodeId);
 
-            char value[PropertyLink::MAX_VALUE_SIZE] = {};
             char meta[MetaPropertyLink::MAX_VALUE_SIZE] = {};
 
             if (edgeJson.contains("properties")) {
                 auto sourceProps = edgeJson["properties"];
                 for (auto it = sourceProps.begin(); it != sourceProps.end(); it++) {
-                    strcpy(value, it.value().get<std::string>().c_str());
-                    newNode->addProperty(std::string(it.key()), &value[0]);
+                    addNodeProperty(newNode, std::string(it.key()), it.value());
                 }
             }
 
@@ -115,7 +180,99 @@ void JasmineGraphIncrementalLocalStore::addEdgeFromString(std::string edgeString
     }
 }
 
+/**
+ * Add a batch of stream messages in the order they arrived. Runs of edge messages between node messages are written
+ * with one NodeManager::addEdges() call for their local edges and one for their central edges, a node message first
+ * applies the run of edges before it.
+ * */
+void JasmineGraphIncrementalLocalStore::addEdgesFromStrings(const std::vector<std::string>& edgeStrings) {
+    logOperations(WalRecordType::MESSAGE, edgeStrings);
+    std::vector<json> edgeJsons;
+    for (const auto& edgeString : edgeStrings) {
+        try {
+            auto edgeJson = json::parse(edgeString);
+            if (edgeJson.contains("isNode")) {
+                applyEdges(edgeJsons);
+                applyMessage(edgeString);
+                continue;
+            }
+            // Read the node IDs here, a malformed message must not fail the whole batch
+            edgeJson["source"]["id"].get<std::string>();
+            edgeJson["destination"]["id"].get<std::string>();
+            edgeJsons.push_back(std::move(edgeJson));
+        } catch (const std::exception&) {
+            incremental_localstore_logger.log("Error while processing edge data = " + edgeString +
+                                              "Could be due to JSON parsing error", "error");
+        }
+    }
+    applyEdges(edgeJsons);
+}
+
+/**
+ * Write a run of edge messages, the local and the central edges each with one NodeManager::addEdges() call. The
+ * properties of the new edges and of their end nodes are added afterwards in the order of the messages, so a later
+ * message of the run still overwrites a property set by an earlier one. The run is cleared.
+ * */
+void JasmineGraphIncrementalLocalStore::applyEdges(std::vector<json>& edgeJsons) {
+    if (edgeJsons.empty()) {
+        return;
+    }
+    std::vector<std::pair<std::string, std::string>> edges[2];  // Local edges, central edges
+    std::vector<size_t> messages[2];
+    for (size_t i = 0; i < edgeJsons.size(); i++) {
+        int group = edgeJsons[i]["EdgeType"] == "Local" ? 0 : 1;
+        edges[group].push_back({edgeJsons[i]["source"]["id"].get<std::string>(),
+                                edgeJsons[i]["destination"]["id"].get<std::string>()});
+        messages[group].push_back(i);
+    }
+    std::vector<unsigned long> addresses(edgeJsons.size(), 0);
+    for (int group = 0; group < 2; group++) {
+        if (edges[group].empty()) {
+            continue;
+        }
+        std::vector<unsigned long> added = this->nm->addEdges(edges[group], group == 1);
+        for (size_t i = 0; i < added.size(); i++) {
+            addresses[messages[group][i]] = added[i];
+        }
+        incremental_localstore_logger.debug("Added a batch of " + std::to_string(edges[group].size()) +
+                                            (group == 0 ? " local" : " central") + " edges");
+    }
+    for (size_t i = 0; i < edgeJsons.size(); i++) {
+        if (addresses[i] == 0) {
+            continue;
+        }
+        const json& edgeJson = edgeJsons[i];
+        bool isLocal = edgeJson["EdgeType"] == "Local";
+        try {
+            std::unique_ptr<RelationBlock> newRelation(isLocal ? RelationBlock::getLocalRelation(addresses[i])
+                                                               : RelationBlock::getCentralRelation(addresses[i]));
+            if (!newRelation || !newRelation->getSource() || !newRelation->getDestination()) {
+                continue;
+            }
+            std::unique_ptr<NodeBlock> source(newRelation->getSource());
+            std::unique_ptr<NodeBlock> destination(newRelation->getDestination());
+            if (isLocal) {
+                addLocalEdgeProperties(newRelation.get(), edgeJson);
+            } else {
+                addCentralEdgeProperties(newRelation.get(), edgeJson);
+            }
+            addSourceProperties(newRelation.get(), edgeJson["source"]);
+            addDestinationProperties(newRelation.get(), edgeJson["destination"]);
+        } catch (const std::exception&) {
+            incremental_localstore_logger.log("Error while adding the properties of edge (" +
+                                              edgeJson["source"]["id"].get<std::string>() + ", " +
+                                              edgeJson["destination"]["id"].get<std::string>() + ")", "error");
+        }
+    }
+    edgeJsons.clear();
+}
+
 void JasmineGraphIncrementalLocalStore::addLocalEdge(std::string edge) {
+    logOperations(WalRecordType::LOCAL_EDGE, {edge});
+    applyLocalEdge(edge);
+}
+
+void JasmineGraphIncrementalLocalStore::applyLocalEdge(const std::string& edge) {
     auto jsonEdge = json::parse(edge);
     auto jsonSource = jsonEdge["source"];
     auto jsonDestination = jsonEdge["destination"];
@@ -138,6 +295,11 @@ void JasmineGraphIncrementalLocalStore::addLocalEdge(std::string edge) {
 }
 
 void JasmineGraphIncrementalLocalStore::addCentralEdge(std::string edge) {
+    logOperations(WalRecordType::CENTRAL_EDGE, {edge});
+    applyCentralEdge(edge);
+}
+
+void JasmineGraphIncrementalLocalStore::applyCentralEdge(const std::string& edge) {
     auto jsonEdge = json::parse(edge);
     auto jsonSource = jsonEdge["source"];
     auto jsonDestination = jsonEdge["destination"];
@@ -160,17 +322,13 @@ void JasmineGraphIncrementalLocalStore::addCentralEdge(std::string edge) {
 }
 
 void JasmineGraphIncrementalLocalStore::addCentralEdgeProperties(RelationBlock* relationBlock, const json& edgeJson) {
-    char value[PropertyLink::MAX_VALUE_SIZE] = {};
-    char type[RelationBlock::MAX_TYPE_SIZE] = {0};
     if (edgeJson.contains("properties")) {
         auto edgeProperties = edgeJson["properties"];
         for (auto it = edgeProperties.begin(); it != edgeProperties.end(); it++) {
-            strcpy(value, it.value().get<std::string>().c_str());
             if (std::string(it.key()) == "type") {
-                strcpy(type, it.value().get<std::string>().c_str());
-                relationBlock->addCentralRelationshipType(&type[0]);
+                relationBlock->addCentralRelationshipType(it.value().get<std::string>());
             }
-            relationBlock->addCentralProperty(std::string(it.key()), &value[0]);
+            relationBlock->addCentralProperty(std::string(it.key()), toPropertyValue(it.value()));
         }
     }
     std::string edgePid = std::to_string(edgeJson["source"]["pid"].get<int>());
@@ -178,33 +336,27 @@ void JasmineGraphIncrementalLocalStore::addCentralEdgeProperties(RelationBlock*
 }
 
 void JasmineGraphIncrementalLocalStore::addLocalEdgeProperties(RelationBlock* relationBlock, const json& edgeJson) {
-    char value[PropertyLink::MAX_VALUE_SIZE] = {};
-    char type[RelationBlock::MAX_TYPE_SIZE] = {0};
     if (edgeJson.contains("properties")) {
         auto edgeProperties = edgeJson["properties"];
         for (auto it = edgeProperties.begin(); it != edgeProperties.end(); it++) {
-            strcpy(value, it.value().get<std::string>().c_str());
             if (std::string(it.key()) == "type") {
-                strcpy(type, it.value().get<std::string>().c_str());
-                relationBlock->addLocalRelationshipType(&type[0]);
+                relationBlock->addLocalRelationshipType(it.value().get<std::string>());
             }
-            relationBlock->addLocalProperty(std::string(it.key()), &value[0]);
+            relationBlock->addLocalProperty(std::string(it.key()), toPropertyValue(it.value()));
         }
     }
 }
 
 void JasmineGraphIncrementalLocalStore::addSourceProperties(RelationBlock* relationBlock, const json& sourceJson) {
-    char value[PropertyLink::MAX_VALUE_SIZE] = {};
     char label[NodeBlock::LABEL_SIZE] = {0};
     if (sourceJson.contains("properties")) {
         auto sourceProps = sourceJson["properties"];
         for (auto it = sourceProps.begin(); it != sourceProps.end(); it++) {
-            strcpy(value, it.value().get<std::string>().c_str());
             if (std::string(it.key()) == "label") {
                 strcpy(label, it.value().get<std::string>().c_str());
                 relationBlock->getSource()->addLabel(&label[0]);
             }
-            relationBlock->getSource()->addProperty(std::string(it.key()), &value[0]);
+            addNodeProperty(relationBlock->getSource(), std::string(it.key()), it.value());
         }
     }
     std::string sourcePid = std::to_string(sourceJson["pid"].get<int>());
@@ -214,17 +366,15 @@ void JasmineGraphIncrementalLocalStore::addSourceProperties(RelationBlock* relat
 
 void JasmineGraphIncrementalLocalStore::addDestinationProperties(RelationBlock* relationBlock,
     const json& destinationJson) {
-    char value[PropertyLink::MAX_VALUE_SIZE] = {};
     char label[NodeBlock::LABEL_SIZE] = {0};
     if (destinationJson.contains("properties")) {
         auto destinationProps = destinationJson["properties"];
         for (auto it = destinationProps.begin(); it != destinationProps.end(); it++) {
-            strcpy(value, it.value().get<std::string>().c_str());
             if (std::string(it.key()) == "label") {
                 strcpy(label, it.value().get<std::string>().c_str());
                 relationBlock->getDestination()->addLabel(&label[0]);
             }
-            relationBlock->getDestination()->addProperty(std::string(it.key()), &value[0]);
+            addNodeProperty(relationBlock->getDestination(), std::string(it.key()), it.value());
         }
     }
     std::string destPId = std::to_string(destinationJson["pid"].get<int>());
@@ -232,6 +382,16 @@ void JasmineGraphIncrementalLocalStore::addDestinationProperties(RelationBlock*
                         destPId);
 }
 
+/**
+ * Add a property to a node and to the index of the property, if the property is indexed
+ * */
+void JasmineGraphIncrementalLocalStore::addNodeProperty(NodeBlock* nodeBlock, const std::string& propertyKey,
+                                                        const json& propertyValue) {
+    PropertyValue value = toPropertyValue(propertyValue);
+    nodeBlock->addProperty(propertyKey, value);
+    this->nm->propertyIndex->insert(propertyKey, value, nodeBlock->addr / NodeBlock::BLOCK_SIZE);
+}
+
 void JasmineGraphIncrementalLocalStore::addNodeMetaProperty(NodeBlock* nodeBlock,
                                                         std::string propertyKey, std::string propertyValue) {
     char meta[MetaPropertyLink::MAX_VALUE_SIZE] = {};
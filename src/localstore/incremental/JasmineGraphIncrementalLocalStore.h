@@ -13,6 +13,7 @@ limitations under the License.
 
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 using json = nlohmann::json;
 
 #include "../../nativestore/NodeManager.h"
@@ -24,17 +25,29 @@ class JasmineGraphIncrementalLocalStore {
     GraphConfig gc;
     NodeManager *nm;
     void addEdgeFromString(std::string edgeString);
+    // Add a batch of stream messages in arrival order, runs of edges are written with NodeManager::addEdges()
+    void addEdgesFromStrings(const std::vector<std::string>& edgeStrings);
     static std::pair<std::string, unsigned int> getIDs(std::string edgeString);
     JasmineGraphIncrementalLocalStore(unsigned int graphID = 0,
                                       unsigned int partitionID = 0, std::string openMode = "trunk");
     void addLocalEdge(std::string edge);
     void addCentralEdge(std::string edge);
     void addNodeMetaProperty(NodeBlock* nodeBlock, std::string propertyKey, std::string propertyValue);
+    void addNodeProperty(NodeBlock* nodeBlock, const std::string& propertyKey, const json& propertyValue);
     void addRelationMetaProperty(RelationBlock* relationBlock, std::string propertyKey, std::string propertyValue);
     void addLocalEdgeProperties(RelationBlock* relationBlock, const json& edgeJson);
     void addCentralEdgeProperties(RelationBlock* relationBlock, const json& edgeJson);
     void addSourceProperties(RelationBlock* relationBlock, const json& sourceJson);
     void addDestinationProperties(RelationBlock* relationBlock, const json& destinationJson);
+
+ private:
+    // Apply an operation without logging it
+    void applyMessage(const std::string& edgeString);
+    void applyLocalEdge(const std::string& edge);
+    void applyCentralEdge(const std::string& edge);
+    void applyEdges(std::vector<json>& edgeJsons);
+    void replayLog();
+    void logOperations(WalRecordType type, const std::vector<std::string>& messages);
 };
 
 #endif
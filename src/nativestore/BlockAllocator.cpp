@@ -0,0 +1,303 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "BlockAllocator.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "../util/logger/Logger.h"
+#include "MetaPropertyEdgeLink.h"
+#include "MetaPropertyLink.h"
+#include "NodeBlock.h"
+#include "PropertyEdgeLink.h"
+#include "PropertyLink.h"
+#include "RelationBlock.h"
+
+Logger block_allocator_logger;
+
+static const char FREE_BLOCKS_MAGIC[8] = {'J', 'G', 'F', 'R', 'E', 'E', '0', '1'};
+static const unsigned int REUSED_FLAG = 0x80000000;  // Set in the file record of a log entry of a reused block
+
+// Size of the blocks of a block file, to find them in the block cache
+static unsigned long blockSize(BlockFile file) {
+    switch (file) {
+        case BlockFile::NODES:
+            return NodeBlock::BLOCK_SIZE;
+        case BlockFile::RELATIONS:
+            return RelationBlock::BLOCK_SIZE;
+        case BlockFile::CENTRAL_RELATIONS:
+            return RelationBlock::CENTRAL_BLOCK_SIZE;
+        case BlockFile::PROPERTIES:
+            return PropertyLink::PROPERTY_BLOCK_SIZE;
+        case BlockFile::META_PROPERTIES:
+            return MetaPropertyLink::META_PROPERTY_BLOCK_SIZE;
+        case BlockFile::EDGE_PROPERTIES:
+            return PropertyEdgeLink::PROPERTY_BLOCK_SIZE;
+        case BlockFile::META_EDGE_PROPERTIES:
+            return MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE;
+    }
+    return 0;
+}
+
+thread_local BlockAllocator *BlockAllocator::current = nullptr;
+std::map<std::string, BlockAllocator *> BlockAllocator::openAllocators;
+std::mutex BlockAllocator::openAllocatorsLock;
+
+BlockAllocator *BlockAllocator::acquire(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(BlockAllocator::openAllocatorsLock);
+    auto it = BlockAllocator::openAllocators.find(dbPrefix);
+    if (it != BlockAllocator::openAllocators.end()) {
+        it->second->references++;
+        return it->second;
+    }
+    BlockAllocator *allocator = new BlockAllocator(dbPrefix);
+    allocator->references++;
+    BlockAllocator::openAllocators[dbPrefix] = allocator;
+    return allocator;
+}
+
+void BlockAllocator::release(BlockAllocator *allocator) {
+    if (!allocator) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(BlockAllocator::openAllocatorsLock);
+    if (--allocator->references > 0) {
+        return;
+    }
+    BlockAllocator::openAllocators.erase(allocator->dbPrefix);
+    allocator->flush();
+    if (BlockAllocator::current == allocator) {
+        BlockAllocator::current = nullptr;
+    }
+    delete allocator;
+}
+
+bool BlockAllocator::isShared() {
+    std::lock_guard<std::mutex> guard(BlockAllocator::openAllocatorsLock);
+    return this->references > 1;
+}
+
+BlockAllocator::BlockAllocator(const std::string &dbPrefix) : dbPrefix(dbPrefix) {
+    for (unsigned int file = 0; file < BlockAllocator::BLOCK_FILES; file++) {
+        this->nextBlocks[file] = 0;
+        this->initialized[file] = false;
+        this->freeCounts[file] = 0;
+        this->freeChanges[file] = 0;
+    }
+    this->loadFreeBlocks();
+}
+
+BlockAllocator::~BlockAllocator() {
+    if (this->freeLogFd >= 0) {
+        ::close(this->freeLogFd);
+    }
+}
+
+/**
+ * Replay the log of freed and reused blocks in _free_blocks.db. A log that ends in a partial record, after a crash
+ * during an append, is read up to the last complete record.
+ * */
+void BlockAllocator::loadFreeBlocks() {
+    std::string path = this->dbPrefix + "_free_blocks.db";
+    this->freeLogFd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->freeLogFd < 0) {
+        block_allocator_logger.error("Error while opening the free blocks of " + this->dbPrefix);
+        return;
+    }
+    off_t size = lseek(this->freeLogFd, 0, SEEK_END);
+    std::vector<char> log(size > 0 ? size : 0);
+    if (size > 0 && pread(this->freeLogFd, log.data(), log.size(), 0) != size) {
+        block_allocator_logger.error("Error while reading the free blocks of " + this->dbPrefix);
+        log.clear();
+    }
+    if (log.size() < sizeof(FREE_BLOCKS_MAGIC) ||
+        std::memcmp(log.data(), FREE_BLOCKS_MAGIC, sizeof(FREE_BLOCKS_MAGIC)) != 0) {
+        this->saveFreeBlocks();  // No blocks were freed yet
+        return;
+    }
+    for (size_t offset = sizeof(FREE_BLOCKS_MAGIC); offset + 2 * sizeof(unsigned int) <= log.size();
+         offset += 2 * sizeof(unsigned int)) {
+        unsigned int record[2];  // File, block index
+        std::memcpy(record, log.data() + offset, sizeof(record));
+        unsigned int file = record[0] & ~REUSED_FLAG;
+        if (file >= BlockAllocator::BLOCK_FILES) {
+            continue;
+        }
+        std::vector<unsigned int> &blocks = this->freeBlocks[file];
+        if (!(record[0] & REUSED_FLAG)) {
+            blocks.push_back(record[1]);
+        } else if (!blocks.empty() && blocks.back() == record[1]) {
+            blocks.pop_back();
+        }
+    }
+    for (unsigned int file = 0; file < BlockAllocator::BLOCK_FILES; file++) {
+        this->freeCounts[file] = this->freeBlocks[file].size();
+    }
+}
+
+// Append an entry to the free block log, called with freeLock held
+void BlockAllocator::logFreeBlock(unsigned int file, unsigned int block, bool reused) {
+    if (this->freeLogFd < 0) {
+        return;
+    }
+    unsigned int record[2] = {reused ? file | REUSED_FLAG : file, block};
+    off_t end = lseek(this->freeLogFd, 0, SEEK_END);
+    if (pwrite(this->freeLogFd, record, sizeof(record), end) != sizeof(record)) {
+        block_allocator_logger.error("Error while logging free block " + std::to_string(block) + " of " +
+                                     this->dbPrefix);
+    }
+}
+
+// Write the free blocks as a new log that replaces the old one by rename, called with freeLock held
+void BlockAllocator::saveFreeBlocks() {
+    std::string path = this->dbPrefix + "_free_blocks.db";
+    std::vector<char> log(FREE_BLOCKS_MAGIC, FREE_BLOCKS_MAGIC + sizeof(FREE_BLOCKS_MAGIC));
+    for (unsigned int file = 0; file < BlockAllocator::BLOCK_FILES; file++) {
+        for (unsigned int block : this->freeBlocks[file]) {
+            unsigned int record[2] = {file, block};
+            log.insert(log.end(), reinterpret_cast<char *>(record), reinterpret_cast<char *>(record) + sizeof(record));
+        }
+    }
+    int fd = ::open((path + ".tmp").c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || write(fd, log.data(), log.size()) != (ssize_t)log.size() ||
+        std::rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+        block_allocator_logger.error("Error while writing the free blocks of " + this->dbPrefix);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return;
+    }
+    if (this->freeLogFd >= 0) {
+        ::close(this->freeLogFd);
+    }
+    this->freeLogFd = fd;
+}
+
+void BlockAllocator::initialize(BlockFile file, unsigned int next, bool reset) {
+    std::lock_guard<std::mutex> guard(this->initializeLock);
+    if (this->initialized[static_cast<unsigned int>(file)] && !reset) {
+        return;
+    }
+    this->nextBlocks[static_cast<unsigned int>(file)] = next;
+    this->initialized[static_cast<unsigned int>(file)] = true;
+    if (reset) {
+        this->freeChanges[static_cast<unsigned int>(file)]++;
+    }
+    if (reset && this->freeCounts[static_cast<unsigned int>(file)] > 0) {
+        this->setFreeBlocks(file, {});  // The blocks of a truncated file are gone
+    }
+}
+
+unsigned int BlockAllocator::allocate(BlockFile file, unsigned int count) {
+    unsigned int index = static_cast<unsigned int>(file);
+    if (count == 1 && this->freeCounts[index] > 0) {
+        std::unique_lock<std::mutex> guard(this->freeLock);
+        if (!this->freeBlocks[index].empty()) {
+            unsigned int block = this->freeBlocks[index].back();
+            this->freeBlocks[index].pop_back();
+            this->freeCounts[index] = this->freeBlocks[index].size();
+            this->freeChanges[index]++;
+            this->logFreeBlock(index, block, true);
+            guard.unlock();
+            // The block cache may still hold the block as it was before it was freed
+            BlockCache::getInstance()->discard(file, (unsigned long)block * blockSize(file));
+            return block;
+        }
+    }
+    return this->nextBlocks[index].fetch_add(count);
+}
+
+unsigned int BlockAllocator::append(BlockFile file, unsigned int count) {
+    return this->nextBlocks[static_cast<unsigned int>(file)].fetch_add(count);
+}
+
+void BlockAllocator::free(BlockFile file, unsigned int block) {
+    unsigned int index = static_cast<unsigned int>(file);
+    BlockCache::getInstance()->discard(file, (unsigned long)block * blockSize(file));
+    std::lock_guard<std::mutex> guard(this->freeLock);
+    this->freeBlocks[index].push_back(block);
+    this->freeCounts[index] = this->freeBlocks[index].size();
+    this->freeChanges[index]++;
+    this->logFreeBlock(index, block, false);
+}
+
+unsigned int BlockAllocator::freeCount(BlockFile file) { return this->freeCounts[static_cast<unsigned int>(file)]; }
+
+unsigned long BlockAllocator::freeListChanges(BlockFile file) {
+    return this->freeChanges[static_cast<unsigned int>(file)];
+}
+
+void BlockAllocator::setFreeBlocks(BlockFile file, const std::vector<unsigned int> &blocks) {
+    unsigned int index = static_cast<unsigned int>(file);
+    std::lock_guard<std::mutex> guard(this->freeLock);
+    this->freeBlocks[index] = blocks;
+    this->freeCounts[index] = blocks.size();
+    this->freeChanges[index]++;
+    this->saveFreeBlocks();
+}
+
+void BlockAllocator::flush() {
+    std::lock_guard<std::mutex> guard(this->freeLock);
+    this->saveFreeBlocks();
+}
+
+unsigned int BlockAllocator::next(BlockFile file) { return this->nextBlocks[static_cast<unsigned int>(file)]; }
+
+unsigned int BlockAllocator::stripe(const std::string &nodeId) {
+    unsigned long long hash = 14695981039346656037ULL;  // FNV-1a
+    for (unsigned char c : nodeId) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash % BlockAllocator::LOCK_STRIPES;
+}
+
+std::mutex &BlockAllocator::nodeLock(const std::string &nodeId) { return this->stripes[this->stripe(nodeId)]; }
+
+void BlockAllocator::lockNodes(const std::string &first, const std::string &second) {
+    unsigned int firstStripe = this->stripe(first);
+    unsigned int secondStripe = this->stripe(second);
+    if (firstStripe > secondStripe) {
+        std::swap(firstStripe, secondStripe);
+    }
+    this->stripes[firstStripe].lock();
+    if (secondStripe != firstStripe) {
+        this->stripes[secondStripe].lock();
+    }
+}
+
+void BlockAllocator::unlockNodes(const std::string &first, const std::string &second) {
+    unsigned int firstStripe = this->stripe(first);
+    unsigned int secondStripe = this->stripe(second);
+    this->stripes[firstStripe].unlock();
+    if (secondStripe != firstStripe) {
+        this->stripes[secondStripe].unlock();
+    }
+}
+
+void BlockAllocator::lockAll() {
+    for (auto &stripe : this->stripes) {
+        stripe.lock();
+    }
+}
+
+void BlockAllocator::unlockAll() {
+    for (auto &stripe : this->stripes) {
+        stripe.unlock();
+    }
+}
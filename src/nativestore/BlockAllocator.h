@@ -0,0 +1,106 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_BLOCKALLOCATOR_H
+#define JASMINEGRAPH_BLOCKALLOCATOR_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "BlockCache.h"
+
+/**
+ * Block allocation and write locks of a native store partition.
+ *
+ * Every block file of the partition has an atomic counter of its next free block index, so NodeManagers in different
+ * threads append blocks to the same partition without handing out a block twice. Inserts of nodes and edges lock the
+ * stripes of the node IDs they touch instead of one lock for the whole store. An edge insert holds the stripes of both
+ * of its nodes, which covers the relation chains of the nodes and the duplicate check of the edge.
+ *
+ * Blocks of deleted relations and properties are returned with free() and handed out again by allocate() before the
+ * file grows. The free blocks of every file are kept in _free_blocks.db, a log of the blocks freed and reused that is
+ * rewritten with only the free blocks by flush().
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see BlockAllocator::acquire().
+ * */
+class BlockAllocator {
+ public:
+    static BlockAllocator *acquire(const std::string &dbPrefix);
+    static void release(BlockAllocator *allocator);
+    // Whether more than one NodeManager of the partition is open
+    bool isShared();
+
+    // Set the next free block of a file from its size. Only the first NodeManager of the partition sets it, unless
+    // reset is set because the file was truncated or repaired
+    void initialize(BlockFile file, unsigned int next, bool reset = false);
+    // Index of the first of count consecutive free blocks of the file, a single block is taken from the freed blocks
+    // of the file if there are any
+    unsigned int allocate(BlockFile file, unsigned int count = 1);
+    // Index of the first of count blocks at the end of the file, for writes of consecutive blocks
+    unsigned int append(BlockFile file, unsigned int count);
+    // Return a block that is no longer used, the caller has already marked it unused in the block file
+    void free(BlockFile file, unsigned int block);
+    unsigned int freeCount(BlockFile file);
+    // Number of blocks of the file freed or handed out again, and of free lists and next blocks reset, since the
+    // allocator was opened. While it does not change, the blocks written since a saved next() are the blocks past it
+    unsigned long freeListChanges(BlockFile file);
+    // Replace the freed blocks of the file, when they are found again by a scan of the block file
+    void setFreeBlocks(BlockFile file, const std::vector<unsigned int> &blocks);
+    // Rewrite _free_blocks.db with the blocks that are free now
+    void flush();
+    // Next free block of the file, the number of blocks in use including unused block 0 of most files
+    unsigned int next(BlockFile file);
+
+    std::mutex &nodeLock(const std::string &nodeId);
+    // Lock the stripes of two nodes, in stripe order so that concurrent edge inserts do not deadlock
+    void lockNodes(const std::string &first, const std::string &second);
+    void unlockNodes(const std::string &first, const std::string &second);
+    // Lock every stripe, for batches that touch many nodes
+    void lockAll();
+    void unlockAll();
+
+    // Allocator of the partition attached to the calling thread, NULL if none
+    static thread_local BlockAllocator *current;
+
+    static const unsigned int LOCK_STRIPES = 64;
+    static const unsigned int BLOCK_FILES = 7;
+
+ private:
+    explicit BlockAllocator(const std::string &dbPrefix);
+    ~BlockAllocator();
+
+    unsigned int stripe(const std::string &nodeId);
+    void loadFreeBlocks();
+    void logFreeBlock(unsigned int file, unsigned int block, bool reused);
+    void saveFreeBlocks();
+
+    std::string dbPrefix;
+    std::atomic<unsigned int> nextBlocks[BLOCK_FILES];
+    bool initialized[BLOCK_FILES];
+    std::vector<unsigned int> freeBlocks[BLOCK_FILES];
+    std::atomic<unsigned int> freeCounts[BLOCK_FILES];  // Sizes of freeBlocks, read without taking freeLock
+    std::atomic<unsigned long> freeChanges[BLOCK_FILES];
+    int freeLogFd = -1;
+    std::mutex freeLock;
+    std::mutex stripes[LOCK_STRIPES];
+    std::mutex initializeLock;
+    int references = 0;
+
+    static std::map<std::string, BlockAllocator *> openAllocators;
+    static std::mutex openAllocatorsLock;
+};
+
+#endif  // JASMINEGRAPH_BLOCKALLOCATOR_H
@@ -0,0 +1,276 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "BlockCache.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "../util/Utils.h"
+#include "../util/logger/Logger.h"
+
+Logger block_cache_logger;
+
+thread_local unsigned int BlockCache::partition = 0;
+
+// Approximate bookkeeping cost of a resident block on top of its data (frame, index entry)
+static const unsigned long FRAME_OVERHEAD = 64;
+// Block keys pack partition id (16 bits), block file and byte address, 2^32 property blocks need 44 address bits
+static const unsigned int ADDRESS_BITS = 44;
+static const unsigned int FILE_BITS = 4;
+
+static const char *BLOCK_FILE_SUFFIXES[] = {"_nodes.db",      "_relations.db",      "_central_relations.db",
+                                            "_properties.db", "_meta_properties.db", "_edge_properties.db",
+                                            "_meta_edge_properties.db"};
+
+BlockCache::BlockCache(unsigned long capacityBytes) : capacity(capacityBytes) {
+    this->partitionPrefixes.push_back("");  // Partition id 0 means no partition attached
+}
+
+BlockCache::~BlockCache() {
+    for (unsigned int partitionId = 1; partitionId < this->partitionPrefixes.size(); partitionId++) {
+        this->flush(partitionId);
+    }
+    for (auto &entry : this->writeFds) {
+        close(entry.second);
+    }
+}
+
+BlockCache *BlockCache::getInstance() {
+    static BlockCache *instance = nullptr;
+    static std::once_flag created;
+    std::call_once(created, []() {
+        unsigned long cacheSizeMB = BlockCache::DEFAULT_CACHE_SIZE_MB;
+        std::string cacheSize = Utils::getJasmineGraphProperty("org.jasminegraph.nativestore.cache.size");
+        if (!cacheSize.empty()) {
+            try {
+                cacheSizeMB = std::stoul(cacheSize);
+            } catch (std::exception &e) {
+                block_cache_logger.warn("Invalid native store cache size " + cacheSize + ", using " +
+                                        std::to_string(cacheSizeMB) + " MB");
+            }
+        }
+        block_cache_logger.info("Native store block cache size: " + std::to_string(cacheSizeMB) + " MB");
+        instance = new BlockCache(cacheSizeMB * 1024 * 1024);
+    });
+    return instance;
+}
+
+unsigned int BlockCache::attach(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    auto it = this->partitionIds.find(dbPrefix);
+    unsigned int partitionId;
+    if (it != this->partitionIds.end()) {
+        partitionId = it->second;
+    } else {
+        partitionId = this->partitionPrefixes.size();
+        this->partitionPrefixes.push_back(dbPrefix);
+        this->partitionIds[dbPrefix] = partitionId;
+    }
+    BlockCache::partition = partitionId;
+    return partitionId;
+}
+
+unsigned long long BlockCache::key(unsigned int partitionId, BlockFile file, unsigned long blockAddress) {
+    return (static_cast<unsigned long long>(partitionId) << (ADDRESS_BITS + FILE_BITS)) |
+           (static_cast<unsigned long long>(file) << ADDRESS_BITS) | blockAddress;
+}
+
+bool BlockCache::lookup(unsigned long long key, char *block, unsigned long blockSize) {
+    auto it = this->frameIndex.find(key);
+    if (it == this->frameIndex.end()) {
+        this->misses++;
+        return false;
+    }
+    Frame &frame = this->frames[it->second];
+    frame.referenced = true;
+    std::memcpy(block, frame.data.data(), std::min(blockSize, (unsigned long)frame.data.size()));
+    this->hits++;
+    return true;
+}
+
+void BlockCache::insert(unsigned long long key, const char *block, unsigned long blockSize) {
+    unsigned long cost = blockSize + FRAME_OVERHEAD;
+    if (cost > this->capacity) {
+        return;
+    }
+    while (this->used + cost > this->capacity) {
+        if (!this->evictNext()) {
+            return;
+        }
+    }
+    size_t index;
+    if (!this->freeFrames.empty()) {
+        index = this->freeFrames.back();
+        this->freeFrames.pop_back();
+    } else {
+        index = this->frames.size();
+        this->frames.emplace_back();
+    }
+    Frame &frame = this->frames[index];
+    frame.key = key;
+    frame.valid = true;
+    frame.referenced = false;  // Set on the first hit, so that blocks read only once are evicted first
+    frame.dirty = false;
+    frame.data.assign(block, block + blockSize);
+    this->frameIndex[key] = index;
+    this->used += cost;
+}
+
+/**
+ * Advance the clock hand until an unreferenced block is found and evict it, giving referenced blocks a second chance
+ * */
+bool BlockCache::evictNext() {
+    if (this->frameIndex.empty()) {
+        return false;
+    }
+    while (true) {
+        if (this->clockHand >= this->frames.size()) {
+            this->clockHand = 0;
+        }
+        Frame &frame = this->frames[this->clockHand];
+        if (frame.valid) {
+            if (frame.referenced) {
+                frame.referenced = false;
+            } else {
+                this->drop(this->clockHand++, true);
+                this->evictions++;
+                return true;
+            }
+        }
+        this->clockHand++;
+    }
+}
+
+void BlockCache::drop(size_t index, bool writeBack) {
+    Frame &frame = this->frames[index];
+    if (writeBack && frame.dirty) {
+        this->writeFrame(frame);
+    }
+    this->frameIndex.erase(frame.key);
+    this->used -= frame.data.size() + FRAME_OVERHEAD;
+    frame.valid = false;
+    frame.dirty = false;
+    std::vector<char>().swap(frame.data);
+    this->freeFrames.push_back(index);
+}
+
+bool BlockCache::writeFrame(const Frame &frame) {
+    unsigned long long fileKey = frame.key >> ADDRESS_BITS;
+    unsigned long blockAddress = frame.key & ((1ULL << ADDRESS_BITS) - 1);
+    int fd;
+    auto it = this->writeFds.find(fileKey);
+    if (it != this->writeFds.end()) {
+        fd = it->second;
+    } else {
+        unsigned int partitionId = fileKey >> FILE_BITS;
+        std::string path = this->partitionPrefixes[partitionId] + BLOCK_FILE_SUFFIXES[fileKey & ((1 << FILE_BITS) - 1)];
+        fd = open(path.c_str(), O_WRONLY);
+        if (fd < 0) {
+            block_cache_logger.error("Error while opening " + path + " to write back cached blocks");
+            return false;
+        }
+        this->writeFds[fileKey] = fd;
+    }
+    if (pwrite(fd, frame.data.data(), frame.data.size(), blockAddress) != (ssize_t)frame.data.size()) {
+        block_cache_logger.error("Error while writing back cached block " + std::to_string(blockAddress));
+        return false;
+    }
+    this->writeBacks++;
+    return true;
+}
+
+void BlockCache::patch(unsigned long long key, unsigned long offset, const char *data, unsigned long length,
+                       bool dirty) {
+    Frame &frame = this->frames[this->frameIndex[key]];
+    if (offset + length > frame.data.size()) {
+        block_cache_logger.error("Block update at offset " + std::to_string(offset) + " is out of the cached block");
+        return;
+    }
+    std::memcpy(frame.data.data() + offset, data, length);
+    frame.dirty = frame.dirty || dirty;
+}
+
+bool BlockCache::writeBack(BlockFile file, unsigned long blockAddress, unsigned long offset, const char *data,
+                           unsigned long length) {
+    if (!this->capacity || !BlockCache::partition) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(this->lock);
+    unsigned long long key = BlockCache::key(BlockCache::partition, file, blockAddress);
+    if (this->frameIndex.find(key) == this->frameIndex.end()) {
+        return false;
+    }
+    this->patch(key, offset, data, length, true);
+    return true;
+}
+
+void BlockCache::update(BlockFile file, unsigned long blockAddress, unsigned long offset, const char *data,
+                        unsigned long length) {
+    if (!this->capacity || !BlockCache::partition) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(this->lock);
+    unsigned long long key = BlockCache::key(BlockCache::partition, file, blockAddress);
+    if (this->frameIndex.find(key) != this->frameIndex.end()) {
+        this->patch(key, offset, data, length, false);
+    }
+}
+
+void BlockCache::discard(BlockFile file, unsigned long blockAddress) {
+    if (!this->capacity || !BlockCache::partition) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(this->lock);
+    auto it = this->frameIndex.find(BlockCache::key(BlockCache::partition, file, blockAddress));
+    if (it != this->frameIndex.end()) {
+        this->drop(it->second, false);
+    }
+}
+
+void BlockCache::flush(unsigned int partitionId) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (Frame &frame : this->frames) {
+        if (frame.valid && frame.dirty && (frame.key >> (ADDRESS_BITS + FILE_BITS)) == partitionId) {
+            if (this->writeFrame(frame)) {
+                frame.dirty = false;
+            }
+        }
+    }
+}
+
+void BlockCache::invalidate(unsigned int partitionId) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (size_t index = 0; index < this->frames.size(); index++) {
+        Frame &frame = this->frames[index];
+        if (frame.valid && (frame.key >> (ADDRESS_BITS + FILE_BITS)) == partitionId) {
+            this->drop(index, false);
+        }
+    }
+    for (auto it = this->writeFds.begin(); it != this->writeFds.end();) {
+        if ((it->first >> FILE_BITS) == partitionId) {
+            close(it->second);
+            it = this->writeFds.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+BlockCacheStats BlockCache::getStats() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return BlockCacheStats{this->hits,     this->misses,  this->evictions, this->writeBacks, this->frameIndex.size(),
+                           this->used};
+}
@@ -0,0 +1,138 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_BLOCKCACHE_H
+#define JASMINEGRAPH_BLOCKCACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Block files of a native store partition that go through the block cache
+enum class BlockFile : unsigned int {
+    NODES = 0,
+    RELATIONS = 1,
+    CENTRAL_RELATIONS = 2,
+    PROPERTIES = 3,
+    META_PROPERTIES = 4,
+    EDGE_PROPERTIES = 5,
+    META_EDGE_PROPERTIES = 6
+};
+
+struct BlockCacheStats {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    unsigned long writeBacks;
+    unsigned long residentBlocks;
+    unsigned long residentBytes;
+};
+
+/**
+ * Process wide buffer pool for native store blocks, keyed by (partition, block file, block address).
+ *
+ * Blocks are loaded on a miss through the caller's loader (the partition's fstream or memory mapping) and evicted with
+ * the CLOCK algorithm once the configured memory budget (org.jasminegraph.nativestore.cache.size in MB) is used up.
+ * Updates to blocks that are already resident can be kept in the pool as dirty blocks and are written back on eviction
+ * or when the partition is flushed. The partition used by the block classes is attached per thread, the same way their
+ * DB streams are.
+ * */
+class BlockCache {
+ public:
+    explicit BlockCache(unsigned long capacityBytes);
+    ~BlockCache();
+
+    BlockCache(const BlockCache &) = delete;
+    BlockCache &operator=(const BlockCache &) = delete;
+
+    static BlockCache *getInstance();
+
+    // Register the partition with the given DB prefix (if needed) and use it for block lookups of the calling thread
+    unsigned int attach(const std::string &dbPrefix);
+    static void detach() { partition = 0; }
+
+    // Copy the block into `block`, calling loader(block) to read it from the file on a miss
+    template <typename Loader>
+    bool read(BlockFile file, unsigned long blockAddress, char *block, unsigned long blockSize, Loader loader) {
+        if (!this->capacity || !BlockCache::partition) {
+            return loader(block);
+        }
+        std::lock_guard<std::mutex> guard(this->lock);
+        unsigned long long key = BlockCache::key(BlockCache::partition, file, blockAddress);
+        if (this->lookup(key, block, blockSize)) {
+            return true;
+        }
+        // The loader runs under the pool lock so that a concurrent update can not slip in between the read and insert
+        if (!loader(block)) {
+            return false;
+        }
+        this->insert(key, block, blockSize);
+        return true;
+    }
+
+    // Patch a resident block and mark it dirty. Returns false if the block is not resident, then the caller writes to
+    // the file itself and calls update().
+    bool writeBack(BlockFile file, unsigned long blockAddress, unsigned long offset, const char *data,
+                   unsigned long length);
+    // Keep a resident block in line with data the caller has already written to the file
+    void update(BlockFile file, unsigned long blockAddress, unsigned long offset, const char *data,
+                unsigned long length);
+    // Drop a resident block without writing it back, for blocks that are freed or handed out again
+    void discard(BlockFile file, unsigned long blockAddress);
+
+    void flush(unsigned int partitionId);
+    void invalidate(unsigned int partitionId);  // Drops the partition's blocks without writing them back
+
+    BlockCacheStats getStats();
+    unsigned long getCapacity() { return capacity; }
+
+    static const unsigned long DEFAULT_CACHE_SIZE_MB = 128;
+    static thread_local unsigned int partition;  // Partition attached to the calling thread, 0 if none
+
+ private:
+    struct Frame {
+        unsigned long long key;
+        bool valid;
+        bool referenced;
+        bool dirty;
+        std::vector<char> data;
+    };
+
+    static unsigned long long key(unsigned int partitionId, BlockFile file, unsigned long blockAddress);
+    bool lookup(unsigned long long key, char *block, unsigned long blockSize);
+    void insert(unsigned long long key, const char *block, unsigned long blockSize);
+    void patch(unsigned long long key, unsigned long offset, const char *data, unsigned long length, bool dirty);
+    bool evictNext();
+    void drop(size_t frameIndex, bool writeBack);
+    bool writeFrame(const Frame &frame);
+
+    unsigned long capacity;
+    unsigned long used = 0;
+    size_t clockHand = 0;
+    std::vector<Frame> frames;
+    std::vector<size_t> freeFrames;
+    std::unordered_map<unsigned long long, size_t> frameIndex;
+    std::vector<std::string> partitionPrefixes;  // Indexed by partition id, id 0 is reserved
+    std::map<std::string, unsigned int> partitionIds;
+    std::map<unsigned long long, int> writeFds;  // Write descriptors for dirty blocks, keyed by (partition, file)
+    std::mutex lock;
+
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+    unsigned long evictions = 0;
+    unsigned long writeBacks = 0;
+};
+
+#endif  // JASMINEGRAPH_BLOCKCACHE_H
@@ -0,0 +1,270 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "BlockFormat.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "../util/logger/Logger.h"
+#include "MetaPropertyEdgeLink.h"
+#include "MetaPropertyLink.h"
+#include "NodeBlock.h"
+#include "PropertyEdgeLink.h"
+#include "PropertyLink.h"
+#include "RelationBlock.h"
+
+Logger block_format_logger;
+
+const unsigned int BlockFormat::BYTE_OFFSETS;
+const unsigned int BlockFormat::BLOCK_INDICES;
+const unsigned int BlockFormat::LATEST;
+thread_local unsigned int BlockFormat::version = BlockFormat::LATEST;
+
+static const char *MIGRATE_SUFFIX = ".migrate";
+static const unsigned long MIGRATE_CHUNK_BLOCKS = 4096;
+
+namespace {
+// A block reference record, at offset in the blocks of a file and pointing to a file of blockSize blocks
+struct ReferenceRecord {
+    unsigned long offset;
+    unsigned long blockSize;
+};
+
+struct BlockFileLayout {
+    std::string suffix;
+    unsigned long blockSize;
+    std::vector<ReferenceRecord> references;
+    bool relations = false;  // Freed relation blocks are marked in their source record and copied as they are
+};
+
+std::vector<BlockFileLayout> blockFileLayouts() {
+    std::vector<ReferenceRecord> localReferences;
+    std::vector<ReferenceRecord> centralReferences;
+    for (int record = 0; record < RelationBlock::NUMBER_OF_CENTRAL_RELATION_RECORDS; record++) {
+        RelationOffsets offset = static_cast<RelationOffsets>(record);
+        unsigned long local = RelationBlock::referenceBlockSize(offset, false);
+        unsigned long central = RelationBlock::referenceBlockSize(offset, true);
+        if (local != 0 && record < RelationBlock::NUMBER_OF_LOCAL_RELATION_RECORDS) {
+            localReferences.push_back({(unsigned long)record * RelationBlock::RECORD_SIZE, local});
+        }
+        if (central != 0) {
+            centralReferences.push_back({(unsigned long)record * RelationBlock::RECORD_SIZE, central});
+        }
+    }
+    return {
+        {"_nodes.db",
+         NodeBlock::BLOCK_SIZE,
+         {{NodeBlock::EDGE_REF_OFFSET, RelationBlock::BLOCK_SIZE},
+          {NodeBlock::CENTRAL_EDGE_REF_OFFSET, RelationBlock::CENTRAL_BLOCK_SIZE},
+          {NodeBlock::PROP_REF_OFFSET, PropertyLink::PROPERTY_BLOCK_SIZE},
+          {NodeBlock::META_PROP_REF_OFFSET, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE}}},
+        {"_relations.db", RelationBlock::BLOCK_SIZE, localReferences, true},
+        {"_central_relations.db", RelationBlock::CENTRAL_BLOCK_SIZE, centralReferences, true},
+        {"_properties.db",
+         PropertyLink::PROPERTY_BLOCK_SIZE,
+         {{PropertyLink::MAX_NAME_SIZE + PropertyLink::MAX_VALUE_SIZE, PropertyLink::PROPERTY_BLOCK_SIZE}}},
+        {"_meta_properties.db",
+         MetaPropertyLink::META_PROPERTY_BLOCK_SIZE,
+         {{MetaPropertyLink::MAX_NAME_SIZE + MetaPropertyLink::MAX_VALUE_SIZE,
+           MetaPropertyLink::META_PROPERTY_BLOCK_SIZE}}},
+        {"_edge_properties.db",
+         PropertyEdgeLink::PROPERTY_BLOCK_SIZE,
+         {{PropertyEdgeLink::MAX_NAME_SIZE + PropertyEdgeLink::MAX_VALUE_SIZE, PropertyEdgeLink::PROPERTY_BLOCK_SIZE}}},
+        {"_meta_edge_properties.db",
+         MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE,
+         {{MetaPropertyEdgeLink::MAX_NAME_SIZE + MetaPropertyEdgeLink::MAX_VALUE_SIZE,
+           MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE}}},
+    };
+}
+
+bool fileExists(const std::string &path) {
+    struct stat stat_buf;
+    return stat(path.c_str(), &stat_buf) == 0;
+}
+
+/**
+ * Write a copy of a format 1 block file with its byte offset references replaced by block indices. Blocks are read
+ * and written in chunks, a partial block at the end of the file is copied as it is.
+ * */
+bool convertBlockFile(const std::string &path, const BlockFileLayout &layout) {
+    std::ifstream blockFile(path, std::ios::binary);
+    if (!blockFile.is_open()) {
+        block_format_logger.error("Error while opening " + path + " to migrate it");
+        return false;
+    }
+    int fd = ::open((path + MIGRATE_SUFFIX).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        block_format_logger.error("Error while creating the migrated copy of " + path);
+        return false;
+    }
+    std::vector<char> chunk(MIGRATE_CHUNK_BLOCKS * layout.blockSize);
+    unsigned long fileOffset = 0;
+    bool converted = true;
+    while (converted && (blockFile.read(chunk.data(), chunk.size()) || blockFile.gcount() > 0)) {
+        unsigned long length = blockFile.gcount();
+        for (unsigned long block = 0; converted && block < length / layout.blockSize; block++) {
+            if (layout.relations && RelationBlock::isFree(chunk.data() + block * layout.blockSize)) {
+                continue;
+            }
+            for (const auto &reference : layout.references) {
+                char *field = chunk.data() + block * layout.blockSize + reference.offset;
+                unsigned int record;
+                std::memcpy(&record, field, sizeof(record));
+                if (record % reference.blockSize != 0) {
+                    block_format_logger.error("Invalid block reference " + std::to_string(record) + " at offset " +
+                                              std::to_string(fileOffset + (field - chunk.data())) + " of " + path);
+                    converted = false;
+                    break;
+                }
+                record /= reference.blockSize;
+                std::memcpy(field, &record, sizeof(record));
+            }
+        }
+        converted = converted && write(fd, chunk.data(), length) == (ssize_t)length;
+        fileOffset += length;
+    }
+    converted = converted && fdatasync(fd) == 0;
+    ::close(fd);
+    return converted;
+}
+}  // namespace
+
+unsigned int BlockFormat::encode(unsigned long address, unsigned long blockSize) {
+    unsigned long record = BlockFormat::version == BlockFormat::BYTE_OFFSETS ? address : address / blockSize;
+    if (record > UINT_MAX) {
+        block_format_logger.error("Block address " + std::to_string(address) + " does not fit a format " +
+                                  std::to_string(BlockFormat::version) + " block reference" +
+                                  (BlockFormat::version == BlockFormat::BYTE_OFFSETS
+                                       ? ", migrate the partition with jasminegraph-migrate"
+                                       : ""));
+        return 0;
+    }
+    return record;
+}
+
+// Format recorded in the partition's _format file, 0 if there is none
+unsigned int BlockFormat::read(const std::string &dbPrefix) {
+    std::ifstream formatFile(dbPrefix + "_format");
+    unsigned int version = 0;
+    if (!formatFile.is_open() || !(formatFile >> version)) {
+        return 0;
+    }
+    return version;
+}
+
+bool BlockFormat::write(const std::string &dbPrefix, unsigned int version) {
+    // Renamed into place so that the file is either complete or missing
+    std::string path = dbPrefix + "_format";
+    std::string content = std::to_string(version) + "\n";
+    int fd = ::open((path + ".tmp").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool written = fd >= 0 && ::write(fd, content.data(), content.size()) == (ssize_t)content.size() &&
+                   fdatasync(fd) == 0;
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (!written || std::rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+        block_format_logger.error("Error while writing the block format of " + dbPrefix);
+        std::remove((path + ".tmp").c_str());
+        return false;
+    }
+    return true;
+}
+
+unsigned int BlockFormat::open(const std::string &dbPrefix, bool truncate) {
+    unsigned int recorded = BlockFormat::read(dbPrefix);
+    unsigned int version = truncate ? BlockFormat::LATEST : recorded;
+    // Migrated copies are renamed into place once the migration recorded the new format, otherwise they are dropped
+    for (const auto &layout : blockFileLayouts()) {
+        std::string path = dbPrefix + layout.suffix;
+        if (!fileExists(path + MIGRATE_SUFFIX)) {
+            continue;
+        }
+        if (version == BlockFormat::LATEST && !truncate) {
+            block_format_logger.info("Completing the migration of " + path);
+            if (std::rename((path + MIGRATE_SUFFIX).c_str(), path.c_str()) != 0) {
+                block_format_logger.error("Error while replacing " + path + " by its migrated copy");
+            }
+        } else {
+            std::remove((path + MIGRATE_SUFFIX).c_str());
+        }
+    }
+    if (version == 0) {
+        struct stat stat_buf;
+        bool hasNodes = stat((dbPrefix + "_nodes.db").c_str(), &stat_buf) == 0 && stat_buf.st_size > 0;
+        version = hasNodes ? BlockFormat::BYTE_OFFSETS : BlockFormat::LATEST;
+    }
+    if (version != recorded) {
+        BlockFormat::write(dbPrefix, version);
+    }
+    if (version == BlockFormat::BYTE_OFFSETS) {
+        block_format_logger.warn("Partition " + dbPrefix + " uses byte offset block references, its block files are " +
+                                 "limited to 4 GiB until it is migrated with jasminegraph-migrate");
+    }
+    return version;
+}
+
+/**
+ * Convert every block file of the partition into a copy with block index references, then record the new format and
+ * rename the copies over the originals. Writing the _format file is the commit point: a migration interrupted before
+ * it leaves the partition in format 1, one interrupted after it is completed when the partition is opened again.
+ * */
+bool BlockFormat::migrate(const std::string &dbPrefix) {
+    if (!fileExists(dbPrefix + "_nodes.db")) {
+        block_format_logger.error("No native store partition at " + dbPrefix);
+        return false;
+    }
+    if (fileExists(dbPrefix + "_compaction.log")) {
+        block_format_logger.error("Partition " + dbPrefix + " has a pending relation compaction, open it once " +
+                                  "before migrating it");
+        return false;
+    }
+    if (BlockFormat::open(dbPrefix, false) == BlockFormat::LATEST) {
+        block_format_logger.info("Partition " + dbPrefix + " already uses the latest block format");
+        return true;
+    }
+    std::vector<std::string> converted;
+    bool migrated = true;
+    for (const auto &layout : blockFileLayouts()) {
+        std::string path = dbPrefix + layout.suffix;
+        if (!fileExists(path)) {
+            continue;
+        }
+        converted.push_back(path);
+        if (!convertBlockFile(path, layout)) {
+            migrated = false;
+            break;
+        }
+    }
+    if (!migrated || !BlockFormat::write(dbPrefix, BlockFormat::LATEST)) {
+        block_format_logger.error("Error while migrating " + dbPrefix + ", the partition is left unchanged");
+        for (const auto &path : converted) {
+            std::remove((path + MIGRATE_SUFFIX).c_str());
+        }
+        return false;
+    }
+    for (const auto &path : converted) {
+        if (std::rename((path + MIGRATE_SUFFIX).c_str(), path.c_str()) != 0) {
+            block_format_logger.error("Error while replacing " + path + " by its migrated copy");
+        }
+    }
+    block_format_logger.info("Migrated " + dbPrefix + " to block format " + std::to_string(BlockFormat::LATEST));
+    return true;
+}
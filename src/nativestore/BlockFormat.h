@@ -0,0 +1,56 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_BLOCKFORMAT_H
+#define JASMINEGRAPH_BLOCKFORMAT_H
+
+#include <string>
+
+/**
+ * On-disk format of the block references of a native store partition, the 4 byte records of node, relation and
+ * property blocks that point to another block.
+ *
+ * Format 1 references hold the byte offset of the block, which limits every block file to 4 GiB. Format 2 references
+ * hold the index of the block in its file, so a file holds up to 2^32 blocks. Block addresses in memory are 64-bit
+ * byte offsets in both formats, records are translated with encode() / decode() when blocks are read and written.
+ *
+ * The format of a partition is kept in its _format file. Partitions without one were written before the file was
+ * introduced and use format 1 until they are converted with migrate(), see the jasminegraph-migrate tool.
+ * */
+class BlockFormat {
+ public:
+    static const unsigned int BYTE_OFFSETS = 1;
+    static const unsigned int BLOCK_INDICES = 2;
+    static const unsigned int LATEST = BLOCK_INDICES;
+
+    // Format of the partition the calling thread works on, set by the NodeManager
+    static thread_local unsigned int version;
+
+    // Record of a reference to the block at address in a file of blockSize blocks, 0 stays 0
+    static unsigned int encode(unsigned long address, unsigned long blockSize);
+    static unsigned long decode(unsigned int record, unsigned long blockSize) {
+        return BlockFormat::version == BlockFormat::BYTE_OFFSETS ? record : record * blockSize;
+    }
+
+    // Format of the partition at dbPrefix. Completes or rolls back an interrupted migration and records the format of
+    // partitions without a _format file, truncate is set when the partition's files are wiped
+    static unsigned int open(const std::string &dbPrefix, bool truncate);
+    // Convert the block files of a closed format 1 partition to the latest format
+    static bool migrate(const std::string &dbPrefix);
+
+ private:
+    static unsigned int read(const std::string &dbPrefix);
+    static bool write(const std::string &dbPrefix, unsigned int version);
+};
+
+#endif  // JASMINEGRAPH_BLOCKFORMAT_H
@@ -0,0 +1,967 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "BulkLoader.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <queue>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+
+#include "../util/logger/Logger.h"
+#include "BlockFormat.h"
+#include "MetaPropertyEdgeLink.h"
+#include "MetaPropertyLink.h"
+#include "PropertyEdgeLink.h"
+#include "PropertyLink.h"
+#include "RelationBlock.h"
+
+using json = nlohmann::json;
+
+Logger bulk_loader_logger;
+
+namespace {
+
+const unsigned long MIN_SORT_RECORDS = 1024;     // Smallest in memory sort buffer, also the smallest run read buffer
+const unsigned long WRITE_BLOCKS = 4096;         // Blocks built in memory before a write
+const unsigned long MAX_LOGGED_ERRORS = 10;      // Invalid input lines logged one by one, the rest are only counted
+const unsigned int TYPE_PATCH = UINT_MAX;        // Patch record of the type field, applied after the reference records
+
+struct CanonicalEdge {
+    unsigned int low;
+    unsigned int high;
+    unsigned long order;  // Position of the edge in the input << 1, the low bit is set for edges read as (high, low)
+
+    bool operator<(const CanonicalEdge &other) const {
+        return std::tie(low, high, order) < std::tie(other.low, other.high, other.order);
+    }
+};
+
+struct Edge {
+    unsigned int source;
+    unsigned int destination;
+
+    bool operator<(const Edge &other) const {
+        return std::tie(source, destination) < std::tie(other.source, other.destination);
+    }
+};
+
+// A relation in the destination part of a node's chain
+struct DestinationLink {
+    unsigned int destination;  // Node block index
+    unsigned int relation;     // Relation block index
+
+    bool operator<(const DestinationLink &other) const {
+        return std::tie(destination, relation) < std::tie(other.destination, other.relation);
+    }
+};
+
+// A record of a relation block that does not follow from the source order, set while the block is written
+struct RelationPatch {
+    unsigned int relation;
+    unsigned int record;  // RelationOffsets value, or TYPE_PATCH
+    unsigned long value;  // Block index for reference records, type ID for the type field
+
+    bool operator<(const RelationPatch &other) const {
+        return std::tie(relation, record) < std::tie(other.relation, other.record);
+    }
+};
+
+/**
+ * Sort of fixed size records that do not have to fit in memory. Records are buffered up to the memory budget, full
+ * buffers are sorted and written to run files, and next() merges the runs. Nothing is written to disk if the records
+ * fit in the buffer.
+ * */
+template <typename Record>
+class ExternalSorter {
+ public:
+    ExternalSorter(const std::string &path, unsigned long memoryBytes)
+        : path(path), capacity(std::max(memoryBytes / sizeof(Record), MIN_SORT_RECORDS)) {}
+
+    ~ExternalSorter() {
+        this->runs.clear();
+        for (unsigned long run = 0; run < this->runCount; run++) {
+            std::remove(this->runPath(run).c_str());
+        }
+    }
+
+    bool add(const Record &record) {
+        this->buffer.push_back(record);
+        return this->buffer.size() < this->capacity || this->spill();
+    }
+
+    // Sort the records added so far, next() returns them in ascending order afterwards
+    bool finish() {
+        if (this->runCount == 0) {
+            std::sort(this->buffer.begin(), this->buffer.end());
+            return true;
+        }
+        if (!this->buffer.empty() && !this->spill()) {
+            return false;
+        }
+        std::vector<Record>().swap(this->buffer);
+        unsigned long runBuffer = std::max(this->capacity / this->runCount, MIN_SORT_RECORDS);
+        this->runs.resize(this->runCount);
+        for (unsigned long run = 0; run < this->runCount; run++) {
+            this->runs[run].file.open(this->runPath(run), std::ios::binary);
+            if (!this->runs[run].file.is_open()) {
+                bulk_loader_logger.error("Error while opening sort run " + this->runPath(run));
+                return false;
+            }
+            this->runs[run].records.resize(runBuffer);
+            Record record;
+            if (this->runs[run].next(record)) {
+                this->heads.push(Head{record, run});
+            }
+        }
+        return true;
+    }
+
+    bool next(Record &record) {
+        if (this->runs.empty()) {
+            if (this->position == this->buffer.size()) {
+                return false;
+            }
+            record = this->buffer[this->position++];
+            return true;
+        }
+        if (this->heads.empty()) {
+            return false;
+        }
+        Head head = this->heads.top();
+        this->heads.pop();
+        record = head.record;
+        Record following;
+        if (this->runs[head.run].next(following)) {
+            this->heads.push(Head{following, head.run});
+        }
+        return true;
+    }
+
+ private:
+    struct Run {
+        std::ifstream file;
+        std::vector<Record> records;
+        unsigned long position = 0;
+        unsigned long count = 0;
+
+        bool next(Record &record) {
+            if (this->position == this->count) {
+                this->file.read(reinterpret_cast<char *>(this->records.data()), this->records.size() * sizeof(Record));
+                this->count = this->file.gcount() / sizeof(Record);
+                this->position = 0;
+                if (this->count == 0) {
+                    return false;
+                }
+            }
+            record = this->records[this->position++];
+            return true;
+        }
+    };
+
+    struct Head {
+        Record record;
+        unsigned long run;
+
+        // std::priority_queue keeps the largest element on top
+        bool operator<(const Head &other) const { return other.record < this->record; }
+    };
+
+    bool spill() {
+        std::sort(this->buffer.begin(), this->buffer.end());
+        std::ofstream run(this->runPath(this->runCount), std::ios::binary | std::ios::trunc);
+        run.write(reinterpret_cast<const char *>(this->buffer.data()), this->buffer.size() * sizeof(Record));
+        if (!run.good()) {
+            bulk_loader_logger.error("Error while writing sort run " + this->runPath(this->runCount));
+            return false;
+        }
+        this->runCount++;
+        this->buffer.clear();
+        return true;
+    }
+
+    std::string runPath(unsigned long run) const { return this->path + "." + std::to_string(run); }
+
+    std::string path;
+    unsigned long capacity;
+    std::vector<Record> buffer;
+    unsigned long position = 0;
+    unsigned long runCount = 0;
+    std::vector<Run> runs;
+    std::priority_queue<Head> heads;
+};
+
+/**
+ * Parse up to maxFields unsigned numbers separated by spaces, tabs or commas. Returns the number of fields, -1 if a
+ * field is not a number
+ * */
+int parseFields(const char *line, unsigned long fields[], int maxFields) {
+    int count = 0;
+    const char *position = line;
+    while (count < maxFields) {
+        while (*position == ' ' || *position == '\t' || *position == ',' || *position == '\r') {
+            position++;
+        }
+        if (*position == '\0') {
+            break;
+        }
+        if (*position < '0' || *position > '9') {
+            return -1;
+        }
+        char *end;
+        fields[count++] = std::strtoul(position, &end, 10);
+        position = end;
+    }
+    return count;
+}
+
+std::vector<std::string> splitCsvLine(const std::string &line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else if (c != '\r') {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+bool parseNodeId(const std::string &text, unsigned int &nodeId) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    unsigned long value = std::strtoul(text.c_str(), nullptr, 10);
+    if (value > UINT_MAX) {
+        return false;
+    }
+    nodeId = value;
+    return true;
+}
+
+bool parseNodeId(const json &value, unsigned int &nodeId) {
+    if (value.is_object() && value.contains("id")) {
+        return parseNodeId(value["id"], nodeId);
+    }
+    if (value.is_number_unsigned() && value.get<unsigned long>() <= UINT_MAX) {
+        nodeId = value.get<unsigned long>();
+        return true;
+    }
+    return value.is_string() && parseNodeId(value.get<std::string>(), nodeId);
+}
+
+// Typed value of a JSON property, the same mapping the streaming ingest uses
+PropertyValue toPropertyValue(const json &value) {
+    if (value.is_number_integer()) {
+        return PropertyValue::ofInt(value.get<long long>());
+    }
+    if (value.is_number_float()) {
+        return PropertyValue::ofDouble(value.get<double>());
+    }
+    if (value.is_boolean()) {
+        return PropertyValue::ofBool(value.get<bool>());
+    }
+    if (value.is_string()) {
+        return PropertyValue::ofString(value.get<std::string>());
+    }
+    return PropertyValue::ofString(value.dump());
+}
+
+typedef std::vector<std::pair<std::string, PropertyValue>> PropertyRow;
+
+/**
+ * Call row with the node IDs of the key columns and the other properties of every row of a CSV or JSON lines
+ * property file. CSV files have a header, the key columns are found by name or are the first columns. JSON lines
+ * have the keys as members (a node ID or an object with an id like streamed edges) and the properties in a
+ * properties object, or as the other members
+ * */
+bool readPropertyRows(const std::string &path, const std::vector<std::string> &keys,
+                      const std::function<void(const std::vector<unsigned int> &, const PropertyRow &)> &row) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        bulk_loader_logger.error("Error while opening property file " + path);
+        return false;
+    }
+    std::string line;
+    std::vector<std::string> columns;
+    std::vector<size_t> keyColumns;
+    std::vector<unsigned int> ids(keys.size());
+    unsigned long lineNumber = 0;
+    unsigned long invalid = 0;
+    bool jsonLines = false;
+    bool detected = false;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos) {
+            continue;
+        }
+        if (!detected) {
+            jsonLines = line[start] == '{';
+            detected = true;
+        }
+        bool valid = true;
+        PropertyRow properties;
+        if (jsonLines) {
+            json object = json::parse(line, nullptr, false);
+            valid = object.is_object();
+            for (size_t k = 0; valid && k < keys.size(); k++) {
+                valid = object.contains(keys[k]) && parseNodeId(object[keys[k]], ids[k]);
+            }
+            if (valid) {
+                const json &members = object.contains("properties") ? object["properties"] : object;
+                for (auto it = members.begin(); it != members.end(); it++) {
+                    if (&members == &object && (it.key() == "pid" ||
+                                                std::find(keys.begin(), keys.end(), it.key()) != keys.end())) {
+                        continue;
+                    }
+                    properties.emplace_back(it.key(), toPropertyValue(it.value()));
+                }
+            }
+        } else if (columns.empty()) {
+            columns = splitCsvLine(line);
+            for (size_t k = 0; k < keys.size(); k++) {
+                auto column = std::find(columns.begin(), columns.end(), keys[k]);
+                keyColumns.push_back(column != columns.end() ? column - columns.begin() : k);
+            }
+            continue;
+        } else {
+            std::vector<std::string> fields = splitCsvLine(line);
+            for (size_t k = 0; valid && k < keys.size(); k++) {
+                valid = keyColumns[k] < fields.size() && parseNodeId(fields[keyColumns[k]], ids[k]);
+            }
+            for (size_t c = 0; valid && c < fields.size() && c < columns.size(); c++) {
+                if (!fields[c].empty() && std::find(keyColumns.begin(), keyColumns.end(), c) == keyColumns.end()) {
+                    properties.emplace_back(columns[c], PropertyValue::ofString(fields[c]));
+                }
+            }
+        }
+        if (!valid) {
+            if (++invalid <= MAX_LOGGED_ERRORS) {
+                bulk_loader_logger.warn("Skipping invalid line " + std::to_string(lineNumber) + " of " + path);
+            }
+            continue;
+        }
+        row(ids, properties);
+    }
+    if (invalid > 0) {
+        bulk_loader_logger.warn("Skipped " + std::to_string(invalid) + " invalid lines of " + path);
+    }
+    return true;
+}
+
+bool syncFile(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = fdatasync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+}  // namespace
+
+struct BulkLoader::RelationFile {
+    bool central;
+    unsigned long blockSize;
+    std::string path;       // Relation block file
+    std::string orderPath;  // (source, destination) node block indexes of the relations in block order
+    std::unique_ptr<ExternalSorter<CanonicalEdge>> edges;
+    std::unique_ptr<ExternalSorter<DestinationLink>> destinationLinks;
+    std::unique_ptr<ExternalSorter<RelationPatch>> patches;
+    // starts[n] is the first relation block of the relations with source node n, starts[n + 1] ends them
+    std::vector<unsigned int> starts;
+    EdgeIndex *edgeIndex = nullptr;
+    std::unordered_map<unsigned int, unsigned int> propertyHeads;  // Relation -> first property block
+    std::unordered_set<unsigned int> typedRelations;
+    unsigned long count = 0;
+
+    void patch(unsigned int relation, unsigned int record, unsigned long value) {
+        this->patches->add(RelationPatch{relation, record, value});
+    }
+};
+
+BulkLoader::BulkLoader(const GraphConfig &gConfig, unsigned long memoryBytes)
+    : gConfig(gConfig), memoryBytes(memoryBytes) {}
+
+bool BulkLoader::load(const BulkLoader::Input &input) {
+    auto begin = std::chrono::steady_clock::now();
+    {
+        // A NodeManager in trunc mode resets the block files, the indexes and the block format of the partition
+        GraphConfig truncConfig = this->gConfig;
+        truncConfig.openMode = "trunc";
+        NodeManager nodeManager(truncConfig);
+        this->dbPrefix = nodeManager.getDbPrefix();
+        this->columnarProperties = PropertyStore::exists(this->dbPrefix);
+        nodeManager.close();
+    }
+    this->tempPrefix = this->dbPrefix + "_bulkload/";
+    if (mkdir(this->tempPrefix.c_str(), 0755) != 0 && errno != EEXIST) {
+        bulk_loader_logger.error("Error while creating the temporary directory " + this->tempPrefix);
+        return false;
+    }
+
+    unsigned long sortMemory = this->memoryBytes / 4;
+    RelationFile local;
+    RelationFile central;
+    for (RelationFile *relations : {&local, &central}) {
+        relations->central = relations == &central;
+        std::string name = relations->central ? "central_relations" : "relations";
+        relations->blockSize = relations->central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+        relations->path = this->dbPrefix + "_" + name + ".db";
+        relations->orderPath = this->tempPrefix + name + ".order";
+        relations->edges.reset(new ExternalSorter<CanonicalEdge>(this->tempPrefix + name + ".edges", sortMemory));
+        relations->edgeIndex = EdgeIndex::acquire(this->dbPrefix + "_" + name + ".hindex.db");
+    }
+    this->collectLimit = std::max(sortMemory / sizeof(unsigned int), MIN_SORT_RECORDS);
+
+    LabelIndex *labelIndex = LabelIndex::acquire(this->dbPrefix);
+    RelationTypeIndex *typeIndex = RelationTypeIndex::acquire(this->dbPrefix);
+    PropertyStore *store = this->columnarProperties ? PropertyStore::acquire(this->dbPrefix) : nullptr;
+    PropertyStore::current = store;
+    RelationTypeIndex::current = typeIndex;
+
+    bool loaded = this->readEdges(input.localEdges, false, local) &&
+                  this->readEdges(input.centralEdges, true, central);
+    if (loaded) {
+        this->collectNodeIds(true);
+        bulk_loader_logger.info("Read the edges of " + std::to_string(this->nodeIds.size()) + " nodes");
+        this->localHeads.assign(this->nodeIds.size(), 0);
+        this->centralHeads.assign(this->nodeIds.size(), 0);
+        this->propertyHeads.assign(this->nodeIds.size(), 0);
+        loaded = this->orderRelations(local) && this->orderRelations(central);
+    }
+    if (loaded && !this->columnarProperties) {
+        this->properties.open(this->dbPrefix + "_properties.db", std::ios::binary | std::ios::trunc);
+        this->edgeProperties.open(this->dbPrefix + "_edge_properties.db", std::ios::binary | std::ios::trunc);
+        // Block 0 of the property files is not used
+        std::vector<char> unused(PropertyLink::PROPERTY_BLOCK_SIZE, 0);
+        this->properties.write(unused.data(), unused.size());
+        this->edgeProperties.write(unused.data(), unused.size());
+    }
+    if (loaded && !input.nodeProperties.empty()) {
+        loaded = this->loadNodeProperties(input.nodeProperties);
+    }
+    if (loaded && !input.edgeProperties.empty()) {
+        loaded = this->loadEdgeProperties(input.edgeProperties, local, central);
+    }
+    if (this->properties.is_open()) {
+        this->properties.close();
+        this->edgeProperties.close();
+        loaded = loaded && !this->properties.fail() && !this->edgeProperties.fail();
+    }
+    loaded = loaded && this->writeRelations(local) && this->writeRelations(central) && this->writeNodes();
+    if (loaded) {
+        for (const auto &label : this->labels) {
+            labelIndex->add(label.second, label.first);
+        }
+        NodeDegrees *degrees = NodeDegrees::acquire(this->dbPrefix);
+        loaded = degrees->rebuild(local.path, central.path);
+        NodeDegrees::release(degrees);
+    }
+
+    for (RelationFile *relations : {&local, &central}) {
+        EdgeIndex::release(relations->edgeIndex);
+        std::remove(relations->orderPath.c_str());
+        relations->edges.reset();
+        relations->destinationLinks.reset();
+        relations->patches.reset();
+    }
+    PropertyStore::current = nullptr;
+    RelationTypeIndex::current = nullptr;
+    PropertyStore::release(store);
+    RelationTypeIndex::release(typeIndex);
+    LabelIndex::release(labelIndex);
+    rmdir(this->tempPrefix.c_str());
+    if (!loaded) {
+        bulk_loader_logger.error("Bulk load of " + this->dbPrefix + " failed");
+        return false;
+    }
+
+    for (const char *suffix : {"_nodes.db", "_properties.db", "_meta_properties.db", "_edge_properties.db",
+                               "_meta_edge_properties.db", "_relations.db", "_central_relations.db"}) {
+        syncFile(this->dbPrefix + suffix);
+    }
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - begin);
+    bulk_loader_logger.info("Loaded " + std::to_string(this->nodeIds.size()) + " nodes, " +
+                            std::to_string(this->relationCounts[0]) + " local and " +
+                            std::to_string(this->relationCounts[1]) + " central relations into " + this->dbPrefix +
+                            " in " + std::to_string(seconds.count()) + " s");
+    return true;
+}
+
+bool BulkLoader::readEdges(const std::vector<std::string> &paths, bool central, BulkLoader::RelationFile &relations) {
+    unsigned long sequence = 0;
+    for (const std::string &path : paths) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            bulk_loader_logger.error("Error while opening edge list " + path);
+            return false;
+        }
+        bulk_loader_logger.info("Reading " + std::string(central ? "central" : "local") + " edges of " + path);
+        std::string line;
+        unsigned long lineNumber = 0;
+        unsigned long invalid = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string::npos || line[start] == '#' || line[start] == '%') {
+                continue;
+            }
+            // Central edges may carry the partitions of their nodes
+            unsigned long fields[4];
+            int count = parseFields(line.c_str() + start, fields, central ? 4 : 2);
+            if (count < 2 || fields[0] > UINT_MAX || fields[1] > UINT_MAX) {
+                if (++invalid <= MAX_LOGGED_ERRORS) {
+                    bulk_loader_logger.warn("Skipping invalid line " + std::to_string(lineNumber) + " of " + path);
+                }
+                continue;
+            }
+            unsigned int source = fields[0];
+            unsigned int destination = fields[1];
+            for (int node = 0; node + 2 < count; node++) {
+                if (fields[node + 2] != this->gConfig.partitionID) {
+                    this->remotePartitions[static_cast<unsigned int>(fields[node])] = fields[node + 2];
+                }
+            }
+            CanonicalEdge edge = source <= destination ? CanonicalEdge{source, destination, sequence << 1}
+                                                       : CanonicalEdge{destination, source, (sequence << 1) | 1};
+            sequence++;
+            if (!relations.edges->add(edge)) {
+                return false;
+            }
+            this->collectedIds.push_back(source);
+            this->collectedIds.push_back(destination);
+            if (this->collectedIds.size() >= this->collectLimit) {
+                this->collectNodeIds(false);
+            }
+        }
+        if (invalid > 0) {
+            bulk_loader_logger.warn("Skipped " + std::to_string(invalid) + " invalid lines of " + path);
+        }
+    }
+    return true;
+}
+
+void BulkLoader::collectNodeIds(bool final) {
+    std::sort(this->collectedIds.begin(), this->collectedIds.end());
+    this->collectedIds.erase(std::unique(this->collectedIds.begin(), this->collectedIds.end()),
+                             this->collectedIds.end());
+    if (final) {
+        this->nodeIds.swap(this->collectedIds);
+        std::vector<unsigned int>().swap(this->collectedIds);
+        return;
+    }
+    // Keep the deduplications amortized once most of the collected IDs are distinct nodes
+    this->collectLimit = std::max(this->collectLimit, this->collectedIds.size() * 2);
+}
+
+long BulkLoader::nodeIndex(unsigned int nodeId) const {
+    auto it = std::lower_bound(this->nodeIds.begin(), this->nodeIds.end(), nodeId);
+    if (it == this->nodeIds.end() || *it != nodeId) {
+        return -1;
+    }
+    return it - this->nodeIds.begin();
+}
+
+/**
+ * Drop the duplicate edges and give the relations their blocks in source node order. Fills the edge index, the
+ * source ranges and the destination links of the relations
+ * */
+bool BulkLoader::orderRelations(BulkLoader::RelationFile &relations) {
+    std::string name = relations.central ? "central_relations" : "relations";
+    unsigned long sortMemory = this->memoryBytes / 4;
+    if (!relations.edges->finish()) {
+        return false;
+    }
+    ExternalSorter<Edge> ordered(this->tempPrefix + name + ".ordered", sortMemory);
+    CanonicalEdge edge;
+    CanonicalEdge previous;
+    bool first = true;
+    unsigned long duplicates = 0;
+    while (relations.edges->next(edge)) {
+        // The first edge of the (low, high) group is the one added first, later ones in either direction are dropped
+        if (!first && edge.low == previous.low && edge.high == previous.high) {
+            duplicates++;
+            continue;
+        }
+        first = false;
+        previous = edge;
+        unsigned int source = nodeIndex((edge.order & 1) ? edge.high : edge.low);
+        unsigned int destination = nodeIndex((edge.order & 1) ? edge.low : edge.high);
+        if (!ordered.add(Edge{source, destination})) {
+            return false;
+        }
+    }
+    relations.edges.reset();
+    if (!ordered.finish()) {
+        return false;
+    }
+
+    std::ofstream order(relations.orderPath, std::ios::binary | std::ios::trunc);
+    relations.destinationLinks.reset(
+        new ExternalSorter<DestinationLink>(this->tempPrefix + name + ".destinations", sortMemory));
+    relations.patches.reset(new ExternalSorter<RelationPatch>(this->tempPrefix + name + ".patches", sortMemory));
+    relations.starts.assign(this->nodeIds.size() + 1, 0);
+    Edge relation;
+    unsigned long count = 0;
+    while (ordered.next(relation)) {
+        if (++count >= UINT_MAX) {
+            bulk_loader_logger.error("Too many relations for the relation block file " + relations.path);
+            return false;
+        }
+        relations.starts[relation.source + 1]++;
+        order.write(reinterpret_cast<const char *>(&relation), sizeof(relation));
+        relations.edgeIndex->insert(relation.source * NodeBlock::BLOCK_SIZE,
+                                    relation.destination * NodeBlock::BLOCK_SIZE, count * relations.blockSize);
+        if (!relations.destinationLinks->add(DestinationLink{relation.destination, (unsigned int)count})) {
+            return false;
+        }
+    }
+    order.close();
+    if (order.fail()) {
+        bulk_loader_logger.error("Error while writing " + relations.orderPath);
+        return false;
+    }
+    relations.starts[0] = 1;  // Block 0 is not used
+    for (size_t node = 0; node < this->nodeIds.size(); node++) {
+        relations.starts[node + 1] += relations.starts[node];
+    }
+    relations.count = count;
+    this->relationCounts[relations.central ? 1 : 0] = count;
+    bulk_loader_logger.info("Ordered " + std::to_string(count) + " relations of " + relations.path + ", dropped " +
+                            std::to_string(duplicates) + " duplicate edges");
+    return true;
+}
+
+/**
+ * Append a linked property block, returns its block index
+ * */
+unsigned int BulkLoader::appendProperty(const std::string &name, const std::string &value, unsigned int next,
+                                        bool edge) {
+    char block[PropertyLink::PROPERTY_BLOCK_SIZE] = {0};
+    std::strncpy(block, name.c_str(), PropertyLink::MAX_NAME_SIZE - 1);
+    std::strncpy(block + PropertyLink::MAX_NAME_SIZE, value.c_str(), PropertyLink::MAX_VALUE_SIZE - 1);
+    unsigned int nextRecord = BlockFormat::encode(next * PropertyLink::PROPERTY_BLOCK_SIZE,
+                                                  PropertyLink::PROPERTY_BLOCK_SIZE);
+    std::memcpy(block + PropertyLink::MAX_NAME_SIZE + PropertyLink::MAX_VALUE_SIZE, &nextRecord, sizeof(nextRecord));
+    (edge ? this->edgeProperties : this->properties).write(block, sizeof(block));
+    return edge ? this->edgePropertyBlocks++ : this->propertyBlocks++;
+}
+
+bool BulkLoader::loadNodeProperties(const std::string &path) {
+    unsigned long missing = 0;
+    bool loaded = readPropertyRows(path, {"id"}, [&](const std::vector<unsigned int> &ids, const PropertyRow &row) {
+        long node = this->nodeIndex(ids[0]);
+        if (node < 0) {
+            missing++;
+            return;
+        }
+        // Blocks are written last property first so that the chain keeps the order of the row
+        for (auto it = row.rbegin(); it != row.rend(); it++) {
+            if (it->first == "label" && this->labels.find(node) == this->labels.end()) {
+                this->labels[node] = it->second.toString();
+            }
+            if (this->columnarProperties) {
+                PropertyStore::current->set(PropertyOwner::NODE, node, it->first, it->second);
+            } else {
+                this->propertyHeads[node] = this->appendProperty(it->first, it->second.toString(),
+                                                                 this->propertyHeads[node], false);
+            }
+        }
+    });
+    if (missing > 0) {
+        bulk_loader_logger.warn("Skipped the properties of " + std::to_string(missing) +
+                                " nodes that are not in the edge lists");
+    }
+    return loaded && (this->columnarProperties || this->properties.good());
+}
+
+bool BulkLoader::loadEdgeProperties(const std::string &path, BulkLoader::RelationFile &local,
+                                    BulkLoader::RelationFile &central) {
+    unsigned long missing = 0;
+    auto addRow = [&](const std::vector<unsigned int> &ids, const PropertyRow &row) {
+        long source = this->nodeIndex(ids[0]);
+        long destination = this->nodeIndex(ids[1]);
+        RelationFile *relations = &local;
+        unsigned long address = 0;
+        if (source >= 0 && destination >= 0) {
+            address = local.edgeIndex->find(source * NodeBlock::BLOCK_SIZE, destination * NodeBlock::BLOCK_SIZE);
+            if (address == 0) {
+                relations = &central;
+                address = central.edgeIndex->find(source * NodeBlock::BLOCK_SIZE,
+                                                  destination * NodeBlock::BLOCK_SIZE);
+            }
+        }
+        if (address == 0) {
+            missing++;
+            return;
+        }
+        unsigned int relation = address / relations->blockSize;
+        for (auto it = row.rbegin(); it != row.rend(); it++) {
+            if (it->first == "type" && relations->typedRelations.insert(relation).second) {
+                int typeId = RelationTypeIndex::current->typeId(it->second.toString(), true);
+                if (typeId > 0) {
+                    RelationTypeIndex::current->add(typeId, relations->central, relation);
+                    relations->patch(relation, TYPE_PATCH, typeId);
+                }
+            }
+            if (this->columnarProperties) {
+                PropertyStore::current->set(
+                    relations->central ? PropertyOwner::CENTRAL_RELATION : PropertyOwner::LOCAL_RELATION, relation,
+                    it->first, it->second);
+            } else {
+                unsigned int &head = relations->propertyHeads[relation];
+                head = this->appendProperty(it->first, it->second.toString(), head, true);
+            }
+        }
+    };
+    bool loaded = readPropertyRows(path, {"source", "destination"}, addRow);
+    if (missing > 0) {
+        bulk_loader_logger.warn("Skipped the properties of " + std::to_string(missing) +
+                                " edges that are not in the edge lists");
+    }
+    return loaded && (this->columnarProperties || this->edgeProperties.good());
+}
+
+/**
+ * Link the incoming relation chains, then write the relation blocks in one sequential pass. Central relations also
+ * get their partition ID meta property block, which has the index of the relation block
+ * */
+bool BulkLoader::writeRelations(BulkLoader::RelationFile &relations) {
+    std::vector<unsigned int> &heads = relations.central ? this->centralHeads : this->localHeads;
+    std::vector<unsigned int> incomingHeads(this->nodeIds.size(), 0);
+    const std::vector<unsigned int> &starts = relations.starts;
+    if (!relations.destinationLinks->finish()) {
+        return false;
+    }
+    DestinationLink link;
+    bool hasLink = relations.destinationLinks->next(link);
+    for (unsigned int node = 0; node < this->nodeIds.size(); node++) {
+        // The outgoing chain is the node's source range, linked when the blocks are written
+        if (starts[node] < starts[node + 1]) {
+            heads[node] = starts[node];
+        }
+        unsigned int previous = 0;
+        for (; hasLink && link.destination == node; hasLink = relations.destinationLinks->next(link)) {
+            if (previous == 0) {
+                incomingHeads[node] = link.relation;
+            } else {
+                relations.patch(previous, static_cast<unsigned int>(RelationOffsets::DESTINATION_NEXT),
+                                link.relation);
+                relations.patch(link.relation, static_cast<unsigned int>(RelationOffsets::DESTINATION_PREVIOUS),
+                                previous);
+            }
+            previous = link.relation;
+        }
+    }
+    relations.destinationLinks.reset();
+    IncomingRelationHeads *incoming = IncomingRelationHeads::acquire(this->dbPrefix);
+    bool assigned = incoming->assign(incomingHeads, relations.central);
+    IncomingRelationHeads::release(incoming);
+    if (!assigned) {
+        return false;
+    }
+    for (const auto &propertyHead : relations.propertyHeads) {
+        relations.patch(propertyHead.first, static_cast<unsigned int>(RelationOffsets::RELATION_PROPS),
+                        propertyHead.second);
+    }
+    std::unordered_map<unsigned int, unsigned int>().swap(relations.propertyHeads);
+    std::unordered_set<unsigned int>().swap(relations.typedRelations);
+    if (!relations.patches->finish()) {
+        return false;
+    }
+
+    const bool central = relations.central;
+    const unsigned long blockSize = relations.blockSize;
+    const unsigned long metaBlockSize = MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE;
+    const int typeOffset = central ? RelationBlock::CENTRAL_RELATIONSHIP_TYPE_OFFSET
+                                   : RelationBlock::LOCAL_RELATIONSHIP_TYPE_OFFSET;
+    std::ofstream out(relations.path, std::ios::binary | std::ios::trunc);
+    std::ofstream meta;
+    if (central) {
+        meta.open(this->dbPrefix + "_meta_edge_properties.db", std::ios::binary | std::ios::trunc);
+    }
+    std::ifstream order(relations.orderPath, std::ios::binary);
+    std::vector<Edge> edges(WRITE_BLOCKS);
+    std::vector<char> blocks(WRITE_BLOCKS * blockSize);
+    std::vector<char> metaBlocks(central ? WRITE_BLOCKS * metaBlockSize : 0);
+    if (relations.count > 0) {
+        // Block 0 is not used
+        std::fill(blocks.begin(), blocks.end(), 0);
+        out.write(blocks.data(), blockSize);
+        if (central) {
+            meta.write(blocks.data(), metaBlockSize);
+        }
+    }
+    RelationPatch patch;
+    bool hasPatch = relations.patches->next(patch);
+    for (unsigned long first = 1; first <= relations.count; first += WRITE_BLOCKS) {
+        unsigned long count = std::min(WRITE_BLOCKS, relations.count - first + 1);
+        if (!order.read(reinterpret_cast<char *>(edges.data()), count * sizeof(Edge))) {
+            bulk_loader_logger.error("Error while reading " + relations.orderPath);
+            return false;
+        }
+        std::fill(blocks.begin(), blocks.end(), 0);
+        std::fill(metaBlocks.begin(), metaBlocks.end(), 0);
+        for (unsigned long i = 0; i < count; i++) {
+            unsigned long relation = first + i;
+            const Edge &edge = edges[i];
+            char *block = blocks.data() + i * blockSize;
+            RelationBlock::writeRecord(block, RelationOffsets::SOURCE_ID, central, this->nodeIds[edge.source]);
+            RelationBlock::writeRecord(block, RelationOffsets::DESTINATION_ID, central,
+                                       this->nodeIds[edge.destination]);
+            RelationBlock::writeRecord(block, RelationOffsets::SOURCE, central, edge.source * NodeBlock::BLOCK_SIZE);
+            RelationBlock::writeRecord(block, RelationOffsets::DESTINATION, central,
+                                       edge.destination * NodeBlock::BLOCK_SIZE);
+            if (relation > starts[edge.source]) {
+                RelationBlock::writeRecord(block, RelationOffsets::SOURCE_PREVIOUS, central,
+                                           (relation - 1) * blockSize);
+            }
+            if (relation + 1 < starts[edge.source + 1]) {
+                RelationBlock::writeRecord(block, RelationOffsets::SOURCE_NEXT, central, (relation + 1) * blockSize);
+            }
+            if (central) {
+                // Central relations carry the partition of their source node, like streamed central edges
+                RelationBlock::writeRecord(block, RelationOffsets::RELATION_PROPS_META, central,
+                                           relation * metaBlockSize);
+                char *metaBlock = metaBlocks.data() + i * metaBlockSize;
+                auto remote = this->remotePartitions.find(this->nodeIds[edge.source]);
+                std::string pid = std::to_string(remote != this->remotePartitions.end() ? remote->second
+                                                                                        : this->gConfig.partitionID);
+                std::strncpy(metaBlock, MetaPropertyEdgeLink::PARTITION_ID.c_str(),
+                             MetaPropertyEdgeLink::MAX_NAME_SIZE - 1);
+                std::strncpy(metaBlock + MetaPropertyEdgeLink::MAX_NAME_SIZE, pid.c_str(),
+                             MetaPropertyEdgeLink::MAX_VALUE_SIZE - 1);
+            }
+            for (; hasPatch && patch.relation == relation; hasPatch = relations.patches->next(patch)) {
+                if (patch.record == TYPE_PATCH) {
+                    unsigned int typeId = patch.value;
+                    std::memcpy(block + RelationBlock::RECORD_SIZE * typeOffset, &typeId, RelationBlock::RECORD_SIZE);
+                    continue;
+                }
+                RelationOffsets offset = static_cast<RelationOffsets>(patch.record);
+                RelationBlock::writeRecord(block, offset, central,
+                                           patch.value * RelationBlock::referenceBlockSize(offset, central));
+            }
+        }
+        out.write(blocks.data(), count * blockSize);
+        if (central) {
+            meta.write(metaBlocks.data(), count * metaBlockSize);
+        }
+    }
+    relations.patches.reset();
+    std::vector<unsigned int>().swap(relations.starts);
+    out.close();
+    if (central) {
+        meta.close();
+    }
+    if (out.fail() || meta.fail()) {
+        bulk_loader_logger.error("Error while writing the relation blocks of " + relations.path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Write the node blocks and their partition ID meta property blocks, node n has meta property block n + 1, and fill
+ * the node index
+ * */
+bool BulkLoader::writeNodes() {
+    std::ofstream nodes(this->dbPrefix + "_nodes.db", std::ios::binary | std::ios::trunc);
+    std::ofstream meta(this->dbPrefix + "_meta_properties.db", std::ios::binary | std::ios::trunc);
+    const unsigned long metaBlockSize = MetaPropertyLink::META_PROPERTY_BLOCK_SIZE;
+    std::vector<char> blocks(WRITE_BLOCKS * NodeBlock::BLOCK_SIZE);
+    std::vector<char> metaBlocks(WRITE_BLOCKS * metaBlockSize, 0);
+    if (!this->nodeIds.empty()) {
+        meta.write(metaBlocks.data(), metaBlockSize);  // Block 0 is not used
+    }
+    NodeIndex *index = NodeIndex::acquire(this->dbPrefix);
+    auto writeReference = [](char *block, unsigned long offset, unsigned long address, unsigned long blockSize) {
+        unsigned int record = BlockFormat::encode(address, blockSize);
+        std::memcpy(block + offset, &record, sizeof(record));
+    };
+    for (unsigned long first = 0; first < this->nodeIds.size(); first += WRITE_BLOCKS) {
+        unsigned long count = std::min(WRITE_BLOCKS, this->nodeIds.size() - first);
+        std::fill(blocks.begin(), blocks.end(), 0);
+        std::fill(metaBlocks.begin(), metaBlocks.end(), 0);
+        for (unsigned long i = 0; i < count; i++) {
+            unsigned long node = first + i;
+            unsigned int nodeId = this->nodeIds[node];
+            std::string id = std::to_string(nodeId);
+            char *block = blocks.data() + i * NodeBlock::BLOCK_SIZE;
+            block[0] = 1;  // In use
+            std::memcpy(block + 1, &nodeId, sizeof(nodeId));
+            writeReference(block, NodeBlock::EDGE_REF_OFFSET, this->localHeads[node] * RelationBlock::BLOCK_SIZE,
+                           RelationBlock::BLOCK_SIZE);
+            writeReference(block, NodeBlock::CENTRAL_EDGE_REF_OFFSET,
+                           this->centralHeads[node] * RelationBlock::CENTRAL_BLOCK_SIZE,
+                           RelationBlock::CENTRAL_BLOCK_SIZE);
+            writeReference(block, NodeBlock::PROP_REF_OFFSET,
+                           this->propertyHeads[node] * PropertyLink::PROPERTY_BLOCK_SIZE,
+                           PropertyLink::PROPERTY_BLOCK_SIZE);
+            writeReference(block, NodeBlock::META_PROP_REF_OFFSET, (node + 1) * metaBlockSize, metaBlockSize);
+            auto label = this->labels.find(node);
+            std::strncpy(block + NodeBlock::LABEL_OFFSET, label != this->labels.end() ? label->second.c_str()
+                                                                                       : id.c_str(),
+                         NodeBlock::LABEL_SIZE - 1);
+
+            char *metaBlock = metaBlocks.data() + i * metaBlockSize;
+            auto remote = this->remotePartitions.find(nodeId);
+            std::string pid = std::to_string(remote != this->remotePartitions.end() ? remote->second
+                                                                                    : this->gConfig.partitionID);
+            std::strncpy(metaBlock, MetaPropertyLink::PARTITION_ID.c_str(), MetaPropertyLink::MAX_NAME_SIZE - 1);
+            std::strncpy(metaBlock + MetaPropertyLink::MAX_NAME_SIZE, pid.c_str(),
+                         MetaPropertyLink::MAX_VALUE_SIZE - 1);
+            index->insert(id, node);
+        }
+        nodes.write(blocks.data(), count * NodeBlock::BLOCK_SIZE);
+        meta.write(metaBlocks.data(), count * metaBlockSize);
+    }
+    index->flush();
+    NodeIndex::release(index);
+    nodes.close();
+    meta.close();
+    if (nodes.fail() || meta.fail()) {
+        bulk_loader_logger.error("Error while writing the node blocks of " + this->dbPrefix);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_BULKLOADER_H
+#define JASMINEGRAPH_BULKLOADER_H
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "NodeManager.h"
+
+/**
+ * Offline loader that writes the block files and indexes of a native store partition directly from its edge lists,
+ * instead of adding the edges one by one through a NodeManager.
+ *
+ * Edges are grouped with external sorts whose runs are kept in a temporary directory next to the partition: one to
+ * drop duplicate edges, keeping the first of (a, b) and (b, a) like the edge index does, and one to order the
+ * relations by source node. Relation blocks, node blocks and meta property blocks are then written with sequential
+ * writes, the incoming relation chain pointers, which do not follow from the source order, come from a third sort.
+ * Nodes get their block in node ID order, the outgoing and incoming relation chains of a node are in relation order.
+ *
+ * Node IDs must be numeric like for streamed edges. Nodes and relations get the partition ID meta property the
+ * streaming ingest gives them. The loader keeps about 24 bytes per node in memory, the sorts use the memory budget.
+ * The partition is reset first and must not be open anywhere else, it is ready to be opened in FILE_MODE afterwards.
+ * */
+class BulkLoader {
+ public:
+    struct Input {
+        // Edge list files, one "source destination" pair per line separated by spaces, tabs or a comma
+        std::vector<std::string> localEdges;
+        // Edges cut by the partitioning, "source destination [source partition destination partition]" per line
+        std::vector<std::string> centralEdges;
+        // Optional node properties, a CSV file with an id column or a JSON lines file ({"id": .., "properties": {..}})
+        std::string nodeProperties;
+        // Optional edge properties, a CSV file with source and destination columns or a JSON lines file
+        // ({"source": .., "destination": .., "properties": {..}}). A type property sets the relationship type
+        std::string edgeProperties;
+    };
+
+    BulkLoader(const GraphConfig &gConfig, unsigned long memoryBytes);
+    bool load(const Input &input);
+
+    unsigned long nodeCount() const { return nodeIds.size(); }
+    unsigned long localRelationCount() const { return relationCounts[0]; }
+    unsigned long centralRelationCount() const { return relationCounts[1]; }
+
+    static const unsigned long DEFAULT_MEMORY_BYTES = 1024UL * 1024 * 1024;
+
+ private:
+    struct RelationFile;
+
+    bool readEdges(const std::vector<std::string> &paths, bool central, RelationFile &relations);
+    bool orderRelations(RelationFile &relations);
+    bool loadNodeProperties(const std::string &path);
+    bool loadEdgeProperties(const std::string &path, RelationFile &local, RelationFile &central);
+    bool writeRelations(RelationFile &relations);
+    bool writeNodes();
+    long nodeIndex(unsigned int nodeId) const;
+    unsigned int appendProperty(const std::string &name, const std::string &value, unsigned int next, bool edge);
+    void collectNodeIds(bool final);
+
+    GraphConfig gConfig;
+    unsigned long memoryBytes;
+    std::string dbPrefix;
+    std::string tempPrefix;
+    bool columnarProperties = false;
+
+    std::vector<unsigned int> nodeIds;  // Node ID of every node block, ascending
+    std::vector<unsigned int> collectedIds;
+    std::vector<unsigned int> localHeads;    // Local outgoing relation chain head of each node, a relation block index
+    std::vector<unsigned int> centralHeads;  // Central outgoing relation chain head of each node
+    std::vector<unsigned int> propertyHeads;  // First property block of each node
+    std::unordered_map<unsigned int, std::string> labels;  // Labels of the nodes that have a label property
+    std::unordered_map<unsigned int, unsigned int> remotePartitions;  // Partition of nodes from other partitions
+    unsigned long relationCounts[2] = {0, 0};
+
+    unsigned long collectLimit = 0;  // Collected node IDs that trigger the next deduplication
+
+    std::ofstream properties;
+    std::ofstream edgeProperties;
+    unsigned long propertyBlocks = 1;  // Block 0 of the property files is not used
+    unsigned long edgePropertyBlocks = 1;
+};
+
+#endif  // JASMINEGRAPH_BULKLOADER_H
@@ -0,0 +1,85 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "CsrSnapshot.h"
+
+#include <algorithm>
+
+/**
+ * Counting sort of the edges by source into the rows, then every row is sorted and deduplicated in place and the rows
+ * are compacted.
+ * */
+CsrSnapshot CsrSnapshot::fromEdges(std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                                   std::vector<unsigned int> nodeIds, bool undirected) {
+    CsrSnapshot snapshot;
+    snapshot.nodeIds = std::move(nodeIds);
+    unsigned int vertexCount = snapshot.nodeIds.size();
+    std::vector<unsigned long long> counts(vertexCount + 1, 0);
+    for (auto &edge : edges) {
+        counts[edge.first + 1]++;
+        if (undirected) {
+            counts[edge.second + 1]++;
+        }
+    }
+    for (unsigned int vertex = 0; vertex < vertexCount; vertex++) {
+        counts[vertex + 1] += counts[vertex];
+    }
+    std::vector<unsigned long long> next(counts.begin(), counts.end() - 1);
+    snapshot.neighbors.resize(counts[vertexCount]);
+    for (auto &edge : edges) {
+        snapshot.neighbors[next[edge.first]++] = edge.second;
+        if (undirected) {
+            snapshot.neighbors[next[edge.second]++] = edge.first;
+        }
+    }
+
+    snapshot.offsets.resize(vertexCount + 1);
+    unsigned long long size = 0;
+    for (unsigned int vertex = 0; vertex < vertexCount; vertex++) {
+        auto rowBegin = snapshot.neighbors.begin() + counts[vertex];
+        auto rowEnd = snapshot.neighbors.begin() + counts[vertex + 1];
+        std::sort(rowBegin, rowEnd);
+        rowEnd = std::unique(rowBegin, rowEnd);
+        snapshot.offsets[vertex] = size;
+        size = std::copy(rowBegin, rowEnd, snapshot.neighbors.begin() + size) - snapshot.neighbors.begin();
+    }
+    snapshot.offsets[vertexCount] = size;
+    snapshot.neighbors.resize(size);
+    snapshot.neighbors.shrink_to_fit();
+    return snapshot;
+}
+
+std::map<long, std::unordered_set<long>> CsrSnapshot::toAdjacencyList(bool includeIsolated) const {
+    std::map<long, std::unordered_set<long>> adjacencyList;
+    for (unsigned int vertex = 0; vertex < this->vertexCount(); vertex++) {
+        if (!includeIsolated && this->degree(vertex) == 0) {
+            continue;
+        }
+        std::unordered_set<long> &neighbors = adjacencyList[this->nodeIds[vertex]];
+        neighbors.reserve(this->degree(vertex));
+        for (const unsigned int *neighbor = this->begin(vertex); neighbor != this->end(vertex); neighbor++) {
+            neighbors.insert(this->nodeIds[*neighbor]);
+        }
+    }
+    return adjacencyList;
+}
+
+std::map<long, long> CsrSnapshot::toDegreeMap(bool includeIsolated) const {
+    std::map<long, long> degreeMap;
+    for (unsigned int vertex = 0; vertex < this->vertexCount(); vertex++) {
+        if (includeIsolated || this->degree(vertex) > 0) {
+            degreeMap[this->nodeIds[vertex]] = this->degree(vertex);
+        }
+    }
+    return degreeMap;
+}
@@ -0,0 +1,52 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_CSRSNAPSHOT_H
+#define JASMINEGRAPH_CSRSNAPSHOT_H
+
+#include <map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Compressed sparse row snapshot of the edges of a partition, see NodeManager::getCsrSnapshot().
+ *
+ * Vertices have dense IDs 0..n-1, the node block indexes of the partition, and nodeIds maps them back to node IDs.
+ * The neighbors of vertex v are neighbors[offsets[v]] .. neighbors[offsets[v + 1] - 1], in ascending order and without
+ * duplicates. The snapshot does not follow later updates of the partition.
+ * */
+class CsrSnapshot {
+ public:
+    std::vector<unsigned long long> offsets;  // vertexCount() + 1 entries
+    std::vector<unsigned int> neighbors;
+    std::vector<unsigned int> nodeIds;        // Dense vertex ID -> node ID
+
+    // Build the rows from (source, destination) pairs of dense vertex IDs, also adding the reverse of each edge if
+    // undirected is set
+    static CsrSnapshot fromEdges(std::vector<std::pair<unsigned int, unsigned int>> &edges,
+                                 std::vector<unsigned int> nodeIds, bool undirected);
+
+    unsigned int vertexCount() const { return nodeIds.size(); }
+    unsigned long long edgeCount() const { return neighbors.size(); }
+    unsigned int degree(unsigned int vertex) const { return offsets[vertex + 1] - offsets[vertex]; }
+    const unsigned int *begin(unsigned int vertex) const { return neighbors.data() + offsets[vertex]; }
+    const unsigned int *end(unsigned int vertex) const { return neighbors.data() + offsets[vertex + 1]; }
+
+    // Node ID keyed forms used by the triangle counting, vertices without neighbors are left out unless
+    // includeIsolated is set
+    std::map<long, std::unordered_set<long>> toAdjacencyList(bool includeIsolated = true) const;
+    std::map<long, long> toDegreeMap(bool includeIsolated = true) const;
+};
+
+#endif  // JASMINEGRAPH_CSRSNAPSHOT_H
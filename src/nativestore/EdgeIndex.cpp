@@ -0,0 +1,354 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "EdgeIndex.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "../util/logger/Logger.h"
+#include "NodeBlock.h"
+#include "RelationBlock.h"
+
+Logger edge_index_logger;
+
+std::map<std::string, EdgeIndex *> EdgeIndex::openIndexes;
+std::mutex EdgeIndex::openIndexesLock;
+
+// The last two characters are the version of the table layout, tables of other versions are rebuilt
+static const char EDGE_INDEX_MAGIC[8] = {'J', 'G', 'E', 'I', 'D', 'X', '0', '2'};
+static const size_t EDGE_INDEX_MAGIC_PREFIX = 6;
+static const unsigned long long INITIAL_CAPACITY = 1024;  // Buckets, always a power of two
+static const unsigned long REBUILD_READ_BLOCKS = 4096;    // Relation blocks read at once while rebuilding
+
+EdgeIndex *EdgeIndex::acquire(const std::string &path, bool *opened) {
+    std::lock_guard<std::mutex> guard(EdgeIndex::openIndexesLock);
+    EdgeIndex *index;
+    auto it = EdgeIndex::openIndexes.find(path);
+    if (it != EdgeIndex::openIndexes.end()) {
+        index = it->second;
+    } else {
+        index = new EdgeIndex(path);
+        EdgeIndex::openIndexes[path] = index;
+    }
+    index->references++;
+    if (opened) {
+        *opened = index->references == 1;
+    }
+    return index;
+}
+
+void EdgeIndex::release(EdgeIndex *index) {
+    std::lock_guard<std::mutex> guard(EdgeIndex::openIndexesLock);
+    if (--index->references > 0) {
+        index->flush();
+        return;
+    }
+    EdgeIndex::openIndexes.erase(index->path);
+    delete index;
+}
+
+EdgeIndex::EdgeIndex(const std::string &path) : path(path) {}
+
+EdgeIndex::~EdgeIndex() {
+    this->flush();
+    this->closeFile();
+}
+
+void EdgeIndex::closeFile() {
+    if (this->header) {
+        munmap(this->header, this->mappedSize);
+        this->header = nullptr;
+        this->buckets = nullptr;
+    }
+    if (this->fd >= 0) {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+}
+
+bool EdgeIndex::ensureOpen() {
+    if (this->header) {
+        return true;
+    }
+    this->fd = open(this->path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->fd < 0) {
+        edge_index_logger.error("Error while opening edge index " + this->path);
+        return false;
+    }
+    struct stat stat_buf;
+    fstat(this->fd, &stat_buf);
+    if (stat_buf.st_size < (off_t)sizeof(Header)) {
+        return this->mapTable(INITIAL_CAPACITY, true);
+    }
+    Header fileHeader;
+    if (pread(this->fd, &fileHeader, sizeof(Header), 0) != sizeof(Header) ||
+        std::memcmp(fileHeader.magic, EDGE_INDEX_MAGIC, EDGE_INDEX_MAGIC_PREFIX) != 0) {
+        edge_index_logger.error("Edge index " + this->path + " is corrupted!");
+        this->closeFile();
+        return false;
+    }
+    if (std::memcmp(fileHeader.magic, EDGE_INDEX_MAGIC, sizeof(EDGE_INDEX_MAGIC)) != 0) {
+        // An empty table covers no relation blocks, so the NodeManager rebuilds it from the relation file
+        edge_index_logger.info("Edge index " + this->path + " has an older layout, it will be rebuilt");
+        if (ftruncate(this->fd, 0) != 0) {
+            edge_index_logger.error("Error while truncating edge index " + this->path);
+            this->closeFile();
+            return false;
+        }
+        return this->mapTable(INITIAL_CAPACITY, true);
+    }
+    return this->mapTable(fileHeader.capacity, false);
+}
+
+bool EdgeIndex::mapTable(unsigned long long capacity, bool create) {
+    unsigned long size = sizeof(Header) + capacity * sizeof(Bucket);
+    if (create && ftruncate(this->fd, size) != 0) {
+        edge_index_logger.error("Error while resizing edge index " + this->path);
+        return false;
+    }
+    void *region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    if (region == MAP_FAILED) {
+        edge_index_logger.error("Error while memory mapping edge index " + this->path);
+        return false;
+    }
+    this->header = static_cast<Header *>(region);
+    this->buckets = reinterpret_cast<Bucket *>(static_cast<char *>(region) + sizeof(Header));
+    this->mappedSize = size;
+    if (create) {
+        std::memcpy(this->header->magic, EDGE_INDEX_MAGIC, sizeof(EDGE_INDEX_MAGIC));
+        this->header->capacity = capacity;
+        this->header->count = 0;
+        this->header->relations = 0;
+    }
+    return true;
+}
+
+unsigned long long EdgeIndex::hashKey(unsigned int source, unsigned int destination) {
+    // splitmix64 finalizer over the packed node index pair
+    unsigned long long hash = (static_cast<unsigned long long>(source) << 32) | destination;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+EdgeIndex::Bucket *EdgeIndex::findBucket(unsigned int source, unsigned int destination) {
+    unsigned long long mask = this->header->capacity - 1;
+    for (unsigned long long slot = EdgeIndex::hashKey(source, destination) & mask;; slot = (slot + 1) & mask) {
+        Bucket *bucket = &this->buckets[slot];
+        if (bucket->relationAddress == 0) {
+            return nullptr;
+        }
+        if (bucket->source == source && bucket->destination == destination) {
+            return bucket;
+        }
+    }
+}
+
+void EdgeIndex::insertBucket(const Bucket &bucket) {
+    unsigned long long mask = this->header->capacity - 1;
+    unsigned long long slot = EdgeIndex::hashKey(bucket.source, bucket.destination) & mask;
+    while (this->buckets[slot].relationAddress != 0) {
+        slot = (slot + 1) & mask;
+    }
+    this->buckets[slot] = bucket;
+    this->header->count++;
+}
+
+/**
+ * Empty the bucket at slot with backward shift deletion: buckets of the probe run after it move back into the hole if
+ * their home slot allows it, so lookups that stop at the first empty bucket still find them
+ * */
+void EdgeIndex::removeBucket(unsigned long long slot) {
+    unsigned long long mask = this->header->capacity - 1;
+    unsigned long long hole = slot;
+    for (unsigned long long next = (hole + 1) & mask; this->buckets[next].relationAddress != 0;
+         next = (next + 1) & mask) {
+        const Bucket &bucket = this->buckets[next];
+        unsigned long long home = EdgeIndex::hashKey(bucket.source, bucket.destination) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            this->buckets[hole] = this->buckets[next];
+            hole = next;
+        }
+    }
+    this->buckets[hole] = Bucket{0, 0, 0};
+    this->header->count--;
+}
+
+/**
+ * Double the bucket count once the table is 70% full, building the new table in a separate file that is renamed over
+ * the old one
+ * */
+bool EdgeIndex::grow() {
+    unsigned long long oldCapacity = this->header->capacity;
+    unsigned long long newCapacity = oldCapacity * 2;
+    std::string tmpPath = this->path + ".tmp";
+    int newFd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    unsigned long newSize = sizeof(Header) + newCapacity * sizeof(Bucket);
+    if (newFd < 0 || ftruncate(newFd, newSize) != 0) {
+        edge_index_logger.error("Error while growing edge index " + this->path);
+        if (newFd >= 0) ::close(newFd);
+        return false;
+    }
+    void *region = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, newFd, 0);
+    if (region == MAP_FAILED) {
+        edge_index_logger.error("Error while memory mapping grown edge index " + this->path);
+        ::close(newFd);
+        return false;
+    }
+    Header *oldHeader = this->header;
+    Bucket *oldBuckets = this->buckets;
+    unsigned long oldSize = this->mappedSize;
+
+    this->header = static_cast<Header *>(region);
+    this->buckets = reinterpret_cast<Bucket *>(static_cast<char *>(region) + sizeof(Header));
+    std::memcpy(this->header->magic, EDGE_INDEX_MAGIC, sizeof(EDGE_INDEX_MAGIC));
+    this->header->capacity = newCapacity;
+    this->header->count = 0;
+    this->header->relations = oldHeader->relations;
+    for (unsigned long long slot = 0; slot < oldCapacity; slot++) {
+        if (oldBuckets[slot].relationAddress != 0) {
+            this->insertBucket(oldBuckets[slot]);
+        }
+    }
+    msync(region, newSize, MS_SYNC);
+    munmap(oldHeader, oldSize);
+    ::close(this->fd);
+    rename(tmpPath.c_str(), this->path.c_str());
+    this->fd = newFd;
+    this->mappedSize = newSize;
+    return true;
+}
+
+unsigned long EdgeIndex::find(unsigned long sourceAddress, unsigned long destinationAddress) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return 0;
+    }
+    unsigned int source = sourceAddress / NodeBlock::BLOCK_SIZE;
+    unsigned int destination = destinationAddress / NodeBlock::BLOCK_SIZE;
+    if (source > destination) {
+        std::swap(source, destination);
+    }
+    Bucket *bucket = this->findBucket(source, destination);
+    return bucket ? bucket->relationAddress : 0;
+}
+
+void EdgeIndex::insert(unsigned long sourceAddress, unsigned long destinationAddress, unsigned long relationAddress) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return;
+    }
+    unsigned int source = sourceAddress / NodeBlock::BLOCK_SIZE;
+    unsigned int destination = destinationAddress / NodeBlock::BLOCK_SIZE;
+    if (source > destination) {
+        std::swap(source, destination);
+    }
+    this->header->relations++;
+    if (this->findBucket(source, destination)) {
+        return;
+    }
+    if ((this->header->count + 1) * 10 > this->header->capacity * 7 && !this->grow()) {
+        return;
+    }
+    this->insertBucket(Bucket{source, destination, relationAddress});
+}
+
+void EdgeIndex::remove(unsigned long sourceAddress, unsigned long destinationAddress, unsigned long relationAddress) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return;
+    }
+    unsigned int source = sourceAddress / NodeBlock::BLOCK_SIZE;
+    unsigned int destination = destinationAddress / NodeBlock::BLOCK_SIZE;
+    if (source > destination) {
+        std::swap(source, destination);
+    }
+    if (this->header->relations > 0) {
+        this->header->relations--;
+    }
+    Bucket *bucket = this->findBucket(source, destination);
+    if (bucket && bucket->relationAddress == relationAddress) {  // Else a duplicate of the indexed relation is removed
+        this->removeBucket(bucket - this->buckets);
+    }
+}
+
+unsigned long EdgeIndex::size() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return 0;
+    }
+    return this->header->count;
+}
+
+unsigned long EdgeIndex::relationCount() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return 0;
+    }
+    return this->header->relations;
+}
+
+void EdgeIndex::flush() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (this->header) {
+        msync(this->header, this->mappedSize, MS_ASYNC);
+    }
+}
+
+void EdgeIndex::truncate() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->closeFile();
+    ::truncate(this->path.c_str(), 0);
+}
+
+/**
+ * Index every relation block of the file (block 0 and freed blocks are unused), used when the index is missing or out
+ * of step with the relation blocks, e.g. for partitions written by older versions
+ * */
+bool EdgeIndex::rebuild(const std::string &relationsPath, unsigned long blockSize) {
+    this->truncate();
+    std::ifstream relations(relationsPath, std::ios::binary);
+    if (!relations.is_open()) {
+        edge_index_logger.error("Error while opening " + relationsPath + " to rebuild the edge index");
+        return false;
+    }
+    edge_index_logger.info("Rebuilding edge index " + this->path);
+    std::vector<char> blocks(REBUILD_READ_BLOCKS * blockSize);
+    unsigned long address = 0;
+    while (relations.read(blocks.data(), blocks.size()) || relations.gcount() > 0) {
+        unsigned long readBlocks = relations.gcount() / blockSize;
+        for (unsigned long i = 0; i < readBlocks; i++, address += blockSize) {
+            if (address == 0) {
+                continue;
+            }
+            // Source and destination records decode the same way in local and central relation blocks
+            const char *block = blocks.data() + i * blockSize;
+            if (RelationBlock::isFree(block)) {
+                continue;
+            }
+            this->insert(RelationBlock::readRecord(block, RelationOffsets::SOURCE, false),
+                         RelationBlock::readRecord(block, RelationOffsets::DESTINATION, false), address);
+        }
+    }
+    this->flush();
+    edge_index_logger.info("Indexed " + std::to_string(this->size()) + " edges of " + relationsPath);
+    return true;
+}
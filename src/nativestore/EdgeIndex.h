@@ -0,0 +1,89 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_EDGEINDEX_H
+#define JASMINEGRAPH_EDGEINDEX_H
+
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * Persistent set of the edges in a relation block file, keyed by the (source, destination) node blocks.
+ *
+ * Answers whether an edge exists with a single hash table probe instead of walking the relation chain of the source
+ * node, so that edge inserts stay O(1) for high degree nodes. Edges are undirected like the relation chains, (a, b)
+ * and (b, a) are the same key. The table is an open addressing hash table file memory mapped on first use, and it
+ * keeps the address of the relation block of every edge.
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see EdgeIndex::acquire().
+ * */
+class EdgeIndex {
+ public:
+    // opened is set if this call opened the index, false if another NodeManager of the partition has it open
+    static EdgeIndex *acquire(const std::string &path, bool *opened = NULL);
+    static void release(EdgeIndex *index);
+
+    // Relation block address of the edge, 0 if the edge does not exist
+    unsigned long find(unsigned long sourceAddress, unsigned long destinationAddress);
+    void insert(unsigned long sourceAddress, unsigned long destinationAddress, unsigned long relationAddress);
+    // Remove the edge of the relation block at relationAddress, which is being freed
+    void remove(unsigned long sourceAddress, unsigned long destinationAddress, unsigned long relationAddress);
+    unsigned long size();
+    // Number of relation blocks the index covers, to tell if it is in step with the relation block file
+    unsigned long relationCount();
+    void flush();
+    void truncate();
+    // Re-create the index from the source and destination records of the relation blocks in relationsPath
+    bool rebuild(const std::string &relationsPath, unsigned long blockSize);
+
+ private:
+    explicit EdgeIndex(const std::string &path);
+    ~EdgeIndex();
+
+    // Nodes are kept as node block indexes, the relation as its block address
+    struct Bucket {
+        unsigned int source;
+        unsigned int destination;
+        unsigned long relationAddress;  // 0 marks an empty bucket, relation block 0 is never used
+    };
+
+    struct Header {
+        char magic[8];
+        unsigned long long capacity;
+        unsigned long long count;
+        unsigned long long relations;  // Relation blocks indexed, duplicates of an indexed edge included
+    };
+
+    bool ensureOpen();
+    bool mapTable(unsigned long long capacity, bool create);
+    bool grow();
+    void closeFile();
+    Bucket *findBucket(unsigned int source, unsigned int destination);
+    void insertBucket(const Bucket &bucket);
+    void removeBucket(unsigned long long slot);
+    static unsigned long long hashKey(unsigned int source, unsigned int destination);
+
+    std::string path;
+    int fd = -1;
+    Header *header = nullptr;
+    Bucket *buckets = nullptr;
+    unsigned long mappedSize = 0;
+    std::mutex lock;
+    int references = 0;
+
+    static std::map<std::string, EdgeIndex *> openIndexes;
+    static std::mutex openIndexesLock;
+};
+
+#endif  // JASMINEGRAPH_EDGEINDEX_H
@@ -0,0 +1,202 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "IncomingRelationHeads.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "../util/logger/Logger.h"
+#include "RelationBlock.h"
+
+Logger incoming_heads_logger;
+
+std::map<std::string, IncomingRelationHeads *> IncomingRelationHeads::openHeads;
+std::mutex IncomingRelationHeads::openHeadsLock;
+thread_local IncomingRelationHeads *IncomingRelationHeads::current = nullptr;
+
+static const char INCOMING_HEADS_MAGIC[8] = {'J', 'G', 'I', 'N', 'H', 'D', '0', '1'};
+static const unsigned long long INITIAL_CAPACITY = 1024;  // Nodes, grown by doubling
+
+IncomingRelationHeads *IncomingRelationHeads::acquire(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(IncomingRelationHeads::openHeadsLock);
+    std::string path = dbPrefix + "_incoming_heads.db";
+    IncomingRelationHeads *heads;
+    auto it = IncomingRelationHeads::openHeads.find(path);
+    if (it != IncomingRelationHeads::openHeads.end()) {
+        heads = it->second;
+    } else {
+        heads = new IncomingRelationHeads(path);
+        IncomingRelationHeads::openHeads[path] = heads;
+    }
+    heads->references++;
+    return heads;
+}
+
+void IncomingRelationHeads::release(IncomingRelationHeads *heads) {
+    std::lock_guard<std::mutex> guard(IncomingRelationHeads::openHeadsLock);
+    if (--heads->references > 0) {
+        heads->flush();
+        return;
+    }
+    IncomingRelationHeads::openHeads.erase(heads->path);
+    delete heads;
+}
+
+bool IncomingRelationHeads::exists(const std::string &dbPrefix) {
+    struct stat stat_buf;
+    return stat((dbPrefix + "_incoming_heads.db").c_str(), &stat_buf) == 0;
+}
+
+IncomingRelationHeads::IncomingRelationHeads(const std::string &path) : path(path) {}
+
+IncomingRelationHeads::~IncomingRelationHeads() {
+    this->flush();
+    this->closeFile();
+}
+
+void IncomingRelationHeads::closeFile() {
+    if (this->header) {
+        munmap(this->header, this->mappedSize);
+        this->header = nullptr;
+        this->heads = nullptr;
+    }
+    if (this->fd >= 0) {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+}
+
+bool IncomingRelationHeads::ensureOpen() {
+    if (this->header) {
+        return true;
+    }
+    this->fd = open(this->path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->fd < 0) {
+        incoming_heads_logger.error("Error while opening incoming relation heads " + this->path);
+        return false;
+    }
+    struct stat stat_buf;
+    fstat(this->fd, &stat_buf);
+    if (stat_buf.st_size < (off_t)sizeof(Header)) {
+        return this->mapFile(INITIAL_CAPACITY, true);
+    }
+    Header fileHeader;
+    if (pread(this->fd, &fileHeader, sizeof(Header), 0) != sizeof(Header) ||
+        std::memcmp(fileHeader.magic, INCOMING_HEADS_MAGIC, sizeof(INCOMING_HEADS_MAGIC)) != 0) {
+        incoming_heads_logger.error("Incoming relation heads " + this->path +
+                                    " are corrupted, remove the file to relink the relation chains");
+        this->closeFile();
+        return false;
+    }
+    return this->mapFile(fileHeader.capacity, false);
+}
+
+bool IncomingRelationHeads::mapFile(unsigned long long capacity, bool create) {
+    unsigned long size = sizeof(Header) + capacity * sizeof(Heads);
+    // Grown files keep their heads, the new part of the file reads as zeros
+    if ((create || size > this->mappedSize) && ftruncate(this->fd, size) != 0) {
+        incoming_heads_logger.error("Error while resizing incoming relation heads " + this->path);
+        return false;
+    }
+    void *region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    if (region == MAP_FAILED) {
+        incoming_heads_logger.error("Error while memory mapping incoming relation heads " + this->path);
+        return false;
+    }
+    if (this->header) {
+        munmap(this->header, this->mappedSize);
+    }
+    this->header = static_cast<Header *>(region);
+    this->heads = reinterpret_cast<Heads *>(static_cast<char *>(region) + sizeof(Header));
+    this->mappedSize = size;
+    if (create) {
+        std::memcpy(this->header->magic, INCOMING_HEADS_MAGIC, sizeof(INCOMING_HEADS_MAGIC));
+    }
+    this->header->capacity = capacity;
+    return true;
+}
+
+// Make room for the heads of nodeIndex, called with the lock held
+bool IncomingRelationHeads::reserve(unsigned int nodeIndex) {
+    if (!this->ensureOpen()) {
+        return false;
+    }
+    if (nodeIndex < this->header->capacity) {
+        return true;
+    }
+    unsigned long long capacity = this->header->capacity;
+    while (capacity <= nodeIndex) {
+        capacity *= 2;
+    }
+    return this->mapFile(capacity, false);
+}
+
+unsigned long IncomingRelationHeads::get(unsigned int nodeIndex, bool central) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen() || nodeIndex >= this->header->capacity) {
+        return 0;
+    }
+    // Heads are kept as block indexes, independent of the BlockFormat of the partition
+    const Heads &node = this->heads[nodeIndex];
+    return central ? (unsigned long)node.central * RelationBlock::CENTRAL_BLOCK_SIZE
+                   : (unsigned long)node.local * RelationBlock::BLOCK_SIZE;
+}
+
+bool IncomingRelationHeads::set(unsigned int nodeIndex, bool central, unsigned long relationAddress) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->reserve(nodeIndex)) {
+        return false;
+    }
+    Heads &node = this->heads[nodeIndex];
+    if (central) {
+        node.central = relationAddress / RelationBlock::CENTRAL_BLOCK_SIZE;
+    } else {
+        node.local = relationAddress / RelationBlock::BLOCK_SIZE;
+    }
+    return true;
+}
+
+bool IncomingRelationHeads::assign(const std::vector<unsigned int> &heads, bool central) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!heads.empty() && !this->reserve(heads.size() - 1)) {
+        return false;
+    }
+    if (!this->ensureOpen()) {
+        return false;
+    }
+    for (unsigned long long nodeIndex = 0; nodeIndex < this->header->capacity; nodeIndex++) {
+        unsigned int head = nodeIndex < heads.size() ? heads[nodeIndex] : 0;
+        (central ? this->heads[nodeIndex].central : this->heads[nodeIndex].local) = head;
+    }
+    msync(this->header, this->mappedSize, MS_ASYNC);
+    return true;
+}
+
+// The heads are part of the relation chains, they are synced with the block files at a checkpoint
+void IncomingRelationHeads::flush() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (this->header) {
+        msync(this->header, this->mappedSize, MS_SYNC);
+    }
+}
+
+void IncomingRelationHeads::truncate() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->closeFile();
+    ::truncate(this->path.c_str(), 0);
+}
@@ -0,0 +1,84 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_INCOMINGRELATIONHEADS_H
+#define JASMINEGRAPH_INCOMINGRELATIONHEADS_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Heads of the incoming relation chains of the nodes of a partition, kept next to the node blocks in
+ * _incoming_heads.db.
+ *
+ * A node has an outgoing chain of the relations it is the source of, linked through their source records, and an
+ * incoming chain of the relations it is the destination of, linked through their destination records. The heads of
+ * the outgoing chains are the edgeRef / centralEdgeRef records of the node blocks, the heads of the incoming chains
+ * are in this file: the local and central relation block index of each node block index after a small header. A walk
+ * of one direction never reads a relation block of the other.
+ *
+ * Partitions without the file were written with one chain per node and are relinked when they are opened.
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see IncomingRelationHeads::acquire().
+ * */
+class IncomingRelationHeads {
+ public:
+    static IncomingRelationHeads *acquire(const std::string &dbPrefix);
+    static void release(IncomingRelationHeads *heads);
+    static bool exists(const std::string &dbPrefix);
+
+    // Address of the first relation of the local or central incoming chain of the node, 0 if the chain is empty
+    unsigned long get(unsigned int nodeIndex, bool central);
+    bool set(unsigned int nodeIndex, bool central, unsigned long relationAddress);
+    // Replace the local or central heads of every node, heads[i] is the relation block index of node block index i
+    bool assign(const std::vector<unsigned int> &heads, bool central);
+    void flush();
+    void truncate();
+
+    // Heads of the partition attached to the calling thread, NULL if none
+    static thread_local IncomingRelationHeads *current;
+
+ private:
+    explicit IncomingRelationHeads(const std::string &path);
+    ~IncomingRelationHeads();
+
+    struct Header {
+        char magic[8];
+        unsigned long long capacity;  // Nodes the file has heads for
+    };
+
+    struct Heads {
+        unsigned int local = 0;
+        unsigned int central = 0;
+    };
+
+    bool ensureOpen();
+    bool mapFile(unsigned long long capacity, bool create);
+    bool reserve(unsigned int nodeIndex);
+    void closeFile();
+
+    std::string path;
+    int fd = -1;
+    Header *header = nullptr;
+    Heads *heads = nullptr;
+    unsigned long mappedSize = 0;
+    std::mutex lock;
+    int references = 0;
+
+    static std::map<std::string, IncomingRelationHeads *> openHeads;
+    static std::mutex openHeadsLock;
+};
+
+#endif  // JASMINEGRAPH_INCOMINGRELATIONHEADS_H
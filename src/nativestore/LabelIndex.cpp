@@ -0,0 +1,254 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "LabelIndex.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#include "../util/logger/Logger.h"
+
+Logger label_index_logger;
+
+thread_local LabelIndex *LabelIndex::current = nullptr;
+std::map<std::string, LabelIndex *> LabelIndex::openIndexes;
+std::mutex LabelIndex::openIndexesLock;
+
+static const unsigned int WORD_BITS = 64;
+
+LabelIndex *LabelIndex::acquire(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(LabelIndex::openIndexesLock);
+    auto it = LabelIndex::openIndexes.find(dbPrefix);
+    if (it != LabelIndex::openIndexes.end()) {
+        it->second->references++;
+        return it->second;
+    }
+    LabelIndex *index = new LabelIndex(dbPrefix);
+    if (!index->open()) {
+        delete index;
+        return nullptr;
+    }
+    index->references++;
+    LabelIndex::openIndexes[dbPrefix] = index;
+    return index;
+}
+
+void LabelIndex::release(LabelIndex *index) {
+    if (!index) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(LabelIndex::openIndexesLock);
+    if (--index->references > 0) {
+        return;
+    }
+    LabelIndex::openIndexes.erase(index->dbPrefix);
+    delete index;
+}
+
+bool LabelIndex::exists(const std::string &dbPrefix) {
+    struct stat stat_buf;
+    return stat((dbPrefix + "_labels.db").c_str(), &stat_buf) == 0;
+}
+
+LabelIndex::LabelIndex(const std::string &dbPrefix) : dbPrefix(dbPrefix) {}
+
+LabelIndex::~LabelIndex() { this->close(); }
+
+/**
+ * Open the label dictionary and load it. Dictionary records are [label length (4)][label bytes], the ID of a label is
+ * the position of its record.
+ * */
+bool LabelIndex::open() {
+    std::string labelsPath = this->dbPrefix + "_labels.db";
+    this->labelsFd = ::open(labelsPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (this->labelsFd < 0) {
+        label_index_logger.error("Error while opening label index " + labelsPath);
+        return false;
+    }
+    unsigned long long offset = 0;
+    unsigned int length;
+    while (pread(this->labelsFd, &length, sizeof(length), offset) == sizeof(length)) {
+        std::string label(length, '\0');
+        if (pread(this->labelsFd, &label[0], length, offset + sizeof(length)) != (ssize_t)length) {
+            label_index_logger.error("Label index " + labelsPath + " is corrupted!");
+            break;
+        }
+        this->labelIds[label] = this->labelNames.size();
+        this->labelNames.push_back(label);
+        this->bitmapFds.push_back(-1);
+        offset += sizeof(length) + length;
+    }
+    return true;
+}
+
+void LabelIndex::close() {
+    for (int &fd : this->bitmapFds) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (this->labelsFd >= 0) {
+        ::close(this->labelsFd);
+        this->labelsFd = -1;
+    }
+}
+
+std::string LabelIndex::bitmapPath(int id) { return this->dbPrefix + "_label_" + std::to_string(id) + ".bitmap"; }
+
+int LabelIndex::labelId(const std::string &label, bool create) {
+    auto it = this->labelIds.find(label);
+    if (it != this->labelIds.end()) {
+        return it->second;
+    }
+    if (!create) {
+        return -1;
+    }
+    unsigned int length = label.length();
+    std::string record(reinterpret_cast<char *>(&length), sizeof(length));
+    record += label;
+    if (write(this->labelsFd, record.data(), record.size()) != (ssize_t)record.size()) {
+        label_index_logger.error("Error while adding label " + label + " to the label index");
+        return -1;
+    }
+    int id = this->labelNames.size();
+    this->labelIds[label] = id;
+    this->labelNames.push_back(label);
+    this->bitmapFds.push_back(-1);
+    return id;
+}
+
+int LabelIndex::bitmapFd(int id) {
+    if (this->bitmapFds[id] < 0) {
+        this->bitmapFds[id] = ::open(this->bitmapPath(id).c_str(), O_RDWR | O_CREAT, 0644);
+        if (this->bitmapFds[id] < 0) {
+            label_index_logger.error("Error while opening label bitmap " + this->bitmapPath(id));
+        }
+    }
+    return this->bitmapFds[id];
+}
+
+void LabelIndex::updateBit(const std::string &label, unsigned int nodeIndex, bool set) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    int id = this->labelId(label, set);
+    if (id < 0) {
+        return;
+    }
+    int fd = this->bitmapFd(id);
+    if (fd < 0) {
+        return;
+    }
+    off_t offset = (off_t)(nodeIndex / WORD_BITS) * sizeof(unsigned long long);
+    unsigned long long word = 0;
+    if (pread(fd, &word, sizeof(word), offset) < 0) {
+        label_index_logger.error("Error while reading label bitmap of " + label);
+        return;
+    }
+    unsigned long long bit = 1ULL << (nodeIndex % WORD_BITS);
+    word = set ? (word | bit) : (word & ~bit);
+    if (pwrite(fd, &word, sizeof(word), offset) != sizeof(word)) {
+        label_index_logger.error("Error while updating label bitmap of " + label);
+    }
+}
+
+void LabelIndex::add(const std::string &label, unsigned int nodeIndex) { this->updateBit(label, nodeIndex, true); }
+
+void LabelIndex::remove(const std::string &label, unsigned int nodeIndex) {
+    this->updateBit(label, nodeIndex, false);
+}
+
+LabelIndex::Bitmap LabelIndex::readBitmap(int id) {
+    Bitmap bitmap;
+    int fd = this->bitmapFd(id);
+    struct stat stat_buf;
+    if (fd < 0 || fstat(fd, &stat_buf) != 0) {
+        return bitmap;
+    }
+    bitmap.resize(stat_buf.st_size / sizeof(unsigned long long));
+    if (pread(fd, bitmap.data(), bitmap.size() * sizeof(unsigned long long), 0) < 0) {
+        label_index_logger.error("Error while reading label bitmap " + this->bitmapPath(id));
+        bitmap.clear();
+    }
+    return bitmap;
+}
+
+LabelIndex::Bitmap LabelIndex::getBitmap(const std::string &label) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    int id = this->labelId(label, false);
+    if (id < 0) {
+        return Bitmap();
+    }
+    return this->readBitmap(id);
+}
+
+std::vector<unsigned int> LabelIndex::toNodes(const Bitmap &bitmap) {
+    std::vector<unsigned int> nodes;
+    for (size_t word = 0; word < bitmap.size(); word++) {
+        unsigned long long bits = bitmap[word];
+        while (bits) {
+            nodes.push_back(word * WORD_BITS + __builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+    return nodes;
+}
+
+std::vector<unsigned int> LabelIndex::getNodes(const std::string &label) {
+    return LabelIndex::toNodes(this->getBitmap(label));
+}
+
+std::vector<unsigned int> LabelIndex::getNodes(const std::vector<std::string> &labels, bool all) {
+    Bitmap result;
+    for (size_t i = 0; i < labels.size(); i++) {
+        Bitmap bitmap = this->getBitmap(labels[i]);
+        if (i == 0) {
+            result = std::move(bitmap);
+        } else if (all) {
+            result.resize(std::min(result.size(), bitmap.size()));
+            for (size_t word = 0; word < result.size(); word++) {
+                result[word] &= bitmap[word];
+            }
+        } else {
+            result.resize(std::max(result.size(), bitmap.size()));
+            for (size_t word = 0; word < bitmap.size(); word++) {
+                result[word] |= bitmap[word];
+            }
+        }
+    }
+    return LabelIndex::toNodes(result);
+}
+
+std::vector<std::string> LabelIndex::getLabels() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->labelNames;
+}
+
+void LabelIndex::truncate() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (int id = 0; id < (int)this->labelNames.size(); id++) {
+        if (this->bitmapFds[id] >= 0) {
+            ::close(this->bitmapFds[id]);
+        }
+        std::remove(this->bitmapPath(id).c_str());
+    }
+    this->bitmapFds.clear();
+    this->labelNames.clear();
+    this->labelIds.clear();
+    if (ftruncate(this->labelsFd, 0) != 0) {
+        label_index_logger.error("Error while truncating the label index of " + this->dbPrefix);
+    }
+}
@@ -0,0 +1,79 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_LABELINDEX_H
+#define JASMINEGRAPH_LABELINDEX_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Persistent label -> node set index of a partition.
+ *
+ * Every label has a bitmap file (_label_<label ID>.bitmap) where bit i is set if the node in node block i has the
+ * label, label names are mapped to IDs by a dictionary (_labels.db). A label scan reads one bitmap instead of every
+ * node block, and scans over several labels intersect or union the bitmaps before any node is read.
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see LabelIndex::acquire().
+ * */
+class LabelIndex {
+ public:
+    typedef std::vector<unsigned long long> Bitmap;
+
+    static LabelIndex *acquire(const std::string &dbPrefix);
+    static void release(LabelIndex *index);
+    static bool exists(const std::string &dbPrefix);
+
+    void add(const std::string &label, unsigned int nodeIndex);
+    void remove(const std::string &label, unsigned int nodeIndex);
+    Bitmap getBitmap(const std::string &label);
+    // Node block indexes of the nodes with the label, in ascending order
+    std::vector<unsigned int> getNodes(const std::string &label);
+    // Nodes having all of the labels (intersection) or any of them (union)
+    std::vector<unsigned int> getNodes(const std::vector<std::string> &labels, bool all);
+    std::vector<std::string> getLabels();
+    void truncate();
+
+    static std::vector<unsigned int> toNodes(const Bitmap &bitmap);
+
+    // Index of the partition attached to the calling thread, NULL if none
+    static thread_local LabelIndex *current;
+
+ private:
+    explicit LabelIndex(const std::string &dbPrefix);
+    ~LabelIndex();
+
+    bool open();
+    void close();
+    int labelId(const std::string &label, bool create);
+    int bitmapFd(int id);
+    std::string bitmapPath(int id);
+    Bitmap readBitmap(int id);
+    void updateBit(const std::string &label, unsigned int nodeIndex, bool set);
+
+    std::string dbPrefix;
+    int labelsFd = -1;
+    std::vector<std::string> labelNames;  // Indexed by label ID
+    std::unordered_map<std::string, int> labelIds;
+    std::vector<int> bitmapFds;           // Indexed by label ID, -1 until the bitmap is opened
+    std::mutex lock;
+    int references = 0;
+
+    static std::map<std::string, LabelIndex *> openIndexes;
+    static std::mutex openIndexesLock;
+};
+
+#endif  // JASMINEGRAPH_LABELINDEX_H
@@ -0,0 +1,99 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "../util/logger/Logger.h"
+
+Logger mapped_file_logger;
+
+const std::string MappedFile::STORAGE_MODE_MMAP = "mmap";
+const std::string MappedFile::STORAGE_MODE_FSTREAM = "fstream";
+
+MappedFile::MappedFile(std::string path) : path(path) {
+    this->fd = open(path.c_str(), O_RDONLY);
+    if (this->fd < 0) {
+        mapped_file_logger.error("Error while opening " + path + " for memory mapping");
+        return;
+    }
+    this->remap();
+}
+
+MappedFile::~MappedFile() {
+    if (this->region) {
+        munmap(this->region, this->mappedSize);
+    }
+    if (this->fd >= 0) {
+        close(this->fd);
+    }
+}
+
+/**
+ * Map the whole file again if it has grown since the last mapping.
+ * Block files are append only, so an existing mapping never needs to shrink.
+ * */
+bool MappedFile::remap() {
+    struct stat stat_buf;
+    if (fstat(this->fd, &stat_buf) != 0) {
+        mapped_file_logger.error("Error getting file size for: " + this->path);
+        return false;
+    }
+    unsigned long fileSize = stat_buf.st_size;
+    if (fileSize <= this->mappedSize) {
+        return false;  // Nothing new to map
+    }
+    void *newRegion;
+    if (this->region) {
+        newRegion = mremap(this->region, this->mappedSize, fileSize, MREMAP_MAYMOVE);
+    } else {
+        newRegion = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, this->fd, 0);
+    }
+    if (newRegion == MAP_FAILED) {
+        mapped_file_logger.error("Error while memory mapping " + this->path + " with size " +
+                                 std::to_string(fileSize));
+        return false;
+    }
+    madvise(newRegion, fileSize, MADV_RANDOM);
+    this->region = static_cast<char *>(newRegion);
+    this->mappedSize = fileSize;
+    return true;
+}
+
+const char *MappedFile::at(unsigned long offset, unsigned long length) {
+    if (this->fd < 0) {
+        return nullptr;
+    }
+    if (offset + length > this->mappedSize) {
+        this->remap();
+        if (offset + length > this->mappedSize) {
+            return nullptr;
+        }
+    }
+    return this->region + offset;
+}
+
+bool MappedFile::read(unsigned long offset, char *buffer, unsigned long length) {
+    const char *data = this->at(offset, length);
+    if (!data) {
+        return false;
+    }
+    std::memcpy(buffer, data, length);
+    return true;
+}
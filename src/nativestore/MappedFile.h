@@ -0,0 +1,55 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_MAPPEDFILE_H
+#define JASMINEGRAPH_MAPPEDFILE_H
+
+#include <string>
+
+/**
+ * Read only, shared memory mapping of a native store block file.
+ *
+ * Writes keep going through the block file streams, which are unbuffered (see NodeManager::openBlockFile()), so a
+ * block is in the page cache once its write returns and the MAP_SHARED mapping observes it without a flush. When a
+ * block beyond the current mapping is requested the file is re-stat'ed and remapped to its new size.
+ *
+ * tests/benchmark/NativeStoreBenchmark measured no gain over the fstream mode, random node lookups and the full
+ * relation traversal took the same time in both modes, so fstream stays the default storage mode.
+ * */
+class MappedFile {
+ public:
+    explicit MappedFile(std::string path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Returns a pointer to [offset, offset + length) or nullptr if that range is not in the file yet
+    const char *at(unsigned long offset, unsigned long length);
+    bool read(unsigned long offset, char *buffer, unsigned long length);
+    unsigned long size() const { return mappedSize; }
+    bool isOpen() const { return fd >= 0; }
+
+    static const std::string STORAGE_MODE_MMAP;
+    static const std::string STORAGE_MODE_FSTREAM;
+
+ private:
+    bool remap();
+
+    std::string path;
+    int fd = -1;
+    char *region = nullptr;
+    unsigned long mappedSize = 0;
+};
+
+#endif  // JASMINEGRAPH_MAPPEDFILE_H
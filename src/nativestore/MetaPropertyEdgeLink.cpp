@@ -16,53 +16,71 @@ limitations under the License.
 #include <memory>
 #include "MetaPropertyEdgeLink.h"
 #include "../util/logger/Logger.h"
+#include "BlockAllocator.h"
+#include "BlockCache.h"
+#include "BlockFormat.h"
+#include "StorageMetrics.h"
 
 Logger metaPropertyEdgeLinkLogger;
-thread_local unsigned int MetaPropertyEdgeLink::nextPropertyIndex = 1;
 thread_local std::fstream* MetaPropertyEdgeLink::metaEdgePropertiesDB = nullptr;
+thread_local MappedFile* MetaPropertyEdgeLink::metaEdgePropertiesMap = nullptr;
 pthread_mutex_t lockMetaPropertyEdgeLink;
 pthread_mutex_t lockCreateMetaPropertyEdgeLink;
 pthread_mutex_t lockInsertMetaPropertyEdgeLink;
 pthread_mutex_t lockGetMetaPropertyEdgeLink;
 
-MetaPropertyEdgeLink::MetaPropertyEdgeLink(unsigned int propertyBlockAddress) : blockAddress(propertyBlockAddress) {
+MetaPropertyEdgeLink::MetaPropertyEdgeLink(unsigned long propertyBlockAddress) : blockAddress(propertyBlockAddress) {
     pthread_mutex_lock(&lockMetaPropertyEdgeLink);
     if (propertyBlockAddress > 0) {
-        this->metaEdgePropertiesDB->seekg(propertyBlockAddress);
-        char rawName[MetaPropertyEdgeLink::MAX_NAME_SIZE] = {0};
-        if (!this->metaEdgePropertiesDB->read(reinterpret_cast<char*>(&rawName),
-                                              MetaPropertyEdgeLink::MAX_NAME_SIZE)) {
-            metaPropertyEdgeLinkLogger.error("Error while reading property name from block " +
-                                            std::to_string(blockAddress));
+        char block[MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE] = {0};
+        if (!MetaPropertyEdgeLink::readBlock(propertyBlockAddress, block)) {
+            metaPropertyEdgeLinkLogger.error("Error while reading edge meta property from block " +
+                                       std::to_string(blockAddress));
         }
-        metaPropertyEdgeLinkLogger.debug(
-                "Current file descriptor cursor position = " +
-                std::to_string(this->metaEdgePropertiesDB->tellg()) +
-                " when reading = " + std::to_string(blockAddress));
-        if (!this->metaEdgePropertiesDB->read(reinterpret_cast<char*>(&this->value),
-                                              MetaPropertyEdgeLink::MAX_VALUE_SIZE)) {
-            metaPropertyEdgeLinkLogger.error("Error while reading property value from block " +
-                                            std::to_string(blockAddress));
-        }
-
-        if (!this->metaEdgePropertiesDB->read(reinterpret_cast<char*>(&(this->nextPropAddress)),
-                                              sizeof(unsigned int))) {
-            metaPropertyEdgeLinkLogger.error("Error while reading property next address from block " +
-                                            std::to_string(blockAddress));
-        }
-
-        this->name = std::string(rawName);
+        const char* rawValue = block + MetaPropertyEdgeLink::MAX_NAME_SIZE;
+        std::memcpy(this->value, rawValue, MetaPropertyEdgeLink::MAX_VALUE_SIZE);
+        unsigned int nextRecord;
+        std::memcpy(&nextRecord, rawValue + MetaPropertyEdgeLink::MAX_VALUE_SIZE, sizeof(nextRecord));
+        this->nextPropAddress = BlockFormat::decode(nextRecord, MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
+        this->name = std::string(block, strnlen(block, MetaPropertyEdgeLink::MAX_NAME_SIZE));
     }
     pthread_mutex_unlock(&lockMetaPropertyEdgeLink);
 };
 
-MetaPropertyEdgeLink::MetaPropertyEdgeLink(unsigned int blockAddress, std::string name,
-                                           char* rvalue, unsigned int nextAddress)
+static bool loadPropertyBlock(unsigned long propertyBlockAddress, char* block) {
+    if (MetaPropertyEdgeLink::metaEdgePropertiesMap) {
+        return MetaPropertyEdgeLink::metaEdgePropertiesMap->read(propertyBlockAddress, block,
+                                                                 MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
+    }
+    MetaPropertyEdgeLink::metaEdgePropertiesDB->seekg(propertyBlockAddress);
+    if (!MetaPropertyEdgeLink::metaEdgePropertiesDB->read(block, MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE)) {
+        MetaPropertyEdgeLink::metaEdgePropertiesDB->clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read a whole property block through the block cache. On a miss it is loaded with a single read, or from the memory
+ * mapped DB when the store runs in mmap mode
+ * */
+bool MetaPropertyEdgeLink::readBlock(unsigned long propertyBlockAddress, char* block) {
+    StorageMetrics::ReadTimer timer(BlockFile::META_EDGE_PROPERTIES, MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
+    return BlockCache::getInstance()->read(
+        BlockFile::META_EDGE_PROPERTIES, propertyBlockAddress, block, MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE,
+        [propertyBlockAddress, &timer](char* buffer) {
+            timer.load(!MetaPropertyEdgeLink::metaEdgePropertiesMap);
+            return loadPropertyBlock(propertyBlockAddress, buffer);
+        });
+}
+
+MetaPropertyEdgeLink::MetaPropertyEdgeLink(unsigned long blockAddress, std::string name,
+                                           char* rvalue, unsigned long nextAddress)
         : blockAddress(blockAddress), nextPropAddress(nextAddress), name(name) {
     memcpy(this->value, rvalue, MetaPropertyEdgeLink::MAX_VALUE_SIZE);
 };
 
-unsigned int MetaPropertyEdgeLink::insert(std::string name, char* value) {
+unsigned long MetaPropertyEdgeLink::insert(std::string name, char* value) {
     char dataName[MetaPropertyEdgeLink::MAX_NAME_SIZE] = {0};
     char dataValue[MetaPropertyEdgeLink::MAX_VALUE_SIZE] = {0};
     std::strcpy(dataName, name.c_str());
@@ -70,9 +88,13 @@ unsigned int MetaPropertyEdgeLink::insert(std::string name, char* value) {
     unsigned int nextAddress = 0;
     if (this->name == name) {
         pthread_mutex_lock(&lockInsertMetaPropertyEdgeLink);
+        StorageMetrics::recordWrite(BlockFile::META_EDGE_PROPERTIES, MetaPropertyEdgeLink::MAX_VALUE_SIZE);
         this->metaEdgePropertiesDB->seekp(this->blockAddress + MetaPropertyEdgeLink::MAX_NAME_SIZE);
         this->metaEdgePropertiesDB->write(reinterpret_cast<char*>(dataValue), MetaPropertyEdgeLink::MAX_VALUE_SIZE);
         this->metaEdgePropertiesDB->flush();
+        BlockCache::getInstance()->update(BlockFile::META_EDGE_PROPERTIES, this->blockAddress,
+                                          MetaPropertyEdgeLink::MAX_NAME_SIZE, dataValue,
+                                          MetaPropertyEdgeLink::MAX_VALUE_SIZE);
         pthread_mutex_unlock(&lockInsertMetaPropertyEdgeLink);
         metaPropertyEdgeLinkLogger.debug("Updating already existing property key = " + std::string(name));
         return this->blockAddress;
@@ -81,8 +103,9 @@ unsigned int MetaPropertyEdgeLink::insert(std::string name, char* value) {
         return pel->insert(name, value);
     } else {  // No next link means end of the link, Now add the new link
         pthread_mutex_lock(&lockInsertMetaPropertyEdgeLink);
-        unsigned int newAddress = MetaPropertyEdgeLink::nextPropertyIndex *
+        unsigned long newAddress = BlockAllocator::current->allocate(BlockFile::META_EDGE_PROPERTIES) *
                 MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE;
+        StorageMetrics::recordWrite(BlockFile::META_EDGE_PROPERTIES, MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
         this->metaEdgePropertiesDB->seekp(newAddress);
         this->metaEdgePropertiesDB->write(dataName, MetaPropertyEdgeLink::MAX_NAME_SIZE);
         this->metaEdgePropertiesDB->write(reinterpret_cast<char*>(dataValue), MetaPropertyEdgeLink::MAX_VALUE_SIZE);
@@ -94,15 +117,20 @@ unsigned int MetaPropertyEdgeLink::insert(std::string name, char* value) {
 
         this->metaEdgePropertiesDB->flush();
         this->nextPropAddress = newAddress;
+        unsigned int nextRecord = BlockFormat::encode(newAddress, MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
+        StorageMetrics::recordWrite(BlockFile::META_EDGE_PROPERTIES, sizeof(nextRecord));
         this->metaEdgePropertiesDB->seekp(this->blockAddress + MetaPropertyEdgeLink::MAX_NAME_SIZE +
                                       MetaPropertyEdgeLink::MAX_VALUE_SIZE);  // seek to current property next address
-        if (!this->metaEdgePropertiesDB->write(reinterpret_cast<char*>(&newAddress), sizeof(newAddress))) {
+        if (!this->metaEdgePropertiesDB->write(reinterpret_cast<char*>(&nextRecord), sizeof(nextRecord))) {
             metaPropertyEdgeLinkLogger.error("Error while updating  property next address for " + name +
                                             " into block address " + std::to_string(this->blockAddress));
             return -1;
         }
+        this->metaEdgePropertiesDB->flush();
+        unsigned long nextAddressOffset = MetaPropertyEdgeLink::MAX_NAME_SIZE + MetaPropertyEdgeLink::MAX_VALUE_SIZE;
+        BlockCache::getInstance()->update(BlockFile::META_EDGE_PROPERTIES, this->blockAddress, nextAddressOffset,
+                                          reinterpret_cast<char*>(&nextRecord), sizeof(nextRecord));
 
-        MetaPropertyEdgeLink::nextPropertyIndex++;  // Increment the shared property index value
         pthread_mutex_unlock(&lockInsertMetaPropertyEdgeLink);
         return this->blockAddress;
     }
@@ -113,7 +141,9 @@ MetaPropertyEdgeLink* MetaPropertyEdgeLink::create(std::string name, char value[
     unsigned int nextAddress = 0;
     char dataName[MetaPropertyEdgeLink::MAX_NAME_SIZE] = {0};
     strcpy(dataName, name.c_str());
-    unsigned int newAddress = MetaPropertyEdgeLink::nextPropertyIndex * MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE;
+    unsigned long newAddress = BlockAllocator::current->allocate(BlockFile::META_EDGE_PROPERTIES) *
+            MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE;
+    StorageMetrics::recordWrite(BlockFile::META_EDGE_PROPERTIES, MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
     MetaPropertyEdgeLink::metaEdgePropertiesDB->seekp(newAddress);
     MetaPropertyEdgeLink::metaEdgePropertiesDB->write(dataName, MetaPropertyEdgeLink::MAX_NAME_SIZE);
     MetaPropertyEdgeLink::metaEdgePropertiesDB->write(reinterpret_cast<char*>(value),
@@ -125,7 +155,6 @@ MetaPropertyEdgeLink* MetaPropertyEdgeLink::create(std::string name, char value[
         return nullptr;
     }
     MetaPropertyEdgeLink::metaEdgePropertiesDB->flush();
-    MetaPropertyEdgeLink::nextPropertyIndex++;  // Increment the shared property index value
     pthread_mutex_unlock(&lockCreateMetaPropertyEdgeLink);
     return new MetaPropertyEdgeLink(newAddress, name, value, nextAddress);
 }
@@ -137,39 +166,23 @@ MetaPropertyEdgeLink* MetaPropertyEdgeLink::next() {
     return nullptr;
 }
 
-MetaPropertyEdgeLink* MetaPropertyEdgeLink::get(unsigned int propertyBlockAddress) {
+MetaPropertyEdgeLink* MetaPropertyEdgeLink::get(unsigned long propertyBlockAddress) {
     MetaPropertyEdgeLink* pl = nullptr;
 
     pthread_mutex_lock(&lockGetMetaPropertyEdgeLink);
     if (propertyBlockAddress > 0) {
-        char propertyName[MetaPropertyEdgeLink::MAX_NAME_SIZE] = {0};
-        char propertyValue[MetaPropertyEdgeLink::MAX_VALUE_SIZE] = {0};
-        unsigned int nextAddress;
-        MetaPropertyEdgeLink::metaEdgePropertiesDB->seekg(propertyBlockAddress);
-
-        if (!MetaPropertyEdgeLink::metaEdgePropertiesDB->read(reinterpret_cast<char*>(&propertyName),
-                                                      MetaPropertyEdgeLink::MAX_NAME_SIZE)) {
-            metaPropertyEdgeLinkLogger.error("Error while reading edge property name from block = " +
-                                            std::to_string(propertyBlockAddress));
+        char block[MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE] = {0};
+        unsigned int nextRecord;
+        if (!MetaPropertyEdgeLink::readBlock(propertyBlockAddress, block)) {
+            metaPropertyEdgeLinkLogger.error("Error while reading edge meta property from block = " +
+                                       std::to_string(propertyBlockAddress));
         }
-        if (!MetaPropertyEdgeLink::metaEdgePropertiesDB->read(reinterpret_cast<char*>(&propertyValue),
-                                                      MetaPropertyEdgeLink::MAX_VALUE_SIZE)) {
-            metaPropertyEdgeLinkLogger.error("Error while reading edge property value from block = " +
-                                            std::to_string(propertyBlockAddress));
-        }
-
-        if (!MetaPropertyEdgeLink::metaEdgePropertiesDB->read(reinterpret_cast<char*>(&(nextAddress)),
-                                                              sizeof(unsigned int))) {
-            metaPropertyEdgeLinkLogger.error("Error while reading edge property next address from block = " +
-                                            std::to_string(propertyBlockAddress));
-        }
-        metaPropertyEdgeLinkLogger.debug("Property head propertyBlockAddress  = " +
-                                        std::to_string(propertyBlockAddress));
-        metaPropertyEdgeLinkLogger.debug("Property head property name  = " + std::string(propertyName));
-        metaPropertyEdgeLinkLogger.debug("Property head nextAddress   = " + std::to_string(nextAddress));
-
-        pl = new MetaPropertyEdgeLink(propertyBlockAddress, std::string(propertyName),
-                                      propertyValue, nextAddress);
+        char* rawValue = block + MetaPropertyEdgeLink::MAX_NAME_SIZE;
+        std::memcpy(&nextRecord, rawValue + MetaPropertyEdgeLink::MAX_VALUE_SIZE, sizeof(nextRecord));
+        std::string propertyName(block, strnlen(block, MetaPropertyEdgeLink::MAX_NAME_SIZE));
+        unsigned long nextAddress =
+            BlockFormat::decode(nextRecord, MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
+        pl = new MetaPropertyEdgeLink(propertyBlockAddress, propertyName, rawValue, nextAddress);
     }
     pthread_mutex_unlock(&lockGetMetaPropertyEdgeLink);
     return pl;
@@ -18,24 +18,27 @@ limitations under the License.
 #include <set>
 #include <string>
 
+#include "MappedFile.h"
+
 class MetaPropertyEdgeLink {
  public:
     static const unsigned long MAX_NAME_SIZE = 12;    // Size of a property name in bytes
     static const unsigned long MAX_VALUE_SIZE = 180;  // Size of a property value in bytes
-    static thread_local unsigned int nextPropertyIndex;            // Next available property block index
     static inline const std::string PARTITION_ID = "pid";
     static const unsigned long META_PROPERTY_BLOCK_SIZE = MAX_NAME_SIZE + MAX_VALUE_SIZE + sizeof(unsigned int);
     std::string name;
     char value[MetaPropertyEdgeLink::MAX_VALUE_SIZE] = {0};
-    unsigned int blockAddress;
-    unsigned int nextPropAddress;
+    unsigned long blockAddress;
+    unsigned long nextPropAddress;
     static std::string DB_PATH;
     static thread_local std::fstream* metaEdgePropertiesDB;
-    MetaPropertyEdgeLink(unsigned int);
-    MetaPropertyEdgeLink(unsigned int, std::string, char*, unsigned int);
-    static MetaPropertyEdgeLink* get(unsigned int);
+    static thread_local MappedFile* metaEdgePropertiesMap;  // Set only in mmap storage mode
+    MetaPropertyEdgeLink(unsigned long);
+    MetaPropertyEdgeLink(unsigned long, std::string, char*, unsigned long);
+    static MetaPropertyEdgeLink* get(unsigned long);
+    static bool readBlock(unsigned long, char*);
     static MetaPropertyEdgeLink* create(std::string, char[]);
-    unsigned int insert(std::string, char[]);
+    unsigned long insert(std::string, char[]);
     MetaPropertyEdgeLink* next();
 };
 
@@ -13,50 +13,71 @@ limitations under the License.
 
 #include "MetaPropertyLink.h"
 #include "../util/logger/Logger.h"
+#include "BlockAllocator.h"
+#include "BlockCache.h"
+#include "BlockFormat.h"
+#include "StorageMetrics.h"
 
 Logger meta_property_link_logger;
-thread_local unsigned int MetaPropertyLink::nextPropertyIndex = 1;
 thread_local std::fstream* MetaPropertyLink::metaPropertiesDB = NULL;
+thread_local MappedFile* MetaPropertyLink::metaPropertiesMap = NULL;
 pthread_mutex_t lockMetaPropertyLink;
 pthread_mutex_t lockCreateMetaPropertyLink;
 pthread_mutex_t lockInsertMetaPropertyLink;
 pthread_mutex_t lockGetMetaPropertyLink;
 
-MetaPropertyLink::MetaPropertyLink(unsigned int propertyBlockAddress) : blockAddress(propertyBlockAddress) {
+MetaPropertyLink::MetaPropertyLink(unsigned long propertyBlockAddress) : blockAddress(propertyBlockAddress) {
     pthread_mutex_lock(&lockMetaPropertyLink);
     if (propertyBlockAddress > 0) {
-        MetaPropertyLink::metaPropertiesDB->seekg(propertyBlockAddress);
-        char rawName[MetaPropertyLink::MAX_NAME_SIZE] = {0};
-
-        if (!this->metaPropertiesDB->read(reinterpret_cast<char*>(&rawName), MetaPropertyLink::MAX_NAME_SIZE)) {
-            meta_property_link_logger.error("Error while reading node property name from block " +
-                                       std::to_string(blockAddress));
-        }
-        meta_property_link_logger.debug(
-                "Current file descriptor curser position = " + std::to_string(this->metaPropertiesDB->tellg()) +
-                " when reading = " + std::to_string(blockAddress));
-        if (!this->metaPropertiesDB->read(reinterpret_cast<char*>(&this->value), MetaPropertyLink::MAX_VALUE_SIZE)) {
-            meta_property_link_logger.error("Error while reading node property value from block " +
-                                       std::to_string(blockAddress));
-        }
-
-        if (!this->metaPropertiesDB->read(reinterpret_cast<char*>(&(this->nextPropAddress)), sizeof(unsigned int))) {
-            meta_property_link_logger.error("Error while reading node property next address from block " +
+        char block[MetaPropertyLink::META_PROPERTY_BLOCK_SIZE] = {0};
+        if (!MetaPropertyLink::readBlock(propertyBlockAddress, block)) {
+            meta_property_link_logger.error("Error while reading node meta property from block " +
                                        std::to_string(blockAddress));
         }
-
-        this->name = std::string(rawName);
+        const char* rawValue = block + MetaPropertyLink::MAX_NAME_SIZE;
+        std::memcpy(this->value, rawValue, MetaPropertyLink::MAX_VALUE_SIZE);
+        unsigned int nextRecord;
+        std::memcpy(&nextRecord, rawValue + MetaPropertyLink::MAX_VALUE_SIZE, sizeof(nextRecord));
+        this->nextPropAddress = BlockFormat::decode(nextRecord, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+        this->name = std::string(block, strnlen(block, MetaPropertyLink::MAX_NAME_SIZE));
     }
     pthread_mutex_unlock(&lockMetaPropertyLink);
 };
 
-MetaPropertyLink::MetaPropertyLink(unsigned int blockAddress, std::string name,
-                                   const char* rvalue, unsigned int nextAddress)
+static bool loadPropertyBlock(unsigned long propertyBlockAddress, char* block) {
+    if (MetaPropertyLink::metaPropertiesMap) {
+        return MetaPropertyLink::metaPropertiesMap->read(propertyBlockAddress, block,
+                                                         MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+    }
+    MetaPropertyLink::metaPropertiesDB->seekg(propertyBlockAddress);
+    if (!MetaPropertyLink::metaPropertiesDB->read(block, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE)) {
+        MetaPropertyLink::metaPropertiesDB->clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read a whole property block through the block cache. On a miss it is loaded with a single read, or from the memory
+ * mapped DB when the store runs in mmap mode
+ * */
+bool MetaPropertyLink::readBlock(unsigned long propertyBlockAddress, char* block) {
+    StorageMetrics::ReadTimer timer(BlockFile::META_PROPERTIES, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+    return BlockCache::getInstance()->read(
+        BlockFile::META_PROPERTIES, propertyBlockAddress, block, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE,
+        [propertyBlockAddress, &timer](char* buffer) {
+            timer.load(!MetaPropertyLink::metaPropertiesMap);
+            return loadPropertyBlock(propertyBlockAddress, buffer);
+        });
+}
+
+MetaPropertyLink::MetaPropertyLink(unsigned long blockAddress, std::string name,
+                                   const char* rvalue, unsigned long nextAddress)
         : blockAddress(blockAddress), nextPropAddress(nextAddress), name(name) {
     memcpy(this->value, rvalue, MetaPropertyLink::MAX_VALUE_SIZE);
 };
 
-unsigned int MetaPropertyLink::insert(std::string name, const char* value) {
+unsigned long MetaPropertyLink::insert(std::string name, const char* value) {
     char dataName[MetaPropertyLink::MAX_NAME_SIZE] = {0};
     char dataValue[MetaPropertyLink::MAX_VALUE_SIZE] = {0};
     std::strcpy(dataName, name.c_str());
@@ -67,9 +88,12 @@ unsigned int MetaPropertyLink::insert(std::string name, const char* value) {
 
     if (this->name == name) {
         pthread_mutex_lock(&lockInsertMetaPropertyLink);
+        StorageMetrics::recordWrite(BlockFile::META_PROPERTIES, MetaPropertyLink::MAX_VALUE_SIZE);
         this->metaPropertiesDB->seekp(this->blockAddress + MetaPropertyLink::MAX_NAME_SIZE);
         this->metaPropertiesDB->write(reinterpret_cast<char*>(dataValue), MetaPropertyLink::MAX_VALUE_SIZE);
         this->metaPropertiesDB->flush();
+        BlockCache::getInstance()->update(BlockFile::META_PROPERTIES, this->blockAddress,
+                                          MetaPropertyLink::MAX_NAME_SIZE, dataValue, MetaPropertyLink::MAX_VALUE_SIZE);
         pthread_mutex_unlock(&lockInsertMetaPropertyLink);
         meta_property_link_logger.debug("Updating already existing property key = " + std::string(name));
         return this->blockAddress;
@@ -77,7 +101,9 @@ unsigned int MetaPropertyLink::insert(std::string name, const char* value) {
         return this->next()->insert(name, value);
     } else {
         pthread_mutex_lock(&lockInsertMetaPropertyLink);
-        unsigned int newAddress = MetaPropertyLink::nextPropertyIndex * MetaPropertyLink::META_PROPERTY_BLOCK_SIZE;
+        unsigned long newAddress = BlockAllocator::current->allocate(BlockFile::META_PROPERTIES) *
+                                  MetaPropertyLink::META_PROPERTY_BLOCK_SIZE;
+        StorageMetrics::recordWrite(BlockFile::META_PROPERTIES, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
         this->metaPropertiesDB->seekp(newAddress);
         this->metaPropertiesDB->write(dataName, MetaPropertyLink::MAX_NAME_SIZE);
         this->metaPropertiesDB->write(reinterpret_cast<char*>(dataValue), MetaPropertyLink::MAX_VALUE_SIZE);
@@ -90,15 +116,20 @@ unsigned int MetaPropertyLink::insert(std::string name, const char* value) {
         this->metaPropertiesDB->flush();
 
         this->nextPropAddress = newAddress;
+        unsigned int nextRecord = BlockFormat::encode(newAddress, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+        StorageMetrics::recordWrite(BlockFile::META_PROPERTIES, sizeof(nextRecord));
         this->metaPropertiesDB->seekp(this->blockAddress + MetaPropertyLink::MAX_NAME_SIZE +
                                   MetaPropertyLink::MAX_VALUE_SIZE);  // seek to current property next address
-        if (!this->metaPropertiesDB->write(reinterpret_cast<char*>(&newAddress), sizeof(newAddress))) {
+        if (!this->metaPropertiesDB->write(reinterpret_cast<char*>(&nextRecord), sizeof(nextRecord))) {
             meta_property_link_logger.error("Error while updating  property next address for " + name +
                                        " into block address " + std::to_string(this->blockAddress));
             return -1;
         }
+        this->metaPropertiesDB->flush();
+        unsigned long nextAddressOffset = MetaPropertyLink::MAX_NAME_SIZE + MetaPropertyLink::MAX_VALUE_SIZE;
+        BlockCache::getInstance()->update(BlockFile::META_PROPERTIES, this->blockAddress, nextAddressOffset,
+                                          reinterpret_cast<char*>(&nextRecord), sizeof(nextRecord));
 
-        MetaPropertyLink::nextPropertyIndex++;  // Increment the shared property index value
         pthread_mutex_unlock(&lockInsertMetaPropertyLink);
         return this->blockAddress;
     }
@@ -109,7 +140,9 @@ MetaPropertyLink* MetaPropertyLink::create(std::string name, const char* value)
     unsigned int nextAddress = 0;
     char dataName[MetaPropertyLink::MAX_NAME_SIZE] = {0};
     strcpy(dataName, name.c_str());
-    unsigned int newAddress = MetaPropertyLink::nextPropertyIndex * MetaPropertyLink::META_PROPERTY_BLOCK_SIZE;
+    unsigned long newAddress =
+            BlockAllocator::current->allocate(BlockFile::META_PROPERTIES) * MetaPropertyLink::META_PROPERTY_BLOCK_SIZE;
+    StorageMetrics::recordWrite(BlockFile::META_PROPERTIES, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
     MetaPropertyLink::metaPropertiesDB->seekp(newAddress);
     MetaPropertyLink::metaPropertiesDB->write(dataName, MetaPropertyLink::MAX_NAME_SIZE);
     MetaPropertyLink::metaPropertiesDB->write(reinterpret_cast<const char*>(value), MetaPropertyLink::MAX_VALUE_SIZE);
@@ -119,7 +152,6 @@ MetaPropertyLink* MetaPropertyLink::create(std::string name, const char* value)
         return NULL;
     }
     MetaPropertyLink::metaPropertiesDB->flush();
-    MetaPropertyLink::nextPropertyIndex++;  // Increment the shared property index value
     pthread_mutex_unlock(&lockCreateMetaPropertyLink);
     return new MetaPropertyLink(newAddress, name, value, nextAddress);
 }
@@ -131,36 +163,22 @@ MetaPropertyLink* MetaPropertyLink::next() {
     return nullptr;
 }
 
-MetaPropertyLink* MetaPropertyLink::get(unsigned int propertyBlockAddress) {
+MetaPropertyLink* MetaPropertyLink::get(unsigned long propertyBlockAddress) {
     MetaPropertyLink* pl = nullptr;
 
     pthread_mutex_lock(&lockGetMetaPropertyLink);
     if (propertyBlockAddress > 0) {
-        char propertyName[MetaPropertyLink::MAX_NAME_SIZE] = {0};
-        char propertyValue[MetaPropertyLink::MAX_VALUE_SIZE] = {0};
-        unsigned int nextAddress;
-        MetaPropertyLink::metaPropertiesDB->seekg(propertyBlockAddress);
-
-
-        if (!MetaPropertyLink::metaPropertiesDB->read(reinterpret_cast<char*>(&propertyName),
-                                                      MetaPropertyLink::MAX_NAME_SIZE)) {
-            meta_property_link_logger.error("Error while reading node property name from block = " +
+        char block[MetaPropertyLink::META_PROPERTY_BLOCK_SIZE] = {0};
+        unsigned int nextRecord;
+        if (!MetaPropertyLink::readBlock(propertyBlockAddress, block)) {
+            meta_property_link_logger.error("Error while reading node meta property from block = " +
                                        std::to_string(propertyBlockAddress));
         }
-        if (!MetaPropertyLink::metaPropertiesDB->read(reinterpret_cast<char*>(&propertyValue),
-                                                      MetaPropertyLink::MAX_VALUE_SIZE)) {
-            meta_property_link_logger.error("Error while reading node property value from block = " +
-                                       std::to_string(propertyBlockAddress));
-        }
-
-        if (!MetaPropertyLink::metaPropertiesDB->read(reinterpret_cast<char*>(&(nextAddress)),
-                                                      sizeof(unsigned int))) {
-            meta_property_link_logger.error("Error while reading node property next address from block = " +
-                                       std::to_string(propertyBlockAddress));
-        }
-
-        pl = new MetaPropertyLink(propertyBlockAddress, std::string(propertyName),
-                                  propertyValue, nextAddress);
+        char* rawValue = block + MetaPropertyLink::MAX_NAME_SIZE;
+        std::memcpy(&nextRecord, rawValue + MetaPropertyLink::MAX_VALUE_SIZE, sizeof(nextRecord));
+        std::string propertyName(block, strnlen(block, MetaPropertyLink::MAX_NAME_SIZE));
+        unsigned long nextAddress = BlockFormat::decode(nextRecord, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+        pl = new MetaPropertyLink(propertyBlockAddress, propertyName, rawValue, nextAddress);
     }
     pthread_mutex_unlock(&lockGetMetaPropertyLink);
     return pl;
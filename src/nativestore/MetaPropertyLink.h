@@ -18,28 +18,31 @@ limitations under the License.
 #include <set>
 #include <string>
 
+#include "MappedFile.h"
+
 class MetaPropertyLink {
  public:
     static const unsigned long MAX_NAME_SIZE = 12;    // Size of a property name in bytes
     static const unsigned long MAX_VALUE_SIZE = 180;  // Size of a property value in bytes
     static inline const std::string PARTITION_ID = "pid";
-    static thread_local unsigned int nextPropertyIndex;            // Next available property block index
     static const unsigned long META_PROPERTY_BLOCK_SIZE = MAX_NAME_SIZE + MAX_VALUE_SIZE + sizeof(unsigned int);
 
     std::string name;
     char value[MetaPropertyLink::MAX_VALUE_SIZE] = {0};
-    unsigned int blockAddress;
-    unsigned int nextPropAddress;
+    unsigned long blockAddress;
+    unsigned long nextPropAddress;
 
     static thread_local std::string DB_PATH;
     static thread_local std::fstream* metaPropertiesDB;
+    static thread_local MappedFile* metaPropertiesMap;  // Set only in mmap storage mode
 
-    MetaPropertyLink(unsigned int);
-    MetaPropertyLink(unsigned int, std::string, const char*, unsigned int);
-    static MetaPropertyLink* get(unsigned int);
+    MetaPropertyLink(unsigned long);
+    MetaPropertyLink(unsigned long, std::string, const char*, unsigned long);
+    static MetaPropertyLink* get(unsigned long);
+    static bool readBlock(unsigned long, char*);
     static MetaPropertyLink* create(std::string, const char*);
 
-    unsigned int insert(std::string, const char*);
+    unsigned long insert(std::string, const char*);
     MetaPropertyLink* next();
 };
 
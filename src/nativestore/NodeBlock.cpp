@@ -13,19 +13,26 @@ limitations under the License.
 
 #include "NodeBlock.h"
 
+#include <cstring>
 #include <sstream>
 #include <vector>
 
 #include "../util/logger/Logger.h"
+#include "BlockCache.h"
+#include "BlockFormat.h"
+#include "IncomingRelationHeads.h"
+#include "LabelIndex.h"
 #include "RelationBlock.h"
+#include "RelationCursor.h"
 #include "MetaPropertyLink.h"
+#include "StorageMetrics.h"
 
 Logger node_block_logger;
 pthread_mutex_t lockSaveNode;
 pthread_mutex_t lockAddNodeProperty;
 
-NodeBlock::NodeBlock(std::string id, unsigned int nodeId, unsigned int address, unsigned int propRef,
-                     unsigned int metaPropRef, unsigned int edgeRef, unsigned int centralEdgeRef,
+NodeBlock::NodeBlock(std::string id, unsigned int nodeId, unsigned long address, unsigned long propRef,
+                     unsigned long metaPropRef, unsigned long edgeRef, unsigned long centralEdgeRef,
                      unsigned char edgeRefPID, const char* _label, bool usage)
     : id(id),
       nodeId(nodeId),
@@ -36,7 +43,7 @@ NodeBlock::NodeBlock(std::string id, unsigned int nodeId, unsigned int address,
       centralEdgeRef(centralEdgeRef),
       edgeRefPID(edgeRefPID),
       usage(usage) {
-    strcpy(this->label, _label);
+    strncpy(this->label, _label, NodeBlock::LABEL_SIZE);
 };
 
 bool NodeBlock::isInUse() { return this->usage == '\1'; }
@@ -50,11 +57,15 @@ void NodeBlock::setLabel(const char *_label) {
 void NodeBlock::addLabel(char *label) {
     if (this->label == this->id && strlen(label) != 0) {
         std::strcpy(this->label, label);
-        NodeBlock::nodesDB->seekp(this->addr + sizeof(this->usage) + sizeof(this->nodeId) + sizeof(this->edgeRef) +
-                                  sizeof(this->centralEdgeRef) + sizeof(this->edgeRefPID) + sizeof(this->propRef) +
-                                  sizeof(this->metaPropRef));
+        unsigned long labelOffset = NodeBlock::LABEL_OFFSET;
+        StorageMetrics::recordWrite(BlockFile::NODES, sizeof(this->label));
+        NodeBlock::nodesDB->seekp(this->addr + labelOffset);
         NodeBlock::nodesDB->write(this->label, sizeof(this->label));
         NodeBlock::nodesDB->flush();
+        BlockCache::getInstance()->update(BlockFile::NODES, this->addr, labelOffset, this->label, sizeof(this->label));
+        if (LabelIndex::current) {
+            LabelIndex::current->add(label, this->addr / NodeBlock::BLOCK_SIZE);
+        }
     }
 }
 
@@ -67,15 +78,24 @@ void NodeBlock::save() {
         if (isSmallLabel) {
             std::strcpy(this->label, this->id.c_str());
         }
+    // Block addresses are written as the 4 byte reference records of the partition's BlockFormat
+    unsigned int edgeRecord = BlockFormat::encode(this->edgeRef, RelationBlock::BLOCK_SIZE);
+    unsigned int centralEdgeRecord = BlockFormat::encode(this->centralEdgeRef, RelationBlock::CENTRAL_BLOCK_SIZE);
+    unsigned int propRecord = BlockFormat::encode(this->propRef, PropertyLink::PROPERTY_BLOCK_SIZE);
+    unsigned int metaPropRecord = BlockFormat::encode(this->metaPropRef, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+    // The block is written with one write, so that readers in other threads never see a part of it
+    char block[NodeBlock::BLOCK_SIZE];
+    block[0] = this->usage;
+    std::memcpy(block + 1, &(this->nodeId), sizeof(this->nodeId));
+    std::memcpy(block + NodeBlock::EDGE_REF_OFFSET, &edgeRecord, sizeof(edgeRecord));
+    std::memcpy(block + NodeBlock::CENTRAL_EDGE_REF_OFFSET, &centralEdgeRecord, sizeof(centralEdgeRecord));
+    block[NodeBlock::EDGE_REF_PID_OFFSET] = this->edgeRefPID;
+    std::memcpy(block + NodeBlock::PROP_REF_OFFSET, &propRecord, sizeof(propRecord));
+    std::memcpy(block + NodeBlock::META_PROP_REF_OFFSET, &metaPropRecord, sizeof(metaPropRecord));
+    std::memcpy(block + NodeBlock::LABEL_OFFSET, this->label, sizeof(this->label));
+    StorageMetrics::recordWrite(BlockFile::NODES, NodeBlock::BLOCK_SIZE);
     NodeBlock::nodesDB->seekp(this->addr);
-    NodeBlock::nodesDB->put(this->usage);                                                                       // 1
-    NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(this->nodeId)), sizeof(this->nodeId));                  // 4
-    NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(this->edgeRef)), sizeof(this->edgeRef));                // 4
-    NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(this->centralEdgeRef)), sizeof(this->centralEdgeRef));  // 4
-    NodeBlock::nodesDB->put(this->edgeRefPID);                                                                  // 1
-    NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(this->propRef)), sizeof(this->propRef));                // 4
-    NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(this->metaPropRef)), sizeof(this->metaPropRef));        // 4
-    NodeBlock::nodesDB->write(this->label, sizeof(this->label));                                                // 18
+    NodeBlock::nodesDB->write(block, NodeBlock::BLOCK_SIZE);
     NodeBlock::nodesDB->flush();  // Sync the file with in-memory stream
     //    pthread_mutex_unlock(&lockSaveNode);
 
@@ -85,6 +105,12 @@ void NodeBlock::save() {
 }
 
 void NodeBlock::addProperty(std::string name, const char* value) {
+    if (PropertyStore::current) {
+        std::string text(value, strnlen(value, PropertyLink::MAX_VALUE_SIZE));
+        PropertyStore::current->set(PropertyOwner::NODE, this->addr / NodeBlock::BLOCK_SIZE, name,
+                                    PropertyValue::ofString(text));
+        return;
+    }
     if (this->propRef == 0) {
         PropertyLink* newLink = PropertyLink::create(name, value);
         //        pthread_mutex_lock(&lockAddNodeProperty);
@@ -93,10 +119,13 @@ void NodeBlock::addProperty(std::string name, const char* value) {
             // If it was an empty prop link before inserting, Then update the property reference of this node
             // block
             //            node_block_logger.info("propRef = " + std::to_string(this->propRef));
-            NodeBlock::nodesDB->seekp(this->addr +sizeof(this->usage) +sizeof(this->nodeId) + sizeof(this->edgeRef) +
-                                      sizeof(this->centralEdgeRef) + sizeof(this->edgeRefPID));
-            NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(this->propRef)), sizeof(this->propRef));
+            unsigned int propRecord = BlockFormat::encode(this->propRef, PropertyLink::PROPERTY_BLOCK_SIZE);
+            StorageMetrics::recordWrite(BlockFile::NODES, sizeof(propRecord));
+            NodeBlock::nodesDB->seekp(this->addr + NodeBlock::PROP_REF_OFFSET);
+            NodeBlock::nodesDB->write(reinterpret_cast<char*>(&propRecord), sizeof(propRecord));
             NodeBlock::nodesDB->flush();
+            BlockCache::getInstance()->update(BlockFile::NODES, this->addr, NodeBlock::PROP_REF_OFFSET,
+                                              reinterpret_cast<char*>(&propRecord), sizeof(propRecord));
         } else {
             node_block_logger.error("Error occurred while adding a new property link to " +
                         std::to_string(this->addr) + " node block");
@@ -106,6 +135,20 @@ void NodeBlock::addProperty(std::string name, const char* value) {
     }
 }
 
+/**
+ * Add a typed property. Property blocks of the linked format only hold text, there the value is stored as its text
+ * form truncated to PropertyLink::MAX_VALUE_SIZE.
+ * */
+void NodeBlock::addProperty(std::string name, const PropertyValue& value) {
+    if (PropertyStore::current) {
+        PropertyStore::current->set(PropertyOwner::NODE, this->addr / NodeBlock::BLOCK_SIZE, name, value);
+        return;
+    }
+    char text[PropertyLink::MAX_VALUE_SIZE] = {0};
+    std::strncpy(text, value.toString().c_str(), PropertyLink::MAX_VALUE_SIZE - 1);
+    this->addProperty(name, text);
+}
+
 void NodeBlock::addMetaProperty(std::string name, const char* value) {
     if (this->metaPropRef == 0) {
         MetaPropertyLink* newLink = MetaPropertyLink::create(name, value);
@@ -113,10 +156,14 @@ void NodeBlock::addMetaProperty(std::string name, const char* value) {
         if (newLink) {
             this->metaPropRef = newLink->blockAddress;
 
-            NodeBlock::nodesDB->seekp(this->addr +sizeof(this->usage) +sizeof(this->nodeId) + sizeof(this->edgeRef) +
-                                      sizeof(this->centralEdgeRef) + sizeof(this->edgeRefPID)+ sizeof(this->propRef));
-            NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(this->metaPropRef)), sizeof(this->metaPropRef));
+            unsigned int metaPropRecord =
+                BlockFormat::encode(this->metaPropRef, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+            StorageMetrics::recordWrite(BlockFile::NODES, sizeof(metaPropRecord));
+            NodeBlock::nodesDB->seekp(this->addr + NodeBlock::META_PROP_REF_OFFSET);
+            NodeBlock::nodesDB->write(reinterpret_cast<char*>(&metaPropRecord), sizeof(metaPropRecord));
             NodeBlock::nodesDB->flush();
+            BlockCache::getInstance()->update(BlockFile::NODES, this->addr, NodeBlock::META_PROP_REF_OFFSET,
+                                              reinterpret_cast<char*>(&metaPropRecord), sizeof(metaPropRecord));
         } else {
             node_block_logger.error("Error occurred while adding a new property link to " +
                                     std::to_string(this->addr) + " node block");
@@ -126,102 +173,92 @@ void NodeBlock::addMetaProperty(std::string name, const char* value) {
     }
 }
 
+/**
+ * Link the relation into the chains of this node: into the outgoing chain if the node is its source and into the
+ * incoming chain if the node is its destination, a self loop goes into both. The relation becomes the head of a chain,
+ * or its tail if relocateHead is not set.
+ * */
 bool NodeBlock::updateLocalRelation(RelationBlock* newRelation, bool relocateHead) {
-    unsigned int edgeReferenceAddress = newRelation->addr;
-    unsigned int thisAddress = this->addr;
-    RelationBlock* currentHead = this->getLocalRelationHead();
-    if (relocateHead) {  // Insert new relation link to the head of the link list
-        if (currentHead) {
-            if (thisAddress == currentHead->source.address) {
-                currentHead->setLocalPreviousSource(newRelation->addr);
-            } else if (thisAddress == currentHead->destination.address) {
-                currentHead->setLocalPreviousDestination(newRelation->addr);
-            } else {
-                node_block_logger.error(std::to_string(thisAddress) +
-                    " relation head does not contain current node in its source or destination");
-            }
-            if (thisAddress == newRelation->source.address) {
-                newRelation->setLocalNextSource(currentHead->addr);
-            } else if (thisAddress == newRelation->destination.address) {
-                newRelation->setLocalNextDestination(currentHead->addr);
-            } else {
-                node_block_logger.error(std::to_string(thisAddress) +
-                    " new relation does not contain current node in its source or destination");
-            }
-        }
-        return this->setLocalRelationHead(*newRelation);
-    }
-    RelationBlock* currentRelation = currentHead;
-    if (currentHead == NULL) {
-        return this->setLocalRelationHead(*newRelation);
-    }
-    while (currentRelation != nullptr) {
-        if (currentRelation->source.address == this->addr) {
-            if (currentRelation->source.nextRelationId == 0) {
-                return currentRelation->setLocalNextSource(edgeReferenceAddress);
-            }
-            currentRelation = currentRelation->nextLocalSource();
-        } else if (!this->isDirected && currentRelation->destination.address == this->addr) {
-            if (currentRelation->destination.nextRelationId == 0) {
-                return currentRelation->setLocalNextDestination(edgeReferenceAddress);
-            }
-            currentRelation = currentRelation->nextLocalDestination();
-        } else {
-            node_block_logger.warn("Invalid relation block" + std::to_string(currentRelation->addr));
-        }
+    bool linked = true;
+    if (newRelation->source.address == this->addr) {
+        linked = this->linkRelation(newRelation, false, true, relocateHead);
     }
-    return false;
+    if (newRelation->destination.address == this->addr) {
+        linked = this->linkRelation(newRelation, false, false, relocateHead) && linked;
+    }
+    return linked;
 }
 
 bool NodeBlock::updateCentralRelation(RelationBlock* newRelation, bool relocateHead) {
-    unsigned int edgeReferenceAddress = newRelation->addr;
-    unsigned int thisAddress = this->addr;
-    RelationBlock* currentHead = this->getCentralRelationHead();
-    if (relocateHead) {  // Insert new relation link to the head of the link list
-        if (currentHead) {
-            if (thisAddress == currentHead->source.address) {
-                currentHead->setCentralPreviousSource(newRelation->addr);
-            } else if (thisAddress == currentHead->destination.address) {
-                currentHead->setCentralPreviousDestination(newRelation->addr);
-            } else {
-                node_block_logger.error(std::to_string(thisAddress) +
-                    " relation head does not contain current node in its source or destination");
-            }
-            if (thisAddress == newRelation->source.address) {
-                newRelation->setCentralNextSource(currentHead->addr);
-            } else if (thisAddress == newRelation->destination.address) {
-                newRelation->setCentralNextDestination(currentHead->addr);
-            } else {
-                node_block_logger.error(std::to_string(thisAddress) +
-                    " new relation does not contain current node in its source or destination");
-            }
+    bool linked = true;
+    if (newRelation->source.address == this->addr) {
+        linked = this->linkRelation(newRelation, true, true, relocateHead);
+    }
+    if (newRelation->destination.address == this->addr) {
+        linked = this->linkRelation(newRelation, true, false, relocateHead) && linked;
+    }
+    return linked;
+}
+
+/**
+ * Insert the relation into the outgoing chain of the node, threaded through the source records of its relations, or
+ * into the incoming chain, threaded through their destination records
+ * */
+bool NodeBlock::linkRelation(RelationBlock* relation, bool central, bool outgoing, bool relocateHead) {
+    auto setNext = [central, outgoing](RelationBlock* block, unsigned long address) {
+        if (central) {
+            return outgoing ? block->setCentralNextSource(address) : block->setCentralNextDestination(address);
         }
-        return this->setCentralRelationHead(*newRelation);
-    } else {
-        RelationBlock* currentRelation = currentHead;
-        if (currentHead == NULL) {
-            node_block_logger.info("Setting the Head for edge reference.");
-            return this->setCentralRelationHead(*newRelation);
-        }  // Last Stopped
-        while (currentRelation != NULL) {
-            if (currentRelation->source.address == this->addr) {
-                if (currentRelation->source.nextRelationId == 0) {
-                    return currentRelation->setCentralNextSource(edgeReferenceAddress);
-                } else {
-                    currentRelation = currentRelation->nextCentralSource();
-                }
-            } else if (!this->isDirected && currentRelation->destination.address == this->addr) {
-                if (currentRelation->destination.nextRelationId == 0) {
-                    return currentRelation->setCentralNextDestination(edgeReferenceAddress);
-                } else {
-                    currentRelation = currentRelation->nextCentralDestination();
-                }
-            } else {
-                node_block_logger.warn("Invalid relation block : " + std::to_string(currentRelation->addr));
-            }
+        return outgoing ? block->setLocalNextSource(address) : block->setLocalNextDestination(address);
+    };
+    auto setPrevious = [central, outgoing](RelationBlock* block, unsigned long address) {
+        if (central) {
+            return outgoing ? block->setCentralPreviousSource(address)
+                            : block->setCentralPreviousDestination(address);
         }
+        return outgoing ? block->setLocalPreviousSource(address) : block->setLocalPreviousDestination(address);
+    };
+    unsigned long head;
+    if (outgoing) {
+        head = central ? this->centralEdgeRef : this->edgeRef;
+    } else if (IncomingRelationHeads::current) {
+        head = IncomingRelationHeads::current->get(this->addr / NodeBlock::BLOCK_SIZE, central);
+    } else {
+        node_block_logger.error("No incoming relation heads attached to link relation " +
+                                std::to_string(relation->addr));
         return false;
     }
+
+    if (head != 0 && !relocateHead) {
+        unsigned long tail = 0;
+        RelationCursor cursor(this->addr, head, central, outgoing);
+        RelationView current;
+        while (cursor.next(current)) {
+            tail = current.addr;
+        }
+        RelationBlock* last = central ? RelationBlock::getCentralRelation(tail) : RelationBlock::getLocalRelation(tail);
+        if (!last) {
+            node_block_logger.error("Error while reading the last relation of node " + std::to_string(this->addr));
+            return false;
+        }
+        setNext(last, relation->addr);
+        setPrevious(relation, last->addr);
+        delete last;
+        return true;
+    }
+    if (head != 0) {
+        RelationBlock* currentHead =
+            central ? RelationBlock::getCentralRelation(head) : RelationBlock::getLocalRelation(head);
+        if (currentHead) {
+            setPrevious(currentHead, relation->addr);
+            delete currentHead;
+        }
+        setNext(relation, head);
+    }
+    if (outgoing) {
+        return central ? this->setCentralRelationHead(relation->addr) : this->setLocalRelationHead(relation->addr);
+    }
+    return IncomingRelationHeads::current->set(this->addr / NodeBlock::BLOCK_SIZE, central, relation->addr);
 }
 
 RelationBlock* NodeBlock::getLocalRelationHead() {
@@ -240,31 +277,52 @@ RelationBlock* NodeBlock::getCentralRelationHead() {
     return relationsHead;
 };
 
-bool NodeBlock::setLocalRelationHead(RelationBlock newRelation) {
-    unsigned int edgeReferenceAddress = newRelation.addr;
-    int edgeReferenceOffset = sizeof(this->usage) + sizeof(this->nodeId);
-    NodeBlock::nodesDB->seekp(this->addr + edgeReferenceOffset);
-    if (!NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(edgeReferenceAddress)), sizeof(unsigned int))) {
-        node_block_logger.error("ERROR: Error while updating edge reference address of " +
-                                std::to_string(edgeReferenceAddress) + " for node " + std::to_string(this->addr));
-        return false;
+bool NodeBlock::setLocalRelationHead(RelationBlock newRelation) { return this->setLocalRelationHead(newRelation.addr); }
+
+bool NodeBlock::setLocalRelationHead(unsigned long edgeReferenceAddress) {
+    int edgeReferenceOffset = NodeBlock::EDGE_REF_OFFSET;
+    unsigned int record = BlockFormat::encode(edgeReferenceAddress, RelationBlock::BLOCK_SIZE);
+    char* data = reinterpret_cast<char*>(&record);
+    // Relation heads change on every edge insert, so a resident node block only gets updated in the block cache
+    if (!BlockCache::getInstance()->writeBack(BlockFile::NODES, this->addr, edgeReferenceOffset, data,
+                                              sizeof(unsigned int))) {
+        StorageMetrics::recordWrite(BlockFile::NODES, sizeof(unsigned int));
+        NodeBlock::nodesDB->seekp(this->addr + edgeReferenceOffset);
+        if (!NodeBlock::nodesDB->write(data, sizeof(unsigned int))) {
+            node_block_logger.error("ERROR: Error while updating edge reference address of " +
+                                    std::to_string(edgeReferenceAddress) + " for node " + std::to_string(this->addr));
+            return false;
+        }
+        NodeBlock::nodesDB->flush();  // Sync the file with in-memory stream
+        BlockCache::getInstance()->update(BlockFile::NODES, this->addr, edgeReferenceOffset, data,
+                                          sizeof(unsigned int));
     }
-    NodeBlock::nodesDB->flush();  // Sync the file with in-memory stream
     this->edgeRef = edgeReferenceAddress;
     return true;
 }
 
 bool NodeBlock::setCentralRelationHead(RelationBlock newRelation) {
-    unsigned int centralEdgeReferenceAddress = newRelation.addr;
-    int edgeReferenceOffset = sizeof(this->usage) + sizeof(this->nodeId);
-    NodeBlock::nodesDB->seekp(this->addr + edgeReferenceOffset + sizeof(this->edgeRef));
-    if (!NodeBlock::nodesDB->write(reinterpret_cast<char*>(&(centralEdgeReferenceAddress)), sizeof(unsigned int))) {
-        node_block_logger.error("ERROR: Error while updating edge reference address of " +
-                                std::to_string(centralEdgeReferenceAddress) + " for node " +
-                                std::to_string(this->addr));
-        return false;
+    return this->setCentralRelationHead(newRelation.addr);
+}
+
+bool NodeBlock::setCentralRelationHead(unsigned long centralEdgeReferenceAddress) {
+    int edgeReferenceOffset = NodeBlock::CENTRAL_EDGE_REF_OFFSET;
+    unsigned int record = BlockFormat::encode(centralEdgeReferenceAddress, RelationBlock::CENTRAL_BLOCK_SIZE);
+    char* data = reinterpret_cast<char*>(&record);
+    if (!BlockCache::getInstance()->writeBack(BlockFile::NODES, this->addr, edgeReferenceOffset, data,
+                                              sizeof(unsigned int))) {
+        StorageMetrics::recordWrite(BlockFile::NODES, sizeof(unsigned int));
+        NodeBlock::nodesDB->seekp(this->addr + edgeReferenceOffset);
+        if (!NodeBlock::nodesDB->write(data, sizeof(unsigned int))) {
+            node_block_logger.error("ERROR: Error while updating edge reference address of " +
+                                    std::to_string(centralEdgeReferenceAddress) + " for node " +
+                                    std::to_string(this->addr));
+            return false;
+        }
+        NodeBlock::nodesDB->flush();  // Sync the file with in-memory stream
+        BlockCache::getInstance()->update(BlockFile::NODES, this->addr, edgeReferenceOffset, data,
+                                          sizeof(unsigned int));
     }
-    NodeBlock::nodesDB->flush();  // Sync the file with in-memory stream
     this->centralEdgeRef = centralEdgeReferenceAddress;
     return true;
 }
@@ -273,57 +331,27 @@ bool NodeBlock::setCentralRelationHead(RelationBlock newRelation) {
  * Return a pointer to matching relation block with the given node if found, Else return NULL
  * **/
 RelationBlock* NodeBlock::searchLocalRelation(NodeBlock withNode) {
-    RelationBlock* found = NULL;
-    RelationBlock* currentRelation = this->getLocalRelationHead();
-    while (currentRelation) {
-        if (currentRelation->source.address == this->addr) {
-            if (currentRelation->destination.address == withNode.addr) {
-                found = currentRelation;
-                break;
-            } else {
-                currentRelation = currentRelation->nextLocalSource();
-            }
-        } else if (!this->isDirected && (currentRelation->destination.address == this->addr)) {
-            if (currentRelation->source.address == withNode.addr) {
-                found = currentRelation;
-                break;
-            } else {
-                currentRelation = currentRelation->nextLocalDestination();
-            }
-        } else {
-            node_block_logger.error("Exception: Unrelated relation block for " + std::to_string(this->addr) +
-                " found in relation block " + std::to_string(currentRelation->addr));
+    RelationCursor cursor(this->addr, false,
+                          this->isDirected ? RelationDirection::OUTGOING : RelationDirection::BOTH);
+    RelationView relation;
+    while (cursor.next(relation)) {
+        if (relation.neighborAddress() == withNode.addr) {
+            return RelationBlock::getLocalRelation(relation.addr);
         }
     }
-
-    return found;
+    return NULL;
 }
 
 RelationBlock* NodeBlock::searchCentralRelation(NodeBlock withNode) {
-    RelationBlock* found = NULL;
-    RelationBlock* currentRelation = this->getCentralRelationHead();
-    while (currentRelation) {
-        if (currentRelation->source.address == this->addr) {
-            if (currentRelation->destination.address == withNode.addr) {
-                found = currentRelation;
-                break;
-            } else {
-                currentRelation = currentRelation->nextCentralSource();
-            }
-        } else if (!this->isDirected && (currentRelation->destination.address == this->addr)) {
-            if (currentRelation->source.address == withNode.addr) {
-                found = currentRelation;
-                break;
-            } else {
-                currentRelation = currentRelation->nextCentralDestination();
-            }
-        } else {
-            node_block_logger.error("Exception: Unrelated relation block for " + std::to_string(this->addr) +
-                " found in relation block " + std::to_string(currentRelation->addr));
+    RelationCursor cursor(this->addr, true,
+                          this->isDirected ? RelationDirection::OUTGOING : RelationDirection::BOTH);
+    RelationView relation;
+    while (cursor.next(relation)) {
+        if (relation.neighborAddress() == withNode.addr) {
+            return RelationBlock::getCentralRelation(relation.addr);
         }
     }
-
-    return found;
+    return NULL;
 }
 
 bool NodeBlock::searchRelation(NodeBlock withNode) {
@@ -338,20 +366,10 @@ bool NodeBlock::searchRelation(NodeBlock withNode) {
 
 std::list<NodeBlock*> NodeBlock::getLocalEdgeNodes() {
     std::list<NodeBlock*> edges;
-    RelationBlock* currentRelation = this->getLocalRelationHead();
-    while (currentRelation != nullptr) {
-        NodeBlock* node = NULL;
-        if (currentRelation->source.address == this->addr) {
-            node = NodeBlock::get(currentRelation->destination.address);
-            currentRelation = currentRelation->nextLocalSource();
-        } else if (currentRelation->destination.address == this->addr) {
-            node = NodeBlock::get(currentRelation->source.address);
-            currentRelation = currentRelation->nextLocalDestination();
-        } else {
-            node_block_logger.error("Error: Unrecognized relation for " + std::to_string(this->addr) +
-                                    " in relation block " + std::to_string(currentRelation->addr));
-            break;
-        }
+    RelationCursor cursor(this->addr, false);
+    RelationView relation;
+    while (cursor.next(relation)) {
+        NodeBlock* node = NodeBlock::get(relation.neighborAddress());
         if (!node) {
             node_block_logger.error("Error creating node in the relation");
             break;
@@ -363,22 +381,13 @@ std::list<NodeBlock*> NodeBlock::getLocalEdgeNodes() {
 
 std::list<NodeBlock*> NodeBlock::getCentralEdgeNodes() {
     std::list<NodeBlock*> edges;
-    RelationBlock* currentRelation = this->getCentralRelationHead();
-    while (currentRelation != NULL) {
-        NodeBlock* node = NULL;
-        if (currentRelation->source.address == this->addr) {
-            node = NodeBlock::get(currentRelation->destination.address);
-            currentRelation = currentRelation->nextCentralSource();
-        } else if (currentRelation->destination.address == this->addr) {
-            node = NodeBlock::get(currentRelation->source.address);
-            currentRelation = currentRelation->nextCentralDestination();
-        } else {
-            node_block_logger.error("Error: Unrecognized central relation for " +
-                                    std::to_string(this->addr) + " in relation block " +
-                                    std::to_string(currentRelation->addr));
-        }
+    RelationCursor cursor(this->addr, true);
+    RelationView relation;
+    while (cursor.next(relation)) {
+        NodeBlock* node = NodeBlock::get(relation.neighborAddress());
         if (!node) {
             node_block_logger.error("Error creating node in the central relation");
+            break;
         }
         edges.push_back(node);
     }
@@ -395,8 +404,41 @@ std::list<NodeBlock*> NodeBlock::getAllEdgeNodes() {
     return allEdges;
 }
 
+/**
+ * Read a single property, without reading the other properties of the node when the column store is used
+ * */
+bool NodeBlock::getProperty(const std::string& name, PropertyValue& value) {
+    if (PropertyStore::current) {
+        return PropertyStore::current->get(PropertyOwner::NODE, this->addr / NodeBlock::BLOCK_SIZE, name, value);
+    }
+    PropertyLink* current = this->getPropertyHead();
+    while (current) {
+        if (current->name == name) {
+            value = PropertyValue::ofString(std::string(current->value,
+                                                        strnlen(current->value, PropertyLink::MAX_VALUE_SIZE)));
+            delete current;
+            return true;
+        }
+        PropertyLink* temp = current->next();
+        delete current;
+        current = temp;
+    }
+    return false;
+}
+
 std::map<std::string, char*> NodeBlock::getAllProperties() {
     std::map<std::string, char*> allProperties;
+    if (PropertyStore::current) {
+        for (auto& property :
+             PropertyStore::current->getAll(PropertyOwner::NODE, this->addr / NodeBlock::BLOCK_SIZE)) {
+            // don't forget to free the allocated memory after using this method
+            std::string text = property.second.toString();
+            char* copiedValue = new char[text.length() + 1];
+            std::memcpy(copiedValue, text.c_str(), text.length() + 1);
+            allProperties.insert({property.first, copiedValue});
+        }
+        return allProperties;
+    }
     PropertyLink* current = this->getPropertyHead();
     while (current) {
         // don't forget to free the allocated memory after using this method
@@ -411,61 +453,68 @@ std::map<std::string, char*> NodeBlock::getAllProperties() {
     return allProperties;
 }
 
-NodeBlock* NodeBlock::get(unsigned int blockAddress) {
-    NodeBlock* nodeBlockPointer = NULL;
-    NodeBlock::nodesDB->seekg(blockAddress);
-    unsigned int nodeId;
-    unsigned int edgeRef;
-    unsigned int centralEdgeRef;
-    unsigned char edgeRefPID;
-    unsigned int propRef;
-    unsigned int metaPropRef;
-    char usageBlock;
-    char label[NodeBlock::LABEL_SIZE];
-    std::string id;
-
-    if (!NodeBlock::nodesDB->get(usageBlock)) {
-        node_block_logger.error("Error while reading usage data from block " + std::to_string(blockAddress));
-    }
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char*>(&nodeId), sizeof(unsigned int))) {
-        node_block_logger.error("Error while reading nodeId  data from block " + std::to_string(blockAddress));
-    }
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char*>(&edgeRef), sizeof(unsigned int))) {
-        node_block_logger.error("Error while reading edge reference data from block " + std::to_string(blockAddress));
+static bool loadNodeBlock(unsigned long blockAddress, char* block) {
+    if (NodeBlock::nodesMap) {
+        return NodeBlock::nodesMap->read(blockAddress, block, NodeBlock::BLOCK_SIZE);
     }
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char*>(&centralEdgeRef), sizeof(unsigned int))) {
-        node_block_logger.error("Error while reading central edge reference data from block " +
-                                std::to_string(blockAddress));
-    }
-
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char*>(&edgeRefPID), sizeof(unsigned char))) {
-        node_block_logger.error("Error while reading edge reference partition ID data from block " +
-                                std::to_string(blockAddress));
+    NodeBlock::nodesDB->seekg(blockAddress);
+    if (!NodeBlock::nodesDB->read(block, NodeBlock::BLOCK_SIZE)) {
+        NodeBlock::nodesDB->clear();
+        return false;
     }
+    return true;
+}
 
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char*>(&propRef), sizeof(unsigned int))) {
-        node_block_logger.error("Error while reading prop reference data from block " + std::to_string(blockAddress));
-    }
+/**
+ * Read the raw bytes of the node block at the given address through the block cache. On a miss the block is copied
+ * from the memory mapped nodes DB or read with a single read from the nodes DB stream
+ * */
+bool NodeBlock::readBlock(unsigned long blockAddress, char* block) {
+    StorageMetrics::ReadTimer timer(BlockFile::NODES, NodeBlock::BLOCK_SIZE);
+    return BlockCache::getInstance()->read(
+        BlockFile::NODES, blockAddress, block, NodeBlock::BLOCK_SIZE, [blockAddress, &timer](char* buffer) {
+            timer.load(!NodeBlock::nodesMap);
+            return loadNodeBlock(blockAddress, buffer);
+        });
+}
 
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char*>(&metaPropRef), sizeof(unsigned int))) {
-        node_block_logger.error("Error while reading prop reference data from block " +
-        std::to_string(blockAddress));
-    }
+/**
+ * Build a node block from the raw bytes read by readBlock(), record layout is the same as in save()
+ * */
+NodeBlock* NodeBlock::decode(std::string id, unsigned long blockAddress, const char* block) {
+    unsigned int nodeId;
+    unsigned char edgeRefPID;
+    char label[NodeBlock::LABEL_SIZE + 1] = {0};
+    auto reference = [block](unsigned long offset, unsigned long blockSize) {
+        unsigned int record;
+        std::memcpy(&record, block + offset, sizeof(record));
+        return BlockFormat::decode(record, blockSize);
+    };
+
+    bool usage = *block == '\1';
+    std::memcpy(&nodeId, block + sizeof(char), sizeof(nodeId));
+    std::memcpy(&edgeRefPID, block + NodeBlock::EDGE_REF_PID_OFFSET, sizeof(edgeRefPID));
+    std::memcpy(label, block + NodeBlock::LABEL_OFFSET, NodeBlock::LABEL_SIZE);
+
+    return new NodeBlock(id, nodeId, blockAddress,
+                         reference(NodeBlock::PROP_REF_OFFSET, PropertyLink::PROPERTY_BLOCK_SIZE),
+                         reference(NodeBlock::META_PROP_REF_OFFSET, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE),
+                         reference(NodeBlock::EDGE_REF_OFFSET, RelationBlock::BLOCK_SIZE),
+                         reference(NodeBlock::CENTRAL_EDGE_REF_OFFSET, RelationBlock::CENTRAL_BLOCK_SIZE), edgeRefPID,
+                         label, usage);
+}
 
-    if (!NodeBlock::nodesDB->read(&label[0], NodeBlock::LABEL_SIZE)) {
-        node_block_logger.error("Error while reading label data from block " + std::to_string(blockAddress));
+NodeBlock* NodeBlock::get(unsigned long blockAddress) {
+    char block[NodeBlock::BLOCK_SIZE] = {0};
+    if (!NodeBlock::readBlock(blockAddress, block)) {
+        node_block_logger.error("Error while reading node block data from block " + std::to_string(blockAddress));
     }
-    bool usage = usageBlock == '\1';
-    node_block_logger.debug("Label = " + std::string(label));
-    node_block_logger.debug("Label = " + std::string(label));
-    node_block_logger.debug("Length of label = " + std::to_string(strlen(label)));
-    node_block_logger.debug("edgeRef = " + std::to_string(edgeRef));
-    if (strlen(label) != 0) {
-        id = std::to_string(nodeId);
+    NodeBlock* nodeBlockPointer = NodeBlock::decode("", blockAddress, block);
+    node_block_logger.debug("Label = " + std::string(nodeBlockPointer->label));
+    node_block_logger.debug("edgeRef = " + std::to_string(nodeBlockPointer->edgeRef));
+    if (strlen(nodeBlockPointer->label) != 0) {
+        nodeBlockPointer->id = std::to_string(nodeBlockPointer->nodeId);
     }
-    nodeBlockPointer =
-        new NodeBlock(id, nodeId, blockAddress, propRef, metaPropRef, edgeRef,
-                      centralEdgeRef, edgeRefPID, label, usage);
     if (nodeBlockPointer->id.length() == 0) {  // if label not found in node block look in the properties
         std::map<std::string, char*> props = nodeBlockPointer->getAllProperties();
         if (props["label"]) {
@@ -474,10 +523,14 @@ NodeBlock* NodeBlock::get(unsigned int blockAddress) {
             node_block_logger.error("Could not find node ID/Label for node with block address = " +
                 std::to_string(nodeBlockPointer->addr));
         }
+        for (auto& [key, value] : props) {
+            delete[] value;
+        }
     }
     node_block_logger.debug("Edge ref = " + std::to_string(nodeBlockPointer->edgeRef));
     if (nodeBlockPointer->edgeRef % RelationBlock::BLOCK_SIZE != 0) {
-        node_block_logger.error("Exception: Invalid edge reference address = " + nodeBlockPointer->edgeRef);
+        node_block_logger.error("Exception: Invalid edge reference address = " +
+                                std::to_string(nodeBlockPointer->edgeRef));
     }
     return nodeBlockPointer;
 }
@@ -486,3 +539,4 @@ PropertyLink* NodeBlock::getPropertyHead() { return PropertyLink::get(this->prop
 MetaPropertyLink* NodeBlock::getMetaPropertyHead() { return MetaPropertyLink::get(this->metaPropRef); }
 
 thread_local std::fstream* NodeBlock::nodesDB = NULL;
+thread_local MappedFile* NodeBlock::nodesMap = NULL;
@@ -19,6 +19,8 @@ limitations under the License.
 
 #include "PropertyLink.h"
 #include "MetaPropertyLink.h"
+#include "MappedFile.h"
+#include "PropertyStore.h"
 
 class RelationBlock;  // Forward declaration
 
@@ -29,40 +31,50 @@ class NodeBlock {
  private:
     bool isDirected = false;
 
+    bool linkRelation(RelationBlock *relation, bool central, bool outgoing, bool relocateHead);
+
  public:
     static const unsigned long BLOCK_SIZE = 40;  // Size of a node block in bytes
     static const unsigned int LABEL_SIZE = 18;    // Size of a node label in bytes
-    unsigned int addr = 0;
+    // Offsets of the records in a node block, see save()
+    static const unsigned long EDGE_REF_OFFSET = 5;
+    static const unsigned long CENTRAL_EDGE_REF_OFFSET = 9;
+    static const unsigned long EDGE_REF_PID_OFFSET = 13;
+    static const unsigned long PROP_REF_OFFSET = 14;
+    static const unsigned long META_PROP_REF_OFFSET = 18;
+    static const unsigned long LABEL_OFFSET = 22;
+    unsigned long addr = 0;
     std::string id = "";  // Node ID for this block ie: citation paper ID, Facebook accout ID, Twitter account ID etc
 
     char usage = false;   // Whether this block is in use or not
     unsigned int nodeId;  // nodeId for each block
-    unsigned int edgeRef = 0;         // edges database block address for relations size of edgeRef is 4 bytes
-    unsigned int centralEdgeRef = 0;  // edges cut database block address for edge cut relations
-    unsigned char edgeRefPID = 0;     // Partition ID of the edge reference
-    unsigned int propRef = 0;         // Properties DB block address for node properties
-    unsigned int metaPropRef = 0;         // Meta properties DB block address for node meta properties
+    unsigned long edgeRef = 0;         // Head of the outgoing relations, a 4 byte record on disk
+    unsigned long centralEdgeRef = 0;  // Head of the outgoing edge cut relations, see IncomingRelationHeads
+    unsigned char edgeRefPID = 0;      // Partition ID of the edge reference
+    unsigned long propRef = 0;         // Properties DB block address for node properties
+    unsigned long metaPropRef = 0;     // Meta properties DB block address for node meta properties
 
     char label[LABEL_SIZE] = {
         0};  // Initialize with null chars label === ID if length(id) < 6 else ID will be stored as a Node's property
 
     static thread_local std::fstream *nodesDB;
+    static thread_local MappedFile *nodesMap;  // Set only when the native store runs in mmap storage mode
 
     /**
      * This constructor is used when creating a node for very first time.
      * Where user don't have properties DB address or edge DB addresses
      *
      **/
-    NodeBlock(std::string newId, unsigned int node, unsigned int address) {
+    NodeBlock(std::string newId, unsigned int node, unsigned long address) {
         this->id = newId;
         this->nodeId = node;
         this->addr = address;
         this->usage = true;
     };
 
-    NodeBlock(std::string id, unsigned int nodeId, unsigned int address, unsigned int propRef, unsigned int metaPropRef,
-              unsigned int edgeRef, unsigned int centralEdgeRef, unsigned char edgeRefPID, const char *_label,
-              bool usage);
+    NodeBlock(std::string id, unsigned int nodeId, unsigned long address, unsigned long propRef,
+              unsigned long metaPropRef, unsigned long edgeRef, unsigned long centralEdgeRef, unsigned char edgeRefPID,
+              const char *_label, bool usage);
 
     void save();
     std::string getLabel();
@@ -70,11 +82,14 @@ class NodeBlock {
     void addLabel(char *label);
     bool isInUse();
     int getFlags();
-    static NodeBlock *get(unsigned int);
+    static NodeBlock *get(unsigned long);
+    static bool readBlock(unsigned long blockAddress, char *block);
+    static NodeBlock *decode(std::string id, unsigned long blockAddress, const char *block);
 
     void addProperty(std::string, const char *);
+    void addProperty(std::string name, const PropertyValue &value);
     void addMetaProperty(std::string, const char *);
-    std::map<std::string, char *> getProperty(std::string);
+    bool getProperty(const std::string &name, PropertyValue &value);
     PropertyLink *getPropertyHead();
     MetaPropertyLink *getMetaPropertyHead();
     std::map<std::string, char *> getAllProperties();
@@ -86,7 +101,9 @@ class NodeBlock {
     RelationBlock *getCentralRelationHead();
 
     bool setLocalRelationHead(RelationBlock);
+    bool setLocalRelationHead(unsigned long relationAddress);
     bool setCentralRelationHead(RelationBlock newRelation);
+    bool setCentralRelationHead(unsigned long relationAddress);
 
     std::list<NodeBlock*> getLocalEdgeNodes();
     std::list<NodeBlock*> getCentralEdgeNodes();
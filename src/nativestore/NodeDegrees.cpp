@@ -0,0 +1,264 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "NodeDegrees.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "../util/logger/Logger.h"
+#include "NodeBlock.h"
+#include "RelationBlock.h"
+
+Logger node_degrees_logger;
+
+std::map<std::string, NodeDegrees *> NodeDegrees::openDegrees;
+std::mutex NodeDegrees::openDegreesLock;
+
+static const char NODE_DEGREES_MAGIC[8] = {'J', 'G', 'D', 'E', 'G', 'R', '0', '1'};
+static const unsigned long long INITIAL_CAPACITY = 1024;  // Nodes, grown by doubling
+static const unsigned long REBUILD_READ_BLOCKS = 4096;    // Relation blocks read at once while rebuilding
+
+NodeDegrees *NodeDegrees::acquire(const std::string &dbPrefix, bool *opened) {
+    std::lock_guard<std::mutex> guard(NodeDegrees::openDegreesLock);
+    std::string path = dbPrefix + "_degrees.db";
+    NodeDegrees *degrees;
+    auto it = NodeDegrees::openDegrees.find(path);
+    if (it != NodeDegrees::openDegrees.end()) {
+        degrees = it->second;
+    } else {
+        degrees = new NodeDegrees(path);
+        NodeDegrees::openDegrees[path] = degrees;
+    }
+    degrees->references++;
+    if (opened) {
+        *opened = degrees->references == 1;
+    }
+    return degrees;
+}
+
+void NodeDegrees::release(NodeDegrees *degrees) {
+    std::lock_guard<std::mutex> guard(NodeDegrees::openDegreesLock);
+    if (--degrees->references > 0) {
+        degrees->flush();
+        return;
+    }
+    NodeDegrees::openDegrees.erase(degrees->path);
+    delete degrees;
+}
+
+NodeDegrees::NodeDegrees(const std::string &path) : path(path) {}
+
+NodeDegrees::~NodeDegrees() {
+    this->flush();
+    this->closeFile();
+}
+
+void NodeDegrees::closeFile() {
+    if (this->header) {
+        munmap(this->header, this->mappedSize);
+        this->header = nullptr;
+        this->degrees = nullptr;
+    }
+    if (this->fd >= 0) {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+}
+
+bool NodeDegrees::ensureOpen() {
+    if (this->header) {
+        return true;
+    }
+    this->fd = open(this->path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->fd < 0) {
+        node_degrees_logger.error("Error while opening node degrees " + this->path);
+        return false;
+    }
+    struct stat stat_buf;
+    fstat(this->fd, &stat_buf);
+    if (stat_buf.st_size < (off_t)sizeof(Header)) {
+        return this->mapFile(INITIAL_CAPACITY, true);
+    }
+    Header fileHeader;
+    if (pread(this->fd, &fileHeader, sizeof(Header), 0) != sizeof(Header) ||
+        std::memcmp(fileHeader.magic, NODE_DEGREES_MAGIC, sizeof(NODE_DEGREES_MAGIC)) != 0) {
+        // Counters that cover no relation blocks are rebuilt by the NodeManager
+        node_degrees_logger.error("Node degrees " + this->path + " are corrupted, they will be rebuilt");
+        if (ftruncate(this->fd, 0) != 0) {
+            this->closeFile();
+            return false;
+        }
+        return this->mapFile(INITIAL_CAPACITY, true);
+    }
+    return this->mapFile(fileHeader.capacity, false);
+}
+
+bool NodeDegrees::mapFile(unsigned long long capacity, bool create) {
+    unsigned long size = sizeof(Header) + capacity * sizeof(NodeDegree);
+    // Grown files keep their counters, the new part of the file reads as zeros
+    if ((create || size > this->mappedSize) && ftruncate(this->fd, size) != 0) {
+        node_degrees_logger.error("Error while resizing node degrees " + this->path);
+        return false;
+    }
+    void *region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    if (region == MAP_FAILED) {
+        node_degrees_logger.error("Error while memory mapping node degrees " + this->path);
+        return false;
+    }
+    if (this->header) {
+        munmap(this->header, this->mappedSize);
+    }
+    this->header = static_cast<Header *>(region);
+    this->degrees = reinterpret_cast<NodeDegree *>(static_cast<char *>(region) + sizeof(Header));
+    this->mappedSize = size;
+    if (create) {
+        std::memcpy(this->header->magic, NODE_DEGREES_MAGIC, sizeof(NODE_DEGREES_MAGIC));
+        this->header->relations[0] = 0;
+        this->header->relations[1] = 0;
+    }
+    this->header->capacity = capacity;
+    return true;
+}
+
+// Make room for the counters of nodeIndex, called with the lock held
+bool NodeDegrees::reserve(unsigned int nodeIndex) {
+    if (!this->ensureOpen()) {
+        return false;
+    }
+    if (nodeIndex < this->header->capacity) {
+        return true;
+    }
+    unsigned long long capacity = this->header->capacity;
+    while (capacity <= nodeIndex) {
+        capacity *= 2;
+    }
+    return this->mapFile(capacity, false);
+}
+
+void NodeDegrees::addRelation(unsigned int source, unsigned int destination, bool central) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->reserve(std::max(source, destination))) {
+        return;
+    }
+    NodeDegree &sourceDegree = this->degrees[source];
+    NodeDegree &destinationDegree = this->degrees[destination];
+    central ? sourceDegree.centralOut++ : sourceDegree.localOut++;
+    central ? destinationDegree.centralIn++ : destinationDegree.localIn++;
+    this->header->relations[central ? 1 : 0]++;
+}
+
+void NodeDegrees::removeRelation(unsigned int source, unsigned int destination, bool central) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen() || std::max(source, destination) >= this->header->capacity) {
+        return;
+    }
+    unsigned int &out = central ? this->degrees[source].centralOut : this->degrees[source].localOut;
+    unsigned int &in = central ? this->degrees[destination].centralIn : this->degrees[destination].localIn;
+    if (out > 0) {
+        out--;
+    }
+    if (in > 0) {
+        in--;
+    }
+    if (this->header->relations[central ? 1 : 0] > 0) {
+        this->header->relations[central ? 1 : 0]--;
+    }
+}
+
+NodeDegree NodeDegrees::get(unsigned int nodeIndex) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen() || nodeIndex >= this->header->capacity) {
+        return NodeDegree();
+    }
+    return this->degrees[nodeIndex];
+}
+
+void NodeDegrees::scan(unsigned int first, unsigned int end,
+                       const std::function<void(unsigned int, const NodeDegree &)> &visit) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return;
+    }
+    const NodeDegree none;
+    for (unsigned int node = first; node < end; node++) {
+        visit(node, node < this->header->capacity ? this->degrees[node] : none);
+    }
+}
+
+unsigned long NodeDegrees::relationCount(bool central) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return 0;
+    }
+    return this->header->relations[central ? 1 : 0];
+}
+
+void NodeDegrees::flush() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (this->header) {
+        msync(this->header, this->mappedSize, MS_ASYNC);
+    }
+}
+
+void NodeDegrees::truncate() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->closeFile();
+    ::truncate(this->path.c_str(), 0);
+}
+
+/**
+ * Count every relation block of the file (block 0 and freed blocks are unused), used when the counters are missing or
+ * out of step with the relation blocks, e.g. for partitions written before they were introduced
+ * */
+bool NodeDegrees::count(const std::string &relationsPath, unsigned long blockSize, bool central) {
+    std::ifstream relations(relationsPath, std::ios::binary);
+    if (!relations.is_open()) {
+        node_degrees_logger.error("Error while opening " + relationsPath + " to rebuild the node degrees");
+        return false;
+    }
+    std::vector<char> blocks(REBUILD_READ_BLOCKS * blockSize);
+    unsigned long address = 0;
+    while (relations.read(blocks.data(), blocks.size()) || relations.gcount() > 0) {
+        unsigned long readBlocks = relations.gcount() / blockSize;
+        for (unsigned long i = 0; i < readBlocks; i++, address += blockSize) {
+            if (address == 0) {
+                continue;
+            }
+            const char *block = blocks.data() + i * blockSize;
+            if (RelationBlock::isFree(block)) {
+                continue;
+            }
+            unsigned long source = RelationBlock::readRecord(block, RelationOffsets::SOURCE, central);
+            unsigned long destination = RelationBlock::readRecord(block, RelationOffsets::DESTINATION, central);
+            this->addRelation(source / NodeBlock::BLOCK_SIZE, destination / NodeBlock::BLOCK_SIZE, central);
+        }
+    }
+    return true;
+}
+
+bool NodeDegrees::rebuild(const std::string &relationsPath, const std::string &centralRelationsPath) {
+    this->truncate();
+    node_degrees_logger.info("Rebuilding node degrees " + this->path);
+    bool counted = this->count(relationsPath, RelationBlock::BLOCK_SIZE, false) &&
+                   this->count(centralRelationsPath, RelationBlock::CENTRAL_BLOCK_SIZE, true);
+    this->flush();
+    return counted;
+}
@@ -0,0 +1,92 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_NODEDEGREES_H
+#define JASMINEGRAPH_NODEDEGREES_H
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Relations of a node by relation file and direction, a self loop counts as an out and an in relation
+struct NodeDegree {
+    unsigned int localOut = 0;
+    unsigned int localIn = 0;
+    unsigned int centralOut = 0;
+    unsigned int centralIn = 0;
+
+    unsigned long local() const { return (unsigned long)localOut + localIn; }
+    unsigned long central() const { return (unsigned long)centralOut + centralIn; }
+    unsigned long total() const { return local() + central(); }
+};
+
+/**
+ * Degree counters of the nodes of a partition, kept next to the node blocks in _degrees.db.
+ *
+ * The file holds a NodeDegree per node block index after a small header, so the degree of a node is one read and the
+ * degrees of the whole partition are one sequential read of 16 bytes per node, instead of a walk of every relation
+ * chain. Counters are updated with the relation blocks, the counters of both nodes of a relation under one lock. The
+ * file is memory mapped on first use like the edge index.
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see NodeDegrees::acquire().
+ * */
+class NodeDegrees {
+ public:
+    // opened is set if this call opened the counters, false if another NodeManager of the partition has them open
+    static NodeDegrees *acquire(const std::string &dbPrefix, bool *opened = NULL);
+    static void release(NodeDegrees *degrees);
+
+    // Count a relation between the node blocks source and destination of the local or central relation file
+    void addRelation(unsigned int source, unsigned int destination, bool central);
+    // Uncount a deleted relation, its relation block is freed
+    void removeRelation(unsigned int source, unsigned int destination, bool central);
+    NodeDegree get(unsigned int nodeIndex);
+    // Call visit with the index and degree of the nodes [first, end) in node block order
+    void scan(unsigned int first, unsigned int end, const std::function<void(unsigned int, const NodeDegree &)> &visit);
+    // Number of relation blocks in use in the local or central relation file the counters cover
+    unsigned long relationCount(bool central);
+    void flush();
+    void truncate();
+    // Re-count the degrees from the source and destination records of the relation block files
+    bool rebuild(const std::string &relationsPath, const std::string &centralRelationsPath);
+
+ private:
+    explicit NodeDegrees(const std::string &path);
+    ~NodeDegrees();
+
+    struct Header {
+        char magic[8];
+        unsigned long long capacity;      // Nodes the file has counters for
+        unsigned long long relations[2];  // Local and central relation blocks counted
+    };
+
+    bool ensureOpen();
+    bool mapFile(unsigned long long capacity, bool create);
+    bool reserve(unsigned int nodeIndex);
+    void closeFile();
+    bool count(const std::string &relationsPath, unsigned long blockSize, bool central);
+
+    std::string path;
+    int fd = -1;
+    Header *header = nullptr;
+    NodeDegree *degrees = nullptr;
+    unsigned long mappedSize = 0;
+    std::mutex lock;
+    int references = 0;
+
+    static std::map<std::string, NodeDegrees *> openDegrees;
+    static std::mutex openDegreesLock;
+};
+
+#endif  // JASMINEGRAPH_NODEDEGREES_H
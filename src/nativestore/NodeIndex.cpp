@@ -0,0 +1,469 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "NodeIndex.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+
+#include "../util/logger/Logger.h"
+
+Logger node_index_logger;
+
+std::map<std::string, NodeIndex *> NodeIndex::openIndexes;
+std::mutex NodeIndex::openIndexesLock;
+
+static const char NODE_INDEX_MAGIC[8] = {'J', 'G', 'N', 'I', 'D', 'X', '0', '1'};
+static const unsigned long long INITIAL_CAPACITY = 1024;  // Buckets, always a power of two
+static const unsigned int KEY_RECORD_HEADER_SIZE = 2 * sizeof(unsigned int);
+
+NodeIndex *NodeIndex::acquire(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(NodeIndex::openIndexesLock);
+    NodeIndex *index;
+    auto it = NodeIndex::openIndexes.find(dbPrefix);
+    if (it != NodeIndex::openIndexes.end()) {
+        index = it->second;
+    } else {
+        index = new NodeIndex(dbPrefix);
+        NodeIndex::openIndexes[dbPrefix] = index;
+    }
+    index->references++;
+    return index;
+}
+
+void NodeIndex::release(NodeIndex *index) {
+    std::lock_guard<std::mutex> guard(NodeIndex::openIndexesLock);
+    if (--index->references > 0) {
+        index->flush();
+        return;
+    }
+    for (auto it = NodeIndex::openIndexes.begin(); it != NodeIndex::openIndexes.end(); it++) {
+        if (it->second == index) {
+            NodeIndex::openIndexes.erase(it);
+            break;
+        }
+    }
+    delete index;
+}
+
+NodeIndex::NodeIndex(const std::string &dbPrefix)
+    : tablePath(dbPrefix + "_nodes.hindex.db"), keysPath(dbPrefix + "_nodes.keys.db") {}
+
+NodeIndex::~NodeIndex() {
+    this->flush();
+    this->closeFiles();
+}
+
+void NodeIndex::closeFiles() {
+    if (this->header) {
+        munmap(this->header, this->mappedSize);
+        this->header = nullptr;
+        this->buckets = nullptr;
+    }
+    if (this->tableFd >= 0) {
+        ::close(this->tableFd);
+        this->tableFd = -1;
+    }
+    if (this->keysFd >= 0) {
+        ::close(this->keysFd);
+        this->keysFd = -1;
+    }
+}
+
+/**
+ * Open and map the index files on first use. The hash table file is created with INITIAL_CAPACITY buckets if it does
+ * not exist yet.
+ * */
+bool NodeIndex::ensureOpen() {
+    if (this->header) {
+        return true;
+    }
+    this->keysFd = open(this->keysPath.c_str(), O_RDWR | O_CREAT, 0644);
+    this->tableFd = open(this->tablePath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->keysFd < 0 || this->tableFd < 0) {
+        node_index_logger.error("Error while opening node index files " + this->tablePath + " and " + this->keysPath);
+        this->closeFiles();
+        return false;
+    }
+    struct stat stat_buf;
+    fstat(this->keysFd, &stat_buf);
+    this->keysFileSize = stat_buf.st_size;
+    fstat(this->tableFd, &stat_buf);
+    if (stat_buf.st_size < (off_t)sizeof(Header)) {
+        return this->mapTable(INITIAL_CAPACITY, true);
+    }
+    Header fileHeader;
+    if (pread(this->tableFd, &fileHeader, sizeof(Header), 0) != sizeof(Header) ||
+        std::memcmp(fileHeader.magic, NODE_INDEX_MAGIC, sizeof(NODE_INDEX_MAGIC)) != 0) {
+        node_index_logger.error("Node index " + this->tablePath + " is corrupted!");
+        this->closeFiles();
+        return false;
+    }
+    return this->mapTable(fileHeader.capacity, false);
+}
+
+bool NodeIndex::mapTable(unsigned long long capacity, bool create) {
+    unsigned long size = sizeof(Header) + capacity * sizeof(Bucket);
+    if (create && ftruncate(this->tableFd, size) != 0) {
+        node_index_logger.error("Error while resizing node index " + this->tablePath);
+        return false;
+    }
+    void *region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->tableFd, 0);
+    if (region == MAP_FAILED) {
+        node_index_logger.error("Error while memory mapping node index " + this->tablePath);
+        return false;
+    }
+    this->header = static_cast<Header *>(region);
+    this->buckets = reinterpret_cast<Bucket *>(static_cast<char *>(region) + sizeof(Header));
+    this->mappedSize = size;
+    if (create) {
+        std::memcpy(this->header->magic, NODE_INDEX_MAGIC, sizeof(NODE_INDEX_MAGIC));
+        this->header->capacity = capacity;
+        this->header->count = 0;
+    }
+    return true;
+}
+
+unsigned long long NodeIndex::hashKey(const std::string &nodeId) {
+    // FNV-1a, 0 is reserved for empty buckets
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned char c : nodeId) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash ? hash : 1;
+}
+
+/**
+ * Compare the key record at keyOffset with nodeId, reading the length and the key bytes with a single read
+ * */
+bool NodeIndex::keyMatches(unsigned long long keyOffset, const std::string &nodeId) {
+    std::string record(KEY_RECORD_HEADER_SIZE + nodeId.length(), '\0');
+    if (keyOffset >= this->keysFileSize) {
+        record = this->pendingKeys.substr(keyOffset - this->keysFileSize, record.size());
+    } else if (pread(this->keysFd, &record[0], record.size(), keyOffset) < (ssize_t)KEY_RECORD_HEADER_SIZE) {
+        return false;
+    }
+    unsigned int keyLength;
+    std::memcpy(&keyLength, record.data(), sizeof(keyLength));
+    return keyLength == nodeId.length() &&
+           record.compare(KEY_RECORD_HEADER_SIZE, std::string::npos, nodeId) == 0;
+}
+
+NodeIndex::Bucket *NodeIndex::findBucket(const std::string &nodeId, unsigned long long hash) {
+    unsigned long long mask = this->header->capacity - 1;
+    for (unsigned long long slot = hash & mask;; slot = (slot + 1) & mask) {
+        Bucket *bucket = &this->buckets[slot];
+        if (bucket->hash == 0) {
+            return nullptr;
+        }
+        if (bucket->hash == hash && this->keyMatches(bucket->keyOffset, nodeId)) {
+            return bucket;
+        }
+    }
+}
+
+void NodeIndex::insertBucket(unsigned long long hash, unsigned long long keyOffset, unsigned int nodeIndex) {
+    unsigned long long mask = this->header->capacity - 1;
+    unsigned long long slot = hash & mask;
+    while (this->buckets[slot].hash != 0) {
+        slot = (slot + 1) & mask;
+    }
+    this->buckets[slot] = Bucket{hash, keyOffset, nodeIndex, 0};
+    this->header->count++;
+}
+
+// Empty the bucket at slot with backward shift deletion, like EdgeIndex::removeBucket()
+void NodeIndex::removeBucket(unsigned long long slot) {
+    unsigned long long mask = this->header->capacity - 1;
+    unsigned long long hole = slot;
+    for (unsigned long long next = (hole + 1) & mask; this->buckets[next].hash != 0; next = (next + 1) & mask) {
+        unsigned long long home = this->buckets[next].hash & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            this->buckets[hole] = this->buckets[next];
+            hole = next;
+        }
+    }
+    this->buckets[hole] = Bucket{0, 0, 0, 0};
+    this->header->count--;
+}
+
+/**
+ * Double the bucket count once the table is 70% full. The new table is built in a separate file and renamed over the
+ * old one, bucket hashes are stored so the keys do not have to be read again.
+ * */
+bool NodeIndex::grow() {
+    unsigned long long oldCapacity = this->header->capacity;
+    unsigned long long newCapacity = oldCapacity * 2;
+    std::string tmpPath = this->tablePath + ".tmp";
+    int newFd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    unsigned long newSize = sizeof(Header) + newCapacity * sizeof(Bucket);
+    if (newFd < 0 || ftruncate(newFd, newSize) != 0) {
+        node_index_logger.error("Error while growing node index " + this->tablePath);
+        if (newFd >= 0) ::close(newFd);
+        return false;
+    }
+    void *region = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, newFd, 0);
+    if (region == MAP_FAILED) {
+        node_index_logger.error("Error while memory mapping grown node index " + this->tablePath);
+        ::close(newFd);
+        return false;
+    }
+    Header *oldHeader = this->header;
+    Bucket *oldBuckets = this->buckets;
+    unsigned long oldSize = this->mappedSize;
+
+    this->header = static_cast<Header *>(region);
+    this->buckets = reinterpret_cast<Bucket *>(static_cast<char *>(region) + sizeof(Header));
+    std::memcpy(this->header->magic, NODE_INDEX_MAGIC, sizeof(NODE_INDEX_MAGIC));
+    this->header->capacity = newCapacity;
+    this->header->count = 0;
+    for (unsigned long long slot = 0; slot < oldCapacity; slot++) {
+        if (oldBuckets[slot].hash != 0) {
+            this->insertBucket(oldBuckets[slot].hash, oldBuckets[slot].keyOffset, oldBuckets[slot].nodeIndex);
+        }
+    }
+    msync(region, newSize, MS_SYNC);
+    munmap(oldHeader, oldSize);
+    ::close(this->tableFd);
+    rename(tmpPath.c_str(), this->tablePath.c_str());
+    this->tableFd = newFd;
+    this->mappedSize = newSize;
+    return true;
+}
+
+bool NodeIndex::find(const std::string &nodeId, unsigned int &nodeIndex) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return false;
+    }
+    Bucket *bucket = this->findBucket(nodeId, NodeIndex::hashKey(nodeId));
+    if (!bucket) {
+        return false;
+    }
+    nodeIndex = bucket->nodeIndex;
+    return true;
+}
+
+bool NodeIndex::contains(const std::string &nodeId) {
+    unsigned int nodeIndex;
+    return this->find(nodeId, nodeIndex);
+}
+
+void NodeIndex::insert(const std::string &nodeId, unsigned int nodeIndex) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return;
+    }
+    unsigned long long hash = NodeIndex::hashKey(nodeId);
+    if (this->findBucket(nodeId, hash)) {
+        return;  // Node IDs are never re-assigned to another block
+    }
+    if ((this->header->count + 1) * 10 > this->header->capacity * 7 && !this->grow()) {
+        return;
+    }
+    unsigned long long keyOffset = this->keysFileSize + this->pendingKeys.size();
+    unsigned int keyLength = nodeId.length();
+    this->pendingKeys.append(reinterpret_cast<char *>(&keyLength), sizeof(keyLength));
+    this->pendingKeys.append(reinterpret_cast<char *>(&nodeIndex), sizeof(nodeIndex));
+    this->pendingKeys.append(nodeId);
+    this->insertBucket(hash, keyOffset, nodeIndex);
+    if (this->pendingKeys.size() >= NodeIndex::PENDING_BATCH_BYTES) {
+        this->flushPending();
+    }
+}
+
+/**
+ * Drop the bucket of the node ID and mark its key record removed, so that iterations and recover() skip the node. The
+ * node index stays unused, nodes are never moved to the block of a removed node.
+ * */
+bool NodeIndex::remove(const std::string &nodeId) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return false;
+    }
+    Bucket *bucket = this->findBucket(nodeId, NodeIndex::hashKey(nodeId));
+    if (!bucket) {
+        return false;
+    }
+    unsigned long long recordOffset = bucket->keyOffset + sizeof(unsigned int);
+    const unsigned int removed = NodeIndex::REMOVED_NODE;
+    if (recordOffset >= this->keysFileSize) {
+        this->pendingKeys.replace(recordOffset - this->keysFileSize, sizeof(removed),
+                                  reinterpret_cast<const char *>(&removed), sizeof(removed));
+    } else if (pwrite(this->keysFd, &removed, sizeof(removed), recordOffset) != sizeof(removed)) {
+        node_index_logger.error("Error while removing node " + nodeId + " from node index keys " + this->keysPath);
+    }
+    this->removeBucket(bucket - this->buckets);
+    return true;
+}
+
+void NodeIndex::flushPending() {
+    if (this->pendingKeys.empty()) {
+        return;
+    }
+    if (pwrite(this->keysFd, this->pendingKeys.data(), this->pendingKeys.size(), this->keysFileSize) !=
+        (ssize_t)this->pendingKeys.size()) {
+        node_index_logger.error("Error while appending to node index keys " + this->keysPath);
+        return;
+    }
+    this->keysFileSize += this->pendingKeys.size();
+    this->pendingKeys.clear();
+}
+
+unsigned long NodeIndex::size() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->ensureOpen()) {
+        return 0;
+    }
+    return this->header->count;
+}
+
+void NodeIndex::flush() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (!this->header) {
+        return;
+    }
+    this->flushPending();
+    msync(this->header, this->mappedSize, MS_ASYNC);
+}
+
+void NodeIndex::truncate() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->closeFiles();
+    this->pendingKeys.clear();
+    ::truncate(this->keysPath.c_str(), 0);
+    ::truncate(this->tablePath.c_str(), 0);
+}
+
+void NodeIndex::migrateLegacyIndex(const std::string &legacyPath, unsigned long keySize) {
+    if (this->size() > 0) {
+        return;
+    }
+    std::ifstream legacyIndex(legacyPath, std::ios::binary);
+    if (!legacyIndex.is_open()) {
+        return;
+    }
+    node_index_logger.info("Migrating node index " + legacyPath + " to " + this->tablePath);
+    std::string key(keySize, '\0');
+    unsigned int nodeIndex;
+    unsigned long migrated = 0;
+    while (legacyIndex.read(&key[0], keySize) &&
+           legacyIndex.read(reinterpret_cast<char *>(&nodeIndex), sizeof(unsigned int))) {
+        this->insert(std::string(key.c_str()), nodeIndex);
+        migrated++;
+    }
+    this->flush();
+    node_index_logger.info("Migrated " + std::to_string(migrated) + " node index entries");
+}
+
+/**
+ * Rebuild the index after a crash. The hash table and the node blocks can reach the disk while key records that were
+ * still pending are lost, so the hash table is rebuilt from the key records that are complete, and node blocks without
+ * a key record are keyed again with keyOf.
+ * */
+void NodeIndex::recover(unsigned int nodeCount, const std::function<std::string(unsigned int)> &keyOf) {
+    std::vector<std::pair<std::string, unsigned int>> entries;
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        if (!this->ensureOpen()) {
+            return;
+        }
+        this->pendingKeys.clear();
+        std::string keys(this->keysFileSize, '\0');
+        if (pread(this->keysFd, &keys[0], keys.size(), 0) != (ssize_t)keys.size()) {
+            node_index_logger.error("Error while reading node index keys " + this->keysPath);
+            keys.clear();
+        }
+        unsigned long offset = 0;
+        while (offset + KEY_RECORD_HEADER_SIZE <= keys.size()) {
+            unsigned int recordHeader[2];  // Key length, node index
+            std::memcpy(recordHeader, keys.data() + offset, KEY_RECORD_HEADER_SIZE);
+            if (offset + KEY_RECORD_HEADER_SIZE + recordHeader[0] > keys.size()) {
+                break;
+            }
+            if (recordHeader[1] < nodeCount) {
+                entries.push_back({keys.substr(offset + KEY_RECORD_HEADER_SIZE, recordHeader[0]), recordHeader[1]});
+            }
+            offset += KEY_RECORD_HEADER_SIZE + recordHeader[0];
+        }
+    }
+    this->truncate();
+    std::vector<bool> keyed(nodeCount, false);
+    for (const auto &entry : entries) {
+        this->insert(entry.first, entry.second);
+        keyed[entry.second] = true;
+    }
+    unsigned long rekeyed = 0;
+    for (unsigned int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++) {
+        std::string key = keyed[nodeIndex] ? "" : keyOf(nodeIndex);
+        if (!key.empty()) {
+            this->insert(key, nodeIndex);
+            rekeyed++;
+        }
+    }
+    this->flush();
+    node_index_logger.info("Recovered node index " + this->tablePath + ", " + std::to_string(entries.size()) +
+                           " keys kept and " + std::to_string(rekeyed) + " restored from node blocks");
+}
+
+NodeIndex::Iterator NodeIndex::begin() {
+    this->flush();
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->ensureOpen();
+    return Iterator(this, 0, this->keysFileSize);
+}
+
+NodeIndex::Iterator NodeIndex::end() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return Iterator(this, this->keysFileSize, this->keysFileSize);
+}
+
+NodeIndex::Iterator::Iterator(NodeIndex *index, unsigned long offset, unsigned long end)
+    : index(index), offset(offset), end(end) {
+    this->load();
+}
+
+void NodeIndex::Iterator::load() {
+    unsigned int recordHeader[2];
+    while (true) {
+        if (this->offset >= this->end) {
+            this->offset = this->end;
+            return;
+        }
+        if (pread(this->index->keysFd, recordHeader, sizeof(recordHeader), this->offset) != sizeof(recordHeader)) {
+            node_index_logger.error("Error while reading node index keys at " + std::to_string(this->offset));
+            this->offset = this->end;
+            return;
+        }
+        if (recordHeader[1] != NodeIndex::REMOVED_NODE) {
+            break;
+        }
+        this->offset += sizeof(recordHeader) + recordHeader[0];  // Key record of a removed node
+    }
+    this->entry.first.resize(recordHeader[0]);
+    pread(this->index->keysFd, &this->entry.first[0], recordHeader[0], this->offset + sizeof(recordHeader));
+    this->entry.second = recordHeader[1];
+    this->recordSize = sizeof(recordHeader) + recordHeader[0];
+}
+
+NodeIndex::Iterator &NodeIndex::Iterator::operator++() {
+    this->offset += this->recordSize;
+    this->load();
+    return *this;
+}
@@ -0,0 +1,125 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_NODEINDEX_H
+#define JASMINEGRAPH_NODEINDEX_H
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Persistent node ID -> node block index map of a partition.
+ *
+ * The index is an open addressing hash table file (_nodes.hindex.db) that is memory mapped on first use, so opening
+ * a NodeManager does not read the index. Keys of any length live in an append only key file (_nodes.keys.db), each
+ * record is [key length (4)][node index (4)][key bytes]. Key records are appended in batches, lookups of keys that
+ * are not written yet are served from the pending batch. Iterating the index scans the key file sequentially, which
+ * gives the nodes in insertion order. The key record of a removed node stays in the key file with node index
+ * REMOVED_NODE.
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see NodeIndex::acquire().
+ * */
+class NodeIndex {
+ public:
+    class Iterator {
+     public:
+        Iterator(NodeIndex *index, unsigned long offset, unsigned long end);
+        const std::pair<std::string, unsigned int> &operator*() const { return entry; }
+        const std::pair<std::string, unsigned int> *operator->() const { return &entry; }
+        Iterator &operator++();
+        bool operator!=(const Iterator &other) const { return offset != other.offset; }
+
+     private:
+        void load();
+
+        NodeIndex *index;
+        unsigned long offset;
+        unsigned long end;
+        unsigned long recordSize = 0;
+        std::pair<std::string, unsigned int> entry;
+    };
+
+    static NodeIndex *acquire(const std::string &dbPrefix);
+    static void release(NodeIndex *index);
+
+    bool find(const std::string &nodeId, unsigned int &nodeIndex);
+    bool contains(const std::string &nodeId);
+    void insert(const std::string &nodeId, unsigned int nodeIndex);
+    // Remove the node ID of a deleted node, false if it is not in the index
+    bool remove(const std::string &nodeId);
+    unsigned long size();
+    void flush();
+    // Drop all entries, used when the partition is opened in trunc mode
+    void truncate();
+    // Import the fixed width _nodes.index.db written by older versions, if the new index is still empty
+    void migrateLegacyIndex(const std::string &legacyPath, unsigned long keySize);
+    // Rebuild the index of nodeCount node blocks after a crash, keyOf gives the key of a node block whose key record
+    // was lost, empty for unused blocks
+    void recover(unsigned int nodeCount, const std::function<std::string(unsigned int)> &keyOf);
+
+    Iterator begin();
+    Iterator end();
+
+    static const unsigned long PENDING_BATCH_BYTES = 64 * 1024;  // Key records buffered before they are appended
+    static const unsigned int REMOVED_NODE = 0xFFFFFFFF;  // Node index of the key records of removed nodes
+
+ private:
+    explicit NodeIndex(const std::string &dbPrefix);
+    ~NodeIndex();
+
+    struct Bucket {
+        unsigned long long hash;  // 0 marks an empty bucket
+        unsigned long long keyOffset;
+        unsigned int nodeIndex;
+        unsigned int reserved;
+    };
+
+    struct Header {
+        char magic[8];
+        unsigned long long capacity;
+        unsigned long long count;
+        unsigned long long reserved;
+    };
+
+    bool ensureOpen();
+    bool mapTable(unsigned long long capacity, bool create);
+    bool grow();
+    void closeFiles();
+    void flushPending();
+    bool keyMatches(unsigned long long keyOffset, const std::string &nodeId);
+    Bucket *findBucket(const std::string &nodeId, unsigned long long hash);
+    void insertBucket(unsigned long long hash, unsigned long long keyOffset, unsigned int nodeIndex);
+    void removeBucket(unsigned long long slot);
+    static unsigned long long hashKey(const std::string &nodeId);
+
+    std::string tablePath;
+    std::string keysPath;
+    int tableFd = -1;
+    int keysFd = -1;
+    Header *header = nullptr;
+    Bucket *buckets = nullptr;
+    unsigned long mappedSize = 0;
+    unsigned long long keysFileSize = 0;  // Bytes of the key file already on disk
+    std::string pendingKeys;              // Key records not appended to the key file yet
+    std::mutex lock;
+    int references = 0;
+
+    static std::map<std::string, NodeIndex *> openIndexes;
+    static std::mutex openIndexesLock;
+};
+
+#endif  // JASMINEGRAPH_NODEINDEX_H
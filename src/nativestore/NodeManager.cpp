@@ -13,24 +13,37 @@ limitations under the License.
 
 #include "NodeManager.h"
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
 #include <exception>
 #include <mutex>
+#include <vector>
 
 #include "../util/Utils.h"
 #include "../util/logger/Logger.h"
 #include "NodeBlock.h"  // To setup node DB
 #include "PropertyEdgeLink.h"
 #include "PropertyLink.h"
+#include "BlockCache.h"
+#include "BlockFormat.h"
+#include "EdgeIndex.h"
+#include "MappedFile.h"
+#include "PropertyStore.h"
+#include "MetaPropertyEdgeLink.h"
 #include "MetaPropertyLink.h"
 #include "RelationBlock.h"
+#include "StorageMetrics.h"
 #include "iostream"
 #include <sys/stat.h>
 #include <thread>
 
 Logger node_manager_logger;
-pthread_mutex_t lockEdgeAdd;
 
 NodeManager::NodeManager(GraphConfig gConfig) {
     this->graphID = gConfig.graphID;
@@ -64,11 +77,27 @@ NodeManager::NodeManager(GraphConfig gConfig) {
     }
 
     std::ios_base::openmode openMode = std::ios::in | std::ios::out;  // Default mode
+    this->nodeIndex = NodeIndex::acquire(dbPrefix);
+    this->allocator = BlockAllocator::acquire(dbPrefix);
+    BlockAllocator::current = this->allocator;
+    StorageMetrics::current = StorageMetrics::get(dbPrefix);
     if (gConfig.openMode == NodeManager::FILE_MODE) {
-        this->nodeIndex = readNodeIndex();
+        this->nodeIndex->migrateLegacyIndex(indexDBPath, NodeManager::INDEX_KEY_SIZE);
+        // Blocks of deleted nodes stay allocated, so the node file can hold more blocks than the index has nodes
+        struct stat stat_buf;
+        unsigned long nodeBlocks = stat(nodesDBPath.c_str(), &stat_buf) == 0 ? stat_buf.st_size / NodeBlock::BLOCK_SIZE
+                                                                             : 0;
+        this->allocator->initialize(BlockFile::NODES, std::max<unsigned long>(this->nodeIndex->size(), nodeBlocks));
     } else {
         openMode |= std::ios::trunc;
+        this->nodeIndex->truncate();
+        std::remove(indexDBPath.c_str());
+        this->allocator->initialize(BlockFile::NODES, 0, true);
     }
+    // A relation compaction that was interrupted after its files were written is completed before they are opened
+    int compactedRelations = NodeManager::swapCompactedFiles(dbPrefix);
+    this->formatVersion = BlockFormat::open(dbPrefix, gConfig.openMode != NodeManager::FILE_MODE);
+    BlockFormat::version = this->formatVersion;
 
     if (gConfig.openMode == NodeManager::FILE_MODE) {
         node_manager_logger.info("Using APPEND mode for file operations.");
@@ -76,13 +105,7 @@ NodeManager::NodeManager(GraphConfig gConfig) {
         node_manager_logger.info("Using TRUNC mode for file operations.");
     }
 
-    NodeBlock::nodesDB = Utils::openFile(nodesDBPath, openMode);
-    PropertyLink::propertiesDB = Utils::openFile(propertiesDBPath, openMode);
-    MetaPropertyLink::metaPropertiesDB = Utils::openFile(metaPropertiesDBPath, openMode);
-    PropertyEdgeLink::edgePropertiesDB = Utils::openFile(edgePropertiesDBPath, openMode);
-    MetaPropertyEdgeLink::metaEdgePropertiesDB = Utils::openFile(metaEdgePropertiesDBPath, openMode);
-    RelationBlock::relationsDB = utils.openFile(relationsDBPath, openMode);
-    RelationBlock::centralRelationsDB = Utils::openFile(centralRelationsDBPath, openMode);
+    NodeManager::openBlockFiles(dbPrefix, openMode);
 
     //    RelationBlock::centralpropertiesDB =
     //            new std::fstream(dbPrefix + "_central_relations.db", std::ios::in | std::ios::out | openMode |
@@ -90,6 +113,35 @@ NodeManager::NodeManager(GraphConfig gConfig) {
     // TODO (tmkasun): set PropertyLink nextPropertyIndex after validating by modulus check from file number of bytes
 
     node_manager_logger.info("NodesDB, PropertiesDB, and RelationsDB files opened (or created) successfully.");
+
+    BlockCache* blockCache = BlockCache::getInstance();
+    this->cachePartition = blockCache->attach(dbPrefix);
+    if (gConfig.openMode != NodeManager::FILE_MODE) {
+        blockCache->invalidate(this->cachePartition);  // Files were truncated, cached blocks are stale
+    }
+
+    // The property format of an existing partition follows its data, new partitions use the configured format
+    bool columnarProperties = PropertyStore::exists(dbPrefix);
+    if (gConfig.openMode != NodeManager::FILE_MODE) {
+        PropertyStore::remove(dbPrefix);
+        columnarProperties = utils.getJasmineGraphProperty("org.jasminegraph.nativestore.property.store") ==
+                             PropertyStore::COLUMNAR;
+    }
+    if (columnarProperties) {
+        node_manager_logger.info("Using the column store for native store properties.");
+        this->propertyStore = PropertyStore::acquire(dbPrefix);
+    }
+    PropertyStore::current = this->propertyStore;
+
+    std::string storageMode = gConfig.storageMode;
+    if (storageMode.empty()) {
+        storageMode = utils.getJasmineGraphProperty("org.jasminegraph.nativestore.storage.mode");
+    }
+    if (storageMode == MappedFile::STORAGE_MODE_MMAP) {
+        node_manager_logger.info("Using memory mapped reads for native store block files.");
+        NodeManager::mapBlockFiles(dbPrefix);
+        this->mappedStorage = true;
+    }
     //    unsigned int nextAddress;
     //    unsigned int propertyBlockAddress = 0;
     //    PropertyLink::propertiesDB->seekg(propertyBlockAddress * PropertyLink::PROPERTY_BLOCK_SIZE);
@@ -122,95 +174,654 @@ NodeManager::NodeManager(GraphConfig gConfig) {
                                                             centralRelationsDBPath);
     }
 
-    struct stat stat_buf;
+    // The first NodeManager of the partition sets the next free blocks from the file sizes, block 0 of the property
+    // and relation files is never used
+    auto initializeAllocator = [&](BlockFile file, const std::string &path, unsigned long blockSize) {
+        struct stat stat_buf;
+        if (stat(path.c_str(), &stat_buf) != 0) {
+            node_manager_logger.error("Error getting file size for: " + path);
+            return;
+        }
+        unsigned int blocks = stat_buf.st_size / blockSize;
+        this->allocator->initialize(file, blocks == 0 ? 1 : blocks, gConfig.openMode != NodeManager::FILE_MODE);
+    };
+    initializeAllocator(BlockFile::PROPERTIES, propertiesDBPath, PropertyLink::PROPERTY_BLOCK_SIZE);
+    initializeAllocator(BlockFile::META_PROPERTIES, metaPropertiesDBPath, MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+    initializeAllocator(BlockFile::EDGE_PROPERTIES, edgePropertiesDBPath, PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
+    initializeAllocator(BlockFile::META_EDGE_PROPERTIES, metaEdgePropertiesDBPath,
+                        MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
+    initializeAllocator(BlockFile::RELATIONS, relationsDBPath, RelationBlock::BLOCK_SIZE);
+    initializeAllocator(BlockFile::CENTRAL_RELATIONS, centralRelationsDBPath, RelationBlock::CENTRAL_BLOCK_SIZE);
+
+    // Rebuild the edge indexes if they do not cover every relation block in use, e.g. for partitions written before
+    // they were introduced. Only the NodeManager that opens an index checks it, with the node locks held: an edge
+    // insert of another NodeManager allocates its relation block before it adds the edge to the index
+    bool localIndexOpened = false;
+    bool centralIndexOpened = false;
+    this->localEdgeIndex = EdgeIndex::acquire(dbPrefix + "_relations.hindex.db", &localIndexOpened);
+    this->centralEdgeIndex = EdgeIndex::acquire(dbPrefix + "_central_relations.hindex.db", &centralIndexOpened);
+    if (gConfig.openMode != NodeManager::FILE_MODE) {
+        this->localEdgeIndex->truncate();
+        this->centralEdgeIndex->truncate();
+    }
+    auto relationsInUse = [this](BlockFile file) {
+        return this->allocator->next(file) - 1 - this->allocator->freeCount(file);
+    };
+    if (localIndexOpened || centralIndexOpened) {
+        this->allocator->lockAll();
+        if (localIndexOpened && this->localEdgeIndex->relationCount() != relationsInUse(BlockFile::RELATIONS)) {
+            this->localEdgeIndex->rebuild(relationsDBPath, RelationBlock::BLOCK_SIZE);
+        }
+        if (centralIndexOpened &&
+            this->centralEdgeIndex->relationCount() != relationsInUse(BlockFile::CENTRAL_RELATIONS)) {
+            this->centralEdgeIndex->rebuild(centralRelationsDBPath, RelationBlock::CENTRAL_BLOCK_SIZE);
+        }
+        this->allocator->unlockAll();
+    }
 
-    if (stat(propertiesDBPath.c_str(), &stat_buf) == 0) {
-        PropertyLink::nextPropertyIndex = (stat_buf.st_size / PropertyLink::PROPERTY_BLOCK_SIZE) == 0 ? 1 :
-                (stat_buf.st_size / PropertyLink::PROPERTY_BLOCK_SIZE);
+    // Checked like the edge indexes, relations are counted after their blocks are allocated
+    bool degreesOpened = false;
+    this->nodeDegrees = NodeDegrees::acquire(dbPrefix, &degreesOpened);
+    if (gConfig.openMode != NodeManager::FILE_MODE) {
+        this->nodeDegrees->truncate();
+    }
+    if (degreesOpened) {
+        this->allocator->lockAll();
+        if (this->nodeDegrees->relationCount(false) != relationsInUse(BlockFile::RELATIONS) ||
+            this->nodeDegrees->relationCount(true) != relationsInUse(BlockFile::CENTRAL_RELATIONS)) {
+            this->nodeDegrees->rebuild(relationsDBPath, centralRelationsDBPath);
+        }
+        this->allocator->unlockAll();
+    }
 
-    } else {
-        node_manager_logger.error("Error getting file size for: " + propertiesDBPath);
+    // Partitions written with one relation chain per node get their outgoing and incoming chains linked
+    bool incomingHeadsExist = IncomingRelationHeads::exists(dbPrefix);
+    this->incomingHeads = IncomingRelationHeads::acquire(dbPrefix);
+    IncomingRelationHeads::current = this->incomingHeads;
+    if (gConfig.openMode != NodeManager::FILE_MODE) {
+        this->incomingHeads->truncate();
+    } else if (!incomingHeadsExist) {
+        node_manager_logger.info("Splitting the relation chains of " + dbPrefix + " by direction");
+        this->relinkRelations(false, true);
+        this->relinkRelations(true, true);
+        blockCache->invalidate(this->cachePartition);
     }
 
-    if (stat(metaPropertiesDBPath.c_str(), &stat_buf) == 0) {
-        MetaPropertyLink::nextPropertyIndex = (stat_buf.st_size / MetaPropertyLink::META_PROPERTY_BLOCK_SIZE) == 0 ? 1 :
-                                          (stat_buf.st_size / MetaPropertyLink::META_PROPERTY_BLOCK_SIZE);
+    bool labelIndexExists = LabelIndex::exists(dbPrefix);
+    this->labelIndex = LabelIndex::acquire(dbPrefix);
+    LabelIndex::current = this->labelIndex;
+    if (gConfig.openMode != NodeManager::FILE_MODE) {
+        this->labelIndex->truncate();
+    } else if (!labelIndexExists && this->allocator->next(BlockFile::NODES) > 0) {
+        this->rebuildLabelIndex();
+    }
 
-    } else {
-        node_manager_logger.error("Error getting file size for: " + metaPropertiesDBPath);
+    this->propertyIndex = PropertyIndex::acquire(dbPrefix);
+    if (gConfig.openMode != NodeManager::FILE_MODE) {
+        this->propertyIndex->truncate();
     }
 
-    if (stat(edgePropertiesDBPath.c_str(), &stat_buf) == 0) {
-        PropertyEdgeLink::nextPropertyIndex = (stat_buf.st_size / PropertyEdgeLink::PROPERTY_BLOCK_SIZE) == 0 ? 1 :
-                                            (stat_buf.st_size / PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
-    } else {
-        node_manager_logger.error("Error getting file size for: " + edgePropertiesDBPath);
+    bool relationTypeIndexExists = RelationTypeIndex::exists(dbPrefix);
+    this->relationTypeIndex = RelationTypeIndex::acquire(dbPrefix);
+    RelationTypeIndex::current = this->relationTypeIndex;
+    if (gConfig.openMode != NodeManager::FILE_MODE) {
+        this->relationTypeIndex->truncate();
+    } else if (!relationTypeIndexExists) {
+        node_manager_logger.info("Building the relation type index of " + dbPrefix);
+        RelationBlock::migrateLegacyTypes(false, this->allocator->next(BlockFile::RELATIONS));
+        RelationBlock::migrateLegacyTypes(true, this->allocator->next(BlockFile::CENTRAL_RELATIONS));
     }
 
-    if (stat(metaEdgePropertiesDBPath.c_str(), &stat_buf) == 0) {
-        MetaPropertyEdgeLink::nextPropertyIndex = (stat_buf.st_size / MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE)
-                == 0 ? 1 : (stat_buf.st_size / MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE);
-    } else {
-        node_manager_logger.error("Error getting file size for: " + metaEdgePropertiesDBPath);
+    // Records left in the log of an existing partition are replayed by the incremental local store. Only the
+    // NodeManager that opens the log finds the records of the last run in it, later ones share the log of a writer
+    // that is still logging
+    bool walOpened = false;
+    this->wal = WriteAheadLog::acquire(dbPrefix, &walOpened);
+    this->truncated = gConfig.openMode != NodeManager::FILE_MODE;
+    if (this->wal && walOpened && this->truncated) {
+        this->wal->checkpoint();
+    } else if (this->wal && walOpened && this->wal->size() > 0) {
+        this->recover();
+    }
+    if (compactedRelations >= 0) {
+        if (gConfig.openMode == NodeManager::FILE_MODE) {
+            this->finishCompaction(compactedRelations == 1);
+            this->checkpoint();
+        }
+        std::remove((dbPrefix + "_compaction.log").c_str());
     }
+    node_manager_logger.info("Node Manager Execution Completed!");
+}
 
-    if (stat(relationsDBPath.c_str(), &stat_buf) == 0) {
-        RelationBlock::nextLocalRelationIndex = (stat_buf.st_size / RelationBlock::BLOCK_SIZE) == 0 ? 1 :
-                                        (stat_buf.st_size / RelationBlock::BLOCK_SIZE);
-    } else {
-        node_manager_logger.error("Error getting file size for: " + relationsDBPath);
+/**
+ * Repair a partition that was not closed cleanly, which is when records are left in its write-ahead log. Updates kept
+ * by the block cache and pending node index keys were lost, so the node index is rebuilt from its key file and the
+ * node blocks, the edge indexes from the relation files, and the relation chains are linked again. Replaying the log
+ * afterwards skips the operations that reached the block files.
+ * */
+void NodeManager::recover() {
+    node_manager_logger.warn("Recovering partition " + dbPrefix + ", " + std::to_string(this->wal->size()) +
+                             " logged operations are not checkpointed");
+    unsigned int nodeCount = dbSize(dbPrefix + "_nodes.db") / NodeBlock::BLOCK_SIZE;
+    this->nodeIndex->recover(nodeCount, [](unsigned int nodeIndex) -> std::string {
+        char block[NodeBlock::BLOCK_SIZE];
+        if (!NodeBlock::readBlock(nodeIndex * NodeBlock::BLOCK_SIZE, block)) {
+            return "";
+        }
+        NodeBlock *node = NodeBlock::decode("", nodeIndex * NodeBlock::BLOCK_SIZE, block);
+        std::string key = node->usage ? std::to_string(node->nodeId) : "";
+        delete node;
+        return key;
+    });
+    this->allocator->initialize(BlockFile::NODES, nodeCount, true);
+    this->localEdgeIndex->rebuild(dbPrefix + "_relations.db", RelationBlock::BLOCK_SIZE);
+    this->centralEdgeIndex->rebuild(dbPrefix + "_central_relations.db", RelationBlock::CENTRAL_BLOCK_SIZE);
+    this->nodeDegrees->rebuild(dbPrefix + "_relations.db", dbPrefix + "_central_relations.db");
+    this->relinkRelations(false);
+    this->relinkRelations(true);
+    BlockCache::getInstance()->invalidate(this->cachePartition);
+}
+
+/**
+ * Link the relations of a relation file into the outgoing chain of their source and the incoming chain of their
+ * destination again, and set the relation heads of the nodes. The order of each chain is read from the next links the
+ * relations already have: a chain is followed from the relation that no other relation of the node links to, for as
+ * long as the links lead to used relations of the same node. Block addresses say nothing about the order once blocks
+ * are reused or compacted. A chain cut by an insert that was interrupted leaves several pieces, which are joined
+ * starting with the piece at the highest block address, and relations only reachable through a cycle of links are
+ * appended in address order.
+ *
+ * Partitions written before the chains were split by direction have one chain per node whose links can not be read
+ * this way. Their chains were never reordered by a reused block, so inAddressOrder links those relations in block
+ * address order, newest first, as addLocalEdge() / addCentralEdge() inserted them.
+ *
+ * Free relation blocks are left out of the chains and become the free blocks of the relation file. The relation file
+ * is read and rewritten in chunks of blocks.
+ * */
+void NodeManager::relinkRelations(bool central, bool inAddressOrder) {
+    const unsigned long blockSize = central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+    const unsigned int relationCount = this->allocator->next(central ? BlockFile::CENTRAL_RELATIONS
+                                                                     : BlockFile::RELATIONS);
+    std::fstream *relationsDB = central ? RelationBlock::centralRelationsDB : RelationBlock::relationsDB;
+    const unsigned long CHUNK_BLOCKS = 4096;
+    std::vector<char> chunk(CHUNK_BLOCKS * blockSize);
+    auto block = [&](unsigned long i) { return chunk.data() + i * blockSize; };
+    const unsigned int nodeCount = this->allocator->next(BlockFile::NODES);
+
+    // Relations and nodes are tracked by block index, relation links are written back as block addresses. Side 0 is
+    // the outgoing chain of the source, side 1 the incoming chain of the destination.
+    std::vector<unsigned int> ends(relationCount * 2, UINT_MAX);  // Node of each side, UINT_MAX for free blocks
+    std::vector<unsigned int> nextLinks(relationCount * 2, 0);
+    std::vector<unsigned int> freed;
+    relationsDB->flush();
+    for (unsigned int first = 1; first < relationCount; first += CHUNK_BLOCKS) {
+        unsigned long blocks = std::min<unsigned long>(CHUNK_BLOCKS, relationCount - first);
+        relationsDB->seekg(first * blockSize);
+        relationsDB->read(chunk.data(), blocks * blockSize);
+        for (unsigned long i = 0; i < blocks; i++) {
+            unsigned int relation = first + i;
+            if (RelationBlock::isFree(block(i))) {
+                freed.push_back(relation);
+                continue;
+            }
+            ends[relation * 2] =
+                RelationBlock::readRecord(block(i), RelationOffsets::SOURCE, central) / NodeBlock::BLOCK_SIZE;
+            ends[relation * 2 + 1] =
+                RelationBlock::readRecord(block(i), RelationOffsets::DESTINATION, central) / NodeBlock::BLOCK_SIZE;
+            nextLinks[relation * 2] =
+                RelationBlock::readRecord(block(i), RelationOffsets::SOURCE_NEXT, central) / blockSize;
+            nextLinks[relation * 2 + 1] =
+                RelationBlock::readRecord(block(i), RelationOffsets::DESTINATION_NEXT, central) / blockSize;
+        }
     }
 
-    if (stat(centralRelationsDBPath.c_str(), &stat_buf) == 0) {
-        RelationBlock::nextCentralRelationIndex = (stat_buf.st_size / RelationBlock::CENTRAL_BLOCK_SIZE)== 0 ? 1 :
-                                                (stat_buf.st_size / RelationBlock::CENTRAL_BLOCK_SIZE);
-    } else {
-        node_manager_logger.error("Error getting file size for: " + centralRelationsDBPath);
+    std::vector<unsigned int> links(relationCount * 4, 0);  // Source next, source previous, destination next/previous
+    std::vector<unsigned int> heads[2] = {std::vector<unsigned int>(nodeCount, 0),
+                                          std::vector<unsigned int>(nodeCount, 0)};
+    std::vector<unsigned int> tails(nodeCount, 0);
+    auto chained = [&](unsigned int relation, int side) { return ends[relation * 2 + side] < nodeCount; };
+    auto append = [&](unsigned int relation, int side) {
+        unsigned int nodeIndex = ends[relation * 2 + side];
+        unsigned int &tail = tails[nodeIndex];
+        if (heads[side][nodeIndex] == 0) {
+            heads[side][nodeIndex] = relation;
+        } else {
+            links[tail * 4 + side * 2] = relation;
+            links[relation * 4 + side * 2 + 1] = tail;
+        }
+        tail = relation;
+    };
+    for (int side = 0; side < 2; side++) {
+        std::fill(tails.begin(), tails.end(), 0);
+        if (inAddressOrder) {
+            for (unsigned int relation = relationCount; relation-- > 1;) {
+                if (chained(relation, side)) {
+                    append(relation, side);
+                }
+            }
+            continue;
+        }
+        // The relation a link of the chain leads to, 0 where the chain ends
+        auto next = [&](unsigned int relation) {
+            unsigned int linked = nextLinks[relation * 2 + side];
+            return linked > 0 && linked < relationCount && ends[linked * 2 + side] == ends[relation * 2 + side]
+                       ? linked
+                       : 0;
+        };
+        std::vector<bool> linkedTo(relationCount, false);
+        for (unsigned int relation = 1; relation < relationCount; relation++) {
+            if (chained(relation, side)) {
+                linkedTo[next(relation)] = true;
+            }
+        }
+        std::vector<bool> placed(relationCount, false);
+        auto follow = [&](unsigned int relation) {
+            for (; relation != 0 && !placed[relation]; relation = next(relation)) {
+                placed[relation] = true;
+                append(relation, side);
+            }
+        };
+        for (unsigned int relation = relationCount; relation-- > 1;) {
+            if (chained(relation, side) && !linkedTo[relation]) {
+                follow(relation);
+            }
+        }
+        for (unsigned int relation = 1; relation < relationCount; relation++) {
+            if (chained(relation, side) && !placed[relation]) {
+                follow(relation);
+            }
+        }
     }
-    node_manager_logger.info("Node Manager Execution Completed!");
+    std::vector<unsigned int> &outgoingHeads = heads[0];
+    std::vector<unsigned int> &incomingHeads = heads[1];
+
+    const RelationOffsets linkOffsets[] = {RelationOffsets::SOURCE_NEXT, RelationOffsets::SOURCE_PREVIOUS,
+                                           RelationOffsets::DESTINATION_NEXT, RelationOffsets::DESTINATION_PREVIOUS};
+    for (unsigned int first = 1; first < relationCount; first += CHUNK_BLOCKS) {
+        unsigned long blocks = std::min<unsigned long>(CHUNK_BLOCKS, relationCount - first);
+        relationsDB->seekg(first * blockSize);
+        relationsDB->read(chunk.data(), blocks * blockSize);
+        for (unsigned long i = 0; i < blocks; i++) {
+            if (RelationBlock::isFree(block(i))) {
+                continue;
+            }
+            const unsigned int *relationLinks = &links[(first + i) * 4];
+            for (int k = 0; k < 4; k++) {
+                RelationBlock::writeRecord(block(i), linkOffsets[k], central, relationLinks[k] * blockSize);
+            }
+        }
+        relationsDB->seekp(first * blockSize);
+        relationsDB->write(chunk.data(), blocks * blockSize);
+    }
+    relationsDB->flush();
+
+    // The outgoing relation heads are the edgeRef / centralEdgeRef records of the node blocks
+    const int headOffset = central ? NodeBlock::CENTRAL_EDGE_REF_OFFSET : NodeBlock::EDGE_REF_OFFSET;
+    for (unsigned int nodeIndex = 0; nodeIndex < outgoingHeads.size(); nodeIndex++) {
+        unsigned int head = BlockFormat::encode(outgoingHeads[nodeIndex] * blockSize, blockSize);
+        NodeBlock::nodesDB->seekp((unsigned long)nodeIndex * NodeBlock::BLOCK_SIZE + headOffset);
+        NodeBlock::nodesDB->write(reinterpret_cast<char *>(&head), sizeof(head));
+    }
+    NodeBlock::nodesDB->flush();
+    this->incomingHeads->assign(incomingHeads, central);
+    this->allocator->setFreeBlocks(central ? BlockFile::CENTRAL_RELATIONS : BlockFile::RELATIONS, freed);
+    node_manager_logger.info("Relinked " + std::to_string(relationCount - 1 - freed.size()) +
+                             (central ? " central" : " local") + " relations of " + dbPrefix);
 }
 
-std::unordered_map<std::string, unsigned int> NodeManager::readNodeIndex() {
-    std::ifstream index_db(indexDBPath, std::ios::app | std::ios::binary);
-    std::unordered_map<std::string, unsigned int> _nodeIndex;  // temporary node index data holder
-    if (index_db.is_open()) {
-        int iSize = dbSize(indexDBPath);
-        unsigned long dataWidth = NodeManager::INDEX_KEY_SIZE + sizeof(unsigned int);
-        if (iSize % dataWidth != 0) {
-            node_manager_logger.error("Index DB size does not comply to index block size Path = " + indexDBPath);
-            node_manager_logger.error("Node index DB in " + indexDBPath + " is corrupted!");
-        }
-        NodeManager::nextNodeIndex = iSize/dataWidth;
-        char nodeIDC[NodeManager::INDEX_KEY_SIZE];
-        bzero(nodeIDC, NodeManager::INDEX_KEY_SIZE);  // Fill with null chars before putting data
-        unsigned int nodeIndexId;
-        for (size_t i = 0; i < iSize / dataWidth; i++) {
-            if (!index_db.read(&nodeIDC[0], NodeManager::INDEX_KEY_SIZE)) {
-                node_manager_logger.error("Error while reading index key data from block i = " + std::to_string(i));
+namespace {
+/**
+ * New index of every relation block for a compaction, with the relations clustered by source node. Nodes are visited
+ * breadth first over the relations in both directions, starting from the nodes of highest degree, and the relations
+ * of each node are placed together in their original order. Block 0 keeps index 0, relations of nodes outside the
+ * node file go last.
+ * */
+std::vector<unsigned int> localityOrder(const std::vector<unsigned int> &sources,
+                                        const std::vector<unsigned int> &destinations, unsigned int nodeCount) {
+    const unsigned int relationCount = sources.size();
+    auto valid = [&](unsigned int relation) {
+        return sources[relation] < nodeCount && destinations[relation] < nodeCount;
+    };
+    // Relations of every node grouped by one of their ends, in ascending relation order
+    auto group = [&](const std::vector<unsigned int> &ends, std::vector<unsigned long long> &offsets,
+                     std::vector<unsigned int> &relations) {
+        offsets.assign(nodeCount + 1, 0);
+        for (unsigned int relation = 1; relation < relationCount; relation++) {
+            if (valid(relation)) {
+                offsets[ends[relation] + 1]++;
+            }
+        }
+        for (unsigned int node = 0; node < nodeCount; node++) {
+            offsets[node + 1] += offsets[node];
+        }
+        relations.resize(offsets[nodeCount]);
+        std::vector<unsigned long long> fill(offsets.begin(), offsets.end() - 1);
+        for (unsigned int relation = 1; relation < relationCount; relation++) {
+            if (valid(relation)) {
+                relations[fill[ends[relation]]++] = relation;
+            }
+        }
+    };
+    std::vector<unsigned long long> outOffsets;
+    std::vector<unsigned int> outRelations;
+    std::vector<unsigned long long> inOffsets;
+    std::vector<unsigned int> inRelations;
+    group(sources, outOffsets, outRelations);
+    group(destinations, inOffsets, inRelations);
+
+    auto degree = [&](unsigned int node) {
+        return outOffsets[node + 1] - outOffsets[node] + inOffsets[node + 1] - inOffsets[node];
+    };
+    std::vector<unsigned int> roots(nodeCount);
+    for (unsigned int node = 0; node < nodeCount; node++) {
+        roots[node] = node;
+    }
+    std::stable_sort(roots.begin(), roots.end(),
+                     [&](unsigned int a, unsigned int b) { return degree(a) > degree(b); });
+
+    std::vector<unsigned int> rows(relationCount, 0);
+    std::vector<bool> visited(nodeCount, false);
+    std::vector<unsigned int> queue;
+    queue.reserve(nodeCount);
+    unsigned int next = 1;
+    auto visit = [&](unsigned int node) {
+        if (!visited[node]) {
+            visited[node] = true;
+            queue.push_back(node);
+        }
+    };
+    size_t head = 0;
+    for (unsigned int root : roots) {
+        visit(root);
+        for (; head < queue.size(); head++) {
+            unsigned int node = queue[head];
+            for (unsigned long long i = outOffsets[node]; i < outOffsets[node + 1]; i++) {
+                rows[outRelations[i]] = next++;
+                visit(destinations[outRelations[i]]);
+            }
+            for (unsigned long long i = inOffsets[node]; i < inOffsets[node + 1]; i++) {
+                visit(sources[inRelations[i]]);
             }
-            if (!index_db.read(reinterpret_cast<char *>(&nodeIndexId), sizeof(unsigned int))) {
-                node_manager_logger.error("Error while reading index ID data from block i = " + std::to_string(i));
+        }
+    }
+    for (unsigned int relation = 1; relation < relationCount; relation++) {
+        if (!valid(relation)) {
+            rows[relation] = next++;
+        }
+    }
+    return rows;
+}
+}  // namespace
+
+/**
+ * Rewrite the local or central relation file with the relations clustered by source node, see localityOrder().
+ * Streamed relations are appended in arrival order, so the relation chain of a node spreads over the whole file and
+ * every step of a chain walk is a random read. After the compaction the relations of a node are adjacent and the
+ * chains are linked again in the new address order. Free relation blocks are dropped, the file shrinks to the
+ * relations in use.
+ *
+ * The compaction writes a copy of the relation file, and of the property columns of the relations, that replaces the
+ * original by rename. _compaction.log lists the copies once they are complete: a compaction interrupted after that is
+ * completed when the partition is opened again, one interrupted before leaves the partition as it was.
+ * */
+bool NodeManager::compactRelations(bool central) {
+    if (this->allocator->isShared()) {
+        node_manager_logger.error("Can not compact the relations of " + dbPrefix +
+                                  " while the partition is open in another NodeManager");
+        return false;
+    }
+    this->checkpoint();
+    const unsigned long blockSize = central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+    const unsigned int relationCount = this->allocator->next(central ? BlockFile::CENTRAL_RELATIONS
+                                                                     : BlockFile::RELATIONS);
+    const std::string relationsPath = dbPrefix + (central ? "_central_relations.db" : "_relations.db");
+    std::fstream *relationsDB = central ? RelationBlock::centralRelationsDB : RelationBlock::relationsDB;
+    const unsigned long CHUNK_BLOCKS = 4096;
+    std::vector<char> chunk(CHUNK_BLOCKS * blockSize);
+    auto readChunk = [&](unsigned int first, unsigned long blocks) {
+        relationsDB->seekg(first * blockSize);
+        if (!relationsDB->read(chunk.data(), blocks * blockSize)) {
+            relationsDB->clear();
+            node_manager_logger.error("Error while reading relation blocks of " + relationsPath);
+            return false;
+        }
+        return true;
+    };
+
+    std::vector<unsigned int> sources(relationCount, 0);
+    std::vector<unsigned int> destinations(relationCount, 0);
+    std::vector<bool> freed(relationCount, false);
+    for (unsigned int first = 0; first < relationCount; first += CHUNK_BLOCKS) {
+        unsigned long blocks = std::min<unsigned long>(CHUNK_BLOCKS, relationCount - first);
+        if (!readChunk(first, blocks)) {
+            return false;
+        }
+        for (unsigned long i = 0; i < blocks; i++) {
+            const char *block = chunk.data() + i * blockSize;
+            if (first + i > 0 && RelationBlock::isFree(block)) {
+                freed[first + i] = true;
+                sources[first + i] = UINT_MAX;  // Placed after the relations of nodes outside the node file
+                destinations[first + i] = UINT_MAX;
+                continue;
             }
-            _nodeIndex[std::string(nodeIDC)] = nodeIndexId;
+            sources[first + i] =
+                RelationBlock::readRecord(block, RelationOffsets::SOURCE, central) / NodeBlock::BLOCK_SIZE;
+            destinations[first + i] =
+                RelationBlock::readRecord(block, RelationOffsets::DESTINATION, central) / NodeBlock::BLOCK_SIZE;
         }
+    }
+    std::vector<unsigned int> rows = localityOrder(sources, destinations, this->allocator->next(BlockFile::NODES));
+    // Relations in use keep their order and come first, the rows of free blocks past them are not written
+    std::vector<unsigned int> relationAt(relationCount);
+    for (unsigned int relation = 0; relation < relationCount; relation++) {
+        relationAt[rows[relation]] = relation;
+    }
+    unsigned int usedCount = 0;
+    for (unsigned int row = 0; row < relationCount; row++) {
+        if (!freed[relationAt[row]]) {
+            rows[relationAt[row]] = usedCount++;
+        }
+    }
+    unsigned int freeRow = usedCount;
+    for (unsigned int row = 0; row < relationCount; row++) {
+        if (freed[relationAt[row]]) {
+            rows[relationAt[row]] = freeRow++;
+        }
+    }
+
+    // The links of the moved relations are moved with them, so the chains keep their order in the copy
+    const RelationOffsets linkOffsets[] = {RelationOffsets::SOURCE_NEXT, RelationOffsets::SOURCE_PREVIOUS,
+                                           RelationOffsets::DESTINATION_NEXT, RelationOffsets::DESTINATION_PREVIOUS};
+    std::string copyPath = relationsPath + ".compact";
+    int fd = ::open(copyPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    bool written = fd >= 0;
+    for (unsigned int first = 0; written && first < relationCount; first += CHUNK_BLOCKS) {
+        unsigned long blocks = std::min<unsigned long>(CHUNK_BLOCKS, relationCount - first);
+        written = readChunk(first, blocks);
+        for (unsigned long i = 0; written && i < blocks; i++) {
+            if (freed[first + i]) {
+                continue;
+            }
+            char *block = chunk.data() + i * blockSize;
+            for (RelationOffsets offset : linkOffsets) {
+                unsigned long linked = RelationBlock::readRecord(block, offset, central) / blockSize;
+                RelationBlock::writeRecord(block, offset, central,
+                                           linked < relationCount ? (unsigned long)rows[linked] * blockSize : 0);
+            }
+            written = pwrite(fd, block, blockSize, (off_t)rows[first + i] * blockSize) == (ssize_t)blockSize;
+        }
+    }
+    written = written && fdatasync(fd) == 0;
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    std::vector<std::pair<std::string, std::string>> copies{{copyPath, relationsPath}};
+    if (written && this->propertyStore) {
+        auto columns = this->propertyStore->renumberRows(
+            central ? PropertyOwner::CENTRAL_RELATION : PropertyOwner::LOCAL_RELATION, rows);
+        copies.insert(copies.end(), columns.begin(), columns.end());
+    }
+
+    // The log is renamed into place so that it is either complete or missing
+    std::string log = central ? "central\n" : "local\n";
+    for (const auto &copy : copies) {
+        log += copy.first + "\t" + copy.second + "\n";
+    }
+    std::string logPath = dbPrefix + "_compaction.log";
+    fd = written ? ::open((logPath + ".tmp").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) : -1;
+    written = fd >= 0 && write(fd, log.data(), log.size()) == (ssize_t)log.size() && fdatasync(fd) == 0;
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (!written || std::rename((logPath + ".tmp").c_str(), logPath.c_str()) != 0) {
+        node_manager_logger.error("Error while writing the compacted relations of " + dbPrefix);
+        for (const auto &copy : copies) {
+            std::remove(copy.first.c_str());
+        }
+        std::remove((logPath + ".tmp").c_str());
+        return false;
+    }
+
+    bool mapped = this->mappedStorage;
+    if (mapped) {
+        NodeManager::unmapBlockFiles();
+    }
+    relationsDB->close();
+    delete relationsDB;
+    NodeManager::swapCompactedFiles(dbPrefix);
+    relationsDB = NodeManager::openBlockFile(relationsPath, std::ios::in | std::ios::out);
+    if (central) {
+        RelationBlock::centralRelationsDB = relationsDB;
     } else {
-        std::string errorMessage = "Error while opening the node index DB";
-        node_manager_logger.error(errorMessage);
+        RelationBlock::relationsDB = relationsDB;
+    }
+    if (this->propertyStore) {
+        this->propertyStore->reopenColumns();
+    }
+    if (mapped) {
+        NodeManager::mapBlockFiles(dbPrefix);
+    }
+    this->allocator->initialize(central ? BlockFile::CENTRAL_RELATIONS : BlockFile::RELATIONS,
+                                std::max(usedCount, 1u), true);
+    this->finishCompaction(central);
+    this->checkpoint();
+    std::remove(logPath.c_str());
+    node_manager_logger.info("Compacted " + std::to_string(usedCount - 1) + (central ? " central" : " local") +
+                             " relations of " + dbPrefix);
+    return true;
+}
+
+/**
+ * Rename the copies listed in _compaction.log over the files they replace, copies that are gone were renamed before.
+ * Returns 1 for a compaction of the central relations, 0 for the local relations and -1 if none is pending.
+ * */
+int NodeManager::swapCompactedFiles(const std::string &dbPrefix) {
+    std::ifstream log(dbPrefix + "_compaction.log");
+    std::string relations;
+    if (!log.is_open() || !std::getline(log, relations)) {
+        return -1;
+    }
+    node_manager_logger.info("Replacing the " + relations + " relation files of " + dbPrefix + " by their compaction");
+    std::string line;
+    while (std::getline(log, line)) {
+        size_t separator = line.find('\t');
+        if (separator == std::string::npos) {
+            continue;
+        }
+        std::string copy = line.substr(0, separator);
+        std::string target = line.substr(separator + 1);
+        struct stat stat_buf;
+        if (stat(copy.c_str(), &stat_buf) == 0 && std::rename(copy.c_str(), target.c_str()) != 0) {
+            node_manager_logger.error("Error while replacing " + target + " by its compacted copy");
+        }
+    }
+    return relations == "central" ? 1 : 0;
+}
+
+/**
+ * Rebuild what refers to relation block addresses once the relation file is replaced by its compaction: the relation
+ * chains and the relation heads of the nodes, the edge index and the relationship type bitmaps.
+ * */
+void NodeManager::finishCompaction(bool central) {
+    const unsigned long blockSize = central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+    const unsigned int relationCount = this->allocator->next(central ? BlockFile::CENTRAL_RELATIONS
+                                                                     : BlockFile::RELATIONS);
+    const std::string relationsPath = dbPrefix + (central ? "_central_relations.db" : "_relations.db");
+    std::fstream *relationsDB = central ? RelationBlock::centralRelationsDB : RelationBlock::relationsDB;
+    const int typeOffset = (central ? RelationBlock::CENTRAL_RELATIONSHIP_TYPE_OFFSET
+                                    : RelationBlock::LOCAL_RELATIONSHIP_TYPE_OFFSET) * RelationBlock::RECORD_SIZE;
+
+    std::vector<unsigned int> types(relationCount, 0);
+    std::vector<char> block(blockSize);
+    relationsDB->seekg(blockSize);
+    for (unsigned int relation = 1; relation < relationCount; relation++) {
+        if (!relationsDB->read(block.data(), blockSize)) {
+            relationsDB->clear();
+            node_manager_logger.error("Error while reading relation types of " + relationsPath);
+            break;
+        }
+        std::memcpy(&types[relation], block.data() + typeOffset, sizeof(unsigned int));
     }
+    this->relationTypeIndex->rebuild(central, types);
+    (central ? this->centralEdgeIndex : this->localEdgeIndex)->rebuild(relationsPath, blockSize);
+    this->relinkRelations(central);
+    BlockCache::getInstance()->invalidate(this->cachePartition);
+}
 
-    index_db.close();
-    return _nodeIndex;
+/**
+ * Index the labels of the partition's nodes, for partitions written before the label index was introduced. Nodes that
+ * were never given a label carry their ID in the label field.
+ * */
+void NodeManager::rebuildLabelIndex() {
+    node_manager_logger.info("Building the label index of " + this->dbPrefix);
+    char block[NodeBlock::BLOCK_SIZE];
+    for (auto it : *this->nodeIndex) {
+        unsigned long blockAddress = (unsigned long)it.second * NodeBlock::BLOCK_SIZE;
+        if (!NodeBlock::readBlock(blockAddress, block)) {
+            continue;
+        }
+        NodeBlock *node = NodeBlock::decode(it.first, blockAddress, block);
+        std::string label(node->label, strnlen(node->label, NodeBlock::LABEL_SIZE));
+        if (!label.empty() && label != it.first.substr(0, NodeBlock::LABEL_SIZE)) {
+            this->labelIndex->add(label, it.second);
+        }
+        delete node;
+    }
+}
+
+bool NodeManager::createPropertyIndex(const std::string &property, PropertyIndexType type) {
+    if (!this->propertyIndex->create(property, type)) {
+        return false;
+    }
+    node_manager_logger.info("Indexing property " + property + " of " + this->dbPrefix);
+    for (auto it : *this->nodeIndex) {
+        NodeBlock *node = NodeBlock::get(it.second * NodeBlock::BLOCK_SIZE);
+        if (!node) {
+            continue;
+        }
+        PropertyValue value;
+        if (node->getProperty(property, value)) {
+            this->propertyIndex->insert(property, value, it.second);
+        }
+        delete node;
+    }
+    this->propertyIndex->flush();
+    return true;
 }
 
 RelationBlock *NodeManager::addLocalRelation(NodeBlock source, NodeBlock destination) {
     RelationBlock *newRelation = NULL;
-    if (source.edgeRef == 0 || destination.edgeRef == 0 ||
-        !source.searchLocalRelation(destination)) {  // certainly a new relation block needed
+    if (!this->localEdgeIndex->find(source.addr, destination.addr)) {  // certainly a new relation block needed
         RelationBlock *relationBlock = new RelationBlock(source, destination);
         newRelation = relationBlock->addLocalRelation(source, destination);
         if (newRelation) {
             source.updateLocalRelation(newRelation, true);
-            destination.updateLocalRelation(newRelation, true);
+            if (destination.addr != source.addr) {  // A self loop was linked into both chains of its node
+                destination.updateLocalRelation(newRelation, true);
+            }
+            this->localEdgeIndex->insert(source.addr, destination.addr, newRelation->addr);
+            this->nodeDegrees->addRelation(source.addr / NodeBlock::BLOCK_SIZE,
+                                           destination.addr / NodeBlock::BLOCK_SIZE, false);
         } else {
             node_manager_logger.error("Error while adding the new edge/relation for source = " +
                                       std::string(source.id) + " destination = " + std::string(destination.id));
@@ -227,13 +838,17 @@ RelationBlock *NodeManager::addLocalRelation(NodeBlock source, NodeBlock destina
 
 RelationBlock *NodeManager::addCentralRelation(NodeBlock source, NodeBlock destination) {
     RelationBlock *newRelation = NULL;
-    if (source.centralEdgeRef == 0 || destination.centralEdgeRef == 0 ||
-        !source.searchCentralRelation(destination)) {  // certainly a new relation block needed
+    if (!this->centralEdgeIndex->find(source.addr, destination.addr)) {  // certainly a new relation block needed
         RelationBlock *relationBlock = new RelationBlock(source, destination);
         newRelation = relationBlock->addCentralRelation(source, destination);
         if (newRelation) {
             source.updateCentralRelation(newRelation, true);
-            destination.updateCentralRelation(newRelation, true);
+            if (destination.addr != source.addr) {
+                destination.updateCentralRelation(newRelation, true);
+            }
+            this->centralEdgeIndex->insert(source.addr, destination.addr, newRelation->addr);
+            this->nodeDegrees->addRelation(source.addr / NodeBlock::BLOCK_SIZE,
+                                           destination.addr / NodeBlock::BLOCK_SIZE, true);
         } else {
             node_manager_logger.error("Error while adding the new edge/relation for source = " +
                                       std::string(source.id) + " destination = " + std::string(destination.id));
@@ -249,15 +864,20 @@ RelationBlock *NodeManager::addCentralRelation(NodeBlock source, NodeBlock desti
 }
 
 NodeBlock *NodeManager::addNode(std::string nodeId) {
-    unsigned int assignedNodeIndex;
-    node_manager_logger.debug("Adding node index " + std::to_string(this->nextNodeIndex));
-    if (this->nodeIndex.find(nodeId) == this->nodeIndex.end()) {
+    std::lock_guard<std::mutex> guard(this->allocator->nodeLock(nodeId));
+    return this->createNode(nodeId);
+}
+
+// Find or create the node, the caller holds the lock stripe of the node ID
+NodeBlock *NodeManager::createNode(const std::string &nodeId) {
+    unsigned int nodeIndex;
+    if (!this->nodeIndex->find(nodeId, nodeIndex)) {
         node_manager_logger.debug("Can't find NodeId (" + nodeId + ") in the index database");
         unsigned int vertexId = std::stoul(nodeId);
-        NodeBlock *sourceBlk = new NodeBlock(nodeId, vertexId, this->nextNodeIndex * NodeBlock::BLOCK_SIZE);
-        this->addNodeIndex(nodeId, this->nextNodeIndex);
-        assignedNodeIndex = this->nextNodeIndex;
-        this->nextNodeIndex++;
+        nodeIndex = this->allocator->allocate(BlockFile::NODES);
+        node_manager_logger.debug("Adding node index " + std::to_string(nodeIndex));
+        NodeBlock *sourceBlk = new NodeBlock(nodeId, vertexId, nodeIndex * NodeBlock::BLOCK_SIZE);
+        this->nodeIndex->insert(nodeId, nodeIndex);
         sourceBlk->setLabel(nodeId.c_str());
         sourceBlk->save();
         return sourceBlk;
@@ -267,16 +887,16 @@ NodeBlock *NodeManager::addNode(std::string nodeId) {
 }
 
 RelationBlock *NodeManager::addLocalEdge(std::pair<std::string, std::string> edge) {
-    pthread_mutex_lock(&lockEdgeAdd);
+    this->allocator->lockNodes(edge.first, edge.second);
 
-    NodeBlock *sourceNode = this->addNode(edge.first);
-    NodeBlock *destNode = this->addNode(edge.second);
+    NodeBlock *sourceNode = this->createNode(edge.first);
+    NodeBlock *destNode = this->createNode(edge.second);
     RelationBlock *newRelation = this->addLocalRelation(*sourceNode, *destNode);
     if (newRelation) {
         newRelation->setDestination(destNode);
         newRelation->setSource(sourceNode);
     }
-    pthread_mutex_unlock(&lockEdgeAdd);
+    this->allocator->unlockNodes(edge.first, edge.second);
 
     node_manager_logger.debug("DEBUG: Source DB block address " + std::to_string(sourceNode->addr) +
                               " Destination DB block address " + std::to_string(destNode->addr));
@@ -284,42 +904,415 @@ RelationBlock *NodeManager::addLocalEdge(std::pair<std::string, std::string> edg
 }
 
 RelationBlock *NodeManager::addCentralEdge(std::pair<std::string, std::string> edge) {
-    //    std::unique_lock<std::mutex> guard1(lockCentralEdgeAdd);
-    //
-    //    guard1.lock();
-    pthread_mutex_lock(&lockEdgeAdd);
+    this->allocator->lockNodes(edge.first, edge.second);
 
-    NodeBlock *sourceNode = this->addNode(edge.first);
-    NodeBlock *destNode = this->addNode(edge.second);
+    NodeBlock *sourceNode = this->createNode(edge.first);
+    NodeBlock *destNode = this->createNode(edge.second);
     RelationBlock *newRelation = this->addCentralRelation(*sourceNode, *destNode);
     if (newRelation) {
         newRelation->setDestination(destNode);
         newRelation->setSource(sourceNode);
     }
-    pthread_mutex_unlock(&lockEdgeAdd);
+    this->allocator->unlockNodes(edge.first, edge.second);
 
-    //    guard1.unlock();
     node_manager_logger.debug("DEBUG: Source DB block address " + std::to_string(sourceNode->addr) +
                               " Destination DB block address " + std::to_string(destNode->addr));
     return newRelation;
 }
 
-void NodeManager::addNodeIndex(std::string nodeId, unsigned int nodeIndex) {
-    this->nodeIndex.insert({nodeId, this->nextNodeIndex});
+namespace {
+// A node touched by an edge batch, with the heads of its outgoing and incoming local or central relation chains
+struct BatchNode {
+    NodeBlock *block;
+    unsigned long outgoingHead;
+    unsigned long incomingHead;
+    bool isNew;
+    bool outgoingHeadChanged;
+    bool incomingHeadChanged;
+};
+
+// Previous pointer of a relation that was already on disk, set in the second pass of a batch
+struct PreviousLink {
+    unsigned long relationAddress;
+    bool outgoing;  // Whether the pointer is in the source records, else in the destination records
+    unsigned long previousAddress;
+};
+}  // namespace
+
+/**
+ * Add a batch of local or central edges while holding every node lock stripe of the partition.
+ *
+ * The nodes of the batch are resolved or allocated first. New relations then get one contiguous range of relation
+ * blocks, and their records, including the relation chain pointers, are built in memory. The range is written with
+ * one sequential write. A second pass updates the chain heads of the nodes and the previous pointers of relations that
+ * were already on disk. Relations are linked in the same order as addLocalEdge() / addCentralEdge() would link them.
+ *
+ * Returns the relation block address of every edge in input order, 0 for edges that already exist or failed.
+ * */
+std::vector<unsigned long> NodeManager::addEdges(const std::vector<std::pair<std::string, std::string>> &edges,
+                                                 bool central) {
+    std::vector<unsigned long> addresses(edges.size(), 0);
+    if (edges.empty()) {
+        return addresses;
+    }
+    const unsigned long blockSize = central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+    const unsigned int recordCount = central ? RelationBlock::NUMBER_OF_CENTRAL_RELATION_RECORDS
+                                             : RelationBlock::NUMBER_OF_LOCAL_RELATION_RECORDS;
+    EdgeIndex *edgeIndex = central ? this->centralEdgeIndex : this->localEdgeIndex;
+    std::fstream *relationsDB = central ? RelationBlock::centralRelationsDB : RelationBlock::relationsDB;
+    const BlockFile relationsFile = central ? BlockFile::CENTRAL_RELATIONS : BlockFile::RELATIONS;
+
+    // Relation blocks are only allocated under node locks, so the range from the end of the file stays free until the
+    // batch appends it. Free blocks of deleted relations are left to single inserts
+    this->allocator->lockAll();
+    std::unordered_map<std::string, size_t> nodePositions;
+    std::vector<BatchNode> nodes;
+    auto resolve = [&](const std::string &id) -> size_t {
+        auto it = nodePositions.find(id);
+        if (it != nodePositions.end()) {
+            return it->second;
+        }
+        BatchNode node{NULL, 0, 0, false, false, false};
+        unsigned int index;
+        if (this->nodeIndex->find(id, index)) {
+            char block[NodeBlock::BLOCK_SIZE];
+            unsigned long nodeAddress = (unsigned long)index * NodeBlock::BLOCK_SIZE;
+            if (NodeBlock::readBlock(nodeAddress, block)) {
+                node.block = NodeBlock::decode(id, nodeAddress, block);
+                node.outgoingHead = central ? node.block->centralEdgeRef : node.block->edgeRef;
+                node.incomingHead = this->incomingHeads->get(index, central);
+            }
+        } else {
+            unsigned int vertexId = std::stoul(id);
+            index = this->allocator->allocate(BlockFile::NODES);
+            node.block = new NodeBlock(id, vertexId, (unsigned long)index * NodeBlock::BLOCK_SIZE);
+            node.block->setLabel(id.c_str());
+            node.isNew = true;
+            this->nodeIndex->insert(id, index);
+        }
+        nodePositions[id] = nodes.size();
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    };
+
+    const unsigned long firstAddress = this->allocator->next(relationsFile) * blockSize;
+    std::vector<unsigned long> records;  // recordCount records of each new relation, encoded when they are written
+    std::vector<PreviousLink> previousLinks;
+    auto record = [&](unsigned long relationAddress, RelationOffsets offset) -> unsigned long & {
+        return records[(relationAddress - firstAddress) / blockSize * recordCount + static_cast<int>(offset)];
+    };
+    // Insert the relation at the head of the node's outgoing or incoming relation chain
+    auto link = [&](BatchNode &node, unsigned long relationAddress, bool isSource) {
+        unsigned long &head = isSource ? node.outgoingHead : node.incomingHead;
+        if (head != 0) {
+            if (head >= firstAddress) {
+                record(head, isSource ? RelationOffsets::SOURCE_PREVIOUS : RelationOffsets::DESTINATION_PREVIOUS) =
+                    relationAddress;
+            } else {
+                previousLinks.push_back({head, isSource, relationAddress});
+            }
+            record(relationAddress, isSource ? RelationOffsets::SOURCE_NEXT : RelationOffsets::DESTINATION_NEXT) =
+                head;
+        }
+        head = relationAddress;
+        (isSource ? node.outgoingHeadChanged : node.incomingHeadChanged) = true;
+    };
+
+    unsigned int newRelations = 0;
+    for (size_t i = 0; i < edges.size(); i++) {
+        size_t source;
+        size_t destination;
+        try {
+            source = resolve(edges[i].first);
+            destination = resolve(edges[i].second);
+        } catch (const std::exception &e) {
+            node_manager_logger.error("Invalid node ID in edge (" + edges[i].first + ", " + edges[i].second + ")");
+            continue;
+        }
+        if (!nodes[source].block || !nodes[destination].block) {
+            node_manager_logger.error("Error while reading the nodes of edge (" + edges[i].first + ", " +
+                                      edges[i].second + ")");
+            continue;
+        }
+        unsigned long sourceAddress = nodes[source].block->addr;
+        unsigned long destinationAddress = nodes[destination].block->addr;
+        if (edgeIndex->find(sourceAddress, destinationAddress)) {
+            continue;
+        }
+        unsigned long relationAddress = firstAddress + newRelations * blockSize;
+        newRelations++;
+        records.resize(newRelations * recordCount, 0);
+        record(relationAddress, RelationOffsets::SOURCE_ID) = nodes[source].block->nodeId;
+        record(relationAddress, RelationOffsets::DESTINATION_ID) = nodes[destination].block->nodeId;
+        record(relationAddress, RelationOffsets::SOURCE) = sourceAddress;
+        record(relationAddress, RelationOffsets::DESTINATION) = destinationAddress;
+        link(nodes[source], relationAddress, true);
+        link(nodes[destination], relationAddress, false);
+        edgeIndex->insert(sourceAddress, destinationAddress, relationAddress);
+        this->nodeDegrees->addRelation(sourceAddress / NodeBlock::BLOCK_SIZE,
+                                       destinationAddress / NodeBlock::BLOCK_SIZE, central);
+        addresses[i] = relationAddress;
+    }
 
-    std::ofstream index_db(indexDBPath, std::ios::app | std::ios::binary);
-    if (index_db.is_open()) {
-        char nodeIDC[NodeManager::INDEX_KEY_SIZE] = {0};  // Initialize with null chars
-        std::strcpy(nodeIDC, nodeId.c_str());
-        index_db.write(nodeIDC, sizeof(nodeIDC));
-        index_db.write(reinterpret_cast<char *>(&nodeIndex), sizeof(unsigned int));
-        index_db.flush();
-        node_manager_logger.debug("Writing node index --> Node key = " +
-                                  std::string(nodeIDC) + ", value = " + std::to_string(nodeIndex));
+    // The records are followed by the type field, type ID 0
+    std::vector<char> blocks(newRelations * blockSize, 0);
+    for (unsigned long i = 0; i < newRelations; i++) {
+        for (unsigned int k = 0; k < recordCount; k++) {
+            RelationBlock::writeRecord(blocks.data() + i * blockSize, static_cast<RelationOffsets>(k), central,
+                                       records[i * recordCount + k]);
+        }
+    }
+    StorageMetrics::recordWrite(BlockFile::RELATIONS, blocks.size());
+    relationsDB->seekp(firstAddress);
+    if (!relationsDB->write(blocks.data(), blocks.size())) {
+        node_manager_logger.error("Error while writing " + std::to_string(newRelations) + " relation blocks at " +
+                                  std::to_string(firstAddress));
+    }
+    relationsDB->flush();
+    this->allocator->append(relationsFile, newRelations);
+
+    for (auto &previous : previousLinks) {
+        RelationBlock *relation = central ? RelationBlock::getCentralRelation(previous.relationAddress)
+                                          : RelationBlock::getLocalRelation(previous.relationAddress);
+        if (!relation) {
+            continue;
+        }
+        if (central) {
+            previous.outgoing ? relation->setCentralPreviousSource(previous.previousAddress)
+                              : relation->setCentralPreviousDestination(previous.previousAddress);
+        } else {
+            previous.outgoing ? relation->setLocalPreviousSource(previous.previousAddress)
+                              : relation->setLocalPreviousDestination(previous.previousAddress);
+        }
+        delete relation;
+    }
+    for (auto &node : nodes) {
+        if (node.isNew) {
+            (central ? node.block->centralEdgeRef : node.block->edgeRef) = node.outgoingHead;
+            node.block->save();
+        } else if (node.block && node.outgoingHeadChanged) {
+            central ? node.block->setCentralRelationHead(node.outgoingHead)
+                    : node.block->setLocalRelationHead(node.outgoingHead);
+        }
+        if (node.block && node.incomingHeadChanged) {
+            this->incomingHeads->set(node.block->addr / NodeBlock::BLOCK_SIZE, central, node.incomingHead);
+        }
+        delete node.block;
+    }
+    this->allocator->unlockAll();
+    return addresses;
+}
+
+namespace {
+/**
+ * Zero the property blocks of a chain and return them to the allocator. The walk stops at a block index the file does
+ * not have, so a damaged next record can not loop.
+ * */
+void freePropertyChain(BlockAllocator *allocator, BlockFile file, unsigned long head) {
+    unsigned long blockSize;
+    bool (*readBlock)(unsigned long, char *);
+    std::fstream *propertiesDB;
+    switch (file) {
+        case BlockFile::PROPERTIES:
+            blockSize = PropertyLink::PROPERTY_BLOCK_SIZE;
+            readBlock = PropertyLink::readBlock;
+            propertiesDB = PropertyLink::propertiesDB;
+            break;
+        case BlockFile::META_PROPERTIES:
+            blockSize = MetaPropertyLink::META_PROPERTY_BLOCK_SIZE;
+            readBlock = MetaPropertyLink::readBlock;
+            propertiesDB = MetaPropertyLink::metaPropertiesDB;
+            break;
+        case BlockFile::EDGE_PROPERTIES:
+            blockSize = PropertyEdgeLink::PROPERTY_BLOCK_SIZE;
+            readBlock = PropertyEdgeLink::readBlock;
+            propertiesDB = PropertyEdgeLink::edgePropertiesDB;
+            break;
+        case BlockFile::META_EDGE_PROPERTIES:
+            blockSize = MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE;
+            readBlock = MetaPropertyEdgeLink::readBlock;
+            propertiesDB = MetaPropertyEdgeLink::metaEdgePropertiesDB;
+            break;
+        default:
+            return;
+    }
+    if (!propertiesDB) {
+        return;
+    }
+    std::vector<char> block(blockSize);
+    const std::vector<char> empty(blockSize, 0);
+    unsigned int blocks = allocator->next(file);
+    for (unsigned int freed = 0; head != 0 && head / blockSize < blocks && freed < blocks; freed++) {
+        if (!readBlock(head, block.data())) {
+            node_manager_logger.error("Error while reading property block " + std::to_string(head));
+            break;
+        }
+        // The next record closes every property block
+        unsigned int nextRecord;
+        std::memcpy(&nextRecord, block.data() + blockSize - sizeof(nextRecord), sizeof(nextRecord));
+        propertiesDB->seekp(head);
+        propertiesDB->write(empty.data(), blockSize);
+        allocator->free(file, head / blockSize);
+        head = BlockFormat::decode(nextRecord, blockSize);
+    }
+    propertiesDB->flush();
+}
+}  // namespace
+
+/**
+ * Unlink a relation from the outgoing chain of its source and the incoming chain of its destination, drop it from the
+ * edge index, the degree counters and the type index, and free its relation block and property blocks. The caller
+ * holds the lock stripes of both nodes.
+ * */
+void NodeManager::removeRelation(const RelationView &relation) {
+    const bool central = relation.central;
+    const unsigned long blockSize = central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+    const NodeRelation &source = relation.source;
+    const NodeRelation &destination = relation.destination;
+    // Point the next or previous record of a neighbor in the outgoing (source records) or incoming chain at address
+    auto relink = [central](unsigned long neighbor, bool outgoing, bool next, unsigned long address) {
+        RelationBlock *block = central ? RelationBlock::getCentralRelation(neighbor)
+                                       : RelationBlock::getLocalRelation(neighbor);
+        if (!block) {
+            return;
+        }
+        if (outgoing && next) {
+            central ? block->setCentralNextSource(address) : block->setLocalNextSource(address);
+        } else if (outgoing) {
+            central ? block->setCentralPreviousSource(address) : block->setLocalPreviousSource(address);
+        } else if (next) {
+            central ? block->setCentralNextDestination(address) : block->setLocalNextDestination(address);
+        } else {
+            central ? block->setCentralPreviousDestination(address) : block->setLocalPreviousDestination(address);
+        }
+        delete block;
+    };
+
+    if (source.preRelationId != 0) {
+        relink(source.preRelationId, true, true, source.nextRelationId);
     } else {
-        node_manager_logger.error("Failed to open index database file.");
+        NodeBlock *sourceNode = NodeBlock::get(source.address);
+        if (sourceNode) {
+            central ? sourceNode->setCentralRelationHead(source.nextRelationId)
+                    : sourceNode->setLocalRelationHead(source.nextRelationId);
+            delete sourceNode;
+        }
+    }
+    if (source.nextRelationId != 0) {
+        relink(source.nextRelationId, true, false, source.preRelationId);
+    }
+    if (destination.preRelationId != 0) {
+        relink(destination.preRelationId, false, true, destination.nextRelationId);
+    } else {
+        this->incomingHeads->set(destination.address / NodeBlock::BLOCK_SIZE, central, destination.nextRelationId);
+    }
+    if (destination.nextRelationId != 0) {
+        relink(destination.nextRelationId, false, false, destination.preRelationId);
+    }
+
+    freePropertyChain(this->allocator, BlockFile::EDGE_PROPERTIES, relation.propertyAddress);
+    if (central) {
+        freePropertyChain(this->allocator, BlockFile::META_EDGE_PROPERTIES, relation.metaPropertyAddress);
+    }
+    if (this->propertyStore) {
+        this->propertyStore->clear(central ? PropertyOwner::CENTRAL_RELATION : PropertyOwner::LOCAL_RELATION,
+                                   relation.addr / blockSize);
+    }
+    if (relation.typeId != 0) {
+        this->relationTypeIndex->remove(relation.typeId, central, relation.addr / blockSize);
+    }
+    (central ? this->centralEdgeIndex : this->localEdgeIndex)->remove(source.address, destination.address,
+                                                                      relation.addr);
+    this->nodeDegrees->removeRelation(source.address / NodeBlock::BLOCK_SIZE,
+                                      destination.address / NodeBlock::BLOCK_SIZE, central);
+    if (RelationBlock::writeFreeBlock(relation.addr, central)) {
+        this->allocator->free(central ? BlockFile::CENTRAL_RELATIONS : BlockFile::RELATIONS, relation.addr / blockSize);
+    }
+}
+
+bool NodeManager::deleteEdge(const std::string &source, const std::string &destination) {
+    this->allocator->lockNodes(source, destination);
+    unsigned int sourceIndex;
+    unsigned int destinationIndex;
+    bool deleted = false;
+    if (this->nodeIndex->find(source, sourceIndex) && this->nodeIndex->find(destination, destinationIndex)) {
+        unsigned long sourceAddress = (unsigned long)sourceIndex * NodeBlock::BLOCK_SIZE;
+        unsigned long destinationAddress = (unsigned long)destinationIndex * NodeBlock::BLOCK_SIZE;
+        for (bool central : {false, true}) {
+            EdgeIndex *edgeIndex = central ? this->centralEdgeIndex : this->localEdgeIndex;
+            unsigned long relationAddress = edgeIndex->find(sourceAddress, destinationAddress);
+            RelationView relation;
+            if (relationAddress != 0 && RelationView::read(relationAddress, central, relation)) {
+                this->removeRelation(relation);
+                deleted = true;
+                break;
+            }
+        }
     }
-    index_db.close();
+    this->allocator->unlockNodes(source, destination);
+    return deleted;
+}
+
+/**
+ * Delete a node, and with detach set its relations, from the partition. The node block is zeroed and its index entry
+ * removed, its properties and labels are dropped. Node blocks are not handed out again because property indexes refer
+ * to nodes by block index, the index scans skip blocks that are not in use.
+ * */
+bool NodeManager::deleteNode(const std::string &nodeId, bool detach) {
+    this->allocator->lockAll();
+    unsigned int index;
+    if (!this->nodeIndex->find(nodeId, index)) {
+        this->allocator->unlockAll();
+        return false;
+    }
+    const unsigned long nodeAddress = (unsigned long)index * NodeBlock::BLOCK_SIZE;
+    if (this->nodeDegrees->get(index).total() > 0) {
+        if (!detach) {
+            node_manager_logger.error("Can not delete node " + nodeId + " of " + dbPrefix +
+                                      " while it has relationships, use DETACH DELETE");
+            this->allocator->unlockAll();
+            return false;
+        }
+        for (bool central : {false, true}) {
+            std::vector<unsigned long> relations;
+            this->forEachNeighbor(nodeAddress, central, [&](const RelationView &relation) {
+                if (std::find(relations.begin(), relations.end(), relation.addr) == relations.end()) {
+                    relations.push_back(relation.addr);  // A self loop is in both chains of the node
+                }
+            });
+            for (unsigned long address : relations) {
+                RelationView relation;
+                if (RelationView::read(address, central, relation)) {
+                    this->removeRelation(relation);
+                }
+            }
+        }
+    }
+
+    char block[NodeBlock::BLOCK_SIZE] = {0};
+    if (NodeBlock::readBlock(nodeAddress, block)) {
+        NodeBlock *node = NodeBlock::decode(nodeId, nodeAddress, block);
+        freePropertyChain(this->allocator, BlockFile::PROPERTIES, node->propRef);
+        freePropertyChain(this->allocator, BlockFile::META_PROPERTIES, node->metaPropRef);
+        std::string label(node->label, strnlen(node->label, NodeBlock::LABEL_SIZE));
+        if (!label.empty() && label != nodeId.substr(0, NodeBlock::LABEL_SIZE)) {
+            this->labelIndex->remove(label, index);
+        }
+        delete node;
+    }
+    if (this->propertyStore) {
+        this->propertyStore->clear(PropertyOwner::NODE, index);
+    }
+    std::memset(block, 0, NodeBlock::BLOCK_SIZE);
+    NodeBlock::nodesDB->seekp(nodeAddress);
+    NodeBlock::nodesDB->write(block, NodeBlock::BLOCK_SIZE);
+    NodeBlock::nodesDB->flush();
+    BlockCache::getInstance()->update(BlockFile::NODES, nodeAddress, 0, block, NodeBlock::BLOCK_SIZE);
+    this->incomingHeads->set(index, false, 0);
+    this->incomingHeads->set(index, true, 0);
+    bool removed = this->nodeIndex->remove(nodeId);
+    this->allocator->unlockAll();
+    return removed;
 }
 
 int NodeManager::dbSize(std::string path) {
@@ -357,90 +1350,26 @@ int NodeManager::dbSize(std::string path) {
  **/
 NodeBlock *NodeManager::get(std::string nodeId) {
     NodeBlock *nodeBlockPointer = NULL;
-    if (this->nodeIndex.find(nodeId) == this->nodeIndex.end()) {  // Not found
+    unsigned int nodeIndex;
+    if (!this->nodeIndex->find(nodeId, nodeIndex)) {  // Not found
         return nodeBlockPointer;
     }
-    unsigned int nodeIndex = this->nodeIndex[nodeId];
-    const unsigned int blockAddress = nodeIndex * NodeBlock::BLOCK_SIZE;
-    NodeBlock::nodesDB->seekg(blockAddress);
-    unsigned int vertexId;
-    unsigned int edgeRef;
-    unsigned int centralEdgeRef;
-    unsigned char edgeRefPID;
-    unsigned int propRef;
-    unsigned int metaPropRef;
-    char usageBlock;
-    char label[NodeBlock::LABEL_SIZE];
-
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char *>(&usageBlock), sizeof(unsigned char))) {
-        node_manager_logger.error("Error while reading usage data from block " + std::to_string(blockAddress));
-    }
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char *>(&vertexId), sizeof(unsigned int))) {
-        node_manager_logger.error("Error while reading nodeId  data from block " + std::to_string(blockAddress));
-    }
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char *>(&edgeRef), sizeof(unsigned int))) {
-        node_manager_logger.error("Error while reading edge reference data from block " + std::to_string(blockAddress));
+    const unsigned long blockAddress = (unsigned long)nodeIndex * NodeBlock::BLOCK_SIZE;
+    char block[NodeBlock::BLOCK_SIZE] = {0};
+    if (!NodeBlock::readBlock(blockAddress, block)) {
+        node_manager_logger.error("Error while reading node block data from block " + std::to_string(blockAddress));
     }
-
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char *>(&centralEdgeRef), sizeof(unsigned int))) {
-        node_manager_logger.error("Error while reading central edge reference data from block " +
-                                  std::to_string(blockAddress));
-    }
-
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char *>(&edgeRefPID), sizeof(unsigned char))) {
-        node_manager_logger.error("Error while reading usage data from block " + std::to_string(blockAddress));
-    }
-
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char *>(&propRef), sizeof(unsigned int))) {
-        node_manager_logger.error("Error while reading prop reference data from block " + std::to_string(blockAddress));
-    }
-
-    if (!NodeBlock::nodesDB->read(reinterpret_cast<char *>(&metaPropRef), sizeof(unsigned int))) {
-        node_manager_logger.error("Error while reading prop reference data from block " + std::to_string(blockAddress));
-    }
-
-    if (!NodeBlock::nodesDB->read(&label[0], NodeBlock::LABEL_SIZE)) {
-        node_manager_logger.error("Error while reading label data from block " + std::to_string(blockAddress));
-    }
-    bool usage = usageBlock == '\1';
-    node_manager_logger.debug("Label = " + std::string(label));
-    node_manager_logger.debug("Length of label = " + std::to_string(strlen(label)));
-    node_manager_logger.debug("DEBUG: raw edgeRef from DB (disk) " + std::to_string(edgeRef));
-
-    nodeBlockPointer = new NodeBlock(nodeId, vertexId, blockAddress, propRef, metaPropRef, edgeRef,
-                                     centralEdgeRef, edgeRefPID, label, usage);
-
-    node_manager_logger.debug("DEBUG: nodeBlockPointer after creating the object edgeRef " +
-                              std::to_string(nodeBlockPointer->edgeRef));
+    nodeBlockPointer = NodeBlock::decode(nodeId, blockAddress, block);
+    node_manager_logger.debug("Label = " + std::string(nodeBlockPointer->label));
+    node_manager_logger.debug("DEBUG: raw edgeRef from DB (disk) " + std::to_string(nodeBlockPointer->edgeRef));
 
     if (nodeBlockPointer->edgeRef % RelationBlock::BLOCK_SIZE != 0) {
-        node_manager_logger.error("Exception: Invalid edge reference address = " + nodeBlockPointer->edgeRef);
+        node_manager_logger.error("Exception: Invalid edge reference address = " +
+                                  std::to_string(nodeBlockPointer->edgeRef));
     }
     return nodeBlockPointer;
 }
 
-void NodeManager::persistNodeIndex() {
-    std::ofstream index_db(indexDBPath, std::ios::trunc | std::ios::binary);
-    if (index_db.is_open()) {
-        if (this->nodeIndex.size() > 0 && (this->nodeIndex.begin()->first.length() > NodeManager::INDEX_KEY_SIZE)) {
-            node_manager_logger.error("Node label/ID is longer ( " +
-                                      std::to_string(this->nodeIndex.begin()->first.length()) +
-                                      " ) than the index key size " + std::to_string(NodeManager::INDEX_KEY_SIZE));
-            node_manager_logger.error("Node label/ID is longer than the index key size!");
-        }
-        for (auto nodeMap : this->nodeIndex) {
-            char nodeIDC[NodeManager::INDEX_KEY_SIZE] = {0};  // Initialize with null chars
-            std::strcpy(nodeIDC, nodeMap.first.c_str());
-            index_db.write(nodeIDC, sizeof(nodeIDC));
-            unsigned int nodeBlockIndex = nodeMap.second;
-            index_db.write(reinterpret_cast<char *>(&(nodeBlockIndex)), sizeof(unsigned int));
-            node_manager_logger.debug("Writing node index --> Node key = " + std::string(nodeIDC) + " value " +
-                                      std::to_string(nodeBlockIndex));
-        }
-    }
-    index_db.close();
-}
-
 /**
  * Return the number of nodes upto the limit given in the arg from nodes index
  * Default limit is 10
@@ -448,7 +1377,7 @@ void NodeManager::persistNodeIndex() {
 std::list<NodeBlock> NodeManager::getLimitedGraph(int limit) {
     int i = 0;
     std::list<NodeBlock> vertices;
-    for (auto it : this->nodeIndex) {
+    for (auto it : *this->nodeIndex) {
         i++;
         if (i > limit) {
             break;
@@ -465,7 +1394,7 @@ std::list<NodeBlock> NodeManager::getLimitedGraph(int limit) {
  * */
 std::list<NodeBlock*> NodeManager::getGraph() {
     std::list<NodeBlock*> vertices;
-    for (auto it : this->nodeIndex) {
+    for (auto it : *this->nodeIndex) {
         auto nodeId = it.first;
         NodeBlock *node = this->get(nodeId);
         vertices.push_back(node);
@@ -480,10 +1409,10 @@ std::list<NodeBlock*> NodeManager::getGraph() {
  * */
 std::list<NodeBlock*> NodeManager::getCentralGraph() {
     std::list<NodeBlock*> vertices;
-    for (auto it : this->nodeIndex) {
+    for (auto it : *this->nodeIndex) {
         auto nodeId = it.first;
         NodeBlock *node = this->get(nodeId);
-        if (node->getCentralRelationHead()) {
+        if (node->centralEdgeRef != 0 || this->incomingHeads->get(it.second, true) != 0) {
             vertices.push_back(node);
         }
         node_manager_logger.debug("Read node index for central node " + nodeId + " with node index " +
@@ -492,66 +1421,261 @@ std::list<NodeBlock*> NodeManager::getCentralGraph() {
     return vertices;
 }
 
-// Get adjacency list for the graph
-std::map<long, std::unordered_set<long>> NodeManager::getAdjacencyList() {
-    map<long, std::unordered_set<long>> adjacencyList;
-    for (auto it : this->nodeIndex) {
-        auto nodeId = it.first;
-        NodeBlock *node = this->get(nodeId);
-        std::unordered_set<long> neighbors;
-        std::list<NodeBlock*> neighborNodes = node->getAllEdgeNodes();
+/**
+ * Collect the (source, destination) node block indexes of the relations in a relation file. The file is read
+ * sequentially in chunks of blocks, only the source and destination records of a block are decoded.
+ * */
+static void readRelationEdges(const std::string &path, unsigned long blockSize, unsigned int vertexCount,
+                              std::vector<std::pair<unsigned int, unsigned int>> &edges) {
+    std::ifstream relations(path, std::ios::binary);
+    if (!relations) {
+        node_manager_logger.error("Error while opening relations DB " + path);
+        return;
+    }
+    const unsigned long CHUNK_BLOCKS = 4096;
+    std::vector<char> chunk(CHUNK_BLOCKS * blockSize);
+    relations.seekg(blockSize);  // Relation block 0 is not used
+    while (relations) {
+        relations.read(chunk.data(), chunk.size());
+        unsigned long blocks = relations.gcount() / blockSize;
+        for (unsigned long i = 0; i < blocks; i++) {
+            const char *block = chunk.data() + i * blockSize;
+            if (RelationBlock::isFree(block)) {
+                continue;
+            }
+            // Source and destination records decode the same way in local and central relation blocks
+            unsigned int source =
+                RelationBlock::readRecord(block, RelationOffsets::SOURCE, false) / NodeBlock::BLOCK_SIZE;
+            unsigned int destination =
+                RelationBlock::readRecord(block, RelationOffsets::DESTINATION, false) / NodeBlock::BLOCK_SIZE;
+            if (source < vertexCount && destination < vertexCount) {
+                edges.push_back({source, destination});
+            }
+        }
+    }
+}
 
-        for (auto neighborNode : neighborNodes) {
-            neighbors.insert(neighborNode->nodeId);
+CsrSnapshot NodeManager::getCsrSnapshot(bool local, bool central, bool undirected) {
+    // Relation blocks are appended through the fstreams, the block cache never holds newer source or destination
+    // records than the relation files
+    if (RelationBlock::relationsDB) {
+        RelationBlock::relationsDB->flush();
+    }
+    if (RelationBlock::centralRelationsDB) {
+        RelationBlock::centralRelationsDB->flush();
+    }
+
+    std::vector<unsigned int> nodeIds(this->allocator->next(BlockFile::NODES), 0);
+    for (auto it : *this->nodeIndex) {
+        if (it.second < nodeIds.size()) {
+            nodeIds[it.second] = std::stoul(it.first);
         }
-        adjacencyList.emplace((long)node->nodeId, neighbors);
     }
-    return adjacencyList;
+    std::vector<std::pair<unsigned int, unsigned int>> edges;
+    if (local) {
+        readRelationEdges(dbPrefix + "_relations.db", RelationBlock::BLOCK_SIZE, nodeIds.size(), edges);
+    }
+    if (central) {
+        readRelationEdges(dbPrefix + "_central_relations.db", RelationBlock::CENTRAL_BLOCK_SIZE, nodeIds.size(),
+                          edges);
+    }
+    return CsrSnapshot::fromEdges(edges, std::move(nodeIds), undirected);
 }
 
+// Get adjacency list for the graph
+std::map<long, std::unordered_set<long>> NodeManager::getAdjacencyList() {
+    return this->getCsrSnapshot().toAdjacencyList();
+}
+
+// Adjacency list of the local or central edges in their direction, only nodes with out edges are listed
 std::map<long, std::unordered_set<long>> NodeManager::getAdjacencyList(bool isLocal) {
-    std::map<long, std::unordered_set<long>> adjacencyList;
+    return this->getCsrSnapshot(isLocal, !isLocal, false).toAdjacencyList(false);
+}
 
-    int relationBlockSize = 0;
-    if (isLocal) {
-        relationBlockSize = RelationBlock::BLOCK_SIZE;
-    } else {
-        relationBlockSize = RelationBlock::CENTRAL_BLOCK_SIZE;
+/**
+ * Number of distinct neighbors of every node of the partition, over local and central relations in both directions.
+ * Nodes without relations are listed with 0 and a self loop adds the node itself once, as when the map was built from
+ * getAdjacencyList(). Relation counts, in which a self loop adds 2, are in the degree counters, see getDegree().
+ * */
+std::map<long, long> NodeManager::getDistributionMap() {
+    CsrSnapshot snapshot = this->getCsrSnapshot();
+    std::map<long, long> distributionMap;
+    for (auto it : *this->nodeIndex) {
+        distributionMap[std::stol(it.first)] = it.second < snapshot.vertexCount() ? snapshot.degree(it.second) : 0;
     }
-    long  newRelationCount;
+    return distributionMap;
+}
 
-    if (isLocal) {
-         newRelationCount = dbSize(dbPrefix + "_relations.db") / relationBlockSize - 1;
-    } else {
-         newRelationCount = dbSize(dbPrefix + "_central_relations.db") / relationBlockSize - 1;
+NodeDegree NodeManager::getDegree(const std::string &nodeId) {
+    unsigned int index;
+    if (!this->nodeIndex->find(nodeId, index)) {
+        return NodeDegree();
     }
+    return this->nodeDegrees->get(index);
+}
 
-    RelationBlock* relationBlock;
+std::map<unsigned long, unsigned long> NodeManager::getDegreeHistogram(bool local, bool central) {
+    std::map<unsigned long, unsigned long> histogram;
+    this->nodeDegrees->scan(0, this->allocator->next(BlockFile::NODES), [&](unsigned int, const NodeDegree &degree) {
+        histogram[(local ? degree.local() : 0) + (central ? degree.central() : 0)]++;
+    });
+    return histogram;
+}
 
-    for (int i = 1; i <=  newRelationCount ; i++) {
-        if (isLocal) {
-            relationBlock = RelationBlock::getLocalRelation(i * relationBlockSize);
-        } else {
-            relationBlock = RelationBlock::getCentralRelation(i * relationBlockSize);
-        }
-        long src = std::stol(relationBlock->getSource()->id);
-        long dest = std::stol(relationBlock->getDestination()->id);
+/**
+ * Write back the blocks of this partition that were only updated in the block cache
+ * */
+void NodeManager::flushBlockCache() {
+    BlockCache* blockCache = BlockCache::getInstance();
+    blockCache->flush(this->cachePartition);
+    BlockCacheStats stats = blockCache->getStats();
+    node_manager_logger.debug("Block cache hits: " + std::to_string(stats.hits) + ", misses: " +
+                              std::to_string(stats.misses) + ", evictions: " + std::to_string(stats.evictions) +
+                              ", write backs: " + std::to_string(stats.writeBacks));
+}
+
+/**
+ * Memory map the block files of a partition for reading on the calling thread. Block lookups then copy straight out
+ * of the page cache instead of a seekg and several read calls on the fstreams, while all writes still go through the
+ * fstreams.
+ * */
+void NodeManager::mapBlockFiles(const std::string &dbPrefix) {
+    NodeBlock::nodesMap = new MappedFile(dbPrefix + "_nodes.db");
+    PropertyLink::propertiesMap = new MappedFile(dbPrefix + "_properties.db");
+    MetaPropertyLink::metaPropertiesMap = new MappedFile(dbPrefix + "_meta_properties.db");
+    PropertyEdgeLink::edgePropertiesMap = new MappedFile(dbPrefix + "_edge_properties.db");
+    MetaPropertyEdgeLink::metaEdgePropertiesMap = new MappedFile(dbPrefix + "_meta_edge_properties.db");
+    RelationBlock::relationsMap = new MappedFile(dbPrefix + "_relations.db");
+    RelationBlock::centralRelationsMap = new MappedFile(dbPrefix + "_central_relations.db");
+}
 
-        // Insert into adjacency list
-        adjacencyList[src].insert(dest);
+void NodeManager::unmapBlockFiles() {
+    delete NodeBlock::nodesMap;
+    NodeBlock::nodesMap = NULL;
+    delete PropertyLink::propertiesMap;
+    PropertyLink::propertiesMap = NULL;
+    delete MetaPropertyLink::metaPropertiesMap;
+    MetaPropertyLink::metaPropertiesMap = NULL;
+    delete PropertyEdgeLink::edgePropertiesMap;
+    PropertyEdgeLink::edgePropertiesMap = NULL;
+    delete MetaPropertyEdgeLink::metaEdgePropertiesMap;
+    MetaPropertyEdgeLink::metaEdgePropertiesMap = nullptr;
+    delete RelationBlock::relationsMap;
+    RelationBlock::relationsMap = NULL;
+    delete RelationBlock::centralRelationsMap;
+    RelationBlock::centralRelationsMap = NULL;
+}
+
+/**
+ * Open the block files of a partition for the calling thread, the streams are per thread
+ * */
+/**
+ * Open a block file stream of the calling thread. Every thread of a partition has streams of its own, so the streams
+ * are unbuffered: a write reaches the file when it returns and a read always reads the file, and threads never see
+ * blocks another thread has written only into its stream buffer, or a block of which only a part was flushed.
+ * */
+std::fstream *NodeManager::openBlockFile(const std::string &path, std::ios_base::openmode openMode) {
+    if (!Utils::fileExistsWithReadPermission(path)) {
+        std::ofstream(path, std::ios::out | std::ios::binary).close();
     }
-    return adjacencyList;
+    std::fstream *stream = new std::fstream();
+    stream->rdbuf()->pubsetbuf(NULL, 0);  // Takes effect only before the file is opened
+    stream->open(path, openMode | std::ios::binary);
+    return stream;
 }
 
-// Get degree map
-std::map<long, long> NodeManager::getDistributionMap() {
-    std::map<long, std::unordered_set<long>> adjacencyList = getAdjacencyList();
-    std::map<long, long> distributionMap;
-    for (auto it : adjacencyList) {
-        distributionMap.emplace(it.first, it.second.size());
+void NodeManager::openBlockFiles(const std::string &dbPrefix, std::ios_base::openmode openMode) {
+    NodeBlock::nodesDB = openBlockFile(dbPrefix + "_nodes.db", openMode);
+    PropertyLink::propertiesDB = openBlockFile(dbPrefix + "_properties.db", openMode);
+    MetaPropertyLink::metaPropertiesDB = openBlockFile(dbPrefix + "_meta_properties.db", openMode);
+    PropertyEdgeLink::edgePropertiesDB = openBlockFile(dbPrefix + "_edge_properties.db", openMode);
+    MetaPropertyEdgeLink::metaEdgePropertiesDB = openBlockFile(dbPrefix + "_meta_edge_properties.db", openMode);
+    RelationBlock::relationsDB = openBlockFile(dbPrefix + "_relations.db", openMode);
+    RelationBlock::centralRelationsDB = openBlockFile(dbPrefix + "_central_relations.db", openMode);
+}
+
+void NodeManager::closeBlockFiles() {
+    for (std::fstream** db : {&NodeBlock::nodesDB, &PropertyLink::propertiesDB, &MetaPropertyLink::metaPropertiesDB,
+                              &PropertyEdgeLink::edgePropertiesDB, &MetaPropertyEdgeLink::metaEdgePropertiesDB,
+                              &RelationBlock::relationsDB, &RelationBlock::centralRelationsDB}) {
+        delete *db;
+        *db = NULL;
     }
+}
 
-    return distributionMap;
+NodeManager::ThreadStore::ThreadStore(NodeManager &nodeManager) : mapped(nodeManager.mappedStorage) {
+    NodeManager::openBlockFiles(nodeManager.dbPrefix, std::ios::in | std::ios::out);
+    if (this->mapped) {
+        NodeManager::mapBlockFiles(nodeManager.dbPrefix);
+    }
+    BlockFormat::version = nodeManager.formatVersion;
+    BlockCache::partition = nodeManager.cachePartition;
+    BlockAllocator::current = nodeManager.allocator;
+    StorageMetrics::current = StorageMetrics::get(nodeManager.dbPrefix);
+    PropertyStore::current = nodeManager.propertyStore;
+    IncomingRelationHeads::current = nodeManager.incomingHeads;
+    LabelIndex::current = nodeManager.labelIndex;
+    RelationTypeIndex::current = nodeManager.relationTypeIndex;
+}
+
+NodeManager::ThreadStore::~ThreadStore() {
+    if (this->mapped) {
+        NodeManager::unmapBlockFiles();
+    }
+    NodeManager::closeBlockFiles();
+    BlockCache::detach();
+    BlockAllocator::current = NULL;
+    StorageMetrics::current = NULL;
+    PropertyStore::current = NULL;
+    IncomingRelationHeads::current = NULL;
+    LabelIndex::current = NULL;
+    RelationTypeIndex::current = NULL;
+}
+
+/**
+ * Write the dirty blocks of the block cache and the buffered stream writes of the calling thread to the block files,
+ * sync the block files and, for the NodeManager that writes the write-ahead log, truncate the log, whose records are
+ * then covered by the block files.
+ * */
+void NodeManager::checkpoint() {
+    this->nodeIndex->flush();
+    this->localEdgeIndex->flush();
+    this->centralEdgeIndex->flush();
+    this->nodeDegrees->flush();
+    this->incomingHeads->flush();
+    this->propertyIndex->flush();
+    if (this->propertyStore) {
+        this->propertyStore->flush();
+    }
+    this->flushBlockCache();
+    this->allocator->flush();
+    for (std::fstream* db : {NodeBlock::nodesDB, PropertyLink::propertiesDB, MetaPropertyLink::metaPropertiesDB,
+                             PropertyEdgeLink::edgePropertiesDB, MetaPropertyEdgeLink::metaEdgePropertiesDB,
+                             RelationBlock::relationsDB, RelationBlock::centralRelationsDB}) {
+        if (db && db->is_open()) {
+            db->flush();
+        }
+    }
+    for (const char* suffix : {"_nodes.db", "_properties.db", "_meta_properties.db", "_edge_properties.db",
+                               "_meta_edge_properties.db", "_relations.db", "_central_relations.db"}) {
+        int fd = ::open((this->dbPrefix + suffix).c_str(), O_RDONLY);
+        if (fd < 0 || fdatasync(fd) != 0) {
+            node_manager_logger.error("Error while syncing " + this->dbPrefix + suffix);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (this->wal && this->logWriter) {
+        this->wal->checkpoint();
+    }
+}
+
+void NodeManager::ownWriteAheadLog() {
+    this->logWriter = true;
+    if (this->wal && this->truncated) {
+        this->wal->checkpoint();
+    }
 }
 
 /**
@@ -561,7 +1685,11 @@ std::map<long, long> NodeManager::getDistributionMap() {
  *
  * **/
 void NodeManager::close() {
-    this->persistNodeIndex();
+    this->checkpoint();
+    if (this->mappedStorage) {
+        NodeManager::unmapBlockFiles();
+        this->mappedStorage = false;
+    }
     if (PropertyLink::propertiesDB) {
         PropertyLink::propertiesDB->flush();
         PropertyLink::propertiesDB->close();
@@ -583,8 +1711,8 @@ void NodeManager::close() {
 /**
  *
  * Set the size of node index key size at the run time.
- * By default Node/Vertext ID or the label is used as the key in the node index database, which act as a lookup table
- * for node IDs to their block address in node DB
+ * Only the fixed width _nodes.index.db written by older versions uses it, the key size is needed to read that file
+ * when it is migrated to the persistent NodeIndex, which takes keys of any length.
  *
  * */
 void NodeManager::setIndexKeySize(unsigned long newIndexKeySize) {
@@ -607,4 +1735,9 @@ std::string NodeManager::getDbPrefix() {
     return dbPrefix;
 }
 
+unsigned long NodeManager::relationBlockChanges() {
+    return this->allocator->freeListChanges(BlockFile::RELATIONS) +
+           this->allocator->freeListChanges(BlockFile::CENTRAL_RELATIONS);
+}
+
 const std::string NodeManager::FILE_MODE = "app";  // for appending to existing DB
@@ -15,8 +15,23 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "BlockAllocator.h"
+#include "BlockFormat.h"
+#include "CsrSnapshot.h"
+#include "EdgeIndex.h"
+#include "IncomingRelationHeads.h"
+#include "LabelIndex.h"
 #include "NodeBlock.h"
+#include "NodeDegrees.h"
+#include "NodeIndex.h"
+#include "PropertyIndex.h"
+#include "PropertyStore.h"
+#include "RelationCursor.h"
+#include "RelationTypeIndex.h"
+#include "WriteAheadLog.h"
 
 #ifndef NODE_MANAGER
 #define NODE_MANAGER
@@ -26,29 +41,92 @@ struct GraphConfig {
     unsigned int graphID;
     unsigned int partitionID;
     std::string openMode;
+    // "fstream" or "mmap", empty to use org.jasminegraph.nativestore.storage.mode
+    std::string storageMode = "";
 };
 
 class NodeManager {
  private:
-    unsigned int nextNodeIndex = 0;
+    BlockAllocator* allocator = NULL;  // Next free blocks and node locks, shared by the NodeManagers of the partition
     std::fstream* nodeDBT;
     unsigned int graphID = 0;
     unsigned int partitionID = 0;
     std::string dbPrefix;
     // static const std::string FILE_MODE;
-    unsigned long INDEX_KEY_SIZE = 6;  // Size of an index key entry in bytes
+    unsigned long INDEX_KEY_SIZE = 6;  // Key size of the legacy fixed width node index, used for migration only
     std::string indexDBPath;
 
 
-    void persistNodeIndex();
-    std::unordered_map<std::string, unsigned int> readNodeIndex();
-    void addNodeIndex(std::string nodeId, unsigned int nodeIndex);
+    bool mappedStorage = false;  // Reads of block files go through MappedFile instead of the fstreams
+    unsigned int cachePartition = 0;  // Id of this partition in the block cache
+    PropertyStore* propertyStore = NULL;  // Set when the partition keeps its properties in a column store
+    EdgeIndex* localEdgeIndex;    // Edges of the local relation blocks, to detect duplicates without a chain walk
+    EdgeIndex* centralEdgeIndex;  // Edges of the central relation blocks
+    NodeDegrees* nodeDegrees;     // In and out degree counters of the nodes
+    IncomingRelationHeads* incomingHeads;  // Heads of the incoming relation chains of the nodes
+    bool truncated = false;  // Opened in a mode other than FILE_MODE, the block files were truncated
+    bool logWriter = false;  // Logs the streaming operations of the partition, see ownWriteAheadLog()
+
+    unsigned int formatVersion = BlockFormat::LATEST;  // Format of the block references of the partition
+
+    static std::fstream* openBlockFile(const std::string &path, std::ios_base::openmode openMode);
+    static void openBlockFiles(const std::string &dbPrefix, std::ios_base::openmode openMode);
+    static void closeBlockFiles();
+    static void mapBlockFiles(const std::string &dbPrefix);
+    static void unmapBlockFiles();
+    void flushBlockCache();
+    void rebuildLabelIndex();
+    void recover();
+    void relinkRelations(bool central, bool inAddressOrder = false);
+    NodeBlock* createNode(const std::string &nodeId);
+    static int swapCompactedFiles(const std::string &dbPrefix);
+    void finishCompaction(bool central);
+    void removeRelation(const RelationView &relation);
 
  public:
     static unsigned int nextPropertyIndex;  // Next available property block index
-    std::unordered_map<std::string, unsigned int> nodeIndex;
+    NodeIndex* nodeIndex;  // Node ID -> node block index, shared by the NodeManagers of the partition
+    LabelIndex* labelIndex;  // Label -> node block indexes
+    PropertyIndex* propertyIndex;  // Secondary indexes of node properties, see CREATE INDEX
+    RelationTypeIndex* relationTypeIndex;  // Relationship type dictionary, type -> relation block indexes
+    WriteAheadLog* wal = NULL;  // Logical operations of streaming ingest not yet covered by a checkpoint
     NodeManager(GraphConfig);
-    ~NodeManager() { delete NodeBlock::nodesDB; };
+    ~NodeManager() {
+        flushBlockCache();
+        if (mappedStorage) {
+            unmapBlockFiles();
+        }
+        NodeIndex::release(nodeIndex);
+        EdgeIndex::release(localEdgeIndex);
+        EdgeIndex::release(centralEdgeIndex);
+        NodeDegrees::release(nodeDegrees);
+        IncomingRelationHeads::release(incomingHeads);
+        PropertyStore::release(propertyStore);
+        LabelIndex::release(labelIndex);
+        PropertyIndex::release(propertyIndex);
+        RelationTypeIndex::release(relationTypeIndex);
+        WriteAheadLog::release(wal);
+        BlockAllocator::release(allocator);
+        closeBlockFiles();
+    };
+
+    /**
+     * The partition of an open NodeManager, opened for another thread while the NodeManager stays open. Helper threads
+     * of a query read the partition through it instead of opening a NodeManager of their own: the thread gets block
+     * file streams of its own, and block file maps in mmap storage mode, and shares the indexes, the allocator and the
+     * block cache partition of the NodeManager. Everything opened for the thread is closed when the scope ends.
+     * */
+    class ThreadStore {
+     public:
+        explicit ThreadStore(NodeManager &nodeManager);
+        ~ThreadStore();
+
+        ThreadStore(const ThreadStore &) = delete;
+        ThreadStore &operator=(const ThreadStore &) = delete;
+
+     private:
+        bool mapped;
+    };
 
     void setIndexKeySize(unsigned long);
     static int dbSize(std::string path);
@@ -57,23 +135,67 @@ class NodeManager {
     int getPartitionID();
     std::string getDbPrefix();
     void close();
+    // Sync the blocks of the partition to the block files, and truncate the write-ahead log if this NodeManager logs
+    void checkpoint();
+    // Make this the NodeManager of the writer that logs the streaming operations of the partition, the only one whose
+    // checkpoints truncate the shared write-ahead log. The records of a partition opened in trunc mode are dropped
+    void ownWriteAheadLog();
+    // Rewrite the local or central relation blocks clustered by source node to restore the locality of relation chain
+    // walks. Runs only while no other NodeManager of the partition is open
+    bool compactRelations(bool central);
 
     RelationBlock* addLocalEdge(std::pair<std::string, std::string>);
     RelationBlock* addCentralEdge(std::pair<std::string, std::string> edge);
+    // Add local or central edges in one batch, returns the relation block address of each edge, 0 for duplicates
+    std::vector<unsigned long> addEdges(const std::vector<std::pair<std::string, std::string>> &edges,
+                                        bool central = false);
+
+    // Delete the local or central relation between two nodes, false if there is none
+    bool deleteEdge(const std::string &source, const std::string &destination);
+    // Delete a node, false if it is unknown or has relations and detach is not set
+    bool deleteNode(const std::string &nodeId, bool detach = false);
+    // Number of local and central relation blocks freed, reused or renumbered since the partition was opened in the
+    // process. While it does not change, the relations added are the blocks appended to the relation files
+    unsigned long relationBlockChanges();
 
     RelationBlock* addLocalRelation(NodeBlock, NodeBlock);
     RelationBlock* addCentralRelation(NodeBlock source, NodeBlock destination);
 
     NodeBlock* addNode(std::string);  // will return DB block address
     NodeBlock* get(std::string);
+    // Create an index of a node property and index the nodes already in the partition, false if it already exists
+    bool createPropertyIndex(const std::string &property, PropertyIndexType type);
 
     std::list<NodeBlock*> getCentralGraph();
     std::list<NodeBlock> getLimitedGraph(int limit = 10);
     std::list<NodeBlock*> getGraph();
 
+    // Compressed sparse row snapshot of the local and/or central edges, built with one sequential read of the
+    // relation files. Every edge is added in both directions if undirected is set
+    CsrSnapshot getCsrSnapshot(bool local = true, bool central = true, bool undirected = true);
+    // Call visit with a RelationView of each relation in the local or central chains of the node block at
+    // nodeAddress, only the relations of one direction are read for OUTGOING or INCOMING. The walk allocates nothing
+    // and loads no NodeBlocks, use RelationCursor to stop a walk early
+    template <typename Visitor>
+    void forEachNeighbor(unsigned long nodeAddress, bool central, RelationDirection direction, Visitor visit) {
+        RelationCursor cursor(nodeAddress, central, direction);
+        RelationView relation;
+        while (cursor.next(relation)) {
+            visit(static_cast<const RelationView &>(relation));
+        }
+    }
+    template <typename Visitor>
+    void forEachNeighbor(unsigned long nodeAddress, bool central, Visitor visit) {
+        this->forEachNeighbor(nodeAddress, central, RelationDirection::BOTH, visit);
+    }
     std::map<long, std::unordered_set<long>> getAdjacencyList();
     std::map<long, std::unordered_set<long>> getAdjacencyList(bool isLocal);
+    // Number of distinct neighbors of every node, local and central relations in both directions
     std::map<long, long> getDistributionMap();
+    // Local and central in and out degrees of a node, all 0 for unknown nodes
+    NodeDegree getDegree(const std::string &nodeId);
+    // Number of nodes of each degree, read from the degree counters without touching a relation block
+    std::map<unsigned long, unsigned long> getDegreeHistogram(bool local = true, bool central = true);
 };
 
 #endif
@@ -19,45 +19,65 @@ limitations under the License.
 #include <memory>
 
 #include "../util/logger/Logger.h"
+#include "BlockAllocator.h"
+#include "BlockCache.h"
+#include "BlockFormat.h"
+#include "StorageMetrics.h"
 Logger property_edge_link_logger;
-thread_local unsigned int PropertyEdgeLink::nextPropertyIndex = 1;
 thread_local std::fstream* PropertyEdgeLink::edgePropertiesDB = NULL;
+thread_local MappedFile* PropertyEdgeLink::edgePropertiesMap = NULL;
 pthread_mutex_t lockPropertyEdgeLink;
 pthread_mutex_t lockCreatePropertyEdgeLink;
 pthread_mutex_t lockInsertPropertyEdgeLink;
 pthread_mutex_t lockGetPropertyEdgeLink;
 
-PropertyEdgeLink::PropertyEdgeLink(unsigned int propertyBlockAddress) : blockAddress(propertyBlockAddress) {
+PropertyEdgeLink::PropertyEdgeLink(unsigned long propertyBlockAddress) : blockAddress(propertyBlockAddress) {
     pthread_mutex_lock(&lockPropertyEdgeLink);
     if (propertyBlockAddress > 0) {
-        this->edgePropertiesDB->seekg(propertyBlockAddress);
-        char rawName[PropertyEdgeLink::MAX_NAME_SIZE] = {0};
-        //        property_edge_link_logger.info("Traverse state  = " +
-        //        std::to_string(PropertyEdgeLink::edgePropertiesDB->rdstate()));
-
-        if (!this->edgePropertiesDB->read(reinterpret_cast<char*>(&rawName), PropertyEdgeLink::MAX_NAME_SIZE)) {
-            property_edge_link_logger.error("Error while reading property name from block " +
-                                            std::to_string(blockAddress));
+        char block[PropertyEdgeLink::PROPERTY_BLOCK_SIZE] = {0};
+        if (!PropertyEdgeLink::readBlock(propertyBlockAddress, block)) {
+            property_edge_link_logger.error("Error while reading edge property from block " +
+                                       std::to_string(blockAddress));
         }
-        property_edge_link_logger.debug(
-            "Current file descriptor cursor position = " + std::to_string(this->edgePropertiesDB->tellg()) +
-            " when reading = " + std::to_string(blockAddress));
-        if (!this->edgePropertiesDB->read(reinterpret_cast<char*>(&this->value), PropertyEdgeLink::MAX_VALUE_SIZE)) {
-            property_edge_link_logger.error("Error while reading property value from block " +
-                                            std::to_string(blockAddress));
-        }
-
-        if (!this->edgePropertiesDB->read(reinterpret_cast<char*>(&(this->nextPropAddress)), sizeof(unsigned int))) {
-            property_edge_link_logger.error("Error while reading property next address from block " +
-                                            std::to_string(blockAddress));
-        }
-
-        this->name = std::string(rawName);
+        const char* rawValue = block + PropertyEdgeLink::MAX_NAME_SIZE;
+        std::memcpy(this->value, rawValue, PropertyEdgeLink::MAX_VALUE_SIZE);
+        unsigned int nextRecord;
+        std::memcpy(&nextRecord, rawValue + PropertyEdgeLink::MAX_VALUE_SIZE, sizeof(nextRecord));
+        this->nextPropAddress = BlockFormat::decode(nextRecord, PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
+        this->name = std::string(block, strnlen(block, PropertyEdgeLink::MAX_NAME_SIZE));
     }
     pthread_mutex_unlock(&lockPropertyEdgeLink);
 };
 
-PropertyEdgeLink::PropertyEdgeLink(unsigned int blockAddress, std::string name, char* rvalue, unsigned int nextAddress)
+static bool loadPropertyBlock(unsigned long propertyBlockAddress, char* block) {
+    if (PropertyEdgeLink::edgePropertiesMap) {
+        return PropertyEdgeLink::edgePropertiesMap->read(propertyBlockAddress, block,
+                                                         PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
+    }
+    PropertyEdgeLink::edgePropertiesDB->seekg(propertyBlockAddress);
+    if (!PropertyEdgeLink::edgePropertiesDB->read(block, PropertyEdgeLink::PROPERTY_BLOCK_SIZE)) {
+        PropertyEdgeLink::edgePropertiesDB->clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read a whole property block through the block cache. On a miss it is loaded with a single read, or from the memory
+ * mapped DB when the store runs in mmap mode
+ * */
+bool PropertyEdgeLink::readBlock(unsigned long propertyBlockAddress, char* block) {
+    StorageMetrics::ReadTimer timer(BlockFile::EDGE_PROPERTIES, PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
+    return BlockCache::getInstance()->read(
+        BlockFile::EDGE_PROPERTIES, propertyBlockAddress, block, PropertyEdgeLink::PROPERTY_BLOCK_SIZE,
+        [propertyBlockAddress, &timer](char* buffer) {
+            timer.load(!PropertyEdgeLink::edgePropertiesMap);
+            return loadPropertyBlock(propertyBlockAddress, buffer);
+        });
+}
+
+PropertyEdgeLink::PropertyEdgeLink(unsigned long blockAddress, std::string name, char* rvalue,
+                                   unsigned long nextAddress)
     : blockAddress(blockAddress), nextPropAddress(nextAddress), name(name) {
     // Can't use just string copyer here because of binary data formats
     for (size_t i = 0; i < PropertyEdgeLink::MAX_VALUE_SIZE; i++) {
@@ -87,7 +107,7 @@ PropertyEdgeLink::PropertyEdgeLink(unsigned int blockAddress, std::string name,
  * if propertyAddress was 0 before inserting you will get head address of the link in return value
  *  else either updated link address or last appended link address will be returned
  * **/
-unsigned int PropertyEdgeLink::insert(std::string name, char* value) {
+unsigned long PropertyEdgeLink::insert(std::string name, char* value) {
     char dataName[PropertyEdgeLink::MAX_NAME_SIZE] = {0};
     char dataValue[PropertyEdgeLink::MAX_VALUE_SIZE] = {0};
     std::strcpy(dataName, name.c_str());
@@ -114,7 +134,9 @@ unsigned int PropertyEdgeLink::insert(std::string name, char* value) {
               //        std::to_string(PropertyEdgeLink::nextPropertyIndex));
 
         pthread_mutex_lock(&lockInsertPropertyEdgeLink);
-        unsigned int newAddress = PropertyEdgeLink::nextPropertyIndex * PropertyEdgeLink::PROPERTY_BLOCK_SIZE;
+        unsigned long newAddress =
+                BlockAllocator::current->allocate(BlockFile::EDGE_PROPERTIES) * PropertyEdgeLink::PROPERTY_BLOCK_SIZE;
+        StorageMetrics::recordWrite(BlockFile::EDGE_PROPERTIES, PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
         this->edgePropertiesDB->seekp(newAddress);
         this->edgePropertiesDB->write(dataName, PropertyEdgeLink::MAX_NAME_SIZE);
         this->edgePropertiesDB->write(reinterpret_cast<char*>(dataValue), PropertyEdgeLink::MAX_VALUE_SIZE);
@@ -125,17 +147,21 @@ unsigned int PropertyEdgeLink::insert(std::string name, char* value) {
         }
 
         this->nextPropAddress = newAddress;
+        unsigned int nextRecord = BlockFormat::encode(newAddress, PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
+        StorageMetrics::recordWrite(BlockFile::EDGE_PROPERTIES, sizeof(nextRecord));
         this->edgePropertiesDB->seekp(this->blockAddress + PropertyEdgeLink::MAX_NAME_SIZE +
                                       PropertyEdgeLink::MAX_VALUE_SIZE);  // seek to current property next address
-        if (!this->edgePropertiesDB->write(reinterpret_cast<char*>(&newAddress), sizeof(newAddress))) {
+        if (!this->edgePropertiesDB->write(reinterpret_cast<char*>(&nextRecord), sizeof(nextRecord))) {
             property_edge_link_logger.error("Error while updating  property next address for " + name +
                                             " into block address " + std::to_string(this->blockAddress));
             return -1;
         }
+        BlockCache::getInstance()->update(BlockFile::EDGE_PROPERTIES, this->blockAddress,
+                                          PropertyEdgeLink::MAX_NAME_SIZE + PropertyEdgeLink::MAX_VALUE_SIZE,
+                                          reinterpret_cast<char*>(&nextRecord), sizeof(nextRecord));
         this->edgePropertiesDB->flush();
         //        property_edge_link_logger.info("nextPropertyIndex = " +
         //        std::to_string(PropertyEdgeLink::nextPropertyIndex));
-        PropertyEdgeLink::nextPropertyIndex++;  // Increment the shared property index value
         pthread_mutex_unlock(&lockInsertPropertyEdgeLink);
         return this->blockAddress;
     }
@@ -150,7 +176,9 @@ PropertyEdgeLink* PropertyEdgeLink::create(std::string name, char value[]) {
     unsigned int nextAddress = 0;
     char dataName[PropertyEdgeLink::MAX_NAME_SIZE] = {0};
     strcpy(dataName, name.c_str());
-    unsigned int newAddress = PropertyEdgeLink::nextPropertyIndex * PropertyEdgeLink::PROPERTY_BLOCK_SIZE;
+    unsigned long newAddress =
+            BlockAllocator::current->allocate(BlockFile::EDGE_PROPERTIES) * PropertyEdgeLink::PROPERTY_BLOCK_SIZE;
+    StorageMetrics::recordWrite(BlockFile::EDGE_PROPERTIES, PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
     PropertyEdgeLink::edgePropertiesDB->seekp(newAddress);
     PropertyEdgeLink::edgePropertiesDB->write(dataName, PropertyEdgeLink::MAX_NAME_SIZE);
     PropertyEdgeLink::edgePropertiesDB->write(reinterpret_cast<char*>(value), PropertyEdgeLink::MAX_VALUE_SIZE);
@@ -162,7 +190,6 @@ PropertyEdgeLink* PropertyEdgeLink::create(std::string name, char value[]) {
     PropertyEdgeLink::edgePropertiesDB->flush();
     //    property_edge_link_logger.info("nextPropertyIndex = " + std::to_string(PropertyEdgeLink::nextPropertyIndex));
     //    property_edge_link_logger.info("newAddress = " + std::to_string(newAddress));
-    PropertyEdgeLink::nextPropertyIndex++;  // Increment the shared property index value
     pthread_mutex_unlock(&lockCreatePropertyEdgeLink);
     return new PropertyEdgeLink(newAddress, name, value, nextAddress);
 }
@@ -179,43 +206,22 @@ PropertyEdgeLink* PropertyEdgeLink::next() {
 
 bool PropertyEdgeLink::isEmpty() { return !(this->blockAddress); }
 
-PropertyEdgeLink* PropertyEdgeLink::get(unsigned int propertyBlockAddress) {
+PropertyEdgeLink* PropertyEdgeLink::get(unsigned long propertyBlockAddress) {
     PropertyEdgeLink* pl = NULL;
 
     pthread_mutex_lock(&lockGetPropertyEdgeLink);
     if (propertyBlockAddress > 0) {
-        char propertyName[PropertyEdgeLink::MAX_NAME_SIZE] = {0};
-        char propertyValue[PropertyEdgeLink::MAX_VALUE_SIZE] = {0};
-        unsigned int nextAddress;
-        PropertyEdgeLink::edgePropertiesDB->seekg(propertyBlockAddress);
-
-        //        property_edge_link_logger.info("Searching propertyHead state  = " +
-        //        std::to_string(PropertyEdgeLink::edgePropertiesDB->rdstate())); std::cout << "Stream state: " <<
-        //        PropertyEdgeLink::edgePropertiesDB->rdstate() << std::endl; std::string
-        //        PropertyEdgeLink::edgePropertiesDB->rdstate();
-        if (!PropertyEdgeLink::edgePropertiesDB->read(reinterpret_cast<char*>(&propertyName),
-                                                      PropertyEdgeLink::MAX_NAME_SIZE)) {
-            //            property_edge_link_logger.error("Error  = " +
-            //                                       std::to_string(PropertyEdgeLink::edgePropertiesDB->rdstate()));
-            property_edge_link_logger.error("Error while reading edge property name from block = " +
-                                            std::to_string(propertyBlockAddress));
+        char block[PropertyEdgeLink::PROPERTY_BLOCK_SIZE] = {0};
+        unsigned int nextRecord;
+        if (!PropertyEdgeLink::readBlock(propertyBlockAddress, block)) {
+            property_edge_link_logger.error("Error while reading edge property from block = " +
+                                       std::to_string(propertyBlockAddress));
         }
-        if (!PropertyEdgeLink::edgePropertiesDB->read(reinterpret_cast<char*>(&propertyValue),
-                                                      PropertyEdgeLink::MAX_VALUE_SIZE)) {
-            property_edge_link_logger.error("Error while reading edge property value from block = " +
-                                            std::to_string(propertyBlockAddress));
-        }
-
-        if (!PropertyEdgeLink::edgePropertiesDB->read(reinterpret_cast<char*>(&(nextAddress)), sizeof(unsigned int))) {
-            property_edge_link_logger.error("Error while reading edge property next address from block = " +
-                                            std::to_string(propertyBlockAddress));
-        }
-        property_edge_link_logger.debug("Property head propertyBlockAddress  = " +
-                                        std::to_string(propertyBlockAddress));
-        property_edge_link_logger.debug("Property head property name  = " + std::string(propertyName));
-        property_edge_link_logger.debug("Property head nextAddress   = " + std::to_string(nextAddress));
-
-        pl = new PropertyEdgeLink(propertyBlockAddress, std::string(propertyName), propertyValue, nextAddress);
+        char* rawValue = block + PropertyEdgeLink::MAX_NAME_SIZE;
+        std::memcpy(&nextRecord, rawValue + PropertyEdgeLink::MAX_VALUE_SIZE, sizeof(nextRecord));
+        std::string propertyName(block, strnlen(block, PropertyEdgeLink::MAX_NAME_SIZE));
+        unsigned long nextAddress = BlockFormat::decode(nextRecord, PropertyEdgeLink::PROPERTY_BLOCK_SIZE);
+        pl = new PropertyEdgeLink(propertyBlockAddress, propertyName, rawValue, nextAddress);
     }
     pthread_mutex_unlock(&lockGetPropertyEdgeLink);
     return pl;
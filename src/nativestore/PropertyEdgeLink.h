@@ -16,6 +16,8 @@ limitations under the License.
 #include <set>
 #include <string>
 
+#include "MappedFile.h"
+
 #ifndef JASMINEGRAPH_PROPERTYEDGELINK_H
 #define JASMINEGRAPH_PROPERTYEDGELINK_H
 
@@ -23,26 +25,27 @@ class PropertyEdgeLink {
  public:
     static const unsigned long MAX_NAME_SIZE = 30;    // Size of a property name in bytes
     static const unsigned long MAX_VALUE_SIZE = 400;  // Size of a property value in bytes
-    static thread_local unsigned int nextPropertyIndex;   // Next available property block index
     // unless open in wipe data
     // mode(trunc) need to set this value to property db seekp()/BLOCK_SIZE
     static const unsigned long PROPERTY_BLOCK_SIZE = MAX_NAME_SIZE + MAX_VALUE_SIZE + sizeof(unsigned int);
 
     std::string name;
     char value[PropertyEdgeLink::MAX_VALUE_SIZE] = {0};
-    unsigned int blockAddress;  // contains the address of the first element in the list
-    unsigned int nextPropAddress;
+    unsigned long blockAddress;  // contains the address of the first element in the list
+    unsigned long nextPropAddress;
 
     static std::string DB_PATH;
     static thread_local std::fstream* edgePropertiesDB;
+    static thread_local MappedFile* edgePropertiesMap;  // Set only in mmap storage mode
 
-    PropertyEdgeLink(unsigned int);
-    PropertyEdgeLink(unsigned int, std::string, char*, unsigned int);
+    PropertyEdgeLink(unsigned long);
+    PropertyEdgeLink(unsigned long, std::string, char*, unsigned long);
     bool isEmpty();
-    static PropertyEdgeLink* get(unsigned int);
+    static PropertyEdgeLink* get(unsigned long);
+    static bool readBlock(unsigned long, char*);
     static PropertyEdgeLink* create(std::string, char[]);
 
-    unsigned int insert(std::string, char[]);
+    unsigned long insert(std::string, char[]);
     PropertyEdgeLink* next();
 };
 
@@ -0,0 +1,618 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "PropertyIndex.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../util/logger/Logger.h"
+
+Logger property_index_logger;
+
+std::map<std::string, PropertyIndex *> PropertyIndex::openIndexes;
+std::mutex PropertyIndex::openIndexesLock;
+
+static const char HASH_INDEX_MAGIC[8] = {'J', 'G', 'P', 'H', 'I', 'D', 'X', '1'};
+static const char RANGE_INDEX_MAGIC[8] = {'J', 'G', 'P', 'B', 'I', 'D', 'X', '1'};
+static const unsigned long long INITIAL_CAPACITY = 1024;  // Buckets, always a power of two
+
+PropertyHashIndex::PropertyHashIndex(const std::string &path) : path(path) {}
+
+PropertyHashIndex::~PropertyHashIndex() {
+    this->flush();
+    this->closeFile();
+}
+
+void PropertyHashIndex::closeFile() {
+    if (this->header) {
+        munmap(this->header, this->mappedSize);
+        this->header = nullptr;
+        this->buckets = nullptr;
+    }
+    if (this->fd >= 0) {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+}
+
+bool PropertyHashIndex::ensureOpen() {
+    if (this->header) {
+        return true;
+    }
+    this->fd = ::open(this->path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->fd < 0) {
+        property_index_logger.error("Error while opening property index " + this->path);
+        return false;
+    }
+    struct stat stat_buf;
+    fstat(this->fd, &stat_buf);
+    if (stat_buf.st_size < (off_t)sizeof(Header)) {
+        return this->mapTable(this->fd, INITIAL_CAPACITY, true);
+    }
+    Header fileHeader;
+    if (pread(this->fd, &fileHeader, sizeof(Header), 0) != sizeof(Header) ||
+        std::memcmp(fileHeader.magic, HASH_INDEX_MAGIC, sizeof(HASH_INDEX_MAGIC)) != 0) {
+        property_index_logger.error("Property index " + this->path + " is corrupted!");
+        this->closeFile();
+        return false;
+    }
+    return this->mapTable(this->fd, fileHeader.capacity, false);
+}
+
+bool PropertyHashIndex::mapTable(int fd, unsigned long long capacity, bool create) {
+    unsigned long size = sizeof(Header) + capacity * sizeof(Bucket);
+    if (create && ftruncate(fd, size) != 0) {
+        property_index_logger.error("Error while resizing property index " + this->path);
+        return false;
+    }
+    void *region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        property_index_logger.error("Error while memory mapping property index " + this->path);
+        return false;
+    }
+    this->header = static_cast<Header *>(region);
+    this->buckets = reinterpret_cast<Bucket *>(static_cast<char *>(region) + sizeof(Header));
+    this->mappedSize = size;
+    if (create) {
+        std::memcpy(this->header->magic, HASH_INDEX_MAGIC, sizeof(HASH_INDEX_MAGIC));
+        this->header->capacity = capacity;
+        this->header->count = 0;
+    }
+    return true;
+}
+
+void PropertyHashIndex::insertBucket(const Bucket &bucket) {
+    unsigned long long mask = this->header->capacity - 1;
+    unsigned long long slot = bucket.hash & mask;
+    while (this->buckets[slot].nodeIndex != 0) {
+        slot = (slot + 1) & mask;
+    }
+    this->buckets[slot] = bucket;
+    this->header->count++;
+}
+
+/**
+ * Double the bucket count once the table is 70% full, building the new table in a separate file that is renamed over
+ * the old one
+ * */
+bool PropertyHashIndex::grow() {
+    unsigned long long oldCapacity = this->header->capacity;
+    std::string tmpPath = this->path + ".tmp";
+    int newFd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (newFd < 0) {
+        property_index_logger.error("Error while growing property index " + this->path);
+        return false;
+    }
+    Header *oldHeader = this->header;
+    Bucket *oldBuckets = this->buckets;
+    unsigned long oldSize = this->mappedSize;
+    if (!this->mapTable(newFd, oldCapacity * 2, true)) {
+        this->header = oldHeader;
+        this->buckets = oldBuckets;
+        this->mappedSize = oldSize;
+        ::close(newFd);
+        return false;
+    }
+    for (unsigned long long slot = 0; slot < oldCapacity; slot++) {
+        if (oldBuckets[slot].nodeIndex != 0) {
+            this->insertBucket(oldBuckets[slot]);
+        }
+    }
+    msync(this->header, this->mappedSize, MS_SYNC);
+    munmap(oldHeader, oldSize);
+    ::close(this->fd);
+    rename(tmpPath.c_str(), this->path.c_str());
+    this->fd = newFd;
+    return true;
+}
+
+void PropertyHashIndex::insert(unsigned long long hash, unsigned int nodeIndex) {
+    if (!this->ensureOpen()) {
+        return;
+    }
+    // Nodes are indexed again every time an edge carries their properties, keep one bucket per (hash, node)
+    unsigned long long mask = this->header->capacity - 1;
+    for (unsigned long long slot = hash & mask; this->buckets[slot].nodeIndex != 0; slot = (slot + 1) & mask) {
+        if (this->buckets[slot].hash == hash && this->buckets[slot].nodeIndex == nodeIndex + 1) {
+            return;
+        }
+    }
+    if ((this->header->count + 1) * 10 > this->header->capacity * 7 && !this->grow()) {
+        return;
+    }
+    this->insertBucket(Bucket{hash, nodeIndex + 1, 0});
+}
+
+std::vector<unsigned int> PropertyHashIndex::seek(unsigned long long hash) {
+    std::vector<unsigned int> nodes;
+    if (!this->ensureOpen()) {
+        return nodes;
+    }
+    unsigned long long mask = this->header->capacity - 1;
+    for (unsigned long long slot = hash & mask; this->buckets[slot].nodeIndex != 0; slot = (slot + 1) & mask) {
+        if (this->buckets[slot].hash == hash) {
+            nodes.push_back(this->buckets[slot].nodeIndex - 1);
+        }
+    }
+    return nodes;
+}
+
+unsigned long PropertyHashIndex::size() { return this->ensureOpen() ? this->header->count : 0; }
+
+void PropertyHashIndex::flush() {
+    if (this->header) {
+        msync(this->header, this->mappedSize, MS_ASYNC);
+    }
+}
+
+PropertyRangeIndex::PropertyRangeIndex(const std::string &path) : path(path) {
+    static_assert(sizeof(Page) == PAGE_SIZE, "B+-tree pages must fill a page");
+}
+
+PropertyRangeIndex::~PropertyRangeIndex() {
+    if (this->fd >= 0) {
+        ::close(this->fd);
+    }
+}
+
+/**
+ * Open the tree file, page 0 holds the metadata. A new tree has an empty leaf as the root.
+ * */
+bool PropertyRangeIndex::ensureOpen() {
+    if (this->fd >= 0) {
+        return true;
+    }
+    this->fd = ::open(this->path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->fd < 0) {
+        property_index_logger.error("Error while opening property index " + this->path);
+        return false;
+    }
+    if (pread(this->fd, &this->meta, sizeof(Meta), 0) == sizeof(Meta)) {
+        if (std::memcmp(this->meta.magic, RANGE_INDEX_MAGIC, sizeof(RANGE_INDEX_MAGIC)) == 0) {
+            return true;
+        }
+        property_index_logger.error("Property index " + this->path + " is corrupted!");
+        ::close(this->fd);
+        this->fd = -1;
+        return false;
+    }
+    std::memcpy(this->meta.magic, RANGE_INDEX_MAGIC, sizeof(RANGE_INDEX_MAGIC));
+    this->meta.root = 1;
+    this->meta.pages = 2;
+    this->meta.entries = 0;
+    Page root = {};
+    root.leaf = 1;
+    return this->writePage(1, root) && this->writeMeta();
+}
+
+bool PropertyRangeIndex::readPage(unsigned int number, Page &page) {
+    if (pread(this->fd, &page, PAGE_SIZE, (off_t)number * PAGE_SIZE) != PAGE_SIZE) {
+        property_index_logger.error("Error while reading page " + std::to_string(number) + " of " + this->path);
+        return false;
+    }
+    return true;
+}
+
+bool PropertyRangeIndex::writePage(unsigned int number, const Page &page) {
+    if (pwrite(this->fd, &page, PAGE_SIZE, (off_t)number * PAGE_SIZE) != PAGE_SIZE) {
+        property_index_logger.error("Error while writing page " + std::to_string(number) + " of " + this->path);
+        return false;
+    }
+    return true;
+}
+
+bool PropertyRangeIndex::writeMeta() { return pwrite(this->fd, &this->meta, sizeof(Meta), 0) == sizeof(Meta); }
+
+unsigned int PropertyRangeIndex::allocatePage() { return this->meta.pages++; }
+
+bool PropertyRangeIndex::less(const Entry &left, const Entry &right) {
+    return left.value < right.value || (left.value == right.value && left.nodeIndex < right.nodeIndex);
+}
+
+bool PropertyRangeIndex::insertInto(unsigned int pageNumber, const Entry &entry, bool &inserted, Entry &separator,
+                                    unsigned int &splitPage) {
+    Page page;
+    if (!this->readPage(pageNumber, page)) {
+        return false;
+    }
+    if (page.leaf) {
+        Entry *end = page.entries + page.count;
+        Entry *position = std::lower_bound(page.entries, end, entry, PropertyRangeIndex::less);
+        if (position != end && !PropertyRangeIndex::less(entry, *position)) {
+            return false;  // Already indexed
+        }
+        inserted = true;
+        std::vector<Entry> entries(page.entries, position);
+        entries.push_back(entry);
+        entries.insert(entries.end(), position, end);
+        if (entries.size() <= LEAF_CAPACITY) {
+            std::copy(entries.begin(), entries.end(), page.entries);
+            page.count = entries.size();
+            this->writePage(pageNumber, page);
+            return false;
+        }
+        Page right = {};
+        right.leaf = 1;
+        right.next = page.next;
+        unsigned int half = entries.size() / 2;
+        std::copy(entries.begin(), entries.begin() + half, page.entries);
+        page.count = half;
+        std::copy(entries.begin() + half, entries.end(), right.entries);
+        right.count = entries.size() - half;
+        splitPage = this->allocatePage();
+        page.next = splitPage;
+        this->writePage(splitPage, right);
+        this->writePage(pageNumber, page);
+        separator = right.entries[0];
+        return true;
+    }
+
+    Entry *keysEnd = page.inner.keys + page.count;
+    unsigned int child = std::upper_bound(page.inner.keys, keysEnd, entry, PropertyRangeIndex::less) - page.inner.keys;
+    Entry childSeparator;
+    unsigned int childPage;
+    if (!this->insertInto(page.inner.children[child], entry, inserted, childSeparator, childPage)) {
+        return false;
+    }
+    std::vector<Entry> keys(page.inner.keys, keysEnd);
+    std::vector<unsigned int> children(page.inner.children, page.inner.children + page.count + 1);
+    keys.insert(keys.begin() + child, childSeparator);
+    children.insert(children.begin() + child + 1, childPage);
+    if (keys.size() <= INNER_CAPACITY) {
+        std::copy(keys.begin(), keys.end(), page.inner.keys);
+        std::copy(children.begin(), children.end(), page.inner.children);
+        page.count = keys.size();
+        this->writePage(pageNumber, page);
+        return false;
+    }
+    // The middle key moves up, the keys on its right go to the new page
+    unsigned int half = keys.size() / 2;
+    Page right = {};
+    std::copy(keys.begin(), keys.begin() + half, page.inner.keys);
+    std::copy(children.begin(), children.begin() + half + 1, page.inner.children);
+    page.count = half;
+    std::copy(keys.begin() + half + 1, keys.end(), right.inner.keys);
+    std::copy(children.begin() + half + 1, children.end(), right.inner.children);
+    right.count = keys.size() - half - 1;
+    splitPage = this->allocatePage();
+    this->writePage(splitPage, right);
+    this->writePage(pageNumber, page);
+    separator = keys[half];
+    return true;
+}
+
+void PropertyRangeIndex::insert(long long value, unsigned int nodeIndex) {
+    if (!this->ensureOpen()) {
+        return;
+    }
+    Entry entry{value, nodeIndex, 0};
+    bool inserted = false;
+    Entry separator;
+    unsigned int splitPage;
+    if (this->insertInto(this->meta.root, entry, inserted, separator, splitPage)) {
+        Page root = {};
+        root.inner.keys[0] = separator;
+        root.inner.children[0] = this->meta.root;
+        root.inner.children[1] = splitPage;
+        root.count = 1;
+        this->meta.root = this->allocatePage();
+        this->writePage(this->meta.root, root);
+    }
+    if (inserted) {
+        this->meta.entries++;
+        this->writeMeta();
+    }
+}
+
+std::vector<unsigned int> PropertyRangeIndex::scan(long long lower, long long upper) {
+    std::vector<unsigned int> nodes;
+    if (lower > upper || !this->ensureOpen()) {
+        return nodes;
+    }
+    Entry first{lower, 0, 0};
+    Page page;
+    unsigned int pageNumber = this->meta.root;
+    if (!this->readPage(pageNumber, page)) {
+        return nodes;
+    }
+    while (!page.leaf) {
+        Entry *keysEnd = page.inner.keys + page.count;
+        unsigned int child =
+            std::upper_bound(page.inner.keys, keysEnd, first, PropertyRangeIndex::less) - page.inner.keys;
+        pageNumber = page.inner.children[child];
+        if (!this->readPage(pageNumber, page)) {
+            return nodes;
+        }
+    }
+    Entry *position = std::lower_bound(page.entries, page.entries + page.count, first, PropertyRangeIndex::less);
+    unsigned int i = position - page.entries;
+    while (true) {
+        for (; i < page.count; i++) {
+            if (page.entries[i].value > upper) {
+                return nodes;
+            }
+            nodes.push_back(page.entries[i].nodeIndex);
+        }
+        if (page.next == 0 || !this->readPage(page.next, page)) {
+            return nodes;
+        }
+        i = 0;
+    }
+}
+
+unsigned long PropertyRangeIndex::size() { return this->ensureOpen() ? this->meta.entries : 0; }
+
+PropertyIndex *PropertyIndex::acquire(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(PropertyIndex::openIndexesLock);
+    auto it = PropertyIndex::openIndexes.find(dbPrefix);
+    if (it != PropertyIndex::openIndexes.end()) {
+        it->second->references++;
+        return it->second;
+    }
+    PropertyIndex *index = new PropertyIndex(dbPrefix);
+    if (!index->open()) {
+        delete index;
+        return nullptr;
+    }
+    index->references++;
+    PropertyIndex::openIndexes[dbPrefix] = index;
+    return index;
+}
+
+void PropertyIndex::release(PropertyIndex *index) {
+    if (!index) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(PropertyIndex::openIndexesLock);
+    if (--index->references > 0) {
+        index->flush();
+        return;
+    }
+    PropertyIndex::openIndexes.erase(index->dbPrefix);
+    delete index;
+}
+
+PropertyIndex::PropertyIndex(const std::string &dbPrefix) : dbPrefix(dbPrefix) {}
+
+PropertyIndex::~PropertyIndex() { this->close(); }
+
+std::string PropertyIndex::indexPath(PropertyIndexType type, int number) {
+    return this->dbPrefix + "_property_index_" + std::to_string(number) +
+           (type == PropertyIndexType::HASH ? ".hash" : ".btree");
+}
+
+void PropertyIndex::openIndex(Definition &definition, int number) {
+    std::string path = this->indexPath(definition.type, number);
+    definition.hashIndex = definition.type == PropertyIndexType::HASH ? new PropertyHashIndex(path) : nullptr;
+    definition.rangeIndex = definition.type == PropertyIndexType::RANGE ? new PropertyRangeIndex(path) : nullptr;
+}
+
+/**
+ * Open the index definitions and load them. Definition records are [type (1)][property length (4)][property bytes],
+ * the position of a record numbers the files of its index.
+ * */
+bool PropertyIndex::open() {
+    std::string definitionsPath = this->dbPrefix + "_property_indexes.db";
+    this->definitionsFd = ::open(definitionsPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (this->definitionsFd < 0) {
+        property_index_logger.error("Error while opening property index definitions " + definitionsPath);
+        return false;
+    }
+    unsigned long long offset = 0;
+    char type;
+    unsigned int length;
+    while (pread(this->definitionsFd, &type, sizeof(type), offset) == sizeof(type) &&
+           pread(this->definitionsFd, &length, sizeof(length), offset + sizeof(type)) == sizeof(length)) {
+        std::string property(length, '\0');
+        if (pread(this->definitionsFd, &property[0], length, offset + sizeof(type) + sizeof(length)) !=
+            (ssize_t)length) {
+            property_index_logger.error("Property index definitions " + definitionsPath + " are corrupted!");
+            break;
+        }
+        Definition definition{static_cast<PropertyIndexType>(type), property, nullptr, nullptr};
+        this->openIndex(definition, this->definitions.size());
+        this->definitions.push_back(definition);
+        offset += sizeof(type) + sizeof(length) + length;
+    }
+    return true;
+}
+
+void PropertyIndex::close() {
+    for (Definition &definition : this->definitions) {
+        delete definition.hashIndex;
+        delete definition.rangeIndex;
+    }
+    this->definitions.clear();
+    if (this->definitionsFd >= 0) {
+        ::close(this->definitionsFd);
+        this->definitionsFd = -1;
+    }
+}
+
+bool PropertyIndex::create(const std::string &property, PropertyIndexType type) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (const Definition &definition : this->definitions) {
+        if (definition.property == property && definition.type == type) {
+            return false;
+        }
+    }
+    char typeCode = static_cast<char>(type);
+    unsigned int length = property.length();
+    std::string record(&typeCode, sizeof(typeCode));
+    record.append(reinterpret_cast<char *>(&length), sizeof(length));
+    record += property;
+    if (write(this->definitionsFd, record.data(), record.size()) != (ssize_t)record.size()) {
+        property_index_logger.error("Error while adding the index of " + property + " to " + this->dbPrefix);
+        return false;
+    }
+    Definition definition{type, property, nullptr, nullptr};
+    this->openIndex(definition, this->definitions.size());
+    this->definitions.push_back(definition);
+    return true;
+}
+
+bool PropertyIndex::isIndexed(const std::string &property) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (const Definition &definition : this->definitions) {
+        if (definition.property == property) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PropertyIndex::toInteger(const std::string &text, long long &value) {
+    if (text.empty()) {
+        return false;
+    }
+    char *end;
+    errno = 0;
+    value = strtoll(text.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
+
+bool PropertyIndex::inclusiveRange(long long &lower, bool lowerInclusive, long long &upper, bool upperInclusive) {
+    // An exclusive bound at the limit of long long leaves no integer to move to
+    if (!lowerInclusive) {
+        if (lower == LLONG_MAX) {
+            return false;
+        }
+        lower++;
+    }
+    if (!upperInclusive) {
+        if (upper == LLONG_MIN) {
+            return false;
+        }
+        upper--;
+    }
+    return lower <= upper;
+}
+
+unsigned long long PropertyIndex::hashValue(const std::string &text) {
+    // Integers hash by their canonical text, so 7 and "07" meet like they do in integer comparisons
+    long long integer;
+    std::string key = PropertyIndex::toInteger(text, integer) ? std::to_string(integer) : text;
+    unsigned long long hash = 14695981039346656037ULL;  // FNV-1a
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void PropertyIndex::insert(const std::string &property, const PropertyValue &value, unsigned int nodeIndex) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (Definition &definition : this->definitions) {
+        if (definition.property != property) {
+            continue;
+        }
+        std::string text = value.toString();
+        long long integer;
+        if (definition.hashIndex) {
+            definition.hashIndex->insert(PropertyIndex::hashValue(text), nodeIndex);
+        } else if (PropertyIndex::toInteger(text, integer)) {
+            definition.rangeIndex->insert(integer, nodeIndex);
+        }
+    }
+}
+
+bool PropertyIndex::seek(const std::string &property, const std::string &value, std::vector<unsigned int> &nodes) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    PropertyRangeIndex *rangeIndex = nullptr;
+    for (Definition &definition : this->definitions) {
+        if (definition.property != property) {
+            continue;
+        }
+        if (definition.hashIndex) {
+            nodes = definition.hashIndex->seek(PropertyIndex::hashValue(value));
+            std::sort(nodes.begin(), nodes.end());
+            return true;
+        }
+        rangeIndex = definition.rangeIndex;
+    }
+    if (!rangeIndex) {
+        return false;
+    }
+    long long integer;
+    nodes.clear();
+    if (PropertyIndex::toInteger(value, integer)) {
+        nodes = rangeIndex->scan(integer, integer);
+        std::sort(nodes.begin(), nodes.end());
+    }
+    return true;
+}
+
+bool PropertyIndex::rangeScan(const std::string &property, long long lower, long long upper,
+                              std::vector<unsigned int> &nodes) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (Definition &definition : this->definitions) {
+        if (definition.property == property && definition.rangeIndex) {
+            nodes = definition.rangeIndex->scan(lower, upper);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PropertyIndex::flush() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (Definition &definition : this->definitions) {
+        if (definition.hashIndex) {
+            definition.hashIndex->flush();
+        }
+    }
+}
+
+void PropertyIndex::truncate() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (size_t number = 0; number < this->definitions.size(); number++) {
+        Definition &definition = this->definitions[number];
+        delete definition.hashIndex;
+        delete definition.rangeIndex;
+        std::remove(this->indexPath(definition.type, number).c_str());
+    }
+    this->definitions.clear();
+    if (ftruncate(this->definitionsFd, 0) != 0) {
+        property_index_logger.error("Error while truncating the property indexes of " + this->dbPrefix);
+    }
+}
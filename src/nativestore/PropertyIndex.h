@@ -0,0 +1,192 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_PROPERTYINDEX_H
+#define JASMINEGRAPH_PROPERTYINDEX_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "PropertyStore.h"
+
+enum class PropertyIndexType : char { HASH = 'h', RANGE = 'r' };
+
+/**
+ * Equality index of one node property: an open addressing hash table file (_property_index_<n>.hash) of
+ * (value hash, node block index) pairs, memory mapped on first use. A property value can map to many nodes, a seek
+ * collects every bucket of the probe sequence with the hash of the value. Hash collisions make a seek return extra
+ * nodes, so seek results are candidates to be checked against the predicate.
+ * */
+class PropertyHashIndex {
+ public:
+    explicit PropertyHashIndex(const std::string &path);
+    ~PropertyHashIndex();
+
+    void insert(unsigned long long hash, unsigned int nodeIndex);
+    std::vector<unsigned int> seek(unsigned long long hash);
+    unsigned long size();
+    void flush();
+
+ private:
+    struct Bucket {
+        unsigned long long hash;
+        unsigned int nodeIndex;  // Node block index + 1, 0 marks an empty bucket
+        unsigned int reserved;
+    };
+
+    struct Header {
+        char magic[8];
+        unsigned long long capacity;
+        unsigned long long count;
+    };
+
+    bool ensureOpen();
+    bool mapTable(int fd, unsigned long long capacity, bool create);
+    bool grow();
+    void closeFile();
+    void insertBucket(const Bucket &bucket);
+
+    std::string path;
+    int fd = -1;
+    Header *header = nullptr;
+    Bucket *buckets = nullptr;
+    unsigned long mappedSize = 0;
+};
+
+/**
+ * Range index of one integer node property: a B+-tree file (_property_index_<n>.btree) of 4KB pages keyed by
+ * (value, node block index). Leaves are linked in key order, so a range scan is one root to leaf descent followed by
+ * a sequential walk over the leaves. Pages are read and written with pread/pwrite and stay in the OS page cache.
+ * */
+class PropertyRangeIndex {
+ public:
+    explicit PropertyRangeIndex(const std::string &path);
+    ~PropertyRangeIndex();
+
+    void insert(long long value, unsigned int nodeIndex);
+    // Nodes with lower <= value <= upper, in value order
+    std::vector<unsigned int> scan(long long lower, long long upper);
+    unsigned long size();
+
+    static const unsigned int PAGE_SIZE = 4096;
+
+ private:
+    struct Entry {
+        long long value;
+        unsigned int nodeIndex;
+        unsigned int reserved;
+    };
+
+    static const unsigned int LEAF_CAPACITY = (PAGE_SIZE - 16) / sizeof(Entry);
+    static const unsigned int INNER_CAPACITY = (PAGE_SIZE - 16 - sizeof(unsigned int)) /
+                                               (sizeof(Entry) + sizeof(unsigned int));
+
+    struct Page {
+        unsigned int leaf;
+        unsigned int count;  // Entries of a leaf, separator keys of an inner page
+        unsigned int next;   // Next leaf in key order, 0 for the last leaf
+        unsigned int reserved;
+        union {
+            Entry entries[LEAF_CAPACITY];
+            struct {
+                Entry keys[INNER_CAPACITY];  // keys[i] is the smallest entry under children[i + 1]
+                unsigned int children[INNER_CAPACITY + 1];
+            } inner;
+        };
+    };
+
+    struct Meta {
+        char magic[8];
+        unsigned int root;
+        unsigned int pages;
+        unsigned long long entries;
+    };
+
+    bool ensureOpen();
+    bool readPage(unsigned int number, Page &page);
+    bool writePage(unsigned int number, const Page &page);
+    bool writeMeta();
+    unsigned int allocatePage();
+    // Insert into the subtree at pageNumber, returns true and the separator and new page if the page was split
+    bool insertInto(unsigned int pageNumber, const Entry &entry, bool &inserted, Entry &separator,
+                    unsigned int &splitPage);
+    static bool less(const Entry &left, const Entry &right);
+
+    std::string path;
+    int fd = -1;
+    Meta meta;
+};
+
+/**
+ * Secondary property indexes of a native store partition, created with CREATE INDEX and used by the NodeIndexSeek and
+ * NodeIndexRangeScan operators instead of a full node scan. The indexed properties are listed in _property_indexes.db.
+ * HASH indexes answer equality predicates on the text of a value. RANGE indexes answer equality and range
+ * predicates over integer values, values that are not integers are not indexed, they never satisfy an integer
+ * comparison. An index covers the property on every node of the partition, label predicates are answered by the
+ * label index.
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see PropertyIndex::acquire().
+ * */
+class PropertyIndex {
+ public:
+    static PropertyIndex *acquire(const std::string &dbPrefix);
+    static void release(PropertyIndex *index);
+
+    // Register an index of the property, false if the property is already indexed with that type
+    bool create(const std::string &property, PropertyIndexType type);
+    bool isIndexed(const std::string &property);
+    // Add a node to the indexes of the property, a no-op for properties without an index
+    void insert(const std::string &property, const PropertyValue &value, unsigned int nodeIndex);
+    // Candidate nodes whose property equals the value, false if the property has no index
+    bool seek(const std::string &property, const std::string &value, std::vector<unsigned int> &nodes);
+    // Nodes whose integer property is within [lower, upper], false if the property has no range index
+    bool rangeScan(const std::string &property, long long lower, long long upper, std::vector<unsigned int> &nodes);
+    void flush();
+    // Drop every index of the partition, used when a partition is opened in trunc mode
+    void truncate();
+
+    // Integer form of the value text, false if the text is not an integer
+    static bool toInteger(const std::string &text, long long &value);
+    // Move exclusive bounds to the next integer inside the range, false if no integer is within the range
+    static bool inclusiveRange(long long &lower, bool lowerInclusive, long long &upper, bool upperInclusive);
+
+ private:
+    explicit PropertyIndex(const std::string &dbPrefix);
+    ~PropertyIndex();
+
+    struct Definition {
+        PropertyIndexType type;
+        std::string property;
+        PropertyHashIndex *hashIndex;
+        PropertyRangeIndex *rangeIndex;
+    };
+
+    bool open();
+    void close();
+    void openIndex(Definition &definition, int number);
+    std::string indexPath(PropertyIndexType type, int number);
+    static unsigned long long hashValue(const std::string &text);
+
+    std::string dbPrefix;
+    int definitionsFd = -1;
+    std::vector<Definition> definitions;  // In creation order, the position is the number of the index files
+    std::mutex lock;
+    int references = 0;
+
+    static std::map<std::string, PropertyIndex *> openIndexes;
+    static std::mutex openIndexesLock;
+};
+
+#endif  // JASMINEGRAPH_PROPERTYINDEX_H
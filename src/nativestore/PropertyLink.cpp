@@ -18,47 +18,64 @@ limitations under the License.
 #include <vector>
 
 #include "../util/logger/Logger.h"
+#include "BlockAllocator.h"
+#include "BlockCache.h"
+#include "BlockFormat.h"
+#include "StorageMetrics.h"
 
 Logger property_link_logger;
-thread_local unsigned int PropertyLink::nextPropertyIndex = 1;
 thread_local std::fstream* PropertyLink::propertiesDB = NULL;
+thread_local MappedFile* PropertyLink::propertiesMap = NULL;
 pthread_mutex_t lockPropertyLink;
 pthread_mutex_t lockCreatePropertyLink;
 pthread_mutex_t lockInsertPropertyLink;
 pthread_mutex_t lockGetPropertyLink;
 
-PropertyLink::PropertyLink(unsigned int propertyBlockAddress) : blockAddress(propertyBlockAddress) {
-    // The problem is when we create the PropertyLink.
+PropertyLink::PropertyLink(unsigned long propertyBlockAddress) : blockAddress(propertyBlockAddress) {
     pthread_mutex_lock(&lockPropertyLink);
     if (propertyBlockAddress > 0) {
-        PropertyLink::propertiesDB->seekg(propertyBlockAddress);
-        char rawName[PropertyLink::MAX_NAME_SIZE] = {0};
-        //        property_link_logger.info("Traverse state  = " +
-        //        std::to_string(PropertyLink::propertiesDB->rdstate()));
-
-        if (!this->propertiesDB->read(reinterpret_cast<char*>(&rawName), PropertyLink::MAX_NAME_SIZE)) {
-            property_link_logger.error("Error while reading node property name from block " +
-                                       std::to_string(blockAddress));
-        }
-        property_link_logger.debug(
-            "Current file descriptor curser position = " + std::to_string(this->propertiesDB->tellg()) +
-            " when reading = " + std::to_string(blockAddress));
-        if (!this->propertiesDB->read(reinterpret_cast<char*>(&this->value), PropertyLink::MAX_VALUE_SIZE)) {
-            property_link_logger.error("Error while reading node property value from block " +
-                                       std::to_string(blockAddress));
-        }
-
-        if (!this->propertiesDB->read(reinterpret_cast<char*>(&(this->nextPropAddress)), sizeof(unsigned int))) {
-            property_link_logger.error("Error while reading node property next address from block " +
+        char block[PropertyLink::PROPERTY_BLOCK_SIZE] = {0};
+        if (!PropertyLink::readBlock(propertyBlockAddress, block)) {
+            property_link_logger.error("Error while reading node property from block " +
                                        std::to_string(blockAddress));
         }
-
-        this->name = std::string(rawName);
+        const char* rawValue = block + PropertyLink::MAX_NAME_SIZE;
+        std::memcpy(this->value, rawValue, PropertyLink::MAX_VALUE_SIZE);
+        unsigned int nextRecord;
+        std::memcpy(&nextRecord, rawValue + PropertyLink::MAX_VALUE_SIZE, sizeof(nextRecord));
+        this->nextPropAddress = BlockFormat::decode(nextRecord, PropertyLink::PROPERTY_BLOCK_SIZE);
+        this->name = std::string(block, strnlen(block, PropertyLink::MAX_NAME_SIZE));
     }
     pthread_mutex_unlock(&lockPropertyLink);
 };
 
-PropertyLink::PropertyLink(unsigned int blockAddress, std::string name, const char* rvalue, unsigned int nextAddress)
+static bool loadPropertyBlock(unsigned long propertyBlockAddress, char* block) {
+    if (PropertyLink::propertiesMap) {
+        return PropertyLink::propertiesMap->read(propertyBlockAddress, block, PropertyLink::PROPERTY_BLOCK_SIZE);
+    }
+    PropertyLink::propertiesDB->seekg(propertyBlockAddress);
+    if (!PropertyLink::propertiesDB->read(block, PropertyLink::PROPERTY_BLOCK_SIZE)) {
+        PropertyLink::propertiesDB->clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read a whole property block through the block cache. On a miss it is loaded with a single read, or from the memory
+ * mapped DB when the store runs in mmap mode
+ * */
+bool PropertyLink::readBlock(unsigned long propertyBlockAddress, char* block) {
+    StorageMetrics::ReadTimer timer(BlockFile::PROPERTIES, PropertyLink::PROPERTY_BLOCK_SIZE);
+    return BlockCache::getInstance()->read(
+        BlockFile::PROPERTIES, propertyBlockAddress, block, PropertyLink::PROPERTY_BLOCK_SIZE,
+        [propertyBlockAddress, &timer](char* buffer) {
+            timer.load(!PropertyLink::propertiesMap);
+            return loadPropertyBlock(propertyBlockAddress, buffer);
+        });
+}
+
+PropertyLink::PropertyLink(unsigned long blockAddress, std::string name, const char* rvalue, unsigned long nextAddress)
     : blockAddress(blockAddress), nextPropAddress(nextAddress), name(name) {
     memcpy(this->value, rvalue, PropertyLink::MAX_VALUE_SIZE);
 };
@@ -85,7 +102,7 @@ PropertyLink::PropertyLink(unsigned int blockAddress, std::string name, const ch
  * if propertyAddress was 0 before inserting you will get head address of the link in return value
  *  else either updated link address or last appended link address will be returned
  * **/
-unsigned int PropertyLink::insert(std::string name, const char* value) {
+unsigned long PropertyLink::insert(std::string name, const char* value) {
     // TODO(thevindu-w): Temporarily commented to resolve conflict
     /*
     if (this->nextPropAddress) {  // for
@@ -131,7 +148,9 @@ unsigned int PropertyLink::insert(std::string name, const char* value) {
         //        property_link_logger.debug("Next prop index = " + std::to_string(PropertyLink::nextPropertyIndex));
 
         pthread_mutex_lock(&lockInsertPropertyLink);
-        unsigned int newAddress = PropertyLink::nextPropertyIndex * PropertyLink::PROPERTY_BLOCK_SIZE;
+        unsigned long newAddress =
+                BlockAllocator::current->allocate(BlockFile::PROPERTIES) * PropertyLink::PROPERTY_BLOCK_SIZE;
+        StorageMetrics::recordWrite(BlockFile::PROPERTIES, PropertyLink::PROPERTY_BLOCK_SIZE);
         this->propertiesDB->seekp(newAddress);
         this->propertiesDB->write(dataName, PropertyLink::MAX_NAME_SIZE);
         this->propertiesDB->write(reinterpret_cast<char*>(dataValue), PropertyLink::MAX_VALUE_SIZE);
@@ -142,17 +161,21 @@ unsigned int PropertyLink::insert(std::string name, const char* value) {
         }
 
         this->nextPropAddress = newAddress;
+        unsigned int nextRecord = BlockFormat::encode(newAddress, PropertyLink::PROPERTY_BLOCK_SIZE);
+        StorageMetrics::recordWrite(BlockFile::PROPERTIES, sizeof(nextRecord));
         this->propertiesDB->seekp(this->blockAddress + PropertyLink::MAX_NAME_SIZE +
                                   PropertyLink::MAX_VALUE_SIZE);  // seek to current property next address
-        if (!this->propertiesDB->write(reinterpret_cast<char*>(&newAddress), sizeof(newAddress))) {
+        if (!this->propertiesDB->write(reinterpret_cast<char*>(&nextRecord), sizeof(nextRecord))) {
             property_link_logger.error("Error while updating  property next address for " + name +
                                        " into block address " + std::to_string(this->blockAddress));
             return -1;
         }
+        BlockCache::getInstance()->update(BlockFile::PROPERTIES, this->blockAddress,
+                                          PropertyLink::MAX_NAME_SIZE + PropertyLink::MAX_VALUE_SIZE,
+                                          reinterpret_cast<char*>(&nextRecord), sizeof(nextRecord));
         this->propertiesDB->flush();
 
         //        property_link_logger.info("nextPropertyIndex = " + std::to_string(PropertyLink::nextPropertyIndex));
-        PropertyLink::nextPropertyIndex++;  // Increment the shared property index value
         pthread_mutex_unlock(&lockInsertPropertyLink);
         return this->blockAddress;
     }
@@ -171,7 +194,9 @@ PropertyLink* PropertyLink::create(std::string name, const char* value) {
     unsigned int nextAddress = 0;
     char dataName[PropertyLink::MAX_NAME_SIZE] = {0};
     strcpy(dataName, name.c_str());
-    unsigned int newAddress = PropertyLink::nextPropertyIndex * PropertyLink::PROPERTY_BLOCK_SIZE;
+    unsigned long newAddress =
+            BlockAllocator::current->allocate(BlockFile::PROPERTIES) * PropertyLink::PROPERTY_BLOCK_SIZE;
+    StorageMetrics::recordWrite(BlockFile::PROPERTIES, PropertyLink::PROPERTY_BLOCK_SIZE);
     PropertyLink::propertiesDB->seekp(newAddress);
     PropertyLink::propertiesDB->write(dataName, PropertyLink::MAX_NAME_SIZE);
     PropertyLink::propertiesDB->write(reinterpret_cast<const char*>(value), PropertyLink::MAX_VALUE_SIZE);
@@ -183,7 +208,6 @@ PropertyLink* PropertyLink::create(std::string name, const char* value) {
     PropertyLink::propertiesDB->flush();
     //    property_link_logger.info("nextPropertyIndex = " + std::to_string(PropertyLink::nextPropertyIndex));
     //    property_link_logger.info("newAddress = " + std::to_string(newAddress));
-    PropertyLink::nextPropertyIndex++;  // Increment the shared property index value
     pthread_mutex_unlock(&lockCreatePropertyLink);
     return new PropertyLink(newAddress, name, value, nextAddress);
 }
@@ -200,40 +224,22 @@ PropertyLink* PropertyLink::next() {
 
 bool PropertyLink::isEmpty() { return !(this->blockAddress); }
 
-PropertyLink* PropertyLink::get(unsigned int propertyBlockAddress) {
+PropertyLink* PropertyLink::get(unsigned long propertyBlockAddress) {
     PropertyLink* pl = NULL;
 
     pthread_mutex_lock(&lockGetPropertyLink);
     if (propertyBlockAddress > 0) {
-        char propertyName[PropertyLink::MAX_NAME_SIZE] = {0};
-        char propertyValue[PropertyLink::MAX_VALUE_SIZE] = {0};
-        unsigned int nextAddress;
-        PropertyLink::propertiesDB->seekg(propertyBlockAddress);
-
-        //        property_link_logger.info("Searching propertyHead state  = " +
-        //        std::to_string(PropertyLink::propertiesDB->rdstate())); std::cout << "Stream state: " <<
-        //        PropertyLink::propertiesDB->rdstate() << std::endl; std::string PropertyLink::propertiesDB->rdstate();
-        if (!PropertyLink::propertiesDB->read(reinterpret_cast<char*>(&propertyName), PropertyLink::MAX_NAME_SIZE)) {
-            //            property_link_logger.error("Error  = " +
-            //                                       std::to_string(PropertyLink::propertiesDB->rdstate()));
-            property_link_logger.error("Error while reading node property name from block = " +
-                                       std::to_string(propertyBlockAddress));
-        }
-        if (!PropertyLink::propertiesDB->read(reinterpret_cast<char*>(&propertyValue), PropertyLink::MAX_VALUE_SIZE)) {
-            property_link_logger.error("Error while reading node property value from block = " +
+        char block[PropertyLink::PROPERTY_BLOCK_SIZE] = {0};
+        unsigned int nextRecord;
+        if (!PropertyLink::readBlock(propertyBlockAddress, block)) {
+            property_link_logger.error("Error while reading node property from block = " +
                                        std::to_string(propertyBlockAddress));
         }
-
-        if (!PropertyLink::propertiesDB->read(reinterpret_cast<char*>(&(nextAddress)), sizeof(unsigned int))) {
-            property_link_logger.error("Error while reading node property next address from block = " +
-                                       std::to_string(propertyBlockAddress));
-        }
-        //        property_link_logger.info("Property head propertyBlockAddress  = " +
-        //        std::to_string(propertyBlockAddress)); property_link_logger.info("Property head property name  = " +
-        //        std::string(propertyName)); property_link_logger.info("Property head nextAddress   = " +
-        //        std::to_string(nextAddress));
-
-        pl = new PropertyLink(propertyBlockAddress, std::string(propertyName), propertyValue, nextAddress);
+        char* rawValue = block + PropertyLink::MAX_NAME_SIZE;
+        std::memcpy(&nextRecord, rawValue + PropertyLink::MAX_VALUE_SIZE, sizeof(nextRecord));
+        std::string propertyName(block, strnlen(block, PropertyLink::MAX_NAME_SIZE));
+        unsigned long nextAddress = BlockFormat::decode(nextRecord, PropertyLink::PROPERTY_BLOCK_SIZE);
+        pl = new PropertyLink(propertyBlockAddress, propertyName, rawValue, nextAddress);
     }
     pthread_mutex_unlock(&lockGetPropertyLink);
     return pl;
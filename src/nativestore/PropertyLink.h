@@ -16,6 +16,8 @@ limitations under the License.
 #include <set>
 #include <string>
 
+#include "MappedFile.h"
+
 #ifndef PROPERTY_LINK
 #define PROPERTY_LINK
 
@@ -23,28 +25,29 @@ class PropertyLink {
  public:
     static const unsigned long MAX_NAME_SIZE = 30;    // Size of a property name in bytes
     static const unsigned long MAX_VALUE_SIZE = 400;  // Size of a property value in bytes
-    static thread_local unsigned int nextPropertyIndex;            // Next available property block index
     // unless open in wipe data
     // mode(trunc) need to set this value to property db seekp()/BLOCK_SIZE
     static const unsigned long PROPERTY_BLOCK_SIZE = MAX_NAME_SIZE + MAX_VALUE_SIZE + sizeof(unsigned int);
 
     std::string name;
     char value[PropertyLink::MAX_VALUE_SIZE] = {0};
-    unsigned int blockAddress;  // contains the address of the first element in the list
-    unsigned int nextPropAddress;
+    unsigned long blockAddress;  // contains the address of the first element in the list
+    unsigned long nextPropAddress;
 
     static thread_local std::string DB_PATH;
     static thread_local std::fstream* propertiesDB;
+    static thread_local MappedFile* propertiesMap;  // Set only in mmap storage mode
 
 
 
-    PropertyLink(unsigned int);
-    PropertyLink(unsigned int, std::string, const char*, unsigned int);
+    PropertyLink(unsigned long);
+    PropertyLink(unsigned long, std::string, const char*, unsigned long);
     bool isEmpty();
-    static PropertyLink* get(unsigned int);
+    static PropertyLink* get(unsigned long);
+    static bool readBlock(unsigned long, char*);
     static PropertyLink* create(std::string, const char*);
 
-    unsigned int insert(std::string, const char*);
+    unsigned long insert(std::string, const char*);
     PropertyLink* next();
 };
 
@@ -0,0 +1,444 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "PropertyStore.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../util/logger/Logger.h"
+
+Logger property_store_logger;
+
+const std::string PropertyStore::COLUMNAR = "columnar";
+const std::string PropertyStore::LINKED = "linked";
+thread_local PropertyStore *PropertyStore::current = nullptr;
+std::map<std::string, PropertyStore *> PropertyStore::openStores;
+std::mutex PropertyStore::openStoresLock;
+
+static const char OWNERS[] = {static_cast<char>(PropertyOwner::NODE), static_cast<char>(PropertyOwner::LOCAL_RELATION),
+                              static_cast<char>(PropertyOwner::CENTRAL_RELATION)};
+
+PropertyValue PropertyValue::ofInt(long long value) {
+    PropertyValue property;
+    property.type = PropertyType::INT64;
+    property.intValue = value;
+    return property;
+}
+
+PropertyValue PropertyValue::ofDouble(double value) {
+    PropertyValue property;
+    property.type = PropertyType::DOUBLE;
+    property.doubleValue = value;
+    return property;
+}
+
+PropertyValue PropertyValue::ofBool(bool value) {
+    PropertyValue property;
+    property.type = PropertyType::BOOL;
+    property.boolValue = value;
+    return property;
+}
+
+PropertyValue PropertyValue::ofString(const std::string &value) {
+    PropertyValue property;
+    property.type = PropertyType::STRING;
+    property.stringValue = value;
+    return property;
+}
+
+std::string PropertyValue::toString() const {
+    switch (this->type) {
+        case PropertyType::INT64:
+            return std::to_string(this->intValue);
+        case PropertyType::DOUBLE: {
+            // Shortest of %.15g and %.17g that reads back as the same double
+            char text[32];
+            snprintf(text, sizeof(text), "%.15g", this->doubleValue);
+            if (std::strtod(text, nullptr) != this->doubleValue) {
+                snprintf(text, sizeof(text), "%.17g", this->doubleValue);
+            }
+            return text;
+        }
+        case PropertyType::BOOL:
+            return this->boolValue ? "true" : "false";
+        case PropertyType::STRING:
+            return this->stringValue;
+        default:
+            return "";
+    }
+}
+
+PropertyStore *PropertyStore::acquire(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(PropertyStore::openStoresLock);
+    auto it = PropertyStore::openStores.find(dbPrefix);
+    if (it != PropertyStore::openStores.end()) {
+        it->second->references++;
+        return it->second;
+    }
+    PropertyStore *store = new PropertyStore(dbPrefix);
+    if (!store->open()) {
+        delete store;
+        return nullptr;
+    }
+    store->references++;
+    PropertyStore::openStores[dbPrefix] = store;
+    return store;
+}
+
+void PropertyStore::release(PropertyStore *store) {
+    if (!store) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(PropertyStore::openStoresLock);
+    if (--store->references > 0) {
+        store->flush();
+        return;
+    }
+    PropertyStore::openStores.erase(store->dbPrefix);
+    delete store;
+}
+
+bool PropertyStore::exists(const std::string &dbPrefix) {
+    struct stat stat_buf;
+    return stat((dbPrefix + "_property_keys.db").c_str(), &stat_buf) == 0;
+}
+
+void PropertyStore::remove(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(PropertyStore::openStoresLock);
+    auto it = PropertyStore::openStores.find(dbPrefix);
+    if (it != PropertyStore::openStores.end()) {
+        it->second->truncate();  // Still used by another NodeManager, keep the files but drop their data
+        return;
+    }
+    if (!PropertyStore::exists(dbPrefix)) {
+        return;
+    }
+    PropertyStore store(dbPrefix);
+    if (store.open()) {
+        store.truncate();
+        store.close();
+    }
+    std::remove((dbPrefix + "_property_keys.db").c_str());
+    std::remove((dbPrefix + "_property_strings.db").c_str());
+}
+
+PropertyStore::PropertyStore(const std::string &dbPrefix) : dbPrefix(dbPrefix) {}
+
+PropertyStore::~PropertyStore() { this->close(); }
+
+/**
+ * Open the key dictionary and the string heap, and load the dictionary. Dictionary records are
+ * [name length (4)][name bytes], the key ID of a name is the position of its record.
+ * */
+bool PropertyStore::open() {
+    std::string keysPath = this->dbPrefix + "_property_keys.db";
+    std::string stringsPath = this->dbPrefix + "_property_strings.db";
+    this->keysFd = ::open(keysPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    this->stringsFd = ::open(stringsPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->keysFd < 0 || this->stringsFd < 0) {
+        property_store_logger.error("Error while opening property store files of " + this->dbPrefix);
+        this->close();
+        return false;
+    }
+    struct stat stat_buf;
+    fstat(this->stringsFd, &stat_buf);
+    this->stringsSize = stat_buf.st_size;
+
+    unsigned long long offset = 0;
+    unsigned int length;
+    while (pread(this->keysFd, &length, sizeof(length), offset) == sizeof(length)) {
+        std::string name(length, '\0');
+        if (pread(this->keysFd, &name[0], length, offset + sizeof(length)) != (ssize_t)length) {
+            property_store_logger.error("Property key dictionary of " + this->dbPrefix + " is corrupted!");
+            break;
+        }
+        this->keyIds[name] = this->keyNames.size();
+        this->keyNames.push_back(name);
+        offset += sizeof(length) + length;
+    }
+    return true;
+}
+
+void PropertyStore::close() {
+    for (auto &column : this->columnFds) {
+        if (column.second >= 0) {
+            ::close(column.second);
+        }
+    }
+    this->columnFds.clear();
+    if (this->keysFd >= 0) {
+        ::close(this->keysFd);
+        this->keysFd = -1;
+    }
+    if (this->stringsFd >= 0) {
+        ::close(this->stringsFd);
+        this->stringsFd = -1;
+    }
+}
+
+void PropertyStore::truncate() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (auto &column : this->columnFds) {
+        if (column.second >= 0) {
+            ::close(column.second);
+        }
+    }
+    this->columnFds.clear();
+    for (int key = 0; key < (int)this->keyNames.size(); key++) {
+        for (char owner : OWNERS) {
+            std::remove(this->columnPath(static_cast<PropertyOwner>(owner), key).c_str());
+        }
+    }
+    this->keyNames.clear();
+    this->keyIds.clear();
+    if (ftruncate(this->keysFd, 0) != 0 || ftruncate(this->stringsFd, 0) != 0) {
+        property_store_logger.error("Error while truncating property store of " + this->dbPrefix);
+    }
+    this->stringsSize = 0;
+}
+
+std::string PropertyStore::columnPath(PropertyOwner owner, int key) {
+    return this->dbPrefix + "_property_" + static_cast<char>(owner) + std::to_string(key) + ".col";
+}
+
+int PropertyStore::keyId(const std::string &name, bool create) {
+    auto it = this->keyIds.find(name);
+    if (it != this->keyIds.end()) {
+        return it->second;
+    }
+    if (!create) {
+        return -1;
+    }
+    unsigned int length = name.length();
+    std::string record(reinterpret_cast<char *>(&length), sizeof(length));
+    record += name;
+    if (write(this->keysFd, record.data(), record.size()) != (ssize_t)record.size()) {
+        property_store_logger.error("Error while adding property key " + name + " to " + this->dbPrefix);
+        return -1;
+    }
+    int key = this->keyNames.size();
+    this->keyIds[name] = key;
+    this->keyNames.push_back(name);
+    return key;
+}
+
+int PropertyStore::columnFd(PropertyOwner owner, int key, bool create) {
+    std::pair<char, int> column(static_cast<char>(owner), key);
+    auto it = this->columnFds.find(column);
+    if (it != this->columnFds.end() && (it->second >= 0 || !create)) {
+        return it->second;
+    }
+    std::string path = this->columnPath(owner, key);
+    int fd = ::open(path.c_str(), create ? O_RDWR | O_CREAT : O_RDWR, 0644);
+    if (fd < 0 && create) {
+        property_store_logger.error("Error while opening property column " + path);
+    }
+    this->columnFds[column] = fd;
+    return fd;
+}
+
+bool PropertyStore::readCell(PropertyOwner owner, int key, unsigned int row, Cell &cell) {
+    int fd = this->columnFd(owner, key, false);
+    if (fd < 0) {
+        return false;
+    }
+    // Rows past the end of the column and holes read as NONE cells
+    if (pread(fd, &cell, sizeof(Cell), (off_t)row * sizeof(Cell)) != sizeof(Cell)) {
+        return false;
+    }
+    return cell.type != PropertyType::NONE;
+}
+
+bool PropertyStore::decode(const Cell &cell, PropertyValue &value) {
+    value.type = cell.type;
+    switch (cell.type) {
+        case PropertyType::INT64:
+            std::memcpy(&value.intValue, &cell.payload, sizeof(value.intValue));
+            return true;
+        case PropertyType::DOUBLE:
+            std::memcpy(&value.doubleValue, &cell.payload, sizeof(value.doubleValue));
+            return true;
+        case PropertyType::BOOL:
+            value.boolValue = cell.payload != 0;
+            return true;
+        case PropertyType::STRING:
+            value.stringValue.resize(cell.length);
+            if (cell.length <= sizeof(cell.payload)) {
+                std::memcpy(&value.stringValue[0], &cell.payload, cell.length);
+                return true;
+            }
+            if (pread(this->stringsFd, &value.stringValue[0], cell.length, cell.payload) != (ssize_t)cell.length) {
+                property_store_logger.error("Error while reading property string at " + std::to_string(cell.payload));
+                return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool PropertyStore::set(PropertyOwner owner, unsigned int row, const std::string &name, const PropertyValue &value) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    int key = this->keyId(name, true);
+    if (key < 0) {
+        return false;
+    }
+    int fd = this->columnFd(owner, key, true);
+    if (fd < 0) {
+        return false;
+    }
+    Cell cell = {};
+    cell.type = value.type;
+    switch (value.type) {
+        case PropertyType::INT64:
+            std::memcpy(&cell.payload, &value.intValue, sizeof(value.intValue));
+            break;
+        case PropertyType::DOUBLE:
+            std::memcpy(&cell.payload, &value.doubleValue, sizeof(value.doubleValue));
+            break;
+        case PropertyType::BOOL:
+            cell.payload = value.boolValue;
+            break;
+        case PropertyType::STRING:
+            cell.length = value.stringValue.length();
+            if (cell.length <= sizeof(cell.payload)) {
+                std::memcpy(&cell.payload, value.stringValue.data(), cell.length);
+                break;
+            }
+            if (pwrite(this->stringsFd, value.stringValue.data(), cell.length, this->stringsSize) !=
+                (ssize_t)cell.length) {
+                property_store_logger.error("Error while writing property string of " + name);
+                return false;
+            }
+            cell.payload = this->stringsSize;
+            this->stringsSize += cell.length;
+            break;
+        default:
+            break;
+    }
+    if (pwrite(fd, &cell, sizeof(Cell), (off_t)row * sizeof(Cell)) != sizeof(Cell)) {
+        property_store_logger.error("Error while writing property " + name + " of row " + std::to_string(row));
+        return false;
+    }
+    return true;
+}
+
+bool PropertyStore::get(PropertyOwner owner, unsigned int row, const std::string &name, PropertyValue &value) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    int key = this->keyId(name, false);
+    Cell cell;
+    if (key < 0 || !this->readCell(owner, key, row, cell)) {
+        return false;
+    }
+    return this->decode(cell, value);
+}
+
+std::map<std::string, PropertyValue> PropertyStore::getAll(PropertyOwner owner, unsigned int row) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    std::map<std::string, PropertyValue> properties;
+    for (int key = 0; key < (int)this->keyNames.size(); key++) {
+        Cell cell;
+        PropertyValue value;
+        if (this->readCell(owner, key, row, cell) && this->decode(cell, value)) {
+            properties.emplace(this->keyNames[key], std::move(value));
+        }
+    }
+    return properties;
+}
+
+void PropertyStore::clear(PropertyOwner owner, unsigned int row) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    const Cell none = {};
+    for (int key = 0; key < (int)this->keyNames.size(); key++) {
+        Cell cell;
+        if (!this->readCell(owner, key, row, cell)) {
+            continue;
+        }
+        // Strings in the heap stay there, the heap is append only
+        if (pwrite(this->columnFd(owner, key, false), &none, sizeof(Cell), (off_t)row * sizeof(Cell)) != sizeof(Cell)) {
+            property_store_logger.error("Error while clearing property " + this->keyNames[key] + " of row " +
+                                        std::to_string(row));
+        }
+    }
+}
+
+std::vector<std::string> PropertyStore::getKeys() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->keyNames;
+}
+
+std::vector<std::pair<std::string, std::string>> PropertyStore::renumberRows(PropertyOwner owner,
+                                                                          const std::vector<unsigned int> &rows) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    std::vector<std::pair<std::string, std::string>> copies;
+    for (int key = 0; key < (int)this->keyNames.size(); key++) {
+        std::string path = this->columnPath(owner, key);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            continue;
+        }
+        struct stat stat_buf;
+        fstat(fd, &stat_buf);
+        std::vector<Cell> cells(stat_buf.st_size / sizeof(Cell));
+        ssize_t size = cells.size() * sizeof(Cell);
+        bool read = pread(fd, cells.data(), size, 0) == size;
+        ::close(fd);
+        std::string copyPath = path + ".compact";
+        int copyFd = ::open(copyPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (!read || copyFd < 0) {
+            property_store_logger.error("Error while renumbering property column " + path);
+            if (copyFd >= 0) {
+                ::close(copyFd);
+            }
+            continue;
+        }
+        for (unsigned int row = 0; row < cells.size() && row < rows.size(); row++) {
+            if (cells[row].type != PropertyType::NONE &&
+                pwrite(copyFd, &cells[row], sizeof(Cell), (off_t)rows[row] * sizeof(Cell)) != sizeof(Cell)) {
+                property_store_logger.error("Error while writing property column " + copyPath);
+            }
+        }
+        fdatasync(copyFd);
+        ::close(copyFd);
+        copies.push_back({copyPath, path});
+    }
+    return copies;
+}
+
+void PropertyStore::reopenColumns() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (auto &column : this->columnFds) {
+        if (column.second >= 0) {
+            ::close(column.second);
+        }
+    }
+    this->columnFds.clear();
+}
+
+void PropertyStore::flush() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (auto &column : this->columnFds) {
+        if (column.second >= 0) {
+            fdatasync(column.second);
+        }
+    }
+    if (this->stringsFd >= 0) {
+        fdatasync(this->stringsFd);
+    }
+}
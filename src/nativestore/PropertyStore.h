@@ -0,0 +1,117 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_PROPERTYSTORE_H
+#define JASMINEGRAPH_PROPERTYSTORE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+enum class PropertyType : unsigned char { NONE = 0, INT64 = 1, DOUBLE = 2, BOOL = 3, STRING = 4 };
+
+struct PropertyValue {
+    PropertyType type = PropertyType::NONE;
+    long long intValue = 0;
+    double doubleValue = 0;
+    bool boolValue = false;
+    std::string stringValue;
+
+    static PropertyValue ofInt(long long value);
+    static PropertyValue ofDouble(double value);
+    static PropertyValue ofBool(bool value);
+    static PropertyValue ofString(const std::string &value);
+    // Text form of the value, the same text the linked property blocks hold
+    std::string toString() const;
+};
+
+// Entities whose properties are kept in separate sets of columns, rows are block addresses / block size
+enum class PropertyOwner : unsigned char { NODE = 'n', LOCAL_RELATION = 'l', CENTRAL_RELATION = 'c' };
+
+/**
+ * Columnar property store of a native store partition, used instead of the linked property blocks when
+ * org.jasminegraph.nativestore.property.store is columnar.
+ *
+ * Property names are mapped to key IDs by a dictionary (_property_keys.db). Every (owner, key) pair has a column file
+ * (_property_<owner><key ID>.col) of 16 byte typed cells indexed by the block index of the node or relation, so
+ * reading one property of an entity is a single cell read and unset cells cost no disk space (file holes). Strings
+ * of up to 8 bytes are stored in the cell, longer ones in a variable length string heap (_property_strings.db).
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see PropertyStore::acquire().
+ * */
+class PropertyStore {
+ public:
+    static PropertyStore *acquire(const std::string &dbPrefix);
+    static void release(PropertyStore *store);
+    // Whether the partition with the given DB prefix keeps its properties in a column store
+    static bool exists(const std::string &dbPrefix);
+    // Delete the column store of the partition, used when a partition is opened in trunc mode
+    static void remove(const std::string &dbPrefix);
+
+    bool set(PropertyOwner owner, unsigned int row, const std::string &name, const PropertyValue &value);
+    bool get(PropertyOwner owner, unsigned int row, const std::string &name, PropertyValue &value);
+    std::map<std::string, PropertyValue> getAll(PropertyOwner owner, unsigned int row);
+    // Unset every property of the row, for a deleted node or relation
+    void clear(PropertyOwner owner, unsigned int row);
+    std::vector<std::string> getKeys();
+    void flush();
+    // Write copies of the columns of the owner with every row moved to rows[row], for a compaction of the relation
+    // blocks. Returns the (copy, column) paths, the copies replace the columns once they are renamed over them
+    std::vector<std::pair<std::string, std::string>> renumberRows(PropertyOwner owner,
+                                                                  const std::vector<unsigned int> &rows);
+    // Close the column files, for columns replaced on disk. They are opened again on the next access
+    void reopenColumns();
+
+    static const std::string COLUMNAR;
+    static const std::string LINKED;
+    // Store of the partition attached to the calling thread, NULL while the partition uses linked property blocks
+    static thread_local PropertyStore *current;
+
+ private:
+    explicit PropertyStore(const std::string &dbPrefix);
+    ~PropertyStore();
+
+    struct Cell {
+        PropertyType type;
+        unsigned char reserved[3];
+        unsigned int length;         // String length
+        unsigned long long payload;  // Value bits, inline string bytes or the string heap offset
+    };
+
+    bool open();
+    void close();
+    void truncate();
+    int keyId(const std::string &name, bool create);
+    int columnFd(PropertyOwner owner, int key, bool create);
+    std::string columnPath(PropertyOwner owner, int key);
+    bool readCell(PropertyOwner owner, int key, unsigned int row, Cell &cell);
+    bool decode(const Cell &cell, PropertyValue &value);
+
+    std::string dbPrefix;
+    int keysFd = -1;
+    int stringsFd = -1;
+    unsigned long long stringsSize = 0;
+    std::vector<std::string> keyNames;                 // Indexed by key ID
+    std::unordered_map<std::string, int> keyIds;
+    std::map<std::pair<char, int>, int> columnFds;     // (owner, key ID) -> column file, -1 if there is no column
+    std::mutex lock;
+    int references = 0;
+
+    static std::map<std::string, PropertyStore *> openStores;
+    static std::mutex openStoresLock;
+};
+
+#endif  // JASMINEGRAPH_PROPERTYSTORE_H
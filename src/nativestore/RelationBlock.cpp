@@ -13,545 +13,224 @@ limitations under the License.
 
 #include "RelationBlock.h"
 
+#include <algorithm>
+#include <cctype>
 #include <sstream>
 #include <vector>
 
 #include "../util/logger/Logger.h"
+#include "BlockAllocator.h"
+#include "BlockCache.h"
+#include "BlockFormat.h"
 #include "NodeManager.h"
+#include "RelationCursor.h"
 #include "MetaPropertyEdgeLink.h"
+#include "RelationTypeIndex.h"
+#include "StorageMetrics.h"
 
 Logger relation_block_logger;
 pthread_mutex_t lockAddProperty;
 
 RelationBlock* RelationBlock::addLocalRelation(NodeBlock source, NodeBlock destination) {
-    int RECORD_SIZE = sizeof(unsigned int);
-
     NodeRelation sourceData;
     NodeRelation destinationData;
 
     sourceData.address = source.addr;
     destinationData.address = destination.addr;
-    long relationBlockAddress = RelationBlock::nextLocalRelationIndex *
+    long relationBlockAddress = (long)BlockAllocator::current->allocate(BlockFile::RELATIONS) *
             RelationBlock::BLOCK_SIZE;  // Block size is 4 * 13 + 18
 
+    // A new relation is not linked yet, its chain pointer and partition ID records stay 0
+    char block[RelationBlock::MAX_BLOCK_SIZE] = {0};
+    RelationBlock::writeRecord(block, RelationOffsets::SOURCE_ID, false, source.nodeId);
+    RelationBlock::writeRecord(block, RelationOffsets::DESTINATION_ID, false, destination.nodeId);
+    RelationBlock::writeRecord(block, RelationOffsets::SOURCE, false, sourceData.address);
+    RelationBlock::writeRecord(block, RelationOffsets::DESTINATION, false, destinationData.address);
+    RelationBlock::writeRecord(block, RelationOffsets::RELATION_PROPS, false, this->propertyAddress);
+    std::memcpy(block + RECORD_SIZE * RelationBlock::LOCAL_RELATIONSHIP_TYPE_OFFSET, &(this->typeId), RECORD_SIZE);
+
+    StorageMetrics::recordWrite(BlockFile::RELATIONS, RelationBlock::BLOCK_SIZE);
     RelationBlock::relationsDB->seekg(relationBlockAddress);
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&source.nodeId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing  sourceAddr " + std::to_string(source.nodeId) +
+    if (!RelationBlock::relationsDB->write(block, RelationBlock::BLOCK_SIZE)) {
+        relation_block_logger.error("ERROR: Error while writing relation of source " + std::to_string(source.nodeId) +
+                                    " and destination " + std::to_string(destination.nodeId) +
                                     " into relation block address " + std::to_string(relationBlockAddress));
         return NULL;
     }
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&destination.nodeId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing  destinationAddr " +
-                                    std::to_string(destination.nodeId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&sourceData.address), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation sourceAddr " +
-                                    std::to_string(sourceData.address) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&destinationData.address), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation destAddr " +
-                                    std::to_string(destinationData.address) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&sourceData.nextRelationId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing source next relation address " +
-                                    std::to_string(sourceData.nextRelationId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&sourceData.nextPid), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing source next relation partition ID " +
-                                    std::to_string(sourceData.nextPid) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&sourceData.preRelationId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing source previous relation address " +
-                                    std::to_string(sourceData.preRelationId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&sourceData.prePid), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing source previous relation partition ID " +
-                                    std::to_string(sourceData.prePid) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
 
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&destinationData.nextRelationId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing destination next relation address " +
-                                    std::to_string(destinationData.nextRelationId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&destinationData.nextPid), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing destination next partition id " +
-                                    std::to_string(destinationData.nextPid) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&destinationData.preRelationId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing destination previous relation address " +
-                                    std::to_string(destinationData.preRelationId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&destinationData.prePid), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing destination previous relation partition id " +
-                                    std::to_string(destinationData.prePid) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&(this->propertyAddress)), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation property address " +
-                                    std::to_string(this->propertyAddress) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&(this->type)), MAX_TYPE_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation type " +
-                                    this->type + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    RelationBlock::nextLocalRelationIndex += 1;
     RelationBlock::relationsDB->flush();
+    // A reused block could have been read into the block cache while it was free
+    BlockCache::getInstance()->update(BlockFile::RELATIONS, relationBlockAddress, 0, block, RelationBlock::BLOCK_SIZE);
     return new RelationBlock(relationBlockAddress, sourceData, destinationData,
-                             this->propertyAddress, this->type);
+                             this->propertyAddress, this->typeId);
 }
 
 RelationBlock* RelationBlock::addCentralRelation(NodeBlock source, NodeBlock destination) {
     relation_block_logger.debug("Writing central relation with source " + std::to_string(source.nodeId) +
                                " and destination " + std::to_string(destination.nodeId));
-    int RECORD_SIZE = sizeof(unsigned int);
-
     NodeRelation sourceData;
     NodeRelation destinationData;
 
     sourceData.address = source.addr;
     destinationData.address = destination.addr;
 
+    // Central relations are always appended, the dynamic central triangle count takes the blocks past the relation
+    // count of its last run as the new central relations. Free central blocks are dropped by compactRelations()
     long relationBlockAddress =
-        RelationBlock::nextCentralRelationIndex * RelationBlock::CENTRAL_BLOCK_SIZE;
+        (long)BlockAllocator::current->append(BlockFile::CENTRAL_RELATIONS, 1) * RelationBlock::CENTRAL_BLOCK_SIZE;
+
+    // A new relation is not linked yet, its chain pointer and partition ID records stay 0
+    char block[RelationBlock::MAX_BLOCK_SIZE] = {0};
+    RelationBlock::writeRecord(block, RelationOffsets::SOURCE_ID, true, source.nodeId);
+    RelationBlock::writeRecord(block, RelationOffsets::DESTINATION_ID, true, destination.nodeId);
+    RelationBlock::writeRecord(block, RelationOffsets::SOURCE, true, sourceData.address);
+    RelationBlock::writeRecord(block, RelationOffsets::DESTINATION, true, destinationData.address);
+    RelationBlock::writeRecord(block, RelationOffsets::RELATION_PROPS, true, this->propertyAddress);
+    RelationBlock::writeRecord(block, RelationOffsets::RELATION_PROPS_META, true, this->metaPropertyAddress);
+    std::memcpy(block + RECORD_SIZE * RelationBlock::CENTRAL_RELATIONSHIP_TYPE_OFFSET, &(this->typeId), RECORD_SIZE);
+
+    StorageMetrics::recordWrite(BlockFile::CENTRAL_RELATIONS, RelationBlock::CENTRAL_BLOCK_SIZE);
     RelationBlock::centralRelationsDB->seekg(relationBlockAddress);
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&source.nodeId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing  sourceAddr " + std::to_string(source.nodeId) +
-                                    " into relation block address " + std::to_string(relationBlockAddress));
-        return NULL;
-    }
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&destination.nodeId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing  destinationAddr " +
+    if (!RelationBlock::centralRelationsDB->write(block, RelationBlock::CENTRAL_BLOCK_SIZE)) {
+        relation_block_logger.error("ERROR: Error while writing central relation of source " +
+                                    std::to_string(source.nodeId) + " and destination " +
                                     std::to_string(destination.nodeId) + " into relation block address " +
                                     std::to_string(relationBlockAddress));
         return NULL;
     }
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&sourceData.address), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation sourceAddr " +
-                                    std::to_string(sourceData.address) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&destinationData.address), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation destAddr " +
-                                    std::to_string(destinationData.address) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&sourceData.nextRelationId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing source next relation address " +
-                                    std::to_string(sourceData.nextRelationId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&sourceData.nextPid), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing source next relation partition ID " +
-                                    std::to_string(sourceData.nextPid) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&sourceData.preRelationId), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing source previous relation address " +
-                                    std::to_string(sourceData.preRelationId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&sourceData.prePid), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing source previous relation partition ID " +
-                                    std::to_string(sourceData.prePid) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&destinationData.nextRelationId),
-                                                  RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing destination next relation address " +
-                                    std::to_string(destinationData.nextRelationId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&destinationData.nextPid), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing destination next partition id " +
-                                    std::to_string(destinationData.nextPid) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&destinationData.preRelationId),
-                                                  RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing destination previous relation address " +
-                                    std::to_string(destinationData.preRelationId) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
 
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&destinationData.prePid), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing destination previous relation partition id " +
-                                    std::to_string(destinationData.prePid) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&(this->propertyAddress)), RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation property address " +
-                                    std::to_string(this->propertyAddress) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&(this->metaPropertyAddress)),
-                                                  RECORD_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation property address " +
-                                    std::to_string(this->metaPropertyAddress) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&(this->type)), MAX_TYPE_SIZE)) {
-        relation_block_logger.error("ERROR: Error while writing relation type " +
-                                    std::to_string(this->propertyAddress) + " into relation block address " +
-                                    std::to_string(relationBlockAddress));
-        return NULL;
-    }
-
-    RelationBlock::nextCentralRelationIndex += 1;
     RelationBlock::centralRelationsDB->flush();
+    BlockCache::getInstance()->update(BlockFile::CENTRAL_RELATIONS, relationBlockAddress, 0, block,
+                                      RelationBlock::CENTRAL_BLOCK_SIZE);
     return new RelationBlock(relationBlockAddress, sourceData, destinationData,
-                             this->propertyAddress, this->metaPropertyAddress, this->type);
+                             this->propertyAddress, this->metaPropertyAddress, this->typeId);
 }
 
-RelationBlock* RelationBlock::getLocalRelation(unsigned int address) {
-    int RECORD_SIZE = sizeof(unsigned int);
-    if (address == 0) {
-        return NULL;
-    }
-    if (address % RelationBlock::BLOCK_SIZE != 0) {
-        relation_block_logger.error("Exception: Invalid relation block address !!\n received address = " + address);
-        return NULL;
+static bool loadLocalRelationBlock(unsigned long address, char* block) {
+    if (RelationBlock::relationsMap) {
+        return RelationBlock::relationsMap->read(address, block, RelationBlock::BLOCK_SIZE);
     }
-    RelationBlock::relationsDB->seekg(address);  // Address is relation ID
-    NodeRelation source;
-    NodeRelation destination;
-    unsigned int propertyReference;
-    char type[RelationBlock::MAX_TYPE_SIZE] = {0};
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&source.nodeId),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 0
-        relation_block_logger.error(
-                "Error while reading local relation source node address offset ID = 0 from "
-                "relation block address " +
-                std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&destination.nodeId),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 1
-        relation_block_logger.error(
-                "Error while reading local relation source node address offset ID = 0 from "
-                "relation block address " +
-                std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&source.address),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 2
-        relation_block_logger.error(
-                "Error while reading local relation source node address offset ID = 0 from "
-                "relation block address " +
-                std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&destination.address),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 3
-        relation_block_logger.error(
-            "Error while reading local relation source node address offset ID = 1 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&source.nextRelationId),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 4
-        relation_block_logger.error(
-            "Error while reading local relation source next relation address offset ID = 2 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&source.nextPid),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 5
-        relation_block_logger.error(
-            "Error while reading local relation source next relation partition id offset ID = 3 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&source.preRelationId),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 6
-        relation_block_logger.error(
-            "Error while reading local relation source previous relation address offset ID = 4 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&source.prePid),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 7
-        relation_block_logger.error(
-            "Error while reading local relation source previous relation partition id offset ID = 5 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&destination.nextRelationId),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 8
-        relation_block_logger.error(
-            "Error while reading local relation destination next relation address offset ID = 6 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&destination.nextPid),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 9
-        relation_block_logger.error(
-            "ERROR: Error while reading local relation destination next relation partition id offset ID = 7 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&destination.preRelationId),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 10
-        relation_block_logger.error(
-            "ERROR: Error while reading local relation destination previous relation address data offset ID = 8 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&destination.prePid),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 11
-        relation_block_logger.error(
-            "ERROR: Error while reading local relation destination previous "
-            "relation partition id data offset ID = 9 from "
-            "relation block address " + std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&propertyReference),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 12
-        relation_block_logger.error(
-            "ERROR: Error while reading local relation property address data "
-            "offset ID = 10 from relation block address " + std::to_string(address));
-        return NULL;
+    RelationBlock::relationsDB->seekg(address);
+    if (!RelationBlock::relationsDB->read(block, RelationBlock::BLOCK_SIZE)) {
+        RelationBlock::relationsDB->clear();
+        return false;
     }
+    return true;
+}
 
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&type),
-                                          RelationBlock::MAX_TYPE_SIZE)) {  // < ------ relation data offset ID = 10
-        relation_block_logger.error(
-                "ERROR: Error while reading local relation property address data "
-                "offset ID = 10 from relation block address " + std::to_string(address));
-        return NULL;
-    }
-    return new RelationBlock(address, source, destination, propertyReference, type);
+/**
+ * Read the raw bytes of the local relation block at the given address through the block cache. On a miss the block
+ * is copied from the memory mapped relations DB or read with a single read from the relations DB stream
+ * */
+bool RelationBlock::readLocalBlock(unsigned long address, char* block) {
+    StorageMetrics::ReadTimer timer(BlockFile::RELATIONS, RelationBlock::BLOCK_SIZE);
+    return BlockCache::getInstance()->read(
+        BlockFile::RELATIONS, address, block, RelationBlock::BLOCK_SIZE, [address, &timer](char* buffer) {
+            timer.load(!RelationBlock::relationsMap);
+            return loadLocalRelationBlock(address, buffer);
+        });
 }
 
-RelationBlock* RelationBlock::getCentralRelation(unsigned int address) {
-    int RECORD_SIZE = sizeof(unsigned int);
-    if (address == 0) {
-        return NULL;
-    }
-    if (address % RelationBlock::CENTRAL_BLOCK_SIZE != 0) {
-        relation_block_logger.error("Exception: Invalid relation block address !!\n received address = " + address);
-        return NULL;
+static bool loadCentralRelationBlock(unsigned long address, char* block) {
+    if (RelationBlock::centralRelationsMap) {
+        return RelationBlock::centralRelationsMap->read(address, block, RelationBlock::CENTRAL_BLOCK_SIZE);
     }
-
     RelationBlock::centralRelationsDB->seekg(address);
-    NodeRelation source;
-    NodeRelation destination;
-    unsigned int propertyReference;
-    unsigned int metaPropertyReference;
-    char type[RelationBlock::MAX_TYPE_SIZE] = {0};
-
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&source.nodeId),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 0
-        relation_block_logger.error(
-                "Error while reading local relation source node address offset ID = 0 from "
-                "relation block address " +
-                std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&destination.nodeId),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 1
-        relation_block_logger.error(
-                "Error while reading local relation source node address offset ID = 0 from "
-                "relation block address " +
-                std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&source.address),
-                                          RECORD_SIZE)) {  // < ------ relation data offset ID = 2
-        relation_block_logger.error(
-                "Error while reading local relation source node address offset ID = 0 from "
-                "relation block address " +
-                std::to_string(address));
-        return NULL;
-    }
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&destination.address),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 3
-        relation_block_logger.error(
-            "Error while reading central relation source node address offset ID = 1 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
-
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&source.nextRelationId),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 4
-        relation_block_logger.error(
-            "Error while reading central relation source next relation address offset ID = 2 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
+    if (!RelationBlock::centralRelationsDB->read(block, RelationBlock::CENTRAL_BLOCK_SIZE)) {
+        RelationBlock::centralRelationsDB->clear();
+        return false;
     }
+    return true;
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&source.nextPid),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 5
-        relation_block_logger.error(
-            "Error while reading central relation source next relation partition id offset ID = 3 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
+bool RelationBlock::readCentralBlock(unsigned long address, char* block) {
+    StorageMetrics::ReadTimer timer(BlockFile::CENTRAL_RELATIONS, RelationBlock::CENTRAL_BLOCK_SIZE);
+    return BlockCache::getInstance()->read(
+        BlockFile::CENTRAL_RELATIONS, address, block, RelationBlock::CENTRAL_BLOCK_SIZE,
+        [address, &timer](char* buffer) {
+            timer.load(!RelationBlock::centralRelationsMap);
+            return loadCentralRelationBlock(address, buffer);
+        });
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&source.preRelationId),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 6
-        relation_block_logger.error(
-            "Error while reading central relation source previous relation address offset ID = 4 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
+unsigned long RelationBlock::referenceBlockSize(RelationOffsets recordOffset, bool central) {
+    switch (recordOffset) {
+        case RelationOffsets::SOURCE:
+        case RelationOffsets::DESTINATION:
+            return NodeBlock::BLOCK_SIZE;
+        case RelationOffsets::SOURCE_NEXT:
+        case RelationOffsets::SOURCE_PREVIOUS:
+        case RelationOffsets::DESTINATION_NEXT:
+        case RelationOffsets::DESTINATION_PREVIOUS:
+            return central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+        case RelationOffsets::RELATION_PROPS:
+            return PropertyEdgeLink::PROPERTY_BLOCK_SIZE;
+        case RelationOffsets::RELATION_PROPS_META:  // The type field of local relation blocks
+            return central ? MetaPropertyEdgeLink::META_PROPERTY_BLOCK_SIZE : 0;
+        default:
+            return 0;
     }
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&source.prePid),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 7
-        relation_block_logger.error(
-            "Error while reading central relation source previous relation partition id offset ID = 5 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
+unsigned int RelationBlock::encodeRecord(RelationOffsets recordOffset, bool central, unsigned long value) {
+    unsigned long blockSize = RelationBlock::referenceBlockSize(recordOffset, central);
+    return blockSize ? BlockFormat::encode(value, blockSize) : value;
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&destination.nextRelationId),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 8
-        relation_block_logger.error(
-            "Error while reading central relation destination next relation address offset ID = 6 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
+unsigned long RelationBlock::decodeRecord(RelationOffsets recordOffset, bool central, unsigned int record) {
+    unsigned long blockSize = RelationBlock::referenceBlockSize(recordOffset, central);
+    return blockSize ? BlockFormat::decode(record, blockSize) : record;
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&destination.nextPid),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 9
-        relation_block_logger.error(
-            "ERROR: Error while reading central relation destination next relation partition id offset ID = 7 from "
-            "relation block address " +
-            std::to_string(address));
-        return NULL;
-    }
+unsigned long RelationBlock::readRecord(const char* block, RelationOffsets recordOffset, bool central) {
+    unsigned int record;
+    std::memcpy(&record, block + RECORD_SIZE * static_cast<int>(recordOffset), RECORD_SIZE);
+    return RelationBlock::decodeRecord(recordOffset, central, record);
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&destination.preRelationId),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 10
-        relation_block_logger.error(
-            "ERROR: Error while reading central relation destination previous relation address "
-            "data offset ID = 8 from "
-            "relation block address " + std::to_string(address));
-        return NULL;
-    }
+void RelationBlock::writeRecord(char* block, RelationOffsets recordOffset, bool central, unsigned long value) {
+    unsigned int record = RelationBlock::encodeRecord(recordOffset, central, value);
+    std::memcpy(block + RECORD_SIZE * static_cast<int>(recordOffset), &record, RECORD_SIZE);
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&destination.prePid),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 11
-        relation_block_logger.error(
-            "ERROR: Error while reading central relation destination previous relation partition "
-            "id data offset ID = 9 from "
-            "relation block address " + std::to_string(address));
-        return NULL;
-    }
+bool RelationBlock::isFree(const char* block) {
+    unsigned int record;
+    std::memcpy(&record, block + RECORD_SIZE * static_cast<int>(RelationOffsets::SOURCE), RECORD_SIZE);
+    return record == RelationBlock::FREE_RECORD;
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&propertyReference),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 12
-        relation_block_logger.error(
-            "ERROR: Error while reading central relation property address data offset ID = 10 from "
-            "relation block address " + std::to_string(address));
-        return NULL;
+bool RelationBlock::writeFreeBlock(unsigned long address, bool central) {
+    char block[RelationBlock::MAX_BLOCK_SIZE] = {0};
+    const unsigned int freeRecord = RelationBlock::FREE_RECORD;
+    std::memcpy(block + RECORD_SIZE * static_cast<int>(RelationOffsets::SOURCE), &freeRecord, RECORD_SIZE);
+    std::fstream* relationsDB = central ? RelationBlock::centralRelationsDB : RelationBlock::relationsDB;
+    StorageMetrics::recordWrite(central ? BlockFile::CENTRAL_RELATIONS : BlockFile::RELATIONS,
+                                 central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE);
+    relationsDB->seekp(address);
+    if (!relationsDB->write(block, central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE)) {
+        relation_block_logger.error("Error while freeing relation block " + std::to_string(address));
+        return false;
     }
+    relationsDB->flush();
+    return true;
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&metaPropertyReference),
-                                                 RECORD_SIZE)) {  // < ------ relation data offset ID = 13
-        relation_block_logger.error(
-                "ERROR: Error while reading central relation meta property address data offset ID = 10 from "
-                "relation block address " + std::to_string(address));
+RelationBlock* RelationBlock::getLocalRelation(unsigned long address) {
+    RelationView relation;
+    if (!RelationView::read(address, false, relation)) {
         return NULL;
     }
+    return new RelationBlock(address, relation.source, relation.destination, relation.propertyAddress,
+                             relation.typeId);
+}
 
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&type),
-                                          RelationBlock::MAX_TYPE_SIZE)) {  // < ------ relation data offset ID = 10
-        relation_block_logger.error(
-                "ERROR: Error while reading local relation property address data "
-                "offset ID = 10 from relation block address " + std::to_string(address));
+RelationBlock* RelationBlock::getCentralRelation(unsigned long address) {
+    RelationView relation;
+    if (!RelationView::read(address, true, relation)) {
         return NULL;
     }
-
-    return new RelationBlock(address, source, destination, propertyReference,
-                             metaPropertyReference, type);
+    return new RelationBlock(address, relation.source, relation.destination, relation.propertyAddress,
+                             relation.metaPropertyAddress, relation.typeId);
 }
 
 RelationBlock* RelationBlock::nextLocalSource() {
@@ -586,7 +265,7 @@ RelationBlock* RelationBlock::previousCentralDestination() {
     return RelationBlock::getCentralRelation(this->destination.preRelationId);
 }
 
-bool RelationBlock::setLocalNextSource(unsigned int newAddress) {
+bool RelationBlock::setLocalNextSource(unsigned long newAddress) {
     if (this->updateLocalRelationRecords(RelationOffsets::SOURCE_NEXT, newAddress)) {
         this->source.nextRelationId = newAddress;
     } else {
@@ -596,7 +275,7 @@ bool RelationBlock::setLocalNextSource(unsigned int newAddress) {
     return true;
 }
 
-bool RelationBlock::setCentralNextSource(unsigned int newAddress) {
+bool RelationBlock::setCentralNextSource(unsigned long newAddress) {
     if (this->updateCentralRelationRecords(RelationOffsets::SOURCE_NEXT, newAddress)) {
         this->source.nextRelationId = newAddress;
     } else {
@@ -606,7 +285,7 @@ bool RelationBlock::setCentralNextSource(unsigned int newAddress) {
     return true;
 }
 
-bool RelationBlock::setLocalPreviousSource(unsigned int newAddress) {
+bool RelationBlock::setLocalPreviousSource(unsigned long newAddress) {
     if (this->updateLocalRelationRecords(RelationOffsets::SOURCE_PREVIOUS, newAddress)) {
         this->source.preRelationId = newAddress;
     } else {
@@ -616,7 +295,7 @@ bool RelationBlock::setLocalPreviousSource(unsigned int newAddress) {
     return true;
 }
 
-bool RelationBlock::setCentralPreviousSource(unsigned int newAddress) {
+bool RelationBlock::setCentralPreviousSource(unsigned long newAddress) {
     if (this->updateCentralRelationRecords(RelationOffsets::SOURCE_PREVIOUS, newAddress)) {
         this->source.preRelationId = newAddress;
     } else {
@@ -626,7 +305,7 @@ bool RelationBlock::setCentralPreviousSource(unsigned int newAddress) {
     return true;
 }
 
-bool RelationBlock::setLocalNextDestination(unsigned int newAddress) {
+bool RelationBlock::setLocalNextDestination(unsigned long newAddress) {
     if (this->updateLocalRelationRecords(RelationOffsets::DESTINATION_NEXT, newAddress)) {
         this->destination.nextRelationId = newAddress;
     } else {
@@ -636,7 +315,7 @@ bool RelationBlock::setLocalNextDestination(unsigned int newAddress) {
     return true;
 }
 
-bool RelationBlock::setCentralNextDestination(unsigned int newAddress) {
+bool RelationBlock::setCentralNextDestination(unsigned long newAddress) {
     if (this->updateCentralRelationRecords(RelationOffsets::DESTINATION_NEXT, newAddress)) {
         this->destination.nextRelationId = newAddress;
     } else {
@@ -646,7 +325,7 @@ bool RelationBlock::setCentralNextDestination(unsigned int newAddress) {
     return true;
 }
 
-bool RelationBlock::setLocalPreviousDestination(unsigned int newAddress) {
+bool RelationBlock::setLocalPreviousDestination(unsigned long newAddress) {
     if (this->updateLocalRelationRecords(RelationOffsets::DESTINATION_PREVIOUS, newAddress)) {
         this->destination.preRelationId = newAddress;
     } else {
@@ -656,7 +335,7 @@ bool RelationBlock::setLocalPreviousDestination(unsigned int newAddress) {
     return true;
 }
 
-bool RelationBlock::setCentralPreviousDestination(unsigned int newAddress) {
+bool RelationBlock::setCentralPreviousDestination(unsigned long newAddress) {
     if (this->updateCentralRelationRecords(RelationOffsets::DESTINATION_PREVIOUS, newAddress)) {
         this->destination.preRelationId = newAddress;
     } else {
@@ -680,72 +359,90 @@ bool RelationBlock::setCentralPreviousDestination(unsigned int newAddress) {
  *  recordOffset 9 --> Destination's previous relation block partition id
  * recordOffset 10 --> Relation's property address in the properties DB
  * */
-bool RelationBlock::updateLocalRelationRecords(RelationOffsets recordOffset, unsigned int data) {
+bool RelationBlock::updateLocalRelationRecords(RelationOffsets recordOffset, unsigned long data) {
     int offsetValue = static_cast<int>(recordOffset);
     int dataOffset = RECORD_SIZE * offsetValue;
+    unsigned int encoded = RelationBlock::encodeRecord(recordOffset, false, data);
+    char *record = reinterpret_cast<char*>(&encoded);
+    // Chain pointers of resident blocks are only updated in the block cache and written back later
+    if (BlockCache::getInstance()->writeBack(BlockFile::RELATIONS, this->addr, dataOffset, record, RECORD_SIZE)) {
+        return true;
+    }
+    StorageMetrics::recordWrite(BlockFile::RELATIONS, RECORD_SIZE);
     RelationBlock::relationsDB->seekg(this->addr + dataOffset);
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&data), RECORD_SIZE)) {
+    if (!RelationBlock::relationsDB->write(record, RECORD_SIZE)) {
         relation_block_logger.error("Error while updating relation data record offset " + std::to_string(offsetValue) +
                                     "data " + std::to_string(data));
         return false;
     }
     RelationBlock::relationsDB->flush();
+    BlockCache::getInstance()->update(BlockFile::RELATIONS, this->addr, dataOffset, record, RECORD_SIZE);
     return true;
 }
 
-bool RelationBlock::updateCentralRelationRecords(RelationOffsets recordOffset, unsigned int data) {
+bool RelationBlock::updateCentralRelationRecords(RelationOffsets recordOffset, unsigned long data) {
     int offsetValue = static_cast<int>(recordOffset);
     int dataOffset = RECORD_SIZE * offsetValue;
+    unsigned int encoded = RelationBlock::encodeRecord(recordOffset, true, data);
+    char *record = reinterpret_cast<char*>(&encoded);
+    // Chain pointers of resident blocks are only updated in the block cache and written back later
+    if (BlockCache::getInstance()->writeBack(BlockFile::CENTRAL_RELATIONS, this->addr, dataOffset, record,
+                                             RECORD_SIZE)) {
+        return true;
+    }
+    StorageMetrics::recordWrite(BlockFile::CENTRAL_RELATIONS, RECORD_SIZE);
     RelationBlock::centralRelationsDB->seekg(this->addr + dataOffset);
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&data), RECORD_SIZE)) {
+    if (!RelationBlock::centralRelationsDB->write(record, RECORD_SIZE)) {
         relation_block_logger.error("Error while updating relation data record offset " + std::to_string(offsetValue) +
                                     "data " + std::to_string(data));
         return false;
     }
     RelationBlock::centralRelationsDB->flush();
+    BlockCache::getInstance()->update(BlockFile::CENTRAL_RELATIONS, this->addr, dataOffset, record, RECORD_SIZE);
     return true;
 }
 
-bool RelationBlock::updateLocalRelationshipType(int offset, std::string data) {
-    int offsetValue = static_cast<int>(offset);
-    int dataOffset = RECORD_SIZE * offsetValue;
-    RelationBlock::centralRelationsDB->seekg(this->addr + dataOffset);
-    char type[RelationBlock::MAX_TYPE_SIZE] = {0};
-    std::memcpy(type, data.c_str(),
-                MAX_TYPE_SIZE);
-    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&type), MAX_TYPE_SIZE)) {
-        relation_block_logger.error("Error while updating relation data record offset " + std::to_string(offsetValue) +
-                                    "data " + data);
+bool RelationBlock::updateLocalRelationshipType(unsigned int typeId) {
+    int dataOffset = RECORD_SIZE * RelationBlock::LOCAL_RELATIONSHIP_TYPE_OFFSET;
+    StorageMetrics::recordWrite(BlockFile::RELATIONS, RECORD_SIZE);
+    RelationBlock::relationsDB->seekg(this->addr + dataOffset);
+    if (!RelationBlock::relationsDB->write(reinterpret_cast<char*>(&typeId), RECORD_SIZE)) {
+        relation_block_logger.error("Error while updating relation type of " + std::to_string(this->addr) +
+                                    " to type ID " + std::to_string(typeId));
         return false;
     }
     RelationBlock::relationsDB->flush();
+    BlockCache::getInstance()->update(BlockFile::RELATIONS, this->addr, dataOffset,
+                                      reinterpret_cast<char*>(&typeId), RECORD_SIZE);
+    this->typeId = typeId;
     return true;
 }
 
-bool RelationBlock::updateCentralRelationshipType(int offset, std::string data) {
-    int offsetValue = static_cast<int>(offset);
-    int dataOffset = RECORD_SIZE * offsetValue;
+bool RelationBlock::updateCentralRelationshipType(unsigned int typeId) {
+    int dataOffset = RECORD_SIZE * RelationBlock::CENTRAL_RELATIONSHIP_TYPE_OFFSET;
+    StorageMetrics::recordWrite(BlockFile::CENTRAL_RELATIONS, RECORD_SIZE);
     RelationBlock::centralRelationsDB->seekg(this->addr + dataOffset);
-    char type[RelationBlock::MAX_TYPE_SIZE] = {0};
-    std::memcpy(type, data.c_str(),
-                MAX_TYPE_SIZE);
-    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&type), MAX_TYPE_SIZE)) {
-        relation_block_logger.error("Error while updating relation data record offset " + std::to_string(offsetValue) +
-                                    "data " + data);
+    if (!RelationBlock::centralRelationsDB->write(reinterpret_cast<char*>(&typeId), RECORD_SIZE)) {
+        relation_block_logger.error("Error while updating central relation type of " + std::to_string(this->addr) +
+                                    " to type ID " + std::to_string(typeId));
         return false;
     }
     RelationBlock::centralRelationsDB->flush();
+    BlockCache::getInstance()->update(BlockFile::CENTRAL_RELATIONS, this->addr, dataOffset,
+                                      reinterpret_cast<char*>(&typeId), RECORD_SIZE);
+    this->typeId = typeId;
     return true;
 }
 
 bool RelationBlock::isInUse() { return this->usage == '\1'; }
-thread_local unsigned int RelationBlock::nextLocalRelationIndex =
-        1;  // Starting with 1 because of the 0 and '\0' differentiation issue
-thread_local unsigned int RelationBlock::nextCentralRelationIndex =
-    1;  // Starting with 1 because of the 0 and '\0' differentiation issue
 
 
 void RelationBlock::addLocalProperty(std::string name, char* value) {
+    if (PropertyStore::current) {
+        std::string text(value, strnlen(value, PropertyEdgeLink::MAX_VALUE_SIZE));
+        this->addLocalProperty(name, PropertyValue::ofString(text));
+        return;
+    }
     if (this->propertyAddress == 0) {
         PropertyEdgeLink* newLink = PropertyEdgeLink::create(name, value);
         if (newLink) {
@@ -762,6 +459,11 @@ void RelationBlock::addLocalProperty(std::string name, char* value) {
     }
 }
 void RelationBlock::addCentralProperty(std::string name, char* value) {
+    if (PropertyStore::current) {
+        std::string text(value, strnlen(value, PropertyEdgeLink::MAX_VALUE_SIZE));
+        this->addCentralProperty(name, PropertyValue::ofString(text));
+        return;
+    }
     if (this->propertyAddress == 0) {
         PropertyEdgeLink* newLink = PropertyEdgeLink::create(name, value);
         if (newLink) {
@@ -778,6 +480,32 @@ void RelationBlock::addCentralProperty(std::string name, char* value) {
     }
 }
 
+/**
+ * Add a typed property. Property blocks of the linked format only hold text, there the value is stored as its text
+ * form truncated to PropertyEdgeLink::MAX_VALUE_SIZE.
+ * */
+void RelationBlock::addLocalProperty(std::string name, const PropertyValue& value) {
+    if (PropertyStore::current) {
+        PropertyStore::current->set(PropertyOwner::LOCAL_RELATION, this->addr / RelationBlock::BLOCK_SIZE, name,
+                                    value);
+        return;
+    }
+    char text[PropertyEdgeLink::MAX_VALUE_SIZE] = {0};
+    std::strncpy(text, value.toString().c_str(), PropertyEdgeLink::MAX_VALUE_SIZE - 1);
+    this->addLocalProperty(name, text);
+}
+
+void RelationBlock::addCentralProperty(std::string name, const PropertyValue& value) {
+    if (PropertyStore::current) {
+        PropertyStore::current->set(PropertyOwner::CENTRAL_RELATION, this->addr / RelationBlock::CENTRAL_BLOCK_SIZE,
+                                    name, value);
+        return;
+    }
+    char text[PropertyEdgeLink::MAX_VALUE_SIZE] = {0};
+    std::strncpy(text, value.toString().c_str(), PropertyEdgeLink::MAX_VALUE_SIZE - 1);
+    this->addCentralProperty(name, text);
+}
+
 void RelationBlock::addMetaProperty(std::string name, char *value) {
     if (this->metaPropertyAddress == 0) {
         MetaPropertyEdgeLink* newLink = MetaPropertyEdgeLink::create(name, value);
@@ -796,61 +524,142 @@ void RelationBlock::addMetaProperty(std::string name, char *value) {
     }
 }
 
-void RelationBlock::addLocalRelationshipType(char *value) {
-    if (this->type == DEFAULT_TYPE) {
-        this->updateLocalRelationshipType(RelationBlock::LOCAL_RELATIONSHIP_TYPE_OFFSET,
-                                               value);
-    } else {
-        relation_block_logger.info("Relation type is already set to " + this->type);
+/**
+ * Set the relationship type of a relation without one. The block keeps the ID of the type from the partition's
+ * RelationTypeIndex, which also gets the relation added to the type's relation set.
+ * */
+void RelationBlock::addLocalRelationshipType(const std::string &type) {
+    if (this->typeId != 0) {
+        relation_block_logger.info("Relation type is already set to " + this->getLocalRelationshipType());
+        return;
+    }
+    if (!RelationTypeIndex::current) {
+        relation_block_logger.error("No relation type index to add relation type " + type);
+        return;
+    }
+    int id = RelationTypeIndex::current->typeId(type, true);
+    if (id > 0 && this->updateLocalRelationshipType(id)) {
+        RelationTypeIndex::current->add(id, false, this->addr / RelationBlock::BLOCK_SIZE);
     }
 }
 
-void RelationBlock::addCentralRelationshipType(char *value) {
-    if (this->type == DEFAULT_TYPE) {
-        this->updateCentralRelationshipType(RelationBlock::CENTRAL_RELATIONSHIP_TYPE_OFFSET,
-                                          value);
-    } else {
-        relation_block_logger.info("Relation type is already set to " + this->type);
+void RelationBlock::addCentralRelationshipType(const std::string &type) {
+    if (this->typeId != 0) {
+        relation_block_logger.info("Relation type is already set to " + this->getCentralRelationshipType());
+        return;
+    }
+    if (!RelationTypeIndex::current) {
+        relation_block_logger.error("No relation type index to add relation type " + type);
+        return;
+    }
+    int id = RelationTypeIndex::current->typeId(type, true);
+    if (id > 0 && this->updateCentralRelationshipType(id)) {
+        RelationTypeIndex::current->add(id, true, this->addr / RelationBlock::CENTRAL_BLOCK_SIZE);
     }
 }
 
-std::string RelationBlock::getLocalRelationshipType() {
-    int address = this->addr;
-    RelationBlock::relationsDB->seekg(address +
-        RelationBlock::LOCAL_RELATIONSHIP_TYPE_OFFSET * RelationBlock::RECORD_SIZE);
-    char type[RelationBlock::MAX_TYPE_SIZE] = {0};
-    if (!RelationBlock::relationsDB->read(reinterpret_cast<char*>(&type), RelationBlock::MAX_TYPE_SIZE)) {
-        relation_block_logger.error("Error while reading local relation type from " +
-                                    std::to_string(address));
-        return "";
+static std::string relationshipTypeName(unsigned int typeId) {
+    if (typeId == 0) {
+        return RelationBlock::DEFAULT_TYPE;
     }
-    std::string relationType(type);
-    return relationType;
+    return RelationTypeIndex::current ? RelationTypeIndex::current->typeName(typeId) : "";
 }
 
-std::string RelationBlock::getCentralRelationshipType() {
-    int address = this->addr;
-    RelationBlock::centralRelationsDB->seekg(address +
-        RelationBlock::CENTRAL_RELATIONSHIP_TYPE_OFFSET * RelationBlock::RECORD_SIZE);
-    char type[RelationBlock::MAX_TYPE_SIZE] = {0};
-    if (!RelationBlock::centralRelationsDB->read(reinterpret_cast<char*>(&type), RelationBlock::MAX_TYPE_SIZE)) {
-        relation_block_logger.error("Error while reading local relation type from " +
-                                    std::to_string(address));
-        return "";
+std::string RelationBlock::getLocalRelationshipType() { return relationshipTypeName(this->typeId); }
+
+std::string RelationBlock::getCentralRelationshipType() { return relationshipTypeName(this->typeId); }
+
+/**
+ * Relation blocks written before the RelationTypeIndex hold the name of their type in the type field, or the bytes of
+ * an std::string object for relations that never got a type. Printable names are moved to the type index, every other
+ * type field is cleared to type ID 0.
+ * */
+void RelationBlock::migrateLegacyTypes(bool central, unsigned int relationCount) {
+    unsigned long blockSize = central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+    int typeOffset = central ? RelationBlock::CENTRAL_RELATIONSHIP_TYPE_OFFSET
+                             : RelationBlock::LOCAL_RELATIONSHIP_TYPE_OFFSET;
+    std::vector<char> block(blockSize);
+    for (unsigned int i = 1; i < relationCount; i++) {
+        bool read = central ? RelationBlock::readCentralBlock(i * blockSize, block.data())
+                            : RelationBlock::readLocalBlock(i * blockSize, block.data());
+        if (!read) {
+            continue;
+        }
+        const char* field = block.data() + typeOffset * RelationBlock::RECORD_SIZE;
+        std::string type(field, strnlen(field, RelationBlock::MAX_TYPE_SIZE));
+        bool isName = !type.empty() && type != RelationBlock::DEFAULT_TYPE &&
+                      std::all_of(type.begin(), type.end(), [](char c) { return std::isprint((unsigned char)c); });
+        RelationBlock* relation = central ? RelationBlock::getCentralRelation(i * blockSize)
+                                          : RelationBlock::getLocalRelation(i * blockSize);
+        if (!relation) {
+            continue;
+        }
+        relation->typeId = 0;
+        if (central) {
+            relation->updateCentralRelationshipType(0);
+        } else {
+            relation->updateLocalRelationshipType(0);
+        }
+        if (isName) {
+            if (central) {
+                relation->addCentralRelationshipType(type);
+            } else {
+                relation->addLocalRelationshipType(type);
+            }
+        }
+        delete relation;
     }
-    std::string relationType(type);
-    return relationType;
 }
 
-
 PropertyEdgeLink* RelationBlock::getPropertyHead() { return PropertyEdgeLink::get(this->propertyAddress); }
 
 MetaPropertyEdgeLink *RelationBlock::getMetaPropertyHead() {
     return MetaPropertyEdgeLink::get(this->metaPropertyAddress);
 }
 
+/**
+ * Owner and row of this relation's properties in the column store
+ * */
+static std::pair<PropertyOwner, unsigned int> propertyRow(const RelationBlock* relation) {
+    if (relation->isCentral) {
+        return {PropertyOwner::CENTRAL_RELATION, relation->addr / RelationBlock::CENTRAL_BLOCK_SIZE};
+    }
+    return {PropertyOwner::LOCAL_RELATION, relation->addr / RelationBlock::BLOCK_SIZE};
+}
+
+bool RelationBlock::getProperty(const std::string& name, PropertyValue& value) {
+    if (PropertyStore::current) {
+        auto row = propertyRow(this);
+        return PropertyStore::current->get(row.first, row.second, name, value);
+    }
+    PropertyEdgeLink* current = this->getPropertyHead();
+    while (current) {
+        if (current->name == name) {
+            value = PropertyValue::ofString(std::string(current->value,
+                                                        strnlen(current->value, PropertyEdgeLink::MAX_VALUE_SIZE)));
+            delete current;
+            return true;
+        }
+        PropertyEdgeLink* temp = current->next();
+        delete current;
+        current = temp;
+    }
+    return false;
+}
+
 std::map<std::string, char*> RelationBlock::getAllProperties() {
     std::map<std::string, char*> allProperties;
+    if (PropertyStore::current) {
+        auto row = propertyRow(this);
+        for (auto& property : PropertyStore::current->getAll(row.first, row.second)) {
+            // don't forget to free the allocated memory after using this method
+            std::string text = property.second.toString();
+            char* copiedValue = new char[text.length() + 1];
+            std::memcpy(copiedValue, text.c_str(), text.length() + 1);
+            allProperties.insert({property.first, copiedValue});
+        }
+        return allProperties;
+    }
     PropertyEdgeLink* current = this->getPropertyHead();
     while (current) {
         // don't forget to free the allocated memory after using this method
@@ -899,3 +708,5 @@ const std::string RelationBlock::DEFAULT_TYPE = "DEFAULT";
 // and one record is typically 4 bytes (size of unsigned int)
 thread_local std::fstream* RelationBlock::relationsDB = NULL;
 thread_local std::fstream* RelationBlock::centralRelationsDB = NULL;
+thread_local MappedFile* RelationBlock::relationsMap = NULL;
+thread_local MappedFile* RelationBlock::centralRelationsMap = NULL;
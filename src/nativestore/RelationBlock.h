@@ -16,6 +16,7 @@ limitations under the License.
 #include <set>
 #include <string>
 
+#include "MappedFile.h"
 #include "NodeBlock.h"
 #include "PropertyEdgeLink.h"
 #include "MetaPropertyEdgeLink.h"
@@ -23,10 +24,10 @@ limitations under the License.
 #ifndef RELATION_BLOCK
 #define RELATION_BLOCK
 struct NodeRelation {
-    unsigned int address = 0;
-    unsigned int nextRelationId = 0;
+    unsigned long address = 0;
+    unsigned long nextRelationId = 0;
     unsigned int nextPid = 0;
-    unsigned int preRelationId = 0;
+    unsigned long preRelationId = 0;
     unsigned int prePid = 0;
     unsigned int nodeId = 0;
 };
@@ -61,10 +62,10 @@ enum class RelationOffsets : int {
 class RelationBlock {
  private:
     std::string id;
-    bool updateLocalRelationRecords(RelationOffsets, unsigned int);
-    bool updateCentralRelationRecords(RelationOffsets recordOffset, unsigned int data);
-    bool updateLocalRelationshipType(int offset, std::string type);
-    bool updateCentralRelationshipType(int offset, std::string type);
+    bool updateLocalRelationRecords(RelationOffsets, unsigned long);
+    bool updateCentralRelationRecords(RelationOffsets recordOffset, unsigned long data);
+    bool updateLocalRelationshipType(unsigned int typeId);
+    bool updateCentralRelationshipType(unsigned int typeId);
 
     NodeBlock *sourceBlock;
     NodeBlock *destinationBlock;
@@ -75,19 +76,19 @@ class RelationBlock {
         this->destinationBlock = &destination;
     }
 
-    RelationBlock(unsigned int addr, NodeRelation source, NodeRelation destination, unsigned int propertyAddress,
-                  std::string type) : addr(addr), source(source), destination(destination),
-                  propertyAddress(propertyAddress), type(type){
+    RelationBlock(unsigned long addr, NodeRelation source, NodeRelation destination, unsigned long propertyAddress,
+                  unsigned int typeId) : addr(addr), source(source), destination(destination),
+                  propertyAddress(propertyAddress), typeId(typeId){
         this->sourceBlock = NodeBlock::get(source.address);
         this->destinationBlock = NodeBlock::get(destination.address);
         this->source = source;
         this->destination = destination;
     };
 
-    RelationBlock(unsigned int address, NodeRelation source, NodeRelation destination, unsigned int propertyAddress,
-                  unsigned int metaPropertyAddress, std::string type) : addr(address), source(source),
+    RelationBlock(unsigned long address, NodeRelation source, NodeRelation destination, unsigned long propertyAddress,
+                  unsigned long metaPropertyAddress, unsigned int typeId) : addr(address), source(source),
                   destination(destination), propertyAddress(propertyAddress), metaPropertyAddress(metaPropertyAddress),
-                  type(type){
+                  typeId(typeId), isCentral(true) {  // Only central relation blocks have a meta property record
         this->sourceBlock = NodeBlock::get(source.address);
         this->destinationBlock = NodeBlock::get(destination.address);
         this->source = source;
@@ -95,27 +96,32 @@ class RelationBlock {
     };
 
     char usage;
-    unsigned int addr = 0;  // Block size * block ID for this block
+    unsigned long addr = 0;  // Block size * block ID for this block
     NodeRelation source;
     NodeRelation destination;
-    unsigned int propertyAddress = 0;
-    unsigned int metaPropertyAddress = 0;
-    std::string type = DEFAULT_TYPE;
+    unsigned long propertyAddress = 0;
+    unsigned long metaPropertyAddress = 0;
+    unsigned int typeId = 0;  // ID of the relationship type in the RelationTypeIndex, 0 if the relation has no type
+    bool isCentral = false;  // Whether this block is in the central relations DB
     PropertyEdgeLink *propertyHead = NULL;
-    static thread_local unsigned int nextLocalRelationIndex;
-    static thread_local unsigned int nextCentralRelationIndex;
     static thread_local const unsigned long BLOCK_SIZE;  // Size of a relation record block in bytes
     static thread_local const unsigned long CENTRAL_BLOCK_SIZE;  // Size of a relation record block in bytes
     static thread_local std::string DB_PATH;
     static thread_local std::fstream *relationsDB;
     static thread_local std::fstream *centralRelationsDB;
+    static thread_local MappedFile *relationsMap;  // Set only when the native store runs in mmap storage mode
+    static thread_local MappedFile *centralRelationsMap;
     static const int RECORD_SIZE = sizeof(unsigned int);
-    static const int MAX_TYPE_SIZE = 18;
+    static const int MAX_TYPE_SIZE = 18;  // Width of the type field, it holds the type ID record, the rest is reserved
     static const std::string DEFAULT_TYPE;
     static const int NUMBER_OF_CENTRAL_RELATION_RECORDS = 14;
     static const int CENTRAL_RELATIONSHIP_TYPE_OFFSET = 14;
     static const int NUMBER_OF_LOCAL_RELATION_RECORDS = 13;
     static const int LOCAL_RELATIONSHIP_TYPE_OFFSET = 13;
+    // Size of the larger central relation blocks, for buffers that hold either kind of block
+    static const int MAX_BLOCK_SIZE = RECORD_SIZE * NUMBER_OF_CENTRAL_RELATION_RECORDS + MAX_TYPE_SIZE;
+    // Source record of a relation block that was freed by a delete, the other records of the block are 0
+    static const unsigned int FREE_RECORD = 0xFFFFFFFF;
 
 
 
@@ -123,17 +129,17 @@ class RelationBlock {
     bool isInUse();
     int getFlags();
 
-    bool setLocalNextSource(unsigned int);
-    bool setCentralNextSource(unsigned int);
+    bool setLocalNextSource(unsigned long);
+    bool setCentralNextSource(unsigned long);
 
-    bool setLocalNextDestination(unsigned int);
-    bool setCentralNextDestination(unsigned int);
+    bool setLocalNextDestination(unsigned long);
+    bool setCentralNextDestination(unsigned long);
 
-    bool setLocalPreviousSource(unsigned int);
-    bool setCentralPreviousSource(unsigned int);
+    bool setLocalPreviousSource(unsigned long);
+    bool setCentralPreviousSource(unsigned long);
 
-    bool setLocalPreviousDestination(unsigned int);
-    bool setCentralPreviousDestination(unsigned int);
+    bool setLocalPreviousDestination(unsigned long);
+    bool setCentralPreviousDestination(unsigned long);
 
     NodeBlock *getSource();
     NodeBlock *getDestination();
@@ -156,20 +162,41 @@ class RelationBlock {
     RelationBlock *addLocalRelation(NodeBlock, NodeBlock);
     RelationBlock *addCentralRelation(NodeBlock source, NodeBlock destination);
 
-    static RelationBlock *getLocalRelation(unsigned int);
-    static RelationBlock *getCentralRelation(unsigned int address);
+    static RelationBlock *getLocalRelation(unsigned long);
+    static RelationBlock *getCentralRelation(unsigned long address);
+    static bool readLocalBlock(unsigned long address, char *block);
+    static bool readCentralBlock(unsigned long address, char *block);
+
+    // Size of the blocks a record refers to, 0 for the node ID, partition ID and type records
+    static unsigned long referenceBlockSize(RelationOffsets recordOffset, bool central);
+    // Translate a record value to and from its on-disk record, block addresses to their BlockFormat references
+    static unsigned int encodeRecord(RelationOffsets recordOffset, bool central, unsigned long value);
+    static unsigned long decodeRecord(RelationOffsets recordOffset, bool central, unsigned int record);
+    // Read or write a record of a raw relation block
+    static unsigned long readRecord(const char *block, RelationOffsets recordOffset, bool central);
+    static void writeRecord(char *block, RelationOffsets recordOffset, bool central, unsigned long value);
+    // Whether a raw relation block was freed, scans of the relation files skip these blocks
+    static bool isFree(const char *block);
+    // Overwrite the relation block with a freed block, the caller hands the block back to the BlockAllocator
+    static bool writeFreeBlock(unsigned long address, bool central);
 
     void addLocalProperty(std::string, char *);
     void addCentralProperty(std::string name, char *value);
+    void addLocalProperty(std::string name, const PropertyValue &value);
+    void addCentralProperty(std::string name, const PropertyValue &value);
     void addMetaProperty(std::string name, char *value);
-    void addLocalRelationshipType(char *value);
-    void addCentralRelationshipType(char *value);
+    void addLocalRelationshipType(const std::string &type);
+    void addCentralRelationshipType(const std::string &type);
 
     std::string getLocalRelationshipType();
     std::string getCentralRelationshipType();
+    // Replace the type names that relation blocks written before the RelationTypeIndex keep in their type field by
+    // type IDs and index the relations by type
+    static void migrateLegacyTypes(bool central, unsigned int relationCount);
     PropertyEdgeLink *getPropertyHead();
     MetaPropertyEdgeLink *getMetaPropertyHead();
     std::map<std::string, char *> getAllProperties();
+    bool getProperty(const std::string &name, PropertyValue &value);
 };
 
 #endif
@@ -0,0 +1,207 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "RelationCursor.h"
+
+#include <cstring>
+
+#include "../util/logger/Logger.h"
+#include "BlockFormat.h"
+#include "IncomingRelationHeads.h"
+#include "MetaPropertyEdgeLink.h"
+#include "NodeBlock.h"
+#include "PropertyEdgeLink.h"
+
+Logger relation_cursor_logger;
+
+/**
+ * Decode the relation records (see RelationOffsets) and the relationship type ID from the raw bytes of the relation
+ * block, read through the block cache
+ * */
+bool RelationView::read(unsigned long address, bool central, RelationView &relation) {
+    if (address == 0) {
+        return false;
+    }
+    unsigned long blockSize = central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+    if (address % blockSize != 0) {
+        relation_cursor_logger.error("Exception: Invalid relation block address !!\n received address = " +
+                                     std::to_string(address));
+        return false;
+    }
+    char block[RelationBlock::MAX_BLOCK_SIZE];
+    bool loaded = central ? RelationBlock::readCentralBlock(address, block)
+                          : RelationBlock::readLocalBlock(address, block);
+    if (!loaded) {
+        relation_cursor_logger.error("Error while reading " + std::string(central ? "central" : "local") +
+                                     " relation data from relation block address " + std::to_string(address));
+        return false;
+    }
+    if (RelationBlock::isFree(block)) {
+        return false;
+    }
+    auto record = [&block, central](RelationOffsets offset) {
+        return RelationBlock::readRecord(block, offset, central);
+    };
+    relation.addr = address;
+    relation.central = central;
+    relation.source.nodeId = record(RelationOffsets::SOURCE_ID);
+    relation.destination.nodeId = record(RelationOffsets::DESTINATION_ID);
+    relation.source.address = record(RelationOffsets::SOURCE);
+    relation.destination.address = record(RelationOffsets::DESTINATION);
+    relation.source.nextRelationId = record(RelationOffsets::SOURCE_NEXT);
+    relation.source.nextPid = record(RelationOffsets::SOURCE_NEXT_PID);
+    relation.source.preRelationId = record(RelationOffsets::SOURCE_PREVIOUS);
+    relation.source.prePid = record(RelationOffsets::SOURCE_PREVIOUS_PID);
+    relation.destination.nextRelationId = record(RelationOffsets::DESTINATION_NEXT);
+    relation.destination.nextPid = record(RelationOffsets::DESTINATION_NEXT_PID);
+    relation.destination.preRelationId = record(RelationOffsets::DESTINATION_PREVIOUS);
+    relation.destination.prePid = record(RelationOffsets::DESTINATION_PREVIOUS_PID);
+    relation.propertyAddress = record(RelationOffsets::RELATION_PROPS);
+    int typeOffset = central ? RelationBlock::CENTRAL_RELATIONSHIP_TYPE_OFFSET
+                             : RelationBlock::LOCAL_RELATIONSHIP_TYPE_OFFSET;
+    relation.metaPropertyAddress = central ? record(RelationOffsets::RELATION_PROPS_META) : 0;
+    std::memcpy(&relation.typeId, block + RelationBlock::RECORD_SIZE * typeOffset, RelationBlock::RECORD_SIZE);
+    relation.outgoing = true;
+    return true;
+}
+
+bool RelationView::getProperty(const std::string &name, PropertyValue &value) const {
+    if (PropertyStore::current) {
+        if (this->central) {
+            return PropertyStore::current->get(PropertyOwner::CENTRAL_RELATION,
+                                               this->addr / RelationBlock::CENTRAL_BLOCK_SIZE, name, value);
+        }
+        return PropertyStore::current->get(PropertyOwner::LOCAL_RELATION, this->addr / RelationBlock::BLOCK_SIZE,
+                                           name, value);
+    }
+    bool found = false;
+    PropertyEdgeLink *current = PropertyEdgeLink::get(this->propertyAddress);
+    while (current) {
+        if (current->name == name) {
+            value = PropertyValue::ofString(
+                std::string(current->value, strnlen(current->value, PropertyEdgeLink::MAX_VALUE_SIZE)));
+            found = true;
+            delete current;
+            break;
+        }
+        PropertyEdgeLink *temp = current->next();
+        delete current;
+        current = temp;
+    }
+    return found;
+}
+
+std::map<std::string, std::string> RelationView::getAllProperties() const {
+    std::map<std::string, std::string> allProperties;
+    if (PropertyStore::current) {
+        PropertyOwner owner = this->central ? PropertyOwner::CENTRAL_RELATION : PropertyOwner::LOCAL_RELATION;
+        unsigned long blockSize = this->central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE;
+        for (auto &property : PropertyStore::current->getAll(owner, this->addr / blockSize)) {
+            allProperties.insert({property.first, property.second.toString()});
+        }
+        return allProperties;
+    }
+    PropertyEdgeLink *current = PropertyEdgeLink::get(this->propertyAddress);
+    while (current) {
+        allProperties.insert(
+            {current->name, std::string(current->value, strnlen(current->value, PropertyEdgeLink::MAX_VALUE_SIZE))});
+        PropertyEdgeLink *temp = current->next();
+        delete current;
+        current = temp;
+    }
+    return allProperties;
+}
+
+std::string RelationView::getPartitionId() const {
+    std::string partitionId;
+    MetaPropertyEdgeLink *current = MetaPropertyEdgeLink::get(this->metaPropertyAddress);
+    while (current) {
+        if (current->name == MetaPropertyEdgeLink::PARTITION_ID) {
+            partitionId = std::string(current->value, strnlen(current->value, MetaPropertyEdgeLink::MAX_VALUE_SIZE));
+            delete current;
+            break;
+        }
+        MetaPropertyEdgeLink *temp = current->next();
+        delete current;
+        current = temp;
+    }
+    return partitionId;
+}
+
+RelationCursor::RelationCursor(unsigned long nodeAddress, bool central, RelationDirection direction)
+    : nodeAddress(nodeAddress),
+      nextAddress(0),
+      central(central),
+      outgoing(direction != RelationDirection::INCOMING),
+      bothDirections(direction == RelationDirection::BOTH) {
+    if (direction != RelationDirection::OUTGOING) {
+        if (!IncomingRelationHeads::current) {
+            relation_cursor_logger.error("No incoming relation heads attached to walk the relations of node " +
+                                         std::to_string(nodeAddress));
+        } else {
+            this->incomingHead = IncomingRelationHeads::current->get(nodeAddress / NodeBlock::BLOCK_SIZE, central);
+        }
+    }
+    if (direction == RelationDirection::INCOMING) {
+        this->nextAddress = this->incomingHead;
+        this->incomingHead = 0;
+        return;
+    }
+    char block[NodeBlock::BLOCK_SIZE];
+    if (!NodeBlock::readBlock(nodeAddress, block)) {
+        relation_cursor_logger.error("Error while reading node block data from block " + std::to_string(nodeAddress));
+        this->incomingHead = 0;
+        return;
+    }
+    // The outgoing relation heads are the edgeRef / centralEdgeRef records of the node block, see NodeBlock::save()
+    unsigned int head;
+    std::memcpy(&head, block + (central ? NodeBlock::CENTRAL_EDGE_REF_OFFSET : NodeBlock::EDGE_REF_OFFSET),
+                sizeof(head));
+    this->nextAddress =
+        BlockFormat::decode(head, central ? RelationBlock::CENTRAL_BLOCK_SIZE : RelationBlock::BLOCK_SIZE);
+}
+
+/**
+ * Decode the next relation of the chains. The outgoing chain of a node continues through the source records of its
+ * relations and the incoming chain through their destination records, the incoming chain is walked once the outgoing
+ * one ends.
+ * */
+bool RelationCursor::next(RelationView &relation) {
+    while (true) {
+        if (this->nextAddress == 0 && this->incomingHead != 0) {
+            this->nextAddress = this->incomingHead;
+            this->incomingHead = 0;
+            this->outgoing = false;
+        }
+        if (this->nextAddress == 0 || !RelationView::read(this->nextAddress, this->central, relation)) {
+            this->nextAddress = 0;
+            this->incomingHead = 0;
+            return false;
+        }
+        const NodeRelation &end = this->outgoing ? relation.source : relation.destination;
+        if (end.address != this->nodeAddress) {
+            relation_cursor_logger.error("Error: Unrecognized relation for " + std::to_string(this->nodeAddress) +
+                                         " in relation block " + std::to_string(relation.addr));
+            this->nextAddress = 0;
+            this->incomingHead = 0;
+            return false;
+        }
+        relation.outgoing = this->outgoing;
+        this->nextAddress = end.nextRelationId;
+        // A self loop is in both chains of its node, a walk of both directions returned it from the outgoing chain
+        if (this->bothDirections && !this->outgoing && relation.source.address == this->nodeAddress) {
+            continue;
+        }
+        return true;
+    }
+}
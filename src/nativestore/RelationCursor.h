@@ -0,0 +1,86 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_RELATIONCURSOR_H
+#define JASMINEGRAPH_RELATIONCURSOR_H
+
+#include <map>
+#include <string>
+
+#include "PropertyStore.h"
+#include "RelationBlock.h"
+
+/**
+ * Decoded records of a local or central relation block, held by value.
+ *
+ * Unlike RelationBlock a view does not load the NodeBlocks of the relation's endpoints, their addresses and node IDs
+ * are in source and destination. Properties are read on request and nothing read for them outlives the call.
+ * */
+struct RelationView {
+    unsigned long addr = 0;
+    bool central = false;
+    NodeRelation source;
+    NodeRelation destination;
+    unsigned long propertyAddress = 0;
+    unsigned long metaPropertyAddress = 0;  // Only central relation blocks have a meta property record
+    unsigned int typeId = 0;
+    bool outgoing = true;  // Whether RelationCursor read the relation from the outgoing chain of the walked node
+
+    // Endpoint of the relation at the other end of the walked node
+    unsigned long neighborAddress() const { return outgoing ? destination.address : source.address; }
+    unsigned int neighborId() const { return outgoing ? destination.nodeId : source.nodeId; }
+
+    // Decode the relation block at the given address, false if the address is invalid or the block can't be read
+    static bool read(unsigned long address, bool central, RelationView &relation);
+
+    bool getProperty(const std::string &name, PropertyValue &value) const;
+    std::map<std::string, std::string> getAllProperties() const;
+    // Partition ID meta property of a central relation, empty if the relation has none
+    std::string getPartitionId() const;
+};
+
+// Relation chains of a node a RelationCursor walks
+enum class RelationDirection { OUTGOING, INCOMING, BOTH };
+
+/**
+ * Walks the local or central relation chains of a node one relation block at a time. Blocks are read through the
+ * block cache into a buffer on the stack and decoded into a RelationView, so a walk allocates nothing on the heap.
+ *
+ * A node has an outgoing and an incoming chain, see IncomingRelationHeads. A walk of both directions reads the
+ * outgoing chain first and returns a self loop once, as an outgoing relation.
+ *
+ *     RelationCursor cursor(node->addr, false);
+ *     RelationView relation;
+ *     while (cursor.next(relation)) { ... relation.neighborAddress() ... }
+ * */
+class RelationCursor {
+ public:
+    // Walk the chains that start at the relation heads of the node block at nodeAddress
+    RelationCursor(unsigned long nodeAddress, bool central, RelationDirection direction = RelationDirection::BOTH);
+    // Walk the outgoing or incoming chain from a known head relation address, 0 for an empty chain
+    RelationCursor(unsigned long nodeAddress, unsigned long headAddress, bool central, bool outgoing)
+        : nodeAddress(nodeAddress), nextAddress(headAddress), central(central), outgoing(outgoing) {}
+
+    // Read the next relation of the chains, false at the end of the chains or if a block of them can't be read
+    bool next(RelationView &relation);
+
+ private:
+    unsigned long nodeAddress;
+    unsigned long nextAddress;
+    unsigned long incomingHead = 0;  // Head of the incoming chain while the outgoing chain of both is walked
+    bool central;
+    bool outgoing;
+    bool bothDirections = false;
+};
+
+#endif  // JASMINEGRAPH_RELATIONCURSOR_H
@@ -0,0 +1,259 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "RelationTypeIndex.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#include "../util/logger/Logger.h"
+#include "LabelIndex.h"
+
+Logger relation_type_index_logger;
+
+thread_local RelationTypeIndex *RelationTypeIndex::current = nullptr;
+std::map<std::string, RelationTypeIndex *> RelationTypeIndex::openIndexes;
+std::mutex RelationTypeIndex::openIndexesLock;
+
+static const unsigned int WORD_BITS = 64;
+
+RelationTypeIndex *RelationTypeIndex::acquire(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(RelationTypeIndex::openIndexesLock);
+    auto it = RelationTypeIndex::openIndexes.find(dbPrefix);
+    if (it != RelationTypeIndex::openIndexes.end()) {
+        it->second->references++;
+        return it->second;
+    }
+    RelationTypeIndex *index = new RelationTypeIndex(dbPrefix);
+    if (!index->open()) {
+        delete index;
+        return nullptr;
+    }
+    index->references++;
+    RelationTypeIndex::openIndexes[dbPrefix] = index;
+    return index;
+}
+
+void RelationTypeIndex::release(RelationTypeIndex *index) {
+    if (!index) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(RelationTypeIndex::openIndexesLock);
+    if (--index->references > 0) {
+        return;
+    }
+    RelationTypeIndex::openIndexes.erase(index->dbPrefix);
+    delete index;
+}
+
+bool RelationTypeIndex::exists(const std::string &dbPrefix) {
+    struct stat stat_buf;
+    return stat((dbPrefix + "_relation_types.db").c_str(), &stat_buf) == 0;
+}
+
+RelationTypeIndex::RelationTypeIndex(const std::string &dbPrefix) : dbPrefix(dbPrefix) {}
+
+RelationTypeIndex::~RelationTypeIndex() { this->close(); }
+
+/**
+ * Open the type dictionary and load it. Dictionary records are [type length (4)][type bytes], the ID of a type is the
+ * position of its record + 1.
+ * */
+bool RelationTypeIndex::open() {
+    std::string typesPath = this->dbPrefix + "_relation_types.db";
+    this->typesFd = ::open(typesPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (this->typesFd < 0) {
+        relation_type_index_logger.error("Error while opening relation type index " + typesPath);
+        return false;
+    }
+    this->typeNames.assign(1, "");
+    this->bitmapFds.assign(2, -1);
+    unsigned long long offset = 0;
+    unsigned int length;
+    while (pread(this->typesFd, &length, sizeof(length), offset) == sizeof(length)) {
+        std::string type(length, '\0');
+        if (pread(this->typesFd, &type[0], length, offset + sizeof(length)) != (ssize_t)length) {
+            relation_type_index_logger.error("Relation type index " + typesPath + " is corrupted!");
+            break;
+        }
+        this->typeIds[type] = this->typeNames.size();
+        this->typeNames.push_back(type);
+        this->bitmapFds.insert(this->bitmapFds.end(), 2, -1);
+        offset += sizeof(length) + length;
+    }
+    return true;
+}
+
+void RelationTypeIndex::close() {
+    for (int &fd : this->bitmapFds) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (this->typesFd >= 0) {
+        ::close(this->typesFd);
+        this->typesFd = -1;
+    }
+}
+
+std::string RelationTypeIndex::bitmapPath(unsigned int id, bool central) {
+    return this->dbPrefix + (central ? "_central_relation_type_" : "_relation_type_") + std::to_string(id) +
+           ".bitmap";
+}
+
+int RelationTypeIndex::typeId(const std::string &type, bool create) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    auto it = this->typeIds.find(type);
+    if (it != this->typeIds.end()) {
+        return it->second;
+    }
+    if (!create || type.empty()) {
+        return -1;
+    }
+    unsigned int length = type.length();
+    std::string record(reinterpret_cast<char *>(&length), sizeof(length));
+    record += type;
+    if (write(this->typesFd, record.data(), record.size()) != (ssize_t)record.size()) {
+        relation_type_index_logger.error("Error while adding relationship type " + type + " to the type index");
+        return -1;
+    }
+    int id = this->typeNames.size();
+    this->typeIds[type] = id;
+    this->typeNames.push_back(type);
+    this->bitmapFds.insert(this->bitmapFds.end(), 2, -1);
+    return id;
+}
+
+std::string RelationTypeIndex::typeName(unsigned int id) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (id >= this->typeNames.size()) {
+        return "";
+    }
+    return this->typeNames[id];
+}
+
+int RelationTypeIndex::bitmapFd(unsigned int id, bool central) {
+    int &fd = this->bitmapFds[2 * id + (central ? 1 : 0)];
+    if (fd < 0) {
+        fd = ::open(this->bitmapPath(id, central).c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            relation_type_index_logger.error("Error while opening relation type bitmap " +
+                                             this->bitmapPath(id, central));
+        }
+    }
+    return fd;
+}
+
+void RelationTypeIndex::updateBit(unsigned int id, bool central, unsigned int relationIndex, bool set) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (id == 0 || id >= this->typeNames.size()) {
+        return;
+    }
+    int fd = this->bitmapFd(id, central);
+    if (fd < 0) {
+        return;
+    }
+    off_t offset = (off_t)(relationIndex / WORD_BITS) * sizeof(unsigned long long);
+    unsigned long long word = 0;
+    if (pread(fd, &word, sizeof(word), offset) < 0) {
+        relation_type_index_logger.error("Error while reading relation type bitmap of " + this->typeNames[id]);
+        return;
+    }
+    if (set) {
+        word |= 1ULL << (relationIndex % WORD_BITS);
+    } else {
+        word &= ~(1ULL << (relationIndex % WORD_BITS));
+    }
+    if (pwrite(fd, &word, sizeof(word), offset) != sizeof(word)) {
+        relation_type_index_logger.error("Error while updating relation type bitmap of " + this->typeNames[id]);
+    }
+}
+
+void RelationTypeIndex::add(unsigned int id, bool central, unsigned int relationIndex) {
+    this->updateBit(id, central, relationIndex, true);
+}
+
+void RelationTypeIndex::remove(unsigned int id, bool central, unsigned int relationIndex) {
+    this->updateBit(id, central, relationIndex, false);
+}
+
+std::vector<unsigned int> RelationTypeIndex::getRelations(const std::string &type, bool central) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    auto it = this->typeIds.find(type);
+    if (it == this->typeIds.end()) {
+        return {};
+    }
+    int fd = this->bitmapFd(it->second, central);
+    struct stat stat_buf;
+    if (fd < 0 || fstat(fd, &stat_buf) != 0) {
+        return {};
+    }
+    LabelIndex::Bitmap bitmap(stat_buf.st_size / sizeof(unsigned long long));
+    if (pread(fd, bitmap.data(), bitmap.size() * sizeof(unsigned long long), 0) < 0) {
+        relation_type_index_logger.error("Error while reading relation type bitmap " +
+                                         this->bitmapPath(it->second, central));
+        return {};
+    }
+    return LabelIndex::toNodes(bitmap);
+}
+
+std::vector<std::string> RelationTypeIndex::getTypes() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return std::vector<std::string>(this->typeNames.begin() + 1, this->typeNames.end());
+}
+
+void RelationTypeIndex::rebuild(bool central, const std::vector<unsigned int> &relationTypes) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    std::vector<std::vector<unsigned long long>> bitmaps(this->typeNames.size());
+    for (unsigned int relationIndex = 0; relationIndex < relationTypes.size(); relationIndex++) {
+        unsigned int id = relationTypes[relationIndex];
+        if (id == 0 || id >= bitmaps.size()) {
+            continue;
+        }
+        bitmaps[id].resize(relationIndex / WORD_BITS + 1, 0);
+        bitmaps[id][relationIndex / WORD_BITS] |= 1ULL << (relationIndex % WORD_BITS);
+    }
+    for (unsigned int id = 1; id < bitmaps.size(); id++) {
+        int fd = this->bitmapFd(id, central);
+        if (fd < 0) {
+            continue;
+        }
+        size_t size = bitmaps[id].size() * sizeof(unsigned long long);
+        if (ftruncate(fd, 0) != 0 || pwrite(fd, bitmaps[id].data(), size, 0) != (ssize_t)size) {
+            relation_type_index_logger.error("Error while rebuilding relation type bitmap of " + this->typeNames[id]);
+        }
+    }
+}
+
+void RelationTypeIndex::truncate() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (unsigned int id = 1; id < this->typeNames.size(); id++) {
+        for (bool central : {false, true}) {
+            int fd = this->bitmapFds[2 * id + (central ? 1 : 0)];
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            std::remove(this->bitmapPath(id, central).c_str());
+        }
+    }
+    this->typeNames.assign(1, "");
+    this->typeIds.clear();
+    this->bitmapFds.assign(2, -1);
+    if (ftruncate(this->typesFd, 0) != 0) {
+        relation_type_index_logger.error("Error while truncating the relation type index of " + this->dbPrefix);
+    }
+}
@@ -0,0 +1,78 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_RELATIONTYPEINDEX_H
+#define JASMINEGRAPH_RELATIONTYPEINDEX_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Persistent relationship type dictionary and type -> relation set index of a partition.
+ *
+ * Relationship types are mapped to compact IDs by a dictionary (_relation_types.db), relation blocks keep the ID of
+ * their type instead of its name. ID 0 stands for relations without a type. Every type has a bitmap of the local
+ * relation blocks (_relation_type_<type ID>.bitmap) and one of the central relation blocks
+ * (_central_relation_type_<type ID>.bitmap) with that type, bit i is set for relation block i. A relationship type
+ * scan reads one bitmap instead of every relation block.
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see RelationTypeIndex::acquire().
+ * */
+class RelationTypeIndex {
+ public:
+    static RelationTypeIndex *acquire(const std::string &dbPrefix);
+    static void release(RelationTypeIndex *index);
+    static bool exists(const std::string &dbPrefix);
+
+    // ID of the type, the type is added to the dictionary if create is set. -1 for unknown types
+    int typeId(const std::string &type, bool create);
+    // Name of the type ID, empty for ID 0 and unknown IDs
+    std::string typeName(unsigned int id);
+    void add(unsigned int id, bool central, unsigned int relationIndex);
+    void remove(unsigned int id, bool central, unsigned int relationIndex);
+    // Relation block indexes of the local or central relations with the type, in ascending order
+    std::vector<unsigned int> getRelations(const std::string &type, bool central);
+    std::vector<std::string> getTypes();
+    // Re-create the bitmaps of the local or central relations, relationTypes holds the type ID of every relation block
+    void rebuild(bool central, const std::vector<unsigned int> &relationTypes);
+    void truncate();
+
+    // Index of the partition attached to the calling thread, NULL if none
+    static thread_local RelationTypeIndex *current;
+
+ private:
+    explicit RelationTypeIndex(const std::string &dbPrefix);
+    ~RelationTypeIndex();
+
+    bool open();
+    void close();
+    int bitmapFd(unsigned int id, bool central);
+    void updateBit(unsigned int id, bool central, unsigned int relationIndex, bool set);
+    std::string bitmapPath(unsigned int id, bool central);
+
+    std::string dbPrefix;
+    int typesFd = -1;
+    std::vector<std::string> typeNames;  // Indexed by type ID, typeNames[0] is the empty type
+    std::unordered_map<std::string, int> typeIds;
+    std::vector<int> bitmapFds;          // 2 * type ID for local relations, 2 * type ID + 1 for central relations
+    std::mutex lock;
+    int references = 0;
+
+    static std::map<std::string, RelationTypeIndex *> openIndexes;
+    static std::mutex openIndexesLock;
+};
+
+#endif  // JASMINEGRAPH_RELATIONTYPEINDEX_H
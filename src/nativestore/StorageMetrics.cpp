@@ -0,0 +1,118 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "StorageMetrics.h"
+
+#include <nlohmann/json.hpp>
+#include <vector>
+
+using json = nlohmann::json;
+
+std::map<std::string, StorageMetrics *> StorageMetrics::partitions;
+std::mutex StorageMetrics::partitionsLock;
+thread_local StorageMetrics *StorageMetrics::current = nullptr;
+
+StorageMetrics *StorageMetrics::get(const std::string &dbPrefix) {
+    std::lock_guard<std::mutex> guard(StorageMetrics::partitionsLock);
+    size_t separator = dbPrefix.find_last_of('/');
+    std::string partition = separator == std::string::npos ? dbPrefix : dbPrefix.substr(separator + 1);
+    auto it = StorageMetrics::partitions.find(partition);
+    if (it != StorageMetrics::partitions.end()) {
+        return it->second;
+    }
+    StorageMetrics *metrics = new StorageMetrics();
+    StorageMetrics::partitions[partition] = metrics;
+    return metrics;
+}
+
+const char *StorageMetrics::fileName(BlockFile file) {
+    static const char *names[BLOCK_FILES] = {"nodes",           "relations",       "central_relations",   "properties",
+                                             "meta_properties", "edge_properties", "meta_edge_properties"};
+    return names[static_cast<unsigned int>(file)];
+}
+
+StorageMetrics::Snapshot StorageMetrics::snapshot() {
+    Snapshot snapshot;
+    for (int file = 0; file < BLOCK_FILES; file++) {
+        StorageCounters &counters = snapshot.files[file];
+        counters.reads = this->files[file].reads;
+        counters.cacheHits = this->files[file].cacheHits;
+        counters.writes = this->files[file].writes;
+        counters.bytesRead = this->files[file].bytesRead;
+        counters.bytesWritten = this->files[file].bytesWritten;
+        counters.seeks = this->files[file].seeks;
+    }
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+        snapshot.latency[bucket] = this->latency[bucket];
+    }
+    return snapshot;
+}
+
+std::string StorageMetrics::toJson() {
+    std::map<std::string, StorageMetrics *> partitions;
+    {
+        std::lock_guard<std::mutex> guard(StorageMetrics::partitionsLock);
+        partitions = StorageMetrics::partitions;
+    }
+    json metrics = json::object();
+    for (auto &partition : partitions) {
+        Snapshot snapshot = partition.second->snapshot();
+        json files;
+        for (int file = 0; file < BLOCK_FILES; file++) {
+            const StorageCounters &counters = snapshot.files[file];
+            files[StorageMetrics::fileName(static_cast<BlockFile>(file))] = {
+                {"reads", counters.reads},   {"cacheHits", counters.cacheHits},
+                {"writes", counters.writes}, {"bytesRead", counters.bytesRead},
+                {"bytesWritten", counters.bytesWritten}, {"seeks", counters.seeks}};
+        }
+        metrics[partition.first] = {
+            {"files", files},
+            {"readLatency", std::vector<unsigned long>(snapshot.latency, snapshot.latency + LATENCY_BUCKETS)}};
+    }
+    return metrics.dump();
+}
+
+StorageMetrics::ReadTimer::ReadTimer(BlockFile file, unsigned long bytes)
+    : metrics(StorageMetrics::current), file(file), bytes(bytes) {
+    if (this->metrics) {
+        this->start = std::chrono::steady_clock::now();
+    }
+}
+
+void StorageMetrics::ReadTimer::load(bool seek) {
+    this->loaded = true;
+    if (this->metrics) {
+        this->metrics->count(this->file).bytesRead += this->bytes;
+        if (seek) {
+            this->metrics->count(this->file).seeks++;
+        }
+    }
+}
+
+StorageMetrics::ReadTimer::~ReadTimer() {
+    if (!this->metrics) {
+        return;
+    }
+    AtomicCounters &counters = this->metrics->count(this->file);
+    counters.reads++;
+    if (!this->loaded) {
+        counters.cacheHits++;
+    }
+    unsigned long long nanoseconds =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count();
+    int bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && nanoseconds >= (2ULL << bucket)) {
+        bucket++;
+    }
+    this->metrics->latency[bucket]++;
+}
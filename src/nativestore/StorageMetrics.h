@@ -0,0 +1,113 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_STORAGEMETRICS_H
+#define JASMINEGRAPH_STORAGEMETRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "BlockCache.h"
+
+// I/O counters of one block file of a partition
+struct StorageCounters {
+    unsigned long reads = 0;         // Block reads, including the ones served by the block cache
+    unsigned long cacheHits = 0;     // Block reads served by the block cache
+    unsigned long writes = 0;        // Writes through the block file stream, a block or some records of a block
+    unsigned long bytesRead = 0;     // Bytes loaded from the block file
+    unsigned long bytesWritten = 0;
+    unsigned long seeks = 0;         // Stream positionings for reads and writes
+};
+
+/**
+ * Storage I/O metrics of a native store partition: reads, cache hits, writes, bytes and seeks of every block file, and
+ * a histogram of block read latencies.
+ *
+ * The block classes count their reads and writes in the metrics attached to the calling thread, the same way they use
+ * its DB streams. NodeManagers come and go with every query, so the metrics of a partition stay for the lifetime of
+ * the process and the counters only grow. Readers take the difference of two snapshots.
+ * */
+class StorageMetrics {
+ public:
+    // Bucket i counts reads that took less than 2^(i+1) ns, the last bucket every slower read
+    static const int LATENCY_BUCKETS = 32;
+    static const int BLOCK_FILES = 7;
+
+    struct Snapshot {
+        StorageCounters files[BLOCK_FILES];
+        unsigned long latency[LATENCY_BUCKETS] = {0};
+    };
+
+    // Metrics of the partition with the given DB prefix, created on first use
+    static StorageMetrics *get(const std::string &dbPrefix);
+    // Metrics of every partition used in the process as JSON, keyed by partition name (g<graph>_p<partition>)
+    static std::string toJson();
+    static const char *fileName(BlockFile file);
+
+    Snapshot snapshot();
+
+    // Count a write of the calling thread's partition, one positioning of the stream followed by bytes of writes
+    static void recordWrite(BlockFile file, unsigned long bytes) {
+        if (current) {
+            current->count(file).writes++;
+            current->count(file).bytesWritten += bytes;
+            current->count(file).seeks++;
+        }
+    }
+
+    /**
+     * Times a block read of the calling thread's partition from construction to destruction. The loader of the block
+     * calls load() when the block is not in the block cache.
+     * */
+    class ReadTimer {
+     public:
+        ReadTimer(BlockFile file, unsigned long bytes);
+        ~ReadTimer();
+        void load(bool seek);
+
+     private:
+        StorageMetrics *metrics;
+        BlockFile file;
+        unsigned long bytes;
+        bool loaded = false;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Metrics of the partition attached to the calling thread, NULL if none
+    static thread_local StorageMetrics *current;
+
+ private:
+    StorageMetrics() = default;
+
+    struct AtomicCounters {
+        std::atomic<unsigned long> reads{0};
+        std::atomic<unsigned long> cacheHits{0};
+        std::atomic<unsigned long> writes{0};
+        std::atomic<unsigned long> bytesRead{0};
+        std::atomic<unsigned long> bytesWritten{0};
+        std::atomic<unsigned long> seeks{0};
+    };
+
+    AtomicCounters &count(BlockFile file) { return this->files[static_cast<unsigned int>(file)]; }
+
+    AtomicCounters files[BLOCK_FILES];
+    std::atomic<unsigned long> latency[LATENCY_BUCKETS] = {};
+
+    static std::map<std::string, StorageMetrics *> partitions;
+    static std::mutex partitionsLock;
+};
+
+#endif  // JASMINEGRAPH_STORAGEMETRICS_H
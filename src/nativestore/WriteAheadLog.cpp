@@ -0,0 +1,277 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include "WriteAheadLog.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+
+#include "../util/Utils.h"
+#include "../util/logger/Logger.h"
+
+Logger wal_logger;
+
+std::map<std::string, WriteAheadLog *> WriteAheadLog::openLogs;
+std::mutex WriteAheadLog::openLogsLock;
+
+static const size_t RECORD_HEADER_SIZE = sizeof(unsigned int) + sizeof(unsigned long long) + sizeof(char);
+
+WriteAheadLog *WriteAheadLog::acquire(const std::string &dbPrefix, bool *opened) {
+    std::lock_guard<std::mutex> guard(WriteAheadLog::openLogsLock);
+    if (opened) {
+        *opened = false;
+    }
+    auto it = WriteAheadLog::openLogs.find(dbPrefix);
+    if (it != WriteAheadLog::openLogs.end()) {
+        it->second->references++;
+        return it->second;
+    }
+    WriteAheadLog *log = new WriteAheadLog(dbPrefix);
+    if (!log->open()) {
+        delete log;
+        return nullptr;
+    }
+    log->references++;
+    WriteAheadLog::openLogs[dbPrefix] = log;
+    if (opened) {
+        *opened = true;
+    }
+    return log;
+}
+
+void WriteAheadLog::release(WriteAheadLog *log) {
+    if (!log) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(WriteAheadLog::openLogsLock);
+    if (--log->references > 0) {
+        return;
+    }
+    WriteAheadLog::openLogs.erase(log->dbPrefix);
+    delete log;
+}
+
+WriteAheadLog::WriteAheadLog(const std::string &dbPrefix) : dbPrefix(dbPrefix), path(dbPrefix + "_wal.log") {
+    this->commitRecords = readSetting("org.jasminegraph.nativestore.wal.commit.records",
+                                      WriteAheadLog::DEFAULT_COMMIT_RECORDS);
+    this->commitIntervalMs = readSetting("org.jasminegraph.nativestore.wal.commit.interval",
+                                         WriteAheadLog::DEFAULT_COMMIT_INTERVAL_MS);
+    this->checkpointRecords = readSetting("org.jasminegraph.nativestore.wal.checkpoint.records",
+                                          WriteAheadLog::DEFAULT_CHECKPOINT_RECORDS);
+}
+
+WriteAheadLog::~WriteAheadLog() { this->close(); }
+
+unsigned long WriteAheadLog::readSetting(const std::string &key, unsigned long defaultValue) {
+    std::string setting = Utils::getJasmineGraphProperty(key);
+    if (setting.empty()) {
+        return defaultValue;
+    }
+    try {
+        return std::stoul(setting);
+    } catch (std::exception &e) {
+        wal_logger.warn("Invalid value " + setting + " of " + key + ", using " + std::to_string(defaultValue));
+    }
+    return defaultValue;
+}
+
+/**
+ * Open the log and count the records left from the last run. The committer thread syncs pending records every commit
+ * interval.
+ * */
+bool WriteAheadLog::open() {
+    this->fd = ::open(this->path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (this->fd < 0) {
+        wal_logger.error("Error while opening write-ahead log " + this->path);
+        return false;
+    }
+    this->records = this->replay(nullptr);
+    if (this->commitIntervalMs > 0) {
+        this->committer = std::thread(&WriteAheadLog::runCommitter, this);
+    }
+    return true;
+}
+
+void WriteAheadLog::close() {
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->commitSignal.notify_all();
+    if (this->committer.joinable()) {
+        this->committer.join();
+    }
+    if (this->fd >= 0) {
+        fdatasync(this->fd);
+        ::close(this->fd);
+        this->fd = -1;
+    }
+}
+
+void WriteAheadLog::runCommitter() {
+    std::unique_lock<std::mutex> guard(this->lock);
+    while (!this->stopping) {
+        this->commitSignal.wait_for(guard, std::chrono::milliseconds(this->commitIntervalMs));
+        if (this->pendingRecords > 0) {
+            this->sync(guard);
+        }
+    }
+}
+
+unsigned long long WriteAheadLog::checksum(WalRecordType type, const std::string &payload) {
+    unsigned long long hash = 14695981039346656037ULL;  // FNV-1a
+    hash = (hash ^ static_cast<unsigned char>(type)) * 1099511628211ULL;
+    for (unsigned char c : payload) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void WriteAheadLog::append(WalRecordType type, const std::string &payload) {
+    this->append(type, std::vector<std::string>{payload});
+}
+
+/**
+ * Append the records with one write. The records are synced by the committer thread, or right away once
+ * org.jasminegraph.nativestore.wal.commit.records records are pending.
+ * */
+void WriteAheadLog::append(WalRecordType type, const std::vector<std::string> &payloads) {
+    std::string buffer;
+    for (const auto &payload : payloads) {
+        unsigned int length = payload.size();
+        unsigned long long sum = WriteAheadLog::checksum(type, payload);
+        buffer.append(reinterpret_cast<char *>(&length), sizeof(length));
+        buffer.append(reinterpret_cast<char *>(&sum), sizeof(sum));
+        buffer.push_back(static_cast<char>(type));
+        buffer.append(payload);
+    }
+    std::unique_lock<std::mutex> guard(this->lock);
+    if (payloads.empty() || (this->replaying && this->replayThread == std::this_thread::get_id())) {
+        return;  // Replayed records are in the log already
+    }
+    this->replayDone.wait(guard, [this]() { return !this->replaying; });
+    size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t count = write(this->fd, buffer.data() + written, buffer.size() - written);
+        if (count < 0) {
+            wal_logger.error("Error while appending to write-ahead log " + this->path);
+            return;
+        }
+        written += count;
+    }
+    this->records += payloads.size();
+    this->pendingRecords += payloads.size();
+    if (this->pendingRecords >= this->commitRecords) {
+        this->sync(guard);
+    }
+}
+
+void WriteAheadLog::commit() {
+    std::unique_lock<std::mutex> guard(this->lock);
+    if (this->pendingRecords > 0) {
+        this->sync(guard);
+    }
+}
+
+/**
+ * Sync the log, the lock is released while the disk syncs so that appends of other threads join the next commit
+ * */
+void WriteAheadLog::sync(std::unique_lock<std::mutex> &guard) {
+    this->pendingRecords = 0;
+    guard.unlock();
+    if (fdatasync(this->fd) != 0) {
+        wal_logger.error("Error while syncing write-ahead log " + this->path);
+    }
+    guard.lock();
+}
+
+/**
+ * Read the records of the log in order and pass them to apply. A torn record at the end of the log, left by a crash
+ * during an append, is cut off. Without an apply function the records are only counted.
+ * */
+unsigned long WriteAheadLog::replay(const std::function<void(WalRecordType, const std::string &)> &apply) {
+    std::unique_lock<std::mutex> guard(this->lock);
+    struct stat stat_buf;
+    if (fstat(this->fd, &stat_buf) != 0) {
+        wal_logger.error("Error while reading write-ahead log " + this->path);
+        return 0;
+    }
+    std::string log(stat_buf.st_size, '\0');
+    if (pread(this->fd, &log[0], log.size(), 0) != (ssize_t)log.size()) {
+        wal_logger.error("Error while reading write-ahead log " + this->path);
+        return 0;
+    }
+    size_t offset = 0;
+    std::vector<std::pair<WalRecordType, std::string>> logged;
+    while (offset + RECORD_HEADER_SIZE <= log.size()) {
+        unsigned int length;
+        unsigned long long sum;
+        std::memcpy(&length, log.data() + offset, sizeof(length));
+        std::memcpy(&sum, log.data() + offset + sizeof(length), sizeof(sum));
+        WalRecordType type = static_cast<WalRecordType>(log[offset + RECORD_HEADER_SIZE - 1]);
+        if (offset + RECORD_HEADER_SIZE + length > log.size()) {
+            break;
+        }
+        std::string payload = log.substr(offset + RECORD_HEADER_SIZE, length);
+        if (WriteAheadLog::checksum(type, payload) != sum) {
+            break;
+        }
+        logged.push_back({type, std::move(payload)});
+        offset += RECORD_HEADER_SIZE + length;
+    }
+    if (offset < log.size()) {
+        wal_logger.warn("Dropping a torn record at offset " + std::to_string(offset) + " of " + this->path);
+        if (ftruncate(this->fd, offset) != 0) {
+            wal_logger.error("Error while truncating write-ahead log " + this->path);
+        }
+    }
+    if (!apply) {
+        return logged.size();
+    }
+    wal_logger.info("Replaying " + std::to_string(logged.size()) + " records of " + this->path);
+    this->replaying = true;
+    this->replayThread = std::this_thread::get_id();
+    guard.unlock();
+    for (const auto &record : logged) {
+        apply(record.first, record.second);
+    }
+    guard.lock();
+    this->replaying = false;
+    this->replayDone.notify_all();
+    return logged.size();
+}
+
+void WriteAheadLog::checkpoint() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (ftruncate(this->fd, 0) != 0 || fdatasync(this->fd) != 0) {
+        wal_logger.error("Error while truncating write-ahead log " + this->path);
+        return;
+    }
+    this->records = 0;
+    this->pendingRecords = 0;
+}
+
+unsigned long WriteAheadLog::size() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->records;
+}
+
+bool WriteAheadLog::needsCheckpoint() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->checkpointRecords > 0 && this->records >= this->checkpointRecords;
+}
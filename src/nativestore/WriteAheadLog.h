@@ -0,0 +1,102 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#ifndef JASMINEGRAPH_WRITEAHEADLOG_H
+#define JASMINEGRAPH_WRITEAHEADLOG_H
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Logical operation of a WAL record, the payload is the stream message of the operation
+enum class WalRecordType : char { MESSAGE = 'm', LOCAL_EDGE = 'l', CENTRAL_EDGE = 'c' };
+
+/**
+ * Write-ahead log of the logical node and edge operations of a native store partition (_wal.log).
+ *
+ * The incremental local store logs every stream message before it is applied to the block files. A record reaches
+ * the OS when it is appended, so it survives a crash of the worker, and the log is synced to disk by group commit:
+ * once org.jasminegraph.nativestore.wal.commit.records records are pending or every
+ * org.jasminegraph.nativestore.wal.commit.interval milliseconds. The log is for durability, it does not defer block
+ * writes: the blocks of an operation are still written to the block files as it is applied, only the chain updates
+ * of blocks resident in the block cache wait there as dirty blocks. The block files are synced to disk only by
+ * NodeManager::checkpoint() of the incremental local store, which then truncates the log. The records left in the log
+ * when a partition is opened are replayed by the incremental local store. Other NodeManagers of the partition only
+ * sync the blocks they wrote, the records of the writer are kept for its own checkpoint.
+ *
+ * Records are [payload length (4)][checksum (8)][type (1)][payload], replay stops at the first torn record.
+ *
+ * Instances are shared by all NodeManagers of a partition in the process, see WriteAheadLog::acquire().
+ * */
+class WriteAheadLog {
+ public:
+    // opened is set if this call opened the log, false if another NodeManager of the partition has it open
+    static WriteAheadLog *acquire(const std::string &dbPrefix, bool *opened = NULL);
+    static void release(WriteAheadLog *log);
+
+    void append(WalRecordType type, const std::string &payload);
+    void append(WalRecordType type, const std::vector<std::string> &payloads);
+    // Sync the appended records to disk
+    void commit();
+    // Apply the records logged since the last checkpoint, returns the number of records applied. Records appended by
+    // apply are not logged again, appends of other threads wait until the replay is done
+    unsigned long replay(const std::function<void(WalRecordType, const std::string &)> &apply);
+    // Drop the logged records, called after the block files are synced
+    void checkpoint();
+    // Records logged since the last checkpoint
+    unsigned long size();
+    // True once org.jasminegraph.nativestore.wal.checkpoint.records records are logged
+    bool needsCheckpoint();
+
+    static const unsigned long DEFAULT_COMMIT_RECORDS = 1000;
+    static const unsigned long DEFAULT_COMMIT_INTERVAL_MS = 50;
+    static const unsigned long DEFAULT_CHECKPOINT_RECORDS = 100000;
+
+ private:
+    explicit WriteAheadLog(const std::string &dbPrefix);
+    ~WriteAheadLog();
+
+    bool open();
+    void close();
+    void sync(std::unique_lock<std::mutex> &guard);
+    void runCommitter();
+    static unsigned long long checksum(WalRecordType type, const std::string &payload);
+    static unsigned long readSetting(const std::string &key, unsigned long defaultValue);
+
+    std::string dbPrefix;
+    std::string path;
+    int fd = -1;
+    unsigned long records = 0;         // Records logged since the last checkpoint
+    unsigned long pendingRecords = 0;  // Records appended after the last sync
+    bool replaying = false;
+    std::thread::id replayThread;  // Thread that applies the records while replaying is set
+    unsigned long commitRecords;
+    unsigned long commitIntervalMs;
+    unsigned long checkpointRecords;
+
+    std::mutex lock;
+    std::condition_variable commitSignal;
+    std::condition_variable replayDone;
+    std::thread committer;
+    bool stopping = false;
+    int references = 0;
+
+    static std::map<std::string, WriteAheadLog *> openLogs;
+    static std::mutex openLogsLock;
+};
+
+#endif  // JASMINEGRAPH_WRITEAHEADLOG_H
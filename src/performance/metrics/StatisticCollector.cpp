@@ -13,6 +13,8 @@ limitations under the License.
 
 #include "StatisticCollector.h"
 
+#include "../../nativestore/StorageMetrics.h"
+
 Logger stat_logger;
 static int numProcessors;
 
@@ -317,6 +319,8 @@ double StatisticCollector::getLoadAverage() {
     return loadAvg;
 }
 
+std::string StatisticCollector::getStorageMetrics() { return StorageMetrics::toJson(); }
+
 void StatisticCollector::logLoadAverage(std::string name) {
     PerformanceUtil::logLoadAverage();
 
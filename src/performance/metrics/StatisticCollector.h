@@ -55,6 +55,8 @@ class StatisticCollector {
     static double getTotalCpuUsage();
     static double getLoadAverage();
     static void logLoadAverage(std::string name);
+    // Storage I/O counters and read latency histograms of the native store partitions used by this worker, as JSON
+    static std::string getStorageMetrics();
 };
 
 #endif  // JASMINEGRAPH_STATISTICCOLLECTOR_H
@@ -17,15 +17,19 @@ limitations under the License.
 #include <future>
 #include <sstream>
 
+#include "../../../nativestore/RelationCursor.h"
 #include "../../../util/logger/Logger.h"
 
 Logger streaming_triangle_logger;
 std::map<long, std::unordered_set<long>> StreamingTriangles::localAdjacencyList;
 std::map<std::string, std::map<long, std::unordered_set<long>>> StreamingTriangles::centralAdjacencyList;
+long StreamingTriangles::localTriangleCount = 0;
+unsigned long StreamingTriangles::localRelationChanges = 0;
 
 TriangleResult StreamingTriangles::countTriangles(NodeManager* nodeManager, bool returnTriangles) {
-    std::map<long, std::unordered_set<long>> adjacencyList = nodeManager->getAdjacencyList();
-    std::map<long, long> distributionMap = nodeManager->getDistributionMap();
+    CsrSnapshot snapshot = nodeManager->getCsrSnapshot();
+    std::map<long, std::unordered_set<long>> adjacencyList = snapshot.toAdjacencyList();
+    std::map<long, long> distributionMap = snapshot.toDegreeMap();
 
     const TriangleResult &result = Triangles::countTriangles(adjacencyList, distributionMap, returnTriangles);
 
@@ -35,10 +39,8 @@ TriangleResult StreamingTriangles::countTriangles(NodeManager* nodeManager, bool
 NativeStoreTriangleResult StreamingTriangles::countLocalStreamingTriangles(
         JasmineGraphIncrementalLocalStore *incrementalLocalStoreInstance) {
     streaming_triangle_logger.info("###STREAMING TRIANGLE### Static Streaming Local Triangle Counting: Started");
-    const TriangleResult &result = countTriangles(incrementalLocalStoreInstance->nm, false);
-    long triangleCount = result.count;
-
     NodeManager* nodeManager = incrementalLocalStoreInstance->nm;
+    long triangleCount = recountLocalTriangles(nodeManager);
     std::string graphID = std::to_string(nodeManager->getGraphID());
     std::string partitionID = std::to_string(nodeManager->getPartitionID());
 
@@ -55,6 +57,19 @@ NativeStoreTriangleResult StreamingTriangles::countLocalStreamingTriangles(
     return nativeStoreTriangleResult;
 }
 
+/**
+ * Count the triangles of the whole partition and keep its edges and the count as the state the next dynamic count
+ * starts from.
+ * */
+long StreamingTriangles::recountLocalTriangles(NodeManager* nodeManager) {
+    localRelationChanges = nodeManager->relationBlockChanges();
+    CsrSnapshot snapshot = nodeManager->getCsrSnapshot();
+    localAdjacencyList = snapshot.toAdjacencyList();
+    std::map<long, long> distributionMap = snapshot.toDegreeMap();
+    localTriangleCount = Triangles::countTriangles(localAdjacencyList, distributionMap, false).count;
+    return localTriangleCount;
+}
+
 std::string StreamingTriangles::countCentralStoreStreamingTriangles(std::string graphId,
                                                                     std::vector<std::string> partitionIdList) {
     streaming_triangle_logger.info("###STREAMING TRIANGLE### Static Streaming Central Triangle "
@@ -115,12 +130,14 @@ std::vector<std::pair<long, long>> StreamingTriangles::getEdges(unsigned int gra
                                     std::to_string(newCentralRelationCount));
 
     for (int i = previousCentralRelationCount + 1; i <= newCentralRelationCount ; i++) {
-        RelationBlock* relationBlock = RelationBlock::getCentralRelation(i*relationBlockSize);
-        long source = std::stol(relationBlock->getSource()->id);
-        long target = std::stol(relationBlock->getDestination()->id);
+        RelationView relation;
+        if (!RelationView::read(i * relationBlockSize, true, relation)) {
+            continue;
+        }
+        long source = relation.source.nodeId;
+        long target = relation.destination.nodeId;
         edges.push_back(std::make_pair(source, target));
         edges.push_back(std::make_pair(target, source));
-        delete relationBlock;
     }
 
     return edges;
@@ -148,6 +165,16 @@ NativeStoreTriangleResult StreamingTriangles::countDynamicLocalTriangles(
     streaming_triangle_logger.debug("got relation count " + std::to_string(newLocalRelationCount) + " " +
                                   std::to_string(newCentralRelationCount));
 
+    // Relations deleted, or added in the blocks of deleted relations below the old relation counts, are not found
+    // past the old counts. The partition is counted again and the result is the difference to the last count
+    if (nodeManager->relationBlockChanges() != localRelationChanges) {
+        long previousCount = localTriangleCount;
+        long trianglesValue = recountLocalTriangles(nodeManager) - previousCount;
+        streaming_triangle_logger.info("###STREAMING TRIANGLE### Dynamic Streaming Local Triangle "
+                                       "Counting: Completed by a full count : " + std::to_string(trianglesValue));
+        return NativeStoreTriangleResult{newLocalRelationCount, newCentralRelationCount, trianglesValue};
+    }
+
     if ((oldLocalRelationCount == newLocalRelationCount) && (oldCentralRelationCount == newCentralRelationCount)) {
         NativeStoreTriangleResult nativeStoreTriangleResult{newLocalRelationCount,
                                                             newCentralRelationCount, 0};
@@ -157,34 +184,39 @@ NativeStoreTriangleResult StreamingTriangles::countDynamicLocalTriangles(
     }
 
     for (int i = oldLocalRelationCount + 1; i <= newLocalRelationCount; i++) {
-        RelationBlock* relationBlock = RelationBlock::getLocalRelation(i*relationBlockSize);
-        long sourceNode = std::stol(relationBlock->getSource()->id);
-        long targetNode = std::stol(relationBlock->getDestination()->id);
+        RelationView relation;
+        if (!RelationView::read(i * relationBlockSize, false, relation)) {
+            continue;
+        }
+        long sourceNode = relation.source.nodeId;
+        long targetNode = relation.destination.nodeId;
         edges.push_back(std::make_pair(sourceNode, targetNode));
         edges.push_back(std::make_pair(targetNode, sourceNode));
         newAdjacencyList[sourceNode].insert(targetNode);
         newAdjacencyList[targetNode].insert(sourceNode);
         localAdjacencyList[sourceNode].insert(targetNode);
         localAdjacencyList[targetNode].insert(sourceNode);
-        delete relationBlock;
     }
 
     for (int i = oldCentralRelationCount + 1; i <= newCentralRelationCount ; i++) {
-        RelationBlock* relationBlock = RelationBlock::getCentralRelation(i*centralRelationBlockSize);
-        long sourceNode = std::stol(relationBlock->getSource()->id);
-        long targetNode = std::stol(relationBlock->getDestination()->id);
+        RelationView relation;
+        if (!RelationView::read(i * centralRelationBlockSize, true, relation)) {
+            continue;
+        }
+        long sourceNode = relation.source.nodeId;
+        long targetNode = relation.destination.nodeId;
         edges.push_back(std::make_pair(sourceNode, targetNode));
         edges.push_back(std::make_pair(targetNode, sourceNode));
         newAdjacencyList[sourceNode].insert(targetNode);
         newAdjacencyList[targetNode].insert(sourceNode);
         localAdjacencyList[sourceNode].insert(targetNode);
         localAdjacencyList[targetNode].insert(sourceNode);
-        delete relationBlock;
     }
 
     std::map<long, std::unordered_set<long>> adjacencyList = localAdjacencyList;
 
     long trianglesValue = totalCount(adjacencyList, newAdjacencyList, edges);
+    localTriangleCount += trianglesValue;
 
     NativeStoreTriangleResult nativeStoreTriangleResult{newLocalRelationCount, newCentralRelationCount,
                                                         trianglesValue};
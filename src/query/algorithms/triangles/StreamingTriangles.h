@@ -37,6 +37,9 @@ class StreamingTriangles {
  public:
     static std::map<long, std::unordered_set<long>> localAdjacencyList;
     static std::map<std::string, std::map<long, std::unordered_set<long>>> centralAdjacencyList;
+    // Local triangles and NodeManager::relationBlockChanges() as of the last count, see countDynamicLocalTriangles()
+    static long localTriangleCount;
+    static unsigned long localRelationChanges;
     static TriangleResult countTriangles(NodeManager* nodeManager, bool returnTriangles);
 
     static NativeStoreTriangleResult countLocalStreamingTriangles(
@@ -60,6 +63,7 @@ class StreamingTriangles {
     static long count(const std::map<long, std::unordered_set<long>>& g1,
                       const std::map<long, std::unordered_set<long>>& g2,
                       const std::vector<std::pair<long, long>>& edges);
+    static long recountLocalTriangles(NodeManager* nodeManager);
     static long totalCount(const std::map<long, std::unordered_set<long>>& g1,
                     std::map<long, std::unordered_set<long>>& g2,
                     std::vector<std::pair<long, long>>& edges);
@@ -846,33 +846,34 @@ any ASTBuilder::visitOC_ComparisonExpression(CypherParser::OC_ComparisonExpressi
 }
 
 any ASTBuilder::visitOC_PartialComparisonExpression(CypherParser::OC_PartialComparisonExpressionContext *ctx)  {
-  if (ctx->getText().find("<>") != string::npos) {
+  // The text starts with the operator, two character operators are matched before their one character prefixes
+  if (ctx->getText().rfind("<>", 0) == 0) {
     auto *node = new ASTInternalNode(Const::GREATER_THAN_LOWER_THAN);
     node->addElements(any_cast<ASTNode*>(visitOC_StringListNullPredicateExpression(
             ctx->oC_StringListNullPredicateExpression())));
     return static_cast<ASTNode*>(node);
-  } else if (ctx->getText().find(">") != string::npos) {
-    auto *node = new ASTInternalNode(Const::GREATER_THAN);
+  } else if (ctx->getText().rfind(">=", 0) == 0) {
+    auto *node = new ASTInternalNode(Const::GREATER_THAN_OR_EQUAL);
     node->addElements(any_cast<ASTNode*>(visitOC_StringListNullPredicateExpression(
             ctx->oC_StringListNullPredicateExpression())));
     return static_cast<ASTNode*>(node);
-  } else if (ctx->getText().find("=") != string::npos) {
-    auto *node = new ASTInternalNode(Const::DOUBLE_EQUAL);
+  } else if (ctx->getText().rfind("<=", 0) == 0) {
+    auto *node = new ASTInternalNode(Const::LOWER_THAN_OR_EQUAL);
     node->addElements(any_cast<ASTNode*>(visitOC_StringListNullPredicateExpression(
             ctx->oC_StringListNullPredicateExpression())));
     return static_cast<ASTNode*>(node);
-  } else if (ctx->getText().find("<") != string::npos) {
-    auto *node = new ASTInternalNode(Const::LOWER_THAN);
+  } else if (ctx->getText().rfind(">", 0) == 0) {
+    auto *node = new ASTInternalNode(Const::GREATER_THAN);
     node->addElements(any_cast<ASTNode*>(visitOC_StringListNullPredicateExpression(
             ctx->oC_StringListNullPredicateExpression())));
     return static_cast<ASTNode*>(node);
-  } else if (ctx->getText().find(">=") != string::npos) {
-    auto *node = new ASTInternalNode(Const::GREATER_THAN_OR_EQUAL);
+  } else if (ctx->getText().rfind("<", 0) == 0) {
+    auto *node = new ASTInternalNode(Const::LOWER_THAN);
     node->addElements(any_cast<ASTNode*>(visitOC_StringListNullPredicateExpression(
             ctx->oC_StringListNullPredicateExpression())));
     return static_cast<ASTNode*>(node);
   } else {
-    auto *node = new ASTInternalNode(Const::LOWER_THAN_OR_EQUAL);
+    auto *node = new ASTInternalNode(Const::DOUBLE_EQUAL);
     node->addElements(any_cast<ASTNode*>(visitOC_StringListNullPredicateExpression(
             ctx->oC_StringListNullPredicateExpression())));
     return static_cast<ASTNode*>(node);
@@ -57,6 +57,64 @@ string NodeByIdSeek::execute() {
     return nodeByIdSeek.dump();
 }
 
+// NodeIndexSeek Implementation
+NodeIndexSeek::NodeIndexSeek(string property, string value, vector<string> labels, string var)
+    : property(property), value(value), labels(labels), var(var) {}
+
+string NodeIndexSeek::execute() {
+    json nodeIndexSeek;
+    nodeIndexSeek["Operator"] = "NodeIndexSeek";
+    nodeIndexSeek["variable"] = var;
+    nodeIndexSeek["Label"] = labels;
+    nodeIndexSeek["property"] = property;
+    nodeIndexSeek["value"] = value;
+    return nodeIndexSeek.dump();
+}
+
+// NodeIndexRangeScan Implementation
+NodeIndexRangeScan::NodeIndexRangeScan(string property, vector<string> labels, string var)
+    : property(property), labels(labels), var(var) {}
+
+void NodeIndexRangeScan::setLowerBound(string value, bool inclusive) {
+    this->lower = value;
+    this->lowerInclusive = inclusive;
+}
+
+void NodeIndexRangeScan::setUpperBound(string value, bool inclusive) {
+    this->upper = value;
+    this->upperInclusive = inclusive;
+}
+
+string NodeIndexRangeScan::execute() {
+    json nodeIndexRangeScan;
+    nodeIndexRangeScan["Operator"] = "NodeIndexRangeScan";
+    nodeIndexRangeScan["variable"] = var;
+    nodeIndexRangeScan["Label"] = labels;
+    nodeIndexRangeScan["property"] = property;
+    if (!lower.empty()) {
+        nodeIndexRangeScan["lower"] = lower;
+        nodeIndexRangeScan["lowerInclusive"] = lowerInclusive;
+    }
+    if (!upper.empty()) {
+        nodeIndexRangeScan["upper"] = upper;
+        nodeIndexRangeScan["upperInclusive"] = upperInclusive;
+    }
+    return nodeIndexRangeScan.dump();
+}
+
+// CreateIndex Implementation
+CreateIndex::CreateIndex(string property, string indexType, string label)
+    : property(property), indexType(indexType), label(label) {}
+
+string CreateIndex::execute() {
+    json createIndex;
+    createIndex["Operator"] = "CreateIndex";
+    createIndex["property"] = property;
+    createIndex["indexType"] = indexType;
+    createIndex["Label"] = label;
+    return createIndex.dump();
+}
+
 // AllNodeScan Implementation
 AllNodeScan::AllNodeScan(const string& var) : var(var) {}
 
@@ -682,6 +740,25 @@ string Create::execute() {
     return  create.dump();
 }
 
+Delete::Delete(Operator *input, ASTNode *ast, bool detach) : input(input), ast(ast), detach(detach) {}
+
+string Delete::execute() {
+    json deleteOperator;
+    if (input != nullptr) {
+        deleteOperator["NextOperator"] = input->execute();
+    }
+    deleteOperator["Operator"] = "Delete";
+    vector<string> variables;
+    for (auto* e : ast->elements) {
+        if (e->nodeType == Const::VARIABLE) {
+            variables.push_back(e->value);
+        }
+    }
+    deleteOperator["variables"] = variables;
+    deleteOperator["detach"] = detach;
+    return deleteOperator.dump();
+}
+
 CartesianProduct::CartesianProduct(Operator* left, Operator* right) : left(left), right(right) {}
 
 string CartesianProduct::execute() {
@@ -66,6 +66,49 @@ class NodeByIdSeek : public Operator {
     string var;
 };
 
+// NodeIndexSeek Operator, nodes whose property equals a value, found with a property index
+class NodeIndexSeek : public Operator {
+ public:
+    NodeIndexSeek(string property, string value, vector<string> labels, string var);
+    string execute() override;
+
+ private:
+    string property;
+    string value;
+    vector<string> labels;
+    string var;
+};
+
+// NodeIndexRangeScan Operator, nodes whose property is within a range, found with a range property index
+class NodeIndexRangeScan : public Operator {
+ public:
+    NodeIndexRangeScan(string property, vector<string> labels, string var);
+    void setLowerBound(string value, bool inclusive);
+    void setUpperBound(string value, bool inclusive);
+    string execute() override;
+
+ private:
+    string property;
+    vector<string> labels;
+    string var;
+    string lower;  // Empty when the range has no lower bound
+    bool lowerInclusive = true;
+    string upper;  // Empty when the range has no upper bound
+    bool upperInclusive = true;
+};
+
+// CreateIndex Operator, CREATE INDEX FOR (n:Label) ON (n.property)
+class CreateIndex : public Operator {
+ public:
+    CreateIndex(string property, string indexType, string label);
+    string execute() override;
+
+ private:
+    string property;
+    string indexType;
+    string label;
+};
+
 // AllNodeScan Operator
 class AllNodeScan : public Operator {
  public:
@@ -294,6 +337,19 @@ class Create : public Operator {
     ASTNode* ast;
 };
 
+// Delete the nodes and relationships bound to variables of the rows of its input, DETACH DELETE also deletes the
+// relationships of deleted nodes
+class Delete : public Operator {
+ public:
+    Delete(Operator* input, ASTNode* ast, bool detach);
+    string execute() override;
+
+ private:
+    Operator* input;
+    ASTNode* ast;
+    bool detach;
+};
+
 class CartesianProduct : public Operator {
  public:
     // Constructor
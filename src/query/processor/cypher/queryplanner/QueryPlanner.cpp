@@ -13,11 +13,17 @@ limitations under the License.
 
 // QueryPlanner.cpp
 #include "QueryPlanner.h"
+#include <map>
+#include <regex>
+#include <tuple>
+#include <nlohmann/json.hpp>
 #include "../util/Const.h"
 #include "../astbuilder/ASTLeafValue.h"
 #include "../astbuilder/ASTInternalNode.h"
 #include "../astbuilder/ASTNode.h"
 
+using json = nlohmann::json;
+
 Operator* QueryPlanner::createExecutionPlan(ASTNode* ast, Operator* op, string var) {
     Operator* currentOperator = op;
     // Example: Create a simple execution plan based on the AST
@@ -57,6 +63,9 @@ Operator* QueryPlanner::createExecutionPlan(ASTNode* ast, Operator* op, string v
                 }
             }
         }
+        if (!currentOperator) {
+            currentOperator = indexScanPlan(ast);
+        }
 
         for (int i = 0; i< ast->elements.size(); i++) {
             currentOperator = createExecutionPlan(ast->elements[i], currentOperator);
@@ -85,9 +94,9 @@ Operator* QueryPlanner::createExecutionPlan(ASTNode* ast, Operator* op, string v
     } else if (ast->nodeType == Const::SET_EUAL) {
         // TODO(thamindumk): Implement SET_EUAL
     } else if (ast->nodeType == Const::DELETE) {
-        // TODO(thamindumk): Implement DELETE
+        return new Delete(currentOperator, ast, false);
     } else if (ast->nodeType == Const::DETACH) {
-        // TODO(thamindumk): Implement DETACH
+        return new Delete(currentOperator, ast->elements[0], true);
     } else if (ast->nodeType == Const::REMOVE_LIST) {
         // TODO(thamindumk): Implement REMOVE_LIST
     } else if (ast->nodeType == Const::REMOVE) {
@@ -1481,3 +1490,186 @@ Operator* QueryPlanner::pathPatternHandler(ASTNode *pattern, Operator* inputOper
     }
     return inputOperator;
 }
+
+/**
+ * Value of a string or integer literal, false for other expressions
+ * */
+static bool literalValue(ASTNode *ast, string &value) {
+    if (ast->nodeType == Const::DECIMAL) {
+        value = ast->value;
+        return true;
+    }
+    if (ast->nodeType == Const::STRING && ast->value.size() >= 2) {
+        value = ast->value.substr(1, ast->value.size() - 2);  // Remove the quotes
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Property name of a lookup of the variable's property, false for other expressions
+ * */
+static bool propertyOf(ASTNode *ast, const string &variable, string &property) {
+    if (ast->nodeType != Const::NON_ARITHMETIC_OPERATOR || ast->elements.size() != 2 ||
+        ast->elements[0]->nodeType != Const::VARIABLE || ast->elements[0]->value != variable ||
+        ast->elements[1]->nodeType != Const::PROPERTY_LOOKUP) {
+        return false;
+    }
+    property = ast->elements[1]->elements[0]->value;
+    return true;
+}
+
+static void collectConjuncts(ASTNode *ast, vector<ASTNode *> &comparisons) {
+    if (ast->nodeType == Const::AND) {
+        for (auto *element : ast->elements) {
+            collectConjuncts(element, comparisons);
+        }
+    } else if (ast->nodeType == Const::COMPARISON && ast->elements.size() == 2) {
+        comparisons.push_back(ast);
+    }
+}
+
+/**
+ * Plan a property index lookup for MATCH (n:Label {p: v}) and MATCH (n:Label) WHERE n.p = v / n.p > v ... over a
+ * single node pattern. Equality predicates become a NodeIndexSeek, integer bounds on one property a
+ * NodeIndexRangeScan. Partitions without an index of the property fall back to a scan, and the predicates are still
+ * checked by the Filter over the lookup. Returns nullptr if no predicate can use an index.
+ * */
+Operator* QueryPlanner::indexScanPlan(ASTNode *match) {
+    ASTNode *pattern = match->elements[0];
+    if (pattern->nodeType != Const::PATTERN || pattern->elements.size() != 1 ||
+        pattern->elements[0]->nodeType != Const::NODE_PATTERN) {
+        return nullptr;
+    }
+    ASTNode *node = pattern->elements[0];
+    if (node->elements.empty() || node->elements[0]->nodeType != Const::VARIABLE) {
+        return nullptr;
+    }
+    string variable = node->elements[0]->value;
+    vector<string> labels;
+    vector<pair<string, string>> equalities;  // (property, value)
+    for (auto *element : node->elements) {
+        if (element->nodeType == Const::NODE_LABEL) {
+            labels.push_back(element->elements[0]->value);
+        } else if (element->nodeType == Const::NODE_LABELS) {
+            return nullptr;  // Labels of (n:A:B) are matched by a label filter over the scan
+        } else if (element->nodeType == Const::PROPERTIES_MAP) {
+            for (auto *prop : element->elements) {
+                string value;
+                if (prop->elements[0]->nodeType != Const::RESERVED_WORD && literalValue(prop->elements[1], value)) {
+                    equalities.push_back({prop->elements[0]->value, value});
+                }
+            }
+        }
+    }
+
+    vector<ASTNode *> comparisons;
+    ASTNode *where = match->elements.back();
+    if (where->nodeType == Const::WHERE) {
+        collectConjuncts(where->elements[0], comparisons);
+    }
+    // (property, operator, integer value) of the range predicates, with the property on the left
+    vector<tuple<string, string, string>> bounds;
+    for (auto *comparison : comparisons) {
+        string op = comparison->elements[1]->nodeType;
+        ASTNode *left = comparison->elements[0];
+        ASTNode *right = comparison->elements[1]->elements[0];
+        string property;
+        string value;
+        ASTNode *literal = right;
+        if (!propertyOf(left, variable, property) || !literalValue(right, value)) {
+            if (!propertyOf(right, variable, property) || !literalValue(left, value)) {
+                continue;
+            }
+            // 5 < n.age is n.age > 5
+            map<string, string> mirrored = {{Const::GREATER_THAN, Const::LOWER_THAN},
+                                            {Const::LOWER_THAN, Const::GREATER_THAN},
+                                            {Const::GREATER_THAN_OR_EQUAL, Const::LOWER_THAN_OR_EQUAL},
+                                            {Const::LOWER_THAN_OR_EQUAL, Const::GREATER_THAN_OR_EQUAL}};
+            if (mirrored.count(op)) {
+                op = mirrored[op];
+            }
+            literal = left;
+        }
+        if (op == Const::DOUBLE_EQUAL) {
+            equalities.push_back({property, value});
+        } else if (op != Const::GREATER_THAN_LOWER_THAN && literal->nodeType == Const::DECIMAL) {
+            bounds.push_back(make_tuple(property, op, value));
+        }
+    }
+
+    if (!equalities.empty()) {
+        return new NodeIndexSeek(equalities[0].first, equalities[0].second, labels, variable);
+    }
+    if (bounds.empty()) {
+        return nullptr;
+    }
+    string property = get<0>(bounds[0]);
+    auto *rangeScan = new NodeIndexRangeScan(property, labels, variable);
+    for (auto &bound : bounds) {
+        if (get<0>(bound) != property) {
+            continue;  // Checked by the Filter
+        }
+        string op = get<1>(bound);
+        if (op == Const::GREATER_THAN || op == Const::GREATER_THAN_OR_EQUAL) {
+            rangeScan->setLowerBound(get<2>(bound), op == Const::GREATER_THAN_OR_EQUAL);
+        } else {
+            rangeScan->setUpperBound(get<2>(bound), op == Const::LOWER_THAN_OR_EQUAL);
+        }
+    }
+    return rangeScan;
+}
+
+/**
+ * CREATE [HASH | RANGE] INDEX [name] [IF NOT EXISTS] FOR (n[:Label]) ON (n.property) is not part of the openCypher
+ * grammar, so it is recognized before the query is parsed. RANGE is the default index type.
+ * */
+Operator* QueryPlanner::createIndexPlan(const string &query) {
+    static const regex createIndex(
+        "^\\s*CREATE\\s+(?:(HASH|RANGE)\\s+)?INDEX(?:\\s+(?!FOR\\b)\\w+)?(?:\\s+IF\\s+NOT\\s+EXISTS)?\\s+FOR\\s*"
+        "\\(\\s*(\\w+)\\s*(?::\\s*(\\w+))?\\s*\\)\\s*ON\\s*\\(\\s*(\\w+)\\s*\\.\\s*(\\w+)\\s*\\)\\s*;?\\s*$",
+        regex::icase);
+    smatch match;
+    if (!regex_match(query, match, createIndex) || match[2] != match[4]) {
+        return nullptr;
+    }
+    string type = match[1].matched ? match[1].str() : "RANGE";
+    transform(type.begin(), type.end(), type.begin(), ::toupper);
+    return new CreateIndex(match[5], type, match[3]);
+}
+
+/**
+ * Query options follow the Neo4j form CYPHER option=value [option=value ...] in front of the query, which the
+ * openCypher grammar does not cover. Option names are case insensitive.
+ * */
+map<string, string> QueryPlanner::extractQueryOptions(string &query) {
+    static const regex prefix("^\\s*CYPHER((?:\\s+\\w+\\s*=\\s*\\w+)+)\\s+", regex::icase);
+    static const regex option("(\\w+)\\s*=\\s*(\\w+)");
+    map<string, string> options;
+    smatch match;
+    if (!regex_search(query, match, prefix)) {
+        return options;
+    }
+    string list = match[1];
+    for (sregex_iterator it(list.begin(), list.end(), option), end; it != end; ++it) {
+        string name = (*it)[1];
+        transform(name.begin(), name.end(), name.begin(), ::tolower);
+        options[name] = (*it)[2];
+    }
+    query = match.suffix();
+    return options;
+}
+
+string QueryPlanner::applyQueryOptions(const string &plan, const map<string, string> &options) {
+    auto parallelism = options.find("parallelism");
+    if (plan.empty() || parallelism == options.end()) {
+        return plan;
+    }
+    int threads = atoi(parallelism->second.c_str());
+    if (threads <= 0) {  // The workers' configured parallelism is used
+        return plan;
+    }
+    json root = json::parse(plan);
+    root["parallelism"] = threads;
+    return root.dump();
+}
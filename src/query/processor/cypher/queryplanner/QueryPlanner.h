@@ -18,6 +18,7 @@ limitations under the License.
 #include "../astbuilder/ASTNode.h"
 #include "Operators.h"  // Include all operators
 #include <algorithm>
+#include <map>
 class QueryPlanner {
  public:
     QueryPlanner() = default;
@@ -31,6 +32,13 @@ class QueryPlanner {
     pair<vector<bool>, vector<ASTNode*>> getNodeDetails(ASTNode* node);
     Operator* pathPatternHandler(ASTNode* pattern, Operator* opr);
     ASTNode* prepareWhereClause(string var1, string var2);
+    Operator* indexScanPlan(ASTNode* match);
+    // Plan of a CREATE INDEX statement, nullptr if the query is not one
+    static Operator* createIndexPlan(const string& query);
+    // Runtime options given before the query as in CYPHER parallelism=4 MATCH ..., the prefix is removed from the query
+    static map<string, string> extractQueryOptions(string& query);
+    // Plan with the options the workers use (parallelism of node and relationship scans) added to its root operator
+    static string applyQueryOptions(const string& plan, const map<string, string>& options);
 };
 
 #endif  // QUERY_PLANNER_H
@@ -14,288 +14,236 @@ limitations under the License.
 #include "Helpers.h"
 
 
-FilterHelper::FilterHelper(string condition) : condition(condition) {};
+FilterHelper::FilterHelper(const json &condition, RowSchema::Ptr schema) : root(compile(condition, *schema)) {}
 
-bool FilterHelper::evaluate(std::string data) {
-    return evaluateCondition(condition, data);
+bool FilterHelper::evaluate(const RowBatch &batch, size_t row) const {
+    return evaluate(this->root, batch, row);
 }
 
-bool FilterHelper::evaluateCondition(std::string condition, std::string data) {
-    json predicate = json::parse(condition);
-    std::string type = predicate["type"];
+FilterHelper::Predicate FilterHelper::compile(const json &condition, const RowSchema &schema) {
+    Predicate predicate;
+    std::string type = condition["type"];
     if (type == "COMPARISON") {
-        return evaluateComparison(condition, data);
+        return compileComparison(condition, schema, false);
     } else if (type == "PREDICATE_EXPRESSIONS") {
-        return evaluatePredicateExpression(condition, data);
+        return compileComparison(condition, schema, true);
     } else if (type == "AND" || type == "OR" || type == "XOR" || type == "NOT") {
-        return evaluateLogical(condition, data);
+        predicate.kind = type == "AND"   ? Predicate::Kind::AND
+                         : type == "OR"  ? Predicate::Kind::OR
+                         : type == "XOR" ? Predicate::Kind::XOR
+                                         : Predicate::Kind::NOT;
+        for (const auto &comparison : condition["comparisons"]) {
+            predicate.children.push_back(compile(comparison, schema));
+        }
+        // XOR of less than two conditions and NOT without a condition are false
+        if ((predicate.kind == Predicate::Kind::XOR && predicate.children.size() < 2) ||
+            (predicate.kind == Predicate::Kind::NOT && predicate.children.empty())) {
+            predicate.kind = Predicate::Kind::NEVER;
+        }
     }
-
-    return false;
+    return predicate;
 }
 
-bool FilterHelper::evaluateComparison(std::string condition, std::string raw) {
-    json predicate = json::parse(condition);
-    json data = json::parse(raw);
-    if (!typeCheck(predicate["left"]["type"], predicate["right"]["type"])) {
-        return false;
+/**
+ * Comparison of two operands. The right operand of a predicate expression (IS NULL, IS NOT NULL) is always a constant.
+ * */
+FilterHelper::Predicate FilterHelper::compileComparison(const json &condition, const RowSchema &schema,
+                                                        bool constantRight) {
+    Predicate predicate;
+    std::string leftType = condition["left"]["type"];
+    std::string rightType = condition["right"]["type"];
+    if (!typeCheck(leftType, rightType)) {
+        return predicate;
     }
 
-    ValueType leftValue;
-    ValueType rightValue;
-
-    if (predicate["left"]["type"] == "VARIABLE" && predicate["right"]["type"] == "VARIABLE") {
-        string left = predicate["left"]["value"];
-        string right = predicate["right"]["value"];
-        return evaluateNodes(data[left].dump(),
-                             data[right].dump());
+    if (leftType == "VARIABLE" && rightType == "VARIABLE") {
+        predicate.kind = Predicate::Kind::DISTINCT_NODES;
+        predicate.left.slot = schema.slot(condition["left"]["value"]);
+        predicate.right.slot = schema.slot(condition["right"]["value"]);
+        return predicate;
     }
 
-    if (predicate["left"]["type"] == "PROPERTY_LOOKUP") {
-        std::string variable = predicate["left"]["variable"];
-        leftValue = evaluatePropertyLookup(predicate["left"].dump(),
-                                           data[variable].dump(), predicate["right"]["type"]);
-    } else if (predicate["left"]["type"] == Const::FUNCTION) {
-        leftValue = evaluateFunction(predicate["left"].dump(),
-                                     data.dump(), predicate["right"]["type"]);
-    } else {
-        //  only evaluating string, decimal, boolean, null for now
-        leftValue = evaluateOtherTypes(predicate["left"].dump());
+    predicate.kind = Predicate::Kind::COMPARISON;
+    predicate.left = compileOperand(condition["left"], rightType, false, schema);
+    predicate.right = compileOperand(condition["right"], leftType, constantRight, schema);
+    std::string op = condition["operator"];
+    if (op == "==") {
+        predicate.comparator = Comparator::EQUAL;
+    } else if (op == "<>") {
+        predicate.comparator = Comparator::NOT_EQUAL;
+    } else if (op == "<") {
+        predicate.comparator = Comparator::LOWER;
+    } else if (op == ">") {
+        predicate.comparator = Comparator::GREATER;
+    } else if (op == "<=") {
+        predicate.comparator = Comparator::LOWER_OR_EQUAL;
+    } else if (op == ">=") {
+        predicate.comparator = Comparator::GREATER_OR_EQUAL;
     }
+    return predicate;
+}
 
-    if (predicate["right"]["type"] == "PROPERTY_LOOKUP") {
-        std::string variable = predicate["right"]["variable"];
-        rightValue = evaluatePropertyLookup(predicate["right"].dump(),
-                                            data[variable].dump(), predicate["left"]["type"]);
-
-    } else if (predicate["right"]["type"] == Const::FUNCTION) {
-        rightValue = evaluateFunction(predicate["right"].dump(),
-                                      data.dump(), predicate["left"]["type"]);
-    } else {
-        //  only evaluating string, decimal, boolean, null for now
-        rightValue = evaluateOtherTypes(predicate["right"].dump());
+FilterHelper::Operand FilterHelper::compileOperand(const json &operand, const std::string &otherType, bool constant,
+                                                   const RowSchema &schema) {
+    Operand compiled;
+    std::string type = operand["type"];
+    if (!constant && (type == "PROPERTY_LOOKUP" || type == Const::FUNCTION)) {
+        if (type == "PROPERTY_LOOKUP") {
+            compiled.kind = Operand::Kind::PROPERTY;
+            compiled.slot = schema.slot(operand["variable"]);
+            // should be implemented to lookup nested properties after persisting that kind of properties
+            // for now only one level of properties are supported (size of properties vector should be 1)
+            vector<string> properties = operand["property"];
+            compiled.name = properties.empty() ? "" : properties.back();
+        } else {
+            compiled.kind = Operand::Kind::FUNCTION;
+            vector<string> args = operand["arguments"];
+            compiled.slot = args.empty() ? -1 : schema.slot(args[0]);
+            compiled.name = operand["functionName"];
+        }
+        if (otherType == "DECIMAL") {
+            compiled.conversion = Conversion::INTEGER;
+        } else if (otherType == "BOOLEAN") {
+            compiled.conversion = Conversion::BOOLEAN;
+        } else if (otherType == "NULL" && compiled.kind == Operand::Kind::FUNCTION) {
+            compiled.conversion = Conversion::NULL_VALUE;
+        }
+        return compiled;
     }
-    string op = predicate["operator"];
-
-    return std::visit([&op](auto&& lhs, auto&& rhs) -> bool {
-        using LType = std::decay_t<decltype(lhs)>;
-        using RType = std::decay_t<decltype(rhs)>;
+    //  only evaluating string, decimal, boolean, null for now
+    compiled.constant = evaluateOtherTypes(operand);
+    return compiled;
+}
 
-        if constexpr (std::is_same_v<LType, RType>) {
-            if (op == "==") return lhs == rhs;
-            if (op == "<>") return lhs != rhs;
-            if constexpr (std::is_arithmetic_v<LType>) {
-                if (op == "<") return lhs < rhs;
-                if (op == ">") return lhs > rhs;
-                if (op == "<=") return lhs <= rhs;
-                if (op == ">=") return lhs >= rhs;
+bool FilterHelper::evaluate(const Predicate &predicate, const RowBatch &batch, size_t row) {
+    switch (predicate.kind) {
+        case Predicate::Kind::AND:
+            for (const auto &child : predicate.children) {
+                if (!evaluate(child, batch, row)) {
+                    return false;
+                }
             }
+            return true;
+        case Predicate::Kind::OR:
+            for (const auto &child : predicate.children) {
+                if (evaluate(child, batch, row)) {
+                    return true;
+                }
+            }
+            return false;
+        case Predicate::Kind::XOR: {
+            bool result = false;
+            for (const auto &child : predicate.children) {
+                result = result ^ evaluate(child, batch, row);
+            }
+            return result;
         }
-        return false;  // Default if types are incompatible
-    }, leftValue, rightValue);
-    return false;
-}
-
-bool FilterHelper::evaluatePredicateExpression(std::string condition, std::string raw) {
-    json predicate = json::parse(condition);
-    json data = json::parse(raw);
-    if (!typeCheck(predicate["left"]["type"], predicate["right"]["type"])) {
-        return false;
-    }
-
-    ValueType leftValue;
-    ValueType rightValue;
-
-    if (predicate["left"]["type"] == "VARIABLE" && predicate["right"]["type"] == "VARIABLE") {
-        string left = predicate["left"]["value"];
-        string right = predicate["right"]["value"];
-        return evaluateNodes(data[left].dump(),
-                             data[right].dump());
-    }
-
-    if (predicate["left"]["type"] == "PROPERTY_LOOKUP") {
-        std::string variable = predicate["left"]["variable"];
-        leftValue = evaluatePropertyLookup(predicate["left"].dump(),
-                                           data[variable].dump(), predicate["right"]["type"]);
-    } else if (predicate["left"]["type"] == Const::FUNCTION) {
-        leftValue = evaluateFunction(predicate["left"].dump(),
-                                     data.dump(), predicate["right"]["type"]);
-    } else {
-        // only evaluating string, decimal, boolean, null for now
-        leftValue = evaluateOtherTypes(predicate["left"].dump());
+        case Predicate::Kind::NOT:
+            return evaluate(predicate.children[0], batch, row);
+        case Predicate::Kind::DISTINCT_NODES: {
+            static const RowValue unbound;
+            return evaluateNodes(predicate.left.slot < 0 ? unbound : batch.get(row, predicate.left.slot),
+                                 predicate.right.slot < 0 ? unbound : batch.get(row, predicate.right.slot));
+        }
+        case Predicate::Kind::COMPARISON:
+            break;
+        default:
+            return false;
     }
-    rightValue = evaluateOtherTypes(predicate["right"].dump());
-
-    string op = predicate["operator"];
 
-    return std::visit([&op](auto&& lhs, auto&& rhs) -> bool {
+    ValueType leftValue = evaluateOperand(predicate.left, batch, row);
+    ValueType rightValue = evaluateOperand(predicate.right, batch, row);
+    Comparator op = predicate.comparator;
+    return std::visit([op](auto&& lhs, auto&& rhs) -> bool {
         using LType = std::decay_t<decltype(lhs)>;
         using RType = std::decay_t<decltype(rhs)>;
 
         if constexpr (std::is_same_v<LType, RType>) {
-            if (op == "==") return lhs == rhs;
-            if (op == "<>") return lhs != rhs;
+            if (op == Comparator::EQUAL) return lhs == rhs;
+            if (op == Comparator::NOT_EQUAL) return lhs != rhs;
             if constexpr (std::is_arithmetic_v<LType>) {
-                if (op == "<") return lhs < rhs;
-                if (op == ">") return lhs > rhs;
-                if (op == "<=") return lhs <= rhs;
-                if (op == ">=") return lhs >= rhs;
+                if (op == Comparator::LOWER) return lhs < rhs;
+                if (op == Comparator::GREATER) return lhs > rhs;
+                if (op == Comparator::LOWER_OR_EQUAL) return lhs <= rhs;
+                if (op == Comparator::GREATER_OR_EQUAL) return lhs >= rhs;
             }
         }
-
         return false;  // Default if types are incompatible
     }, leftValue, rightValue);
-    return false;
 }
 
-bool FilterHelper::evaluateLogical(std::string condition, std::string data) {
-    json predicate = json::parse(condition);
-    std::string type = predicate["type"];
-    vector<json> comparisons = predicate["comparisons"];
-
-    if (type == "AND") {
-        for (auto comp : comparisons) {
-            if (!evaluateCondition(comp.dump(), data)) {
-                return false;
-            }
-        }
-        return true;
-    } else if (type == "OR") {
-        for (auto comp : comparisons) {
-            if (evaluateCondition(comp.dump(), data)) {
-                return true;
-            }
-        }
-        return false;
-    } else if (type == "XOR") {
-        if (comparisons.size() < 2) {
-            return false;
-        }
-        bool result = evaluateCondition(comparisons[0].dump(),
-                                        data) ^ evaluateCondition(comparisons[1].dump(), data);
-
-        for (size_t i = 2; i < comparisons.size(); ++i) {
-            result = result ^ evaluateCondition(comparisons[i].dump(), data);
-        }
-        return result;
-    } else if (type == "NOT") {
-        return evaluateCondition(comparisons[0].dump(), data);
-    }
-
-    return false;
-}
-
-bool FilterHelper::evaluateNodes(std::string left, std::string right) {
-    json leftNode = json::parse(left);
-    json rightNode = json::parse(right);
-    if (left == "null" || right == "null") {
+/**
+ * Two node variables of a pattern match different nodes, true if either is unbound
+ * */
+bool FilterHelper::evaluateNodes(const RowValue &left, const RowValue &right) {
+    if (left.index() == 0 || right.index() == 0) {
         return true;
     }
-
-    if (leftNode["id"] != rightNode["id"]) {
-        return true;
+    auto leftNode = RowBatch::entity(left);
+    auto rightNode = RowBatch::entity(right);
+    const std::string *leftId = leftNode ? leftNode->property("id") : NULL;
+    const std::string *rightId = rightNode ? rightNode->property("id") : NULL;
+    if (leftId && rightId) {
+        return *leftId != *rightId;
     }
-    return false;
+    return leftId != rightId;
 }
 
-bool FilterHelper::typeCheck(std::string left, std::string right) {
-    if (left == Const::PROPERTY_LOOKUP
-        || right == Const::PROPERTY_LOOKUP
-        || left == Const::FUNCTION
-        || right == Const::FUNCTION) {
-        return true;
-    } else if (left == right) {
-        return true;
-    } else {
-        return false;
+ValueType FilterHelper::evaluateOperand(const Operand &operand, const RowBatch &batch, size_t row) {
+    if (operand.kind == Operand::Kind::CONSTANT) {
+        return operand.constant;
     }
-}
-
-ValueType FilterHelper::evaluatePropertyLookup(std::string property, std::string data, string type) {
-    json prop = json::parse(property);
-    json raw = json::parse(data);
-    vector<string> properties = prop["property"];
-    string value;
-    // should be implemented to lookup nested properties after persisting that kind of properties
-    // for now only one level of properties are supported (size of properties vector should be 1)
-    for (auto p : properties) {
-        if (!raw.contains(p)) {
-            value = "null";
-        } else {
-            value = raw[p];
-        }
+    auto entity = operand.slot < 0 ? nullptr : RowBatch::entity(batch.get(row, operand.slot));
+    if (operand.kind == Operand::Kind::PROPERTY) {
+        const std::string *value = entity ? entity->property(operand.name) : NULL;
+        return convert(value ? *value : "null", operand.conversion);
     }
+    const std::string *value = entity && operand.name == "id" ? entity->property("id") : NULL;
+    return convert(value ? *value : "", operand.conversion);
+}
 
+ValueType FilterHelper::convert(const std::string &value, Conversion conversion) {
     try {
-        if (type == "STRING") {
-            return value;
-        } else if (type == "DECIMAL") {
+        if (conversion == Conversion::INTEGER) {
             size_t pos;
             int num = stoi(value, &pos);
             if (pos != value.size()) throw invalid_argument("Invalid number format");
             return num;
-        } else if (type == "BOOLEAN") {
+        } else if (conversion == Conversion::BOOLEAN) {
             string lowerValue;
             std::transform(value.begin(), value.end(), back_inserter(lowerValue), ::tolower);
             if (lowerValue == "true") return true;
             if (lowerValue == "false") return false;
             throw invalid_argument("Invalid boolean format");
-        } else if (type == "NULL") {
-            if (value == "null") return "null";
-            return value;
-        } else if ("PROPERTY_LOOKUP") {
-            return value;
+        } else if (conversion == Conversion::NULL_VALUE) {
+            return "null";
         }
+        return value;
     } catch (const exception& e) {
         return "null";
     }
-    return "null";
 }
 
-ValueType FilterHelper::evaluateFunction(std::string function, std::string data, std::string type) {
-    json func = json::parse(function);
-    json raw = json::parse(data);
-    vector<string> args = func["arguments"];
-    string arg = args[0];
-    string value;
-
-    if (func["functionName"] == "id") {
-        value = raw[arg]["id"];
-    }
-
-    try {
-        if (type == "STRING") {
-            return value;
-        } else if (type == "DECIMAL") {
-            size_t pos;
-            int num = stoi(value, &pos);
-            if (pos != value.size()) throw invalid_argument("Invalid number format");
-            return num;
-        } else if (type == "BOOLEAN") {
-            string lowerValue;
-            std::transform(value.begin(), value.end(), back_inserter(lowerValue), ::tolower);
-            if (lowerValue == "true") return true;
-            if (lowerValue == "false") return false;
-            throw invalid_argument("Invalid boolean format");
-        } else if (type == "NULL") {
-            return "null";
-        } else if ("PROPERTY_LOOKUP") {
-            return value;
-        }
-    } catch (const exception& e) {
-        return "null";
+bool FilterHelper::typeCheck(std::string left, std::string right) {
+    if (left == Const::PROPERTY_LOOKUP
+        || right == Const::PROPERTY_LOOKUP
+        || left == Const::FUNCTION
+        || right == Const::FUNCTION) {
+        return true;
+    } else if (left == right) {
+        return true;
+    } else {
+        return false;
     }
-    return "null";
 }
 
-ValueType FilterHelper::evaluateOtherTypes(std::string data) {
-    json val = json::parse(data);
+ValueType FilterHelper::evaluateOtherTypes(const json &val) {
     if (val["type"] == "STRING") {
         string str = val["value"];
         if (str.size() >= 2 && str.front() == '\'' && str.back() == '\'') {
             return str.substr(1, str.size() - 2);  // Remove first and last character ' '
         }
-        return val["value"];
+        return str;
     } else if (val["type"] == "DECIMAL") {
         return stoi(val["value"].get<std::string>());
     } else if (val["type"] == "BOOLEAN") {
@@ -346,19 +294,22 @@ string ExpandAllHelper::generateSubQuery(std::string startVar, std::string destV
             + startVar + ") = " + id + " return " + relVar + "," + destVar;
 }
 
-void AverageAggregationHelper::insertData(std::string data) {
-    json rawObj = json::parse(data);
-    string value = rawObj[this->variable][this->property];
-    float property = stof(value);
+void AverageAggregationHelper::insertData(const RowValue &data) {
+    auto entity = RowBatch::entity(data);
+    const std::string *value = entity ? entity->property(this->property) : NULL;
+    if (!value) {
+        return;
+    }
+    float property = stof(*value);
     this->numberOfData++;
     this->localAverage = (this->localAverage * (this->numberOfData - 1) + property) / this->numberOfData;
 }
 
-string AverageAggregationHelper::getFinalResult() {
+json AverageAggregationHelper::getFinalResult() {
     json data;
     data["avg"] = this->localAverage;
     data["numberOfData"] = this->numberOfData;
-    return data.dump();
+    return data;
 }
 
 CreateHelper::CreateHelper(vector<json> elements, std::string partitionAlgo, GraphConfig gc, string masterIP) :
@@ -369,9 +320,7 @@ CreateHelper::CreateHelper(vector<json> elements, std::string partitionAlgo, Gra
                                              spt::getPartitioner(partitionAlgo), nullptr, true);
 };
 
-void CreateHelper::insertFromData(std::string data, SharedBuffer &buffer) {
-    json rawData = json::parse(data);
-    NodeManager nodeManager(this->gc);
+void CreateHelper::insertFromData(NodeManager &nodeManager, const json &rawData, std::vector<json> &rows) {
     for (json insert : this->elements) {
         if (insert["type"] == "Relationships") {
             for (json rel : insert["relationships"]) {
@@ -558,9 +507,16 @@ void CreateHelper::insertFromData(std::string data, SharedBuffer &buffer) {
 
                 for (auto it = edgeProps.begin(); it != edgeProps.end(); it++) {
                     strcpy(value, it.value().get<std::string>().c_str());
+                    bool isType = std::string(it.key()) == "type";
                     if (partitionedEdge[0].second == partitionedEdge[1].second) {
+                        if (isType) {
+                            newRelation->addLocalRelationshipType(it.value().get<std::string>());
+                        }
                         newRelation->addLocalProperty(std::string(it.key()), &value[0]);
                     } else {
+                        if (isType) {
+                            newRelation->addCentralRelationshipType(it.value().get<std::string>());
+                        }
                         newRelation->addCentralProperty(std::string(it.key()), &value[0]);
                     }
                 }
@@ -602,7 +558,7 @@ void CreateHelper::insertFromData(std::string data, SharedBuffer &buffer) {
                     string variable = relation["variable"];
                     rawObj[variable] = edgeProps;
                 }
-                buffer.add(rawObj.dump());
+                rows.push_back(rawObj);
             }
         } else if (insert["type"] == "Node") {
             auto rawObj = rawData;
@@ -655,15 +611,14 @@ void CreateHelper::insertFromData(std::string data, SharedBuffer &buffer) {
                     rawObj[variable] = sourceProps;
                 }
 
-                buffer.add(rawObj.dump());
+                rows.push_back(rawObj);
             }
             return;
         }
     }
 }
 
-void CreateHelper::insertWithoutData(SharedBuffer &buffer) {
-    NodeManager nodeManager(this->gc);
+void CreateHelper::insertWithoutData(NodeManager &nodeManager, std::vector<json> &rows) {
     for (json insert : this->elements) {
         if (insert["type"] == "Relationships") {
             for (json rel : insert["relationships"]) {
@@ -713,9 +668,16 @@ void CreateHelper::insertWithoutData(SharedBuffer &buffer) {
 
                 for (auto it = edgeProps.begin(); it != edgeProps.end(); it++) {
                     strcpy(value, it.value().get<std::string>().c_str());
+                    bool isType = std::string(it.key()) == "type";
                     if (partitionedEdge[0].second == partitionedEdge[1].second) {
+                        if (isType) {
+                            newRelation->addLocalRelationshipType(it.value().get<std::string>());
+                        }
                         newRelation->addLocalProperty(std::string(it.key()), &value[0]);
                     } else {
+                        if (isType) {
+                            newRelation->addCentralRelationshipType(it.value().get<std::string>());
+                        }
                         newRelation->addCentralProperty(std::string(it.key()), &value[0]);
                     }
                 }
@@ -758,7 +720,7 @@ void CreateHelper::insertWithoutData(SharedBuffer &buffer) {
                     rawObj[variable] = edgeProps;
                 }
 
-                buffer.add(rawObj.dump());
+                rows.push_back(rawObj);
             }
         } else if (insert["type"] == "Node") {
             json rawObj;
@@ -792,7 +754,7 @@ void CreateHelper::insertWithoutData(SharedBuffer &buffer) {
                     string variable = insert["variable"];
                     rawObj[variable] = insert["properties"];
                 }
-                buffer.add(rawObj.dump());
+                rows.push_back(rawObj);
             }
             return;
         }
@@ -33,27 +33,56 @@ limitations under the License.
 #include "../../../../nativestore/RelationBlock.h"
 #include "../../../../partitioner/stream/Partitioner.h"
 #include "../../../../util/Utils.h"
+#include "../util/RowBatch.h"
 
 using namespace std;
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 using ValueType = std::variant<std::string, int, bool>;
 
+/**
+ * WHERE condition of a Filter, compiled once per query into a tree of predicates over the row slots of the Filter's
+ * input. Constants are parsed and variables resolved to slots when the tree is built, evaluating a row only reads its
+ * values.
+ * */
 class FilterHelper {
  public:
-    FilterHelper(string condition);
-    bool evaluate(string data);
+    FilterHelper(const json &condition, RowSchema::Ptr schema);
+    bool evaluate(const RowBatch &batch, size_t row) const;
+
  private:
-    string condition;
-    static bool evaluateCondition(string condition, string data);
-    static bool evaluateComparison(string condition, string raw);
-    static bool evaluatePredicateExpression(string condition, string raw);
-    static bool evaluateLogical(string condition, string data);
-    static bool evaluateNodes(string left, string right);
-    static ValueType evaluateFunction(string function, string data, string type);
-    static ValueType evaluatePropertyLookup(string property, string data, string type);
+    // How the string value of a property or function is converted, decided by the type of the other operand
+    enum class Conversion { STRING, INTEGER, BOOLEAN, NULL_VALUE };
+    enum class Comparator { EQUAL, NOT_EQUAL, LOWER, GREATER, LOWER_OR_EQUAL, GREATER_OR_EQUAL, NONE };
+
+    struct Operand {
+        enum class Kind { CONSTANT, PROPERTY, FUNCTION } kind = Kind::CONSTANT;
+        ValueType constant;
+        int slot = -1;
+        std::string name;  // Property of a lookup or name of a function
+        Conversion conversion = Conversion::STRING;
+    };
+
+    struct Predicate {
+        enum class Kind { NEVER, COMPARISON, DISTINCT_NODES, AND, OR, XOR, NOT } kind = Kind::NEVER;
+        Comparator comparator = Comparator::NONE;
+        Operand left;
+        Operand right;
+        std::vector<Predicate> children;
+    };
+
+    Predicate root;
+
+    static Predicate compile(const json &condition, const RowSchema &schema);
+    static Predicate compileComparison(const json &condition, const RowSchema &schema, bool constantRight);
+    static Operand compileOperand(const json &operand, const std::string &otherType, bool constant,
+                                  const RowSchema &schema);
+    static bool evaluate(const Predicate &predicate, const RowBatch &batch, size_t row);
+    static bool evaluateNodes(const RowValue &left, const RowValue &right);
+    static ValueType evaluateOperand(const Operand &operand, const RowBatch &batch, size_t row);
+    static ValueType convert(const std::string &value, Conversion conversion);
     static bool typeCheck(string left, string right);
-    static ValueType evaluateOtherTypes(string data);
+    static ValueType evaluateOtherTypes(const json &val);
 };
 
 class ExpandAllHelper {
@@ -66,8 +95,9 @@ class ExpandAllHelper {
 class AverageAggregationHelper {
  public:
     AverageAggregationHelper(string variable, string property): variable(variable), property(property){};
-    void insertData(string data);
-    string getFinalResult();
+    // Add the property of the entity bound to the variable, rows without the property are not counted
+    void insertData(const RowValue &data);
+    json getFinalResult();
  private:
     string variable;
     string property;
@@ -78,8 +108,10 @@ class AverageAggregationHelper {
 class CreateHelper {
  public:
     CreateHelper(vector<json> elements, std::string partitionAlgo, GraphConfig gc, string masterIP);
-    void insertFromData(string data, SharedBuffer &buffer);
-    void insertWithoutData(SharedBuffer &buffer);
+    // Rows of the input row with the created nodes and relationships bound are added to rows. The node manager is the
+    // one of the operator pipeline, the native store can only be opened once per thread.
+    void insertFromData(NodeManager &nodeManager, const json &rawData, std::vector<json> &rows);
+    void insertWithoutData(NodeManager &nodeManager, std::vector<json> &rows);
 
  private:
     GraphConfig gc;
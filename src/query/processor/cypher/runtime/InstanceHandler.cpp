@@ -25,27 +25,27 @@ void InstanceHandler::handleRequest(int connFd, bool *loop_exit_p,
                                     std::string queryJson) {
     OperatorExecutor operatorExecutor(gc, queryJson, masterIP);
     operatorExecutor.initializeMethodMap();
-    SharedBuffer sharedBuffer(operatorExecutor.INTER_OPERATOR_BUFFER_SIZE);
-    auto method = OperatorExecutor::methodMap[operatorExecutor.query["Operator"]];
-    // Launch the method in a new thread
-    std::thread result(method, std::ref(operatorExecutor), std::ref(sharedBuffer),
-                       std::string(operatorExecutor.queryPlan), gc);
+    BatchBuffer sharedBuffer(operatorExecutor.INTER_OPERATOR_BUFFER_SIZE);
+    // The operator pipeline runs as one task of the shared pool, this thread sends its rows to the master
+    auto pipeline = TaskPool::getInstance().submit([&operatorExecutor, &sharedBuffer]() {
+        operatorExecutor.execute(sharedBuffer);
+    });
     auto startTime = std::chrono::high_resolution_clock::now();
     int time = 0;
-    while (true) {
-        string raw = sharedBuffer.get();
-        if (raw == "-1") {
-            this->dataPublishToMaster(connFd, loop_exit_p, raw);
-            instance_logger.info("Total time taken for query execution: " + std::to_string(time) + " ms");
-            result.join();
-            break;
-        }
+    // Rows leave the worker as JSON, one message per row
+    RowBatch batch;
+    while (sharedBuffer.get(batch)) {
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
         time += duration.count();
-        this->dataPublishToMaster(connFd, loop_exit_p, raw);
+        for (size_t row = 0; row < batch.size(); row++) {
+            this->dataPublishToMaster(connFd, loop_exit_p, batch.toJson(row, true).dump());
+        }
         startTime = std::chrono::high_resolution_clock::now();
     }
+    this->dataPublishToMaster(connFd, loop_exit_p, "-1");
+    instance_logger.info("Total time taken for query execution: " + std::to_string(time) + " ms");
+    pipeline->join();
 }
 
 void InstanceHandler::dataPublishToMaster(int connFd, bool *loop_exit_p, std::string message) {
@@ -16,638 +16,768 @@ limitations under the License.
 #include "../util/Const.h"
 #include "../../../../util/logger/Logger.h"
 #include "Helpers.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
 #include <thread>
 #include <queue>
 
 Logger execution_logger;
 std::unordered_map<std::string,
-    std::function<void(OperatorExecutor&, SharedBuffer&, std::string, GraphConfig)>> OperatorExecutor::methodMap;
+    std::function<void(OperatorExecutor&, BatchBuffer&, std::string, GraphConfig)>> OperatorExecutor::methodMap;
 OperatorExecutor::OperatorExecutor(GraphConfig gc, std::string queryPlan, std::string masterIP):
     queryPlan(queryPlan), gc(gc), masterIP(masterIP) {
     this->query = json::parse(queryPlan);
 };
 
+void OperatorExecutor::execute(BatchBuffer &buffer) {
+    methodMap[this->query["Operator"]](*this, buffer, this->queryPlan, this->gc);
+    // Closed on the thread that opened it
+    this->store.reset();
+}
+
+void OperatorExecutor::runPipeline(const string &jsonPlan, GraphConfig gc, BatchBuffer::Consumer consume) {
+    json plan = json::parse(jsonPlan);
+    BatchBuffer input(std::move(consume));
+    std::vector<Fragment> above = std::move(this->fragments);
+    this->fragments.clear();
+    methodMap[plan["Operator"]](*this, input, jsonPlan, gc);
+    this->fragments = std::move(above);
+}
+
+void OperatorExecutor::runPipeline(const string &jsonPlan, GraphConfig gc, BatchBuffer &buffer,
+                                   const RowSchema::Ptr &schema,
+                                   std::function<void(RowBatch &, BatchWriter &)> process) {
+    json plan = json::parse(jsonPlan);
+    BatchWriter out(buffer, schema);
+    BatchBuffer input([&process, &out](RowBatch &batch) { process(batch, out); });
+    this->fragments.push_back({process, schema, &buffer});
+    size_t depth = this->fragments.size();
+    methodMap[plan["Operator"]](*this, input, jsonPlan, gc);
+    // A scan that took the fragment ran it in its threads and closed the buffer
+    if (this->fragments.size() == depth) {
+        this->fragments.pop_back();
+        out.close();
+    }
+}
+
+std::vector<OperatorExecutor::Fragment> OperatorExecutor::takeFragments() {
+    std::vector<Fragment> taken = std::move(this->fragments);
+    this->fragments.clear();
+    return taken;
+}
+
+NodeManager &OperatorExecutor::openStore(GraphConfig gc) {
+    // A second NodeManager on the thread would replace the store streams of the first one
+    if (!this->store) {
+        this->store = std::make_unique<NodeManager>(gc);
+    }
+    return *this->store;
+}
+
 void OperatorExecutor::initializeMethodMap() {
-    methodMap["AllNodeScan"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["AllNodeScan"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
             std::string jsonPlan, GraphConfig gc) {
         executor.AllNodeScan(buffer, jsonPlan, gc);
     };
 
-    methodMap["ProduceResult"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["ProduceResult"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
             std::string jsonPlan, GraphConfig gc) {
         executor.ProduceResult(buffer, jsonPlan, gc);
     };
 
-    methodMap["Filter"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["Filter"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
             std::string jsonPlan, GraphConfig gc) {
         executor.Filter(buffer, jsonPlan, gc);
     };
 
-    methodMap["ExpandAll"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["ExpandAll"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
             std::string jsonPlan, GraphConfig gc) {
         executor.ExpandAll(buffer, jsonPlan, gc);
     };
 
-    methodMap["UndirectedRelationshipTypeScan"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["UndirectedRelationshipTypeScan"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
             std::string jsonPlan, GraphConfig gc) {
         executor.UndirectedRelationshipTypeScan(buffer, jsonPlan, gc);
     };
 
-    methodMap["UndirectedAllRelationshipScan"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["UndirectedAllRelationshipScan"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
             std::string jsonPlan, GraphConfig gc) {
         executor.UndirectedAllRelationshipScan(buffer, jsonPlan, gc);
     };
 
-    methodMap["DirectedRelationshipTypeScan"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["DirectedRelationshipTypeScan"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
                                                      std::string jsonPlan, GraphConfig gc) {
         executor.DirectedRelationshipTypeScan(buffer, jsonPlan, gc);
     };
 
-    methodMap["DirectedAllRelationshipScan"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["DirectedAllRelationshipScan"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
                                                     std::string jsonPlan, GraphConfig gc) {
         executor.DirectedAllRelationshipScan(buffer, jsonPlan, gc);
     };
 
-    methodMap["NodeByIdSeek"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["NodeByIdSeek"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
                                                     std::string jsonPlan, GraphConfig gc) {
         executor.NodeByIdSeek(buffer, jsonPlan, gc);
     };
 
-    methodMap["Projection"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["Projection"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
             std::string jsonPlan, GraphConfig gc) {
         executor.Projection(buffer, jsonPlan, gc);
     };
 
-    methodMap["AggregationFunction"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["AggregationFunction"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
                                    std::string jsonPlan, GraphConfig gc) {
         executor.AggregationFunction(buffer, jsonPlan, gc);
     };
 
-    methodMap["Create"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["Create"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
                                     std::string jsonPlan, GraphConfig gc) {
         executor.Create(buffer, jsonPlan, gc);
     };
 
-    methodMap["CartesianProduct"] = [](OperatorExecutor &executor, SharedBuffer &buffer,
+    methodMap["Delete"] = [](OperatorExecutor &executor, BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+        executor.Delete(buffer, jsonPlan, gc);
+    };
+
+    methodMap["CartesianProduct"] = [](OperatorExecutor &executor, BatchBuffer &buffer,
                                      std::string jsonPlan, GraphConfig gc) {
         executor.CartesianProduct(buffer, jsonPlan, gc);
     };
 
-    methodMap["Distinct"] = [](OperatorExecutor &executor, SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    methodMap["Distinct"] = [](OperatorExecutor &executor, BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
         executor.Distinct(buffer, jsonPlan, gc);
     };
 
-    methodMap["OrderBy"] = [](OperatorExecutor &executor, SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    methodMap["OrderBy"] = [](OperatorExecutor &executor, BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
         executor.OrderBy(buffer, jsonPlan, gc);
     };
 
-    methodMap["NodeScanByLabel"] = [](OperatorExecutor &executor, SharedBuffer &buffer, std::string jsonPlan,
+    methodMap["NodeScanByLabel"] = [](OperatorExecutor &executor, BatchBuffer &buffer, std::string jsonPlan,
             GraphConfig gc) {
         executor.NodeScanByLabel(buffer, jsonPlan, gc);
     };
+
+    methodMap["MultipleNodeScanByLabel"] = [](OperatorExecutor &executor, BatchBuffer &buffer, std::string jsonPlan,
+            GraphConfig gc) {
+        executor.MultipleNodeScanByLabel(buffer, jsonPlan, gc);
+    };
+
+    methodMap["NodeIndexSeek"] = [](OperatorExecutor &executor, BatchBuffer &buffer, std::string jsonPlan,
+            GraphConfig gc) {
+        executor.NodeIndexSeek(buffer, jsonPlan, gc);
+    };
+
+    methodMap["NodeIndexRangeScan"] = [](OperatorExecutor &executor, BatchBuffer &buffer, std::string jsonPlan,
+            GraphConfig gc) {
+        executor.NodeIndexRangeScan(buffer, jsonPlan, gc);
+    };
+
+    methodMap["CreateIndex"] = [](OperatorExecutor &executor, BatchBuffer &buffer, std::string jsonPlan,
+            GraphConfig gc) {
+        executor.CreateIndex(buffer, jsonPlan, gc);
+    };
 }
 
-void OperatorExecutor::AllNodeScan(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
-    json query = json::parse(jsonPlan);
-    NodeManager nodeManager(gc);
-    for (auto it : nodeManager.nodeIndex) {
-        json nodeData;
-        auto nodeId = it.first;
-        NodeBlock *node = nodeManager.get(nodeId);
-        std::string value(node->getMetaPropertyHead()->value);
-        if (value == to_string(gc.partitionID)) {
-            nodeData["partitionID"] = value;
-            std::map<std::string, char*> properties = node->getAllProperties();
-            for (auto property : properties) {
-                nodeData[property.first] = property.second;
+
+/**
+ * Variables of the rows produced by the operator of a plan, derived from the plan before the operator runs. Operators
+ * that add variables to the rows of their input append them after the input variables.
+ * */
+RowSchema::Ptr OperatorExecutor::outputSchema(const json &plan) {
+    auto schema = std::make_shared<RowSchema>();
+    auto addInput = [&schema, &plan](const char *input) {
+        if (plan.contains(input)) {
+            for (auto &variable : outputSchema(json::parse(plan[input].get<std::string>()))->variables()) {
+                schema->add(variable);
             }
-            for (auto& [key, value] : properties) {
-                delete[] value;  // Free each allocated char* array
+        }
+    };
+    std::string op = plan["Operator"];
+    if (op == "AllNodeScan" || op == "MultipleNodeScanByLabel") {
+        schema->add(plan["variables"]);
+    } else if (op == "NodeScanByLabel" || op == "NodeIndexSeek" || op == "NodeIndexRangeScan" ||
+               op == "NodeByIdSeek") {
+        schema->add(plan["variable"]);
+    } else if (op == "UndirectedRelationshipTypeScan" || op == "UndirectedAllRelationshipScan" ||
+               op == "DirectedRelationshipTypeScan" || op == "DirectedAllRelationshipScan") {
+        schema->add(plan["sourceVariable"]);
+        schema->add(plan["destVariable"]);
+        schema->add(plan["relVariable"]);
+    } else if (op == "ExpandAll") {
+        addInput("NextOperator");
+        schema->add(plan["relVariable"]);
+        schema->add(plan["destVariable"]);
+    } else if (op == "Projection" || op == "Distinct") {
+        addInput("NextOperator");
+        if (plan.contains("project") && plan["project"].is_array()) {
+            for (const auto &operand : plan["project"]) {
+                if (operand.contains("variable") && schema->slot(operand["variable"]) >= 0) {
+                    schema->add(operand["assign"]);
+                } else if (operand.contains("functionName") && schema->slot(operand["functionName"]) >= 0) {
+                    schema->add("variable");
+                    schema->add(operand["assign"]);
+                }
             }
-            properties.clear();
-
-            json data;
-            string variable = query["variables"];
-            data[variable] = nodeData;
-            buffer.add(data.dump());
         }
+    } else if (op == "ProduceResult") {
+        for (const auto &variable : plan["variable"]) {
+            schema->add(variable);
+        }
+    } else if (op == "AggregationFunction") {
+        schema->add("avg");
+        schema->add("numberOfData");
+    } else if (op == "Create") {
+        addInput("NextOperator");
+        // Variables of the created nodes, and of the relationships and their end nodes
+        std::function<void(const json &)> addVariables = [&](const json &element) {
+            for (auto &[key, value] : element.items()) {
+                if (key == "variable" && value.is_string()) {
+                    schema->add(value);
+                } else if (value.is_structured()) {
+                    addVariables(value);
+                }
+            }
+        };
+        addVariables(plan["elements"]);
+    } else if (op == "Delete") {
+        schema->add("partitionID");
+        schema->add("deletedNodes");
+        schema->add("deletedRelationships");
+    } else if (op == "CreateIndex") {
+        schema->add("partitionID");
+        schema->add("index");
+        schema->add("created");
+    } else if (op == "CartesianProduct") {
+        addInput("left");
+        addInput("right");
+    } else {  // Filter and OrderBy pass the rows of their input
+        addInput("NextOperator");
     }
-    buffer.add("-1");
+    return schema;
 }
 
-void OperatorExecutor::NodeScanByLabel(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
-    json query = json::parse(jsonPlan);
-    NodeManager nodeManager(gc);
-    for (auto it : nodeManager.nodeIndex) {
-        json nodeData;
-        auto nodeId = it.first;
-        NodeBlock *node = nodeManager.get(nodeId);
-        string label = node->getLabel();
-        std::string value(node->getMetaPropertyHead()->value);
-        if (value == to_string(gc.partitionID) && label == query["Label"]) {
-            nodeData["partitionID"] = value;
-            std::map<std::string, char*> properties = node->getAllProperties();
-            for (auto property : properties) {
-                nodeData[property.first] = property.second;
-            }
-            for (auto& [key, value] : properties) {
-                delete[] value;  // Free each allocated char* array
-            }
-            properties.clear();
-
-            json data;
-            string variable = query["variable"];
-            data[variable] = nodeData;
-            buffer.add(data.dump());
-        }
+/**
+ * Partition ID and properties of a node as the value of a row slot
+ * */
+static std::shared_ptr<const Entity> nodeEntity(NodeBlock *node, const std::string &partitionID) {
+    auto entity = std::make_shared<Entity>();
+    entity->properties.emplace_back("partitionID", partitionID);
+    std::map<std::string, char*> properties = node->getAllProperties();
+    for (auto& [key, value] : properties) {
+        entity->properties.emplace_back(key, value);
+        delete[] value;  // Free each allocated char* array
     }
-    buffer.add("-1");
+    return entity;
 }
 
-void OperatorExecutor::ProduceResult(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
-    json query = json::parse(jsonPlan);
-    SharedBuffer sharedBuffer(INTER_OPERATOR_BUFFER_SIZE);
-    std::string nextOpt = query["NextOperator"];
-    json next = json::parse(nextOpt);
-    auto method = OperatorExecutor::methodMap[next["Operator"]];
-    // Launch the method in a new thread
-    std::thread result(method, std::ref(*this), std::ref(sharedBuffer), query["NextOperator"], gc);
-
-    while (true) {
-        string raw = sharedBuffer.get();
-        if (raw == "-1") {
-            buffer.add(raw);
-            result.join();
-            break;
-        }
-        std::vector<std::string> values = query["variable"].get<std::vector<std::string>>();
-        json data;
-        json rawObj = json::parse(raw);
-        for (auto value : values) {
-            data[value] = rawObj[value];
-        }
-        buffer.add(data.dump());
+int OperatorExecutor::scanParallelism() {
+    int parallelism = 0;
+    if (this->query.contains("parallelism") && this->query["parallelism"].is_number_integer()) {
+        parallelism = this->query["parallelism"];
+    } else {
+        parallelism = atoi(Utils::getJasmineGraphProperty("org.jasminegraph.query.scan.parallelism").c_str());
+    }
+    if (parallelism <= 0) {  // One scan thread per core
+        parallelism = std::max(1U, std::thread::hardware_concurrency());
     }
+    return parallelism;
 }
 
-void OperatorExecutor::Filter(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
-    json query = json::parse(jsonPlan);
-    SharedBuffer sharedBuffer(INTER_OPERATOR_BUFFER_SIZE);
-    std::string nextOpt = query["NextOperator"];
-    json next = json::parse(nextOpt);
-    auto method = OperatorExecutor::methodMap[next["Operator"]];
-    // Launch the method in a new thread
-    std::thread result(method, std::ref(*this), std::ref(sharedBuffer), query["NextOperator"], gc);
-
-    auto condition = query["condition"];
-    FilterHelper FilterHelper(condition.dump());
-    while (true) {
-        string raw = sharedBuffer.get();
-        if (raw == "-1") {
-            buffer.add(raw);
-            result.join();
-            break;
-        }
-        if (FilterHelper.evaluate(raw)) {
-            buffer.add(raw);
+/**
+ * Fragments of the streaming operators above a morsel scan as run by one scan thread. Rows added to input() are
+ * passed through the fragments from the innermost one to the outermost one, whose rows go to the output buffer.
+ * */
+class FragmentChain {
+ public:
+    FragmentChain(const std::vector<OperatorExecutor::Fragment> &fragments, BatchBuffer &output,
+                  const RowSchema::Ptr &schema) {
+        BatchBuffer *next = &output;
+        for (const auto &fragment : fragments) {
+            this->writers.emplace_back(new BatchWriter(*next, fragment.schema));
+            BatchWriter *writer = this->writers.back().get();
+            auto &process = fragment.process;
+            this->buffers.emplace_back(new BatchBuffer([&process, writer](RowBatch &batch) {
+                process(batch, *writer);
+            }));
+            next = this->buffers.back().get();
+        }
+        this->writers.emplace_back(new BatchWriter(*next, schema));
+    }
+
+    BatchWriter &input() { return *this->writers.back(); }
+
+    // Pass on the last rows of every fragment, the innermost one first, and close the output buffer
+    void close() {
+        for (auto writer = this->writers.rbegin(); writer != this->writers.rend(); writer++) {
+            (*writer)->close();
         }
     }
-}
 
-void OperatorExecutor::UndirectedRelationshipTypeScan(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
-    json query = json::parse(jsonPlan);
-    NodeManager nodeManager(gc);
+ private:
+    std::vector<std::unique_ptr<BatchBuffer>> buffers;
+    std::vector<std::unique_ptr<BatchWriter>> writers;
+};
 
-    const std::string& dbPrefix = nodeManager.getDbPrefix();
-    long localRelationCount = nodeManager.dbSize(dbPrefix + "_relations.db") / RelationBlock::BLOCK_SIZE;
-    long centralRelationCount = nodeManager.dbSize(dbPrefix +
-                                                   "_central_relations.db") / RelationBlock::CENTRAL_BLOCK_SIZE;
-    string direction = Utils::getGraphDirection(to_string(gc.graphID), masterIP);
-    bool isDirected = false;
-    if (direction == "TRUE") {
-        isDirected = true;
+/**
+ * Morsel driven scan of count node or relation IDs. The IDs are split into morsels of MORSEL_SIZE that the scanning
+ * threads claim one at a time, so a thread that runs into slow blocks does not hold back the others. The calling thread
+ * scans morsels itself and hands the rest to helper tasks of the TaskPool. Every helper reads the partition through a
+ * ThreadStore of the pipeline's NodeManager, as the native store streams are per thread. The scanning threads run the
+ * fragments of the streaming operators above the scan on their own rows, each helper writes the rows of the outermost
+ * fragment to its own batch buffer, which the calling thread passes on between its morsels. Helpers that have not
+ * started once every morsel is claimed are dropped. addRows(out, position) adds the rows of the ID at a position.
+ * Scans of a single morsel and a parallelism of 1 keep the order of the IDs.
+ * */
+template <typename AddRows>
+static void morselScan(BatchBuffer &buffer, const RowSchema::Ptr &schema, size_t count, int parallelism,
+                       NodeManager &nodeManager, const std::vector<OperatorExecutor::Fragment> &fragments,
+                       AddRows addRows) {
+    size_t morsels = (count + OperatorExecutor::MORSEL_SIZE - 1) / OperatorExecutor::MORSEL_SIZE;
+    size_t threads = std::min<size_t>(parallelism, morsels);
+    // Rows of the outermost fragment go where that operator adds its rows
+    BatchBuffer &output = fragments.empty() ? buffer : *fragments.front().output;
+    FragmentChain chain(fragments, output, schema);
+    std::atomic<size_t> nextMorsel{0};
+    // Scan the next unclaimed morsel, false once every morsel is claimed
+    auto scanMorsel = [&nextMorsel, morsels, count, &addRows](BatchWriter &writer) {
+        size_t morsel = nextMorsel.fetch_add(1, std::memory_order_relaxed);
+        if (morsel >= morsels) {
+            return false;
+        }
+        size_t end = std::min(count, (morsel + 1) * OperatorExecutor::MORSEL_SIZE);
+        for (size_t position = morsel * OperatorExecutor::MORSEL_SIZE; position < end; position++) {
+            addRows(writer, position);
+        }
+        return true;
+    };
+
+    std::vector<std::unique_ptr<BatchBuffer>> outputs;
+    std::vector<std::shared_ptr<TaskPool::Task>> helpers;
+    for (size_t i = 1; i < threads; i++) {
+        outputs.emplace_back(new BatchBuffer(OperatorExecutor::INTER_OPERATOR_BUFFER_SIZE));
+        helpers.push_back(TaskPool::getInstance().submit([&, helperOutput = outputs.back().get()]() {
+            FragmentChain helperChain(fragments, *helperOutput, schema);
+            std::unique_ptr<NodeManager::ThreadStore> threadStore;
+            if (nextMorsel.load(std::memory_order_relaxed) < morsels) {
+                threadStore.reset(new NodeManager::ThreadStore(nodeManager));
+                while (scanMorsel(helperChain.input())) {
+                }
+            }
+            // Fragments such as ExpandAll still read the partition when their last rows are passed on
+            helperChain.close();
+        }));
     }
-    int count = 1;
-    for (long i = 1; i < localRelationCount; i++) {
-        json startNodeData;
-        json destNodeData;
-        json relationData;
-        RelationBlock* relation = RelationBlock::getLocalRelation(i*RelationBlock::BLOCK_SIZE);
-        if (relation->getLocalRelationshipType() != query["relType"]) {
-            continue;
-        }
-        NodeBlock* startNode = relation->getSource();
-        NodeBlock* destNode = relation->getDestination();
-
-        std::string startPid(startNode->getMetaPropertyHead()->value);
-        startNodeData["partitionID"] = startPid;
-        std::map<std::string, char*> startProperties = startNode->getAllProperties();
-        for (auto property : startProperties) {
-            startNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : startProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        startProperties.clear();
 
-        std::string destPid(destNode->getMetaPropertyHead()->value);
-        destNodeData["partitionID"] = destPid;
-        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-        for (auto property : destProperties) {
-            destNodeData[property.first] = property.second;
+    // Batches are passed on as they arrive, rows of different morsels are not kept in ID order
+    std::vector<bool> finished(outputs.size(), false);
+    RowBatch batch;
+    auto passOnBatches = [&]() {
+        bool received = false;
+        for (size_t i = 0; i < outputs.size(); i++) {
+            while (!finished[i] && outputs[i]->tryGet(batch)) {
+                output.add(std::move(batch));
+                received = true;
+            }
+            finished[i] = finished[i] || outputs[i]->finished();
         }
-        for (auto& [key, value] : destProperties) {
-            delete[] value;  // Free each allocated char* array
+        return received;
+    };
+    while (scanMorsel(chain.input())) {
+        passOnBatches();
+    }
+    for (size_t i = 0; i < helpers.size(); i++) {
+        finished[i] = finished[i] || helpers[i]->cancel();
+    }
+    unsigned int idle = 0;
+    while (std::find(finished.begin(), finished.end(), false) != finished.end()) {
+        if (passOnBatches()) {
+            idle = 0;
+        } else {
+            SpscRing<RowBatch>::backoff(idle);
         }
-        destProperties.clear();
+    }
+    // Only helpers that started are left, join() waits for them to leave their task
+    for (auto &helper : helpers) {
+        helper->join();
+    }
+    chain.close();
+}
 
-        std::map<std::string, char*> relProperties = relation->getAllProperties();
-        for (auto property : relProperties) {
-            relationData[property.first] = property.second;
-        }
-        for (auto& [key, value] : relProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        relProperties.clear();
-
-        json rightDirectionData;
-        string start = query["sourceVariable"];
-        string dest = query["destVariable"];
-        string rel = query["relVariable"];
-
-        rightDirectionData[start] = startNodeData;
-        rightDirectionData[dest] = destNodeData;
-        rightDirectionData[rel] = relationData;
-        buffer.add(rightDirectionData.dump());
-
-        if (!isDirected) {
-            json leftDirectionData;
-            leftDirectionData[start] = destNodeData;
-            leftDirectionData[dest] = startNodeData;
-            leftDirectionData[rel] = relationData;
-            buffer.add(leftDirectionData.dump());
-        }
-        count++;
+void OperatorExecutor::AllNodeScan(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    NodeManager &nodeManager = openStore(gc);
+    RowSchema::Ptr schema = outputSchema(query);
+    int slot = schema->slot(query["variables"]);
+    // The node index is read in one pass, the node blocks and properties are read by the scan threads
+    std::vector<unsigned int> nodeIndexes;
+    for (auto it : *nodeManager.nodeIndex) {
+        nodeIndexes.push_back(it.second);
     }
+    const std::string partitionID = to_string(gc.partitionID);
+    morselScan(buffer, schema, nodeIndexes.size(), scanParallelism(), nodeManager, takeFragments(),
+               [&nodeIndexes, slot, &partitionID](BatchWriter &out, size_t position) {
+        const unsigned long blockAddress = (unsigned long)nodeIndexes[position] * NodeBlock::BLOCK_SIZE;
+        char block[NodeBlock::BLOCK_SIZE] = {0};
+        if (!NodeBlock::readBlock(blockAddress, block)) {
+            execution_logger.error("Error while reading node block data from block " + std::to_string(blockAddress));
+            return;
+        }
+        NodeBlock *node = NodeBlock::decode("", blockAddress, block);
+        MetaPropertyLink *metaProperty = node->getMetaPropertyHead();
+        std::string value(metaProperty ? metaProperty->value : "");
+        delete metaProperty;
+        if (value == partitionID) {
+            size_t row = out.addRow();
+            out.batch().set(row, slot, nodeEntity(node, value));
+        }
+        delete node;
+    });
+}
 
-    int central = 1;
-    for (long i = 1; i < centralRelationCount; i++) {
-        json startNodeData;
-        json destNodeData;
-        json relationData;
-        RelationBlock* relation = RelationBlock::getCentralRelation(i * RelationBlock::CENTRAL_BLOCK_SIZE);
-        if (relation->getCentralRelationshipType() != query["relType"]) {
-            continue;
-        }
+/**
+ * Add the row of a node found by a label or index scan, skipping nodes that are only replicated in this partition
+ * */
+static void addNodeScanRow(BatchWriter &out, NodeBlock *node, int slot, GraphConfig gc) {
+    MetaPropertyLink *metaProperty = node->getMetaPropertyHead();
+    std::string value(metaProperty ? metaProperty->value : "");
+    delete metaProperty;
+    if (value != to_string(gc.partitionID)) {
+        return;
+    }
+    size_t row = out.addRow();
+    out.batch().set(row, slot, nodeEntity(node, value));
+}
 
-        std::string pid(relation->getMetaPropertyHead()->value);
-        if (pid != to_string(gc.partitionID)) {
-            continue;
-        }
+void OperatorExecutor::NodeScanByLabel(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    NodeManager &nodeManager = openStore(gc);
+    RowSchema::Ptr schema = outputSchema(query);
+    int slot = schema->slot(query["variable"]);
+    std::vector<unsigned int> nodes = nodeManager.labelIndex->getNodes(query["Label"].get<std::string>());
+    morselScan(buffer, schema, nodes.size(), scanParallelism(), nodeManager, takeFragments(),
+               [&nodes, slot, gc](BatchWriter &out, size_t position) {
+        NodeBlock *node = NodeBlock::get(nodes[position] * NodeBlock::BLOCK_SIZE);
+        addNodeScanRow(out, node, slot, gc);
+        delete node;
+    });
+}
 
-        NodeBlock* startNode = relation->getSource();
-        NodeBlock* destNode = relation->getDestination();
+void OperatorExecutor::MultipleNodeScanByLabel(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    NodeManager &nodeManager = openStore(gc);
+    BatchWriter out(buffer, outputSchema(query));
+    int slot = out.schema()->slot(query["variables"]);
+    // (n:A:B) matches nodes that have all of the labels
+    std::vector<std::string> labels = query["Label"];
+    for (unsigned int nodeIndex : nodeManager.labelIndex->getNodes(labels, true)) {
+        NodeBlock *node = NodeBlock::get(nodeIndex * NodeBlock::BLOCK_SIZE);
+        addNodeScanRow(out, node, slot, gc);
+        delete node;
+    }
+    out.close();
+}
 
-        std::string startPid(startNode->getMetaPropertyHead()->value);
-        startNodeData["partitionID"] = startPid;
-        std::map<std::string, char*> startProperties = startNode->getAllProperties();
-        for (auto property : startProperties) {
-            startNodeData[property.first] = property.second;
+/**
+ * Emit the nodes found by a property index lookup that have all the labels of the pattern. Partitions without an index
+ * of the property emit every node with the labels, the predicate is checked by the Filter above the lookup.
+ * */
+static void addIndexScanRows(BatchWriter &out, NodeManager &nodeManager, const json &query, bool indexed,
+                             const std::vector<unsigned int> &nodes, GraphConfig gc) {
+    int slot = out.schema()->slot(query["variable"]);
+    std::vector<std::string> labels = query["Label"];
+    std::vector<unsigned int> scanned;
+    if (!indexed) {
+        if (labels.empty()) {
+            for (auto it : *nodeManager.nodeIndex) {
+                scanned.push_back(it.second);
+            }
+        } else {
+            scanned = nodeManager.labelIndex->getNodes(labels, true);
+            labels.clear();
         }
-        for (auto& [key, value] : startProperties) {
-            delete[] value;  // Free each allocated char* array
+    }
+    std::vector<LabelIndex::Bitmap> bitmaps;
+    for (auto &label : labels) {
+        bitmaps.push_back(nodeManager.labelIndex->getBitmap(label));
+    }
+    for (unsigned int nodeIndex : indexed ? nodes : scanned) {
+        bool hasLabels = true;
+        for (auto &bitmap : bitmaps) {
+            unsigned int word = nodeIndex / 64;
+            hasLabels = hasLabels && word < bitmap.size() && (bitmap[word] >> (nodeIndex % 64) & 1ULL);
         }
-        startProperties.clear();
-
-        std::string destPid(destNode->getMetaPropertyHead()->value);
-        destNodeData["partitionID"] = destPid;
-        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-        for (auto property : destProperties) {
-            destNodeData[property.first] = property.second;
+        if (!hasLabels) {
+            continue;
         }
-        for (auto& [key, value] : destProperties) {
-            delete[] value;  // Free each allocated char* array
+        // Property indexes keep the entries of deleted nodes, whose blocks are no longer in use
+        NodeBlock *node = NodeBlock::get(nodeIndex * NodeBlock::BLOCK_SIZE);
+        if (node && node->isInUse()) {
+            addNodeScanRow(out, node, slot, gc);
         }
-        destProperties.clear();
+        delete node;
+    }
+}
 
-        std::map<std::string, char*> relProperties = relation->getAllProperties();
-        for (auto property : relProperties) {
-            relationData[property.first] = property.second;
-        }
-        for (auto& [key, value] : relProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        relProperties.clear();
-
-        json rightDirectionData;
-        string start = query["sourceVariable"];
-        string dest = query["destVariable"];
-        string rel = query["relVariable"];
-
-        rightDirectionData[start] = startNodeData;
-        rightDirectionData[dest] = destNodeData;
-        rightDirectionData[rel] = relationData;
-        buffer.add(rightDirectionData.dump());
-
-        if (!isDirected) {
-            json leftDirectionData;
-            leftDirectionData[start] = destNodeData;
-            leftDirectionData[dest] = startNodeData;
-            leftDirectionData[rel] = relationData;
-            buffer.add(leftDirectionData.dump());
-        }
-        central++;
+void OperatorExecutor::NodeIndexSeek(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    NodeManager &nodeManager = openStore(gc);
+    BatchWriter out(buffer, outputSchema(query));
+    std::vector<unsigned int> nodes;
+    bool indexed = nodeManager.propertyIndex->seek(query["property"], query["value"], nodes);
+    addIndexScanRows(out, nodeManager, query, indexed, nodes, gc);
+    out.close();
+}
+
+void OperatorExecutor::NodeIndexRangeScan(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    NodeManager &nodeManager = openStore(gc);
+    BatchWriter out(buffer, outputSchema(query));
+    // Integer bounds, exclusive bounds are moved to the next integer inside the range
+    long long lower = LLONG_MIN;
+    long long upper = LLONG_MAX;
+    bool lowerInclusive = true;
+    bool upperInclusive = true;
+    bool valid = true;
+    if (query.contains("lower")) {
+        valid = PropertyIndex::toInteger(query["lower"], lower);
+        lowerInclusive = query["lowerInclusive"].get<bool>();
+    }
+    if (valid && query.contains("upper")) {
+        valid = PropertyIndex::toInteger(query["upper"], upper);
+        upperInclusive = query["upperInclusive"].get<bool>();
     }
-    buffer.add("-1");
+    // A range without integers, such as > 9223372036854775807, matches no node
+    valid = valid && PropertyIndex::inclusiveRange(lower, lowerInclusive, upper, upperInclusive);
+    std::vector<unsigned int> nodes;
+    bool indexed = !valid || nodeManager.propertyIndex->rangeScan(query["property"], lower, upper, nodes);
+    addIndexScanRows(out, nodeManager, query, indexed, nodes, gc);
+    out.close();
 }
 
-void OperatorExecutor::UndirectedAllRelationshipScan(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+void OperatorExecutor::CreateIndex(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    NodeManager nodeManager(gc);
+    NodeManager &nodeManager = openStore(gc);
+    string property = query["property"];
+    PropertyIndexType type = query["indexType"] == "HASH" ? PropertyIndexType::HASH : PropertyIndexType::RANGE;
+    BatchWriter out(buffer, outputSchema(query));
+    size_t row = out.addRow();
+    out.batch().set(row, out.schema()->slot("partitionID"), to_string(gc.partitionID));
+    out.batch().set(row, out.schema()->slot("index"), query["indexType"].get<std::string>() + " (" + property + ")");
+    out.batch().set(row, out.schema()->slot("created"), nodeManager.createPropertyIndex(property, type));
+    out.close();
+}
 
-    const std::string& dbPrefix = nodeManager.getDbPrefix();
-    long localRelationCount = nodeManager.dbSize(dbPrefix + "_relations.db") / RelationBlock::BLOCK_SIZE;
-    long centralRelationCount = nodeManager.dbSize(dbPrefix +
-                                                    "_central_relations.db") / RelationBlock::CENTRAL_BLOCK_SIZE;
-    string direction = Utils::getGraphDirection(to_string(gc.graphID), masterIP);
-    bool isDirected = false;
-    if (direction == "TRUE") {
-        isDirected = true;
+void OperatorExecutor::ProduceResult(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    std::string nextOpt = query["NextOperator"];
+    json next = json::parse(nextOpt);
+
+    // Input slot of every result variable, -1 if the input does not bind it
+    RowSchema::Ptr inputSchema = outputSchema(next);
+    RowSchema::Ptr schema = outputSchema(query);
+    std::vector<int> inputSlots;
+    for (auto &variable : schema->variables()) {
+        inputSlots.push_back(inputSchema->slot(variable));
     }
-    int count = 1;
-    for (long i = 1; i < localRelationCount; i++) {
-        json startNodeData;
-        json destNodeData;
-        json relationData;
-        RelationBlock* relation = RelationBlock::getLocalRelation(i*RelationBlock::BLOCK_SIZE);
-        NodeBlock* startNode = relation->getSource();
-        NodeBlock* destNode = relation->getDestination();
-
-        std::string startPid(startNode->getMetaPropertyHead()->value);
-        startNodeData["partitionID"] = startPid;
-        std::map<std::string, char*> startProperties = startNode->getAllProperties();
-        for (auto property : startProperties) {
-            startNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : startProperties) {
-            delete[] value;  // Free each allocated char* array
+    runPipeline(nextOpt, gc, buffer, schema, [&inputSlots](RowBatch &input, BatchWriter &out) {
+        for (size_t row = 0; row < input.size(); row++) {
+            size_t resultRow = out.addRow();
+            for (size_t slot = 0; slot < inputSlots.size(); slot++) {
+                if (inputSlots[slot] >= 0) {
+                    out.batch().set(resultRow, slot, input.get(row, inputSlots[slot]));
+                }
+            }
         }
-        startProperties.clear();
+    });
+}
 
-        std::string destPid(destNode->getMetaPropertyHead()->value);
-        destNodeData["partitionID"] = destPid;
-        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-        for (auto property : destProperties) {
-            destNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : destProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        destProperties.clear();
+void OperatorExecutor::Filter(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    std::string nextOpt = query["NextOperator"];
+    json next = json::parse(nextOpt);
 
-        std::map<std::string, char*> relProperties = relation->getAllProperties();
-        for (auto property : relProperties) {
-            relationData[property.first] = property.second;
-        }
-        for (auto& [key, value] : relProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        relProperties.clear();
-
-        json rightDirectionData;
-        string start = query["sourceVariable"];
-        string dest = query["destVariable"];
-        string rel = query["relVariable"];
-
-        rightDirectionData[start] = startNodeData;
-        rightDirectionData[dest] = destNodeData;
-        rightDirectionData[rel] = relationData;
-        buffer.add(rightDirectionData.dump());
-
-        if (!isDirected) {
-            json leftDirectionData;
-            leftDirectionData[start] = destNodeData;
-            leftDirectionData[dest] = startNodeData;
-            leftDirectionData[rel] = relationData;
-            buffer.add(leftDirectionData.dump());
+    // Compiled against the rows of the next operator, rows are then tested without any json work
+    FilterHelper filterHelper(query["condition"], outputSchema(next));
+    runPipeline(nextOpt, gc, buffer, outputSchema(query), [&filterHelper](RowBatch &input, BatchWriter &out) {
+        for (size_t row = 0; row < input.size(); row++) {
+            if (filterHelper.evaluate(input, row)) {
+                out.addRow(input, row);
+            }
         }
-        count++;
+    });
+}
+
+/**
+ * Partition ID and properties of the node at a relation's endpoint, the node block is freed once it is read
+ * */
+static std::shared_ptr<const Entity> readNodeData(unsigned long nodeAddress) {
+    NodeBlock *node = NodeBlock::get(nodeAddress);
+    MetaPropertyLink *metaProperty = node->getMetaPropertyHead();
+    std::string partitionID(metaProperty ? metaProperty->value : "");
+    delete metaProperty;
+    std::shared_ptr<const Entity> nodeData = nodeEntity(node, partitionID);
+    delete node;
+    return nodeData;
+}
+
+static std::shared_ptr<const Entity> readRelationData(const RelationView &relation) {
+    auto relationData = std::make_shared<Entity>();
+    for (auto &property : relation.getAllProperties()) {
+        relationData->properties.emplace_back(property.first, property.second);
     }
+    return relationData;
+}
 
-    int central = 1;
-    for (long i = 1; i < centralRelationCount; i++) {
-        json startNodeData;
-        json destNodeData;
-        json relationData;
-        RelationBlock* relation = RelationBlock::getCentralRelation(i*RelationBlock::CENTRAL_BLOCK_SIZE);
-        std::string pid(relation->getMetaPropertyHead()->value);
-        if (pid != to_string(gc.partitionID)) {
-            continue;
-        }
+/**
+ * Add the row of a relation found by a relationship scan, an end that the scan does not bind is left unbound
+ * */
+static void addRelationRow(BatchWriter &out, int startSlot, int destSlot, int relSlot, const RowValue &startNodeData,
+                           const RowValue &destNodeData, const RowValue &relationData) {
+    size_t row = out.addRow();
+    out.batch().set(row, startSlot, startNodeData);
+    out.batch().set(row, destSlot, destNodeData);
+    out.batch().set(row, relSlot, relationData);
+}
 
-        NodeBlock* startNode = relation->getSource();
-        NodeBlock* destNode = relation->getDestination();
+/**
+ * Read a relation found by a relationship scan, false for unused blocks and for central relations that belong to
+ * another partition
+ * */
+static bool readScannedRelation(unsigned long relationIndex, bool central, const std::string &partitionID,
+                                RelationView &relation) {
+    if (!central) {
+        return RelationView::read(relationIndex * RelationBlock::BLOCK_SIZE, false, relation);
+    }
+    return RelationView::read(relationIndex * RelationBlock::CENTRAL_BLOCK_SIZE, true, relation) &&
+           relation.getPartitionId() == partitionID;
+}
 
-        std::string startPid(startNode->getMetaPropertyHead()->value);
-        startNodeData["partitionID"] = startPid;
-        std::map<std::string, char*> startProperties = startNode->getAllProperties();
-        for (auto property : startProperties) {
-            startNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : startProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        startProperties.clear();
+/**
+ * Add the rows of a relation found by an undirected relationship scan, relations of an undirected graph match both ways
+ * */
+static void addUndirectedRelationRows(BatchWriter &out, int start, int dest, int rel, bool isDirected,
+                                      const RelationView &relation) {
+    RowValue startNodeData = readNodeData(relation.source.address);
+    RowValue destNodeData = readNodeData(relation.destination.address);
+    RowValue relationData = readRelationData(relation);
+
+    addRelationRow(out, start, dest, rel, startNodeData, destNodeData, relationData);
+    if (!isDirected) {
+        addRelationRow(out, start, dest, rel, destNodeData, startNodeData, relationData);
+    }
+}
 
-        std::string destPid(destNode->getMetaPropertyHead()->value);
-        destNodeData["partitionID"] = destPid;
-        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-        for (auto property : destProperties) {
-            destNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : destProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        destProperties.clear();
+void OperatorExecutor::UndirectedRelationshipTypeScan(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    NodeManager &nodeManager = openStore(gc);
 
-        std::map<std::string, char*> relProperties = relation->getAllProperties();
-        for (auto property : relProperties) {
-            relationData[property.first] = property.second;
-        }
-        for (auto& [key, value] : relProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        relProperties.clear();
-
-        json rightDirectionData;
-        string start = query["sourceVariable"];
-        string dest = query["destVariable"];
-        string rel = query["relVariable"];
-
-        rightDirectionData[start] = startNodeData;
-        rightDirectionData[dest] = destNodeData;
-        rightDirectionData[rel] = relationData;
-        buffer.add(rightDirectionData.dump());
-
-        if (!isDirected) {
-            json leftDirectionData;
-            leftDirectionData[start] = destNodeData;
-            leftDirectionData[dest] = startNodeData;
-            leftDirectionData[rel] = relationData;
-            buffer.add(leftDirectionData.dump());
-        }
-        central++;
+    string relType = query["relType"];
+    string direction = Utils::getGraphDirection(to_string(gc.graphID), masterIP);
+    bool isDirected = false;
+    if (direction == "TRUE") {
+        isDirected = true;
     }
-    buffer.add("-1");
+    RowSchema::Ptr schema = outputSchema(query);
+    int start = schema->slot(query["sourceVariable"]);
+    int dest = schema->slot(query["destVariable"]);
+    int rel = schema->slot(query["relVariable"]);
+    // Local relations of the type come first, then the central ones
+    std::vector<unsigned int> local = nodeManager.relationTypeIndex->getRelations(relType, false);
+    std::vector<unsigned int> central = nodeManager.relationTypeIndex->getRelations(relType, true);
+    const std::string partitionID = to_string(gc.partitionID);
+    morselScan(buffer, schema, local.size() + central.size(), scanParallelism(), nodeManager, takeFragments(),
+               [&, start, dest, rel, isDirected](BatchWriter &out, size_t position) {
+        bool isCentral = position >= local.size();
+        RelationView relation;
+        if (readScannedRelation(isCentral ? central[position - local.size()] : local[position], isCentral,
+                                partitionID, relation)) {
+            addUndirectedRelationRows(out, start, dest, rel, isDirected, relation);
+        }
+    });
 }
 
-void OperatorExecutor::DirectedRelationshipTypeScan(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+void OperatorExecutor::UndirectedAllRelationshipScan(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    NodeManager nodeManager(gc);
-    string direction = query["direction"];
+    NodeManager &nodeManager = openStore(gc);
+
     const std::string& dbPrefix = nodeManager.getDbPrefix();
     long localRelationCount = nodeManager.dbSize(dbPrefix + "_relations.db") / RelationBlock::BLOCK_SIZE;
     long centralRelationCount = nodeManager.dbSize(dbPrefix +
-                                                   "_central_relations.db") / RelationBlock::CENTRAL_BLOCK_SIZE;
-    string graphDirection = Utils::getGraphDirection(to_string(gc.graphID), masterIP);
+                                                    "_central_relations.db") / RelationBlock::CENTRAL_BLOCK_SIZE;
+    string direction = Utils::getGraphDirection(to_string(gc.graphID), masterIP);
     bool isDirected = false;
-    if (graphDirection == "TRUE") {
+    if (direction == "TRUE") {
         isDirected = true;
     }
-    bool isDirectionRight = query["direction"] == "right";
-    int count = 1;
-    for (long i = 1; i < localRelationCount; i++) {
-        json startNodeData;
-        json destNodeData;
-        json relationData;
-        RelationBlock* relation = RelationBlock::getLocalRelation(i*RelationBlock::BLOCK_SIZE);
-        if (relation->getLocalRelationshipType() != query["relType"]) {
-            continue;
-        }
-        NodeBlock* startNode = relation->getSource();
-        NodeBlock* destNode = relation->getDestination();
-
-        std::string startPid(startNode->getMetaPropertyHead()->value);
-        startNodeData["partitionID"] = startPid;
-        std::map<std::string, char*> startProperties = startNode->getAllProperties();
-        for (auto property : startProperties) {
-            startNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : startProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        startProperties.clear();
-
-        std::string destPid(destNode->getMetaPropertyHead()->value);
-        destNodeData["partitionID"] = destPid;
-        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-        for (auto property : destProperties) {
-            destNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : destProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        destProperties.clear();
+    RowSchema::Ptr schema = outputSchema(query);
+    int start = schema->slot(query["sourceVariable"]);
+    int dest = schema->slot(query["destVariable"]);
+    int rel = schema->slot(query["relVariable"]);
+    // Relation blocks from 1 on, the local ones first and then the central ones
+    size_t local = std::max(localRelationCount - 1, 0L);
+    size_t central = std::max(centralRelationCount - 1, 0L);
+    const std::string partitionID = to_string(gc.partitionID);
+    morselScan(buffer, schema, local + central, scanParallelism(), nodeManager, takeFragments(),
+               [&partitionID, local, start, dest, rel, isDirected](BatchWriter &out, size_t position) {
+        bool isCentral = position >= local;
+        RelationView relation;
+        if (readScannedRelation(isCentral ? position - local + 1 : position + 1, isCentral, partitionID, relation)) {
+            addUndirectedRelationRows(out, start, dest, rel, isDirected, relation);
+        }
+    });
+}
 
-        std::map<std::string, char*> relProperties = relation->getAllProperties();
-        for (auto property : relProperties) {
-            relationData[property.first] = property.second;
-        }
-        for (auto& [key, value] : relProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        relProperties.clear();
-
-        json directionData;
-        string start = query["sourceVariable"];
-        string dest = query["destVariable"];
-        string rel = query["relVariable"];
-
-        if (isDirectionRight) {
-            directionData[start] = startNodeData;
-            directionData[dest] = destNodeData;
-        } else if (!isDirected) {
-            directionData[start] = destNodeData;
-            directionData[dest] = startNodeData;
-        }
-        directionData[rel] = relationData;
-        buffer.add(directionData.dump());
-        count++;
+/**
+ * Add the row of a relation found by a directed relationship scan. Relations of a directed graph that point the other
+ * way only bind the relationship variable.
+ * */
+static void addDirectedRelationRow(BatchWriter &out, int start, int dest, int rel, bool right, bool isDirected,
+                                   const RelationView &relation) {
+    RowValue startNodeData = readNodeData(relation.source.address);
+    RowValue destNodeData = readNodeData(relation.destination.address);
+    RowValue relationData = readRelationData(relation);
+    if (right) {
+        addRelationRow(out, start, dest, rel, startNodeData, destNodeData, relationData);
+    } else if (!isDirected) {
+        addRelationRow(out, start, dest, rel, destNodeData, startNodeData, relationData);
+    } else {
+        addRelationRow(out, start, dest, rel, RowValue(), RowValue(), relationData);
     }
+}
 
-    int central = 1;
-    for (long i = 1; i < centralRelationCount; i++) {
-        json startNodeData;
-        json destNodeData;
-        json relationData;
-        RelationBlock* relation = RelationBlock::getCentralRelation(i*RelationBlock::CENTRAL_BLOCK_SIZE);
-        if (relation->getCentralRelationshipType() != query["relType"]) {
-            continue;
-        }
-
-        std::string pid(relation->getMetaPropertyHead()->value);
-        if (pid != to_string(gc.partitionID)) {
-            continue;
-        }
-
-        NodeBlock* startNode = relation->getSource();
-        NodeBlock* destNode = relation->getDestination();
-
-        std::string startPid(startNode->getMetaPropertyHead()->value);
-        startNodeData["partitionID"] = startPid;
-        std::map<std::string, char*> startProperties = startNode->getAllProperties();
-        for (auto property : startProperties) {
-            startNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : startProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        startProperties.clear();
-
-        std::string destPid(destNode->getMetaPropertyHead()->value);
-        destNodeData["partitionID"] = destPid;
-        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-        for (auto property : destProperties) {
-            destNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : destProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        destProperties.clear();
-
-        std::map<std::string, char*> relProperties = relation->getAllProperties();
-        for (auto property : relProperties) {
-            relationData[property.first] = property.second;
-        }
-        for (auto& [key, value] : relProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        relProperties.clear();
-
-        json directionData;
-        string start = query["sourceVariable"];
-        string dest = query["destVariable"];
-        string rel = query["relVariable"];
-
-        if (isDirectionRight) {
-            directionData[start] = startNodeData;
-            directionData[dest] = destNodeData;
-        } else if (!isDirected) {
-            directionData[start] = destNodeData;
-            directionData[dest] = startNodeData;
-        }
-        directionData[rel] = relationData;
-        buffer.add(directionData.dump());
-
-        central++;
+void OperatorExecutor::DirectedRelationshipTypeScan(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    NodeManager &nodeManager = openStore(gc);
+    string relType = query["relType"];
+    string graphDirection = Utils::getGraphDirection(to_string(gc.graphID), masterIP);
+    bool isDirected = false;
+    if (graphDirection == "TRUE") {
+        isDirected = true;
     }
-    buffer.add("-1");
+    RowSchema::Ptr schema = outputSchema(query);
+    int start = schema->slot(query["sourceVariable"]);
+    int dest = schema->slot(query["destVariable"]);
+    int rel = schema->slot(query["relVariable"]);
+    bool right = query["direction"] == "right";
+    std::vector<unsigned int> local = nodeManager.relationTypeIndex->getRelations(relType, false);
+    std::vector<unsigned int> central = nodeManager.relationTypeIndex->getRelations(relType, true);
+    const std::string partitionID = to_string(gc.partitionID);
+    morselScan(buffer, schema, local.size() + central.size(), scanParallelism(), nodeManager, takeFragments(),
+               [&, start, dest, rel, right, isDirected](BatchWriter &out, size_t position) {
+        bool isCentral = position >= local.size();
+        RelationView relation;
+        if (readScannedRelation(isCentral ? central[position - local.size()] : local[position], isCentral,
+                                partitionID, relation)) {
+            addDirectedRelationRow(out, start, dest, rel, right, isDirected, relation);
+        }
+    });
 }
 
-void OperatorExecutor::DirectedAllRelationshipScan(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+void OperatorExecutor::DirectedAllRelationshipScan(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    NodeManager nodeManager(gc);
-    string direction = query["direction"];
+    NodeManager &nodeManager = openStore(gc);
     const std::string& dbPrefix = nodeManager.getDbPrefix();
     long localRelationCount = nodeManager.dbSize(dbPrefix + "_relations.db") / RelationBlock::BLOCK_SIZE;
     long centralRelationCount = nodeManager.dbSize(dbPrefix +
@@ -657,160 +787,49 @@ void OperatorExecutor::DirectedAllRelationshipScan(SharedBuffer &buffer, std::st
     if (graphDirection == "TRUE") {
         isDirected = true;
     }
-    bool isDirectionRight = query["direction"] == "right";
-    int count = 1;
-    for (long i = 1; i < localRelationCount; i++) {
-        json startNodeData;
-        json destNodeData;
-        json relationData;
-        RelationBlock* relation = RelationBlock::getLocalRelation(i * RelationBlock::BLOCK_SIZE);
-        NodeBlock* startNode = relation->getSource();
-        NodeBlock* destNode = relation->getDestination();
-
-        std::string startPid(startNode->getMetaPropertyHead()->value);
-        startNodeData["partitionID"] = startPid;
-        std::map<std::string, char*> startProperties = startNode->getAllProperties();
-        for (auto property : startProperties) {
-            startNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : startProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        startProperties.clear();
-
-        std::string destPid(destNode->getMetaPropertyHead()->value);
-        destNodeData["partitionID"] = destPid;
-        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-        for (auto property : destProperties) {
-            destNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : destProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        destProperties.clear();
-
-        std::map<std::string, char*> relProperties = relation->getAllProperties();
-        for (auto property : relProperties) {
-            relationData[property.first] = property.second;
-        }
-        for (auto& [key, value] : relProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        relProperties.clear();
-
-        json directionData;
-        string start = query["sourceVariable"];
-        string dest = query["destVariable"];
-        string rel = query["relVariable"];
-
-        if (isDirectionRight) {
-            directionData[start] = startNodeData;
-            directionData[dest] = destNodeData;
-        } else if (!isDirected) {
-            directionData[start] = destNodeData;
-            directionData[dest] = startNodeData;
-        }
-        directionData[rel] = relationData;
-        buffer.add(directionData.dump());
-        count++;
-    }
-
-    int central = 1;
-    for (long i = 1; i < centralRelationCount; i++) {
-        json startNodeData;
-        json destNodeData;
-        json relationData;
-        RelationBlock* relation = RelationBlock::getCentralRelation(i * RelationBlock::CENTRAL_BLOCK_SIZE);
-        std::string pid(relation->getMetaPropertyHead()->value);
-        if (pid != to_string(gc.partitionID)) {
-            continue;
-        }
-
-        NodeBlock* startNode = relation->getSource();
-        NodeBlock* destNode = relation->getDestination();
-
-        std::string startPid(startNode->getMetaPropertyHead()->value);
-        startNodeData["partitionID"] = startPid;
-        std::map<std::string, char*> startProperties = startNode->getAllProperties();
-        for (auto property : startProperties) {
-            startNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : startProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        startProperties.clear();
-
-        std::string destPid(destNode->getMetaPropertyHead()->value);
-        destNodeData["partitionID"] = destPid;
-        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-        for (auto property : destProperties) {
-            destNodeData[property.first] = property.second;
-        }
-        for (auto& [key, value] : destProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        destProperties.clear();
-
-        std::map<std::string, char*> relProperties = relation->getAllProperties();
-        for (auto property : relProperties) {
-            relationData[property.first] = property.second;
-        }
-        for (auto& [key, value] : relProperties) {
-            delete[] value;  // Free each allocated char* array
-        }
-        relProperties.clear();
-
-        json directionData;
-        string start = query["sourceVariable"];
-        string dest = query["destVariable"];
-        string rel = query["relVariable"];
-
-        if (isDirectionRight) {
-            directionData[start] = startNodeData;
-            directionData[dest] = destNodeData;
-        } else if (!isDirected) {
-            directionData[start] = destNodeData;
-            directionData[dest] = startNodeData;
-        }
-        directionData[rel] = relationData;
-        buffer.add(directionData.dump());
-
-        central++;
-    }
-    buffer.add("-1");
+    RowSchema::Ptr schema = outputSchema(query);
+    int start = schema->slot(query["sourceVariable"]);
+    int dest = schema->slot(query["destVariable"]);
+    int rel = schema->slot(query["relVariable"]);
+    bool right = query["direction"] == "right";
+    size_t local = std::max(localRelationCount - 1, 0L);
+    size_t central = std::max(centralRelationCount - 1, 0L);
+    const std::string partitionID = to_string(gc.partitionID);
+    morselScan(buffer, schema, local + central, scanParallelism(), nodeManager, takeFragments(),
+               [&partitionID, local, start, dest, rel, right, isDirected](BatchWriter &out, size_t position) {
+        bool isCentral = position >= local;
+        RelationView relation;
+        if (readScannedRelation(isCentral ? position - local + 1 : position + 1, isCentral, partitionID, relation)) {
+            addDirectedRelationRow(out, start, dest, rel, right, isDirected, relation);
+        }
+    });
 }
 
-void OperatorExecutor::NodeByIdSeek(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+void OperatorExecutor::NodeByIdSeek(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    NodeManager nodeManager(gc);
+    NodeManager &nodeManager = openStore(gc);
+    BatchWriter out(buffer, outputSchema(query));
     NodeBlock* node = nodeManager.get(query["id"]);
     if (node) {
-        json nodeData;
-        std::string value(node->getMetaPropertyHead()->value);
-        if (value == to_string(gc.partitionID)) {
-            std::map<std::string, char*> properties = node->getAllProperties();
-            nodeData["partitionID"] = value;
-            for (auto property : properties) {
-                nodeData[property.first] = property.second;
-            }
-            json data;
-            string variable = query["variable"];
-            data[variable] = nodeData;
-            buffer.add(data.dump());
-        }
+        addNodeScanRow(out, node, out.schema()->slot(query["variable"]), gc);
+        delete node;
     }
-    buffer.add("-1");
+    out.close();
 }
 
-void OperatorExecutor::ExpandAll(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+/**
+ * Expansion of a node of another partition, its relations and end nodes are asked from the worker of the partition
+ * */
+struct RemoteExpansion {
+    std::string partitionID;
+    std::string nodeId;
+    std::vector<std::pair<RowValue, RowValue>> rows;  // Relation and end node of every expanded row
+    std::shared_ptr<TaskPool::Task> request;
+};
+
+void OperatorExecutor::ExpandAll(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    SharedBuffer sharedBuffer(INTER_OPERATOR_BUFFER_SIZE);
     std::string nextOpt = query["NextOperator"];
-    json next = json::parse(nextOpt);
-    auto method = OperatorExecutor::methodMap[next["Operator"]];
-    // Launch the method in a new thread
-    std::thread result(method, std::ref(*this), std::ref(sharedBuffer), query["NextOperator"], gc);
-
     string sourceVariable = query["sourceVariable"];
     string destVariable = query["destVariable"];
     string relVariable = query["relVariable"];
@@ -824,462 +843,445 @@ void OperatorExecutor::ExpandAll(SharedBuffer &buffer, std::string jsonPlan, Gra
     if (graphDirection == "TRUE") {
         isDirected = true;
     }
-    bool isDirectionRight = false;
-    if (query.contains("direction")) {
-        isDirectionRight = query["direction"] == "right";
-    }
 
-    string queryString;
-
-    NodeManager nodeManager(gc);
-
-    while (true) {
-        string raw = sharedBuffer.get();
-        if (raw == "-1") {
-            buffer.add(raw);
-            result.join();
-            break;
+    NodeManager &nodeManager = openStore(gc);
+    // Relations are matched on the type ID kept in their block, -1 if no relation of the partition has the type
+    int relTypeId = relType == "" ? 0 : nodeManager.relationTypeIndex->typeId(relType, false);
+    // Directed patterns only read the outgoing relation chains of the nodes
+    RelationDirection direction = isDirected ? RelationDirection::OUTGOING : RelationDirection::BOTH;
+
+    RowSchema::Ptr schema = outputSchema(query);
+    int sourceSlot = schema->slot(sourceVariable);
+    int relSlot = schema->slot(relVariable);
+    int destSlot = schema->slot(destVariable);
+    const std::string localPartition = to_string(gc.partitionID);
+    // Ask the worker of the partition for the expansion of a node. Rows of other workers are exchanged as JSON.
+    auto requestExpansion = [&](RemoteExpansion &remote) {
+        remote.request = TaskPool::getInstance().submit([&, expansion = &remote]() {
+            string queryString = ExpandAllHelper::generateSubQuery(sourceVariable, destVariable, relVariable,
+                                                                   isDirected, expansion->nodeId, relType);
+            string queryPlan = ExpandAllHelper::generateSubQueryPlan(queryString);
+            TaskPool::Blocking blocking;
+            try {
+                Utils::sendDataFromWorkerToWorker(masterIP, gc.graphID, expansion->partitionID, queryPlan,
+                                                  [expansion, &relVariable, &destVariable](std::string &raw) {
+                    json tmpData = json::parse(raw);
+                    expansion->rows.emplace_back(RowBatch::fromJson(tmpData[relVariable]),
+                                                 RowBatch::fromJson(tmpData[destVariable]));
+                });
+            } catch (const std::exception &e) {  // The pool thread must not end on a malformed row
+                execution_logger.error("Expansion of node " + expansion->nodeId + " of partition " +
+                                       expansion->partitionID + " failed: " + e.what());
+            }
+        });
+    };
+    // Runs in the scan threads below, everything it shares is only read
+    runPipeline(nextOpt, gc, buffer, schema, [&](RowBatch &input, BatchWriter &out) {
+        // Nodes of other partitions are asked for once per batch, the requests run on the TaskPool while the local
+        // nodes are expanded and at most REMOTE_EXPAND_REQUESTS of them are in flight
+        std::vector<RemoteExpansion> remotes;
+        std::map<std::pair<std::string, std::string>, size_t> remoteIndex;
+        std::vector<long> remoteOfRow(input.size(), -1);
+        for (size_t row = 0; row < input.size(); row++) {
+            auto source = RowBatch::entity(input.get(row, sourceSlot));
+            const std::string *nodeId = source ? source->property("id") : NULL;
+            const std::string *partitionID = source ? source->property("partitionID") : NULL;
+            if (!nodeId || !partitionID || *partitionID == localPartition) {
+                continue;
+            }
+            auto found = remoteIndex.emplace(std::make_pair(*partitionID, *nodeId), remotes.size());
+            if (found.second) {
+                remotes.push_back({*partitionID, *nodeId, {}, nullptr});
+            }
+            remoteOfRow[row] = found.first->second;
+        }
+        for (size_t i = 0; i < remotes.size() && i < REMOTE_EXPAND_REQUESTS; i++) {
+            requestExpansion(remotes[i]);
         }
-        json rawObj = json::parse(raw);
-        string nodeId = rawObj[sourceVariable]["id"];
-        if (rawObj[sourceVariable]["partitionID"] == to_string(gc.partitionID)) {
-            NodeBlock* node = nodeManager.get(nodeId);
-            if (node) {
-                RelationBlock *relation = RelationBlock::getLocalRelation(node->edgeRef);
-                if (relation) {
-                    RelationBlock *nextRelation = relation;
-                    bool isSource;
-                    while (nextRelation) {
-                        if (to_string(nextRelation->source.nodeId) == nodeId) {
-                            isSource = true;
-                        } else {
-                            isSource = false;
-                        }
-
-                        json relationData;
-                        json destNodeData;
-                        std::map<std::string, char*> relProperties = nextRelation->getAllProperties();
-                        for (auto property : relProperties) {
-                            relationData[property.first] = property.second;
-                        }
-
-                        if (relType != "" && relationData["relationship"] != relType) {
-                            if (isSource) {
-                                nextRelation = nextRelation->nextLocalSource();
-                            } else {
-                                nextRelation = nextRelation->nextLocalDestination();
-                            }
-                            continue;
-                        }
-                        if (isDirected && !isSource) {
-                            nextRelation = nextRelation->nextLocalDestination();
-                            continue;
-                        }
-                        for (auto& [key, value] : relProperties) {
-                            delete[] value;  // Free each allocated char* array
-                        }
-                        relProperties.clear();
-                        NodeBlock *destNode;
-                        if (isSource) {
-                            destNode = nextRelation->getDestination();
-                        } else {
-                            destNode = nextRelation->getSource();
-                        }
-                        std::string value(destNode->getMetaPropertyHead()->value);
-                        destNodeData["partitionID"] = value;
-                        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-                        for (auto property : destProperties) {
-                            destNodeData[property.first] = property.second;
-                        }
-                        for (auto& [key, value] : destProperties) {
-                            delete[] value;  // Free each allocated char* array
-                        }
-                        destProperties.clear();
-                        rawObj[relVariable] = relationData;
-                        rawObj[destVariable] = destNodeData;
-
-                        buffer.add(rawObj.dump());
-                        if (isSource) {
-                            nextRelation = nextRelation->nextLocalSource();
-                        } else {
-                            nextRelation = nextRelation->nextLocalDestination();
-                        }
-                    }
-                }
 
-                relation = RelationBlock::getCentralRelation(node->centralEdgeRef);
-                if (relation) {
-                    RelationBlock *nextRelation = relation;
-                    bool isSource;
-
-                    while (nextRelation) {
-                        if (to_string(nextRelation->source.nodeId) == nodeId) {
-                            isSource = true;
-                        } else {
-                            isSource = false;
-                        }
-
-                        json relationData;
-                        json destNodeData;
-                        std::map<std::string, char*> relProperties = nextRelation->getAllProperties();
-                        for (auto property : relProperties) {
-                            relationData[property.first] = property.second;
-                        }
-
-                        if (relType != "" && relationData["relationship"] != relType) {
-                            if (isSource) {
-                                nextRelation = nextRelation->nextCentralSource();
-                            } else {
-                                nextRelation = nextRelation->nextCentralDestination();
-                            }
-                            continue;
-                        }
-
-                        if (isDirected && !isSource) {
-                            nextRelation = nextRelation->nextCentralDestination();
-                            continue;
-                        }
-
-                        for (auto& [key, value] : relProperties) {
-                            delete[] value;  // Free each allocated char* array
-                        }
-                        relProperties.clear();
-                        NodeBlock *destNode;
-                        if (isSource) {
-                            destNode = nextRelation->getDestination();
-                        } else {
-                            destNode = nextRelation->getSource();
-                        }
-                        std::string value(destNode->getMetaPropertyHead()->value);
-                        destNodeData["partitionID"] = value;
-                        std::map<std::string, char*> destProperties = destNode->getAllProperties();
-                        for (auto property : destProperties) {
-                            destNodeData[property.first] = property.second;
-                        }
-                        for (auto& [key, value] : destProperties) {
-                            delete[] value;  // Free each allocated char* array
-                        }
-                        destProperties.clear();
-                        rawObj[relVariable] = relationData;
-                        rawObj[destVariable] = destNodeData;
-                        buffer.add(rawObj.dump());
-                        if (isSource) {
-                            nextRelation = nextRelation->nextCentralSource();
-                        } else {
-                            nextRelation = nextRelation->nextCentralDestination();
-                        }
+        // Rows are expanded in input order, requests are joined in the order they were made
+        size_t joined = 0;
+        for (size_t row = 0; row < input.size(); row++) {
+            if (remoteOfRow[row] >= 0) {
+                size_t index = remoteOfRow[row];
+                for (; joined <= index; joined++) {
+                    remotes[joined].request->join();
+                    if (joined + REMOTE_EXPAND_REQUESTS < remotes.size()) {
+                        requestExpansion(remotes[joined + REMOTE_EXPAND_REQUESTS]);
                     }
                 }
+                for (const auto &expandedRow : remotes[index].rows) {
+                    size_t expanded = out.addRow(input, row);
+                    out.batch().set(expanded, relSlot, expandedRow.first);
+                    out.batch().set(expanded, destSlot, expandedRow.second);
+                }
+                continue;
             }
-        } else {
-            if (query.contains("relType")) {
-                queryString = ExpandAllHelper::generateSubQuery(query["sourceVariable"],
-                                                                query["destVariable"],
-                                                                query["relVariable"],
-                                                                isDirected,
-                                                                rawObj[sourceVariable]["id"],
-                                                                query["relType"]);
-            } else {
-                queryString = ExpandAllHelper::generateSubQuery(query["sourceVariable"],
-                                                                query["destVariable"],
-                                                                query["relVariable"],
-                                                                isDirected,
-                                                                rawObj[sourceVariable]["id"]);
+            auto source = RowBatch::entity(input.get(row, sourceSlot));
+            const std::string *nodeId = source ? source->property("id") : NULL;
+            const std::string *partitionID = source ? source->property("partitionID") : NULL;
+            if (!nodeId || !partitionID) {
+                continue;
             }
-            string queryPlan = ExpandAllHelper::generateSubQueryPlan(queryString);
-            SharedBuffer temp(INTER_OPERATOR_BUFFER_SIZE);
-            std::thread t(Utils::sendDataFromWorkerToWorker,
-                          masterIP,
-                          gc.graphID,
-                          rawObj[sourceVariable]["partitionID"],
-                          std::ref(queryPlan),
-                          std::ref(temp));
-            while (true) {
-                string tmpRaw = temp.get();
-                if (tmpRaw == "-1") {
-                    t.join();
-                    break;
-                }
-                json tmpData = json::parse(tmpRaw);
-                rawObj[relVariable] = tmpData[relVariable];
-                rawObj[destVariable] = tmpData[destVariable];
-                buffer.add(rawObj.dump());
+            NodeBlock* node = nodeManager.get(*nodeId);
+            if (!node) {
+                continue;
+            }
+            for (bool central : {false, true}) {
+                nodeManager.forEachNeighbor(node->addr, central, direction, [&](const RelationView &relation) {
+                    if (relType != "" && (int)relation.typeId != relTypeId) {
+                        return;
+                    }
+                    size_t expanded = out.addRow(input, row);
+                    out.batch().set(expanded, relSlot, readRelationData(relation));
+                    out.batch().set(expanded, destSlot, readNodeData(relation.neighborAddress()));
+                });
             }
+            delete node;
         }
-    }
+    });
 }
 
-void OperatorExecutor::AggregationFunction(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+void OperatorExecutor::AggregationFunction(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    SharedBuffer sharedBuffer(INTER_OPERATOR_BUFFER_SIZE);
     std::string nextOpt = query["NextOperator"];
     json next = json::parse(nextOpt);
-    auto method = OperatorExecutor::methodMap[next["Operator"]];
-    // Launch the method in a new thread
-    std::thread result(method, std::ref(*this), std::ref(sharedBuffer), query["NextOperator"], gc);
-    AverageAggregationHelper* averageAggregationHelper =
-            new AverageAggregationHelper(query["variable"], query["property"]);
-    while (true) {
-        string raw = sharedBuffer.get();
-        if (raw == "-1") {
-            buffer.add(averageAggregationHelper->getFinalResult());
-            buffer.add(raw);
-            result.join();
-            break;
+    AverageAggregationHelper averageAggregationHelper(query["variable"], query["property"]);
+    int slot = outputSchema(next)->slot(query["variable"]);
+    runPipeline(nextOpt, gc, [&averageAggregationHelper, slot](RowBatch &input) {
+        for (size_t row = 0; slot >= 0 && row < input.size(); row++) {
+            averageAggregationHelper.insertData(input.get(row, slot));
+        }
+    });
+    BatchWriter out(buffer, outputSchema(query));
+    out.batch().set(out.addRow(), averageAggregationHelper.getFinalResult());
+    out.close();
+}
+
+struct ProjectedSlot {
+    int input;
+    int assign;
+    std::string property;
+    bool function;
+    json assignName;
+};
+
+/**
+ * Slots bound by the "project" operands of a Projection or Distinct. Operands of a variable bind a property of the
+ * entity, operands of a function bind its value and "variable" to the assigned name.
+ * */
+static std::vector<ProjectedSlot> projectedSlots(const json &query, const RowSchema::Ptr &inputSchema,
+                                                 const RowSchema::Ptr &schema) {
+    std::vector<ProjectedSlot> projected;
+    if (query.contains("project") && query["project"].is_array()) {
+        for (const auto& operand : query["project"]) {
+            if (operand.contains("variable") && inputSchema->slot(operand["variable"]) >= 0) {
+                projected.push_back({inputSchema->slot(operand["variable"]), schema->slot(operand["assign"]),
+                                     operand["property"].get<std::string>(), false, operand["assign"]});
+            } else if (operand.contains("functionName") && inputSchema->slot(operand["functionName"]) >= 0) {
+                projected.push_back({inputSchema->slot(operand["functionName"]),
+                                     schema->slot(operand["assign"]), "", true, operand["assign"]});
+            }
         }
-        averageAggregationHelper->insertData(raw);
     }
+    return projected;
 }
 
-void OperatorExecutor::Projection(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+/**
+ * Bind the projected slots of every row of a batch of the input
+ * */
+static void projectRows(const std::vector<ProjectedSlot> &projected, const RowBatch &batch, BatchWriter &out) {
+    int variableSlot = out.schema()->slot("variable");
+    for (size_t row = 0; row < batch.size(); row++) {
+        size_t projectedRow = out.addRow(batch, row);
+        for (const auto &slot : projected) {
+            const RowValue &value = batch.get(row, slot.input);
+            if (slot.function) {
+                out.batch().set(projectedRow, variableSlot, slot.assignName.get<std::string>());
+                out.batch().set(projectedRow, slot.assign, value);
+                continue;
+            }
+            auto entity = RowBatch::entity(value);
+            const std::string *property = entity ? entity->property(slot.property) : NULL;
+            out.batch().set(projectedRow, slot.assign, property ? RowValue(*property) : RowValue());
+        }
+    }
+}
+
+void OperatorExecutor::Projection(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    SharedBuffer sharedBuffer(INTER_OPERATOR_BUFFER_SIZE);
     std::string nextOpt = query["NextOperator"];
     json next = json::parse(nextOpt);
-    auto method = OperatorExecutor::methodMap[next["Operator"]];
-
-    // Launch the method in a new thread
-    std::thread result(method, std::ref(*this), std::ref(sharedBuffer), query["NextOperator"], gc);
-    if (!query.contains("project") || !query["project"].is_array()) {
-        while (true) {
-            string raw = sharedBuffer.get();
-            buffer.add(raw);
-            if (raw == "-1") {
-                result.join();
-                break;
-            }
+    RowSchema::Ptr schema = outputSchema(query);
+    std::vector<ProjectedSlot> projected = projectedSlots(query, outputSchema(next), schema);
+    runPipeline(nextOpt, gc, buffer, schema,
+                [&projected](RowBatch &input, BatchWriter &out) { projectRows(projected, input, out); });
+}
+
+void OperatorExecutor::Create(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+    json query = json::parse(jsonPlan);
+    string partitionAlgo = Utils::getPartitionAlgorithm(to_string(gc.graphID), masterIP);
+    CreateHelper createHelper(query["elements"], partitionAlgo, gc, masterIP);
+    BatchWriter out(buffer, outputSchema(query));
+    std::vector<json> created;
+    auto addCreatedRows = [&out, &created]() {
+        for (const auto &data : created) {
+            out.batch().set(out.addRow(), data);
         }
-    } else {
-        while (true) {
-            string raw = sharedBuffer.get();
-            if (raw == "-1") {
-                buffer.add(raw);
-                result.join();
-                break;
-            }
-            auto data = json::parse(raw);
-            for (const auto& operand : query["project"]) {
-                for (auto& [key, value] : data.items()) {
-                    if (operand.contains("variable") && key == operand["variable"]) {
-                        string assign = operand["assign"];
-                        string property = operand["property"];
-                        data[assign] = value[property];
-                    } else if (operand.contains("functionName") && key == operand["functionName"]) {
-                        string assign = operand["assign"];
-                        data["variable"] = assign;
-                        data[assign] = value;
-                    }
-                }
+        created.clear();
+    };
+    NodeManager &nodeManager = openStore(gc);
+    if (query.contains("NextOperator")) {
+        std::string nextOpt = query["NextOperator"];
+        runPipeline(nextOpt, gc, [&](RowBatch &input) {
+            for (size_t row = 0; row < input.size(); row++) {
+                createHelper.insertFromData(nodeManager, input.toJson(row), created);
+                addCreatedRows();
             }
-            buffer.add(data.dump());
+        });
+    } else {
+        createHelper.insertWithoutData(nodeManager, created);
+        addCreatedRows();
+    }
+    out.close();
+}
+
+/**
+ * Find the source and destination variables of the relationship scan or expansion that binds a relationship variable
+ * in the plan below an operator
+ * */
+static bool findRelationshipEnds(const json &plan, const std::string &variable, std::string &source,
+                                 std::string &destination) {
+    if (plan.contains("relVariable") && plan["relVariable"] == variable) {
+        source = plan["sourceVariable"];
+        destination = plan["destVariable"];
+        return true;
+    }
+    for (const char *input : {"NextOperator", "left", "right"}) {
+        if (plan.contains(input) && plan[input].is_string() &&
+            findRelationshipEnds(json::parse(plan[input].get<std::string>()), variable, source, destination)) {
+            return true;
         }
     }
+    return false;
 }
 
-void OperatorExecutor::Create(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+/**
+ * Property of the entity bound to a slot of a row, NULL if the slot is missing or not bound to an entity
+ * */
+static const std::string *entityProperty(const RowBatch &batch, size_t row, int slot, const std::string &name) {
+    if (slot < 0) {
+        return NULL;
+    }
+    auto entity = RowBatch::entity(batch.get(row, slot));
+    return entity ? entity->property(name) : NULL;
+}
+
+/**
+ * Delete the nodes and relationships bound to the variables of every input row. A node is deleted by the partition
+ * that owns it, a relationship by the partition that holds its relation block. Produces one row with the numbers of
+ * deleted nodes and relationships of this partition.
+ * */
+void OperatorExecutor::Delete(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    SharedBuffer sharedBuffer(INTER_OPERATOR_BUFFER_SIZE);
-    string partitionAlgo = Utils::getPartitionAlgorithm(to_string(gc.graphID), masterIP);
-    CreateHelper createHelper(query["elements"], partitionAlgo, gc, masterIP);
+    std::vector<std::string> variables = query["variables"];
+    bool detach = query["detach"];
+    std::map<std::string, std::pair<std::string, std::string>> relationshipEnds;
+    for (auto &variable : variables) {
+        std::string source;
+        std::string destination;
+        if (findRelationshipEnds(query, variable, source, destination)) {
+            relationshipEnds[variable] = {source, destination};
+        }
+    }
+
+    NodeManager &nodeManager = openStore(gc);
+    long deletedNodes = 0;
+    long deletedRelationships = 0;
     if (query.contains("NextOperator")) {
         std::string nextOpt = query["NextOperator"];
         json next = json::parse(nextOpt);
-        auto method = OperatorExecutor::methodMap[next["Operator"]];
-        // Launch the method in a new thread
-        std::thread result(method, std::ref(*this), std::ref(sharedBuffer), query["NextOperator"], gc);
-        while (true) {
-            string raw = sharedBuffer.get();
-            if (raw == "-1") {
-                buffer.add(raw);
-                result.join();
-                break;
+        RowSchema::Ptr inputSchema = outputSchema(next);
+        std::vector<std::pair<int, int>> relationshipSlots;
+        for (auto &[variable, ends] : relationshipEnds) {
+            relationshipSlots.emplace_back(inputSchema->slot(ends.first), inputSchema->slot(ends.second));
+        }
+        std::vector<int> nodeSlots;
+        for (auto &variable : variables) {
+            if (!relationshipEnds.count(variable)) {
+                nodeSlots.push_back(inputSchema->slot(variable));
             }
-            createHelper.insertFromData(raw, std::ref(buffer));
         }
-    } else {
-        createHelper.insertWithoutData(std::ref(buffer));
-        buffer.add("-1");
+        runPipeline(nextOpt, gc, [&](RowBatch &input) {
+            for (size_t row = 0; row < input.size(); row++) {
+                // Relationships first, a node of the same row is then deleted without DETACH
+                for (auto &[sourceSlot, destinationSlot] : relationshipSlots) {
+                    const std::string *source = entityProperty(input, row, sourceSlot, "id");
+                    const std::string *destination = entityProperty(input, row, destinationSlot, "id");
+                    if (!source || !destination) {
+                        continue;
+                    }
+                    // An undirected scan binds the ends of a relationship in either order
+                    if (nodeManager.deleteEdge(*source, *destination) ||
+                        nodeManager.deleteEdge(*destination, *source)) {
+                        deletedRelationships++;
+                    }
+                }
+                for (int slot : nodeSlots) {
+                    const std::string *id = entityProperty(input, row, slot, "id");
+                    const std::string *partitionID = entityProperty(input, row, slot, "partitionID");
+                    if (!id || !partitionID || *partitionID != to_string(gc.partitionID)) {
+                        continue;
+                    }
+                    if (nodeManager.deleteNode(*id, detach)) {
+                        deletedNodes++;
+                    }
+                }
+            }
+        });
     }
+    BatchWriter out(buffer, outputSchema(query));
+    size_t row = out.addRow();
+    out.batch().set(row, out.schema()->slot("partitionID"), to_string(gc.partitionID));
+    out.batch().set(row, out.schema()->slot("deletedNodes"), (long long)deletedNodes);
+    out.batch().set(row, out.schema()->slot("deletedRelationships"), (long long)deletedRelationships);
+    out.close();
 }
 
-void OperatorExecutor::CartesianProduct(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+/**
+ * Rows of every left row combined with every right row. The right rows of all partitions are the same for each left
+ * row, they are read once before the left rows.
+ * */
+void OperatorExecutor::CartesianProduct(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    SharedBuffer left(INTER_OPERATOR_BUFFER_SIZE);
-    SharedBuffer right(INTER_OPERATOR_BUFFER_SIZE);
     std::string leftOpt = query["left"];
     std::string rightOpt = query["right"];
-    json leftJson = json::parse(leftOpt);
     json rightJson = json::parse(rightOpt);
-    auto leftMethod = OperatorExecutor::methodMap[leftJson["Operator"]];
-    auto rightMethod = OperatorExecutor::methodMap[rightJson["Operator"]];
-    // Launch the method in a new thread
-    std::thread leftThread(leftMethod, std::ref(*this), std::ref(left), query["left"], gc);
-    while (true) {
-        string leftRaw = left.get();
-        if (leftRaw == "-1") {
-            buffer.add(leftRaw);
-            leftThread.join();
-            break;
+    RowSchema::Ptr rightSchema = outputSchema(rightJson);
+
+    string partitionCount = Utils::getJasmineGraphProperty("org.jasminegraph.server.npartitions");
+    int numberOfPartitions = std::stoi(partitionCount);
+    // Rows of the other workers are exchanged as JSON, each worker's rows are fetched by a task of the pool while the
+    // local right rows are read
+    std::vector<std::vector<RowBatch>> remote(numberOfPartitions);
+    std::vector<std::shared_ptr<TaskPool::Task>> fetches;
+    for (int i = 0; i < numberOfPartitions; i++) {
+        if (i == gc.partitionID) {
+            continue;
         }
+        fetches.push_back(TaskPool::getInstance().submit(
+                [this, gc, i, &rightOpt, &rightSchema, &batches = remote[i]]() {
+            TaskPool::Blocking blocking;
+            batches.emplace_back(rightSchema);
+            Utils::sendDataFromWorkerToWorker(masterIP, gc.graphID, to_string(i), rightOpt,
+                                              [&batches, &rightSchema](std::string &raw) {
+                if (batches.back().full()) {
+                    batches.emplace_back(rightSchema);
+                }
+                batches.back().set(batches.back().append(), json::parse(raw));
+            });
+        }));
+    }
 
-        string partitionCount = Utils::getJasmineGraphProperty("org.jasminegraph.server.npartitions");
-        int numberOfPartitions = std::stoi(partitionCount);
-        std::vector<std::thread> workerThreads;
-
-        for (int i = 0; i < numberOfPartitions; i++) {
-            if (i == gc.partitionID) {
-                continue;
-            }
-            workerThreads.emplace_back(
-                    Utils::sendDataFromWorkerToWorker,
-                    masterIP,
-                    gc.graphID,
-                    to_string(i),
-                    query["right"],
-                    std::ref(right));
+    std::vector<RowBatch> rightRows;
+    runPipeline(rightOpt, gc, [&rightRows](RowBatch &batch) { rightRows.push_back(std::move(batch)); });
+    // A fetch that no thread has taken yet runs here
+    for (auto &fetch : fetches) {
+        fetch->join();
+    }
+    for (auto &workerRows : remote) {
+        for (auto &batch : workerRows) {
+            rightRows.push_back(std::move(batch));
         }
+    }
 
-        std::thread rightThread(rightMethod, std::ref(*this), std::ref(right), query["right"], gc);
-        int count = 0;
-        while (true) {
-            string rightRaw = right.get();
-            if (rightRaw == "-1") {
-                count++;
-                if (count == numberOfPartitions) {
-                    buffer.add("-1");
-                    rightThread.join();
-                    for (auto& t : workerThreads) {
-                        if (t.joinable()) {
-                            t.join();
-                        }
+    BatchWriter out(buffer, outputSchema(query));
+    // Right variables also bound on the left take the right value
+    std::vector<int> rightSlots;
+    for (auto &variable : rightSchema->variables()) {
+        rightSlots.push_back(out.schema()->slot(variable));
+    }
+    runPipeline(leftOpt, gc, [&](RowBatch &leftRows) {
+        for (size_t leftRow = 0; leftRow < leftRows.size(); leftRow++) {
+            for (const auto &rightBatch : rightRows) {
+                for (size_t rightRow = 0; rightRow < rightBatch.size(); rightRow++) {
+                    size_t row = out.addRow(leftRows, leftRow);
+                    for (size_t slot = 0; slot < rightSlots.size(); slot++) {
+                        out.batch().set(row, rightSlots[slot], rightBatch.get(rightRow, slot));
                     }
                 }
-                continue;
-            }
-
-
-
-            json leftData = json::parse(leftRaw);
-            json rightData = json::parse(rightRaw);
-
-            for (auto& [key, value] : rightData.items()) {
-                leftData[key] = value;
             }
-            buffer.add(leftData.dump());
         }
-    }
+    });
+    out.close();
 }
 
-void OperatorExecutor::Distinct(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+void OperatorExecutor::Distinct(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    SharedBuffer sharedBuffer(INTER_OPERATOR_BUFFER_SIZE);
     std::string nextOpt = query["NextOperator"];
     json next = json::parse(nextOpt);
-    auto method = OperatorExecutor::methodMap[next["Operator"]];
-
-    // Launch the method in a new thread
-    std::thread result(method, std::ref(*this), std::ref(sharedBuffer), query["NextOperator"], gc);
-    if (!query.contains("project") || !query["project"].is_array()) {
-        while (true) {
-            string raw = sharedBuffer.get();
-            buffer.add(raw);
-            if (raw == "-1") {
-                result.join();
-                break;
-            }
-        }
-    } else {
-        while (true) {
-            string raw = sharedBuffer.get();
-            if (raw == "-1") {
-                buffer.add(raw);
-                result.join();
-                break;
-            }
-            auto data = json::parse(raw);
-            for (const auto& operand : query["project"]) {
-                for (auto& [key, value] : data.items()) {
-                    if (operand.contains("variable") && key == operand["variable"]) {
-                        string assign = operand["assign"];
-                        string property = operand["property"];
-                        data[assign] = value[property];
-                    } else if (operand.contains("functionName") && key == operand["functionName"]) {
-                        string assign = operand["assign"];
-                        data["variable"] = assign;
-                        data[assign] = value;
-                    }
-                }
-            }
-            buffer.add(data.dump());
-        }
-    }
+    RowSchema::Ptr schema = outputSchema(query);
+    std::vector<ProjectedSlot> projected = projectedSlots(query, outputSchema(next), schema);
+    runPipeline(nextOpt, gc, buffer, schema,
+                [&projected](RowBatch &input, BatchWriter &out) { projectRows(projected, input, out); });
 }
 
-struct Row {
-    json data;
-    std::string jsonStr;
-    std::string sortKey;
+struct OrderedRow {
+    RowValue key;
+    std::vector<RowValue> values;
     bool isAsc;
 
-    Row(const std::string& str, const std::string& key, bool asc)
-        : jsonStr(str), sortKey(key), isAsc(asc) {
-        data = json::parse(str);
-    }
-
-    bool operator<(const Row& other) const {
-        const auto& val1 = data[sortKey];
-        const auto& val2 = other.data[sortKey];
+    bool operator<(const OrderedRow& other) const {
+        const long long *int1 = std::get_if<long long>(&key);
+        const long long *int2 = std::get_if<long long>(&other.key);
+        const std::string *str1 = std::get_if<std::string>(&key);
+        const std::string *str2 = std::get_if<std::string>(&other.key);
 
         bool result;
-        if (val1.is_number_integer() && val2.is_number_integer()) {
-            result = val1.get<int>() > val2.get<int>();
-        } else if (val1.is_string() && val2.is_string()) {
-            result = val1.get<std::string>() > val2.get<std::string>();
+        if (int1 && int2) {
+            result = *int1 > *int2;
+        } else if (str1 && str2) {
+            result = *str1 > *str2;
         } else {
-            result = val1.dump() > val2.dump();
+            result = RowBatch::toJson(key).dump() > RowBatch::toJson(other.key).dump();
         }
         return isAsc ? result : !result;  // Flip for DESC
     }
 };
 
-void OperatorExecutor::OrderBy(SharedBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
+void OperatorExecutor::OrderBy(BatchBuffer &buffer, std::string jsonPlan, GraphConfig gc) {
     json query = json::parse(jsonPlan);
-    SharedBuffer sharedBuffer(INTER_OPERATOR_BUFFER_SIZE);
     std::string nextOpt = query["NextOperator"];
-    json next = json::parse(nextOpt);
-    auto method = OperatorExecutor::methodMap[next["Operator"]];
-
-    // Launch the method in a new thread
-    std::thread result(method, std::ref(*this), std::ref(sharedBuffer), query["NextOperator"], gc);
-
     std::string sortKey = query["variable"];
     std::string order = query["order"];
     const size_t MAX_SIZE = 5000;
     bool isAsc = (order == "ASC");
 
-    std::priority_queue<Row> heap;
-    while (true) {
-        std::string jsonStr = sharedBuffer.get();
-        if (jsonStr == "-1") {
-            while (!heap.empty()) {
-                buffer.add(heap.top().jsonStr);
-                heap.pop();
+    BatchWriter out(buffer, outputSchema(query));
+    int keySlot = out.schema()->slot(sortKey);
+    std::priority_queue<OrderedRow> heap;
+    runPipeline(nextOpt, gc, [&](RowBatch &input) {
+        for (size_t row = 0; keySlot >= 0 && row < input.size(); row++) {
+            if (input.get(row, keySlot).index() == 0) {  // Ensure field exists
+                continue;
             }
-            buffer.add(jsonStr);  // -1 close flag
-            result.join();
-            break;
-        }
-
-        try {
-            Row row(jsonStr, sortKey, isAsc);
-            if (row.data.contains(sortKey)) {  // Ensure field exists
-                heap.push(row);
-                if (heap.size() > MAX_SIZE) {
-                    heap.pop();  // Remove smallest (ASC) or largest (DESC)
-                }
+            OrderedRow ordered{input.get(row, keySlot), {}, isAsc};
+            for (size_t slot = 0; slot < input.schema()->size(); slot++) {
+                ordered.values.push_back(input.get(row, slot));
             }
-        } catch (const std::exception& e) {
-            std::cerr << "Error parsing JSON: " << e.what() << "\n";
+            heap.push(std::move(ordered));
+            if (heap.size() > MAX_SIZE) {
+                heap.pop();  // Remove smallest (ASC) or largest (DESC)
+            }
+        }
+    });
+    while (!heap.empty()) {
+        size_t row = out.addRow();
+        const std::vector<RowValue> &values = heap.top().values;
+        for (size_t slot = 0; slot < values.size(); slot++) {
+            out.batch().set(row, slot, values[slot]);
         }
+        heap.pop();
     }
+    out.close();
 }
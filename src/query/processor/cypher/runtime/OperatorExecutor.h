@@ -15,39 +15,92 @@ limitations under the License.
 #define JASMINEGRAPH_OPERATOREXECUTOR_H
 #include "../../../../nativestore/NodeManager.h"
 #include "InstanceHandler.h"
-#include "../util/SharedBuffer.h"
+#include "../util/RowBatch.h"
+#include "../util/TaskPool.h"
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 using namespace  std;
 
+/**
+ * Runs the operator plan of a query on this worker. The operators of a plan form one pipeline that runs on a single
+ * thread: every operator runs its input operator with runPipeline and handles each batch the input produces before
+ * the input goes on. Work that runs in parallel, such as scan morsels and the sub queries sent to other workers, goes
+ * to the shared TaskPool. Streaming operators that only look at one row at a time leave their batches to fragments,
+ * which a morsel scan below them runs in each of its scan threads.
+ * */
 class OperatorExecutor {
  public:
+    /**
+     * A streaming operator as a step of the pipeline: process adds the rows the operator makes of an input batch to
+     * the writer. Filter, Projection, Distinct, ExpandAll and ProduceResult register it before they run their input, a
+     * morsel scan below them then runs the steps on the rows of every morsel in the thread that scanned it, and its
+     * rows reach the output buffer of the outermost step without passing through the pipeline thread one by one.
+     * */
+    struct Fragment {
+        std::function<void(RowBatch &, BatchWriter &)> process;
+        RowSchema::Ptr schema;  // Rows the operator produces
+        BatchBuffer *output;    // Buffer the operator adds its rows to
+    };
+
     OperatorExecutor(GraphConfig gc, string queryPlan, string masterIP);
-    void AllNodeScan(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void NodeScanByLabel(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void ProduceResult(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void Filter(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void ExpandAll(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void UndirectedRelationshipTypeScan(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void UndirectedAllRelationshipScan(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void DirectedRelationshipTypeScan(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void DirectedAllRelationshipScan(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void NodeByIdSeek(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void AggregationFunction(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void Create(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void CartesianProduct(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void Projection(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void Distinct(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
-    void OrderBy(SharedBuffer &buffer, string jsonPlan, GraphConfig gc);
+    // Run the whole plan on the calling thread, its rows are added to buffer
+    void execute(BatchBuffer &buffer);
+    void AllNodeScan(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void NodeScanByLabel(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void MultipleNodeScanByLabel(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void NodeIndexSeek(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void NodeIndexRangeScan(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void CreateIndex(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void ProduceResult(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void Filter(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void ExpandAll(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void UndirectedRelationshipTypeScan(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void UndirectedAllRelationshipScan(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void DirectedRelationshipTypeScan(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void DirectedAllRelationshipScan(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void NodeByIdSeek(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void AggregationFunction(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void Create(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void Delete(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void CartesianProduct(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void Projection(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void Distinct(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
+    void OrderBy(BatchBuffer &buffer, string jsonPlan, GraphConfig gc);
     string masterIP;
     string  queryPlan;
     GraphConfig gc;
     json query;
-    static std::unordered_map<std::string, std::function<void(OperatorExecutor &, SharedBuffer &,
+    static std::unordered_map<std::string, std::function<void(OperatorExecutor &, BatchBuffer &,
             std::string, GraphConfig)>> methodMap;
     static void initializeMethodMap();
+    // Variables of the rows produced by the operator of a plan
+    static RowSchema::Ptr outputSchema(const json &plan);
     static const int INTER_OPERATOR_BUFFER_SIZE = 5;
+    // Node or relation IDs a scan thread takes at a time
+    static const size_t MORSEL_SIZE = 2048;
+    // Sub queries to other workers that an ExpandAll step keeps in flight for the remote nodes of a batch
+    static const size_t REMOTE_EXPAND_REQUESTS = 16;
+    // Threads of a node or relationship scan, given by the query or org.jasminegraph.query.scan.parallelism
+    int scanParallelism();
+
+ private:
+    // Run the operator of a plan, each batch it produces is passed to consume on the calling thread. The fragments of
+    // the operators above are not run below a consumer, it is a pipeline breaker.
+    void runPipeline(const string &jsonPlan, GraphConfig gc, BatchBuffer::Consumer consume);
+    // Run the operator of a plan below a streaming operator whose rows of the schema go to buffer, which is closed
+    // once the input is done. process runs in the scan threads if a morsel scan takes the fragment.
+    void runPipeline(const string &jsonPlan, GraphConfig gc, BatchBuffer &buffer, const RowSchema::Ptr &schema,
+                     std::function<void(RowBatch &, BatchWriter &)> process);
+    // Fragments of the streaming operators above the calling scan, outermost first, which the scan runs itself
+    std::vector<Fragment> takeFragments();
+    // Native store of the partition, opened once by the thread that runs the pipeline and shared by its operators
+    NodeManager &openStore(GraphConfig gc);
+
+    std::unique_ptr<NodeManager> store;
+    std::vector<Fragment> fragments;  // Streaming operators above the operator that runs, not taken by a scan yet
 };
 
 #endif  // JASMINEGRAPH_OPERATOREXECUTOR_H
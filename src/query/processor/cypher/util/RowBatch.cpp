@@ -0,0 +1,174 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "RowBatch.h"
+
+const std::string *Entity::property(const std::string &name) const {
+    for (auto &property : this->properties) {
+        if (property.first == name) {
+            return &property.second;
+        }
+    }
+    return NULL;
+}
+
+RowSchema::RowSchema(const std::vector<std::string> &variables) {
+    for (auto &variable : variables) {
+        this->add(variable);
+    }
+}
+
+int RowSchema::add(const std::string &variable) {
+    auto it = this->slots.find(variable);
+    if (it != this->slots.end()) {
+        return it->second;
+    }
+    int slot = this->names.size();
+    this->names.push_back(variable);
+    this->slots[variable] = slot;
+    return slot;
+}
+
+int RowSchema::slot(const std::string &variable) const {
+    auto it = this->slots.find(variable);
+    return it == this->slots.end() ? -1 : it->second;
+}
+
+RowBatch::RowBatch(RowSchema::Ptr schema) : rowSchema(schema), columns(schema->size()) {
+    for (auto &column : this->columns) {
+        column.reserve(RowBatch::CAPACITY);
+    }
+}
+
+size_t RowBatch::append() {
+    for (auto &column : this->columns) {
+        column.emplace_back();
+    }
+    return this->count++;
+}
+
+size_t RowBatch::append(const RowBatch &source, size_t row) {
+    size_t copied = source.columns.size();
+    for (size_t slot = 0; slot < this->columns.size(); slot++) {
+        if (slot < copied) {
+            this->columns[slot].push_back(source.columns[slot][row]);
+        } else {
+            this->columns[slot].emplace_back();
+        }
+    }
+    return this->count++;
+}
+
+void RowBatch::set(size_t row, const json &data) {
+    for (auto &[key, value] : data.items()) {
+        int slot = this->rowSchema->slot(key);
+        if (slot >= 0) {
+            this->columns[slot][row] = RowBatch::fromJson(value);
+        }
+    }
+}
+
+json RowBatch::toJson(size_t row, bool nulls) const {
+    json data = json::object();
+    const std::vector<std::string> &variables = this->rowSchema->variables();
+    for (size_t slot = 0; slot < variables.size(); slot++) {
+        if (nulls || this->columns[slot][row].index() != 0) {
+            data[variables[slot]] = RowBatch::toJson(this->columns[slot][row]);
+        }
+    }
+    return data;
+}
+
+void RowBatch::clear() {
+    for (auto &column : this->columns) {
+        column.clear();
+    }
+    this->count = 0;
+}
+
+json RowBatch::toJson(const RowValue &value) {
+    switch (value.index()) {
+        case 1:
+            return std::get<std::string>(value);
+        case 2:
+            return std::get<long long>(value);
+        case 3:
+            return std::get<double>(value);
+        case 4:
+            return std::get<bool>(value);
+        case 5: {
+            json data = json::object();
+            for (auto &property : std::get<std::shared_ptr<const Entity>>(value)->properties) {
+                data[property.first] = property.second;
+            }
+            return data;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+RowValue RowBatch::fromJson(const json &value) {
+    if (value.is_string()) {
+        return value.get<std::string>();
+    } else if (value.is_boolean()) {
+        return value.get<bool>();
+    } else if (value.is_number_integer()) {
+        return value.get<long long>();
+    } else if (value.is_number()) {
+        return value.get<double>();
+    } else if (value.is_object()) {
+        auto entity = std::make_shared<Entity>();
+        for (auto &[key, property] : value.items()) {
+            entity->properties.emplace_back(key, property.is_string() ? property.get<std::string>() : property.dump());
+        }
+        return std::shared_ptr<const Entity>(entity);
+    }
+    return std::monostate();
+}
+
+std::shared_ptr<const Entity> RowBatch::entity(const RowValue &value) {
+    if (auto entity = std::get_if<std::shared_ptr<const Entity>>(&value)) {
+        return *entity;
+    }
+    return nullptr;
+}
+
+BatchWriter::BatchWriter(BatchBuffer &buffer, RowSchema::Ptr schema) : buffer(buffer), current(schema) {}
+
+void BatchWriter::flushIfFull() {
+    if (this->current.full()) {
+        RowSchema::Ptr schema = this->current.schema();
+        this->buffer.add(std::move(this->current));
+        this->current = RowBatch(schema);
+    }
+}
+
+size_t BatchWriter::addRow() {
+    this->flushIfFull();
+    return this->current.append();
+}
+
+size_t BatchWriter::addRow(const RowBatch &source, size_t row) {
+    this->flushIfFull();
+    return this->current.append(source, row);
+}
+
+void BatchWriter::close() {
+    if (!this->current.empty()) {
+        RowSchema::Ptr schema = this->current.schema();
+        this->buffer.add(std::move(this->current));
+        this->current = RowBatch(schema);
+    }
+    this->buffer.close();
+}
@@ -0,0 +1,159 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#ifndef JASMINEGRAPH_ROWBATCH_H
+#define JASMINEGRAPH_ROWBATCH_H
+
+#include <functional>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "SpscRing.h"
+
+using json = nlohmann::json;
+
+// Properties of a node or relationship bound to a row, nodes also carry their "id" and "partitionID"
+struct Entity {
+    std::vector<std::pair<std::string, std::string>> properties;
+
+    // Value of a property, NULL if the entity does not have it
+    const std::string *property(const std::string &name) const;
+};
+
+// Value of a row slot. Entities are shared between the rows they are bound to, monostate is an unbound slot (null)
+using RowValue = std::variant<std::monostate, std::string, long long, double, bool, std::shared_ptr<const Entity>>;
+
+/**
+ * Variables of the rows an operator produces, mapped to the slots of the row batch columns. The schema of every
+ * operator is derived from the query plan before the operator runs, an operator that adds variables appends them after
+ * the variables of its input so that input rows are copied slot by slot.
+ * */
+class RowSchema {
+ public:
+    typedef std::shared_ptr<const RowSchema> Ptr;
+
+    RowSchema() = default;
+    explicit RowSchema(const std::vector<std::string> &variables);
+
+    // Slot of the variable, appended if the schema does not have it yet
+    int add(const std::string &variable);
+    // Slot of the variable, -1 if the schema does not have it
+    int slot(const std::string &variable) const;
+    const std::vector<std::string> &variables() const { return this->names; }
+    size_t size() const { return this->names.size(); }
+
+ private:
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> slots;
+};
+
+/**
+ * Rows passed between Cypher operators, one column of values per slot of the schema. JSON is only produced for the
+ * rows sent out of the worker.
+ * */
+class RowBatch {
+ public:
+    static const size_t CAPACITY = 1024;
+
+    RowBatch() = default;
+    explicit RowBatch(RowSchema::Ptr schema);
+
+    const RowSchema::Ptr &schema() const { return this->rowSchema; }
+    size_t size() const { return this->count; }
+    bool empty() const { return this->count == 0; }
+    bool full() const { return this->count >= RowBatch::CAPACITY; }
+
+    // Append a row with every slot unbound and return its index
+    size_t append();
+    // Append a copy of a row of a batch whose schema is a prefix of this schema, the remaining slots stay unbound
+    size_t append(const RowBatch &source, size_t row);
+    const RowValue &get(size_t row, int slot) const { return this->columns[slot][row]; }
+    void set(size_t row, int slot, RowValue value) { this->columns[slot][row] = std::move(value); }
+    // Bind the variables of the schema found in a JSON row received from another worker
+    void set(size_t row, const json &data);
+    // JSON object of a row keyed by variable. Unbound variables are left out unless nulls is set, which the rows sent
+    // out of the worker use to keep every result column.
+    json toJson(size_t row, bool nulls = false) const;
+    void clear();
+
+    static json toJson(const RowValue &value);
+    static RowValue fromJson(const json &value);
+    static std::shared_ptr<const Entity> entity(const RowValue &value);
+
+ private:
+    RowSchema::Ptr rowSchema;
+    std::vector<std::vector<RowValue>> columns;
+    size_t count = 0;
+};
+
+/**
+ * Bounded buffer of row batches between a producing and a consuming thread. The producer closes the buffer after its
+ * last batch. A buffer made with a consumer does not buffer anything: every batch is passed to the consumer on the
+ * producer's thread, which is how the operators of a pipeline hand batches to the operator above them.
+ * */
+class BatchBuffer {
+ public:
+    using Consumer = std::function<void(RowBatch &)>;
+
+    explicit BatchBuffer(size_t size) : ring(size) {}
+    explicit BatchBuffer(Consumer consumer) : ring(1), consumer(std::move(consumer)) {}
+
+    // Add a batch, waits while the buffer is full
+    void add(RowBatch batch) {
+        if (this->consumer) {
+            this->consumer(batch);
+        } else {
+            this->ring.push(std::move(batch));
+        }
+    }
+    // Mark the end of the stream of batches
+    void close() { this->ring.close(); }
+    // Take the next batch, false once the buffer is closed and every batch was taken
+    bool get(RowBatch &batch) { return this->ring.pop(batch); }
+    // Take the next batch if one is already in the buffer
+    bool tryGet(RowBatch &batch) { return this->ring.tryPop(batch); }
+    // True once the buffer was closed and every batch was taken
+    bool finished() const { return this->ring.finished(); }
+
+ private:
+    SpscRing<RowBatch> ring;
+    Consumer consumer;
+};
+
+// Fills row batches of a schema and adds every full batch to a buffer
+class BatchWriter {
+ public:
+    BatchWriter(BatchBuffer &buffer, RowSchema::Ptr schema);
+
+    // Start a row with every slot unbound, returns its index in batch()
+    size_t addRow();
+    // Start a row copied from a row of the input of the operator
+    size_t addRow(const RowBatch &source, size_t row);
+    RowBatch &batch() { return this->current; }
+    const RowSchema::Ptr &schema() const { return this->current.schema(); }
+    // Add the last batch and close the buffer
+    void close();
+
+ private:
+    void flushIfFull();
+
+    BatchBuffer &buffer;
+    RowBatch current;
+};
+
+#endif  // JASMINEGRAPH_ROWBATCH_H
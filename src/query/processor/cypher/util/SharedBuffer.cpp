@@ -5,37 +5,40 @@
 #include "SharedBuffer.h"
 
 // Add data to the buffer
-void SharedBuffer::add(const std::string &data) {
-    std::unique_lock<std::mutex> lock(mtx);
-    cv.wait(lock, [this]() { return buffer.size() < max_size; });
-    buffer.push_back(data);
-    cv.notify_one();  // Notify waiting threads
+void SharedBuffer::add(std::string data) {
+    ring.push(std::move(data));
+}
+
+void SharedBuffer::addBatch(std::vector<std::string> &data) {
+    ring.pushBatch(data.data(), data.size());
+}
+
+void SharedBuffer::close() {
+    ring.close();
 }
 
 // Retrieve data from the buffer
-std::string SharedBuffer::get() {
-    std::unique_lock<std::mutex> lock(mtx);
-    cv.wait(lock, [this]() { return !buffer.empty(); });
-    std::string data = buffer.front();
-    buffer.pop_front();
-    cv.notify_one();  // Notify waiting threads
-    return data;
+bool SharedBuffer::get(std::string &data) {
+    return ring.pop(data);
+}
+
+size_t SharedBuffer::getBatch(std::vector<std::string> &data, size_t max) {
+    return ring.popBatch(data, max);
 }
 
 // Non-blocking method to try getting data
-bool SharedBuffer::tryGet(std::string& data) {
-    std::unique_lock<std::mutex> lock(mtx);
-    if (buffer.empty()) {
-        return false;  // No data available
-    }
-    data = buffer.front();
-    buffer.pop_front();
-    cv.notify_one();  // Notify waiting threads
-    return true;
+bool SharedBuffer::tryGet(std::string &data) {
+    return ring.tryPop(data);
 }
 
-bool SharedBuffer::empty() {
-    std::lock_guard<std::mutex> lock(mtx);
-    return buffer.empty();
+size_t SharedBuffer::tryGetBatch(std::vector<std::string> &data, size_t max) {
+    return ring.tryPopBatch(data, max);
+}
+
+bool SharedBuffer::finished() {
+    return ring.finished();
 }
 
+bool SharedBuffer::empty() {
+    return ring.empty();
+}
@@ -6,28 +6,53 @@
 #define JASMINEGRAPH_SHAREDBUFFER_H
 
 #include <iostream>
-#include <deque>
-#include <mutex>
-#include <condition_variable>
 #include <string>
+#include <vector>
 
+#include "SpscRing.h"
+
+/**
+ * Rows of a query result passed from the thread that receives them from a worker to the thread that consumes them.
+ * One producer and one consumer per buffer, the producer closes the buffer at the end of the stream.
+ * */
 class SharedBuffer {
  private:
-    std::deque<std::string> buffer;
-    std::mutex mtx;
-    std::condition_variable cv;
-    const size_t max_size;
+    SpscRing<std::string> ring;
 
  public:
-    explicit SharedBuffer(size_t size) : max_size(size) {}
+    explicit SharedBuffer(size_t size) : ring(size) {}
+
+    // Closes a buffer when its producer leaves the scope, on error paths too
+    class CloseGuard {
+     public:
+        explicit CloseGuard(SharedBuffer &buffer) : buffer(buffer) {}
+        ~CloseGuard() { buffer.close(); }
+
+     private:
+        SharedBuffer &buffer;
+    };
 
     // Add data to the buffer
-    void add(const std::string &data);
+    void add(std::string data);
+
+    // Add a batch of data to the buffer, the strings are moved out of data
+    void addBatch(std::vector<std::string> &data);
+
+    // Mark the end of the stream
+    void close();
+
+    // Retrieve data from the buffer, false once the buffer is closed and every string was taken
+    bool get(std::string &data);
+
+    // Move up to max strings to the end of data, 0 once the buffer is closed and every string was taken
+    size_t getBatch(std::vector<std::string> &data, size_t max);
 
-    // Retrieve data from the buffer
-    std::string get();
+    // Non-blocking methods to try getting data
+    bool tryGet(std::string &data);
+    size_t tryGetBatch(std::vector<std::string> &data, size_t max);
 
-    bool tryGet(std::string& data);
+    // True once the buffer is closed and every string was taken
+    bool finished();
 
     bool empty();
 };
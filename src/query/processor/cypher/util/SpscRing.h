@@ -0,0 +1,198 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#ifndef JASMINEGRAPH_SPSCRING_H
+#define JASMINEGRAPH_SPSCRING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Bounded ring of items passed from one producer thread to one consumer thread. Items are moved in and out in batches
+ * with a single atomic index update per batch. A side that has to wait spins, then yields, and only then parks on a
+ * condition variable, which the other side signals only when it sees a parked waiter. The producer closes the ring
+ * after its last item, the consumer takes the remaining items and then sees the end of the stream.
+ * */
+template <typename T>
+class SpscRing {
+ public:
+    // The capacity is rounded up to a power of two
+    explicit SpscRing(size_t size) {
+        size_t capacity = 1;
+        while (capacity < size) {
+            capacity <<= 1;
+        }
+        this->slots.resize(capacity);
+        this->mask = capacity - 1;
+    }
+
+    size_t capacity() const { return this->mask + 1; }
+
+    // Move count items into the ring, waiting while it is full
+    void pushBatch(T *items, size_t count) {
+        size_t pushed = 0;
+        while (pushed < count) {
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            size_t free = this->capacity() - (tail - this->head.load(std::memory_order_acquire));
+            if (free == 0) {
+                this->await(this->producerParked, [this, tail]() {
+                    return tail - this->head.load(std::memory_order_acquire) < this->capacity();
+                });
+                continue;
+            }
+            size_t moved = std::min(free, count - pushed);
+            for (size_t i = 0; i < moved; i++) {
+                this->slots[(tail + i) & this->mask] = std::move(items[pushed + i]);
+            }
+            this->tail.store(tail + moved, std::memory_order_release);
+            pushed += moved;
+            this->wake(this->consumerParked);
+        }
+    }
+
+    void push(T item) { this->pushBatch(&item, 1); }
+
+    // Move up to max items to the end of items, waiting while the ring is empty. 0 once the ring is closed and empty.
+    size_t popBatch(std::vector<T> &items, size_t max) {
+        while (true) {
+            size_t taken = this->tryPopBatch(items, max);
+            if (taken > 0 || this->finished()) {
+                return taken;
+            }
+            this->awaitItems();
+        }
+    }
+
+    // Take the next item, waiting while the ring is empty. False once the ring is closed and empty.
+    bool pop(T &item) {
+        while (true) {
+            if (this->tryPop(item)) {
+                return true;
+            }
+            if (this->finished()) {
+                return false;
+            }
+            this->awaitItems();
+        }
+    }
+
+    // Move up to max items that are already in the ring, without waiting
+    size_t tryPopBatch(std::vector<T> &items, size_t max) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        size_t taken = std::min(this->tail.load(std::memory_order_acquire) - head, max);
+        for (size_t i = 0; i < taken; i++) {
+            items.push_back(std::move(this->slots[(head + i) & this->mask]));
+        }
+        if (taken > 0) {
+            this->head.store(head + taken, std::memory_order_release);
+            this->wake(this->producerParked);
+        }
+        return taken;
+    }
+
+    bool tryPop(T &item) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        if (this->tail.load(std::memory_order_acquire) == head) {
+            return false;
+        }
+        item = std::move(this->slots[head & this->mask]);
+        this->head.store(head + 1, std::memory_order_release);
+        this->wake(this->producerParked);
+        return true;
+    }
+
+    // Mark the end of the stream, called by the producer after its last item
+    void close() {
+        this->closed.store(true, std::memory_order_release);
+        this->wake(this->consumerParked);
+    }
+
+    // True once the ring was closed and every item was taken
+    bool finished() const {
+        // The closed flag is read first, the producer does not add items after closing
+        return this->closed.load(std::memory_order_acquire) &&
+               this->tail.load(std::memory_order_acquire) == this->head.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return this->tail.load(std::memory_order_acquire) == this->head.load(std::memory_order_acquire);
+    }
+
+    // One wait step of a consumer that polls several rings, spinning first, then yielding, then sleeping briefly
+    static void backoff(unsigned int &attempt) {
+        if (attempt < SPIN_LIMIT) {
+            attempt++;
+        } else if (attempt < SPIN_LIMIT + YIELD_LIMIT) {
+            attempt++;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+ private:
+    static const unsigned int SPIN_LIMIT = 64;
+    static const unsigned int YIELD_LIMIT = 64;
+
+    template <typename Ready>
+    void await(std::atomic<bool> &parked, Ready ready) {
+        unsigned int attempt = 0;
+        while (attempt < SPIN_LIMIT + YIELD_LIMIT) {
+            if (ready()) {
+                return;
+            }
+            backoff(attempt);
+        }
+        std::unique_lock<std::mutex> guard(this->parkLock);
+        parked.store(true, std::memory_order_relaxed);
+        // Pairs with the fence in wake(), either the waker sees the flag or the waiter sees the update
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        this->signal.wait(guard, ready);
+        parked.store(false, std::memory_order_relaxed);
+    }
+
+    void awaitItems() {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        this->await(this->consumerParked, [this, head]() {
+            return this->tail.load(std::memory_order_acquire) != head ||
+                   this->closed.load(std::memory_order_acquire);
+        });
+    }
+
+    void wake(std::atomic<bool> &parked) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> guard(this->parkLock);
+            this->signal.notify_all();
+        }
+    }
+
+    std::vector<T> slots;
+    size_t mask;
+    // Next slot to take, written by the consumer only
+    alignas(64) std::atomic<size_t> head{0};
+    // Next slot to fill, written by the producer only
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<bool> closed{false};
+    std::atomic<bool> producerParked{false};
+    std::atomic<bool> consumerParked{false};
+    std::mutex parkLock;
+    std::condition_variable signal;
+};
+
+#endif  // JASMINEGRAPH_SPSCRING_H
@@ -0,0 +1,140 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "TaskPool.h"
+
+#include <algorithm>
+
+thread_local TaskPool *TaskPool::current = NULL;
+
+bool TaskPool::Task::claim() {
+    int queued = QUEUED;
+    return this->state.compare_exchange_strong(queued, RUNNING);
+}
+
+void TaskPool::Task::run() {
+    this->work();
+    this->work = nullptr;  // Release what the task holds before it is reported done
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->state.store(DONE);
+    this->finished.notify_all();
+}
+
+bool TaskPool::Task::cancel() {
+    int queued = QUEUED;
+    return this->state.compare_exchange_strong(queued, CANCELLED) || this->state.load() == CANCELLED;
+}
+
+void TaskPool::Task::join() {
+    if (this->claim()) {
+        this->run();
+        return;
+    }
+    // The task may itself wait on another worker, so the wait counts as blocking
+    Blocking blocking;
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->finished.wait(guard, [this]() {
+        int state = this->state.load();
+        return state == DONE || state == CANCELLED;
+    });
+}
+
+TaskPool::Blocking::Blocking() : pool(TaskPool::current) {
+    if (!this->pool) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(this->pool->lock);
+    this->pool->blocked++;
+    this->pool->addThreadIfBlocked();
+}
+
+TaskPool::Blocking::~Blocking() {
+    if (!this->pool) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(this->pool->lock);
+    this->pool->blocked--;
+}
+
+TaskPool::TaskPool(unsigned int size) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for (unsigned int i = 0; i < std::max(size, 1U); i++) {
+        this->threads.emplace_back(&TaskPool::runTasks, this, false);
+        this->running++;
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->available.notify_all();
+    for (auto &thread : this->threads) {
+        thread.join();
+    }
+    // Extra threads are detached, they end once the queue is empty
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->stopped.wait(guard, [this]() { return this->running == 0; });
+}
+
+TaskPool &TaskPool::getInstance() {
+    static TaskPool pool(std::thread::hardware_concurrency());
+    return pool;
+}
+
+std::shared_ptr<TaskPool::Task> TaskPool::submit(std::function<void()> work) {
+    auto task = std::make_shared<Task>(this, std::move(work));
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->queue.push_back(task);
+        this->addThreadIfBlocked();
+    }
+    this->available.notify_one();
+    return task;
+}
+
+void TaskPool::addThreadIfBlocked() {
+    if (this->queue.empty() || this->idle > 0 || this->blocked < this->running) {
+        return;
+    }
+    this->running++;
+    std::thread(&TaskPool::runTasks, this, true).detach();
+}
+
+void TaskPool::runTasks(bool extra) {
+    TaskPool::current = this;
+    while (true) {
+        std::shared_ptr<Task> task;
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+            if (!extra) {
+                this->idle++;
+                this->available.wait(guard, [this]() { return this->stopping || !this->queue.empty(); });
+                this->idle--;
+            }
+            if (this->queue.empty()) {
+                if (--this->running == 0) {
+                    this->stopped.notify_all();
+                }
+                return;
+            }
+            task = std::move(this->queue.front());
+            this->queue.pop_front();
+        }
+        // Tasks that were cancelled or run by the thread waiting for them are skipped
+        if (task->claim()) {
+            task->run();
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#ifndef JASMINEGRAPH_TASKPOOL_H
+#define JASMINEGRAPH_TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of threads, one per core, shared by the Cypher queries of a process. The operator pipeline of a query runs
+ * as one task, and the parts of a pipeline that can go in parallel, such as the morsels of a scan and the sub queries
+ * sent to other workers, run as further tasks.
+ *
+ * A thread never waits for a task that no pool thread has taken yet: it drops the task or runs it itself, so tasks of
+ * a query can not be held back by tasks queued before them. Pool threads that wait on other workers are marked with a
+ * Blocking scope. Once every pool thread waits that way, queued tasks get an extra thread, which ends as soon as it
+ * finds the queue empty. The sub queries that other workers wait for therefore always get to run.
+ * */
+class TaskPool {
+ public:
+    class Task {
+     public:
+        Task(TaskPool *pool, std::function<void()> work) : pool(pool), work(std::move(work)) {}
+
+        // Drop the task if no thread has taken it yet, false if it has started
+        bool cancel();
+        // Run the task on the calling thread if no thread has taken it yet, then wait until it has finished
+        void join();
+
+     private:
+        friend class TaskPool;
+        enum State { QUEUED, RUNNING, DONE, CANCELLED };
+
+        // Take the task for the calling thread, false if another thread took it or it was cancelled
+        bool claim();
+        void run();
+
+        TaskPool *pool;
+        std::function<void()> work;
+        std::atomic<int> state{QUEUED};
+        std::mutex lock;
+        std::condition_variable finished;
+    };
+
+    // Marks the calling pool thread as waiting for something outside the pool, no effect on other threads
+    class Blocking {
+     public:
+        Blocking();
+        ~Blocking();
+
+     private:
+        TaskPool *pool;
+    };
+
+    explicit TaskPool(unsigned int size);
+    ~TaskPool();
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    static TaskPool &getInstance();
+
+    std::shared_ptr<Task> submit(std::function<void()> work);
+    unsigned int size() const { return this->threads.size(); }
+
+ private:
+    void runTasks(bool extra);
+    // Start an extra thread if tasks are queued and every thread waits in a Blocking scope, called with lock held
+    void addThreadIfBlocked();
+
+    std::vector<std::thread> threads;
+    std::deque<std::shared_ptr<Task>> queue;
+    std::mutex lock;
+    std::condition_variable available;
+    std::condition_variable stopped;
+    unsigned int running = 0;  // Threads of the pool, including extra threads
+    unsigned int idle = 0;     // Threads waiting for a task
+    unsigned int blocked = 0;  // Threads in a Blocking scope
+    bool stopping = false;
+
+    static thread_local TaskPool *current;  // Pool of the calling thread, NULL for threads outside any pool
+};
+
+#endif  // JASMINEGRAPH_TASKPOOL_H
@@ -63,6 +63,7 @@ const string JasmineGraphInstanceProtocol::AGGREGATE_STREAMING_CENTRALSTORE_TRIA
 const string JasmineGraphInstanceProtocol::AGGREGATE_COMPOSITE_CENTRALSTORE_TRIANGLES = "aggregate-composite";
 const string JasmineGraphInstanceProtocol::START_STAT_COLLECTION = "begin-stat";
 const string JasmineGraphInstanceProtocol::REQUEST_COLLECTED_STATS = "request-stat";
+const string JasmineGraphInstanceProtocol::STORAGE_METRICS = "storage-metrics";
 const string JasmineGraphInstanceProtocol::INITIATE_TRAIN = "initiate-train";
 const string JasmineGraphInstanceProtocol::INITIATE_PREDICT = "init-predict";
 const string JasmineGraphInstanceProtocol::SEND_HOSTS = "send-hosts";
@@ -78,6 +78,7 @@ class JasmineGraphInstanceProtocol {
     static const string AGGREGATE_COMPOSITE_CENTRALSTORE_TRIANGLES;
     static const string START_STAT_COLLECTION;
     static const string REQUEST_COLLECTED_STATS;
+    static const string STORAGE_METRICS;
     static const string INITIATE_TRAIN;
     static const string INITIATE_PREDICT;
     static const string SEND_HOSTS;
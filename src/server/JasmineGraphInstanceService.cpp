@@ -111,6 +111,7 @@ static void initiate_client_command(int connFd, bool *loop_exit_p);
 static void initiate_merge_files_command(int connFd, bool *loop_exit_p);
 static inline void start_stat_collection_command(int connFd, bool *collectValid_p, bool *loop_exit_p);
 static void request_collected_stats_command(int connFd, bool *collectValid_p, bool *loop_exit_p);
+static void storage_metrics_command(int connFd, bool *loop_exit_p);
 static void initiate_train_command(int connFd, bool *loop_exit_p);
 static void initiate_predict_command(int connFd, instanceservicesessionargs *sessionargs, bool *loop_exit_p);
 static void initiate_model_collection_command(int connFd, bool *loop_exit_p);
@@ -259,6 +260,8 @@ void *instanceservicesession(void *dummyPt) {
             start_stat_collection_command(connFd, &collectValid, &loop_exit);
         } else if (line.compare(JasmineGraphInstanceProtocol::REQUEST_COLLECTED_STATS) == 0) {
             request_collected_stats_command(connFd, &collectValid, &loop_exit);
+        } else if (line.compare(JasmineGraphInstanceProtocol::STORAGE_METRICS) == 0) {
+            storage_metrics_command(connFd, &loop_exit);
         } else if (line.compare(JasmineGraphInstanceProtocol::INITIATE_TRAIN) == 0) {
             initiate_train_command(connFd, &loop_exit);
         } else if (line.compare(JasmineGraphInstanceProtocol::INITIATE_PREDICT) == 0) {
@@ -3610,6 +3613,32 @@ static void request_collected_stats_command(int connFd, bool *collectValid_p, bo
     }
 }
 
+/**
+ * Send the storage I/O metrics of the native store partitions of this worker as JSON: the content length first, then
+ * the JSON after the master acknowledged the length
+ * */
+static void storage_metrics_command(int connFd, bool *loop_exit_p) {
+    std::string metrics = StatisticCollector::getStorageMetrics();
+    int contentLength = htonl(metrics.length());
+    if (!Utils::send_int_wrapper(connFd, &contentLength, sizeof(contentLength))) {
+        *loop_exit_p = true;
+        return;
+    }
+    char data[DATA_BUFFER_SIZE];
+    std::string response = Utils::read_str_trim_wrapper(connFd, data, INSTANCE_DATA_LENGTH);
+    if (response.compare(JasmineGraphInstanceProtocol::GRAPH_STREAM_C_length_ACK) != 0) {
+        instance_logger.error("Incorrect response. Expected: " +
+                              JasmineGraphInstanceProtocol::GRAPH_STREAM_C_length_ACK + " ; Received: " + response);
+        *loop_exit_p = true;
+        return;
+    }
+    if (!Utils::send_str_wrapper(connFd, metrics)) {
+        *loop_exit_p = true;
+        return;
+    }
+    instance_logger.debug("Sent storage metrics of " + std::to_string(metrics.length()) + " bytes");
+}
+
 static void initiate_train_command(int connFd, bool *loop_exit_p) {
     if (!Utils::send_str_wrapper(connFd, JasmineGraphInstanceProtocol::OK)) {
         *loop_exit_p = true;
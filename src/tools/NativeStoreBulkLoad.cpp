@@ -0,0 +1,86 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include <iostream>
+#include <string>
+
+#include "../../globals.h"
+#include "../nativestore/BulkLoader.h"
+#include "../util/Utils.h"
+#include "../util/logger/Logger.h"
+
+int jasminegraph_profile = PROFILE_NATIVE;
+
+Logger bulkload_logger;
+
+static void usage(const char *program) {
+    std::cerr << "Usage: " << program << " --graph <graph ID> --partition <partition ID> --edges <edge list>..."
+              << " [--central <central edge list>]... [--node-properties <file>] [--edge-properties <file>]"
+              << " [--memory <MB>]" << std::endl;
+}
+
+/**
+ * Write the native store files of a partition from its edge lists, see BulkLoader. The partition is created in the
+ * data folder of the configuration and must not be open in a running worker.
+ * */
+int main(int argc, char *argv[]) {
+    GraphConfig gc;
+    gc.graphID = 0;
+    gc.partitionID = 0;
+    gc.openMode = "trunc";
+    gc.maxLabelSize = std::stoi(Utils::getJasmineGraphProperty("org.jasminegraph.nativestore.max.label.size"));
+    unsigned long memoryBytes = BulkLoader::DEFAULT_MEMORY_BYTES;
+    BulkLoader::Input input;
+    bool hasGraph = false;
+    bool hasPartition = false;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (option == "--graph") {
+            gc.graphID = std::stoul(value);
+            hasGraph = true;
+        } else if (option == "--partition") {
+            gc.partitionID = std::stoul(value);
+            hasPartition = true;
+        } else if (option == "--edges") {
+            input.localEdges.push_back(value);
+        } else if (option == "--central") {
+            input.centralEdges.push_back(value);
+        } else if (option == "--node-properties") {
+            input.nodeProperties = value;
+        } else if (option == "--edge-properties") {
+            input.edgeProperties = value;
+        } else if (option == "--memory") {
+            memoryBytes = std::stoul(value) * 1024 * 1024;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!hasGraph || !hasPartition || (input.localEdges.empty() && input.centralEdges.empty())) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    BulkLoader loader(gc, memoryBytes);
+    if (!loader.load(input)) {
+        bulkload_logger.error("Bulk load of graph " + std::to_string(gc.graphID) + " partition " +
+                              std::to_string(gc.partitionID) + " failed");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+#include <iostream>
+#include <string>
+
+#include "../../globals.h"
+#include "../nativestore/BlockFormat.h"
+#include "../util/logger/Logger.h"
+
+int jasminegraph_profile = PROFILE_NATIVE;
+
+Logger migrate_logger;
+
+/**
+ * Convert native store partitions to the latest block format. Each argument is the prefix of a partition's files,
+ * <data folder>/g<graph ID>_p<partition ID>, and the partitions must not be open in a running worker.
+ * */
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <partition prefix>..." << std::endl;
+        return 1;
+    }
+    int failed = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!BlockFormat::migrate(argv[i])) {
+            migrate_logger.error("Migration of " + std::string(argv[i]) + " failed");
+            failed++;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -1394,6 +1394,7 @@ void Utils::assignPartitionToWorker(int graphId, int partitionIndex, string  hos
 
 bool Utils::sendQueryPlanToWorker(std::string host, int port, std::string masterIP,
                                   int graphID, int partitionId, std::string message, SharedBuffer &sharedBuffer) {
+    SharedBuffer::CloseGuard closeGuard(sharedBuffer);
     util_logger.info("Host:" + host + " Port:" + to_string(port));
     bool result = true;
     int sockfd;
@@ -1530,8 +1531,7 @@ bool Utils::sendQueryPlanToWorker(std::string host, int port, std::string master
             return false;
         }
 
-        if (data == "-1") {
-            sharedBuffer.add(data);
+        if (data == "-1") {  // End of the worker's result
             break;
         }
         sharedBuffer.add(data);
@@ -1539,6 +1539,68 @@ bool Utils::sendQueryPlanToWorker(std::string host, int port, std::string master
     return true;
 }
 
+std::string Utils::getStorageMetrics(std::string host, int port, std::string masterIP) {
+    int sockfd;
+    char data[FED_DATA_LENGTH + 1];
+    struct sockaddr_in serv_addr;
+    struct hostent *server;
+
+    sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        util_logger.error("Cannot create socket");
+        return "";
+    }
+
+    if (host.find('@') != std::string::npos) {
+        host = Utils::split(host, '@')[1];
+    }
+
+    server = gethostbyname(host.c_str());
+    if (server == NULL) {
+        util_logger.error("ERROR, no host named " + host);
+        close(sockfd);
+        return "";
+    }
+
+    bzero((char *)&serv_addr, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    bcopy((char *)server->h_addr, (char *)&serv_addr.sin_addr.s_addr, server->h_length);
+    serv_addr.sin_port = htons(port);
+    if (Utils::connect_wrapper(sockfd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        close(sockfd);
+        return "";
+    }
+
+    if (!Utils::performHandshake(sockfd, data, FED_DATA_LENGTH, masterIP) ||
+        !Utils::send_str_wrapper(sockfd, JasmineGraphInstanceProtocol::STORAGE_METRICS)) {
+        Utils::send_str_wrapper(sockfd, JasmineGraphInstanceProtocol::CLOSE);
+        close(sockfd);
+        return "";
+    }
+
+    int content_length;
+    if (recv(sockfd, &content_length, sizeof(int), MSG_WAITALL) != sizeof(int)) {
+        util_logger.error("Error while receiving storage metrics length from " + host + ":" + to_string(port));
+        close(sockfd);
+        return "";
+    }
+    content_length = ntohl(content_length);
+    if (!Utils::send_str_wrapper(sockfd, JasmineGraphInstanceProtocol::GRAPH_STREAM_C_length_ACK)) {
+        close(sockfd);
+        return "";
+    }
+
+    std::string metrics(content_length, 0);
+    if (content_length > 0 && recv(sockfd, &metrics[0], content_length, MSG_WAITALL) != content_length) {
+        util_logger.error("Error while receiving storage metrics from " + host + ":" + to_string(port));
+        close(sockfd);
+        return "";
+    }
+    Utils::send_str_wrapper(sockfd, JasmineGraphInstanceProtocol::CLOSE);
+    close(sockfd);
+    return metrics;
+}
+
 std::optional<std::tuple<std::string, int, int>> Utils::getWorker(string partitionId, std::string host, int port) {
     util_logger.info("Host:" + host + " Port:" + to_string(port));
     bool result = true;
@@ -1808,8 +1870,8 @@ string Utils::getFrontendInput(int connFd) {
     return input;
 }
 
-bool Utils::sendDataFromWorkerToWorker(string masterIP, int graphID, string partitionId,
-                                       std::string message, SharedBuffer &sharedBuffer) {
+bool Utils::sendDataFromWorkerToWorker(string masterIP, int graphID, string partitionId, std::string message,
+                                       const std::function<void(std::string &)> &addRow) {
     auto workerDetails = getWorker(partitionId, masterIP, Conts::JASMINEGRAPH_BACKEND_PORT);
     std::string host;
     int port;
@@ -1958,11 +2020,10 @@ bool Utils::sendDataFromWorkerToWorker(string masterIP, int graphID, string part
             return false;
         }
 
-        if (subData == "-1") {
-            sharedBuffer.add(subData);
+        if (subData == "-1") {  // End of the worker's result
             break;
         }
-        sharedBuffer.add(subData);
+        addRow(subData);
     }
     auto now = std::chrono::high_resolution_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - startTime);
@@ -18,6 +18,7 @@ limitations under the License.
 #include <optional>
 #include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <nlohmann/json.hpp>
@@ -193,11 +194,16 @@ class Utils {
     static bool transferPartition(std::string sourceWorker, int sourceWorkerPort, std::string destinationWorker,
                                   int destinationWorkerDataPort, std::string graphID, std::string partitionID,
                                   std::string workerID, SQLiteDBInterface *sqlite);
+    // Rows of the query result of a worker are added to sharedBuffer, which is closed once the result ends or fails
     static bool sendQueryPlanToWorker(std::string host, int port, std::string masterIP,
                                       int graphID, int PartitionId, std::string message, SharedBuffer &sharedBuffer);
+    // Storage I/O metrics JSON of the native store partitions of a worker, empty if the worker could not be reached
+    static std::string getStorageMetrics(std::string host, int port, std::string masterIP);
     static std::optional<std::tuple<std::string, int, int>> getWorker(string partitionID, std::string host, int port);
+    // Same as sendQueryPlanToWorker for a sub query sent to the worker of another partition, every result row is
+    // passed to addRow on the calling thread as it is received
     static bool sendDataFromWorkerToWorker(string masterIP, int graphID, string partitionId, std::string message,
-                                           SharedBuffer &sharedBuffer);
+                                           const std::function<void(std::string &)> &addRow);
     static bool sendIntExpectResponse(int sockfd, char *data, size_t data_length,
                                       int value, std::string expectMsg);
 
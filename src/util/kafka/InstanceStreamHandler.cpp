@@ -12,11 +12,18 @@
  */
 
 #include "InstanceStreamHandler.h"
+
+#include <vector>
+
 #include "../../localstore/incremental/JasmineGraphIncrementalLocalStore.h"
 #include "../Utils.h"
 #include "../logger/Logger.h"
 
 Logger instance_stream_logger;
+
+// Maximum number of queued stream messages written as one batch
+static const size_t MAX_BATCH_SIZE = 1024;
+
 InstanceStreamHandler::InstanceStreamHandler(std::map<std::string,
                                              JasmineGraphIncrementalLocalStore*>& incrementalLocalStoreMap)
         : incrementalLocalStoreMap(incrementalLocalStoreMap) { }
@@ -63,8 +70,9 @@ void InstanceStreamHandler::threadFunction(const std::string& nodeString) {
     JasmineGraphIncrementalLocalStore* localStore = incrementalLocalStoreMap[graphIdentifier];
     instance_stream_logger.info("Thread Function");
 
+    std::vector<std::string> batch;
     while (!terminateThreads) {
-        std::string nodeString;
+        batch.clear();
         {
             std::unique_lock<std::mutex> lock(queue_mutexes[graphIdentifier]);
             cond_vars[graphIdentifier].wait(lock, [&]{
@@ -74,10 +82,17 @@ void InstanceStreamHandler::threadFunction(const std::string& nodeString) {
             if (terminateThreads) {
                 break;
             }
-            nodeString = queues[graphIdentifier].front();
-            queues[graphIdentifier].pop();
+            // Drain the queued messages so that their edges are written with one batch insert
+            while (!queues[graphIdentifier].empty() && batch.size() < MAX_BATCH_SIZE) {
+                batch.push_back(std::move(queues[graphIdentifier].front()));
+                queues[graphIdentifier].pop();
+            }
+        }
+        if (batch.size() == 1) {
+            localStore->addEdgeFromString(batch.front());
+        } else {
+            localStore->addEdgesFromStrings(batch);
         }
-        localStore->addEdgeFromString(nodeString);
     }
 }
 
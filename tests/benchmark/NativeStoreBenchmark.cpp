@@ -0,0 +1,97 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+/**
+ * Compares the fstream and mmap storage modes of the native store.
+ *
+ * A synthetic partition is written once, then reopened in each storage mode to time random node lookups and a full
+ * relation chain traversal (getAdjacencyList), which touch the nodes and relations DB files in the same way the
+ * Cypher operators and streaming algorithms do.
+ *
+ * Usage: NativeStoreBenchmark [nodes] [edges] [lookups]
+ * The partition is written to org.jasminegraph.server.instance.datafolder as graph 0, partition 0.
+ * */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../../src/nativestore/MappedFile.h"
+#include "../../src/nativestore/NodeManager.h"
+
+static const unsigned int BENCHMARK_GRAPH_ID = 0;
+static const unsigned int BENCHMARK_PARTITION_ID = 0;
+
+static double elapsedMillis(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void buildGraph(unsigned long nodes, unsigned long edges) {
+    GraphConfig gc{43, BENCHMARK_GRAPH_ID, BENCHMARK_PARTITION_ID, "trunc"};
+    NodeManager nodeManager(gc);
+    std::mt19937 random(42);
+    std::uniform_int_distribution<unsigned long> node(1, nodes);
+    for (unsigned long i = 0; i < edges; i++) {
+        nodeManager.addLocalEdge({std::to_string(node(random)), std::to_string(node(random))});
+    }
+    nodeManager.close();
+}
+
+static void runMode(const std::string &storageMode, unsigned long nodes, unsigned long lookups) {
+    GraphConfig gc{43, BENCHMARK_GRAPH_ID, BENCHMARK_PARTITION_ID, NodeManager::FILE_MODE, storageMode};
+    NodeManager nodeManager(gc);
+
+    std::mt19937 random(7);
+    std::uniform_int_distribution<unsigned long> node(1, nodes);
+    unsigned long found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < lookups; i++) {
+        NodeBlock *nodeBlock = nodeManager.get(std::to_string(node(random)));
+        if (nodeBlock) {
+            found++;
+            delete nodeBlock;
+        }
+    }
+    double lookupTime = elapsedMillis(start);
+
+    start = std::chrono::steady_clock::now();
+    auto adjacencyList = nodeManager.getAdjacencyList(true);
+    unsigned long degreeSum = 0;
+    for (auto &entry : adjacencyList) {
+        degreeSum += entry.second.size();
+    }
+    double traversalTime = elapsedMillis(start);
+
+    std::cout << storageMode << ": " << lookups << " node lookups (" << found << " found) in " << lookupTime
+              << " ms, relation traversal of " << degreeSum << " adjacencies in " << traversalTime << " ms"
+              << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long nodes = argc > 1 ? std::stoul(argv[1]) : 100000;
+    unsigned long edges = argc > 2 ? std::stoul(argv[2]) : 500000;
+    unsigned long lookups = argc > 3 ? std::stoul(argv[3]) : 100000;
+
+    auto start = std::chrono::steady_clock::now();
+    buildGraph(nodes, edges);
+    std::cout << "Built partition with " << nodes << " nodes and " << edges << " edges in " << elapsedMillis(start)
+              << " ms" << std::endl;
+
+    // Run each mode twice so that both see a warm page cache
+    for (int round = 0; round < 2; round++) {
+        runMode(MappedFile::STORAGE_MODE_FSTREAM, nodes, lookups);
+        runMode(MappedFile::STORAGE_MODE_MMAP, nodes, lookups);
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**/
+
+/**
+ * Compares the ring buffer behind SharedBuffer with the mutex and condition variable buffer it replaced.
+ *
+ * One thread produces result rows of the size the workers send and another consumes them, as between the thread that
+ * receives a worker's rows and the master. The locked buffer moves one row per lock and ends the stream with the "-1"
+ * row, the ring is timed both row by row and in batches.
+ *
+ * Usage: SharedBufferBenchmark [rows] [buffer size] [batch size]
+ * */
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../src/query/processor/cypher/util/SharedBuffer.h"
+
+// The SharedBuffer implementation before the ring buffer
+class LockedBuffer {
+ public:
+    explicit LockedBuffer(size_t size) : maxSize(size) {}
+
+    void add(const std::string &data) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return buffer.size() < maxSize; });
+        buffer.push_back(data);
+        cv.notify_one();
+    }
+
+    std::string get() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return !buffer.empty(); });
+        std::string data = buffer.front();
+        buffer.pop_front();
+        cv.notify_one();
+        return data;
+    }
+
+ private:
+    std::deque<std::string> buffer;
+    std::mutex mtx;
+    std::condition_variable cv;
+    const size_t maxSize;
+};
+
+static double elapsedMillis(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const std::string &name, unsigned long rows, double millis) {
+    std::cout << name << ": " << rows << " rows in " << millis << " ms (" << (unsigned long)(rows / millis * 1000)
+              << " rows/s)" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long rows = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    size_t bufferSize = argc > 2 ? std::stoul(argv[2]) : 5;
+    size_t batchSize = argc > 3 ? std::stoul(argv[3]) : 64;
+    const std::string row = R"({"n":{"id":"1234","name":"Node 1234","partitionID":"0"}})";
+
+    for (int round = 0; round < 2; round++) {
+        {
+            LockedBuffer buffer(bufferSize);
+            auto start = std::chrono::steady_clock::now();
+            std::thread producer([&]() {
+                for (unsigned long i = 0; i < rows; i++) {
+                    buffer.add(row);
+                }
+                buffer.add("-1");
+            });
+            unsigned long received = 0;
+            while (buffer.get() != "-1") {
+                received++;
+            }
+            producer.join();
+            report("locked buffer", received, elapsedMillis(start));
+        }
+        {
+            SharedBuffer buffer(bufferSize);
+            auto start = std::chrono::steady_clock::now();
+            std::thread producer([&]() {
+                for (unsigned long i = 0; i < rows; i++) {
+                    buffer.add(row);
+                }
+                buffer.close();
+            });
+            unsigned long received = 0;
+            std::string data;
+            while (buffer.get(data)) {
+                received++;
+            }
+            producer.join();
+            report("ring buffer", received, elapsedMillis(start));
+        }
+        {
+            SharedBuffer buffer(std::max(bufferSize, batchSize));
+            auto start = std::chrono::steady_clock::now();
+            std::thread producer([&]() {
+                std::vector<std::string> batch;
+                for (unsigned long i = 0; i < rows; i++) {
+                    batch.push_back(row);
+                    if (batch.size() == batchSize) {
+                        buffer.addBatch(batch);
+                        batch.clear();
+                    }
+                }
+                buffer.addBatch(batch);
+                buffer.close();
+            });
+            unsigned long received = 0;
+            std::vector<std::string> batch;
+            while (buffer.getBatch(batch, batchSize) > 0) {
+                received += batch.size();
+                batch.clear();
+            }
+            producer.join();
+            report("ring buffer, batches of " + std::to_string(batchSize), received, elapsedMillis(start));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/BlockAllocator.h"
+
+#include <cstdio>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+TEST(BlockAllocatorTest, TestConcurrentAllocation) {
+    BlockAllocator *allocator = BlockAllocator::acquire(TEST_DB_PREFIX);
+    ASSERT_EQ(BlockAllocator::acquire(TEST_DB_PREFIX), allocator);
+    BlockAllocator::release(allocator);
+    allocator->initialize(BlockFile::RELATIONS, 1, true);
+    allocator->initialize(BlockFile::RELATIONS, 100);  // Already set by the first NodeManager
+    ASSERT_EQ(allocator->next(BlockFile::RELATIONS), 1);
+
+    std::vector<std::vector<unsigned int>> allocated(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < allocated.size(); t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 1000; i++) {
+                allocator->lockNodes(std::to_string(i), std::to_string(i * 7 + t));
+                allocated[t].push_back(allocator->allocate(BlockFile::RELATIONS));
+                allocator->unlockNodes(std::to_string(i), std::to_string(i * 7 + t));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::set<unsigned int> blocks;
+    for (auto &addresses : allocated) {
+        blocks.insert(addresses.begin(), addresses.end());
+    }
+    ASSERT_EQ(blocks.size(), 4000);
+    ASSERT_EQ(*blocks.begin(), 1);
+    ASSERT_EQ(allocator->next(BlockFile::RELATIONS), 4001);
+    ASSERT_EQ(allocator->allocate(BlockFile::RELATIONS, 10), 4001);
+    ASSERT_EQ(allocator->next(BlockFile::RELATIONS), 4011);
+    BlockAllocator::release(allocator);
+}
+
+TEST(BlockAllocatorTest, TestFreeBlockReuse) {
+    BlockAllocator *allocator = BlockAllocator::acquire(TEST_DB_PREFIX);
+    allocator->initialize(BlockFile::RELATIONS, 10, true);
+    allocator->initialize(BlockFile::PROPERTIES, 5, true);
+    allocator->free(BlockFile::RELATIONS, 3);
+    allocator->free(BlockFile::RELATIONS, 7);
+    allocator->free(BlockFile::PROPERTIES, 2);
+    ASSERT_EQ(allocator->freeCount(BlockFile::RELATIONS), 2);
+    ASSERT_EQ(allocator->allocate(BlockFile::RELATIONS), 7);
+    ASSERT_EQ(allocator->append(BlockFile::RELATIONS, 2), 10);  // Consecutive blocks come from the end of the file
+    ASSERT_EQ(allocator->allocate(BlockFile::RELATIONS, 2), 12);
+    BlockAllocator::release(allocator);
+
+    // Free blocks that were not reused are read back from _free_blocks.db
+    allocator = BlockAllocator::acquire(TEST_DB_PREFIX);
+    ASSERT_EQ(allocator->freeCount(BlockFile::RELATIONS), 1);
+    ASSERT_EQ(allocator->freeCount(BlockFile::PROPERTIES), 1);
+    allocator->initialize(BlockFile::RELATIONS, 14);
+    ASSERT_EQ(allocator->allocate(BlockFile::RELATIONS), 3);
+    ASSERT_EQ(allocator->allocate(BlockFile::RELATIONS), 14);
+    allocator->initialize(BlockFile::PROPERTIES, 1, true);  // A truncated file has no free blocks
+    ASSERT_EQ(allocator->freeCount(BlockFile::PROPERTIES), 0);
+    BlockAllocator::release(allocator);
+    std::remove((TEST_DB_PREFIX + "_free_blocks.db").c_str());
+}
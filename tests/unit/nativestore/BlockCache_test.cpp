@@ -0,0 +1,103 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/BlockCache.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+static const unsigned long TEST_BLOCK_SIZE = 40;
+
+static bool loadTestBlock(unsigned long address, char *block, int *loads) {
+    (*loads)++;
+    std::memset(block, 0, TEST_BLOCK_SIZE);
+    std::memcpy(block, &address, sizeof(address));
+    return true;
+}
+
+TEST(BlockCacheTest, TestHitsAndMisses) {
+    BlockCache cache(1024 * 1024);
+    cache.attach(TEST_RESOURCE_DIR "temp/g0_p0");
+    char block[TEST_BLOCK_SIZE];
+    int loads = 0;
+    for (int round = 0; round < 3; round++) {
+        for (unsigned long address = TEST_BLOCK_SIZE; address <= 10 * TEST_BLOCK_SIZE; address += TEST_BLOCK_SIZE) {
+            ASSERT_TRUE(cache.read(BlockFile::NODES, address, block, TEST_BLOCK_SIZE,
+                                   [address, &loads](char *buffer) { return loadTestBlock(address, buffer, &loads); }));
+            unsigned long stored;
+            std::memcpy(&stored, block, sizeof(stored));
+            ASSERT_EQ(stored, address);
+        }
+    }
+    BlockCacheStats stats = cache.getStats();
+    ASSERT_EQ(loads, 10);
+    ASSERT_EQ(stats.misses, 10);
+    ASSERT_EQ(stats.hits, 20);
+    ASSERT_EQ(stats.residentBlocks, 10);
+    BlockCache::detach();
+}
+
+TEST(BlockCacheTest, TestEvictionStaysWithinBudget) {
+    BlockCache cache(1024);
+    cache.attach(TEST_RESOURCE_DIR "temp/g0_p0");
+    char block[TEST_BLOCK_SIZE];
+    int loads = 0;
+    for (unsigned long address = TEST_BLOCK_SIZE; address <= 100 * TEST_BLOCK_SIZE; address += TEST_BLOCK_SIZE) {
+        cache.read(BlockFile::RELATIONS, address, block, TEST_BLOCK_SIZE,
+                   [address, &loads](char *buffer) { return loadTestBlock(address, buffer, &loads); });
+    }
+    BlockCacheStats stats = cache.getStats();
+    ASSERT_LE(stats.residentBytes, cache.getCapacity());
+    ASSERT_GT(stats.evictions, 0);
+    ASSERT_EQ(stats.residentBlocks + stats.evictions, 100);
+    BlockCache::detach();
+}
+
+TEST(BlockCacheTest, TestDirtyBlocksAreWrittenBackOnFlush) {
+    std::string prefix = TEST_RESOURCE_DIR "temp/g1_p0";
+    std::string nodesDBPath = prefix + "_nodes.db";
+    {
+        std::ofstream nodesDB(nodesDBPath, std::ios::binary | std::ios::trunc);
+        std::string empty(2 * TEST_BLOCK_SIZE, '\0');
+        nodesDB.write(empty.data(), empty.size());
+    }
+    BlockCache cache(1024 * 1024);
+    unsigned int partition = cache.attach(prefix);
+    char block[TEST_BLOCK_SIZE];
+    int loads = 0;
+    cache.read(BlockFile::NODES, TEST_BLOCK_SIZE, block, TEST_BLOCK_SIZE,
+               [&loads](char *buffer) { return loadTestBlock(TEST_BLOCK_SIZE, buffer, &loads); });
+
+    unsigned int edgeRef = 1234;
+    ASSERT_TRUE(cache.writeBack(BlockFile::NODES, TEST_BLOCK_SIZE, 5, reinterpret_cast<char *>(&edgeRef),
+                                sizeof(edgeRef)));
+    // Blocks that are not resident are left to the caller
+    ASSERT_FALSE(cache.writeBack(BlockFile::NODES, 0, 5, reinterpret_cast<char *>(&edgeRef), sizeof(edgeRef)));
+
+    cache.read(BlockFile::NODES, TEST_BLOCK_SIZE, block, TEST_BLOCK_SIZE,
+               [&loads](char *buffer) { return loadTestBlock(TEST_BLOCK_SIZE, buffer, &loads); });
+    unsigned int cachedEdgeRef;
+    std::memcpy(&cachedEdgeRef, block + 5, sizeof(cachedEdgeRef));
+    ASSERT_EQ(cachedEdgeRef, edgeRef);
+
+    cache.flush(partition);
+    std::ifstream nodesDB(nodesDBPath, std::ios::binary);
+    nodesDB.seekg(TEST_BLOCK_SIZE + 5);
+    unsigned int storedEdgeRef = 0;
+    nodesDB.read(reinterpret_cast<char *>(&storedEdgeRef), sizeof(storedEdgeRef));
+    ASSERT_EQ(storedEdgeRef, edgeRef);
+    ASSERT_EQ(cache.getStats().writeBacks, 1);
+    BlockCache::detach();
+}
@@ -0,0 +1,79 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/BlockFormat.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "../../../src/nativestore/NodeBlock.h"
+#include "../../../src/nativestore/RelationBlock.h"
+#include "gtest/gtest.h"
+
+static const std::string TEST_PREFIX = TEST_RESOURCE_DIR "temp/g0_p9";
+
+static void removePartition() {
+    for (const char *suffix : {"_format", "_nodes.db", "_relations.db", "_nodes.db.migrate", "_relations.db.migrate"}) {
+        std::remove((TEST_PREFIX + suffix).c_str());
+    }
+}
+
+TEST(BlockFormatTest, TestEncodeAndDecode) {
+    BlockFormat::version = BlockFormat::BLOCK_INDICES;
+    ASSERT_EQ(BlockFormat::encode(0, 70), 0);
+    ASSERT_EQ(BlockFormat::encode(70 * 5, 70), 5);
+    ASSERT_EQ(BlockFormat::decode(5, 70), 70 * 5);
+    // Block indices address files far past 4 GiB
+    unsigned long address = 4000000000UL * 70;
+    ASSERT_EQ(BlockFormat::decode(BlockFormat::encode(address, 70), 70), address);
+
+    BlockFormat::version = BlockFormat::BYTE_OFFSETS;
+    ASSERT_EQ(BlockFormat::encode(70 * 5, 70), 70 * 5);
+    ASSERT_EQ(BlockFormat::decode(70 * 5, 70), 70 * 5);
+    ASSERT_EQ(BlockFormat::encode(address, 70), 0);  // Does not fit a byte offset record
+    BlockFormat::version = BlockFormat::LATEST;
+}
+
+TEST(BlockFormatTest, TestMigrate) {
+    removePartition();
+    ASSERT_EQ(BlockFormat::open(TEST_PREFIX, true), BlockFormat::LATEST);
+
+    // A partition without a _format file was written with byte offset references
+    removePartition();
+    std::vector<char> node(NodeBlock::BLOCK_SIZE * 2, 0);
+    unsigned int edgeRef = RelationBlock::BLOCK_SIZE * 3;
+    std::memcpy(node.data() + NodeBlock::BLOCK_SIZE + NodeBlock::EDGE_REF_OFFSET, &edgeRef, sizeof(edgeRef));
+    std::ofstream(TEST_PREFIX + "_nodes.db", std::ios::binary).write(node.data(), node.size());
+    std::vector<char> relation(RelationBlock::BLOCK_SIZE * 2, 0);
+    unsigned int source = NodeBlock::BLOCK_SIZE;
+    std::memcpy(relation.data() + RelationBlock::BLOCK_SIZE +
+                    RelationBlock::RECORD_SIZE * static_cast<int>(RelationOffsets::SOURCE),
+                &source, sizeof(source));
+    std::ofstream(TEST_PREFIX + "_relations.db", std::ios::binary).write(relation.data(), relation.size());
+    ASSERT_EQ(BlockFormat::open(TEST_PREFIX, false), BlockFormat::BYTE_OFFSETS);
+
+    ASSERT_TRUE(BlockFormat::migrate(TEST_PREFIX));
+    ASSERT_EQ(BlockFormat::open(TEST_PREFIX, false), BlockFormat::BLOCK_INDICES);
+    std::ifstream nodes(TEST_PREFIX + "_nodes.db", std::ios::binary);
+    nodes.read(node.data(), node.size());
+    std::memcpy(&edgeRef, node.data() + NodeBlock::BLOCK_SIZE + NodeBlock::EDGE_REF_OFFSET, sizeof(edgeRef));
+    ASSERT_EQ(edgeRef, 3);
+    std::ifstream relations(TEST_PREFIX + "_relations.db", std::ios::binary);
+    relations.read(relation.data(), relation.size());
+    BlockFormat::version = BlockFormat::BLOCK_INDICES;
+    ASSERT_EQ(RelationBlock::readRecord(relation.data() + RelationBlock::BLOCK_SIZE, RelationOffsets::SOURCE, false),
+              source);
+    removePartition();
+}
@@ -0,0 +1,81 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/BulkLoader.h"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+
+#include "../../../src/util/Utils.h"
+#include "gtest/gtest.h"
+
+static const std::string TEST_EDGES = TEST_RESOURCE_DIR "temp/bulkload_edges.txt";
+static const std::string TEST_CENTRAL_EDGES = TEST_RESOURCE_DIR "temp/bulkload_central.txt";
+static const std::string TEST_NODE_PROPERTIES = TEST_RESOURCE_DIR "temp/bulkload_nodes.csv";
+
+TEST(BulkLoaderTest, TestLoad) {
+    mkdir(Utils::getJasmineGraphProperty("org.jasminegraph.server.instance.datafolder").c_str(), 0755);
+    // (2, 1) duplicates (1, 2), 4 4 is a self loop
+    std::ofstream(TEST_EDGES) << "# source destination\n1 2\n1 3\n2 3\n2 1\n3 4\n4 4\n1,2\n";
+    std::ofstream(TEST_CENTRAL_EDGES) << "1 100 9 3\n";
+    std::ofstream(TEST_NODE_PROPERTIES) << "id,name\n1,\"one, the first\"\n3,three\n";
+
+    GraphConfig gConfig{43, 0, 9, "trunc"};
+    BulkLoader loader(gConfig, BulkLoader::DEFAULT_MEMORY_BYTES);
+    BulkLoader::Input input;
+    input.localEdges = {TEST_EDGES};
+    input.centralEdges = {TEST_CENTRAL_EDGES};
+    input.nodeProperties = TEST_NODE_PROPERTIES;
+    ASSERT_TRUE(loader.load(input));
+    ASSERT_EQ(loader.nodeCount(), 5);
+    ASSERT_EQ(loader.localRelationCount(), 5);
+    ASSERT_EQ(loader.centralRelationCount(), 1);
+
+    gConfig.openMode = NodeManager::FILE_MODE;
+    NodeManager nodeManager(gConfig);
+    std::map<long, std::unordered_set<long>> expected = {{1, {2, 3}}, {2, {3}}, {3, {4}}, {4, {4}}};
+    ASSERT_EQ(nodeManager.getAdjacencyList(true), expected);
+
+    std::multiset<unsigned int> neighbors;
+    NodeBlock *node = nodeManager.get("3");
+    nodeManager.forEachNeighbor(node->addr, false, [&](const RelationView &relation) {
+        neighbors.insert(relation.neighborId());
+    });
+    ASSERT_EQ(neighbors, std::multiset<unsigned int>({1, 2, 4}));
+    PropertyValue name;
+    ASSERT_TRUE(node->getProperty("name", name));
+    ASSERT_EQ(name.toString(), "three");
+    delete node;
+
+    node = nodeManager.get("1");
+    ASSERT_TRUE(node->getProperty("name", name));
+    ASSERT_EQ(name.toString(), "one, the first");
+    RelationCursor cursor(node->addr, true);
+    RelationView relation;
+    ASSERT_TRUE(cursor.next(relation));
+    ASSERT_EQ(relation.neighborId(), 100);
+    ASSERT_EQ(relation.getPartitionId(), "9");
+    ASSERT_FALSE(cursor.next(relation));
+    delete node;
+
+    // Edges streamed into the loaded partition are checked against the loaded ones
+    ASSERT_EQ(nodeManager.addLocalEdge({"3", "2"}), nullptr);
+    RelationBlock *added = nodeManager.addLocalEdge({"4", "5"});
+    ASSERT_NE(added, nullptr);
+    delete added;
+    nodeManager.close();
+}
@@ -0,0 +1,37 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/CsrSnapshot.h"
+
+#include "gtest/gtest.h"
+
+TEST(CsrSnapshotTest, TestFromEdges) {
+    std::vector<std::pair<unsigned int, unsigned int>> edges = {{0, 2}, {2, 1}, {0, 1}, {0, 2}, {1, 0}};
+    CsrSnapshot directed = CsrSnapshot::fromEdges(edges, {10, 11, 12, 13}, false);
+    ASSERT_EQ(directed.vertexCount(), 4);
+    ASSERT_EQ(directed.edgeCount(), 4);  // The duplicate 0 -> 2 is dropped
+    ASSERT_EQ(std::vector<unsigned int>(directed.begin(0), directed.end(0)), std::vector<unsigned int>({1, 2}));
+    ASSERT_EQ(directed.degree(3), 0);
+
+    CsrSnapshot undirected = CsrSnapshot::fromEdges(edges, {10, 11, 12, 13}, true);
+    ASSERT_EQ(std::vector<unsigned int>(undirected.begin(1), undirected.end(1)), std::vector<unsigned int>({0, 2}));
+    ASSERT_EQ(undirected.edgeCount(), 6);
+
+    auto adjacencyList = directed.toAdjacencyList(false);
+    ASSERT_EQ(adjacencyList.size(), 3);
+    ASSERT_EQ(adjacencyList[10], std::unordered_set<long>({11, 12}));
+    auto degreeMap = undirected.toDegreeMap();
+    ASSERT_EQ(degreeMap.size(), 4);
+    ASSERT_EQ(degreeMap[12], 2);
+    ASSERT_EQ(degreeMap[13], 0);
+}
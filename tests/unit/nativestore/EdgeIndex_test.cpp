@@ -0,0 +1,77 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/EdgeIndex.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "../../../src/nativestore/RelationBlock.h"
+#include "gtest/gtest.h"
+
+static const std::string TEST_INDEX_PATH = TEST_RESOURCE_DIR "temp/g0_p0_relations.hindex.db";
+static const std::string TEST_RELATIONS_PATH = TEST_RESOURCE_DIR "temp/g0_p0_relations.db";
+
+TEST(EdgeIndexTest, TestInsertAndFind) {
+    std::remove(TEST_INDEX_PATH.c_str());
+    bool opened = false;
+    EdgeIndex *index = EdgeIndex::acquire(TEST_INDEX_PATH, &opened);
+    ASSERT_TRUE(opened);
+    ASSERT_EQ(EdgeIndex::acquire(TEST_INDEX_PATH, &opened), index);
+    ASSERT_FALSE(opened);  // Only the NodeManager that opens the index checks it
+    EdgeIndex::release(index);
+    for (unsigned int i = 1; i <= 3000; i++) {  // Grows the table past its initial capacity
+        index->insert(i * 40, (i % 7) * 40, i * 70);
+    }
+    ASSERT_EQ(index->size(), 3000);
+    ASSERT_EQ(index->find(40 * 10, 40 * 3), 700);
+    ASSERT_EQ(index->find(40 * 3, 40 * 10), 700);  // Edges are undirected
+    ASSERT_EQ(index->find(40 * 10, 40 * 4), 0);
+
+    index->insert(40 * 3, 40 * 10, 999 * 70);  // Duplicate edges keep the first relation block
+    ASSERT_EQ(index->size(), 3000);
+    ASSERT_EQ(index->relationCount(), 3001);
+    ASSERT_EQ(index->find(40 * 10, 40 * 3), 700);
+    EdgeIndex::release(index);
+    std::remove(TEST_INDEX_PATH.c_str());
+}
+
+TEST(EdgeIndexTest, TestRebuild) {
+    std::remove(TEST_INDEX_PATH.c_str());
+    const unsigned long blockSize = 70;
+    std::ofstream relations(TEST_RELATIONS_PATH, std::ios::binary | std::ios::trunc);
+    std::vector<char> block(blockSize, 0);
+    relations.write(block.data(), blockSize);  // Block 0 is never used
+    for (unsigned int i = 1; i <= 100; i++) {
+        unsigned int source = i;  // Node block indexes, the records of the latest block format
+        unsigned int destination = i + 1;
+        std::memcpy(block.data() + RelationBlock::RECORD_SIZE * static_cast<int>(RelationOffsets::SOURCE), &source,
+                    sizeof(source));
+        std::memcpy(block.data() + RelationBlock::RECORD_SIZE * static_cast<int>(RelationOffsets::DESTINATION),
+                    &destination, sizeof(destination));
+        relations.write(block.data(), blockSize);
+    }
+    relations.close();
+
+    EdgeIndex *index = EdgeIndex::acquire(TEST_INDEX_PATH);
+    ASSERT_TRUE(index->rebuild(TEST_RELATIONS_PATH, blockSize));
+    ASSERT_EQ(index->size(), 100);
+    ASSERT_EQ(index->relationCount(), 100);
+    ASSERT_EQ(index->find(51 * 40, 50 * 40), 50 * blockSize);
+    ASSERT_EQ(index->find(40, 3 * 40), 0);
+    EdgeIndex::release(index);
+    std::remove(TEST_INDEX_PATH.c_str());
+    std::remove(TEST_RELATIONS_PATH.c_str());
+}
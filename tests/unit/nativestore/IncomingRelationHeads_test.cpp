@@ -0,0 +1,48 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/IncomingRelationHeads.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "../../../src/nativestore/RelationBlock.h"
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+TEST(IncomingRelationHeadsTest, TestSetAndAssign) {
+    std::remove((TEST_DB_PREFIX + "_incoming_heads.db").c_str());
+    ASSERT_FALSE(IncomingRelationHeads::exists(TEST_DB_PREFIX));
+    IncomingRelationHeads *heads = IncomingRelationHeads::acquire(TEST_DB_PREFIX);
+    ASSERT_EQ(heads->get(3, false), 0);
+    ASSERT_TRUE(heads->set(3, false, 5 * RelationBlock::BLOCK_SIZE));
+    ASSERT_TRUE(heads->set(5000, true, 9 * RelationBlock::CENTRAL_BLOCK_SIZE));  // Grows the file
+    ASSERT_TRUE(IncomingRelationHeads::exists(TEST_DB_PREFIX));
+    ASSERT_EQ(heads->get(3, false), 5 * RelationBlock::BLOCK_SIZE);
+    ASSERT_EQ(heads->get(3, true), 0);
+    ASSERT_EQ(heads->get(5000, true), 9 * RelationBlock::CENTRAL_BLOCK_SIZE);
+    IncomingRelationHeads::release(heads);
+
+    heads = IncomingRelationHeads::acquire(TEST_DB_PREFIX);
+    ASSERT_EQ(heads->get(3, false), 5 * RelationBlock::BLOCK_SIZE);
+    std::vector<unsigned int> local = {0, 2, 0, 4};
+    ASSERT_TRUE(heads->assign(local, false));
+    ASSERT_EQ(heads->get(1, false), 2 * RelationBlock::BLOCK_SIZE);
+    ASSERT_EQ(heads->get(3, false), 4 * RelationBlock::BLOCK_SIZE);
+    ASSERT_EQ(heads->get(5000, true), 9 * RelationBlock::CENTRAL_BLOCK_SIZE);
+    heads->truncate();
+    ASSERT_EQ(heads->get(3, false), 0);
+    IncomingRelationHeads::release(heads);
+    std::remove((TEST_DB_PREFIX + "_incoming_heads.db").c_str());
+}
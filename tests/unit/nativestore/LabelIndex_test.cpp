@@ -0,0 +1,46 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/LabelIndex.h"
+
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+TEST(LabelIndexTest, TestLabelScans) {
+    LabelIndex *index = LabelIndex::acquire(TEST_DB_PREFIX);
+    index->truncate();
+    for (unsigned int i = 0; i < 1000; i++) {
+        if (i % 2 == 0) {
+            index->add("Even", i);
+        }
+        if (i % 3 == 0) {
+            index->add("Triple", i);
+        }
+    }
+    index->remove("Even", 0);
+    LabelIndex::release(index);
+
+    index = LabelIndex::acquire(TEST_DB_PREFIX);
+    std::vector<unsigned int> even = index->getNodes("Even");
+    ASSERT_EQ(even.size(), 499);
+    ASSERT_EQ(even.front(), 2);
+    ASSERT_EQ(even.back(), 998);
+    ASSERT_EQ(index->getNodes({"Even", "Triple"}, true).size(), 166);   // Multiples of 6, without 0
+    ASSERT_EQ(index->getNodes({"Even", "Triple"}, false).size(), 667);  // 0 is still a Triple node
+    ASSERT_TRUE(index->getNodes("Odd").empty());
+    index->truncate();
+    ASSERT_TRUE(index->getLabels().empty());
+    LabelIndex::release(index);
+    std::remove((TEST_DB_PREFIX + "_labels.db").c_str());
+}
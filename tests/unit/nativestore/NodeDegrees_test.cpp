@@ -0,0 +1,75 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/NodeDegrees.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "../../../src/nativestore/RelationBlock.h"
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+TEST(NodeDegreesTest, TestCountAndRebuild) {
+    std::remove((TEST_DB_PREFIX + "_degrees.db").c_str());
+    bool opened = false;
+    NodeDegrees *degrees = NodeDegrees::acquire(TEST_DB_PREFIX, &opened);
+    ASSERT_TRUE(opened);
+    ASSERT_EQ(NodeDegrees::acquire(TEST_DB_PREFIX, &opened), degrees);
+    ASSERT_FALSE(opened);  // Only the NodeManager that opens the counters checks them
+    NodeDegrees::release(degrees);
+    for (unsigned int i = 0; i < 3000; i++) {  // Grows the file past its initial capacity
+        degrees->addRelation(i, i + 1, false);
+    }
+    degrees->addRelation(7, 7, false);
+    degrees->addRelation(7, 5000, true);
+    NodeDegree degree = degrees->get(7);
+    ASSERT_EQ(degree.localOut, 2);
+    ASSERT_EQ(degree.localIn, 2);
+    ASSERT_EQ(degree.centralOut, 1);
+    ASSERT_EQ(degree.total(), 5);
+    ASSERT_EQ(degrees->get(5000).centralIn, 1);
+    ASSERT_EQ(degrees->relationCount(false), 3001);
+    degrees->removeRelation(7, 7, false);
+    ASSERT_EQ(degrees->get(7).local(), 2);
+    unsigned long total = 0;
+    degrees->scan(0, 3001, [&](unsigned int node, const NodeDegree &degree) { total += degree.local(); });
+    ASSERT_EQ(total, 6000);
+
+    // Relation blocks whose source and destination records are node block indexes, block 0 is never used
+    const std::string relationsPath = TEST_DB_PREFIX + "_relations.db";
+    std::ofstream relations(relationsPath, std::ios::binary | std::ios::trunc);
+    std::vector<char> block(RelationBlock::BLOCK_SIZE, 0);
+    relations.write(block.data(), block.size());
+    for (unsigned int i = 1; i <= 10; i++) {
+        unsigned int destination = 0;
+        std::memcpy(block.data() + RelationBlock::RECORD_SIZE * static_cast<int>(RelationOffsets::SOURCE), &i,
+                    sizeof(i));
+        std::memcpy(block.data() + RelationBlock::RECORD_SIZE * static_cast<int>(RelationOffsets::DESTINATION),
+                    &destination, sizeof(destination));
+        relations.write(block.data(), block.size());
+    }
+    relations.close();
+    std::ofstream(TEST_DB_PREFIX + "_central_relations.db", std::ios::trunc);
+    ASSERT_TRUE(degrees->rebuild(relationsPath, TEST_DB_PREFIX + "_central_relations.db"));
+    ASSERT_EQ(degrees->relationCount(false), 10);
+    ASSERT_EQ(degrees->get(0).localIn, 10);
+    ASSERT_EQ(degrees->get(7).total(), 1);
+    NodeDegrees::release(degrees);
+    for (const char *suffix : {"_degrees.db", "_relations.db", "_central_relations.db"}) {
+        std::remove((TEST_DB_PREFIX + suffix).c_str());
+    }
+}
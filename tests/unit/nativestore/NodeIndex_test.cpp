@@ -0,0 +1,85 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/NodeIndex.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+static void removeIndexFiles() {
+    std::remove((TEST_DB_PREFIX + "_nodes.hindex.db").c_str());
+    std::remove((TEST_DB_PREFIX + "_nodes.keys.db").c_str());
+    std::remove((TEST_DB_PREFIX + "_nodes.index.db").c_str());
+}
+
+TEST(NodeIndexTest, TestInsertAndPersist) {
+    removeIndexFiles();
+    std::string longKey(200, 'k');  // Longer than any fixed index key size
+    NodeIndex *index = NodeIndex::acquire(TEST_DB_PREFIX);
+    for (unsigned int i = 0; i < 5000; i++) {  // Grows the table past its initial capacity
+        index->insert(std::to_string(i), i);
+    }
+    index->insert(longKey, 5000);
+    index->insert("42", 7);  // Existing keys keep their node index
+    ASSERT_EQ(index->size(), 5001);
+    NodeIndex::release(index);
+
+    index = NodeIndex::acquire(TEST_DB_PREFIX);
+    unsigned int nodeIndex;
+    ASSERT_TRUE(index->find("42", nodeIndex));
+    ASSERT_EQ(nodeIndex, 42);
+    ASSERT_TRUE(index->find(longKey, nodeIndex));
+    ASSERT_EQ(nodeIndex, 5000);
+    ASSERT_FALSE(index->contains("5001"));
+    ASSERT_FALSE(index->contains(longKey.substr(1)));
+
+    unsigned int expected = 0;
+    for (auto entry : *index) {  // Entries come back in insertion order
+        ASSERT_EQ(entry.second, expected);
+        expected++;
+    }
+    ASSERT_EQ(expected, 5001);
+    NodeIndex::release(index);
+    removeIndexFiles();
+}
+
+TEST(NodeIndexTest, TestLegacyMigrationAndTruncate) {
+    removeIndexFiles();
+    const unsigned long keySize = 6;
+    std::ofstream legacyIndex(TEST_DB_PREFIX + "_nodes.index.db", std::ios::binary);
+    for (unsigned int i = 0; i < 10; i++) {
+        char key[keySize] = {0};
+        std::strcpy(key, std::to_string(i * 100).c_str());
+        legacyIndex.write(key, keySize);
+        legacyIndex.write(reinterpret_cast<char *>(&i), sizeof(unsigned int));
+    }
+    legacyIndex.close();
+
+    NodeIndex *index = NodeIndex::acquire(TEST_DB_PREFIX);
+    index->migrateLegacyIndex(TEST_DB_PREFIX + "_nodes.index.db", keySize);
+    ASSERT_EQ(index->size(), 10);
+    unsigned int nodeIndex;
+    ASSERT_TRUE(index->find("900", nodeIndex));
+    ASSERT_EQ(nodeIndex, 9);
+
+    index->truncate();
+    ASSERT_EQ(index->size(), 0);
+    ASSERT_FALSE(index->contains("900"));
+    NodeIndex::release(index);
+    removeIndexFiles();
+}
@@ -0,0 +1,508 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/NodeManager.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../../src/nativestore/EdgeIndex.h"
+#include "../../../src/nativestore/StorageMetrics.h"
+#include "../../../src/util/Utils.h"
+#include "gtest/gtest.h"
+
+// Block reads and writes of every block file of a partition so far
+static unsigned long blockAccesses(const std::string &dbPrefix) {
+    StorageMetrics::Snapshot snapshot = StorageMetrics::get(dbPrefix)->snapshot();
+    unsigned long accesses = 0;
+    for (const auto &file : snapshot.files) {
+        accesses += file.reads + file.writes;
+    }
+    return accesses;
+}
+
+// Empty partition of graph 0 opened in trunc mode
+static GraphConfig truncatedPartition(unsigned int partitionID) {
+    mkdir(Utils::getJasmineGraphProperty("org.jasminegraph.server.instance.datafolder").c_str(), 0755);
+    return GraphConfig{43, 0, partitionID, "trunc"};
+}
+
+// Neighbors in the outgoing or incoming local chain of a node, in chain order. Every relation of the chain has to
+// point back at the relation before it
+static std::vector<unsigned int> chain(NodeManager &nodeManager, const std::string &nodeId, bool outgoing) {
+    std::vector<unsigned int> neighbors;
+    NodeBlock *node = nodeManager.get(nodeId);
+    if (!node) {
+        return neighbors;
+    }
+    RelationCursor cursor(node->addr, false, outgoing ? RelationDirection::OUTGOING : RelationDirection::INCOMING);
+    delete node;
+    RelationView relation;
+    unsigned long previous = 0;
+    while (cursor.next(relation)) {
+        EXPECT_EQ((outgoing ? relation.source : relation.destination).preRelationId, previous);
+        previous = relation.addr;
+        neighbors.push_back(relation.neighborId());
+    }
+    return neighbors;
+}
+
+// Relation block indexes of the local relations with the type, in ascending order
+static std::vector<unsigned int> typedRelations(NodeManager &nodeManager, const std::string &type) {
+    return nodeManager.relationTypeIndex->getRelations(type, false);
+}
+
+static unsigned int relationIndex(RelationBlock *relation) {
+    unsigned int index = relation->addr / RelationBlock::BLOCK_SIZE;
+    delete relation;
+    return index;
+}
+
+static void assertDegree(NodeManager &nodeManager, const std::string &nodeId, unsigned long in, unsigned long out) {
+    NodeDegree degree = nodeManager.getDegree(nodeId);
+    ASSERT_EQ(degree.localIn, in) << nodeId;
+    ASSERT_EQ(degree.localOut, out) << nodeId;
+}
+
+TEST(NodeManagerTest, TestSecondOpenKeepsPendingLog) {
+    GraphConfig gConfig = truncatedPartition(11);
+    NodeManager writer(gConfig);
+    writer.ownWriteAheadLog();
+    ASSERT_NE(writer.wal, nullptr);
+    writer.wal->append(WalRecordType::LOCAL_EDGE, std::vector<std::string>{"1 2", "2 3"});
+    delete writer.addLocalEdge({"1", "2"});
+    delete writer.addLocalEdge({"2", "3"});
+    NodeDegree degree = writer.getDegree("2");
+
+    // A reader opened while the writer logs shares its log, the partition is not repaired and the log is kept
+    gConfig.openMode = NodeManager::FILE_MODE;
+    unsigned long accesses = blockAccesses(writer.getDbPrefix());
+    std::thread reader([&gConfig, &writer]() {
+        NodeManager nodeManager(gConfig);
+        ASSERT_EQ(nodeManager.wal, writer.wal);
+        ASSERT_EQ(nodeManager.wal->size(), 2);
+        nodeManager.checkpoint();
+    });
+    reader.join();
+    ASSERT_EQ(blockAccesses(writer.getDbPrefix()), accesses);  // No index or relation chain was rebuilt
+    ASSERT_EQ(writer.wal->size(), 2);
+    ASSERT_EQ(writer.nodeIndex->size(), 3);
+    NodeDegree after = writer.getDegree("2");
+    ASSERT_EQ(after.localIn, degree.localIn);
+    ASSERT_EQ(after.localOut, degree.localOut);
+    ASSERT_EQ(writer.addLocalEdge({"1", "2"}), nullptr);  // Still found by the edge index
+    NodeBlock *node = writer.addNode("4");
+    ASSERT_EQ(node->addr, 3 * NodeBlock::BLOCK_SIZE);  // Node blocks are not handed out again
+    delete node;
+
+    writer.checkpoint();
+    ASSERT_EQ(writer.wal->size(), 0);
+}
+
+TEST(NodeManagerTest, TestDeleteEdgeRelinksChains) {
+    NodeManager nodeManager(truncatedPartition(12));
+    std::map<std::pair<std::string, std::string>, unsigned int> relations;
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{
+             {"1", "2"}, {"1", "3"}, {"1", "4"}, {"1", "5"}, {"6", "10"}, {"7", "10"}, {"8", "10"}, {"9", "10"}}) {
+        RelationBlock *relation = nodeManager.addLocalEdge(edge);
+        ASSERT_NE(relation, nullptr);
+        relation->addLocalRelationshipType("KNOWS");
+        relations[edge] = relationIndex(relation);
+    }
+    auto remove = [&](const std::string &source, const std::string &destination) {
+        ASSERT_TRUE(nodeManager.deleteEdge(source, destination));
+        relations.erase({source, destination});
+    };
+
+    // Head, middle and tail of the outgoing chain of 1
+    std::vector<unsigned int> out = chain(nodeManager, "1", true);
+    ASSERT_EQ(out.size(), 4);
+    remove("1", std::to_string(out[0]));
+    ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({out[1], out[2], out[3]}));
+    remove("1", std::to_string(out[2]));
+    ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({out[1], out[3]}));
+    remove("1", std::to_string(out[3]));
+    ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({out[1]}));
+    ASSERT_TRUE(chain(nodeManager, std::to_string(out[0]), false).empty());
+    ASSERT_EQ(chain(nodeManager, std::to_string(out[1]), false), std::vector<unsigned int>({1}));
+
+    // Head, middle and tail of the incoming chain of 10
+    std::vector<unsigned int> in = chain(nodeManager, "10", false);
+    ASSERT_EQ(in.size(), 4);
+    remove(std::to_string(in[0]), "10");
+    ASSERT_EQ(chain(nodeManager, "10", false), std::vector<unsigned int>({in[1], in[2], in[3]}));
+    remove(std::to_string(in[2]), "10");
+    ASSERT_EQ(chain(nodeManager, "10", false), std::vector<unsigned int>({in[1], in[3]}));
+    remove(std::to_string(in[3]), "10");
+    ASSERT_EQ(chain(nodeManager, "10", false), std::vector<unsigned int>({in[1]}));
+    ASSERT_TRUE(chain(nodeManager, std::to_string(in[0]), true).empty());
+
+    assertDegree(nodeManager, "1", 0, 1);
+    assertDegree(nodeManager, std::to_string(out[0]), 0, 0);
+    assertDegree(nodeManager, "10", 1, 0);
+    assertDegree(nodeManager, std::to_string(in[1]), 0, 1);
+
+    std::vector<unsigned int> typed;
+    for (const auto &relation : relations) {
+        typed.push_back(relation.second);
+    }
+    std::sort(typed.begin(), typed.end());
+    ASSERT_EQ(typedRelations(nodeManager, "KNOWS"), typed);
+
+    // The edge index forgets deleted edges only
+    ASSERT_FALSE(nodeManager.deleteEdge("1", std::to_string(out[0])));
+    ASSERT_EQ(nodeManager.addLocalEdge({"1", std::to_string(out[1])}), nullptr);
+    RelationBlock *added = nodeManager.addLocalEdge({"1", std::to_string(out[0])});
+    ASSERT_NE(added, nullptr);
+    delete added;
+    ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({out[0], out[1]}));
+    assertDegree(nodeManager, "1", 0, 2);
+}
+
+TEST(NodeManagerTest, TestDeleteNodeWithRelationsNeedsDetach) {
+    NodeManager nodeManager(truncatedPartition(13));
+    delete nodeManager.addLocalEdge({"1", "2"});
+    delete nodeManager.addNode("3");
+
+    ASSERT_FALSE(nodeManager.deleteNode("1"));
+    ASSERT_FALSE(nodeManager.deleteNode("2"));
+    NodeBlock *node = nodeManager.get("1");
+    ASSERT_NE(node, nullptr);
+    delete node;
+    ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({2}));
+    assertDegree(nodeManager, "1", 0, 1);
+    assertDegree(nodeManager, "2", 1, 0);
+
+    ASSERT_FALSE(nodeManager.deleteNode("4"));
+    ASSERT_TRUE(nodeManager.deleteNode("3"));
+    ASSERT_EQ(nodeManager.get("3"), nullptr);
+    ASSERT_FALSE(nodeManager.deleteNode("3"));
+}
+
+TEST(NodeManagerTest, TestDetachDeleteWithSelfLoop) {
+    NodeManager nodeManager(truncatedPartition(14));
+    unsigned int kept = 0;
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{
+             {"1", "2"}, {"1", "1"}, {"2", "3"}, {"3", "1"}}) {
+        RelationBlock *relation = nodeManager.addLocalEdge(edge);
+        ASSERT_NE(relation, nullptr);
+        relation->addLocalRelationshipType("LINK");
+        unsigned int index = relationIndex(relation);
+        if (edge.first == "2") {
+            kept = index;
+        }
+    }
+    assertDegree(nodeManager, "1", 2, 2);
+
+    ASSERT_TRUE(nodeManager.deleteNode("1", true));
+    ASSERT_EQ(nodeManager.get("1"), nullptr);
+    ASSERT_EQ(chain(nodeManager, "2", true), std::vector<unsigned int>({3}));
+    ASSERT_TRUE(chain(nodeManager, "2", false).empty());
+    ASSERT_TRUE(chain(nodeManager, "3", true).empty());
+    ASSERT_EQ(chain(nodeManager, "3", false), std::vector<unsigned int>({2}));
+    assertDegree(nodeManager, "2", 0, 1);
+    assertDegree(nodeManager, "3", 1, 0);
+    ASSERT_EQ(typedRelations(nodeManager, "LINK"), std::vector<unsigned int>({kept}));
+    ASSERT_FALSE(nodeManager.deleteEdge("3", "1"));
+    ASSERT_EQ(nodeManager.addLocalEdge({"2", "3"}), nullptr);
+
+    // The node comes back as a new node without relations
+    RelationBlock *added = nodeManager.addLocalEdge({"1", "1"});
+    ASSERT_NE(added, nullptr);
+    delete added;
+    ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({1}));
+    ASSERT_EQ(chain(nodeManager, "1", false), std::vector<unsigned int>({1}));
+    assertDegree(nodeManager, "1", 1, 1);
+}
+
+TEST(NodeManagerTest, TestAddEdgesLinksLikeSingleInserts) {
+    // The batch extends chains already on disk, repeats an edge of the batch and one on disk and has self loops
+    std::vector<std::pair<std::string, std::string>> existing = {{"1", "2"}, {"2", "3"}};
+    std::vector<std::pair<std::string, std::string>> batch = {{"1", "3"}, {"3", "4"}, {"1", "3"}, {"2", "2"},
+                                                              {"4", "1"}, {"2", "1"}, {"2", "4"}, {"4", "4"}};
+    struct Linked {
+        std::vector<unsigned long> addresses;
+        std::map<std::string, std::vector<unsigned int>> outgoing;
+        std::map<std::string, std::vector<unsigned int>> incoming;
+        std::map<std::string, std::pair<unsigned long, unsigned long>> degrees;
+    };
+    // The block file streams are per thread, the partitions are opened one after the other
+    auto insert = [&](unsigned int partitionID, bool batched) {
+        NodeManager nodeManager(truncatedPartition(partitionID));
+        for (const auto &edge : existing) {
+            delete nodeManager.addLocalEdge(edge);
+        }
+        Linked linked;
+        if (batched) {
+            linked.addresses = nodeManager.addEdges(batch);
+        } else {
+            for (const auto &edge : batch) {
+                RelationBlock *relation = nodeManager.addLocalEdge(edge);
+                linked.addresses.push_back(relation ? relation->addr : 0);
+                delete relation;
+            }
+        }
+        for (const std::string nodeId : {"1", "2", "3", "4"}) {
+            linked.outgoing[nodeId] = chain(nodeManager, nodeId, true);
+            linked.incoming[nodeId] = chain(nodeManager, nodeId, false);
+            NodeDegree degree = nodeManager.getDegree(nodeId);
+            linked.degrees[nodeId] = {degree.localIn, degree.localOut};
+        }
+        // Duplicates of the batch are found like those of single inserts
+        EXPECT_EQ(nodeManager.addLocalEdge({"1", "4"}), nullptr);
+        EXPECT_EQ(nodeManager.addEdges({{"2", "2"}, {"3", "1"}}), std::vector<unsigned long>({0, 0}));
+        return linked;
+    };
+
+    Linked single = insert(15, false);
+    Linked batched = insert(16, true);
+    ASSERT_EQ(batched.addresses, single.addresses);
+    ASSERT_EQ(batched.addresses[2], 0);
+    ASSERT_EQ(batched.addresses[5], 0);
+    ASSERT_EQ(batched.outgoing, single.outgoing);
+    ASSERT_EQ(batched.incoming, single.incoming);
+    ASSERT_EQ(batched.degrees, single.degrees);
+    ASSERT_EQ(batched.outgoing["2"].size(), 3);
+    ASSERT_EQ(batched.incoming["4"].size(), 3);
+}
+
+TEST(NodeManagerTest, TestCompactionKeepsNeighbours) {
+    NodeManager nodeManager(truncatedPartition(17));
+    std::vector<std::pair<std::string, std::string>> edges;
+    // Streamed edges of the nodes are spread over the whole relation file
+    for (int i = 0; i < 60; i++) {
+        std::pair<std::string, std::string> edge{std::to_string(i % 7 + 1), std::to_string(i * 3 % 11 + 1)};
+        RelationBlock *relation = nodeManager.addLocalEdge(edge);
+        if (!relation) {
+            continue;
+        }
+        if (i % 4 == 0) {
+            relation->addLocalRelationshipType("NEAR");
+        }
+        delete relation;
+        edges.push_back(edge);
+    }
+    // Free blocks of deleted relations are dropped by the compaction
+    for (size_t i = 0; i < edges.size(); i += 5) {
+        ASSERT_TRUE(nodeManager.deleteEdge(edges[i].first, edges[i].second));
+    }
+
+    auto neighbors = [&nodeManager]() {
+        std::map<std::string, std::pair<std::vector<unsigned int>, std::vector<unsigned int>>> all;
+        for (unsigned int id = 1; id <= 11; id++) {
+            auto &lists = all[std::to_string(id)];
+            lists.first = chain(nodeManager, std::to_string(id), true);
+            lists.second = chain(nodeManager, std::to_string(id), false);
+            std::sort(lists.first.begin(), lists.first.end());
+            std::sort(lists.second.begin(), lists.second.end());
+        }
+        return all;
+    };
+    auto typedEdges = [&nodeManager]() {
+        std::vector<std::pair<unsigned int, unsigned int>> typed;
+        for (unsigned int index : typedRelations(nodeManager, "NEAR")) {
+            RelationView relation;
+            EXPECT_TRUE(RelationView::read((unsigned long)index * RelationBlock::BLOCK_SIZE, false, relation));
+            typed.push_back({relation.source.nodeId, relation.destination.nodeId});
+        }
+        std::sort(typed.begin(), typed.end());
+        return typed;
+    };
+    auto before = neighbors();
+    auto typedBefore = typedEdges();
+    ASSERT_FALSE(typedBefore.empty());
+
+    ASSERT_TRUE(nodeManager.compactRelations(false));
+    ASSERT_EQ(neighbors(), before);
+    ASSERT_EQ(typedEdges(), typedBefore);
+
+    // The edge index finds every edge at its new address
+    EdgeIndex *edgeIndex = EdgeIndex::acquire(nodeManager.getDbPrefix() + "_relations.hindex.db");
+    for (size_t i = 0; i < edges.size(); i++) {
+        NodeBlock *source = nodeManager.get(edges[i].first);
+        NodeBlock *destination = nodeManager.get(edges[i].second);
+        unsigned long address = edgeIndex->find(source->addr, destination->addr);
+        if (i % 5 == 0) {
+            ASSERT_EQ(address, 0);
+        } else {
+            RelationView relation;
+            ASSERT_TRUE(RelationView::read(address, false, relation));
+            ASSERT_EQ(relation.source.address, source->addr);
+            ASSERT_EQ(relation.destination.address, destination->addr);
+        }
+        delete source;
+        delete destination;
+    }
+    EdgeIndex::release(edgeIndex);
+    ASSERT_EQ(nodeManager.addLocalEdge(edges[1]), nullptr);
+}
+
+TEST(NodeManagerTest, TestThreadStoreReadsOnOtherThread) {
+    NodeManager nodeManager(truncatedPartition(19));
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{{"1", "2"}, {"1", "3"}, {"3", "1"}}) {
+        delete nodeManager.addLocalEdge(edge);
+    }
+    std::vector<unsigned int> outgoing = chain(nodeManager, "1", true);
+    std::vector<unsigned int> incoming = chain(nodeManager, "1", false);
+    ASSERT_EQ(outgoing.size(), 2);
+
+    std::thread helper([&]() {
+        {
+            NodeManager::ThreadStore threadStore(nodeManager);
+            ASSERT_NE(NodeBlock::nodesDB, nullptr);
+            ASSERT_EQ(LabelIndex::current, nodeManager.labelIndex);
+            ASSERT_EQ(chain(nodeManager, "1", true), outgoing);
+            ASSERT_EQ(chain(nodeManager, "1", false), incoming);
+        }
+        // The streams of the thread are closed with the scope
+        ASSERT_EQ(NodeBlock::nodesDB, nullptr);
+        ASSERT_EQ(RelationBlock::relationsDB, nullptr);
+        ASSERT_EQ(LabelIndex::current, nullptr);
+    });
+    helper.join();
+    // The streams of the NodeManager's own thread are untouched
+    ASSERT_EQ(chain(nodeManager, "1", true), outgoing);
+}
+
+TEST(NodeManagerTest, TestDistributionMapCountsDistinctNeighbours) {
+    NodeManager nodeManager(truncatedPartition(20));
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{{"1", "2"}, {"2", "3"}, {"3", "3"},
+                                                                              {"1", "3"}}) {
+        delete nodeManager.addLocalEdge(edge);
+    }
+    delete nodeManager.addCentralEdge({"3", "100"});
+    delete nodeManager.addNode("4");
+
+    // A self loop is one neighbor, nodes without relations are kept
+    std::map<long, long> expected{{1, 2}, {2, 2}, {3, 4}, {4, 0}, {100, 1}};
+    ASSERT_EQ(nodeManager.getDistributionMap(), expected);
+    // The degree counters count the self loop as an in and an out relation
+    NodeDegree degree = nodeManager.getDegree("3");
+    ASSERT_EQ(degree.localIn + degree.localOut, 4);
+}
+
+TEST(NodeManagerTest, TestCompactionKeepsChainOrderOfReusedBlocks) {
+    NodeManager nodeManager(truncatedPartition(21));
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{
+             {"1", "2"}, {"1", "3"}, {"1", "4"}, {"1", "5"}, {"6", "10"}, {"7", "10"}, {"8", "10"}}) {
+        delete nodeManager.addLocalEdge(edge);
+    }
+    // The new relations get the blocks of the deleted ones, below the relations inserted before them
+    ASSERT_TRUE(nodeManager.deleteEdge("6", "10"));
+    ASSERT_TRUE(nodeManager.deleteEdge("1", "3"));
+    ASSERT_EQ(relationIndex(nodeManager.addLocalEdge({"1", "9"})), 2);
+    ASSERT_EQ(relationIndex(nodeManager.addLocalEdge({"9", "10"})), 5);
+    std::vector<unsigned int> outgoing = chain(nodeManager, "1", true);
+    std::vector<unsigned int> incoming = chain(nodeManager, "10", false);
+    ASSERT_EQ(outgoing, std::vector<unsigned int>({9, 5, 4, 2}));
+    ASSERT_EQ(incoming, std::vector<unsigned int>({9, 8, 7}));
+
+    ASSERT_TRUE(nodeManager.compactRelations(false));
+    ASSERT_EQ(chain(nodeManager, "1", true), outgoing);
+    ASSERT_EQ(chain(nodeManager, "10", false), incoming);
+    ASSERT_EQ(chain(nodeManager, "9", true), std::vector<unsigned int>({10}));
+    ASSERT_EQ(chain(nodeManager, "9", false), std::vector<unsigned int>({1}));
+}
+
+TEST(NodeManagerTest, TestConcurrentInsertsAreReadByOtherThreads) {
+    NodeManager nodeManager(truncatedPartition(23));
+    const unsigned int WRITERS = 4;
+    const unsigned int EDGES = 200;
+    std::atomic<unsigned int> published[WRITERS];
+    for (auto &count : published) {
+        count = 0;
+    }
+    auto hub = [](unsigned int writer) { return std::to_string(1000 * writer + 1); };
+
+    // Every writer adds edges from its own hub, readers check that each edge is found once it was added
+    std::vector<std::thread> threads;
+    for (unsigned int writer = 0; writer < WRITERS; writer++) {
+        threads.emplace_back([&, writer]() {
+            NodeManager::ThreadStore threadStore(nodeManager);
+            for (unsigned int i = 0; i < EDGES; i++) {
+                std::string neighbor = std::to_string(1000 * writer + 2 + i);
+                RelationBlock *relation = nodeManager.addLocalEdge({hub(writer), neighbor});
+                EXPECT_NE(relation, nullptr);
+                delete relation;
+                published[writer]++;
+            }
+        });
+    }
+    std::atomic<bool> readersFailed{false};
+    for (unsigned int reader = 0; reader < 2; reader++) {
+        threads.emplace_back([&]() {
+            NodeManager::ThreadStore threadStore(nodeManager);
+            bool done = false;
+            while (!done && !readersFailed) {
+                done = true;
+                for (unsigned int writer = 0; writer < WRITERS; writer++) {
+                    unsigned int added = published[writer];
+                    done = done && added == EDGES;
+                    if (added == 0) {
+                        continue;
+                    }
+                    std::vector<unsigned int> outgoing = chain(nodeManager, hub(writer), true);
+                    std::string last = std::to_string(1000 * writer + 1 + added);
+                    if (outgoing.size() < added || chain(nodeManager, last, false) !=
+                                                       std::vector<unsigned int>({1000 * writer + 1})) {
+                        readersFailed = true;
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_FALSE(readersFailed);
+    for (unsigned int writer = 0; writer < WRITERS; writer++) {
+        ASSERT_EQ(chain(nodeManager, hub(writer), true).size(), EDGES);
+        assertDegree(nodeManager, hub(writer), 0, EDGES);
+    }
+}
+
+TEST(NodeManagerTest, TestMappedReadsSeeWrites) {
+    GraphConfig gConfig = truncatedPartition(24);
+    gConfig.storageMode = "mmap";
+    NodeManager nodeManager(gConfig);
+    ASSERT_NE(RelationBlock::relationsMap, nullptr);
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{{"1", "2"}, {"1", "3"}, {"4", "1"}}) {
+        delete nodeManager.addLocalEdge(edge);
+    }
+    // Appended blocks and links updated in place are read from the mapping right after they are written
+    ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({3, 2}));
+    ASSERT_EQ(chain(nodeManager, "1", false), std::vector<unsigned int>({4}));
+    ASSERT_TRUE(nodeManager.deleteEdge("1", "3"));
+    RelationBlock *relation = nodeManager.addLocalEdge({"1", "5"});
+    unsigned long address = relation->addr;
+    delete relation;
+    RelationView view;
+    ASSERT_TRUE(RelationView::read(address, false, view));
+    ASSERT_EQ(view.destination.nodeId, 5);
+    ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({5, 2}));
+
+    // Another thread maps the files written by this one
+    std::thread reader([&]() {
+        NodeManager::ThreadStore threadStore(nodeManager);
+        ASSERT_NE(RelationBlock::relationsMap, nullptr);
+        ASSERT_EQ(chain(nodeManager, "1", true), std::vector<unsigned int>({5, 2}));
+    });
+    reader.join();
+}
@@ -0,0 +1,87 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/PropertyIndex.h"
+
+#include <climits>
+
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+TEST(PropertyIndexTest, TestSeekAndRangeScan) {
+    PropertyIndex *index = PropertyIndex::acquire(TEST_DB_PREFIX);
+    index->truncate();
+    ASSERT_TRUE(index->create("name", PropertyIndexType::HASH));
+    ASSERT_TRUE(index->create("age", PropertyIndexType::RANGE));
+    ASSERT_FALSE(index->create("age", PropertyIndexType::RANGE));
+    // Enough entries to split leaves and inner pages of the B+-tree, inserted out of order and twice
+    for (int round = 0; round < 2; round++) {
+        for (unsigned int i = 0; i < 100000; i++) {
+            unsigned int node = (i * 7919) % 100000;
+            index->insert("name", PropertyValue::ofString("user" + std::to_string(node % 1000)), node);
+            index->insert("age", PropertyValue::ofInt(node % 500), node);
+        }
+    }
+    index->insert("age", PropertyValue::ofString("unknown"), 100000);
+    PropertyIndex::release(index);
+
+    index = PropertyIndex::acquire(TEST_DB_PREFIX);
+    std::vector<unsigned int> nodes;
+    ASSERT_TRUE(index->seek("name", "user42", nodes));
+    ASSERT_EQ(nodes.size(), 100);
+    ASSERT_EQ(nodes.front(), 42);
+    ASSERT_TRUE(index->seek("age", "7", nodes));
+    ASSERT_EQ(nodes.size(), 200);
+    ASSERT_FALSE(index->seek("city", "Colombo", nodes));
+
+    ASSERT_TRUE(index->rangeScan("age", 10, 19, nodes));
+    ASSERT_EQ(nodes.size(), 2000);
+    ASSERT_EQ(nodes.front() % 500, 10);
+    ASSERT_EQ(nodes.back() % 500, 19);
+    ASSERT_TRUE(index->rangeScan("age", 499, LLONG_MAX, nodes));
+    ASSERT_EQ(nodes.size(), 200);
+    ASSERT_FALSE(index->rangeScan("name", 0, 10, nodes));
+
+    index->truncate();
+    ASSERT_FALSE(index->isIndexed("age"));
+    PropertyIndex::release(index);
+    std::remove((TEST_DB_PREFIX + "_property_indexes.db").c_str());
+}
+
+TEST(PropertyIndexTest, TestInclusiveRangeAtLimits) {
+    long long lower;
+    long long upper = LLONG_MAX;
+    // > 9223372036854775807
+    ASSERT_TRUE(PropertyIndex::toInteger("9223372036854775807", lower));
+    ASSERT_FALSE(PropertyIndex::inclusiveRange(lower, false, upper, true));
+    ASSERT_EQ(lower, LLONG_MAX);
+    // < -9223372036854775808
+    lower = LLONG_MIN;
+    ASSERT_TRUE(PropertyIndex::toInteger("-9223372036854775808", upper));
+    ASSERT_FALSE(PropertyIndex::inclusiveRange(lower, true, upper, false));
+    ASSERT_EQ(upper, LLONG_MIN);
+
+    // >= and <= at the limits keep the one integer, exclusive bounds inside the range are moved inward
+    lower = LLONG_MAX;
+    upper = LLONG_MAX;
+    ASSERT_TRUE(PropertyIndex::inclusiveRange(lower, true, upper, true));
+    lower = 3;
+    upper = 7;
+    ASSERT_TRUE(PropertyIndex::inclusiveRange(lower, false, upper, false));
+    ASSERT_EQ(lower, 4);
+    ASSERT_EQ(upper, 6);
+    lower = 3;
+    upper = 4;
+    ASSERT_FALSE(PropertyIndex::inclusiveRange(lower, false, upper, false));
+}
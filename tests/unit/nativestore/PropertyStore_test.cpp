@@ -0,0 +1,54 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/PropertyStore.h"
+
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+TEST(PropertyStoreTest, TestTypedValues) {
+    PropertyStore::remove(TEST_DB_PREFIX);
+    std::string longText(1000, 'x');  // Longer than a linked property block value
+    PropertyStore *store = PropertyStore::acquire(TEST_DB_PREFIX);
+    ASSERT_TRUE(store->set(PropertyOwner::NODE, 3, "age", PropertyValue::ofInt(-42)));
+    ASSERT_TRUE(store->set(PropertyOwner::NODE, 3, "score", PropertyValue::ofDouble(0.1)));
+    ASSERT_TRUE(store->set(PropertyOwner::NODE, 3, "active", PropertyValue::ofBool(true)));
+    ASSERT_TRUE(store->set(PropertyOwner::NODE, 3, "name", PropertyValue::ofString("alice")));
+    ASSERT_TRUE(store->set(PropertyOwner::NODE, 1000, "name", PropertyValue::ofString(longText)));
+    ASSERT_TRUE(store->set(PropertyOwner::LOCAL_RELATION, 3, "weight", PropertyValue::ofInt(7)));
+    PropertyStore::release(store);
+
+    store = PropertyStore::acquire(TEST_DB_PREFIX);
+    PropertyValue value;
+    ASSERT_TRUE(store->get(PropertyOwner::NODE, 3, "age", value));
+    ASSERT_EQ(value.type, PropertyType::INT64);
+    ASSERT_EQ(value.intValue, -42);
+    ASSERT_TRUE(store->get(PropertyOwner::NODE, 3, "score", value));
+    ASSERT_EQ(value.toString(), "0.1");
+    ASSERT_TRUE(store->get(PropertyOwner::NODE, 3, "active", value));
+    ASSERT_EQ(value.toString(), "true");
+    ASSERT_TRUE(store->get(PropertyOwner::NODE, 1000, "name", value));
+    ASSERT_EQ(value.stringValue, longText);
+    ASSERT_FALSE(store->get(PropertyOwner::NODE, 4, "name", value));
+    ASSERT_FALSE(store->get(PropertyOwner::CENTRAL_RELATION, 3, "weight", value));
+
+    std::map<std::string, PropertyValue> properties = store->getAll(PropertyOwner::NODE, 3);
+    ASSERT_EQ(properties.size(), 4);
+    ASSERT_EQ(properties["name"].stringValue, "alice");
+    ASSERT_EQ(store->getAll(PropertyOwner::LOCAL_RELATION, 3).size(), 1);
+    PropertyStore::release(store);
+
+    PropertyStore::remove(TEST_DB_PREFIX);
+    ASSERT_FALSE(PropertyStore::exists(TEST_DB_PREFIX));
+}
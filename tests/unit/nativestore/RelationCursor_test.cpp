@@ -0,0 +1,126 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/RelationCursor.h"
+
+#include <sys/stat.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../../src/nativestore/NodeManager.h"
+#include "../../../src/util/Utils.h"
+#include "gtest/gtest.h"
+
+// Relation records compared between a RelationCursor walk and a RelationBlock walk
+struct Walked {
+    unsigned long addr;
+    unsigned long source;
+    unsigned long destination;
+    unsigned int sourceId;
+    unsigned int destinationId;
+    unsigned int typeId;
+    unsigned long propertyAddress;
+
+    bool operator==(const Walked &other) const {
+        return addr == other.addr && source == other.source && destination == other.destination &&
+               sourceId == other.sourceId && destinationId == other.destinationId && typeId == other.typeId &&
+               propertyAddress == other.propertyAddress;
+    }
+};
+
+static std::vector<Walked> cursorWalk(RelationCursor cursor) {
+    std::vector<Walked> walked;
+    RelationView relation;
+    while (cursor.next(relation)) {
+        walked.push_back({relation.addr, relation.source.address, relation.destination.address,
+                          relation.source.nodeId, relation.destination.nodeId, relation.typeId,
+                          relation.propertyAddress});
+    }
+    return walked;
+}
+
+// Walk a chain the way traversals did before RelationCursor, loading a RelationBlock for every relation
+static std::vector<Walked> blockWalk(unsigned long head, bool central, bool outgoing) {
+    std::vector<Walked> walked;
+    RelationBlock *relation = central ? RelationBlock::getCentralRelation(head) : RelationBlock::getLocalRelation(head);
+    while (relation) {
+        walked.push_back({relation->addr, relation->source.address, relation->destination.address,
+                          relation->source.nodeId, relation->destination.nodeId, relation->typeId,
+                          relation->propertyAddress});
+        RelationBlock *next;
+        if (outgoing) {
+            next = central ? relation->nextCentralSource() : relation->nextLocalSource();
+        } else {
+            next = central ? relation->nextCentralDestination() : relation->nextLocalDestination();
+        }
+        delete relation;
+        relation = next;
+    }
+    return walked;
+}
+
+TEST(RelationCursorTest, TestWalkMatchesRelationBlocks) {
+    mkdir(Utils::getJasmineGraphProperty("org.jasminegraph.server.instance.datafolder").c_str(), 0755);
+    NodeManager nodeManager(GraphConfig{43, 0, 18, "trunc"});
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{
+             {"1", "2"}, {"1", "3"}, {"2", "3"}, {"3", "3"}, {"4", "3"}, {"3", "5"}, {"5", "1"}}) {
+        RelationBlock *relation = nodeManager.addLocalEdge(edge);
+        ASSERT_NE(relation, nullptr);
+        if (edge.first == "3") {
+            relation->addLocalRelationshipType("FROM_3");
+        }
+        delete relation;
+    }
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{{"3", "100"}, {"200", "3"}}) {
+        delete nodeManager.addCentralEdge(edge);
+    }
+
+    for (const std::string nodeId : {"1", "2", "3", "4", "5", "100", "200"}) {
+        NodeBlock *node = nodeManager.get(nodeId);
+        ASSERT_NE(node, nullptr);
+        unsigned int index = node->addr / NodeBlock::BLOCK_SIZE;
+        for (bool central : {false, true}) {
+            unsigned long outgoingHead = central ? node->centralEdgeRef : node->edgeRef;
+            unsigned long incomingHead = IncomingRelationHeads::current->get(index, central);
+            std::vector<Walked> outgoing = blockWalk(outgoingHead, central, true);
+            std::vector<Walked> incoming = blockWalk(incomingHead, central, false);
+            ASSERT_EQ(cursorWalk(RelationCursor(node->addr, central, RelationDirection::OUTGOING)), outgoing);
+            ASSERT_EQ(cursorWalk(RelationCursor(node->addr, central, RelationDirection::INCOMING)), incoming);
+            ASSERT_EQ(cursorWalk(RelationCursor(node->addr, outgoingHead, central, true)), outgoing);
+            ASSERT_EQ(cursorWalk(RelationCursor(node->addr, incomingHead, central, false)), incoming);
+
+            // Both directions return a self loop once, from the outgoing chain
+            std::vector<Walked> both = outgoing;
+            for (const auto &relation : incoming) {
+                if (relation.source != node->addr) {
+                    both.push_back(relation);
+                }
+            }
+            ASSERT_EQ(cursorWalk(RelationCursor(node->addr, central)), both);
+        }
+        delete node;
+    }
+
+    NodeBlock *node = nodeManager.get("3");
+    ASSERT_EQ(cursorWalk(RelationCursor(node->addr, false)).size(), 5);
+    ASSERT_EQ(cursorWalk(RelationCursor(node->addr, true)).size(), 2);
+    RelationCursor cursor(node->addr, false, RelationDirection::OUTGOING);
+    RelationView relation;
+    while (cursor.next(relation)) {
+        ASSERT_TRUE(relation.outgoing);
+        ASSERT_EQ(nodeManager.relationTypeIndex->typeName(relation.typeId), "FROM_3");
+    }
+    delete node;
+}
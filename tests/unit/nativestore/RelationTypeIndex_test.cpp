@@ -0,0 +1,55 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/RelationTypeIndex.h"
+
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+TEST(RelationTypeIndexTest, TestTypeScans) {
+    RelationTypeIndex *index = RelationTypeIndex::acquire(TEST_DB_PREFIX);
+    index->truncate();
+    int knows = index->typeId("KNOWS", true);
+    int worksAt = index->typeId("WORKS_AT", true);
+    ASSERT_EQ(knows, 1);
+    ASSERT_EQ(worksAt, 2);
+    ASSERT_EQ(index->typeId("KNOWS", true), knows);
+    for (unsigned int i = 1; i < 1000; i++) {
+        index->add(i % 4 == 0 ? worksAt : knows, false, i);
+    }
+    index->add(worksAt, true, 7);
+    RelationTypeIndex::release(index);
+
+    index = RelationTypeIndex::acquire(TEST_DB_PREFIX);
+    ASSERT_EQ(index->typeId("WORKS_AT", false), worksAt);
+    ASSERT_EQ(index->typeId("LIKES", false), -1);
+    ASSERT_EQ(index->typeName(knows), "KNOWS");
+    std::vector<unsigned int> relations = index->getRelations("WORKS_AT", false);
+    ASSERT_EQ(relations.size(), 249);
+    ASSERT_EQ(relations.front(), 4);
+    ASSERT_EQ(index->getRelations("KNOWS", false).size(), 750);
+    ASSERT_EQ(index->getRelations("WORKS_AT", true), std::vector<unsigned int>({7}));
+    ASSERT_TRUE(index->getRelations("KNOWS", true).empty());
+    ASSERT_TRUE(index->getRelations("LIKES", false).empty());
+
+    // Relations renumbered by a compaction
+    index->rebuild(false, {0, 2, 1, 1, 0});
+    ASSERT_EQ(index->getRelations("KNOWS", false), std::vector<unsigned int>({2, 3}));
+    ASSERT_EQ(index->getRelations("WORKS_AT", false), std::vector<unsigned int>({1}));
+    ASSERT_EQ(index->getRelations("WORKS_AT", true), std::vector<unsigned int>({7}));
+    index->truncate();
+    ASSERT_TRUE(index->getTypes().empty());
+    RelationTypeIndex::release(index);
+    std::remove((TEST_DB_PREFIX + "_relation_types.db").c_str());
+}
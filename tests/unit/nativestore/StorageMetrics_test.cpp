@@ -0,0 +1,55 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/StorageMetrics.h"
+
+#include "gtest/gtest.h"
+
+TEST(StorageMetricsTest, TestCountReadsAndWrites) {
+    StorageMetrics *metrics = StorageMetrics::get(TEST_RESOURCE_DIR "temp/g90_p1");
+    ASSERT_EQ(metrics, StorageMetrics::get("/other/folder/g90_p1"));  // Keyed by partition name
+    StorageMetrics::Snapshot before = metrics->snapshot();
+
+    StorageMetrics::current = nullptr;
+    { StorageMetrics::ReadTimer unattached(BlockFile::NODES, 40); }
+    StorageMetrics::recordWrite(BlockFile::NODES, 40);
+
+    StorageMetrics::current = metrics;
+    {
+        StorageMetrics::ReadTimer miss(BlockFile::RELATIONS, 64);
+        miss.load(true);
+    }
+    { StorageMetrics::ReadTimer hit(BlockFile::RELATIONS, 64); }
+    StorageMetrics::recordWrite(BlockFile::PROPERTIES, 12);
+    StorageMetrics::current = nullptr;
+
+    StorageMetrics::Snapshot after = metrics->snapshot();
+    const StorageCounters &nodes = after.files[static_cast<int>(BlockFile::NODES)];
+    const StorageCounters &relations = after.files[static_cast<int>(BlockFile::RELATIONS)];
+    const StorageCounters &properties = after.files[static_cast<int>(BlockFile::PROPERTIES)];
+    ASSERT_EQ(nodes.reads, before.files[static_cast<int>(BlockFile::NODES)].reads);
+    ASSERT_EQ(nodes.writes, before.files[static_cast<int>(BlockFile::NODES)].writes);
+    ASSERT_EQ(relations.reads - before.files[static_cast<int>(BlockFile::RELATIONS)].reads, 2);
+    ASSERT_EQ(relations.cacheHits - before.files[static_cast<int>(BlockFile::RELATIONS)].cacheHits, 1);
+    ASSERT_EQ(relations.bytesRead - before.files[static_cast<int>(BlockFile::RELATIONS)].bytesRead, 64);
+    ASSERT_EQ(relations.seeks - before.files[static_cast<int>(BlockFile::RELATIONS)].seeks, 1);
+    ASSERT_EQ(properties.writes - before.files[static_cast<int>(BlockFile::PROPERTIES)].writes, 1);
+    ASSERT_EQ(properties.bytesWritten - before.files[static_cast<int>(BlockFile::PROPERTIES)].bytesWritten, 12);
+
+    unsigned long timedReads = 0;
+    for (int bucket = 0; bucket < StorageMetrics::LATENCY_BUCKETS; bucket++) {
+        timedReads += after.latency[bucket] - before.latency[bucket];
+    }
+    ASSERT_EQ(timedReads, 2);
+    ASSERT_NE(StorageMetrics::toJson().find("\"g90_p1\""), std::string::npos);
+}
@@ -0,0 +1,82 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/nativestore/WriteAheadLog.h"
+
+#include <fstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+static const std::string TEST_DB_PREFIX = TEST_RESOURCE_DIR "temp/g0_p0";
+
+TEST(WriteAheadLogTest, TestReplayAndCheckpoint) {
+    WriteAheadLog *log = WriteAheadLog::acquire(TEST_DB_PREFIX);
+    log->checkpoint();
+    log->append(WalRecordType::MESSAGE, std::string("{\"isNode\": true, \"id\": \"1\"}"));
+    log->append(WalRecordType::LOCAL_EDGE, std::vector<std::string>{"edge 1 2", "edge 2 3", ""});
+    log->append(WalRecordType::CENTRAL_EDGE, std::string(100000, 'x'));
+    log->commit();
+    ASSERT_EQ(log->size(), 5);
+    WriteAheadLog::release(log);
+
+    // A record torn by a crash during an append is dropped
+    std::ofstream file(TEST_DB_PREFIX + "_wal.log", std::ios::app | std::ios::binary);
+    file.write("\x20\x00\x00\x00\x01\x02", 6);
+    file.close();
+
+    log = WriteAheadLog::acquire(TEST_DB_PREFIX);
+    ASSERT_EQ(log->size(), 5);
+    std::vector<std::pair<WalRecordType, std::string>> records;
+    ASSERT_EQ(log->replay([&](WalRecordType type, const std::string &payload) {
+        records.push_back({type, payload});
+        log->append(type, payload);  // Not logged again while replaying
+    }), 5);
+    ASSERT_EQ(records[0].first, WalRecordType::MESSAGE);
+    ASSERT_EQ(records[2].second, "edge 2 3");
+    ASSERT_EQ(records[3].second, "");
+    ASSERT_EQ(records[4].first, WalRecordType::CENTRAL_EDGE);
+    ASSERT_EQ(records[4].second.size(), 100000);
+    ASSERT_EQ(log->size(), 5);
+
+    log->checkpoint();
+    ASSERT_EQ(log->size(), 0);
+    log->append(WalRecordType::LOCAL_EDGE, std::string("edge 3 4"));
+    ASSERT_EQ(log->replay([](WalRecordType, const std::string &) {}), 1);
+    log->checkpoint();
+    WriteAheadLog::release(log);
+    std::remove((TEST_DB_PREFIX + "_wal.log").c_str());
+}
+
+TEST(WriteAheadLogTest, TestAppendOfOtherThreadDuringReplay) {
+    WriteAheadLog *log = WriteAheadLog::acquire(TEST_DB_PREFIX);
+    log->checkpoint();
+    log->append(WalRecordType::LOCAL_EDGE, std::vector<std::string>{"edge 1 2", "edge 2 3"});
+
+    // Another writer appends while the records are applied, its record is logged once the replay is done
+    std::thread writer;
+    ASSERT_EQ(log->replay([&](WalRecordType, const std::string &) {
+        if (!writer.joinable()) {
+            writer = std::thread([log]() { log->append(WalRecordType::LOCAL_EDGE, std::string("edge 3 4")); });
+        }
+        ASSERT_EQ(log->size(), 2);
+    }), 2);
+    writer.join();
+    ASSERT_EQ(log->size(), 3);
+    std::vector<std::string> payloads;
+    ASSERT_EQ(log->replay([&](WalRecordType, const std::string &payload) { payloads.push_back(payload); }), 3);
+    ASSERT_EQ(payloads.back(), "edge 3 4");
+    log->checkpoint();
+    WriteAheadLog::release(log);
+    std::remove((TEST_DB_PREFIX + "_wal.log").c_str());
+}
@@ -0,0 +1,174 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/query/processor/cypher/runtime/Helpers.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Conditions in the form the Filter operator of the query plan sends them
+static json property(const std::string &variable, const std::string &name) {
+    return json{{"type", "PROPERTY_LOOKUP"}, {"variable", variable}, {"property", json::array({name})}};
+}
+
+static json constant(const std::string &type, const std::string &value) {
+    return json{{"type", type}, {"value", value}};
+}
+
+static json comparison(const json &left, const std::string &op, const json &right) {
+    return json{{"type", "COMPARISON"}, {"left", left}, {"operator", op}, {"right", right}};
+}
+
+// IS NULL compares with ==, IS NOT NULL with <>, against a NULL operand without a value
+static json isNull(const json &left, bool negated = false) {
+    return json{{"type", "PREDICATE_EXPRESSIONS"}, {"left", left}, {"operator", negated ? "<>" : "=="},
+                {"right", {{"type", "NULL"}}}};
+}
+
+static json combine(const std::string &type, const std::vector<json> &comparisons) {
+    return json{{"type", type}, {"comparisons", comparisons}};
+}
+
+class FilterHelperTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        this->schema = std::make_shared<RowSchema>(std::vector<std::string>{"n", "m", "o"});
+        this->batch = RowBatch(this->schema);
+        this->batch.set(this->batch.append(), json::parse(R"({
+            "n": {"id": "1", "partitionID": "0", "age": "30", "name": "alice", "active": "True"},
+            "m": {"id": "2", "partitionID": "0", "age": "x"}
+        })"));
+    }
+
+    bool matches(const json &condition) const {
+        FilterHelper filter(condition, this->schema);
+        return filter.evaluate(this->batch, 0);
+    }
+
+    RowSchema::Ptr schema;
+    RowBatch batch;
+};
+
+TEST_F(FilterHelperTest, TestDecimalComparators) {
+    json age = property("n", "age");
+    ASSERT_TRUE(matches(comparison(age, "==", constant("DECIMAL", "30"))));
+    ASSERT_FALSE(matches(comparison(age, "==", constant("DECIMAL", "31"))));
+    ASSERT_TRUE(matches(comparison(age, "<>", constant("DECIMAL", "31"))));
+    ASSERT_FALSE(matches(comparison(age, "<>", constant("DECIMAL", "30"))));
+    ASSERT_TRUE(matches(comparison(age, "<", constant("DECIMAL", "31"))));
+    ASSERT_FALSE(matches(comparison(age, "<", constant("DECIMAL", "30"))));
+    ASSERT_TRUE(matches(comparison(age, ">", constant("DECIMAL", "29"))));
+    ASSERT_FALSE(matches(comparison(age, ">", constant("DECIMAL", "30"))));
+    ASSERT_TRUE(matches(comparison(age, "<=", constant("DECIMAL", "30"))));
+    ASSERT_FALSE(matches(comparison(age, "<=", constant("DECIMAL", "29"))));
+    ASSERT_TRUE(matches(comparison(age, ">=", constant("DECIMAL", "30"))));
+    ASSERT_FALSE(matches(comparison(age, ">=", constant("DECIMAL", "31"))));
+
+    // A value that is not a number matches no comparator
+    json notNumber = property("m", "age");
+    ASSERT_FALSE(matches(comparison(notNumber, "==", constant("DECIMAL", "0"))));
+    ASSERT_FALSE(matches(comparison(notNumber, "<>", constant("DECIMAL", "0"))));
+}
+
+TEST_F(FilterHelperTest, TestStringComparators) {
+    json name = property("n", "name");
+    ASSERT_TRUE(matches(comparison(name, "==", constant("STRING", "'alice'"))));
+    ASSERT_FALSE(matches(comparison(name, "==", constant("STRING", "'bob'"))));
+    ASSERT_TRUE(matches(comparison(name, "<>", constant("STRING", "'bob'"))));
+    ASSERT_FALSE(matches(comparison(name, "<>", constant("STRING", "'alice'"))));
+    // Strings are not ordered
+    for (const std::string op : {"<", ">", "<=", ">="}) {
+        ASSERT_FALSE(matches(comparison(name, op, constant("STRING", "'alice'")))) << op;
+        ASSERT_FALSE(matches(comparison(name, op, constant("STRING", "'bob'")))) << op;
+    }
+}
+
+TEST_F(FilterHelperTest, TestBooleanComparators) {
+    json active = property("n", "active");
+    ASSERT_TRUE(matches(comparison(active, "==", constant("BOOLEAN", "TRUE"))));
+    ASSERT_FALSE(matches(comparison(active, "==", constant("BOOLEAN", "FALSE"))));
+    ASSERT_TRUE(matches(comparison(active, "<>", constant("BOOLEAN", "FALSE"))));
+    ASSERT_FALSE(matches(comparison(active, "<>", constant("BOOLEAN", "TRUE"))));
+    ASSERT_TRUE(matches(comparison(active, ">", constant("BOOLEAN", "FALSE"))));
+    ASSERT_FALSE(matches(comparison(active, "<", constant("BOOLEAN", "TRUE"))));
+    ASSERT_TRUE(matches(comparison(active, "<=", constant("BOOLEAN", "TRUE"))));
+    ASSERT_TRUE(matches(comparison(active, ">=", constant("BOOLEAN", "TRUE"))));
+    ASSERT_FALSE(matches(comparison(property("n", "name"), "==", constant("BOOLEAN", "TRUE"))));
+}
+
+TEST_F(FilterHelperTest, TestMissingPropertyIsNull) {
+    json missing = property("n", "city");
+    ASSERT_TRUE(matches(comparison(missing, "==", constant("STRING", "'null'"))));
+    ASSERT_FALSE(matches(comparison(missing, "==", constant("DECIMAL", "0"))));
+    ASSERT_FALSE(matches(comparison(missing, "<>", constant("DECIMAL", "0"))));
+    ASSERT_FALSE(matches(comparison(missing, "==", constant("BOOLEAN", "FALSE"))));
+    // Variables that are not bound in the row have no properties either
+    ASSERT_TRUE(matches(comparison(property("o", "name"), "==", constant("STRING", "'null'"))));
+    ASSERT_TRUE(matches(comparison(property("x", "name"), "==", constant("STRING", "'null'"))));
+}
+
+TEST_F(FilterHelperTest, TestIsNull) {
+    ASSERT_TRUE(matches(isNull(property("n", "city"))));
+    ASSERT_FALSE(matches(isNull(property("n", "name"))));
+    ASSERT_TRUE(matches(isNull(property("o", "name"))));
+    ASSERT_FALSE(matches(isNull(property("n", "city"), true)));
+    ASSERT_TRUE(matches(isNull(property("n", "name"), true)));
+}
+
+TEST_F(FilterHelperTest, TestIdFunction) {
+    json id = json{{"type", "FUNCTION"}, {"functionName", "id"}, {"arguments", json::array({"m"})}};
+    ASSERT_TRUE(matches(comparison(id, "==", constant("STRING", "'2'"))));
+    ASSERT_FALSE(matches(comparison(id, "==", constant("STRING", "'1'"))));
+    ASSERT_TRUE(matches(comparison(id, "==", constant("DECIMAL", "2"))));
+    ASSERT_TRUE(matches(comparison(id, ">", constant("DECIMAL", "1"))));
+    ASSERT_FALSE(matches(comparison(constant("DECIMAL", "2"), "<", id)));
+    ASSERT_TRUE(matches(comparison(constant("DECIMAL", "1"), "<", id)));
+}
+
+TEST_F(FilterHelperTest, TestLogicalOperators) {
+    json older = comparison(property("n", "age"), ">", constant("DECIMAL", "20"));
+    json younger = comparison(property("n", "age"), "<", constant("DECIMAL", "20"));
+    json named = comparison(property("n", "name"), "==", constant("STRING", "'alice'"));
+
+    ASSERT_TRUE(matches(combine("AND", {older, named})));
+    ASSERT_FALSE(matches(combine("AND", {older, younger})));
+    ASSERT_TRUE(matches(combine("OR", {younger, named})));
+    ASSERT_FALSE(matches(combine("OR", {younger, younger})));
+    ASSERT_TRUE(matches(combine("XOR", {older, younger})));
+    ASSERT_FALSE(matches(combine("XOR", {older, named})));
+    ASSERT_TRUE(matches(combine("XOR", {older, named, older})));
+    ASSERT_FALSE(matches(combine("XOR", {older})));
+    ASSERT_TRUE(matches(combine("AND", {combine("OR", {younger, older}), combine("XOR", {named, younger})})));
+}
+
+TEST_F(FilterHelperTest, TestNotReturnsItsOperand) {
+    json older = comparison(property("n", "age"), ">", constant("DECIMAL", "20"));
+    json younger = comparison(property("n", "age"), "<", constant("DECIMAL", "20"));
+    ASSERT_TRUE(matches(combine("NOT", {older})));
+    ASSERT_FALSE(matches(combine("NOT", {younger})));
+    ASSERT_FALSE(matches(combine("NOT", {})));
+}
+
+TEST_F(FilterHelperTest, TestDistinctNodes) {
+    json n = constant("VARIABLE", "n");
+    json m = constant("VARIABLE", "m");
+    ASSERT_TRUE(matches(comparison(n, "<>", m)));
+    ASSERT_FALSE(matches(comparison(n, "<>", n)));
+    // A variable that is not bound matches any node
+    ASSERT_TRUE(matches(comparison(n, "<>", constant("VARIABLE", "o"))));
+    ASSERT_TRUE(matches(comparison(constant("VARIABLE", "x"), "<>", n)));
+    // Operands of different types are never compared
+    ASSERT_FALSE(matches(comparison(n, "==", constant("STRING", "'1'"))));
+}
@@ -0,0 +1,41 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/query/processor/cypher/queryplanner/QueryPlanner.h"
+
+#include <nlohmann/json.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(QueryPlannerTest, TestExtractQueryOptions) {
+    std::string query = "cypher Parallelism = 4 runtime=slotted\nMATCH (n) RETURN n";
+    auto options = QueryPlanner::extractQueryOptions(query);
+    ASSERT_EQ(query, "MATCH (n) RETURN n");
+    ASSERT_EQ(options.size(), 2);
+    ASSERT_EQ(options["parallelism"], "4");
+    ASSERT_EQ(options["runtime"], "slotted");
+
+    std::string plain = "MATCH (n) RETURN n";
+    ASSERT_TRUE(QueryPlanner::extractQueryOptions(plain).empty());
+    ASSERT_EQ(plain, "MATCH (n) RETURN n");
+}
+
+TEST(QueryPlannerTest, TestApplyQueryOptions) {
+    std::string plan = R"({"Operator":"AllNodeScan","variables":"n"})";
+    auto applied = nlohmann::json::parse(QueryPlanner::applyQueryOptions(plan, {{"parallelism", "3"}}));
+    ASSERT_EQ(applied["parallelism"], 3);
+    ASSERT_EQ(applied["Operator"], "AllNodeScan");
+    // Invalid values leave the parallelism to the workers
+    ASSERT_EQ(QueryPlanner::applyQueryOptions(plan, {{"parallelism", "all"}}), plan);
+    ASSERT_EQ(QueryPlanner::applyQueryOptions("", {{"parallelism", "3"}}), "");
+}
@@ -0,0 +1,61 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/query/processor/cypher/util/RowBatch.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(RowBatchTest, TestCopyRowsIntoWiderSchema) {
+    auto input = std::make_shared<RowSchema>(std::vector<std::string>{"n"});
+    auto output = std::make_shared<RowSchema>(std::vector<std::string>{"n", "r", "m"});
+    ASSERT_EQ(output->slot("m"), 2);
+    ASSERT_EQ(output->slot("x"), -1);
+
+    RowBatch nodes(input);
+    nodes.set(nodes.append(), json::parse(R"({"n": {"id": "1", "partitionID": "0"}, "x": 3})"));
+    RowBatch expanded(output);
+    size_t row = expanded.append(nodes, 0);
+    expanded.set(row, output->slot("r"), 7LL);
+
+    auto node = RowBatch::entity(expanded.get(row, 0));
+    ASSERT_NE(node, nullptr);
+    ASSERT_EQ(*node->property("id"), "1");
+    ASSERT_EQ(node->property("name"), nullptr);
+    ASSERT_EQ(expanded.toJson(row), json::parse(R"({"n": {"id": "1", "partitionID": "0"}, "r": 7})"));
+    ASSERT_TRUE(expanded.toJson(row, true)["m"].is_null());
+}
+
+TEST(RowBatchTest, TestWriterSplitsBatches) {
+    auto schema = std::make_shared<RowSchema>(std::vector<std::string>{"count"});
+    BatchBuffer buffer(2);
+    std::thread producer([&buffer, schema]() {
+        BatchWriter out(buffer, schema);
+        for (long long i = 0; i < (long long)RowBatch::CAPACITY + 10; i++) {
+            out.batch().set(out.addRow(), 0, i);
+        }
+        out.close();
+    });
+    std::vector<size_t> sizes;
+    long long next = 0;
+    RowBatch batch;
+    while (buffer.get(batch)) {
+        sizes.push_back(batch.size());
+        for (size_t row = 0; row < batch.size(); row++) {
+            ASSERT_EQ(std::get<long long>(batch.get(row, 0)), next++);
+        }
+    }
+    producer.join();
+    ASSERT_EQ(sizes, (std::vector<size_t>{RowBatch::CAPACITY, 10}));
+}
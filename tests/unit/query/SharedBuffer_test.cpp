@@ -0,0 +1,82 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/query/processor/cypher/util/SharedBuffer.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(SharedBufferTest, TestBatchesKeepOrderUntilClosed) {
+    SharedBuffer buffer(5);
+    const int rows = 10000;
+    std::thread producer([&buffer]() {
+        SharedBuffer::CloseGuard closeGuard(buffer);
+        std::vector<std::string> batch;
+        for (int i = 0; i < rows; i++) {
+            if (i % 3 == 0) {
+                buffer.add(std::to_string(i));
+                continue;
+            }
+            batch.push_back(std::to_string(i));
+            if (batch.size() == 7) {
+                buffer.addBatch(batch);
+                batch.clear();
+            }
+            // Rows of a partial batch are added before the next single row
+            if ((i + 1) % 3 == 0 && !batch.empty()) {
+                buffer.addBatch(batch);
+                batch.clear();
+            }
+        }
+        buffer.addBatch(batch);
+    });
+    int next = 0;
+    std::string row;
+    std::vector<std::string> batch;
+    while (true) {
+        if (next % 2 == 0) {
+            if (!buffer.get(row)) {
+                break;
+            }
+            ASSERT_EQ(row, std::to_string(next++));
+        } else {
+            if (buffer.getBatch(batch, 4) == 0) {
+                break;
+            }
+            for (auto &data : batch) {
+                ASSERT_EQ(data, std::to_string(next++));
+            }
+            batch.clear();
+        }
+    }
+    producer.join();
+    ASSERT_EQ(next, rows);
+    ASSERT_TRUE(buffer.finished());
+    ASSERT_FALSE(buffer.tryGet(row));
+}
+
+TEST(SharedBufferTest, TestCloseWakesParkedConsumer) {
+    SharedBuffer buffer(2);
+    std::thread producer([&buffer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        buffer.add("1");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        buffer.close();
+    });
+    std::string row;
+    ASSERT_TRUE(buffer.get(row));
+    ASSERT_EQ(row, "1");
+    ASSERT_FALSE(buffer.get(row));
+    producer.join();
+}
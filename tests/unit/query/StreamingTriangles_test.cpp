@@ -0,0 +1,58 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/query/algorithms/triangles/StreamingTriangles.h"
+
+#include <sys/stat.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../../src/util/Utils.h"
+#include "gtest/gtest.h"
+
+TEST(StreamingTrianglesTest, TestDynamicCountAfterBlockReuse) {
+    mkdir(Utils::getJasmineGraphProperty("org.jasminegraph.server.instance.datafolder").c_str(), 0755);
+    JasmineGraphIncrementalLocalStore store(0, 22, "trunc");
+    NodeManager *nodeManager = store.nm;
+    for (const auto &edge : std::vector<std::pair<std::string, std::string>>{{"1", "2"}, {"2", "3"}, {"3", "4"},
+                                                                              {"1", "5"}}) {
+        delete nodeManager->addLocalEdge(edge);
+    }
+    NativeStoreTriangleResult counted = StreamingTriangles::countLocalStreamingTriangles(&store);
+    ASSERT_EQ(counted.result, 0);
+    auto countNew = [&]() {
+        counted = StreamingTriangles::countDynamicLocalTriangles(&store, counted.localRelationCount,
+                                                                 counted.centralRelationCount);
+        return counted.result;
+    };
+
+    // The new edge is written to the block of the deleted one, below the relation count of the last run
+    ASSERT_TRUE(nodeManager->deleteEdge("1", "5"));
+    delete nodeManager->addLocalEdge({"1", "3"});
+    ASSERT_EQ(counted.localRelationCount, 4);
+    ASSERT_EQ(countNew(), 1);
+    ASSERT_EQ(counted.localRelationCount, 4);
+    ASSERT_EQ(countNew(), 0);
+
+    // Appended edges are counted from the blocks past the last run again
+    delete nodeManager->addLocalEdge({"2", "4"});
+    ASSERT_EQ(countNew(), 1);
+    ASSERT_EQ(counted.localRelationCount, 5);
+
+    // Triangles of a deleted edge are subtracted
+    ASSERT_TRUE(nodeManager->deleteEdge("1", "2"));
+    ASSERT_EQ(countNew(), -1);
+    ASSERT_EQ(countNew(), 0);
+}
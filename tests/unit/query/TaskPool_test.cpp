@@ -0,0 +1,66 @@
+/**
+Copyright 2025 JasmineGraph Team
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+#include "../../../src/query/processor/cypher/util/TaskPool.h"
+
+#include <future>
+
+#include "gtest/gtest.h"
+
+TEST(TaskPoolTest, TestTasksRunOnce) {
+    TaskPool pool(4);
+    std::atomic<int> runs{0};
+    std::vector<std::shared_ptr<TaskPool::Task>> tasks;
+    for (int i = 0; i < 1000; i++) {
+        tasks.push_back(pool.submit([&runs]() { runs++; }));
+    }
+    for (auto &task : tasks) {
+        task->join();
+    }
+    ASSERT_EQ(runs.load(), 1000);
+}
+
+TEST(TaskPoolTest, TestQueuedTaskIsCancelledOrRunByJoin) {
+    TaskPool pool(1);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    auto busy = pool.submit([released]() { released.wait(); });
+    bool cancelledRan = false;
+    bool joinedRan = false;
+    auto cancelled = pool.submit([&cancelledRan]() { cancelledRan = true; });
+    auto joined = pool.submit([&joinedRan]() { joinedRan = true; });
+
+    // The only thread is busy, the queued tasks do not wait for it
+    ASSERT_TRUE(cancelled->cancel());
+    joined->join();
+    ASSERT_TRUE(joinedRan);
+    ASSERT_FALSE(joined->cancel());
+    release.set_value();
+    busy->join();
+    cancelled->join();
+    ASSERT_FALSE(cancelledRan);
+}
+
+TEST(TaskPoolTest, TestBlockedThreadsGetExtraThread) {
+    TaskPool pool(1);
+    std::promise<void> answered;
+    std::shared_future<void> answer = answered.get_future().share();
+    // A task that waits on a task queued after it, as a query waits for the sub query of another worker
+    auto waiting = pool.submit([answer]() {
+        TaskPool::Blocking blocking;
+        answer.wait();
+    });
+    auto answering = pool.submit([&answered]() { answered.set_value(); });
+    waiting->join();
+    answering->join();
+}